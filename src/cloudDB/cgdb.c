@@ -508,26 +508,13 @@ static int cgdb_get_entry_cb(cgdb_backend_cursor * cursor,
 
             if (result == 0)
             {
-                cgdb_row const * const row = tmp_row;
-
-                CGUTILS_ASSERT(row != NULL);
+                CGUTILS_ASSERT(tmp_row != NULL);
 
-                result = cgdb_get_entry_from_row(row, &entry);
+                /* the backend has decoded the row into an entry */
+                entry = tmp_row;
+                cgdb_entry_finish_decoding(entry);
 
-                if (result == 0)
-                {
-                    CGUTILS_ASSERT(entry != NULL);
-                }
-                else
-                {
-                    CGUTILS_ERROR("Unable to convert database response to entry: %d",
-                                  result);
-                }
-
-                if (result != 0)
-                {
-                    cgdb_entry_free(entry), entry = NULL;
-                }
+                cgutils_vector_set(rows, 0, NULL);
             }
             else
             {
@@ -552,7 +539,7 @@ static int cgdb_get_entry_cb(cgdb_backend_cursor * cursor,
 
     if (rows != NULL)
     {
-        cgutils_vector_deep_free(&rows, &cgdb_row_delete);
+        cgutils_vector_deep_free(&rows, &cgdb_entry_delete);
     }
 
     result = (*((cgdb_entry_getter_cb *) request->cb))(result,
@@ -684,31 +671,24 @@ static int cgdb_get_inode_instances_cb(cgdb_backend_cursor * cursor,
                          idx < rows_count;
                      idx++)
                 {
-                    cgdb_row const * row = NULL;
+                    cgdb_inode_instance * instance = NULL;
 
                     result = cgutils_vector_get(rows,
                                                 idx,
-                                                (void *) &row);
+                                                (void *) &instance);
 
                     if (result == 0)
                     {
-                        cgdb_inode_instance * instance = NULL;
-
-                        result = cgdb_get_inode_instance_from_row(row, &instance);
+                        /* the backend has decoded the row into an instance */
+                        result = cgutils_llist_insert(instances, instance);
 
                         if (result == 0)
                         {
-                            result = cgutils_llist_insert(instances, instance);
-
-                            if (result != 0)
-                            {
-                                CGUTILS_ERROR("Error inserting instance into list: %d", result);
-                                cgdb_inode_instance_free(instance), instance = NULL;
-                            }
+                            cgutils_vector_set(rows, idx, NULL);
                         }
                         else
                         {
-                            CGUTILS_ERROR("Unable to get instance from database row: %d", result);
+                            CGUTILS_ERROR("Error inserting instance into list: %d", result);
                         }
                     }
                     else
@@ -739,7 +719,7 @@ static int cgdb_get_inode_instances_cb(cgdb_backend_cursor * cursor,
 
     if (rows != NULL)
     {
-        cgutils_vector_deep_free(&rows, &cgdb_row_delete);
+        cgutils_vector_deep_free(&rows, &cgdb_inode_instance_delete);
     }
 
     result = (*((cgdb_multiple_inode_instances_getter_cb *)request->cb))(result,
@@ -1790,6 +1770,120 @@ int cgdb_add_inode_instance(cgdb_data * const db,
     return result;
 }
 
+int cgdb_add_inode_instances(cgdb_data * const db,
+                             uint64_t const fs_id,
+                             uint64_t const inode_number,
+                             uint64_t const * const instances_ids,
+                             char const * const * const ids_in_instance,
+                             size_t const instances_count,
+                             uint8_t const status,
+                             cgdb_status_cb * const cb,
+                             void * const cb_data)
+{
+    int result = EINVAL;
+
+    if (db != NULL &&
+        fs_id > 0 &&
+        inode_number > 0 &&
+        instances_ids != NULL &&
+        ids_in_instance != NULL &&
+        instances_count > 0)
+    {
+        static cgdb_backend_statement const statement = cgdb_backend_statement_add_inode_instance;
+        size_t const params_size = cgdb_backend_statement_params_count[statement];
+        cgdb_param * params = NULL;
+        cgdb_backend_batch_stmt * stmts = NULL;
+
+        uint16_t const status_temp = status;
+        uint64_t const upload_time = (uint64_t) 0;
+        bool const state = false;
+
+        result = ENOMEM;
+
+        CGUTILS_MALLOC(params, instances_count * params_size, sizeof *params);
+
+        if (params != NULL)
+        {
+            CGUTILS_MALLOC(stmts, instances_count, sizeof *stmts);
+
+            if (stmts != NULL)
+            {
+                result = 0;
+
+                for (size_t idx = 0;
+                     result == 0 &&
+                         idx < instances_count;
+                     idx++)
+                {
+                    cgdb_param * const stmt_params = &(params[idx * params_size]);
+                    size_t param_idx = 0;
+
+                    if (instances_ids[idx] > 0 &&
+                        ids_in_instance[idx] != NULL)
+                    {
+                        cgdb_param_array_init(stmt_params, params_size);
+
+                        cgdb_param_set_uint64(stmt_params, &param_idx, &fs_id);
+                        cgdb_param_set_uint64(stmt_params, &param_idx, &(instances_ids[idx]));
+                        cgdb_param_set_uint64(stmt_params, &param_idx, &inode_number);
+                        cgdb_param_set_string(stmt_params, &param_idx, ids_in_instance[idx]);
+                        cgdb_param_set_uint16(stmt_params, &param_idx, &status_temp);
+                        cgdb_param_set_uint64(stmt_params, &param_idx, &upload_time);
+                        /* uploading */
+                        cgdb_param_set_boolean(stmt_params, &param_idx, &state);
+                        /* deleting */
+                        cgdb_param_set_boolean(stmt_params, &param_idx, &state);
+
+                        stmts[idx].statement = statement;
+                        stmts[idx].params = stmt_params;
+                        stmts[idx].params_count = params_size;
+                    }
+                    else
+                    {
+                        result = EINVAL;
+                    }
+                }
+
+                if (result == 0)
+                {
+                    cgdb_request_data * request = NULL;
+
+                    result = cgdb_request_data_init(db, cb, cb_data, &request);
+
+                    if (result == 0)
+                    {
+                        result = cgdb_backend_exec_batch(db->backend,
+                                                         stmts,
+                                                         instances_count,
+                                                         &cgdb_generic_status_cb,
+                                                         request);
+
+                        if (result != 0)
+                        {
+                            if (result != ENOSYS)
+                            {
+                                CGUTILS_ERROR("Error in batch operation: %d", result);
+                            }
+
+                            cgdb_request_data_free(request), request = NULL;
+                        }
+                    }
+                    else
+                    {
+                        CGUTILS_ERROR("Unable to allocate request data: %d", result);
+                    }
+                }
+
+                CGUTILS_FREE(stmts);
+            }
+
+            CGUTILS_FREE(params);
+        }
+    }
+
+    return result;
+}
+
 int cgdb_remove_inode_instance(cgdb_data * const db,
                                uint64_t const fs_id,
                                uint64_t const instance_id,
@@ -2252,6 +2346,88 @@ int cgdb_set_inode_and_all_inodes_instances_dirty(cgdb_data * const db,
     return result;
 }
 
+int cgdb_set_inodes_and_all_inodes_instances_dirty_multi(cgdb_data * const db,
+                                                         uint64_t const fs_id,
+                                                         uint64_t const * const inodes,
+                                                         size_t const inodes_count,
+                                                         time_t const min_mtime,
+                                                         time_t const min_ctime,
+                                                         time_t const last_modification,
+                                                         uint8_t const old_status,
+                                                         uint8_t const new_status,
+                                                         cgdb_status_cb * const cb,
+                                                         void * const cb_data)
+{
+    int result = EINVAL;
+
+    if (COMPILER_LIKELY(db != NULL &&
+                        fs_id > 0 &&
+                        inodes != NULL &&
+                        inodes_count > 0))
+    {
+        char * inodes_literal = NULL;
+
+        result = cgdb_param_array_literal_from_uint64(inodes,
+                                                      inodes_count,
+                                                      &inodes_literal);
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            static cgdb_backend_statement const statement = cgdb_backend_statement_update_set_inodes_and_all_inodes_instances_dirty_multi;
+            cgdb_param params[cgdb_backend_statement_params_count[statement]];
+            size_t const params_size = sizeof params / sizeof *params;
+            size_t param_idx = 0;
+
+            uint16_t const status_temp = new_status;
+            uint16_t const old_status_temp = old_status;
+            uint64_t const min_mtime_temp = (uint64_t) min_mtime;
+            uint64_t const min_ctime_temp = (uint64_t) min_ctime;
+            uint64_t const last_modification_temp = (uint64_t) last_modification;
+
+            cgdb_param_array_init(params, params_size);
+            cgdb_param_set_uint64(params, &param_idx, &fs_id);
+            cgdb_param_set_string(params, &param_idx, inodes_literal);
+            cgdb_param_set_uint64(params, &param_idx, &min_mtime_temp);
+            cgdb_param_set_uint64(params, &param_idx, &min_ctime_temp);
+            cgdb_param_set_uint64(params, &param_idx, &last_modification_temp);
+            cgdb_param_set_uint16(params, &param_idx, &old_status_temp);
+            cgdb_param_set_uint16(params, &param_idx, &status_temp);
+
+            cgdb_request_data * request = NULL;
+
+            result = cgdb_request_data_init(db, cb, cb_data, &request);
+
+            if (result == 0)
+            {
+                result = cgdb_backend_update(db->backend,
+                                             statement,
+                                             params,
+                                             params_size,
+                                             &cgdb_generic_status_cb,
+                                             request);
+
+                if (result != 0)
+                {
+                    CGUTILS_ERROR("Error in update operation: %d", result);
+                    cgdb_request_data_free(request), request = NULL;
+                }
+            }
+            else
+            {
+                CGUTILS_ERROR("Unable to allocate request data: %d", result);
+            }
+
+            CGUTILS_FREE(inodes_literal);
+        }
+        else
+        {
+            CGUTILS_ERROR("Error building inodes array: %d", result);
+        }
+    }
+
+    return result;
+}
+
 int cgdb_get_inode_valid_instances(cgdb_data * const db,
                                    uint64_t const fs_id,
                                    uint64_t const inode_number,
@@ -2385,60 +2561,25 @@ static int cgdb_get_directory_entries_cb(cgdb_backend_cursor * cursor,
 
         if (rows_count > 0)
         {
-            result = cgutils_vector_init(rows_count,
-                                         &entries);
+            /* the backend has decoded the rows into entries */
+            entries = rows, rows = NULL;
 
-            if (result == 0)
+            for (size_t idx = 0;
+                 result == 0 &&
+                     idx < rows_count;
+                 idx++)
             {
-                for (size_t idx = 0;
-                     result == 0 &&
-                         idx < rows_count;
-                     idx++)
-                {
-                    cgdb_row * row = NULL;
+                cgdb_entry * entry = NULL;
 
-                    result = cgutils_vector_get(rows,
-                                                idx,
-                                                (void *) &row);
-
-                    if (result == 0)
-                    {
-                        CGUTILS_ASSERT(row != NULL);
-
-                        cgdb_entry * entry = NULL;
-
-                        result = cgdb_get_entry_from_row(row, &entry);
-
-                        if (result == 0)
-                        {
-                            result = cgutils_vector_add(entries,
-                                                        entry);
+                result = cgutils_vector_get(entries,
+                                            idx,
+                                            (void *) &entry);
 
-                            if (result != 0)
-                            {
-                                CGUTILS_ERROR("Error inserting entry in vector: %d", result);
-                                cgdb_entry_free(entry), entry = NULL;
-                            }
-                        }
-                        else
-                        {
-                            CGUTILS_ERROR("Error getting entry from row: %d", result);
-                        }
-                    }
-                    else
-                    {
-                        CGUTILS_ERROR("Error getting row %zu on %zu: %d",
-                                      idx,
-                                      rows_count,
-                                      result);
-                    }
+                if (result == 0)
+                {
+                    cgdb_entry_finish_decoding(entry);
                 }
             }
-            else
-            {
-                result = ENOMEM;
-                CGUTILS_ERROR("Error creating vector: %d", result);
-            }
         }
     }
     else
@@ -2450,7 +2591,7 @@ static int cgdb_get_directory_entries_cb(cgdb_backend_cursor * cursor,
 
     if (rows != NULL)
     {
-        cgutils_vector_deep_free(&rows, &cgdb_row_delete);
+        cgutils_vector_deep_free(&rows, &cgdb_entry_delete);
     }
 
     if (result != 0 &&
@@ -2527,29 +2668,32 @@ int cgdb_get_inode_entries(cgdb_data * const db,
     return result;
 }
 
-int cgdb_get_inode_instances_by_status(cgdb_data * const db,
-                                       uint8_t const status,
-                                       cgdb_limit_type const limit,
-                                       cgdb_skip_type const skip,
-                                       cgdb_multiple_inode_instances_getter_cb * const cb,
-                                       void * const cb_data)
+int cgdb_get_inode_entries_page(cgdb_data * const db,
+                                uint64_t const fs_id,
+                                uint64_t const directory_inode_id,
+                                uint64_t const after_entry_id,
+                                cgdb_limit_type const limit,
+                                cgdb_multiple_entries_getter_cb * const cb,
+                                void * const cb_data)
 {
     int result = EINVAL;
 
-    if (db != NULL && cb != NULL && limit > 0)
+    if (COMPILER_LIKELY(db != NULL &&
+                        fs_id > 0 &&
+                        directory_inode_id > 0 &&
+                        limit > 0 &&
+                        cb != NULL))
     {
-        static cgdb_backend_statement const statement = cgdb_backend_statement_get_inode_instances_by_status;
+        static cgdb_backend_statement const statement = cgdb_backend_statement_get_inode_entries_page;
         cgdb_param params[cgdb_backend_statement_params_count[statement]];
         size_t const params_size = sizeof params / sizeof *params;
         size_t param_idx = 0;
 
-        uint16_t const status_temp = status;
-        static char const order_by_str[] = "upload_failures ASC, inode_mtime";
-
         cgdb_param_array_init(params, params_size);
 
-        cgdb_param_set_uint16(params, &param_idx, &status_temp);
-        cgdb_param_set_immutable_string(params, &param_idx, order_by_str);
+        cgdb_param_set_uint64(params, &param_idx, &fs_id);
+        cgdb_param_set_uint64(params, &param_idx, &directory_inode_id);
+        cgdb_param_set_uint64(params, &param_idx, &after_entry_id);
 
         cgdb_request_data * request = NULL;
 
@@ -2557,14 +2701,16 @@ int cgdb_get_inode_instances_by_status(cgdb_data * const db,
 
         if (result == 0)
         {
+            request->entry_id = directory_inode_id;
+
             result = cgdb_backend_find(db->backend,
                                        statement,
                                        params,
-                                       /* limit and skip are omitted */
-                                       params_size - 2,
+                                       /* limit is omitted */
+                                       params_size - 1,
                                        limit,
-                                       skip,
-                                       &cgdb_get_inode_instances_cb,
+                                       CGDB_SKIP_NONE,
+                                       &cgdb_get_directory_entries_cb,
                                        request);
 
             if (result != 0)
@@ -2582,6 +2728,61 @@ int cgdb_get_inode_instances_by_status(cgdb_data * const db,
     return result;
 }
 
+int cgdb_claim_inode_instances_by_status(cgdb_data * const db,
+                                         uint8_t const status,
+                                         uint64_t const lease_duration,
+                                         cgdb_limit_type const limit,
+                                         cgdb_multiple_inode_instances_getter_cb * const cb,
+                                         void * const cb_data)
+{
+    int result = EINVAL;
+
+    if (db != NULL && cb != NULL && limit > 0)
+    {
+        static cgdb_backend_statement const statement = cgdb_backend_statement_claim_inode_instances_by_status;
+        cgdb_param params[cgdb_backend_statement_params_count[statement]];
+        size_t const params_size = sizeof params / sizeof *params;
+        size_t param_idx = 0;
+
+        uint16_t const status_temp = status;
+        uint64_t const limit_temp = (uint64_t) limit;
+
+        cgdb_param_array_init(params, params_size);
+
+        cgdb_param_set_uint16(params, &param_idx, &status_temp);
+        cgdb_param_set_uint64(params, &param_idx, &lease_duration);
+        cgdb_param_set_uint64(params, &param_idx, &limit_temp);
+
+        cgdb_request_data * request = NULL;
+
+        result = cgdb_request_data_init(db, cb, cb_data, &request);
+
+        if (result == 0)
+        {
+            /* not a find: the claim updates the work queue, so it has to go
+               to the primary */
+            result = cgdb_backend_exec_rows_stmt(db->backend,
+                                                 statement,
+                                                 params,
+                                                 params_size,
+                                                 &cgdb_get_inode_instances_cb,
+                                                 request);
+
+            if (result != 0)
+            {
+                CGUTILS_ERROR("Error in rows statement operation: %d", result);
+                cgdb_request_data_free(request), request = NULL;
+            }
+        }
+        else
+        {
+            CGUTILS_ERROR("Unable to allocate request data: %d", result);
+        }
+    }
+
+    return result;
+}
+
 int cgdb_clear_inodes_instances_flags(cgdb_data * const db,
                                       cgdb_status_cb * const cb,
                                       void * const cb_data)
@@ -2700,62 +2901,30 @@ static int cgdb_get_entries_cb(cgdb_backend_cursor * cursor,
 
         if (rows_count > 0)
         {
-            result = cgutils_vector_init(rows_count,
-                                         &entries);
+            /* the backend has decoded the rows into entries */
+            entries = rows, rows = NULL;
 
-            if (result == 0)
+            for (size_t idx = 0;
+                 result == 0 &&
+                     idx < rows_count;
+                 idx++)
             {
-                for (size_t idx = 0;
-                     result == 0 &&
-                         idx < rows_count;
-                     idx++)
-                {
-                    cgdb_row const * row = NULL;
-
-                    result = cgutils_vector_get(rows,
-                                                idx,
-                                                (void *) &row);
-
-                    if (result == 0)
-                    {
-                        cgdb_entry * entry = NULL;
-
-                        result = cgdb_get_entry_from_row(row, &entry);
-
-                        if (result == 0)
-                        {
-                            result = cgutils_vector_add(entries,
-                                                        entry);
+                cgdb_entry * entry = NULL;
 
-                            if (result != 0)
-                            {
-                                CGUTILS_ERROR("Error inserting entry into vector: %d", result);
-                                cgdb_entry_free(entry), entry = NULL;
-                            }
-                        }
-                        else
-                        {
-                            CGUTILS_ERROR("Unable to get entry from database row: %d", result);
-                        }
-                    }
-                    else
-                    {
-                        CGUTILS_ERROR("Error getting rows %zu on %zu: %d",
-                                      idx,
-                                      rows_count,
-                                      result);
-                    }
-                }
+                result = cgutils_vector_get(entries,
+                                            idx,
+                                            (void *) &entry);
 
-                if (result != 0)
+                if (result == 0)
                 {
-                    cgutils_vector_deep_free(&entries,
-                                             &cgdb_entry_delete);
+                    cgdb_entry_finish_decoding(entry);
                 }
             }
-            else
+
+            if (result != 0)
             {
-                CGUTILS_ERROR("Error creating entries vector: %d", result);
+                cgutils_vector_deep_free(&entries,
+                                         &cgdb_entry_delete);
             }
         }
     }
@@ -2766,7 +2935,7 @@ static int cgdb_get_entries_cb(cgdb_backend_cursor * cursor,
 
     if (rows != NULL)
     {
-        cgutils_vector_deep_free(&rows, &cgdb_row_delete);
+        cgutils_vector_deep_free(&rows, &cgdb_entry_delete);
     }
 
     result = (*((cgdb_multiple_entries_getter_cb *)request->cb))(result,
@@ -2787,8 +2956,8 @@ int cgdb_get_not_dirty_entries_by_type_size_last_usage_cached(cgdb_data * const
                                                               size_t const min_size,
                                                               uint64_t const max_usage,
                                                               uint16_t const dirty_status,
+                                                              uint64_t const after_entry_id,
                                                               cgdb_limit_type const limit,
-                                                              cgdb_skip_type const skip,
                                                               cgdb_multiple_entries_getter_cb * const cb,
                                                               void * const cb_data)
 {
@@ -2809,7 +2978,6 @@ int cgdb_get_not_dirty_entries_by_type_size_last_usage_cached(cgdb_data * const
         uint16_t const type_temp = (uint16_t) type;
         uint16_t const status_temp = dirty_status;
         bool const in_cache = true;
-        static char const order_by_str[] = "mtime";
 
         cgdb_param_array_init(params, params_size);
 
@@ -2819,7 +2987,7 @@ int cgdb_get_not_dirty_entries_by_type_size_last_usage_cached(cgdb_data * const
         cgdb_param_set_uint64(params, &param_idx, &max_usage);
         cgdb_param_set_boolean(params, &param_idx, &in_cache);
         cgdb_param_set_uint16(params, &param_idx, &status_temp);
-        cgdb_param_set_immutable_string(params, &param_idx, order_by_str);
+        cgdb_param_set_uint64(params, &param_idx, &after_entry_id);
 
         cgdb_request_data * request = NULL;
 
@@ -2833,10 +3001,10 @@ int cgdb_get_not_dirty_entries_by_type_size_last_usage_cached(cgdb_data * const
             result = cgdb_backend_find(db->backend,
                                        statement,
                                        params,
-                                       /* limit and skip are omitted */
-                                       params_size - 2,
+                                       /* limit is omitted */
+                                       params_size - 1,
                                        limit,
-                                       skip,
+                                       CGDB_SKIP_NONE,
                                        &cgdb_get_entries_cb,
                                        request);
 
@@ -2855,6 +3023,151 @@ int cgdb_get_not_dirty_entries_by_type_size_last_usage_cached(cgdb_data * const
     return result;
 }
 
+int cgdb_get_inodes_info_multi(cgdb_data * const db,
+                               uint64_t const fs_id,
+                               uint64_t const * const inodes,
+                               size_t const inodes_count,
+                               cgdb_multiple_entries_getter_cb * const cb,
+                               void * const cb_data)
+{
+    int result = EINVAL;
+
+    if (COMPILER_LIKELY(db != NULL &&
+                        fs_id > 0 &&
+                        inodes != NULL &&
+                        inodes_count > 0 &&
+                        cb != NULL))
+    {
+        char * inodes_literal = NULL;
+
+        result = cgdb_param_array_literal_from_uint64(inodes,
+                                                      inodes_count,
+                                                      &inodes_literal);
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            static cgdb_backend_statement const statement = cgdb_backend_statement_get_inodes_info_multi;
+            cgdb_param params[cgdb_backend_statement_params_count[statement]];
+            size_t const params_size = sizeof params / sizeof *params;
+            size_t param_idx = 0;
+
+            cgdb_param_array_init(params, params_size);
+
+            cgdb_param_set_uint64(params, &param_idx, &fs_id);
+            cgdb_param_set_string(params, &param_idx, inodes_literal);
+
+            cgdb_request_data * request = NULL;
+
+            result = cgdb_request_data_init(db, cb, cb_data, &request);
+
+            if (result == 0)
+            {
+                result = cgdb_backend_find(db->backend,
+                                           statement,
+                                           params,
+                                           /* limit is omitted */
+                                           params_size - 1,
+                                           (cgdb_limit_type) inodes_count,
+                                           CGDB_SKIP_NONE,
+                                           &cgdb_get_entries_cb,
+                                           request);
+
+                if (result != 0)
+                {
+                    CGUTILS_ERROR("Error in find operation: %d", result);
+                    cgdb_request_data_free(request), request = NULL;
+                }
+            }
+            else
+            {
+                CGUTILS_ERROR("Unable to allocate request data: %d", result);
+            }
+
+            CGUTILS_FREE(inodes_literal);
+        }
+        else
+        {
+            CGUTILS_ERROR("Error building inodes array: %d", result);
+        }
+    }
+
+    return result;
+}
+
+int cgdb_get_children_inodes_info_multi(cgdb_data * const db,
+                                        uint64_t const fs_id,
+                                        uint64_t const parent_ino,
+                                        char const * const * const names,
+                                        size_t const names_count,
+                                        cgdb_multiple_entries_getter_cb * const cb,
+                                        void * const cb_data)
+{
+    int result = EINVAL;
+
+    if (COMPILER_LIKELY(db != NULL &&
+                        fs_id > 0 &&
+                        parent_ino >= 1 &&
+                        names != NULL &&
+                        names_count > 0 &&
+                        cb != NULL))
+    {
+        char * names_literal = NULL;
+
+        result = cgdb_param_array_literal_from_strings(names,
+                                                       names_count,
+                                                       &names_literal);
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            static cgdb_backend_statement const statement = cgdb_backend_statement_get_children_inodes_info_multi;
+            cgdb_param params[cgdb_backend_statement_params_count[statement]];
+            size_t const params_size = sizeof params / sizeof *params;
+            size_t param_idx = 0;
+
+            cgdb_param_array_init(params, params_size);
+
+            cgdb_param_set_uint64(params, &param_idx, &fs_id);
+            cgdb_param_set_uint64(params, &param_idx, &parent_ino);
+            cgdb_param_set_string(params, &param_idx, names_literal);
+
+            cgdb_request_data * request = NULL;
+
+            result = cgdb_request_data_init(db, cb, cb_data, &request);
+
+            if (result == 0)
+            {
+                result = cgdb_backend_find(db->backend,
+                                           statement,
+                                           params,
+                                           /* limit is omitted */
+                                           params_size - 1,
+                                           (cgdb_limit_type) names_count,
+                                           CGDB_SKIP_NONE,
+                                           &cgdb_get_entries_cb,
+                                           request);
+
+                if (result != 0)
+                {
+                    CGUTILS_ERROR("Error in find operation: %d", result);
+                    cgdb_request_data_free(request), request = NULL;
+                }
+            }
+            else
+            {
+                CGUTILS_ERROR("Unable to allocate request data: %d", result);
+            }
+
+            CGUTILS_FREE(names_literal);
+        }
+        else
+        {
+            CGUTILS_ERROR("Error building names array: %d", result);
+        }
+    }
+
+    return result;
+}
+
 void cgdb_inode_clean(cgdb_inode * this)
 {
     if (COMPILER_LIKELY(this != NULL))
@@ -3615,6 +3928,88 @@ int cgdb_sync_test_credentials(cgdb_data * const db,
     return result;
 }
 
+struct cgdb_listener
+{
+    cgdb_data * db;
+    cgdb_backend_listener * backend_listener;
+    cgdb_notification_cb * cb;
+    void * cb_data;
+};
+
+static void cgdb_listener_notification_cb(int const status,
+                                          char const * const payload,
+                                          void * const cb_data)
+{
+    cgdb_listener * const listener = cb_data;
+    CGUTILS_ASSERT(cb_data != NULL);
+    CGUTILS_ASSERT(listener->cb != NULL);
+
+    (*(listener->cb))(status,
+                      payload,
+                      listener->cb_data);
+}
+
+int cgdb_listen(cgdb_data * const db,
+                char const * const channel,
+                cgdb_notification_cb * const cb,
+                void * const cb_data,
+                cgdb_listener ** const out)
+{
+    int result = EINVAL;
+
+    if (db != NULL && channel != NULL && cb != NULL && out != NULL)
+    {
+        cgdb_listener * listener = NULL;
+
+        CGUTILS_ALLOCATE_STRUCT(listener);
+
+        if (listener != NULL)
+        {
+            listener->db = db;
+            listener->cb = cb;
+            listener->cb_data = cb_data;
+
+            result = cgdb_backend_listen(db->backend,
+                                         channel,
+                                         &cgdb_listener_notification_cb,
+                                         listener,
+                                         &(listener->backend_listener));
+
+            if (result == 0)
+            {
+                *out = listener;
+            }
+            else
+            {
+                CGUTILS_FREE(listener);
+            }
+        }
+        else
+        {
+            result = ENOMEM;
+        }
+    }
+
+    return result;
+}
+
+void cgdb_listener_free(cgdb_listener * listener)
+{
+    if (listener != NULL)
+    {
+        CGUTILS_ASSERT(listener->db != NULL);
+
+        cgdb_backend_listener_destroy(listener->db->backend,
+                                      listener->backend_listener);
+        listener->backend_listener = NULL;
+        listener->db = NULL;
+        listener->cb = NULL;
+        listener->cb_data = NULL;
+
+        CGUTILS_FREE(listener);
+    }
+}
+
 int cgdb_add_person(cgdb_data * const db,
                     uint64_t const id,
                     char const * const name,
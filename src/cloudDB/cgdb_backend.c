@@ -24,6 +24,7 @@
 #include <assert.h>
 #include <dlfcn.h>
 #include <errno.h>
+#include <stddef.h>
 #include <string.h>
 
 #include "cloudutils/cloudutils.h"
@@ -39,6 +40,91 @@ struct cgdb_backend
     void * backend_data;
 };
 
+typedef enum
+{
+    cgdb_backend_row_layout_none = 0,
+#define LAYOUT_BEGIN(name, type, freer) cgdb_backend_row_layout_ ## name,
+#define COLUMN(layout, name, member, kind, optional)
+#define LAYOUT_END(name)
+#include "cgdb/cgdb_backend_row_layouts.itm"
+#undef LAYOUT_END
+#undef COLUMN
+#undef LAYOUT_BEGIN
+    cgdb_backend_row_layout_count
+} cgdb_backend_row_layout_type;
+
+#define LAYOUT_BEGIN(name, type, freer)                                 \
+    typedef type cgdb_backend_row_layout_ ## name ## _type;             \
+    static cgdb_backend_row_column const cgdb_backend_row_layout_ ## name ## _columns[] = {
+#define COLUMN(layout, name, member, kind, optional)                     \
+    {                                                                   \
+        #name,                                                          \
+        offsetof(cgdb_backend_row_layout_ ## layout ## _type, member),  \
+        sizeof (((cgdb_backend_row_layout_ ## layout ## _type *) NULL)->member), \
+        cgdb_backend_row_column_kind_ ## kind,                          \
+        optional                                                        \
+    },
+#define LAYOUT_END(name) };
+#include "cgdb/cgdb_backend_row_layouts.itm"
+#undef LAYOUT_END
+#undef COLUMN
+#undef LAYOUT_BEGIN
+
+static cgdb_backend_row_layout const cgdb_backend_row_layouts[] =
+{
+    { NULL, 0, 0, NULL },
+#define LAYOUT_BEGIN(name, type, freer)                                 \
+    {                                                                   \
+        cgdb_backend_row_layout_ ## name ## _columns,                   \
+        sizeof cgdb_backend_row_layout_ ## name ## _columns / sizeof *cgdb_backend_row_layout_ ## name ## _columns, \
+        sizeof (type),                                                  \
+        &freer                                                          \
+    },
+#define COLUMN(layout, name, member, kind, optional)
+#define LAYOUT_END(name)
+#include "cgdb/cgdb_backend_row_layouts.itm"
+#undef LAYOUT_END
+#undef COLUMN
+#undef LAYOUT_BEGIN
+};
+
+static cgdb_backend_row_layout_type const cgdb_backend_statement_row_layouts[] =
+{
+    cgdb_backend_row_layout_none,
+#define STMT(name, count, layout) cgdb_backend_row_layout_ ## layout,
+#include "cgdb/cgdb_backend_statements.itm"
+#undef STMT
+    cgdb_backend_row_layout_none
+};
+
+cgdb_backend_row_layout const * cgdb_backend_get_row_layout(cgdb_backend_statement const statement)
+{
+    cgdb_backend_row_layout const * result = NULL;
+
+#define LAYOUT_BEGIN(name, type, freer)                                 \
+    COMPILER_STATIC_ASSERT(sizeof cgdb_backend_row_layout_ ## name ## _columns / sizeof *cgdb_backend_row_layout_ ## name ## _columns <= CGDB_BACKEND_ROW_LAYOUT_MAX_COLUMNS, \
+                           "Too many columns in the " #name " row layout");
+#define COLUMN(layout, name, member, kind, optional)
+#define LAYOUT_END(name)
+#include "cgdb/cgdb_backend_row_layouts.itm"
+#undef LAYOUT_END
+#undef COLUMN
+#undef LAYOUT_BEGIN
+
+    if (statement > cgdb_backend_statement_none &&
+        statement < cgdb_backend_statement_count)
+    {
+        cgdb_backend_row_layout_type const layout = cgdb_backend_statement_row_layouts[statement];
+
+        if (layout != cgdb_backend_row_layout_none)
+        {
+            result = &(cgdb_backend_row_layouts[layout]);
+        }
+    }
+
+    return result;
+}
+
 static int cgdb_backend_load(cgdb_backend * const this,
                              cgutils_event_data * const event_data,
                              cgutils_configuration * const config)
@@ -478,6 +564,62 @@ int cgdb_backend_exec_rows_stmt(cgdb_backend * const backend,
     return result;
 }
 
+int cgdb_backend_exec_batch(cgdb_backend * const backend,
+                            cgdb_backend_batch_stmt const * const stmts,
+                            size_t const stmts_count,
+                            cgdb_backend_status_cb * const cb,
+                            void * const cb_data)
+{
+    int result = ENOSYS;
+
+    assert(backend != NULL && stmts != NULL);
+
+    if (backend->ops.exec_batch != NULL)
+    {
+        result = (*(backend->ops.exec_batch))(backend->backend_data,
+                                              stmts,
+                                              stmts_count,
+                                              cb,
+                                              cb_data);
+    }
+
+    return result;
+}
+
+int cgdb_backend_listen(cgdb_backend * const backend,
+                        char const * const channel,
+                        cgdb_backend_notification_cb * const cb,
+                        void * const cb_data,
+                        cgdb_backend_listener ** const listener)
+{
+    int result = ENOSYS;
+
+    assert(backend != NULL && channel != NULL && cb != NULL && listener != NULL);
+
+    if (backend->ops.listen != NULL)
+    {
+        result = (*(backend->ops.listen))(backend->backend_data,
+                                          channel,
+                                          cb,
+                                          cb_data,
+                                          listener);
+    }
+
+    return result;
+}
+
+void cgdb_backend_listener_destroy(cgdb_backend * const backend,
+                                   cgdb_backend_listener * const listener)
+{
+    if (backend != NULL && listener != NULL)
+    {
+        if (backend->ops.destroy_listener != NULL)
+        {
+            (*(backend->ops.destroy_listener))(backend->backend_data, listener);
+        }
+    }
+}
+
 int cgdb_backend_sync_test_credentials(cgdb_backend * const backend,
                                        char ** const error_str_out)
 {
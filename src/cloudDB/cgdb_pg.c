@@ -52,6 +52,7 @@ I'm really sorry guys: */
 
 #define CGDB_PG_DEFAULT_POOL_SIZE (20)
 #define CGDB_PG_DEFAULT_CONNECTION_RETRY (3)
+#define CGDB_PG_DEFAULT_PIPELINE_CONNECTIONS (4)
 
 #define CGDB_PG_NO_STATUS_CB (NULL)
 #define CGDB_PG_NO_STATUS_RETURNING_CB (NULL)
@@ -59,6 +60,7 @@ I'm really sorry guys: */
 
 typedef struct cgdb_pg_data cgdb_pg_data;
 typedef struct cgdb_pg_cursor cgdb_pg_cursor;
+typedef struct cgdb_pg_shared_conn cgdb_pg_shared_conn;
 
 struct cgdb_pg_data
 {
@@ -67,7 +69,14 @@ struct cgdb_pg_data
     char * read_only_conn_str;
     cgutils_pool * conn_pool;
     cgutils_pool * read_only_conn_pool;
+    /* Connections in pipeline mode shared by the
+       asynchronous cursors (cgdb_pg_shared_conn *) */
+    cgutils_llist * shared_conns;
+    size_t shared_conns_max;
     size_t connections_max_retry;
+    /* Entering pipeline mode failed, each cursor
+       uses a connection of its own */
+    bool pipeline_unavailable;
 };
 
 typedef struct
@@ -83,7 +92,9 @@ typedef enum
 {
     cgdb_pg_state_sending_query,
     cgdb_pg_state_preparing_statement,
-    cgdb_pg_state_executing_statement
+    cgdb_pg_state_executing_statement,
+    cgdb_pg_state_beginning_batch,
+    cgdb_pg_state_committing_batch
 } cgdb_pg_state;
 
 typedef struct
@@ -110,6 +121,12 @@ typedef struct
     size_t name_len;
 } cgdb_field_description;
 
+typedef struct
+{
+    cgdb_pg_prepared_stmt_params * stmt_params;
+    cgdb_backend_statement statement;
+} cgdb_pg_batch_stmt;
+
 struct cgdb_pg_cursor
 {
     cgdb_pg_conn * conn;
@@ -117,6 +134,10 @@ struct cgdb_pg_cursor
 
     cgdb_pg_data * data;
 
+    /* Set while the statements of this cursor are in flight on a
+       shared connection, conn then belongs to the shared connection */
+    cgdb_pg_shared_conn * shared_conn;
+
     cgdb_backend_cursor_cb * cursor_cb;
     cgdb_backend_status_cb * status_cb;
     cgdb_backend_status_returning_cb * status_returning_cb;
@@ -129,8 +150,23 @@ struct cgdb_pg_cursor
 
     cgdb_field_description * fields_descriptions;
 
+    /* For statements with a row layout, rows are decoded straight
+       into the target structure. */
+    cgdb_backend_row_layout const * row_layout;
+    /* Index in the result of each column of the layout, -1 if missing */
+    int row_layout_fields[CGDB_BACKEND_ROW_LAYOUT_MAX_COLUMNS];
+    Oid row_layout_types[CGDB_BACKEND_ROW_LAYOUT_MAX_COLUMNS];
+
     cgdb_pg_prepared_stmt_params * stmt_params;
 
+    /* Statements sent in the same pipeline after the main one,
+       for batches */
+    cgdb_pg_batch_stmt * batch;
+    size_t batch_count;
+    /* Without pipeline, how many of the batch statements
+       have already been sent, one after the other */
+    size_t batch_done;
+
     cgutils_vector * rows;
 
     size_t rows_count;
@@ -158,8 +194,62 @@ struct cgdb_pg_cursor
     bool read_only;
     bool returning_id;
     bool fatal_error;
+    /* The connection is in pipeline mode, the statement is
+       prepared (if needed) and executed in a single round trip */
+    bool pipeline;
+    /* A statement has been prepared in the pipeline
+       along with the statements of this cursor */
+    bool prepared_in_pipeline;
+    /* The batch is sent one statement at a time,
+       inside an explicit transaction */
+    bool sequential_batch;
+    bool row_layout_resolved;
 };
 
+/* A connection in pipeline mode, shared by the asynchronous cursors.
+   Each cursor sends its statements followed by a sync point, so the
+   results are read in order and an error only affects its own cursor. */
+struct cgdb_pg_shared_conn
+{
+    cgdb_pg_data * data;
+    cgdb_pg_conn * conn;
+    /* Cursors waiting for the connection to be established */
+    cgutils_llist * waiting;
+    /* Cursors whose statements have been sent, in order */
+    cgutils_llist * in_flight;
+    bool read_only;
+    bool connected;
+    /* Some output has not been flushed yet */
+    bool flushing;
+    /* Results are being handled, the connection can not be freed */
+    bool handling;
+    /* No new cursor, freed once the ones in flight are done */
+    bool retired;
+};
+
+typedef enum
+{
+    cgdb_pg_listener_state_connecting,
+    cgdb_pg_listener_state_sending,
+    cgdb_pg_listener_state_listening,
+    cgdb_pg_listener_state_failed
+} cgdb_pg_listener_state;
+
+/* A dedicated connection, never returned to the pool since
+   LISTEN is tied to the session */
+typedef struct
+{
+    cgdb_pg_data * data;
+    PGconn * conn;
+    cgutils_event * conn_event;
+    char * channel;
+    cgdb_backend_notification_cb * cb;
+    void * cb_data;
+    cgdb_pg_listener_state state;
+    /* The LISTEN query has succeeded */
+    bool ready;
+} cgdb_pg_listener;
+
 static struct
 {
     char const * name;
@@ -227,12 +317,19 @@ static void cgdb_pg_conn_delete(void * conn)
     cgdb_pg_conn_free(conn);
 }
 
+static void cgdb_pg_shared_conn_delete(void * this);
+
 static void cgdb_pg_free(void * this)
 {
     if (this != NULL)
     {
         cgdb_pg_data * data = this;
 
+        if (data->shared_conns != NULL)
+        {
+            cgutils_llist_free(&(data->shared_conns), &cgdb_pg_shared_conn_delete);
+        }
+
         if (data->conn_str != NULL)
         {
             CGUTILS_FREE(data->conn_str);
@@ -342,72 +439,99 @@ static int cgdb_pg_init(cgutils_event_data * const event_data,
 
                     if (result == 0 || result == ENOENT)
                     {
-                        cgdb_pg_data ** data = (cgdb_pg_data ** )out;
+                        uint64_t pipeline_connections = 0;
 
                         if (result == ENOENT)
                         {
-                            result = 0;
                             connection_retry = CGDB_PG_DEFAULT_CONNECTION_RETRY;
                         }
 
-                        CGUTILS_ALLOCATE_STRUCT(*data);
+                        result = cgutils_configuration_get_unsigned_integer(config,
+                                                                            "PipelineConnections",
+                                                                            &pipeline_connections);
 
-                        if (*data != NULL)
+                        if (result == 0 || result == ENOENT)
                         {
-                            if (pool_size > 0)
+                            cgdb_pg_data ** data = (cgdb_pg_data ** )out;
+
+                            if (result == ENOENT)
+                            {
+                                result = 0;
+                                pipeline_connections = CGDB_PG_DEFAULT_PIPELINE_CONNECTIONS;
+                            }
+
+#if !defined(LIBPQ_HAS_PIPELINING)
+                            /* Connections can only be shared in pipeline mode */
+                            pipeline_connections = 0;
+#endif /* LIBPQ_HAS_PIPELINING */
+
+                            CGUTILS_ALLOCATE_STRUCT(*data);
+
+                            if (*data != NULL)
                             {
-                                result = cgutils_pool_init((size_t) pool_size,
-                                                           &cgdb_pg_conn_delete,
-                                                           false,
-                                                           false,
-                                                           &((*data)->conn_pool));
-
-                                if (result == 0
-                                    && read_only_conn_str != NULL)
+                                result = cgutils_llist_create(&((*data)->shared_conns));
+
+                                if (result == 0 &&
+                                    pool_size > 0)
                                 {
                                     result = cgutils_pool_init((size_t) pool_size,
                                                                &cgdb_pg_conn_delete,
                                                                false,
                                                                false,
-                                                               &((*data)->read_only_conn_pool));
+                                                               &((*data)->conn_pool));
+
+                                    if (result == 0
+                                        && read_only_conn_str != NULL)
+                                    {
+                                        result = cgutils_pool_init((size_t) pool_size,
+                                                                   &cgdb_pg_conn_delete,
+                                                                   false,
+                                                                   false,
+                                                                   &((*data)->read_only_conn_pool));
+                                    }
                                 }
-                            }
 
-                            if (result == 0)
-                            {
-                                (*data)->event_data = event_data;
-                                (*data)->conn_str = conn_str;
+                                if (result == 0)
+                                {
+                                    (*data)->event_data = event_data;
+                                    (*data)->conn_str = conn_str;
 
-                                (*data)->read_only_conn_str = read_only_conn_str;
-                                read_only_conn_str = NULL;
-                                (*data)->connections_max_retry = connection_retry;
+                                    (*data)->read_only_conn_str = read_only_conn_str;
+                                    read_only_conn_str = NULL;
+                                    (*data)->connections_max_retry = connection_retry;
+                                    (*data)->shared_conns_max = (size_t) pipeline_connections;
 
-                                conn_str = NULL;
+                                    conn_str = NULL;
 
-                                /* We let libpq know that libssl and libcrypto have already been initialized,
-                                 otherwise attempting to connect to a PG server over TLS will fail. */
-                                PQinitOpenSSL(0, 0);
+                                    /* We let libpq know that libssl and libcrypto have already been initialized,
+                                     otherwise attempting to connect to a PG server over TLS will fail. */
+                                    PQinitOpenSSL(0, 0);
 
-                                result = cgdb_pg_statements_str_init();
+                                    result = cgdb_pg_statements_str_init();
+
+                                    if (result != 0)
+                                    {
+                                        CGUTILS_ERROR("Error in statements init: %d", result);
+                                    }
+                                }
+                                else
+                                {
+                                    CGUTILS_ERROR("Error in pool init: %d", result);
+                                }
 
                                 if (result != 0)
                                 {
-                                    CGUTILS_ERROR("Error in statements init: %d", result);
+                                    cgdb_pg_free(*data), *data = NULL;
                                 }
                             }
                             else
                             {
-                                CGUTILS_ERROR("Error in pool init: %d", result);
-                            }
-
-                            if (result != 0)
-                            {
-                                cgdb_pg_free(*data), *data = NULL;
+                                result = ENOMEM;
                             }
                         }
                         else
                         {
-                            result = ENOMEM;
+                            CGUTILS_ERROR("Error getting PipelineConnections for PG database: %d", result);
                         }
                     }
                     else
@@ -749,6 +873,17 @@ static void cgdb_pg_conn_release(cgdb_pg_data * const data,
     }
 }
 
+static void cgdb_pg_cursor_free_rows(cgdb_pg_cursor * const cursor)
+{
+    assert(cursor != NULL);
+
+    if (cursor->rows != NULL)
+    {
+        cgutils_vector_deep_free(&(cursor->rows),
+                                 cursor->row_layout != NULL ? cursor->row_layout->row_free : &cgdb_row_delete);
+    }
+}
+
 static void cgdb_pg_cursor_free(cgdb_pg_cursor * cursor)
 {
     if (cursor != NULL)
@@ -799,6 +934,19 @@ static void cgdb_pg_cursor_free(cgdb_pg_cursor * cursor)
             cgdb_pg_prepared_stmt_params_free(cursor->stmt_params), cursor->stmt_params = NULL;
         }
 
+        if (cursor->batch != NULL)
+        {
+            for (size_t idx = 0;
+                 idx < cursor->batch_count;
+                 idx++)
+            {
+                cgdb_pg_prepared_stmt_params_free(cursor->batch[idx].stmt_params), cursor->batch[idx].stmt_params = NULL;
+            }
+
+            CGUTILS_FREE(cursor->batch);
+            cursor->batch_count = 0;
+        }
+
         cursor->data = NULL;
         cursor->cursor_cb = NULL;
         cursor->status_cb = NULL;
@@ -850,6 +998,7 @@ static int cgdb_pg_cursor_init(cgdb_pg_data * const data,
             cursor->skip = skip;
             cursor->read_only = read_only;
             cursor->blocking = blocking;
+            cursor->row_layout = cgdb_backend_get_row_layout(statement);
 
             if (statement > cgdb_backend_statement_none &&
                 statement < cgdb_backend_statement_count)
@@ -930,6 +1079,10 @@ static void cgdb_pg_cursor_reset_for_reconnection(cgdb_pg_cursor * cursor)
 
     cursor->last_error = 0;
     cursor->fatal_error = false;
+    cursor->pipeline = false;
+    cursor->prepared_in_pipeline = false;
+    cursor->sequential_batch = false;
+    cursor->row_layout_resolved = false;
 
     cursor->connection_try_count++;
 }
@@ -941,10 +1094,7 @@ static void cgdb_pg_cursor_do_callback(cgdb_pg_cursor * cursor,
 
     if (cursor->status_cb != NULL)
     {
-        if (cursor->rows != NULL)
-        {
-            cgutils_vector_deep_free(&(cursor->rows), &cgdb_row_delete);
-        }
+        cgdb_pg_cursor_free_rows(cursor);
 
         (*(cursor->status_cb))(cursor->data,
                                status,
@@ -954,10 +1104,7 @@ static void cgdb_pg_cursor_do_callback(cgdb_pg_cursor * cursor,
     else if (cursor->returning_id == true &&
              cursor->status_returning_cb != NULL)
     {
-        if (cursor->rows != NULL)
-        {
-            cgutils_vector_deep_free(&(cursor->rows), &cgdb_row_delete);
-        }
+        cgdb_pg_cursor_free_rows(cursor);
 
         (*(cursor->status_returning_cb))(cursor->data,
                                          status,
@@ -1230,6 +1377,275 @@ static int cgdb_pg_parse_row(cgdb_pg_cursor * const cursor,
     return result;
 }
 
+static int cgdb_pg_resolve_row_layout(cgdb_pg_cursor * const cursor,
+                                      PGresult const * const pgres)
+{
+    int result = 0;
+    assert(cursor != NULL);
+    assert(cursor->row_layout != NULL);
+    assert(pgres != NULL);
+
+    cgdb_backend_row_layout const * const layout = cursor->row_layout;
+    CGUTILS_ASSERT(layout->columns_count <= CGDB_BACKEND_ROW_LAYOUT_MAX_COLUMNS);
+
+    for (size_t idx = 0;
+         result == 0 &&
+             idx < layout->columns_count;
+         idx++)
+    {
+        cgdb_backend_row_column const * const column = &(layout->columns[idx]);
+        /* PQ API */
+        int const field_idx = PQfnumber(pgres, column->name);
+
+        cursor->row_layout_fields[idx] = field_idx;
+
+        if (COMPILER_LIKELY(field_idx >= 0))
+        {
+            Oid const type = PQftype(pgres, field_idx);
+
+            cursor->row_layout_types[idx] = type;
+
+            if (column->kind == cgdb_backend_row_column_kind_string)
+            {
+                if (COMPILER_UNLIKELY(type != TEXTOID))
+                {
+                    result = EIO;
+                }
+            }
+            else if (COMPILER_UNLIKELY(type != INT8OID &&
+                                       type != INT4OID &&
+                                       type != INT2OID &&
+                                       type != BOOLOID))
+            {
+                result = EIO;
+            }
+
+            if (COMPILER_UNLIKELY(result != 0))
+            {
+                CGUTILS_ERROR("Unexpected type %d for column %s of statement %s: %d",
+                              type,
+                              column->name,
+                              cgdb_pg_statements[cursor->statement].name,
+                              result);
+            }
+        }
+        else if (COMPILER_UNLIKELY(column->optional == false))
+        {
+            result = EIO;
+            CGUTILS_ERROR("Column %s is missing from the result of statement %s: %d",
+                          column->name,
+                          cgdb_pg_statements[cursor->statement].name,
+                          result);
+        }
+    }
+
+    if (COMPILER_LIKELY(result == 0))
+    {
+        cursor->row_layout_resolved = true;
+    }
+
+    return result;
+}
+
+static int cgdb_pg_decode_integer(Oid const type,
+                                  void const * const field_value,
+                                  int const field_size,
+                                  uint64_t * const out)
+{
+    int result = 0;
+    size_t expected_size = 0;
+    assert(field_value != NULL);
+    assert(out != NULL);
+
+    *out = 0;
+
+    switch(type)
+    {
+    case INT8OID:
+        expected_size = sizeof (uint64_t);
+
+        if (COMPILER_LIKELY(field_size == sizeof (uint64_t)))
+        {
+            *out = cgutils_ntohll(*((uint64_t const *) field_value));
+        }
+        break;
+    case INT4OID:
+        expected_size = sizeof (int32_t);
+
+        if (COMPILER_LIKELY(field_size == sizeof (int32_t)))
+        {
+            *out = (uint64_t) (int64_t) (int32_t) cgutils_ntohl(*((uint32_t const *) field_value));
+        }
+        break;
+    case INT2OID:
+        expected_size = sizeof (int16_t);
+
+        if (COMPILER_LIKELY(field_size == sizeof (int16_t)))
+        {
+            *out = (uint64_t) (int64_t) (int16_t) cgutils_ntohs(*((uint16_t const *) field_value));
+        }
+        break;
+    case BOOLOID:
+        expected_size = sizeof (uint8_t);
+
+        if (COMPILER_LIKELY(field_size == sizeof (uint8_t)))
+        {
+            *out = *((uint8_t const *) field_value) != 0;
+        }
+        break;
+    default:
+        CGUTILS_ASSERT(false);
+    }
+
+    /* a NULL value has a size of 0 */
+    if (COMPILER_UNLIKELY(field_size != 0 &&
+                          (size_t) field_size != expected_size))
+    {
+        result = EINVAL;
+        CGUTILS_WARN("Expected field size of %zu, got %d for type %d",
+                     expected_size,
+                     field_size,
+                     type);
+    }
+
+    return result;
+}
+
+static void cgdb_pg_store_integer(cgdb_backend_row_column const * const column,
+                                  uint64_t value,
+                                  char * const member)
+{
+    assert(column != NULL);
+    assert(member != NULL);
+
+    if (column->kind == cgdb_backend_row_column_kind_signed &&
+        value > (UINT64_C(1) << (column->size * CHAR_BIT - 1)) - 1)
+    {
+        value = 0;
+    }
+
+    switch(column->size)
+    {
+    case sizeof (uint64_t):
+    {
+        uint64_t const member_value = value;
+        memcpy(member, &member_value, sizeof member_value);
+        break;
+    }
+    case sizeof (uint32_t):
+    {
+        uint32_t const member_value = (uint32_t) value;
+        memcpy(member, &member_value, sizeof member_value);
+        break;
+    }
+    case sizeof (uint16_t):
+    {
+        uint16_t const member_value = (uint16_t) value;
+        memcpy(member, &member_value, sizeof member_value);
+        break;
+    }
+    case sizeof (uint8_t):
+    {
+        uint8_t const member_value = (uint8_t) value;
+        memcpy(member, &member_value, sizeof member_value);
+        break;
+    }
+    default:
+        CGUTILS_ASSERT(false);
+    }
+}
+
+static int cgdb_pg_decode_row(cgdb_pg_cursor * const cursor,
+                              size_t const row_idx,
+                              PGresult * const pgres,
+                              void ** const out)
+{
+    int result = 0;
+    char * row = NULL;
+    assert(cursor != NULL);
+    assert(cursor->row_layout != NULL);
+    assert(cursor->row_layout_resolved == true);
+    assert(pgres != NULL);
+    assert(out != NULL);
+
+    cgdb_backend_row_layout const * const layout = cursor->row_layout;
+
+    CGUTILS_MALLOC(row, 1, layout->row_size);
+
+    if (COMPILER_LIKELY(row != NULL))
+    {
+        memset(row, 0, layout->row_size);
+
+        for (size_t idx = 0;
+             result == 0 &&
+                 idx < layout->columns_count;
+             idx++)
+        {
+            int const field_idx = cursor->row_layout_fields[idx];
+
+            if (field_idx >= 0)
+            {
+                cgdb_backend_row_column const * const column = &(layout->columns[idx]);
+                /* Sorry for the casts, but the PQ API needs to be fixed. */
+                int const field_size = PQgetlength(pgres, (int) row_idx, field_idx);
+                char const * const field_value = PQgetvalue(pgres, (int) row_idx, field_idx);
+
+                if (column->kind == cgdb_backend_row_column_kind_string)
+                {
+                    char * const value = cgutils_strdup(field_value);
+                    CGUTILS_ASSERT(column->size == sizeof value);
+
+                    if (COMPILER_LIKELY(value != NULL))
+                    {
+                        memcpy(row + column->offset, &value, sizeof value);
+                    }
+                    else
+                    {
+                        result = ENOMEM;
+                        CGUTILS_ERROR("Error allocating value of column %s: %d", column->name, result);
+                    }
+                }
+                else
+                {
+                    uint64_t value = 0;
+
+                    result = cgdb_pg_decode_integer(cursor->row_layout_types[idx],
+                                                    field_value,
+                                                    field_size,
+                                                    &value);
+
+                    if (COMPILER_LIKELY(result == 0))
+                    {
+                        cgdb_pg_store_integer(column,
+                                              value,
+                                              row + column->offset);
+                    }
+                    else
+                    {
+                        CGUTILS_ERROR("Error decoding column %s: %d", column->name, result);
+                    }
+                }
+            }
+        }
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            *out = row;
+        }
+        else
+        {
+            (*(layout->row_free))(row), row = NULL;
+        }
+    }
+    else
+    {
+        result = ENOMEM;
+        CGUTILS_ERROR("Error allocating row: %d", result);
+    }
+
+    return result;
+}
+
 static int cgdb_pg_handle_returning_id(cgdb_pg_cursor * const cursor,
                                        PGresult * const pgres)
 {
@@ -1308,7 +1724,14 @@ static int cgdb_pg_handle_rows(cgdb_pg_cursor * const cursor,
     {
         size_t vector_size = current_rows;
 
-        if (cursor->fields_descriptions == NULL)
+        if (cursor->row_layout != NULL)
+        {
+            if (cursor->row_layout_resolved == false)
+            {
+                result = cgdb_pg_resolve_row_layout(cursor, pgres);
+            }
+        }
+        else if (cursor->fields_descriptions == NULL)
         {
             cursor->fields_count = (size_t) PQnfields(pgres);
 
@@ -1406,8 +1829,19 @@ static int cgdb_pg_handle_rows(cgdb_pg_cursor * const cursor,
                      cursor->full == false;
                  idx++)
             {
-                cgdb_row * row = NULL;
-                result = cgdb_pg_parse_row(cursor, idx, pgres, &row);
+                void * row = NULL;
+
+                if (cursor->row_layout != NULL)
+                {
+                    result = cgdb_pg_decode_row(cursor, idx, pgres, &row);
+                }
+                else
+                {
+                    cgdb_row * parsed_row = NULL;
+
+                    result = cgdb_pg_parse_row(cursor, idx, pgres, &parsed_row);
+                    row = parsed_row;
+                }
 
                 if (COMPILER_LIKELY(result == 0))
                 {
@@ -1429,7 +1863,15 @@ static int cgdb_pg_handle_rows(cgdb_pg_cursor * const cursor,
                     else
                     {
                         CGUTILS_ERROR("Error while inserting row %zu into list: %d", idx, result);
-                        cgdb_row_free(row), row = NULL;
+
+                        if (cursor->row_layout != NULL)
+                        {
+                            (*(cursor->row_layout->row_free))(row), row = NULL;
+                        }
+                        else
+                        {
+                            cgdb_row_free(row), row = NULL;
+                        }
                     }
                 }
                 else if (result == ENOENT)
@@ -1450,23 +1892,409 @@ static int cgdb_pg_handle_rows(cgdb_pg_cursor * const cursor,
 static int cgdb_pg_send_data(cgdb_pg_cursor * const cursor,
                              bool const initial_flush);
 
-static int cgdb_pg_handle_statement(cgdb_pg_cursor * const cursor)
+#if defined(LIBPQ_HAS_PIPELINING)
+
+static bool cgdb_pg_conn_enter_pipeline_mode(cgdb_pg_conn * const conn)
 {
-    int result = 0;
-    assert(cursor != NULL);
-    PGconn * const conn = cgdb_pg_cursor_get_conn(cursor);
+    bool result = false;
     assert(conn != NULL);
-    assert(cursor->state == cgdb_pg_state_preparing_statement);
+    assert(conn->conn != NULL);
 
-    if (COMPILER_LIKELY(cursor->statement > cgdb_backend_statement_none &&
-                        cursor->statement < cgdb_backend_statement_count))
+    if (PQpipelineStatus(conn->conn) != PQ_PIPELINE_OFF)
     {
-        if (COMPILER_UNLIKELY(cursor->conn->stmts[cursor->statement] == false))
-        {
-            if (COMPILER_LIKELY(cgdb_pg_statements[cursor->statement].str != NULL))
-            {
-                CGUTILS_ASSERT(cgdb_pg_statements[cursor->statement].params_count ==
-                               cursor->stmt_params->count);
+        result = true;
+    }
+    else if (PQenterPipelineMode(conn->conn) == 1)
+    {
+        result = true;
+    }
+    else
+    {
+        char const * const error_str = PQerrorMessage(conn->conn);
+        CGUTILS_WARN("Error entering pipeline mode, falling back to one statement per round trip: %s",
+                     error_str != NULL ? error_str : "");
+    }
+
+    return result;
+}
+
+static int cgdb_pg_pipeline_prepare_statement(cgdb_pg_cursor * const cursor,
+                                              cgdb_backend_statement const statement,
+                                              cgdb_pg_prepared_stmt_params const * const stmt_params)
+{
+    int result = 0;
+    assert(cursor != NULL);
+    assert(stmt_params != NULL);
+    PGconn * const conn = cgdb_pg_cursor_get_conn(cursor);
+    assert(conn != NULL);
+
+    if (COMPILER_UNLIKELY(cursor->conn->stmts[statement] == false))
+    {
+        CGUTILS_ASSERT(cgdb_pg_statements[statement].params_count == stmt_params->count);
+
+        if (COMPILER_LIKELY(PQsendPrepare(conn,
+                                          cgdb_pg_statements[statement].name,
+                                          cgdb_pg_statements[statement].str,
+                                          0,
+                                          NULL) == 1))
+        {
+            /* The statement is prepared by the server before being executed
+               in this pipeline. If anything fails, the connection is not reused. */
+            cursor->conn->stmts[statement] = true;
+            cursor->prepared_in_pipeline = true;
+        }
+        else
+        {
+            char const * const error_str = PQerrorMessage(conn);
+            CGUTILS_ERROR("Error in PQsendPrepare while preparing statement %s (%s): %s",
+                          cgdb_pg_statements[statement].name,
+                          cgdb_pg_statements[statement].str,
+                          error_str != NULL ? error_str : "");
+            result = EIO;
+        }
+    }
+
+    return result;
+}
+
+static int cgdb_pg_pipeline_execute_statement(cgdb_pg_cursor * const cursor,
+                                              cgdb_backend_statement const statement,
+                                              cgdb_pg_prepared_stmt_params const * const stmt_params)
+{
+    int result = 0;
+    assert(cursor != NULL);
+    assert(stmt_params != NULL);
+    PGconn * const conn = cgdb_pg_cursor_get_conn(cursor);
+    assert(conn != NULL);
+
+    if (COMPILER_UNLIKELY(PQsendQueryPrepared(conn,
+                                              cgdb_pg_statements[statement].name,
+                                              (int) stmt_params->count,
+                                              (char const * const *) stmt_params->values,
+                                              stmt_params->lengths,
+                                              stmt_params->formats,
+                                              1) != 1))
+    {
+        char const * const error_str = PQerrorMessage(conn);
+        CGUTILS_ERROR("Error sending prepared statement %s(%s): %s",
+                      cgdb_pg_statements[statement].name,
+                      cgdb_pg_statements[statement].str,
+                      error_str != NULL ? error_str : "");
+        result = EIO;
+    }
+
+    return result;
+}
+
+static int cgdb_pg_send_pipeline(cgdb_pg_cursor * const cursor)
+{
+    int result = 0;
+    assert(cursor != NULL);
+    assert(cursor->pipeline == true);
+    PGconn * const conn = cgdb_pg_cursor_get_conn(cursor);
+    assert(conn != NULL);
+
+    if (COMPILER_LIKELY(cgdb_pg_statements[cursor->statement].str != NULL))
+    {
+        CGUTILS_ASSERT(cursor->stmt_params != NULL);
+
+        /* The statements are all prepared before the first execution,
+           so that a failing statement can not prevent the preparation
+           of another one which is then believed to be prepared. */
+        result = cgdb_pg_pipeline_prepare_statement(cursor,
+                                                    cursor->statement,
+                                                    cursor->stmt_params);
+
+        for (size_t idx = 0;
+             result == 0 &&
+                 idx < cursor->batch_count;
+             idx++)
+        {
+            result = cgdb_pg_pipeline_prepare_statement(cursor,
+                                                        cursor->batch[idx].statement,
+                                                        cursor->batch[idx].stmt_params);
+        }
+
+        /* No single row mode here: PQsetSingleRowMode() applies to the oldest
+           query not yet read, which is not this one in a pipeline. */
+        if (COMPILER_LIKELY(result == 0))
+        {
+            result = cgdb_pg_pipeline_execute_statement(cursor,
+                                                        cursor->statement,
+                                                        cursor->stmt_params);
+        }
+
+        for (size_t idx = 0;
+             result == 0 &&
+                 idx < cursor->batch_count;
+             idx++)
+        {
+            result = cgdb_pg_pipeline_execute_statement(cursor,
+                                                        cursor->batch[idx].statement,
+                                                        cursor->batch[idx].stmt_params);
+        }
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            /* Everything up to the sync point is executed
+               in a single implicit transaction. */
+            if (COMPILER_LIKELY(PQpipelineSync(conn) == 1))
+            {
+                cursor->state = cgdb_pg_state_executing_statement;
+            }
+            else
+            {
+                char const * const error_str = PQerrorMessage(conn);
+                CGUTILS_ERROR("Error marking pipeline sync point: %s",
+                              error_str != NULL ? error_str : "");
+                result = EIO;
+            }
+        }
+    }
+    else
+    {
+        result = ENOENT;
+    }
+
+    return result;
+}
+
+/* Reads the results of the cursor statements up to its sync point.
+   An error on a statement is stored in the cursor, and the following
+   results are still read so that the connection stays usable.
+   Only an unexpected end of the results is returned as an error. */
+static int cgdb_pg_read_pipeline_results(cgdb_pg_cursor * const cursor,
+                                         bool * const busy,
+                                         bool * const synced)
+{
+    int result = 0;
+    assert(cursor != NULL);
+    assert(cursor->conn != NULL);
+    assert(cursor->pipeline == true);
+    assert(busy != NULL);
+    assert(synced != NULL);
+
+    PGconn * const conn = cgdb_pg_cursor_get_conn(cursor);
+    assert(conn != NULL);
+    /* PQgetResult() returns NULL once after the results of each statement,
+       twice in a row means that there is nothing left to read. */
+    bool end_of_statement = false;
+
+    *busy = false;
+    *synced = false;
+
+    while (result == 0 &&
+           *synced == false &&
+           *busy == false)
+    {
+        if (PQisBusy(conn) == 1)
+        {
+            *busy = true;
+        }
+        else
+        {
+            cursor->result = PQgetResult(conn);
+
+            if (cursor->result != NULL)
+            {
+                ExecStatusType const status = PQresultStatus(cursor->result);
+                int error = 0;
+                end_of_statement = false;
+
+                switch(status)
+                {
+                case PGRES_PIPELINE_SYNC:
+                    *synced = true;
+                    break;
+                case PGRES_SINGLE_TUPLE:
+                case PGRES_TUPLES_OK:
+                    /* Batches only report a status */
+                    if (cursor->batch_count == 0 &&
+                        cursor->last_error == 0)
+                    {
+                        if (cursor->returning_id == false)
+                        {
+                            error = cgdb_pg_handle_rows(cursor, cursor->result);
+                        }
+                        else
+                        {
+                            error = cgdb_pg_handle_returning_id(cursor, cursor->result);
+                        }
+                    }
+                    break;
+                case PGRES_COMMAND_OK:
+                    /* Statement prepared, or query (UPDATE for example) not returning rows */
+                    break;
+                case PGRES_EMPTY_QUERY:
+                    CGUTILS_INFO("Silently ignoring an empty query: %d", status);
+                    break;
+                case PGRES_NONFATAL_ERROR:
+                    CGUTILS_INFO("Silently ignoring a non fatal error: %d", status);
+                    break;
+                case PGRES_PIPELINE_ABORTED:
+                    /* A previous statement of this cursor failed */
+                    error = EIO;
+                    break;
+                case PGRES_FATAL_ERROR:
+                {
+                    char const * const error_str = PQresultErrorMessage(cursor->result);
+                    CGUTILS_ERROR("Fatal error received on DB %s, aborting. %s",
+                                  PQdb(conn),
+                                  error_str != NULL ? error_str : "");
+                    error = EIO;
+                    break;
+                }
+                case PGRES_COPY_BOTH:
+                case PGRES_COPY_IN:
+                case PGRES_COPY_OUT:
+                case PGRES_BAD_RESPONSE:
+                default:
+                    CGUTILS_ERROR("Unexpected result: %d", status);
+                    error = EIO;
+                    break;
+                }
+
+                if (COMPILER_UNLIKELY(error != 0 &&
+                                      cursor->last_error == 0))
+                {
+                    cgdb_pg_cursor_set_error(cursor, error, status == PGRES_FATAL_ERROR);
+                }
+
+                PQclear(cursor->result), cursor->result = NULL;
+            }
+            else if (end_of_statement == false)
+            {
+                end_of_statement = true;
+            }
+            else
+            {
+                result = EIO;
+                CGUTILS_ERROR("Pipeline ended before its sync point: %d", result);
+                cgdb_pg_cursor_set_error(cursor, result, false);
+            }
+        }
+    }
+
+    return result;
+}
+
+static int cgdb_pg_handle_pipeline_results(cgdb_pg_cursor * const cursor,
+                                           bool * const busy)
+{
+    bool synced = false;
+    assert(cursor != NULL);
+    assert(busy != NULL);
+
+    int result = cgdb_pg_read_pipeline_results(cursor,
+                                               busy,
+                                               &synced);
+
+    if (result == 0 &&
+        synced == true)
+    {
+        cgdb_pg_cursor_do_callback(cursor,
+                                   cursor->last_error);
+    }
+
+    return result;
+}
+
+#else /* LIBPQ_HAS_PIPELINING */
+
+static bool cgdb_pg_conn_enter_pipeline_mode(cgdb_pg_conn * const conn)
+{
+    (void) conn;
+    return false;
+}
+
+static int cgdb_pg_send_pipeline(cgdb_pg_cursor * const cursor)
+{
+    (void) cursor;
+    return ENOSYS;
+}
+
+static int cgdb_pg_read_pipeline_results(cgdb_pg_cursor * const cursor,
+                                         bool * const busy,
+                                         bool * const synced)
+{
+    (void) cursor;
+    (void) busy;
+    (void) synced;
+    return ENOSYS;
+}
+
+static int cgdb_pg_handle_pipeline_results(cgdb_pg_cursor * const cursor,
+                                           bool * const busy)
+{
+    (void) cursor;
+    (void) busy;
+    return ENOSYS;
+}
+
+#endif /* LIBPQ_HAS_PIPELINING */
+
+static int cgdb_pg_send_batch_command(cgdb_pg_cursor * const cursor,
+                                      cgdb_pg_state const state,
+                                      char const * const command)
+{
+    int result = 0;
+    assert(cursor != NULL);
+    assert(command != NULL);
+    PGconn * const conn = cgdb_pg_cursor_get_conn(cursor);
+    assert(conn != NULL);
+
+    cursor->state = state;
+
+    if (COMPILER_UNLIKELY(PQsendQuery(conn, command) != 1))
+    {
+        char const * const error_str = PQerrorMessage(conn);
+        CGUTILS_ERROR("Error sending %s for batch: %s",
+                      command,
+                      error_str != NULL ? error_str : "");
+        result = EIO;
+    }
+
+    return result;
+}
+
+static int cgdb_pg_handle_statement(cgdb_pg_cursor * const cursor)
+{
+    int result = 0;
+    assert(cursor != NULL);
+    PGconn * const conn = cgdb_pg_cursor_get_conn(cursor);
+    assert(conn != NULL);
+    assert(cursor->state == cgdb_pg_state_preparing_statement);
+
+    if (COMPILER_LIKELY(cursor->statement > cgdb_backend_statement_none &&
+                        cursor->statement < cgdb_backend_statement_count))
+    {
+        if (cursor->pipeline == false &&
+            cursor->blocking == false)
+        {
+            cursor->pipeline = cgdb_pg_conn_enter_pipeline_mode(cursor->conn);
+        }
+
+        if (COMPILER_LIKELY(cursor->pipeline == true))
+        {
+            result = cgdb_pg_send_pipeline(cursor);
+        }
+        else if (COMPILER_UNLIKELY(cursor->batch_count > 0 &&
+                                   cursor->sequential_batch == false))
+        {
+            /* No pipeline, the statements are sent one at a time
+               and the transaction makes them a single unit. */
+            cursor->sequential_batch = true;
+
+            result = cgdb_pg_send_batch_command(cursor,
+                                                cgdb_pg_state_beginning_batch,
+                                                "BEGIN");
+        }
+        else if (COMPILER_UNLIKELY(cursor->conn->stmts[cursor->statement] == false))
+        {
+            if (COMPILER_LIKELY(cgdb_pg_statements[cursor->statement].str != NULL))
+            {
+                CGUTILS_ASSERT(cgdb_pg_statements[cursor->statement].params_count ==
+                               cursor->stmt_params->count);
 
                 result = PQsendPrepare(conn,
                                        cgdb_pg_statements[cursor->statement].name,
@@ -1553,6 +2381,51 @@ static int cgdb_pg_handle_statement(cgdb_pg_cursor * const cursor)
     return result;
 }
 
+static int cgdb_pg_handle_batch_next(cgdb_pg_cursor * const cursor)
+{
+    int result = 0;
+    assert(cursor != NULL);
+    assert(cursor->sequential_batch == true);
+
+    if (cursor->state == cgdb_pg_state_beginning_batch)
+    {
+        cursor->state = cgdb_pg_state_preparing_statement;
+
+        result = cgdb_pg_handle_statement(cursor);
+    }
+    else if (cursor->batch_done < cursor->batch_count)
+    {
+        cgdb_pg_batch_stmt * const next = &(cursor->batch[cursor->batch_done]);
+
+        cgdb_pg_prepared_stmt_params_free(cursor->stmt_params);
+        cursor->stmt_params = next->stmt_params;
+        next->stmt_params = NULL;
+        cursor->statement = next->statement;
+        cursor->batch_done++;
+        cursor->state = cgdb_pg_state_preparing_statement;
+
+        result = cgdb_pg_handle_statement(cursor);
+    }
+    else
+    {
+        result = cgdb_pg_send_batch_command(cursor,
+                                            cgdb_pg_state_committing_batch,
+                                            "COMMIT");
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            result = cgdb_pg_send_data(cursor,
+                                       true);
+        }
+        else
+        {
+            cgdb_pg_cursor_set_error(cursor, result, false);
+        }
+    }
+
+    return result;
+}
+
 static int cgdb_pg_handle_results(cgdb_pg_cursor * const cursor)
 {
     int result = 0;
@@ -1580,13 +2453,17 @@ static int cgdb_pg_handle_results(cgdb_pg_cursor * const cursor)
             result = cgdb_pg_handle_rows(cursor, cursor->result);
             break;
         case PGRES_TUPLES_OK:
-            if (cursor->returning_id == false)
+            /* Batches only report a status */
+            if (cursor->batch_count == 0)
             {
-                result = cgdb_pg_handle_rows(cursor, cursor->result);
-            }
-            else
-            {
-                result = cgdb_pg_handle_returning_id(cursor, cursor->result);
+                if (cursor->returning_id == false)
+                {
+                    result = cgdb_pg_handle_rows(cursor, cursor->result);
+                }
+                else
+                {
+                    result = cgdb_pg_handle_returning_id(cursor, cursor->result);
+                }
             }
             break;
         case PGRES_COMMAND_OK:
@@ -1642,6 +2519,16 @@ static int cgdb_pg_handle_results(cgdb_pg_cursor * const cursor)
                 CGUTILS_ERROR("Error handling statement: %d", result);
             }
         }
+        else if (cursor->sequential_batch == true &&
+                 cursor->state != cgdb_pg_state_committing_batch)
+        {
+            result = cgdb_pg_handle_batch_next(cursor);
+
+            if (result != 0)
+            {
+                CGUTILS_ERROR("Error handling batch: %d", result);
+            }
+        }
         else if (cursor->blocking == false)
         {
             cgdb_pg_cursor_do_callback(cursor,
@@ -1662,10 +2549,7 @@ static int cgdb_pg_cursor_get_more(cgdb_pg_cursor * cursor,
 
     if (COMPILER_LIKELY(cursor->single_row_mode == true))
     {
-        if (cursor->rows != NULL)
-        {
-            cgutils_vector_deep_free(&(cursor->rows), &cgdb_row_delete);
-        }
+        cgdb_pg_cursor_free_rows(cursor);
 
         cursor->rows_count = 0;
         cursor->full = false;
@@ -1725,18 +2609,36 @@ static int cgdb_pg_recv_results(cgdb_pg_cursor * const cursor,
 
     if (result == 1)
     {
-        result = PQisBusy(conn);
+        /* the cursor may be freed by the callback */
+        bool const pipeline = cursor->pipeline;
+        bool busy = false;
+        result = 0;
 
-        if (result == 1)
+        if (pipeline == true)
         {
-            cgutils_event * const conn_event = cgdb_pg_cursor_get_conn_event(cursor);
-            assert(conn_event != NULL);
-
-            result = 0;
+            /* Results are handled as they arrive,
+               the callback is called once the sync point is reached. */
+            result = cgdb_pg_handle_pipeline_results(cursor, &busy);
 
-            if (COMPILER_UNLIKELY(intial_recv == true))
+            if (COMPILER_UNLIKELY(result != 0))
             {
-                result = cgutils_event_reassign(conn_event,
+                CGUTILS_ERROR("Error handling pipeline results: %d", result);
+            }
+        }
+        else
+        {
+            busy = PQisBusy(conn) == 1;
+        }
+
+        if (result == 0 &&
+            busy == true)
+        {
+            cgutils_event * const conn_event = cgdb_pg_cursor_get_conn_event(cursor);
+            assert(conn_event != NULL);
+
+            if (COMPILER_UNLIKELY(intial_recv == true))
+            {
+                result = cgutils_event_reassign(conn_event,
                                                 CGUTILS_EVENT_READ,
                                                 &cgdb_pg_recv_cb);
 
@@ -1756,7 +2658,8 @@ static int cgdb_pg_recv_results(cgdb_pg_cursor * const cursor,
                 }
             }
         }
-        else
+        else if (result == 0 &&
+                 pipeline == false)
         {
             result = cgdb_pg_handle_results(cursor);
 
@@ -2250,7 +3153,7 @@ static int cgdb_pg_new_connection(cgdb_pg_cursor * const cursor,
     return result;
 }
 
-static int cgdb_pg_query(cgdb_pg_cursor * const cursor)
+static int cgdb_pg_query_with_own_conn(cgdb_pg_cursor * const cursor)
 {
     int result = 0;
 
@@ -2311,209 +3214,900 @@ static int cgdb_pg_query(cgdb_pg_cursor * const cursor)
     return result;
 }
 
-static int cgdb_pg_find(void * const data,
-                        cgdb_backend_statement const statement,
-                        cgdb_param const * const params,
-                        size_t const params_count,
-                        cgdb_limit_type const limit,
-                        cgdb_skip_type const skip,
-                        cgdb_backend_cursor_cb * cb,
-                        void * const cb_data)
+static void cgdb_pg_shared_conn_free(cgdb_pg_shared_conn * this)
 {
-    int result = EINVAL;
-
-    if (data != NULL)
+    if (this != NULL)
     {
-        cgdb_pg_data * this = data;
-        cgdb_pg_cursor * cursor = NULL;
-
-        result = cgdb_pg_cursor_init(this,
-                                     statement,
-                                     CGDB_PG_NO_STATUS_CB,
-                                     cb,
-                                     CGDB_PG_NO_STATUS_RETURNING_CB,
-                                     cb_data,
-                                     params,
-                                     params_count,
-                                     limit,
-                                     skip,
-                                     true,
-                                     false,
-                                     &cursor);
+        cgutils_llist * lists[] = { this->waiting, this->in_flight };
 
-        if (result == 0)
+        for (size_t idx = 0;
+             idx < sizeof lists / sizeof *lists;
+             idx++)
         {
-            result = cgdb_pg_query(cursor);
-
-            if (result != 0)
+            for (cgutils_llist_elt * elt = cgutils_llist_get_first(lists[idx]);
+                 elt != NULL;
+                 elt = cgutils_llist_elt_get_next(elt))
             {
-                CGUTILS_ERROR("Error sending query: %d", result);
+                cgdb_pg_cursor * cursor = cgutils_llist_elt_get_object(elt);
+                assert(cursor != NULL);
+
+                cursor->conn = NULL;
+                cursor->shared_conn = NULL;
                 cgdb_pg_cursor_free(cursor), cursor = NULL;
             }
         }
-        else
+
+        if (this->waiting != NULL)
         {
-            CGUTILS_ERROR("Error creating PG cursor: %d", result);
+            cgutils_llist_free(&(this->waiting), NULL);
+        }
+
+        if (this->in_flight != NULL)
+        {
+            cgutils_llist_free(&(this->in_flight), NULL);
+        }
+
+        if (this->conn != NULL)
+        {
+            cgdb_pg_conn_free(this->conn), this->conn = NULL;
         }
+
+        this->data = NULL;
+
+        CGUTILS_FREE(this);
+    }
+}
+
+static void cgdb_pg_shared_conn_delete(void * this)
+{
+    cgdb_pg_shared_conn_free(this);
+}
+
+static void cgdb_pg_shared_conn_release(cgdb_pg_shared_conn * this)
+{
+    assert(this != NULL);
+    assert(this->data != NULL);
+    assert(this->handling == false);
+
+    cgutils_llist_remove_by_object(this->data->shared_conns, this);
+
+    cgdb_pg_shared_conn_free(this), this = NULL;
+}
+
+static cgdb_pg_cursor * cgdb_pg_shared_conn_pop(cgutils_llist * const list)
+{
+    cgdb_pg_cursor * result = NULL;
+    assert(list != NULL);
+
+    cgutils_llist_elt * const elt = cgutils_llist_get_first(list);
+
+    if (elt != NULL)
+    {
+        result = cgutils_llist_elt_get_object(elt);
+        cgutils_llist_remove(list, elt);
     }
 
     return result;
 }
 
-static int cgdb_pg_insert(void * const data,
-                          cgdb_backend_statement const statement,
-                          cgdb_param const * const params,
-                          size_t const params_count,
-                          cgdb_backend_status_cb * const cb,
-                          void * const cb_data)
+static void cgdb_pg_shared_conn_complete(cgdb_pg_cursor * const cursor,
+                                         int const status)
 {
-    int result = EINVAL;
+    assert(cursor != NULL);
 
-    if (data != NULL &&
-        (params != NULL || params_count == 0))
+    cursor->conn = NULL;
+    cursor->shared_conn = NULL;
+
+    cgdb_pg_cursor_do_callback(cursor,
+                               status);
+}
+
+/* The cursor has not been sent, it gets a connection of its own instead */
+static void cgdb_pg_shared_conn_fallback(cgdb_pg_cursor * const cursor)
+{
+    assert(cursor != NULL);
+
+    cursor->conn = NULL;
+    cursor->shared_conn = NULL;
+    cursor->pipeline = false;
+
+    int const result = cgdb_pg_query_with_own_conn(cursor);
+
+    if (result != 0)
     {
-        cgdb_pg_data * this = data;
-        cgdb_pg_cursor * cursor = NULL;
+        CGUTILS_ERROR("Error sending query on a connection of its own: %d", result);
+        cursor->last_error = result;
 
-        result = cgdb_pg_cursor_init(this,
-                                     statement,
-                                     cb,
-                                     CGDB_PG_NO_CURSOR_CB,
-                                     CGDB_PG_NO_STATUS_RETURNING_CB,
-                                     cb_data,
-                                     params,
-                                     params_count,
-                                     CGDB_LIMIT_NONE,
-                                     CGDB_SKIP_NONE,
-                                     false,
-                                     false,
-                                     &cursor);
+        cgdb_pg_cursor_do_callback(cursor,
+                                   result);
+    }
+}
 
-        if (result == 0)
+static void cgdb_pg_shared_conn_fail(cgdb_pg_shared_conn * const this,
+                                     int const error)
+{
+    cgdb_pg_cursor * cursor = NULL;
+    assert(this != NULL);
+
+    this->retired = true;
+    this->handling = true;
+
+    while ((cursor = cgdb_pg_shared_conn_pop(this->in_flight)) != NULL)
+    {
+        cgdb_pg_cursor_set_error(cursor, error, false);
+
+        cgdb_pg_shared_conn_complete(cursor,
+                                     error);
+    }
+
+    while ((cursor = cgdb_pg_shared_conn_pop(this->waiting)) != NULL)
+    {
+        cgdb_pg_shared_conn_fallback(cursor);
+    }
+
+    this->handling = false;
+}
+
+static int cgdb_pg_shared_conn_update_event(cgdb_pg_shared_conn * const this)
+{
+    int result = 0;
+    assert(this != NULL);
+    assert(this->conn != NULL);
+    assert(this->conn->conn_event != NULL);
+    assert(this->connected == true);
+
+    /* Always reading, to notice when the server closes the connection */
+    cgutils_event_flags flags = CGUTILS_EVENT_READ;
+
+    if (this->flushing == true)
+    {
+        flags |= CGUTILS_EVENT_WRITE;
+    }
+
+    result = cgutils_event_change_action(this->conn->conn_event,
+                                         flags);
+
+    if (COMPILER_LIKELY(result == 0))
+    {
+        if (cgutils_event_is_enabled(this->conn->conn_event) == false)
         {
-            result = cgdb_pg_query(cursor);
+            result = cgutils_event_enable(this->conn->conn_event, NULL);
 
-            if (result != 0)
+            if (COMPILER_UNLIKELY(result != 0))
             {
-                CGUTILS_ERROR("Error sending query: %d", result);
-                cgdb_pg_cursor_free(cursor), cursor = NULL;
+                CGUTILS_ERROR("Error enabling shared connection event: %d", result);
             }
         }
-        else
-        {
-            CGUTILS_ERROR("Error creating PG cursor: %d", result);
-        }
+    }
+    else
+    {
+        CGUTILS_ERROR("Error changing shared connection event: %d", result);
     }
 
     return result;
 }
 
-static int cgdb_pg_insert_returning(void * const data,
-                                    cgdb_backend_statement const statement,
-                                    cgdb_param const * const params,
-                                    size_t const params_count,
-                                    cgdb_backend_status_returning_cb * const cb,
-                                    void * const cb_data)
+static int cgdb_pg_shared_conn_send(cgdb_pg_shared_conn * const this,
+                                    cgdb_pg_cursor * const cursor)
 {
-    int result = EINVAL;
+    int result = 0;
+    assert(this != NULL);
+    assert(this->connected == true);
+    assert(this->retired == false);
+    assert(cursor != NULL);
 
-    if (data != NULL &&
-        (params != NULL || params_count == 0))
-    {
-        cgdb_pg_data * this = data;
-        cgdb_pg_cursor * cursor = NULL;
+    cursor->conn = this->conn;
+    cursor->shared_conn = this;
+    cursor->pipeline = true;
 
-        result = cgdb_pg_cursor_init(this,
-                                     statement,
-                                     CGDB_PG_NO_STATUS_CB,
-                                     CGDB_PG_NO_CURSOR_CB,
-                                     cb,
-                                     cb_data,
-                                     params,
-                                     params_count,
-                                     CGDB_LIMIT_NONE,
-                                     CGDB_SKIP_NONE,
-                                     false,
-                                     false,
-                                     &cursor);
+    result = cgutils_llist_insert(this->in_flight, cursor);
 
-        if (result == 0)
+    if (COMPILER_LIKELY(result == 0))
+    {
+        result = cgdb_pg_send_pipeline(cursor);
+
+        if (COMPILER_LIKELY(result == 0))
         {
-            cursor->returning_id = true;
+            int const res = PQflush(this->conn->conn);
 
-            result = cgdb_pg_query(cursor);
+            if (res == 0 || res == 1)
+            {
+                this->flushing = res == 1;
 
-            if (result != 0)
+                result = cgdb_pg_shared_conn_update_event(this);
+            }
+            else
             {
-                CGUTILS_ERROR("Error sending query: %d", result);
-                cgdb_pg_cursor_free(cursor), cursor = NULL;
+                result = EIO;
+                CGUTILS_ERROR("Error flushing statements on shared connection: %d", result);
             }
         }
-        else
+
+        if (COMPILER_UNLIKELY(result != 0))
         {
-            CGUTILS_ERROR("Error creating PG cursor: %d", result);
+            /* The cursor is the last one in flight, and no other cursor
+               will follow since the connection is retired. */
+            cgutils_llist_remove_by_object(this->in_flight, cursor);
         }
     }
+    else
+    {
+        CGUTILS_ERROR("Error adding cursor to the shared connection: %d", result);
+    }
+
+    if (COMPILER_UNLIKELY(result != 0))
+    {
+        this->retired = true;
+
+        cursor->conn = NULL;
+        cursor->shared_conn = NULL;
+        cursor->pipeline = false;
+    }
 
     return result;
 }
 
-static int cgdb_pg_update(void * const data,
-                          cgdb_backend_statement const statement,
-                          cgdb_param const * const params,
-                          size_t const params_count,
-                          cgdb_backend_status_cb * const cb,
-                          void * const cb_data)
+static void cgdb_pg_shared_conn_connect(cgdb_pg_shared_conn * const this)
 {
-    int result = EINVAL;
-
-    if (data != NULL &&
-        (params != NULL || params_count == 0))
-    {
-        cgdb_pg_data * this = data;
-        cgdb_pg_cursor * cursor = NULL;
+    int result = 0;
+    assert(this != NULL);
+    assert(this->conn != NULL);
+    PGconn * const conn = this->conn->conn;
+    assert(conn != NULL);
+    cgutils_event * const conn_event = this->conn->conn_event;
+    assert(conn_event != NULL);
 
-        result = cgdb_pg_cursor_init(this,
-                                     statement,
-                                     cb,
-                                     CGDB_PG_NO_CURSOR_CB,
-                                     CGDB_PG_NO_STATUS_RETURNING_CB,
-                                     cb_data,
-                                     params,
-                                     params_count,
-                                     CGDB_LIMIT_NONE,
-                                     CGDB_SKIP_NONE,
-                                     false,
-                                     false,
-                                     &cursor);
+    PostgresPollingStatusType const status = PQconnectPoll(conn);
 
-        if (result == 0)
+    if (status == PGRES_POLLING_OK)
+    {
+        if (cgdb_pg_conn_enter_pipeline_mode(this->conn) == true)
         {
-            result = cgdb_pg_query(cursor);
+            cgdb_pg_cursor * cursor = NULL;
 
-            if (result != 0)
+            this->connected = true;
+            this->handling = true;
+
+            while ((cursor = cgdb_pg_shared_conn_pop(this->waiting)) != NULL)
             {
-                CGUTILS_ERROR("Error sending query: %d", result);
+                if (this->retired == true ||
+                    cgdb_pg_shared_conn_send(this, cursor) != 0)
+                {
+                    cgdb_pg_shared_conn_fallback(cursor);
+                }
             }
 
-            if (result != 0)
+            this->handling = false;
+
+            if (this->retired == false ||
+                cgutils_llist_get_count(this->in_flight) > 0)
             {
-                cgdb_pg_cursor_free(cursor), cursor = NULL;
+                result = cgdb_pg_shared_conn_update_event(this);
             }
         }
         else
         {
-            CGUTILS_ERROR("Error creating PG cursor: %d", result);
+            /* Do not try again, cursors use connections of their own */
+            this->data->pipeline_unavailable = true;
+            result = ENOSYS;
         }
     }
+    else if (status == PGRES_POLLING_READING ||
+             status == PGRES_POLLING_WRITING)
+    {
+        result = cgutils_event_change_action(conn_event,
+                                             status == PGRES_POLLING_READING ?
+                                             CGUTILS_EVENT_READ :
+                                             CGUTILS_EVENT_WRITE);
 
-    return result;
-}
+        if (result == 0)
+        {
+            result = cgutils_event_enable(conn_event, NULL);
 
-static int cgdb_pg_delete(void * const data,
-                          cgdb_backend_statement const statement,
-                          cgdb_param const * const params,
-                          size_t const params_count,
+            if (result != 0)
+            {
+                CGUTILS_ERROR("Error enabling event on shared connection to database %s: %d",
+                              PQdb(conn),
+                              result);
+            }
+        }
+        else
+        {
+            CGUTILS_ERROR("Error changing IO action on shared connection to database %s: %d",
+                          PQdb(conn),
+                          result);
+        }
+    }
+    else
+    {
+        char const * const error_str = PQerrorMessage(conn);
+
+        result = EIO;
+        CGUTILS_ERROR("Shared connection to database %s failed: %s (%d)",
+                      PQdb(conn),
+                      error_str ?: "no error message",
+                      result);
+    }
+
+    if (result != 0)
+    {
+        /* Nothing has been sent yet, the waiting cursors
+           get a connection of their own. */
+        cgdb_pg_shared_conn_fail(this, result);
+    }
+
+    if (this->retired == true &&
+        cgutils_llist_get_count(this->in_flight) == 0)
+    {
+        cgdb_pg_shared_conn_release(this);
+    }
+}
+
+static void cgdb_pg_shared_conn_io(cgdb_pg_shared_conn * const this)
+{
+    int result = 0;
+    assert(this != NULL);
+    assert(this->conn != NULL);
+    PGconn * const conn = this->conn->conn;
+    assert(conn != NULL);
+
+    this->handling = true;
+
+    if (this->flushing == true)
+    {
+        int const res = PQflush(conn);
+
+        if (res == 0 || res == 1)
+        {
+            this->flushing = res == 1;
+        }
+        else
+        {
+            result = EIO;
+            CGUTILS_ERROR("Error flushing statements on shared connection: %d", result);
+        }
+    }
+
+    /* Results may have been read while flushing,
+       so they are handled whatever the event was. */
+    if (result == 0)
+    {
+        if (PQconsumeInput(conn) == 1)
+        {
+            bool busy = false;
+            cgutils_llist_elt * elt = NULL;
+
+            while (result == 0 &&
+                   busy == false &&
+                   (elt = cgutils_llist_get_first(this->in_flight)) != NULL)
+            {
+                cgdb_pg_cursor * const cursor = cgutils_llist_elt_get_object(elt);
+                bool synced = false;
+
+                result = cgdb_pg_read_pipeline_results(cursor,
+                                                       &busy,
+                                                       &synced);
+
+                if (result == 0 &&
+                    synced == true)
+                {
+                    cgutils_llist_remove(this->in_flight, elt), elt = NULL;
+
+                    if (cursor->last_error != 0 &&
+                        cursor->prepared_in_pipeline == true)
+                    {
+                        /* The statement may not have been prepared */
+                        this->retired = true;
+                    }
+
+                    cgdb_pg_shared_conn_complete(cursor,
+                                                 cursor->last_error);
+                }
+            }
+        }
+        else
+        {
+            char const * const error_str = PQerrorMessage(conn);
+            result = EIO;
+            CGUTILS_ERROR("Error consuming input from shared connection: %s (%d)",
+                          error_str ?: "no error message",
+                          result);
+        }
+    }
+
+    this->handling = false;
+
+    if (result == 0 &&
+        (this->retired == false ||
+         cgutils_llist_get_count(this->in_flight) > 0))
+    {
+        result = cgdb_pg_shared_conn_update_event(this);
+    }
+
+    if (result != 0)
+    {
+        cgdb_pg_shared_conn_fail(this, result);
+    }
+
+    if (this->retired == true &&
+        cgutils_llist_get_count(this->in_flight) == 0)
+    {
+        cgdb_pg_shared_conn_release(this);
+    }
+}
+
+static void cgdb_pg_shared_conn_cb(int const fd,
+                                   short const flags,
+                                   void * const cb_data)
+{
+    cgdb_pg_shared_conn * const this = cb_data;
+    assert(cb_data != NULL);
+
+    (void) fd;
+    (void) flags;
+
+    if (this->connected == false)
+    {
+        cgdb_pg_shared_conn_connect(this);
+    }
+    else
+    {
+        cgdb_pg_shared_conn_io(this);
+    }
+}
+
+static int cgdb_pg_shared_conn_create(cgdb_pg_data * const data,
+                                      bool const read_only,
+                                      cgdb_pg_shared_conn ** const out)
+{
+    int result = 0;
+    cgdb_pg_shared_conn * this = NULL;
+    assert(data != NULL);
+    assert(out != NULL);
+
+    CGUTILS_ALLOCATE_STRUCT(this);
+
+    if (COMPILER_LIKELY(this != NULL))
+    {
+        this->data = data;
+        this->read_only = read_only;
+
+        CGUTILS_ALLOCATE_STRUCT(this->conn);
+
+        if (COMPILER_LIKELY(this->conn != NULL))
+        {
+            this->conn->read_only = read_only;
+
+            result = cgutils_llist_create(&(this->waiting));
+
+            if (COMPILER_LIKELY(result == 0))
+            {
+                result = cgutils_llist_create(&(this->in_flight));
+            }
+        }
+        else
+        {
+            result = ENOMEM;
+        }
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            PGconn * const conn = PQconnectStart(read_only == true ?
+                                                 data->read_only_conn_str :
+                                                 data->conn_str);
+
+            if (conn != NULL &&
+                PQstatus(conn) != CONNECTION_BAD)
+            {
+                this->conn->conn = conn;
+
+                if (PQsetnonblocking(conn, 1) == 0)
+                {
+                    int const conn_fd = PQsocket(conn);
+
+                    if (conn_fd >= 0)
+                    {
+                        result = cgutils_event_create_fd_event(data->event_data,
+                                                               conn_fd,
+                                                               &cgdb_pg_shared_conn_cb,
+                                                               this,
+                                                               CGUTILS_EVENT_WRITE,
+                                                               &(this->conn->conn_event));
+
+                        if (COMPILER_LIKELY(result == 0))
+                        {
+                            result = cgutils_event_enable(this->conn->conn_event, NULL);
+
+                            if (COMPILER_UNLIKELY(result != 0))
+                            {
+                                CGUTILS_ERROR("Error enabling shared connection event: %d", result);
+                            }
+                        }
+                        else
+                        {
+                            CGUTILS_ERROR("Error creating shared connection event: %d", result);
+                        }
+                    }
+                    else
+                    {
+                        result = EIO;
+                        CGUTILS_ERROR("Error getting FD from shared connection: %d", result);
+                    }
+                }
+                else
+                {
+                    result = EIO;
+                    CGUTILS_ERROR("Error setting shared connection to a non-blocking state: %d", result);
+                }
+            }
+            else if (conn != NULL)
+            {
+                char const * const error_str = PQerrorMessage(conn);
+                result = EIO;
+                CGUTILS_ERROR("Error connecting to database %s: %s", PQdb(conn),
+                              error_str ?: "no error message");
+                PQfinish(conn);
+            }
+            else
+            {
+                result = ENOMEM;
+                CGUTILS_ERROR("Error connecting to database: %d", result);
+            }
+        }
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            result = cgutils_llist_insert(data->shared_conns, this);
+        }
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            *out = this;
+        }
+        else
+        {
+            cgdb_pg_shared_conn_free(this), this = NULL;
+        }
+    }
+    else
+    {
+        result = ENOMEM;
+    }
+
+    return result;
+}
+
+/* Picks the least busy shared connection, a new one is opened
+   while all of them are busy and the limit has not been reached. */
+static int cgdb_pg_shared_conn_get(cgdb_pg_data * const data,
+                                   bool const read_only,
+                                   cgdb_pg_shared_conn ** const out)
+{
+    int result = 0;
+    cgdb_pg_shared_conn * best = NULL;
+    size_t best_load = SIZE_MAX;
+    size_t usable = 0;
+    assert(data != NULL);
+    assert(out != NULL);
+
+    for (cgutils_llist_elt * elt = cgutils_llist_get_first(data->shared_conns);
+         elt != NULL;
+         elt = cgutils_llist_elt_get_next(elt))
+    {
+        cgdb_pg_shared_conn * const this = cgutils_llist_elt_get_object(elt);
+        assert(this != NULL);
+
+        if (this->retired == false &&
+            this->read_only == read_only)
+        {
+            size_t const load = cgutils_llist_get_count(this->waiting) +
+                cgutils_llist_get_count(this->in_flight);
+
+            usable++;
+
+            if (load < best_load)
+            {
+                best = this;
+                best_load = load;
+            }
+        }
+    }
+
+    if (best == NULL ||
+        (best_load > 0 &&
+         usable < data->shared_conns_max))
+    {
+        result = cgdb_pg_shared_conn_create(data,
+                                            read_only,
+                                            out);
+    }
+    else
+    {
+        *out = best;
+    }
+
+    return result;
+}
+
+static int cgdb_pg_shared_conn_submit(cgdb_pg_cursor * const cursor)
+{
+    int result = 0;
+    cgdb_pg_shared_conn * shared_conn = NULL;
+    assert(cursor != NULL);
+    assert(cursor->data != NULL);
+    assert(cursor->blocking == false);
+
+    bool const read_only = cgdb_pg_cursor_is_read_only(cursor) == true &&
+        cursor->data->read_only_conn_str != NULL;
+
+    result = cgdb_pg_shared_conn_get(cursor->data,
+                                     read_only,
+                                     &shared_conn);
+
+    if (COMPILER_LIKELY(result == 0))
+    {
+        if (shared_conn->connected == true)
+        {
+            result = cgdb_pg_shared_conn_send(shared_conn,
+                                              cursor);
+
+            if (COMPILER_UNLIKELY(result != 0))
+            {
+                CGUTILS_ERROR("Error sending statements on shared connection: %d", result);
+
+                if (shared_conn->handling == false &&
+                    cgutils_llist_get_count(shared_conn->in_flight) == 0)
+                {
+                    cgdb_pg_shared_conn_release(shared_conn), shared_conn = NULL;
+                }
+            }
+        }
+        else
+        {
+            result = cgutils_llist_insert(shared_conn->waiting,
+                                          cursor);
+
+            if (COMPILER_LIKELY(result == 0))
+            {
+                cursor->shared_conn = shared_conn;
+            }
+            else
+            {
+                CGUTILS_ERROR("Error adding cursor to the shared connection: %d", result);
+            }
+        }
+    }
+    else
+    {
+        CGUTILS_ERROR("Error getting a shared connection: %d", result);
+    }
+
+    return result;
+}
+
+static int cgdb_pg_query(cgdb_pg_cursor * const cursor)
+{
+    int result = 0;
+    assert(cursor != NULL);
+    assert(cursor->data != NULL);
+
+    if (cursor->blocking == false &&
+        cursor->data->shared_conns_max > 0 &&
+        cursor->data->pipeline_unavailable == false)
+    {
+        result = cgdb_pg_shared_conn_submit(cursor);
+    }
+    else
+    {
+        result = cgdb_pg_query_with_own_conn(cursor);
+    }
+
+    return result;
+}
+
+static int cgdb_pg_find(void * const data,
+                        cgdb_backend_statement const statement,
+                        cgdb_param const * const params,
+                        size_t const params_count,
+                        cgdb_limit_type const limit,
+                        cgdb_skip_type const skip,
+                        cgdb_backend_cursor_cb * cb,
+                        void * const cb_data)
+{
+    int result = EINVAL;
+
+    if (data != NULL)
+    {
+        cgdb_pg_data * this = data;
+        cgdb_pg_cursor * cursor = NULL;
+
+        result = cgdb_pg_cursor_init(this,
+                                     statement,
+                                     CGDB_PG_NO_STATUS_CB,
+                                     cb,
+                                     CGDB_PG_NO_STATUS_RETURNING_CB,
+                                     cb_data,
+                                     params,
+                                     params_count,
+                                     limit,
+                                     skip,
+                                     true,
+                                     false,
+                                     &cursor);
+
+        if (result == 0)
+        {
+            result = cgdb_pg_query(cursor);
+
+            if (result != 0)
+            {
+                CGUTILS_ERROR("Error sending query: %d", result);
+                cgdb_pg_cursor_free(cursor), cursor = NULL;
+            }
+        }
+        else
+        {
+            CGUTILS_ERROR("Error creating PG cursor: %d", result);
+        }
+    }
+
+    return result;
+}
+
+static int cgdb_pg_insert(void * const data,
+                          cgdb_backend_statement const statement,
+                          cgdb_param const * const params,
+                          size_t const params_count,
+                          cgdb_backend_status_cb * const cb,
+                          void * const cb_data)
+{
+    int result = EINVAL;
+
+    if (data != NULL &&
+        (params != NULL || params_count == 0))
+    {
+        cgdb_pg_data * this = data;
+        cgdb_pg_cursor * cursor = NULL;
+
+        result = cgdb_pg_cursor_init(this,
+                                     statement,
+                                     cb,
+                                     CGDB_PG_NO_CURSOR_CB,
+                                     CGDB_PG_NO_STATUS_RETURNING_CB,
+                                     cb_data,
+                                     params,
+                                     params_count,
+                                     CGDB_LIMIT_NONE,
+                                     CGDB_SKIP_NONE,
+                                     false,
+                                     false,
+                                     &cursor);
+
+        if (result == 0)
+        {
+            result = cgdb_pg_query(cursor);
+
+            if (result != 0)
+            {
+                CGUTILS_ERROR("Error sending query: %d", result);
+                cgdb_pg_cursor_free(cursor), cursor = NULL;
+            }
+        }
+        else
+        {
+            CGUTILS_ERROR("Error creating PG cursor: %d", result);
+        }
+    }
+
+    return result;
+}
+
+static int cgdb_pg_insert_returning(void * const data,
+                                    cgdb_backend_statement const statement,
+                                    cgdb_param const * const params,
+                                    size_t const params_count,
+                                    cgdb_backend_status_returning_cb * const cb,
+                                    void * const cb_data)
+{
+    int result = EINVAL;
+
+    if (data != NULL &&
+        (params != NULL || params_count == 0))
+    {
+        cgdb_pg_data * this = data;
+        cgdb_pg_cursor * cursor = NULL;
+
+        result = cgdb_pg_cursor_init(this,
+                                     statement,
+                                     CGDB_PG_NO_STATUS_CB,
+                                     CGDB_PG_NO_CURSOR_CB,
+                                     cb,
+                                     cb_data,
+                                     params,
+                                     params_count,
+                                     CGDB_LIMIT_NONE,
+                                     CGDB_SKIP_NONE,
+                                     false,
+                                     false,
+                                     &cursor);
+
+        if (result == 0)
+        {
+            cursor->returning_id = true;
+
+            result = cgdb_pg_query(cursor);
+
+            if (result != 0)
+            {
+                CGUTILS_ERROR("Error sending query: %d", result);
+                cgdb_pg_cursor_free(cursor), cursor = NULL;
+            }
+        }
+        else
+        {
+            CGUTILS_ERROR("Error creating PG cursor: %d", result);
+        }
+    }
+
+    return result;
+}
+
+static int cgdb_pg_update(void * const data,
+                          cgdb_backend_statement const statement,
+                          cgdb_param const * const params,
+                          size_t const params_count,
+                          cgdb_backend_status_cb * const cb,
+                          void * const cb_data)
+{
+    int result = EINVAL;
+
+    if (data != NULL &&
+        (params != NULL || params_count == 0))
+    {
+        cgdb_pg_data * this = data;
+        cgdb_pg_cursor * cursor = NULL;
+
+        result = cgdb_pg_cursor_init(this,
+                                     statement,
+                                     cb,
+                                     CGDB_PG_NO_CURSOR_CB,
+                                     CGDB_PG_NO_STATUS_RETURNING_CB,
+                                     cb_data,
+                                     params,
+                                     params_count,
+                                     CGDB_LIMIT_NONE,
+                                     CGDB_SKIP_NONE,
+                                     false,
+                                     false,
+                                     &cursor);
+
+        if (result == 0)
+        {
+            result = cgdb_pg_query(cursor);
+
+            if (result != 0)
+            {
+                CGUTILS_ERROR("Error sending query: %d", result);
+            }
+
+            if (result != 0)
+            {
+                cgdb_pg_cursor_free(cursor), cursor = NULL;
+            }
+        }
+        else
+        {
+            CGUTILS_ERROR("Error creating PG cursor: %d", result);
+        }
+    }
+
+    return result;
+}
+
+static int cgdb_pg_delete(void * const data,
+                          cgdb_backend_statement const statement,
+                          cgdb_param const * const params,
+                          size_t const params_count,
                           cgdb_backend_status_cb * const cb,
                           void * const cb_data)
 {
@@ -2644,10 +4238,123 @@ static int cgdb_pg_exec_rows_stmt(void * const data,
                 cgdb_pg_cursor_free(cursor), cursor = NULL;
             }
         }
-        else
-        {
-            CGUTILS_ERROR("Error creating PG cursor: %d", result);
-        }
+        else
+        {
+            CGUTILS_ERROR("Error creating PG cursor: %d", result);
+        }
+    }
+
+    return result;
+}
+
+static int cgdb_pg_exec_batch(void * const data,
+                              cgdb_backend_batch_stmt const * const stmts,
+                              size_t const stmts_count,
+                              cgdb_backend_status_cb * const cb,
+                              void * const cb_data)
+{
+    int result = EINVAL;
+
+    if (data != NULL &&
+        stmts != NULL &&
+        stmts_count > 0)
+    {
+        result = 0;
+
+        for (size_t idx = 0;
+             result == 0 &&
+                 idx < stmts_count;
+             idx++)
+        {
+            if (COMPILER_UNLIKELY(stmts[idx].statement <= cgdb_backend_statement_none ||
+                                  stmts[idx].statement >= cgdb_backend_statement_count ||
+                                  cgdb_pg_statements[stmts[idx].statement].str == NULL ||
+                                  (stmts[idx].params == NULL && stmts[idx].params_count > 0)))
+            {
+                result = EINVAL;
+                CGUTILS_ERROR("Invalid statement %zu in batch: %d", idx, result);
+            }
+        }
+
+        if (result == 0)
+        {
+            cgdb_pg_data * this = data;
+            cgdb_pg_cursor * cursor = NULL;
+
+            result = cgdb_pg_cursor_init(this,
+                                         stmts[0].statement,
+                                         cb,
+                                         CGDB_PG_NO_CURSOR_CB,
+                                         CGDB_PG_NO_STATUS_RETURNING_CB,
+                                         cb_data,
+                                         stmts[0].params,
+                                         stmts[0].params_count,
+                                         CGDB_LIMIT_NONE,
+                                         CGDB_SKIP_NONE,
+                                         false, /* NOT read only */
+                                         false, /* NOT blocking */
+                                         &cursor);
+
+            if (result == 0)
+            {
+                if (stmts_count > 1)
+                {
+                    CGUTILS_MALLOC(cursor->batch, stmts_count - 1, sizeof *(cursor->batch));
+
+                    if (cursor->batch != NULL)
+                    {
+                        for (size_t idx = 1;
+                             result == 0 &&
+                                 idx < stmts_count;
+                             idx++)
+                        {
+                            cgdb_pg_batch_stmt * const batch_stmt = &(cursor->batch[idx - 1]);
+                            batch_stmt->statement = stmts[idx].statement;
+                            batch_stmt->stmt_params = NULL;
+
+                            result = cgdb_pg_get_prepared_stmt_params(stmts[idx].params,
+                                                                      stmts[idx].params_count,
+                                                                      CGDB_LIMIT_NONE,
+                                                                      CGDB_SKIP_NONE,
+                                                                      &(batch_stmt->stmt_params));
+
+                            if (result == 0)
+                            {
+                                cursor->batch_count++;
+                            }
+                            else
+                            {
+                                CGUTILS_ERROR("Error getting parameters of statement %zu in batch: %d", idx, result);
+                            }
+                        }
+                    }
+                    else
+                    {
+                        result = ENOMEM;
+                        CGUTILS_ERROR("Error allocating batch: %d", result);
+                    }
+                }
+
+                if (result == 0)
+                {
+                    result = cgdb_pg_query(cursor);
+
+                    if (result != 0)
+                    {
+                        CGUTILS_ERROR("Error sending query: %d", result);
+                    }
+                }
+
+                if (result != 0)
+                {
+                    cgdb_pg_cursor_free(cursor), cursor = NULL;
+                }
+            }
+            else
+            {
+                CGUTILS_ERROR("Error creating PG cursor: %d", result);
+            }
+        }
     }
 
     return result;
@@ -2790,10 +4497,7 @@ static int cgdb_pg_exec_rows_stmt_sync(void * const data,
                                       result,
                                       error_str);
 
-                        if (cursor->rows != NULL)
-                        {
-                            cgutils_vector_deep_free(&(cursor->rows), &cgdb_row_delete);
-                        }
+                        cgdb_pg_cursor_free_rows(cursor);
 
                         result = EIO;
                     }
@@ -2872,6 +4576,429 @@ static int cgdb_pg_sync_test_credentials(void * const data,
     return result;
 }
 
+static void cgdb_pg_listener_free(cgdb_pg_listener * listener)
+{
+    if (listener != NULL)
+    {
+        if (listener->conn_event != NULL)
+        {
+            cgutils_event_free(listener->conn_event), listener->conn_event = NULL;
+        }
+
+        if (listener->conn != NULL)
+        {
+            PQfinish(listener->conn), listener->conn = NULL;
+        }
+
+        CGUTILS_FREE(listener->channel);
+
+        listener->data = NULL;
+        listener->cb = NULL;
+        listener->cb_data = NULL;
+
+        CGUTILS_FREE(listener);
+    }
+}
+
+static void cgdb_pg_listener_set_error(cgdb_pg_listener * const listener,
+                                       int const error)
+{
+    assert(listener != NULL);
+    assert(error != 0);
+
+    /* Nothing more will be received on this connection,
+       the owner has to destroy the listener and listen again */
+    listener->state = cgdb_pg_listener_state_failed;
+
+    if (listener->conn_event != NULL)
+    {
+        cgutils_event_disable(listener->conn_event);
+    }
+
+    (*(listener->cb))(error,
+                      NULL,
+                      listener->cb_data);
+}
+
+static void cgdb_pg_listener_cb(int const fd,
+                                short const flags,
+                                void * const cb_data);
+
+static int cgdb_pg_listener_flush(cgdb_pg_listener * const listener)
+{
+    int result = 0;
+    assert(listener != NULL);
+    assert(listener->conn != NULL);
+    assert(listener->conn_event != NULL);
+
+    result = PQflush(listener->conn);
+
+    if (result == 0)
+    {
+        listener->state = cgdb_pg_listener_state_listening;
+
+        /* From now on, we wait for the LISTEN result then for
+           notifications, for as long as the listener lives */
+        result = cgutils_event_reassign(listener->conn_event,
+                                        CGUTILS_EVENT_READ | CGUTILS_EVENT_PERSIST,
+                                        &cgdb_pg_listener_cb);
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            result = cgutils_event_enable(listener->conn_event, NULL);
+
+            if (COMPILER_UNLIKELY(result != 0))
+            {
+                CGUTILS_ERROR("Error enabling listener event: %d", result);
+            }
+        }
+        else
+        {
+            CGUTILS_ERROR("Error reassigning listener event: %d", result);
+        }
+    }
+    else if (result == 1)
+    {
+        result = cgutils_event_change_action(listener->conn_event,
+                                             CGUTILS_EVENT_WRITE);
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            result = cgutils_event_enable(listener->conn_event, NULL);
+
+            if (COMPILER_UNLIKELY(result != 0))
+            {
+                CGUTILS_ERROR("Error enabling listener event: %d", result);
+            }
+        }
+        else
+        {
+            CGUTILS_ERROR("Error changing IO action on listener event: %d", result);
+        }
+    }
+    else
+    {
+        result = EIO;
+        CGUTILS_ERROR("Error flushing LISTEN query: %d", result);
+    }
+
+    return result;
+}
+
+static int cgdb_pg_listener_send(cgdb_pg_listener * const listener)
+{
+    int result = 0;
+    assert(listener != NULL);
+    assert(listener->conn != NULL);
+    assert(listener->channel != NULL);
+
+    char * const channel = PQescapeIdentifier(listener->conn,
+                                              listener->channel,
+                                              strlen(listener->channel));
+
+    if (channel != NULL)
+    {
+        char * query = NULL;
+
+        result = cgutils_asprintf(&query,
+                                  "LISTEN %s",
+                                  channel);
+
+        if (result == 0)
+        {
+            if (PQsendQuery(listener->conn, query) == 1)
+            {
+                listener->state = cgdb_pg_listener_state_sending;
+
+                result = cgdb_pg_listener_flush(listener);
+            }
+            else
+            {
+                char const * const error_str = PQerrorMessage(listener->conn);
+                result = EIO;
+                CGUTILS_ERROR("Error sending LISTEN query: %s",
+                              error_str ?: "no error message");
+            }
+
+            CGUTILS_FREE(query);
+        }
+        else
+        {
+            CGUTILS_ERROR("Error allocating LISTEN query: %d", result);
+        }
+
+        PQfreemem(channel);
+    }
+    else
+    {
+        char const * const error_str = PQerrorMessage(listener->conn);
+        result = EINVAL;
+        CGUTILS_ERROR("Error escaping channel name %s: %s",
+                      listener->channel,
+                      error_str ?: "no error message");
+    }
+
+    return result;
+}
+
+static int cgdb_pg_listener_recv(cgdb_pg_listener * const listener)
+{
+    int result = 0;
+    assert(listener != NULL);
+    assert(listener->conn != NULL);
+
+    if (PQconsumeInput(listener->conn) == 1)
+    {
+        PGresult * res = NULL;
+
+        while (result == 0 &&
+               PQisBusy(listener->conn) == 0 &&
+               (res = PQgetResult(listener->conn)) != NULL)
+        {
+            /* the result of the LISTEN query */
+            ExecStatusType const status = PQresultStatus(res);
+
+            if (status == PGRES_COMMAND_OK)
+            {
+                listener->ready = true;
+            }
+            else
+            {
+                char const * const error_str = PQresultErrorMessage(res);
+                result = EIO;
+                CGUTILS_ERROR("Error in LISTEN query (%d): %s",
+                              status,
+                              error_str ?: "no error message");
+            }
+
+            PQclear(res), res = NULL;
+
+            if (result == 0)
+            {
+                (*(listener->cb))(0,
+                                  NULL,
+                                  listener->cb_data);
+            }
+        }
+
+        if (result == 0 &&
+            listener->ready == true)
+        {
+            PGnotify * notify = NULL;
+
+            while ((notify = PQnotifies(listener->conn)) != NULL)
+            {
+                (*(listener->cb))(0,
+                                  notify->extra != NULL ? notify->extra : "",
+                                  listener->cb_data);
+
+                PQfreemem(notify), notify = NULL;
+            }
+        }
+    }
+    else
+    {
+        char const * const error_str = PQerrorMessage(listener->conn);
+        result = EIO;
+        CGUTILS_ERROR("Error consuming input from listener connection: %s",
+                      error_str ?: "no error message");
+    }
+
+    return result;
+}
+
+static void cgdb_pg_listener_cb(int const fd,
+                                short const flags,
+                                void * const cb_data)
+{
+    int result = 0;
+    assert(cb_data != NULL);
+    cgdb_pg_listener * const listener = cb_data;
+    assert(listener->conn != NULL);
+
+    (void) fd;
+    (void) flags;
+
+    if (listener->state == cgdb_pg_listener_state_connecting)
+    {
+        PostgresPollingStatusType const status = PQconnectPoll(listener->conn);
+
+        if (status == PGRES_POLLING_OK)
+        {
+            result = cgdb_pg_listener_send(listener);
+        }
+        else if (status == PGRES_POLLING_READING ||
+                 status == PGRES_POLLING_WRITING)
+        {
+            result = cgutils_event_change_action(listener->conn_event,
+                                                 status == PGRES_POLLING_READING ?
+                                                 CGUTILS_EVENT_READ :
+                                                 CGUTILS_EVENT_WRITE);
+
+            if (COMPILER_LIKELY(result == 0))
+            {
+                result = cgutils_event_enable(listener->conn_event, NULL);
+
+                if (COMPILER_UNLIKELY(result != 0))
+                {
+                    CGUTILS_ERROR("Error enabling listener event: %d", result);
+                }
+            }
+            else
+            {
+                CGUTILS_ERROR("Error changing IO action on listener event: %d", result);
+            }
+        }
+        else
+        {
+            char const * const error_str = PQerrorMessage(listener->conn);
+            result = EIO;
+            CGUTILS_ERROR("Listener connection to database %s failed: %s",
+                          PQdb(listener->conn),
+                          error_str ?: "no error message");
+        }
+    }
+    else if (listener->state == cgdb_pg_listener_state_sending)
+    {
+        result = cgdb_pg_listener_flush(listener);
+    }
+    else if (listener->state == cgdb_pg_listener_state_listening)
+    {
+        result = cgdb_pg_listener_recv(listener);
+    }
+
+    if (COMPILER_UNLIKELY(result != 0))
+    {
+        cgdb_pg_listener_set_error(listener, result);
+    }
+}
+
+static int cgdb_pg_listen(void * const data,
+                          char const * const channel,
+                          cgdb_backend_notification_cb * const cb,
+                          void * const cb_data,
+                          cgdb_backend_listener ** const out)
+{
+    int result = EINVAL;
+
+    if (data != NULL && channel != NULL && cb != NULL && out != NULL)
+    {
+        cgdb_pg_data * const this = data;
+        cgdb_pg_listener * listener = NULL;
+
+        assert(this->event_data != NULL);
+        assert(this->conn_str != NULL);
+
+        CGUTILS_ALLOCATE_STRUCT(listener);
+
+        if (listener != NULL)
+        {
+            listener->data = this;
+            listener->cb = cb;
+            listener->cb_data = cb_data;
+            listener->state = cgdb_pg_listener_state_connecting;
+            listener->channel = cgutils_strdup(channel);
+
+            if (listener->channel != NULL)
+            {
+                /* Notifications are only delivered on the primary,
+                   never use the read-only connection string here */
+                listener->conn = PQconnectStart(this->conn_str);
+
+                if (listener->conn != NULL &&
+                    PQstatus(listener->conn) != CONNECTION_BAD)
+                {
+                    result = PQsetnonblocking(listener->conn, 1);
+
+                    if (result == 0)
+                    {
+                        int const conn_fd = PQsocket(listener->conn);
+
+                        if (conn_fd >= 0)
+                        {
+                            result = cgutils_event_create_fd_event(this->event_data,
+                                                                   conn_fd,
+                                                                   &cgdb_pg_listener_cb,
+                                                                   listener,
+                                                                   CGUTILS_EVENT_WRITE,
+                                                                   &(listener->conn_event));
+
+                            if (result == 0)
+                            {
+                                result = cgutils_event_enable(listener->conn_event, NULL);
+
+                                if (result != 0)
+                                {
+                                    CGUTILS_ERROR("Error enabling listener event: %d", result);
+                                }
+                            }
+                            else
+                            {
+                                CGUTILS_ERROR("Error creating listener event: %d", result);
+                            }
+                        }
+                        else
+                        {
+                            result = EIO;
+                            CGUTILS_ERROR("Error getting FD from listener connection: %d", result);
+                        }
+                    }
+                    else
+                    {
+                        result = EIO;
+                        CGUTILS_ERROR("Error setting listener connection to a non-blocking state: %d", result);
+                    }
+                }
+                else
+                {
+                    result = EIO;
+
+                    if (listener->conn != NULL)
+                    {
+                        char const * const error_str = PQerrorMessage(listener->conn);
+                        CGUTILS_ERROR("Error connecting to database %s: %s",
+                                      PQdb(listener->conn),
+                                      error_str ?: "no error message");
+                    }
+                    else
+                    {
+                        CGUTILS_ERROR("Error connecting to database: %d", result);
+                    }
+                }
+            }
+            else
+            {
+                result = ENOMEM;
+                CGUTILS_ERROR("Error allocating channel name: %d", result);
+            }
+
+            if (result == 0)
+            {
+                *out = listener;
+            }
+            else
+            {
+                cgdb_pg_listener_free(listener), listener = NULL;
+            }
+        }
+        else
+        {
+            result = ENOMEM;
+            CGUTILS_ERROR("Error allocating listener: %d", result);
+        }
+    }
+
+    return result;
+}
+
+static void cgdb_pg_listener_destroy(void * const data,
+                                     cgdb_backend_listener * const listener)
+{
+    (void) data;
+
+    cgdb_pg_listener_free(listener);
+}
+
 COMPILER_BLOCK_VISIBILITY_DEFAULT
 
 extern cgdb_backend_ops const cgdb_backend_pg_ops;
@@ -2889,6 +5016,9 @@ cgdb_backend_ops const cgdb_backend_pg_ops =
     .increment = &cgdb_pg_increment,
     .exec_stmt = &cgdb_pg_exec_stmt,
     .exec_rows_stmt = &cgdb_pg_exec_rows_stmt,
+    .exec_batch = &cgdb_pg_exec_batch,
+    .listen = &cgdb_pg_listen,
+    .destroy_listener = &cgdb_pg_listener_destroy,
     .exec_rows_stmt_sync = &cgdb_pg_exec_rows_stmt_sync,
     .sync_test_credentials = &cgdb_pg_sync_test_credentials,
 };
@@ -26,6 +26,7 @@
 #include <inttypes.h>
 #include <limits.h>
 #include <stdbool.h>
+#include <stdio.h>
 #include <string.h>
 
 #include <cgdb/cgdb.h>
@@ -141,6 +142,146 @@ void cgdb_param_set_null(cgdb_param params[],
     (*position)++;
 }
 
+/* Array parameters are sent as a text literal ('{1,2,3}'),
+   which lets the statement cast them with $n::BIGINT[]. */
+int cgdb_param_array_literal_from_uint64(uint64_t const * const values,
+                                         size_t const values_count,
+                                         char ** const out)
+{
+    int result = EINVAL;
+
+    if (COMPILER_LIKELY(values != NULL &&
+                        values_count > 0 &&
+                        out != NULL))
+    {
+        /* 20 digits and a separator per value, plus the braces */
+        size_t const literal_size = (values_count * 21) + 3;
+        char * literal = NULL;
+
+        CGUTILS_MALLOC(literal, literal_size, 1);
+
+        if (COMPILER_LIKELY(literal != NULL))
+        {
+            size_t pos = 0;
+
+            literal[pos++] = '{';
+
+            for (size_t idx = 0;
+                 idx < values_count;
+                 idx++)
+            {
+                int const res = snprintf(literal + pos,
+                                         literal_size - pos,
+                                         "%s%"PRIu64,
+                                         idx > 0 ? "," : "",
+                                         values[idx]);
+
+                CGUTILS_ASSERT(res > 0 && (size_t) res < literal_size - pos);
+                pos += (size_t) res;
+            }
+
+            literal[pos++] = '}';
+            literal[pos] = '\0';
+
+            *out = literal;
+            result = 0;
+        }
+        else
+        {
+            result = ENOMEM;
+        }
+    }
+
+    return result;
+}
+
+/* Same as above for strings, every element being double-quoted
+   ('{"a","b\"c"}') so that commas, braces and spaces are kept as is. */
+int cgdb_param_array_literal_from_strings(char const * const * const values,
+                                          size_t const values_count,
+                                          char ** const out)
+{
+    int result = EINVAL;
+
+    if (COMPILER_LIKELY(values != NULL &&
+                        values_count > 0 &&
+                        out != NULL))
+    {
+        size_t literal_size = 3;
+
+        result = 0;
+
+        for (size_t idx = 0;
+             result == 0 &&
+                 idx < values_count;
+             idx++)
+        {
+            if (COMPILER_LIKELY(values[idx] != NULL))
+            {
+                /* quotes, separator and, at worst, every char escaped */
+                literal_size += (strlen(values[idx]) * 2) + 3;
+            }
+            else
+            {
+                result = EINVAL;
+            }
+        }
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            char * literal = NULL;
+
+            CGUTILS_MALLOC(literal, literal_size, 1);
+
+            if (COMPILER_LIKELY(literal != NULL))
+            {
+                size_t pos = 0;
+
+                literal[pos++] = '{';
+
+                for (size_t idx = 0;
+                     idx < values_count;
+                     idx++)
+                {
+                    if (idx > 0)
+                    {
+                        literal[pos++] = ',';
+                    }
+
+                    literal[pos++] = '"';
+
+                    for (char const * ptr = values[idx];
+                         *ptr != '\0';
+                         ptr++)
+                    {
+                        if (*ptr == '"' || *ptr == '\\')
+                        {
+                            literal[pos++] = '\\';
+                        }
+
+                        literal[pos++] = *ptr;
+                    }
+
+                    literal[pos++] = '"';
+                }
+
+                literal[pos++] = '}';
+                literal[pos] = '\0';
+
+                CGUTILS_ASSERT(pos < literal_size);
+
+                *out = literal;
+            }
+            else
+            {
+                result = ENOMEM;
+            }
+        }
+    }
+
+    return result;
+}
+
 int cgdb_get_inode_from_row(cgdb_row const * const row,
                             cgdb_inode ** const out)
 {
@@ -247,128 +388,18 @@ GET(uint16, digest_type, true)
     return result;
 }
 
-int cgdb_get_entry_from_row(cgdb_row const * const row,
-                            cgdb_entry ** const out)
+void cgdb_entry_finish_decoding(cgdb_entry * const entry)
 {
-    int result = EINVAL;
-
-    CGUTILS_ASSERT(row != NULL);
-    CGUTILS_ASSERT(out != NULL);
-    uint64_t entry_id = 0;
-    uint64_t fs_id = 0;
-    uint16_t type = 0;
-    char * name = NULL;
-    char * link_to = NULL;
-    uint64_t inode_number = 0;
-    uint64_t uid = 0;
-    uint64_t gid = 0;
-    uint64_t mode = 0;
-    uint64_t size = 0;
-    uint64_t atime = 0;
-    uint64_t ctime = 0;
-    uint64_t mtime = 0;
-    uint64_t last_usage = 0;
-    uint64_t last_modification = 0;
-    uint64_t nlink = 0;
-    uint64_t dirty_writers = 0;
-    bool in_cache = false;
-    char * digest = NULL;
-    uint16_t digest_type = 0;
+    CGUTILS_ASSERT(entry != NULL);
 
-    result = 0;
+    COMPILER_STATIC_ASSERT(sizeof(ino_t) <= sizeof(uint64_t),
+                           "The size of the ino_t type should be <= the size of uint64_t");
+    entry->inode.st.st_ino = (ino_t) entry->inode.inode_number;
 
-#define GET(type, name, idx, optional)                                  \
-    if (COMPILER_LIKELY(result == 0))                                   \
-    {                                                                   \
-        result = cgdb_row_get_field_value_as_ ## type ## _by_idx(row, idx, &name); \
-        if (result == ENOENT && optional == true)                       \
-        {                                                               \
-            result = 0;                                                 \
-        }                                                               \
-        else if (COMPILER_UNLIKELY(result != 0))                        \
-        {                                                               \
-            CGUTILS_ERROR("Error getting field '%s': %d", #name, result); \
-        }                                                               \
-    }
-GET(uint64, entry_id, 1, false)
-GET(uint64, fs_id, 2, false)
-GET(uint16, type, 3, false)
-GET(string, name, 4, false)
-GET(string, link_to, 5, false)
-GET(uint64, inode_number, 6, false)
-GET(uint64, uid, 7, false)
-GET(uint64, gid, 8, false)
-GET(uint64, mode, 9, false)
-GET(uint64, size, 10, false)
-GET(uint64, atime, 11, false)
-GET(uint64, ctime, 12, false)
-GET(uint64, mtime, 13, false)
-GET(uint64, last_usage, 14, false)
-GET(uint64, last_modification, 15, false)
-GET(uint64, nlink, 16, false)
-GET(uint64, dirty_writers, 17, false)
-GET(boolean, in_cache, 18, false)
-GET(string, digest, 19, true)
-GET(uint16, digest_type, 20, true)
-#undef GET
-
-    if (COMPILER_LIKELY(result == 0))
+    if (entry->inode.digest != NULL)
     {
-        cgdb_entry * entry = NULL;
-
-        CGUTILS_ALLOCATE_STRUCT(entry);
-
-        if (COMPILER_LIKELY(entry != NULL))
-        {
-            entry->name = name;
-            entry->link_to = link_to;
-            entry->entry_id = entry_id;
-            entry->fs_id = fs_id;
-            entry->type = type;
-
-            entry->inode.inode_number = inode_number;
-            entry->inode.st.st_uid = (uid_t) uid;
-            entry->inode.st.st_gid = (gid_t) gid;
-            entry->inode.st.st_mode = (mode_t) mode;
-            entry->inode.st.st_nlink = (nlink_t) nlink;
-            COMPILER_STATIC_ASSERT(sizeof(ino_t) <= sizeof(uint64_t),
-                                   "The size of the ino_t type should be <= the size of uint64_t");
-            entry->inode.st.st_ino = (ino_t) inode_number;
-            entry->inode.last_usage = last_usage;
-            entry->inode.last_modification = last_modification;
-            entry->inode.dirty_writers = dirty_writers;
-            entry->inode.in_cache = in_cache;
-            entry->inode.digest = digest;
-            entry->inode.digest_type = (uint8_t) digest_type;
-
-            if (digest != NULL)
-            {
-                entry->inode.digest_size = strlen(digest);
-            }
-
-            entry->inode.st.st_size = (size <= LONG_MAX) ? (long) size : 0;
-            entry->inode.st.st_atime = (atime <= LONG_MAX) ? (long) atime : 0;
-            entry->inode.st.st_ctime = (ctime <= LONG_MAX) ? (long) ctime : 0;
-            entry->inode.st.st_mtime = (mtime <= LONG_MAX) ? (long) mtime : 0;
-
-            *out = entry;
-        }
-        else
-        {
-            result = ENOMEM;
-            CGUTILS_ERROR("Error allocating memory for entry: %d", result);
-        }
-
+        entry->inode.digest_size = strlen(entry->inode.digest);
     }
-
-    if (COMPILER_UNLIKELY(result != 0))
-    {
-        CGUTILS_FREE(name);
-        CGUTILS_FREE(link_to);
-        CGUTILS_FREE(digest);
-    }
-
-    return result;
 }
 
 int cgdb_get_delayed_expunge_entry_from_row(cgdb_row const * const row,
@@ -483,92 +514,6 @@ GET(boolean, in_cache, false)
     return result;
 }
 
-int cgdb_get_inode_instance_from_row(cgdb_row const * const row,
-                                     cgdb_inode_instance ** const out)
-{
-    assert(row != NULL);
-    assert(out != NULL);
-
-    int result = 0;
-
-    uint64_t upload_time = 0;
-    uint64_t inode_mtime = 0;
-    uint64_t inode_last_modification = 0;
-    uint64_t inode_size = 0;
-    uint64_t instance_id = 0;
-    uint64_t inode_number = 0;
-    uint64_t inode_dirty_writers = 0;
-    char * id_in_instance = NULL;
-    uint64_t fs_id = 0;
-    bool uploading = false;
-    bool deleting = false;
-    uint8_t status = 0;
-    uint8_t inode_digest_type = 0;
-
-#define GET(type, name, optional)                                       \
-    if (result == 0)                                                    \
-    {                                                                   \
-        result = cgdb_row_get_field_value_as_ ## type(row, #name, &name); \
-        if (result == ENOENT && optional == true)                       \
-        {                                                               \
-            result = 0;                                                 \
-        }                                                               \
-        else if (result != 0)                                           \
-        {                                                               \
-            CGUTILS_ERROR("Error getting field %s: %d", #name, result); \
-        }                                                               \
-    }
-GET(uint64, instance_id, false)
-GET(uint64, inode_number, false)
-GET(uint64, upload_time, false)
-GET(uint64, inode_mtime, true)
-GET(uint64, inode_last_modification, true)
-GET(uint64, inode_size, true)
-GET(uint64, inode_dirty_writers, true)
-GET(string, id_in_instance, false)
-GET(uint64, fs_id, false)
-GET(boolean, uploading, false)
-GET(boolean, deleting, false)
-GET(uint8, status, false)
-GET(uint8, inode_digest_type, true)
-#undef GET
-
-    if (result == 0)
-    {
-        CGUTILS_ALLOCATE_STRUCT(*out);
-
-        if (*out != NULL)
-        {
-            cgdb_inode_instance * this = *out;
-            this->upload_time = upload_time;
-            this->inode_mtime = inode_mtime;
-            this->inode_last_modification = inode_last_modification;
-            this->instance_id = instance_id;
-            this->inode_number = inode_number;
-            this->id_in_instance = id_in_instance;
-            this->inode_dirty_writers = inode_dirty_writers;
-            this->inode_size = (size_t) inode_size;
-            this->inode_digest_type = inode_digest_type;
-            this->fs_id = fs_id;
-            this->status = status;
-            this->uploading = uploading;
-            this->deleting = deleting;
-        }
-        else
-        {
-            result = ENOMEM;
-            CGUTILS_ERROR("Error allocating object: %d", result);
-        }
-    }
-
-    if (result != 0)
-    {
-        CGUTILS_FREE(id_in_instance);
-    }
-
-    return result;
-}
-
 int cgdb_field_set_string(cgdb_field * const this,
                           char const * const name,
                           size_t const name_len,
@@ -24,14 +24,11 @@
 #ifndef CLOUD_GATEWAY_UTILS_INTERNAL_H_
 #define CLOUD_GATEWAY_UTILS_INTERNAL_H_
 
-int cgdb_get_inode_instance_from_row(cgdb_row const * row,
-                                     cgdb_inode_instance ** out);
-
 int cgdb_get_inode_from_row(cgdb_row const * row,
                             cgdb_inode ** out);
 
-int cgdb_get_entry_from_row(cgdb_row const * row,
-                            cgdb_entry ** out);
+/* Complete an entry decoded by the backend from its row layout */
+void cgdb_entry_finish_decoding(cgdb_entry * entry);
 
 int cgdb_get_delayed_expunge_entry_from_row(cgdb_row const * row,
                                             cgdb_delayed_expunge_entry ** out);
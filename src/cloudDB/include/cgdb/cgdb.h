@@ -35,6 +35,7 @@
 typedef struct cgdb_data cgdb_data;
 
 typedef struct cgdb_cursor cgdb_cursor;
+typedef struct cgdb_listener cgdb_listener;
 
 typedef enum
 {
@@ -77,24 +78,26 @@ typedef struct
 typedef struct cgdb_inode_instance
 {
     char * id_in_instance;
+    /* only set by claim_inode_instances_by_status */
+    uint64_t inode_instance_id;
     uint64_t fs_id;
     uint64_t inode_number;
     uint64_t instance_id;
     uint64_t upload_time;
     /* inode instance has no last modification,
-       but in certain cases (e.g. get_inodes_instances_by_status - Syncer),
+       but in certain cases (e.g. claim_inode_instances_by_status - Syncer),
        the inode's last modification is fetched as well. */
     uint64_t inode_last_modification;
     /* inode instance has no mtime,
-       but in certain cases (e.g. get_inodes_instances_by_status - Syncer),
+       but in certain cases (e.g. claim_inode_instances_by_status - Syncer),
        the inode's mtime is fetched as well. */
     uint64_t inode_mtime;
     /* inode instance has no dirty_writers,
-       but in certain cases (e.g. get_inodes_instances_by_status - Syncer),
+       but in certain cases (e.g. claim_inode_instances_by_status - Syncer),
        the inode's dirty_writers is fetched as well. */
     uint64_t inode_dirty_writers;
     /* inode instance has no size,
-       but in certain cases (e.g. get_inodes_instances_by_status - Syncer),
+       but in certain cases (e.g. claim_inode_instances_by_status - Syncer),
        the inode's size is fetched as well. */
     size_t inode_size;
     uint8_t inode_digest_type;
@@ -175,6 +178,17 @@ typedef int (cgdb_readlink_cb)(int status,
                                char * link_to,
                                void * cb_data);
 
+/* Called with a NULL payload once the listener is ready, then with the
+   payload of each notification. After an error, nothing more is received
+   and the listener has to be freed, but not from the callback. */
+typedef int (cgdb_notification_cb)(int status,
+                                   char const * payload,
+                                   void * cb_data);
+
+/* Notified by the database whenever an inode instance enters the
+   work queue, with the instance status as payload. */
+#define CGDB_SYNCER_WORK_CHANNEL "cg_syncer_work"
+
 typedef int64_t cgdb_limit_type;
 typedef int64_t cgdb_skip_type;
 
@@ -305,14 +319,16 @@ int cgdb_update_inode_digest(cgdb_data * db,
                              cgdb_status_cb * cb,
                              void * cb_data);
 
+/* Entries are returned by increasing entry ID, starting after after_entry_id
+   (0 for the first page). Pass the ID of the last entry returned to get the next page. */
 int cgdb_get_not_dirty_entries_by_type_size_last_usage_cached(cgdb_data * db,
                                                               uint64_t fs_id,
                                                               cgdb_entry_type type,
                                                               size_t min_size,
                                                               uint64_t max_usage,
                                                               uint16_t dirty_status,
+                                                              uint64_t after_entry_id,
                                                               cgdb_limit_type limit,
-                                                              cgdb_skip_type skip,
                                                               cgdb_multiple_entries_getter_cb * cb,
                                                               void * cb_data);
 
@@ -334,6 +350,19 @@ int cgdb_add_inode_instance(cgdb_data * db,
                             cgdb_status_cb * cb,
                             void * cb_data);
 
+/* Add one inode instance per entry of instances_ids / ids_in_instance
+   in a single round trip. Either all of them are added, or none is.
+   Returns ENOSYS if the backend does not support batches. */
+int cgdb_add_inode_instances(cgdb_data * db,
+                             uint64_t fs_id,
+                             uint64_t inode_number,
+                             uint64_t const * instances_ids,
+                             char const * const * ids_in_instance,
+                             size_t instances_count,
+                             uint8_t status,
+                             cgdb_status_cb * cb,
+                             void * cb_data);
+
 int cgdb_remove_inode_instance(cgdb_data * db,
                                uint64_t fs_id,
                                uint64_t instance_id,
@@ -406,6 +435,20 @@ int cgdb_set_inode_and_all_inodes_instances_dirty(cgdb_data * db,
                                                   cgdb_status_cb *cb,
                                                   void * cb_data);
 
+/* Batched variant of set_inode_and_all_inodes_instances_dirty,
+   applied to all the given inodes at once. */
+int cgdb_set_inodes_and_all_inodes_instances_dirty_multi(cgdb_data * db,
+                                                         uint64_t fs_id,
+                                                         uint64_t const * inodes,
+                                                         size_t inodes_count,
+                                                         time_t min_mtime,
+                                                         time_t min_ctime,
+                                                         time_t last_modification,
+                                                         uint8_t old_status,
+                                                         uint8_t new_status,
+                                                         cgdb_status_cb * cb,
+                                                         void * cb_data);
+
 int cgdb_get_inode_valid_instances(cgdb_data * db,
                                    uint64_t fs_id,
                                    uint64_t inode_number,
@@ -425,6 +468,32 @@ int cgdb_get_inode_entries(cgdb_data * db,
                            cgdb_multiple_entries_getter_cb * cb,
                            void * cb_data);
 
+int cgdb_get_inode_entries_page(cgdb_data * db,
+                                uint64_t fs_id,
+                                uint64_t directory_inode_id,
+                                uint64_t after_entry_id,
+                                cgdb_limit_type limit,
+                                cgdb_multiple_entries_getter_cb * cb,
+                                void * cb_data);
+
+/* Batched variants of get_inode_info and get_child_inode_info,
+   returning one entry per inode found, in no particular order.
+   Missing inodes or names are simply absent from the result. */
+int cgdb_get_inodes_info_multi(cgdb_data * db,
+                               uint64_t fs_id,
+                               uint64_t const * inodes,
+                               size_t inodes_count,
+                               cgdb_multiple_entries_getter_cb * cb,
+                               void * cb_data);
+
+int cgdb_get_children_inodes_info_multi(cgdb_data * db,
+                                        uint64_t fs_id,
+                                        uint64_t parent_ino,
+                                        char const * const * names,
+                                        size_t names_count,
+                                        cgdb_multiple_entries_getter_cb * cb,
+                                        void * cb_data);
+
 int cgdb_get_cursor_inode_entries(cgdb_data * db,
                                   uint64_t fs_id,
                                   uint64_t directory_inode_id,
@@ -443,12 +512,15 @@ int cgdb_get_expired_delayed_expunge_entries(cgdb_data * db,
                                              cgdb_multiple_delayed_expunge_entries_getter_cb * cb,
                                              void * cb_data);
 
-int cgdb_get_inode_instances_by_status(cgdb_data * db,
-                                       uint8_t status,
-                                       cgdb_limit_type const limit,
-                                       cgdb_skip_type const skip,
-                                       cgdb_multiple_inode_instances_getter_cb * cb,
-                                       void * cb_data);
+/* Claim up to limit instances of the given status from the work queue.
+   A claimed instance is not returned again, to this caller or any other,
+   until lease_duration seconds have passed or its state changes. */
+int cgdb_claim_inode_instances_by_status(cgdb_data * db,
+                                         uint8_t status,
+                                         uint64_t lease_duration,
+                                         cgdb_limit_type limit,
+                                         cgdb_multiple_inode_instances_getter_cb * cb,
+                                         void * cb_data);
 
 int cgdb_count_inode_instances_by_status(cgdb_data * db,
                                          uint64_t fs_id,
@@ -499,6 +571,15 @@ int cgdb_sync_get_version(cgdb_data * db,
 int cgdb_sync_test_credentials(cgdb_data * db,
                                char ** error_str);
 
+/* Returns ENOSYS if the backend does not support notifications */
+int cgdb_listen(cgdb_data * db,
+                char const * channel,
+                cgdb_notification_cb * cb,
+                void * cb_data,
+                cgdb_listener ** listener);
+
+void cgdb_listener_free(cgdb_listener * listener);
+
 void cgdb_inode_instance_free(cgdb_inode_instance * this);
 void cgdb_inode_clean(cgdb_inode * this);
 void cgdb_inode_free(cgdb_inode * this);
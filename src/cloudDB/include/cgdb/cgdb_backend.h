@@ -32,11 +32,12 @@
 #include <cgdb/cgdb_utils.h>
 
 typedef void cgdb_backend_cursor;
+typedef void cgdb_backend_listener;
 
 typedef enum cgdb_backend_statements
 {
     cgdb_backend_statement_none = 0,
-#define STMT(name, count) cgdb_backend_statement_ ## name,
+#define STMT(name, count, layout) cgdb_backend_statement_ ## name,
 #include "cgdb/cgdb_backend_statements.itm"
 #undef STMT
     cgdb_backend_statement_count
@@ -45,12 +46,43 @@ typedef enum cgdb_backend_statements
 static size_t const cgdb_backend_statement_params_count[] =
 {
     0,
-#define STMT(name, count) count,
+#define STMT(name, count, layout) count,
 #include "cgdb/cgdb_backend_statements.itm"
 #undef STMT
     0
 };
 
+#define CGDB_BACKEND_ROW_LAYOUT_MAX_COLUMNS (24)
+
+typedef enum
+{
+    cgdb_backend_row_column_kind_unsigned,
+    /* set to 0 if the value does not fit in the signed member */
+    cgdb_backend_row_column_kind_signed,
+    cgdb_backend_row_column_kind_boolean,
+    cgdb_backend_row_column_kind_string
+} cgdb_backend_row_column_kind;
+
+typedef struct
+{
+    char const * name;
+    size_t offset;
+    size_t size;
+    cgdb_backend_row_column_kind kind;
+    bool optional;
+} cgdb_backend_row_column;
+
+/* Statements declaring a row layout in cgdb_backend_statements.itm get
+   each row decoded straight into a structure of row_size bytes, to be
+   freed with row_free, instead of a cgdb_row. */
+typedef struct
+{
+    cgdb_backend_row_column const * columns;
+    size_t columns_count;
+    size_t row_size;
+    void (*row_free)(void *);
+} cgdb_backend_row_layout;
+
 typedef int (cgdb_backend_cursor_cb)(cgdb_backend_cursor *,
                                      int status,
                                      bool has_error,
@@ -63,11 +95,25 @@ typedef void (cgdb_backend_status_cb)(void * data,
                                       int status,
                                       void * cb_data);
 
+/* One statement of a batch, see cgdb_backend_exec_batch() */
+typedef struct
+{
+    cgdb_param const * params;
+    size_t params_count;
+    cgdb_backend_statement statement;
+} cgdb_backend_batch_stmt;
+
 typedef void (cgdb_backend_status_returning_cb)(void * data,
                                                 int status,
                                                 uint64_t id,
                                                 void * cb_data);
 
+/* status is 0 and payload NULL once the backend is listening,
+   then cb is called with the payload of each notification. */
+typedef void (cgdb_backend_notification_cb)(int status,
+                                            char const * payload,
+                                            void * cb_data);
+
 typedef int (cgdb_backend_op_init)(cgutils_event_data * event_data,
                                    cgutils_configuration const * specifics,
                                    void ** data);
@@ -109,6 +155,21 @@ typedef int (cgdb_backend_op_exec_rows_stmt)(void * data,
                                              cgdb_backend_cursor_cb * cb,
                                              void * cb_data);
 
+typedef int (cgdb_backend_op_exec_batch)(void * data,
+                                         cgdb_backend_batch_stmt const * stmts,
+                                         size_t stmts_count,
+                                         cgdb_backend_status_cb * cb,
+                                         void * cb_data);
+
+typedef int (cgdb_backend_op_listen)(void * data,
+                                     char const * channel,
+                                     cgdb_backend_notification_cb * cb,
+                                     void * cb_data,
+                                     cgdb_backend_listener ** listener);
+
+typedef void (cgdb_backend_op_destroy_listener)(void * data,
+                                                cgdb_backend_listener * listener);
+
 typedef int (cgdb_backend_op_exec_rows_stmt_sync)(void * data,
                                                   cgdb_backend_statement statement,
                                                   cgdb_param const * params,
@@ -161,6 +222,9 @@ typedef struct cgdb_backend_ops
     cgdb_backend_op_free * free;
     cgdb_backend_op_exec_stmt * exec_stmt;
     cgdb_backend_op_exec_rows_stmt * exec_rows_stmt;
+    cgdb_backend_op_exec_batch * exec_batch;
+    cgdb_backend_op_listen * listen;
+    cgdb_backend_op_destroy_listener * destroy_listener;
     cgdb_backend_op_exec_rows_stmt_sync * exec_rows_stmt_sync;
     cgdb_backend_op_sync_test_credentials * sync_test_credentials;
 } cgdb_backend_ops;
@@ -169,6 +233,9 @@ typedef struct cgdb_backend cgdb_backend;
 
 COMPILER_BLOCK_VISIBILITY_DEFAULT
 
+/* NULL if the rows of this statement are returned as cgdb_row */
+cgdb_backend_row_layout const * cgdb_backend_get_row_layout(cgdb_backend_statement statement);
+
 int cgdb_backend_init(char const * name,
                       char const * backends_path,
                       cgutils_event_data * event_data,
@@ -233,6 +300,25 @@ int cgdb_backend_exec_rows_stmt(cgdb_backend * backend,
                                 cgdb_backend_cursor_cb * cb,
                                 void * cb_data);
 
+/* Send all the statements at once, as a single unit: if one of them fails,
+   none of them is applied. cb is called once, after the last one. */
+int cgdb_backend_exec_batch(cgdb_backend * backend,
+                            cgdb_backend_batch_stmt const * stmts,
+                            size_t stmts_count,
+                            cgdb_backend_status_cb * cb,
+                            void * cb_data);
+
+/* Subscribe to the notifications sent on channel. The listener has to be
+   destroyed with cgdb_backend_listener_destroy(), but not from cb. */
+int cgdb_backend_listen(cgdb_backend * backend,
+                        char const * channel,
+                        cgdb_backend_notification_cb * cb,
+                        void * cb_data,
+                        cgdb_backend_listener ** listener);
+
+void cgdb_backend_listener_destroy(cgdb_backend * backend,
+                                   cgdb_backend_listener * listener);
+
 void cgdb_backend_cursor_destroy(cgdb_backend * backend,
                                  cgdb_backend_cursor * cursor);
 
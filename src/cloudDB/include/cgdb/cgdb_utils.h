@@ -108,6 +108,14 @@ void cgdb_param_set_immutable_string(cgdb_param params[],
 void cgdb_param_set_null(cgdb_param params[],
                          size_t * position);
 
+int cgdb_param_array_literal_from_uint64(uint64_t const * values,
+                                         size_t values_count,
+                                         char ** out);
+
+int cgdb_param_array_literal_from_strings(char const * const * values,
+                                          size_t values_count,
+                                          char ** out);
+
 int cgdb_field_set_string(cgdb_field * field,
                           char const * name,
                           size_t name_len,
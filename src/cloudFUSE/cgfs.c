@@ -22,17 +22,32 @@
  */
 
 #include <errno.h>
+#include <time.h>
 
 #include <cgfs.h>
+#include <cgfs_async.h>
 
 #include <cloudutils/cloudutils_xml.h>
 #include <cloudutils/cloudutils_configuration.h>
 
+static __thread cgfs_data * cgfs_thread_data = NULL;
+
 cgfs_data * cgfs_get_data(void)
 {
     static cgfs_data data;
+    cgfs_data * result = cgfs_thread_data;
+
+    if (result == NULL)
+    {
+        result = &data;
+    }
 
-    return &data;
+    return result;
+}
+
+void cgfs_set_thread_data(cgfs_data * const data)
+{
+    cgfs_thread_data = data;
 }
 
 int cgfs_init(void)
@@ -62,9 +77,22 @@ void cgfs_destroy(void)
 
         if (this->cache != NULL)
         {
-            cgfs_cache_free(this->cache), this->cache = NULL;
+            /* the cache is owned by the main thread */
+            if (this->main == NULL)
+            {
+                cgfs_log_stats(this);
+                cgfs_cache_free(this->cache);
+            }
+
+            this->cache = NULL;
         }
 
+        this->main = NULL;
+
+        /* before the event loop and the inodes go away */
+        cgfs_async_notify_write_batch_clean(this);
+        cgfs_async_open_lease_clean(this);
+
         if (this->cgsmc_data != NULL)
         {
             cgsmc_async_data_free(this->cgsmc_data), this->cgsmc_data = NULL;
@@ -80,6 +108,12 @@ void cgfs_destroy(void)
             cgutils_event_destroy(this->event_data), this->event_data = NULL;
         }
 
+        /* after everything that could still release a request */
+        if (this->pool != NULL)
+        {
+            cgfs_pool_free(this->pool), this->pool = NULL;
+        }
+
         CGUTILS_FREE(this->cgsm_configuration_file);
         CGUTILS_FREE(this->pid_file);
         CGUTILS_FREE(this->fs_name);
@@ -88,6 +122,133 @@ void cgfs_destroy(void)
     }
 }
 
+static int cgfs_data_load_parameters(cgfs_data * const this)
+{
+    int result = 0;
+    cgutils_configuration * global_configuration = NULL;
+    CGUTILS_ASSERT(this != NULL);
+    CGUTILS_ASSERT(this->cgsm_configuration_file != NULL);
+    CGUTILS_ASSERT(this->fs_name != NULL);
+
+    this->inode_cache_active_size = CGFS_INODE_CACHE_ACTIVE_SIZE_DEFAULT;
+    this->inode_cache_inactive_size = CGFS_INODE_CACHE_INACTIVE_SIZE_DEFAULT;
+    this->dentry_cache_size = CGFS_DENTRY_CACHE_SIZE_DEFAULT;
+    this->dentry_cache_positive_ttl = CGFS_DENTRY_CACHE_POSITIVE_TTL_DEFAULT;
+    this->dentry_cache_negative_ttl = CGFS_DENTRY_CACHE_NEGATIVE_TTL_DEFAULT;
+    this->fuse_threads = CGFS_FUSE_THREADS_DEFAULT;
+    this->buffer_pool_size = CGFS_BUFFER_POOL_SIZE_DEFAULT;
+    this->attr_timeout_min = CGFS_ATTR_TIMEOUT_MIN_DEFAULT;
+    this->attr_timeout_max = CGFS_ATTR_TIMEOUT_MAX_DEFAULT;
+    this->entry_timeout_min = CGFS_ENTRY_TIMEOUT_MIN_DEFAULT;
+    this->entry_timeout_max = CGFS_ENTRY_TIMEOUT_MAX_DEFAULT;
+    this->notify_write_batch_size = CGFS_NOTIFY_WRITE_BATCH_SIZE_DEFAULT;
+    this->notify_write_batch_delay = CGFS_NOTIFY_WRITE_BATCH_DELAY_DEFAULT;
+    this->open_lease_cache_size = CGFS_OPEN_LEASE_CACHE_SIZE_DEFAULT;
+
+    result = cgutils_configuration_from_xml_file(this->cgsm_configuration_file,
+                                                 &global_configuration);
+
+    if (result == 0)
+    {
+        char * xpath_str = NULL;
+
+        result = cgutils_asprintf(&xpath_str,
+                                  "FileSystems/FileSystem[Id='%s']",
+                                  this->fs_name);
+
+        if (result == 0)
+        {
+            cgutils_configuration * configuration = NULL;
+
+            result = cgutils_configuration_from_path(global_configuration,
+                                                     xpath_str,
+                                                     &configuration);
+
+            if (result == 0)
+            {
+#define GET_SIZE_CONF(name, storage, defaultval)                        \
+                result = cgutils_configuration_get_size(configuration,  \
+                                                        name,           \
+                                                        &(storage));    \
+                if (result != 0)                                        \
+                {                                                       \
+                    storage = defaultval;                               \
+                    if (result != ENOENT)                               \
+                    {                                                   \
+                        CGUTILS_WARN("Invalid value found for %s, using the default.", name); \
+                    }                                                   \
+                    result = 0;                                         \
+                }
+
+                GET_SIZE_CONF("InodeCacheActiveSize", this->inode_cache_active_size, CGFS_INODE_CACHE_ACTIVE_SIZE_DEFAULT);
+                GET_SIZE_CONF("InodeCacheInactiveSize", this->inode_cache_inactive_size, CGFS_INODE_CACHE_INACTIVE_SIZE_DEFAULT);
+                GET_SIZE_CONF("DentryCacheSize", this->dentry_cache_size, CGFS_DENTRY_CACHE_SIZE_DEFAULT);
+                GET_SIZE_CONF("DentryCachePositiveTTL", this->dentry_cache_positive_ttl, CGFS_DENTRY_CACHE_POSITIVE_TTL_DEFAULT);
+                GET_SIZE_CONF("DentryCacheNegativeTTL", this->dentry_cache_negative_ttl, CGFS_DENTRY_CACHE_NEGATIVE_TTL_DEFAULT);
+                GET_SIZE_CONF("FuseThreads", this->fuse_threads, CGFS_FUSE_THREADS_DEFAULT);
+                GET_SIZE_CONF("BufferPoolSize", this->buffer_pool_size, CGFS_BUFFER_POOL_SIZE_DEFAULT);
+                GET_SIZE_CONF("AttrTimeoutMin", this->attr_timeout_min, CGFS_ATTR_TIMEOUT_MIN_DEFAULT);
+                GET_SIZE_CONF("AttrTimeoutMax", this->attr_timeout_max, CGFS_ATTR_TIMEOUT_MAX_DEFAULT);
+                GET_SIZE_CONF("EntryTimeoutMin", this->entry_timeout_min, CGFS_ENTRY_TIMEOUT_MIN_DEFAULT);
+                GET_SIZE_CONF("EntryTimeoutMax", this->entry_timeout_max, CGFS_ENTRY_TIMEOUT_MAX_DEFAULT);
+                GET_SIZE_CONF("NotifyWriteBatchSize", this->notify_write_batch_size, CGFS_NOTIFY_WRITE_BATCH_SIZE_DEFAULT);
+                GET_SIZE_CONF("NotifyWriteBatchDelay", this->notify_write_batch_delay, CGFS_NOTIFY_WRITE_BATCH_DELAY_DEFAULT);
+                GET_SIZE_CONF("OpenLeaseCacheSize", this->open_lease_cache_size, CGFS_OPEN_LEASE_CACHE_SIZE_DEFAULT);
+
+                if (this->attr_timeout_max < this->attr_timeout_min)
+                {
+                    CGUTILS_WARN("AttrTimeoutMax is lower than AttrTimeoutMin, using AttrTimeoutMin for both.");
+                    this->attr_timeout_max = this->attr_timeout_min;
+                }
+
+                if (this->entry_timeout_max < this->entry_timeout_min)
+                {
+                    CGUTILS_WARN("EntryTimeoutMax is lower than EntryTimeoutMin, using EntryTimeoutMin for both.");
+                    this->entry_timeout_max = this->entry_timeout_min;
+                }
+
+                if (this->fuse_threads == 0)
+                {
+                    this->fuse_threads = 1;
+                }
+
+                if (this->notify_write_batch_size > CGSMC_ASYNC_NOTIFY_WRITE_BATCH_SIZE_MAX)
+                {
+                    this->notify_write_batch_size = CGSMC_ASYNC_NOTIFY_WRITE_BATCH_SIZE_MAX;
+                }
+
+#undef GET_SIZE_CONF
+
+                cgutils_configuration_free(configuration), configuration = NULL;
+            }
+            else
+            {
+                CGUTILS_ERROR("There does not seem to be a filesystem/volume named %s in this file (%s): %d",
+                              this->fs_name,
+                              this->cgsm_configuration_file,
+                              result);
+            }
+
+            CGUTILS_FREE(xpath_str);
+        }
+        else
+        {
+            CGUTILS_ERROR("Error allocating memory for xpath: %d",
+                          result);
+        }
+
+        cgutils_configuration_free(global_configuration), global_configuration = NULL;
+    }
+    else
+    {
+        CGUTILS_ERROR("Unable to get configuration from the Cloud Gateway Configuration file (%s): %d",
+                      this->cgsm_configuration_file,
+                      result);
+    }
+
+    return result;
+}
+
 int cgfs_data_load_configuration(cgfs_data * const this)
 {
     CGUTILS_ASSERT(this != NULL);
@@ -102,7 +263,22 @@ int cgfs_data_load_configuration(cgfs_data * const this)
 
     if (result == 0)
     {
-        result = cgfs_cache_init(&(this->cache));
+        result = cgfs_data_load_parameters(this);
+    }
+    else
+    {
+        CGUTILS_ERROR("Error initializing the communication to the storage manager: %d",
+                      result);
+    }
+
+    if (result == 0)
+    {
+        result = cgfs_cache_init(this->inode_cache_active_size,
+                                 this->inode_cache_inactive_size,
+                                 this->dentry_cache_size,
+                                 (time_t) this->dentry_cache_positive_ttl,
+                                 (time_t) this->dentry_cache_negative_ttl,
+                                 &(this->cache));
 
         if (result != 0)
         {
@@ -110,15 +286,134 @@ int cgfs_data_load_configuration(cgfs_data * const this)
                           result);
         }
     }
+
+    if (result == 0)
+    {
+        result = cgfs_pool_init(this->buffer_pool_size,
+                                &(this->pool));
+
+        if (result != 0)
+        {
+            CGUTILS_ERROR("Error in buffer pool init: %d",
+                          result);
+        }
+    }
+
+    if (result == 0)
+    {
+        result = cgfs_async_notify_write_batch_init(this);
+    }
+
+    if (result == 0)
+    {
+        result = cgfs_async_open_lease_init(this);
+    }
+
+    return result;
+}
+
+int cgfs_data_init_worker(cgfs_data * const main,
+                          cgfs_data * const worker)
+{
+    CGUTILS_ASSERT(main != NULL);
+    CGUTILS_ASSERT(main->main == NULL);
+    CGUTILS_ASSERT(main->cache != NULL);
+    CGUTILS_ASSERT(worker != NULL);
+
+    *worker = (cgfs_data) { 0 };
+    worker->main = main;
+    worker->cache = main->cache;
+    worker->zero_copy_read = main->zero_copy_read;
+    worker->zero_copy_write = main->zero_copy_write;
+    worker->buffer_pool_size = main->buffer_pool_size;
+    worker->attr_timeout_min = main->attr_timeout_min;
+    worker->attr_timeout_max = main->attr_timeout_max;
+    worker->entry_timeout_min = main->entry_timeout_min;
+    worker->entry_timeout_max = main->entry_timeout_max;
+    worker->notify_write_batch_size = main->notify_write_batch_size;
+    worker->notify_write_batch_delay = main->notify_write_batch_delay;
+    worker->open_lease_cache_size = main->open_lease_cache_size;
+    worker->session = main->session;
+    worker->exit_pipe[0] = -1;
+    worker->exit_pipe[1] = -1;
+
+    int result = cgfs_pool_init(worker->buffer_pool_size,
+                                &(worker->pool));
+
+    if (result == 0)
+    {
+        result = cgutils_event_init(&(worker->event_data));
+
+        if (result != 0)
+        {
+            CGUTILS_ERROR("Error initializing event: %d",
+                          result);
+        }
+    }
     else
     {
-        CGUTILS_ERROR("Error initializing the communication to the storage manager: %d",
+        CGUTILS_ERROR("Error in buffer pool init: %d",
                       result);
     }
 
+    if (result == 0)
+    {
+        result = cgutils_aio_init(worker->event_data,
+                                  &(worker->aio));
+
+        if (result == 0)
+        {
+            /* each worker gets its own pool of connections */
+            result = cgsmc_async_data_init(main->fs_name,
+                                           main->cgsm_configuration_file,
+                                           worker->event_data,
+                                           &(worker->cgsmc_data));
+
+            if (result != 0)
+            {
+                CGUTILS_ERROR("Error initializing the communication to the storage manager: %d",
+                              result);
+            }
+        }
+        else
+        {
+            CGUTILS_ERROR("Error initializing AIO: %d",
+                          result);
+        }
+    }
+
+    if (result == 0)
+    {
+        result = cgfs_async_notify_write_batch_init(worker);
+    }
+
+    if (result == 0)
+    {
+        result = cgfs_async_open_lease_init(worker);
+    }
+
     return result;
 }
 
+bool cgfs_is_multithreaded(cgfs_data const * const data)
+{
+    CGUTILS_ASSERT(data != NULL);
+
+    return data->main != NULL || data->workers_count > 0;
+}
+
+bool cgfs_set_root_inode_number(cgfs_data * const data,
+                                uint64_t const ino)
+{
+    CGUTILS_ASSERT(data != NULL);
+    CGUTILS_ASSERT(ino > 0);
+    cgfs_data * const shared = data->main != NULL ? data->main : data;
+
+    return COMPILER_SYNC_BOOL_COMPARE_AND_SWAP(&(shared->root_inode_number),
+                                               0,
+                                               ino);
+}
+
 uint64_t cgfs_translate_inode_number(cgfs_data const * const data,
                                      uint64_t const ino)
 {
@@ -126,11 +421,187 @@ uint64_t cgfs_translate_inode_number(cgfs_data const * const data,
 
     CGUTILS_ASSERT(data != NULL);
 
-    if (COMPILER_UNLIKELY(ino == 1 &&
-                          data->root_inode_number > 0))
+    if (COMPILER_UNLIKELY(ino == 1))
     {
-        result = data->root_inode_number;
+        cgfs_data const * const shared = data->main != NULL ? data->main : data;
+        uint64_t const root_inode_number = shared->root_inode_number;
+
+        if (root_inode_number > 0)
+        {
+            result = root_inode_number;
+        }
     }
 
     return result;
 }
+
+static size_t cgfs_clamp_timeout(size_t const value,
+                                 size_t const min,
+                                 size_t const max)
+{
+    return value < min ? min : value > max ? max : value;
+}
+
+void cgfs_get_inode_timeouts(cgfs_data * const data,
+                             cgfs_inode * const inode,
+                             double * const attr_timeout,
+                             double * const entry_timeout)
+{
+    CGUTILS_ASSERT(data != NULL);
+    uint64_t const writers = inode != NULL ? cgfs_inode_get_writers(inode) : 0;
+    size_t age = 0;
+
+    /* Like the NFS attribute cache, the longer an inode has not
+       been modified, the longer it will likely stay unmodified:
+       we use a tenth of the time since its last change, within bounds.
+       Inodes currently written to get the lowest bounds. */
+    if (inode != NULL &&
+        writers == 0)
+    {
+        time_t const now = time(NULL);
+        time_t const last_change = cgfs_inode_get_last_change(inode);
+
+        if (now > last_change)
+        {
+            age = (size_t) (now - last_change) / 10;
+        }
+    }
+
+    size_t const attr = cgfs_clamp_timeout(age,
+                                           data->attr_timeout_min,
+                                           data->attr_timeout_max);
+
+    if (attr_timeout != NULL)
+    {
+        *attr_timeout = (double) attr;
+    }
+
+    if (entry_timeout != NULL)
+    {
+        size_t const entry = cgfs_clamp_timeout(age,
+                                                data->entry_timeout_min,
+                                                data->entry_timeout_max);
+        *entry_timeout = (double) entry;
+    }
+
+    cgfs_timeout_stats * const stats = data->main != NULL ? &(data->main->timeout_stats) : &(data->timeout_stats);
+
+    if (attr == data->attr_timeout_min)
+    {
+        COMPILER_SYNC_ADD_AND_FETCH(&(stats->min_timeouts), 1);
+
+        if (writers > 0)
+        {
+            COMPILER_SYNC_ADD_AND_FETCH(&(stats->writing_timeouts), 1);
+        }
+    }
+    else if (attr == data->attr_timeout_max)
+    {
+        COMPILER_SYNC_ADD_AND_FETCH(&(stats->max_timeouts), 1);
+    }
+    else
+    {
+        COMPILER_SYNC_ADD_AND_FETCH(&(stats->adaptive_timeouts), 1);
+    }
+}
+
+void cgfs_get_timeout_stats(cgfs_data const * const data,
+                            cgfs_timeout_stats * const stats)
+{
+    CGUTILS_ASSERT(data != NULL);
+    CGUTILS_ASSERT(stats != NULL);
+    cgfs_data const * const shared = data->main != NULL ? data->main : data;
+
+    /* the counters may be updated concurrently,
+       each of them is consistent */
+    *stats = shared->timeout_stats;
+}
+
+void cgfs_log_stats(cgfs_data const * const data)
+{
+    CGUTILS_ASSERT(data != NULL);
+    cgfs_timeout_stats timeouts = (cgfs_timeout_stats) { 0 };
+
+    cgfs_get_timeout_stats(data,
+                           &timeouts);
+
+    CGUTILS_INFO("Attribute timeouts: %"PRIu64" min (%"PRIu64" open for writing), %"PRIu64" adaptive, %"PRIu64" max, bounds %zu-%zu",
+                 timeouts.min_timeouts,
+                 timeouts.writing_timeouts,
+                 timeouts.adaptive_timeouts,
+                 timeouts.max_timeouts,
+                 data->attr_timeout_min,
+                 data->attr_timeout_max);
+
+    if (data->cache != NULL)
+    {
+        cgfs_cache_stats cache = (cgfs_cache_stats) { 0 };
+
+        cgfs_cache_get_stats(data->cache,
+                             &cache);
+
+        CGUTILS_INFO("Inode cache: %zu inodes (%zu active, %zu inactive), %"PRIu64" hits, %"PRIu64" misses",
+                     cache.count,
+                     cache.active_count,
+                     cache.inactive_count,
+                     cache.hits,
+                     cache.misses);
+        CGUTILS_INFO("Dentry cache: %zu entries, %"PRIu64" hits, %"PRIu64" negative hits, %"PRIu64" misses",
+                     cache.dentries_count,
+                     cache.dentry_hits,
+                     cache.dentry_negative_hits,
+                     cache.dentry_misses);
+    }
+}
+
+/* The kernel knows the root inode as 1 */
+static uint64_t cgfs_get_kernel_inode_number(cgfs_data const * const shared,
+                                             uint64_t const ino)
+{
+    CGUTILS_ASSERT(shared != NULL);
+    return ino == shared->root_inode_number ? 1 : ino;
+}
+
+void cgfs_set_invalidation_callbacks(cgfs_data * const data,
+                                     cgfs_invalidate_inode_cb * const inode_cb,
+                                     cgfs_invalidate_entry_cb * const entry_cb,
+                                     void * const cb_data)
+{
+    CGUTILS_ASSERT(data != NULL);
+    CGUTILS_ASSERT(data->main == NULL);
+
+    data->invalidate_inode_cb = inode_cb;
+    data->invalidate_entry_cb = entry_cb;
+    data->invalidate_cb_data = cb_data;
+}
+
+void cgfs_invalidate_inode(cgfs_data const * const data,
+                           uint64_t const ino)
+{
+    CGUTILS_ASSERT(data != NULL);
+    CGUTILS_ASSERT(ino > 0);
+    cgfs_data const * const shared = data->main != NULL ? data->main : data;
+
+    if (shared->invalidate_inode_cb != NULL)
+    {
+        (*(shared->invalidate_inode_cb))(shared->invalidate_cb_data,
+                                         cgfs_get_kernel_inode_number(shared, ino));
+    }
+}
+
+void cgfs_invalidate_entry(cgfs_data const * const data,
+                           uint64_t const parent_ino,
+                           char const * const name)
+{
+    CGUTILS_ASSERT(data != NULL);
+    CGUTILS_ASSERT(parent_ino > 0);
+    CGUTILS_ASSERT(name != NULL);
+    cgfs_data const * const shared = data->main != NULL ? data->main : data;
+
+    if (shared->invalidate_entry_cb != NULL)
+    {
+        (*(shared->invalidate_entry_cb))(shared->invalidate_cb_data,
+                                         cgfs_get_kernel_inode_number(shared, parent_ino),
+                                         name);
+    }
+}
@@ -23,8 +23,34 @@
 #ifndef CGFS_H_
 #define CGFS_H_
 
+#include <pthread.h>
+#include <stdbool.h>
 #include <stdint.h>
 
+#define CGFS_FUSE_THREADS_DEFAULT (1)
+#define CGFS_INODE_CACHE_ACTIVE_SIZE_DEFAULT (100000)
+#define CGFS_INODE_CACHE_INACTIVE_SIZE_DEFAULT (200000)
+#define CGFS_DENTRY_CACHE_SIZE_DEFAULT (100000)
+#define CGFS_DENTRY_CACHE_POSITIVE_TTL_DEFAULT (60)
+#define CGFS_DENTRY_CACHE_NEGATIVE_TTL_DEFAULT (5)
+/* per thread, in bytes */
+#define CGFS_BUFFER_POOL_SIZE_DEFAULT (16 * 1024 * 1024)
+/* Bounds of the time the kernel may cache the attributes
+   and the directory entries of an inode, in seconds.
+   The attributes are invalidated by the kernel
+   on open / truncate / fallocate / read / write anyway,
+   and the entries on unlink / rmdir / rename / .. */
+#define CGFS_ATTR_TIMEOUT_MIN_DEFAULT (1)
+#define CGFS_ATTR_TIMEOUT_MAX_DEFAULT (60)
+#define CGFS_ENTRY_TIMEOUT_MIN_DEFAULT (1)
+#define CGFS_ENTRY_TIMEOUT_MAX_DEFAULT (60)
+/* Write notifications are sent to the storage manager in batches
+   of up to that many inodes, or after that many milliseconds. */
+#define CGFS_NOTIFY_WRITE_BATCH_SIZE_DEFAULT (64)
+#define CGFS_NOTIFY_WRITE_BATCH_DELAY_DEFAULT (500)
+/* Number of read-only open leases kept by each thread, 0 disables them. */
+#define CGFS_OPEN_LEASE_CACHE_SIZE_DEFAULT (128)
+
 #define CGFS_SET_ATTR_MODE      (1 << 0)
 #define CGFS_SET_ATTR_UID       (1 << 1)
 #define CGFS_SET_ATTR_GID       (1 << 2)
@@ -36,11 +62,38 @@
 
 typedef struct cgfs_data cgfs_data;
 
+/* Called when a response from the storage manager shows that
+   something cached by the kernel has been changed from outside
+   of this mount. Changes are not pushed to us, so this is only
+   noticed when the inode or its directory is queried again.
+   May be called from any FUSE thread. */
+typedef void (cgfs_invalidate_inode_cb)(void * cb_data,
+                                        uint64_t ino);
+typedef void (cgfs_invalidate_entry_cb)(void * cb_data,
+                                        uint64_t parent_ino,
+                                        char const * name);
+
 #include <cgfs_cache.h>
+#include <cgfs_lease.h>
+#include <cgfs_pool.h>
 #include <cgsmclient/cgsmc_async.h>
 #include <cloudutils/cloudutils_aio.h>
 #include <cloudutils/cloudutils_event.h>
 
+/* Attribute timeouts handed to the kernel, by bound.
+   Shared by all threads, see cgfs_get_timeout_stats(). */
+typedef struct
+{
+    /* open for writing, or modified very recently */
+    uint64_t min_timeouts;
+    /* part of min_timeouts, given because the inode was open for writing */
+    uint64_t writing_timeouts;
+    /* in between the bounds, from the time since the last modification */
+    uint64_t adaptive_timeouts;
+    /* not modified for a long time */
+    uint64_t max_timeouts;
+} cgfs_timeout_stats;
+
 struct cgfs_data
 {
     cgfs_cache * cache;
@@ -48,9 +101,12 @@ struct cgfs_data
     cgutils_event_data * event_data;
     cgutils_event * fuse_event;
     cgutils_event * sighup_event;
+    cgutils_event * sigusr1_event;
     cgutils_event * sigint_event;
     cgutils_event * sigterm_event;
     cgutils_aio * aio;
+    /* request objects and read buffers, owned by this thread */
+    cgfs_pool * pool;
     struct fuse_session * session;
     char * cgsm_configuration_file;
     char * pid_file;
@@ -58,28 +114,102 @@ struct cgfs_data
     char * buffer;
     size_t buffer_size;
     uint64_t root_inode_number;
-    /* We use segmented LRU:
-       - cgfs_inode * active_lru_tail;
-       - cgfs_inode * active_lru_head;
-       - cgfs_inode * inactive_lru_tail;
-       - cgfs_inode * inactive_lru_head;
-
-       Inodes are first added to the inactive lru (tail) BUT ONLY AFTER their lookup count drops down to 0.
-       Inactive hits are moved to the active lru (tail).
-       If the active list becomes full, inodes from the head are moved back to the inactive list (tail).
-       If the inactive list becomes full, inodes from the head are dropped.
-    */
+    /* set by the zero_copy_read and zero_copy_write mount options */
+    int zero_copy_read;
+    int zero_copy_write;
+    size_t inode_cache_active_size;
+    size_t inode_cache_inactive_size;
+    size_t dentry_cache_size;
+    size_t dentry_cache_positive_ttl;
+    size_t dentry_cache_negative_ttl;
+    size_t buffer_pool_size;
+    size_t attr_timeout_min;
+    size_t attr_timeout_max;
+    size_t entry_timeout_min;
+    size_t entry_timeout_max;
+    /* 0 or 1 sends the write notifications right away */
+    size_t notify_write_batch_size;
+    size_t notify_write_batch_delay;
+    /* per thread, inodes whose write notification is waiting
+       for the next batch, see cgfs_async_notify_write */
+    cgfs_inode ** pending_write_notifications;
+    size_t pending_write_notifications_count;
+    cgutils_event * notify_write_event;
+    size_t open_lease_cache_size;
+    /* per thread, descriptors of the files leased by the storage manager,
+       NULL if disabled, see cgfs_async_open */
+    cgfs_lease_table * open_leases;
+    cgutils_event * open_lease_event;
+    /* updated on the main data only */
+    cgfs_timeout_stats timeout_stats;
+    /* set on the main data only */
+    cgfs_invalidate_inode_cb * invalidate_inode_cb;
+    cgfs_invalidate_entry_cb * invalidate_entry_cb;
+    void * invalidate_cb_data;
+    /* number of threads processing FUSE requests, including the main one */
+    size_t fuse_threads;
+
+    /* For a worker thread, the main data holding the shared inode cache
+       and root inode number. NULL for the main thread. */
+    cgfs_data * main;
+    /* Additional worker threads, each with its own /dev/fuse channel,
+       event loop, AIO context and storage manager connections. */
+    cgfs_data * workers;
+    size_t workers_count;
+    struct fuse_chan * chan;
+    /* written to by the main thread to stop a worker */
+    cgutils_event * exit_event;
+    int exit_pipe[2];
+    pthread_t thread;
+    bool thread_started;
 };
 
 int cgfs_init(void);
 void cgfs_destroy(void);
 
+/* Returns the data of the calling thread */
 cgfs_data * cgfs_get_data(void);
+void cgfs_set_thread_data(cgfs_data * data);
 
 void cgfs_data_clean(cgfs_data ** data);
 int cgfs_data_load_configuration(cgfs_data * this);
 
+int cgfs_data_init_worker(cgfs_data * main,
+                          cgfs_data * worker);
+
+bool cgfs_is_multithreaded(cgfs_data const * data);
+
+/* Returns true if the root inode number was not known yet
+   and has been set by this call. */
+bool cgfs_set_root_inode_number(cgfs_data * data,
+                                uint64_t ino);
+
 uint64_t cgfs_translate_inode_number(cgfs_data const * data,
                                      uint64_t ino);
 
+/* Either of attr_timeout and entry_timeout may be NULL,
+   as may be the inode for a negative entry. */
+void cgfs_get_inode_timeouts(cgfs_data * data,
+                             cgfs_inode * inode,
+                             double * attr_timeout,
+                             double * entry_timeout);
+
+void cgfs_set_invalidation_callbacks(cgfs_data * data,
+                                     cgfs_invalidate_inode_cb * inode_cb,
+                                     cgfs_invalidate_entry_cb * entry_cb,
+                                     void * cb_data);
+
+void cgfs_invalidate_inode(cgfs_data const * data,
+                           uint64_t ino);
+
+void cgfs_invalidate_entry(cgfs_data const * data,
+                           uint64_t parent_ino,
+                           char const * name);
+
+void cgfs_get_timeout_stats(cgfs_data const * data,
+                            cgfs_timeout_stats * stats);
+
+/* Logs the current statistics of the caches and timeouts */
+void cgfs_log_stats(cgfs_data const * data);
+
 #endif /* CGFS_H_ */
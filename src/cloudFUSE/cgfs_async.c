@@ -22,6 +22,8 @@
  */
 
 #include <errno.h>
+#include <fcntl.h>
+#include <string.h>
 #include <sys/stat.h>
 
 #include <cgfs_async.h>
@@ -41,6 +43,7 @@ typedef enum
     cgfs_async_request_type_stat,
     cgfs_async_request_type_getattr,
     cgfs_async_request_type_open,
+    cgfs_async_request_type_readdir,
     cgfs_async_request_type_create_and_open,
     cgfs_async_request_type_release,
     cgfs_async_request_type_notify_write,
@@ -71,11 +74,16 @@ typedef struct
     char * name;
     char * new_name;
 
+    /* notify_write requests sent for several inodes */
+    cgfs_inode ** inodes;
+    size_t inodes_count;
+
     union
     {
         cgfs_async_status_cb * status_cb;
         cgfs_async_stat_cb * stat_cb;
         cgfs_async_open_cb * open_cb;
+        cgfs_async_readdir_cb * readdir_cb;
         cgfs_async_create_and_open_cb * create_and_open_cb;
         cgfs_async_read_cb * read_cb;
         cgfs_async_write_cb * write_cb;
@@ -89,15 +97,25 @@ typedef struct
     size_t buffer_size;
     size_t got;
     size_t pos;
+    /* position in the directory stream of the first
+       entry of the batch being fetched */
+    size_t dir_offset;
 
     uint64_t ino;
     uint64_t new_parent_ino;
+    /* generation of the parent directory when
+       the lookup was sent */
+    uint64_t dir_generation;
     uid_t uid;
     gid_t gid;
     mode_t mode;
     int flags;
     int fd;
 
+    /* attributes sent by setattr, the inode ones
+       may change before the request is written */
+    struct stat attr;
+
     cgfs_async_request_type type;
 } cgfs_async_request;
 
@@ -105,6 +123,9 @@ static void cgfs_async_request_free(cgfs_async_request * this)
 {
     if (this != NULL)
     {
+        cgfs_data * const data = this->data;
+        CGUTILS_ASSERT(data != NULL);
+
         if (this->fh != NULL)
         {
             this->fh = NULL;
@@ -120,7 +141,29 @@ static void cgfs_async_request_free(cgfs_async_request * this)
             cgfs_inode_release(this->inode), this->inode = NULL;
         }
 
-        CGUTILS_FREE(this->buffer);
+        for (size_t idx = 0;
+             idx < this->inodes_count;
+             idx++)
+        {
+            cgfs_inode_release(this->inodes[idx]), this->inodes[idx] = NULL;
+        }
+
+        this->inodes_count = 0;
+        CGUTILS_FREE(this->inodes);
+
+        if (this->type == cgfs_async_request_type_read)
+        {
+            /* read buffers come from the pool */
+            cgfs_pool_release(data->pool,
+                              this->buffer,
+                              this->buffer_size);
+            this->buffer = NULL;
+        }
+        else
+        {
+            CGUTILS_FREE(this->buffer);
+        }
+
         this->const_buffer = NULL;
         this->buffer_size = 0;
 
@@ -141,7 +184,9 @@ static void cgfs_async_request_free(cgfs_async_request * this)
         this->got = 0;
         this->pos = 0;
 
-        CGUTILS_FREE(this);
+        cgfs_pool_release(data->pool,
+                          this,
+                          sizeof *this);
     }
 }
 
@@ -161,10 +206,12 @@ static int cgfs_async_request_init(cgfs_data * const data,
     CGUTILS_ASSERT(type > cgfs_async_request_type_none);
     CGUTILS_ASSERT(type < cgfs_async_request_type_count);
 
-    CGUTILS_ALLOCATE_STRUCT(request);
+    request = cgfs_pool_get(data->pool,
+                            sizeof *request);
 
     if (request != NULL)
     {
+        CGUTILS_INIT_STRUCT(request);
         request->data = data;
         request->ino = ino;
         request->cb_data = cb_data;
@@ -196,6 +243,48 @@ static int cgfs_async_request_init(cgfs_data * const data,
     return result;
 }
 
+/* Drops the cached (parent, name) entries that the request
+   is about to change, whatever its outcome. */
+static void cgfs_async_invalidate_entries(cgfs_async_request const * const request)
+{
+    CGUTILS_ASSERT(request != NULL);
+    CGUTILS_ASSERT(request->data != NULL);
+
+    cgfs_cache * const cache = request->data->cache;
+
+    switch(request->type)
+    {
+    case cgfs_async_request_type_rename:
+        cgfs_cache_remove_child(cache,
+                                request->ino,
+                                request->name);
+        cgfs_cache_remove_child(cache,
+                                request->new_parent_ino,
+                                request->new_name);
+        break;
+    case cgfs_async_request_type_hardlink:
+        /* ino is the existing inode here */
+        cgfs_cache_remove_child(cache,
+                                request->new_parent_ino,
+                                request->name);
+        break;
+    case cgfs_async_request_type_symlink:
+        /* name is the link target here */
+        cgfs_cache_remove_child(cache,
+                                request->ino,
+                                request->new_name);
+        break;
+    default:
+        cgfs_cache_remove_child(cache,
+                                request->ino,
+                                request->name);
+        break;
+    }
+}
+
+/* Returns 0 and the child inode if it is cached,
+   ENOENT if the child is known not to exist,
+   ENODATA if we need to ask the storage manager. */
 static int cgfs_utils_lookup_child(cgfs_data * const data,
                                    uint64_t const parent_ino,
                                    char const * const name,
@@ -206,64 +295,55 @@ static int cgfs_utils_lookup_child(cgfs_data * const data,
     CGUTILS_ASSERT(name != NULL);
     CGUTILS_ASSERT(inode_out != NULL);
 
-    int result = cgfs_cache_lookup_child(data->cache,
-                                         parent_ino,
-                                         name,
-                                         inode_out);
-
-    if (result != 0)
-    {
-        cgfs_inode * parent_inode = NULL;
-
-        result = cgfs_cache_lookup(data->cache,
+    /* Directory listings are paginated and no longer kept in full
+       by the dir FH, readdir seeds the dentry cache instead. */
+    return cgfs_cache_lookup_child(data->cache,
                                    parent_ino,
-                                   &parent_inode);
-
-        if (COMPILER_LIKELY(result == 0))
-        {
-            cgfs_file_handler const * const fh = cgfs_inode_get_dir_file_handler(parent_inode);
-
-            if (COMPILER_UNLIKELY(fh != NULL))
-            {
-                uint64_t child_ino = 0;
+                                   name,
+                                   inode_out);
+}
 
-                CGUTILS_ASSERT(cgfs_file_handler_get_type(fh) == cgfs_file_handler_type_dir);
+/* Creates an inode from st and adds it to the cache, or returns
+   the cached one if another request added it in the meantime. */
+static int cgfs_async_cache_inode(cgfs_data * const data,
+                                  struct stat const * const st,
+                                  cgfs_inode ** const out)
+{
+    CGUTILS_ASSERT(data != NULL);
+    CGUTILS_ASSERT(st != NULL);
+    CGUTILS_ASSERT(out != NULL);
 
-                result = cgfs_file_handler_dir_get_child_ino(fh,
-                                                             name,
-                                                             &child_ino);
+    int result = cgfs_inode_init(st,
+                                 out);
 
-                if (result == 0)
-                {
-                    result = cgfs_cache_lookup(data->cache,
-                                               child_ino,
-                                               inode_out);
+    if (COMPILER_LIKELY(result == 0))
+    {
+        result = cgfs_cache_add(data->cache,
+                                out);
 
-                    if (COMPILER_UNLIKELY(result != 0))
-                    {
-                        result = ENOENT;
-                    }
-                }
-                else
-                {
-                    result = ENOENT;
-                }
-            }
-            else
+        if (result == EEXIST)
+        {
+            if (cgfs_inode_refresh_attributes(*out,
+                                              st) == true)
             {
-                result = ENOENT;
+                cgfs_invalidate_inode(data,
+                                      st->st_ino);
             }
 
-            cgfs_inode_release(parent_inode), parent_inode = NULL;
+            result = 0;
         }
-        else
+        else if (COMPILER_UNLIKELY(result != 0))
         {
-            result = ENOENT;
+            CGUTILS_WARN("Error adding inode %"PRIu64" to cache: %d",
+                         st->st_ino,
+                         result);
+            result = 0;
         }
     }
     else
     {
-        result = ENOENT;
+        CGUTILS_ERROR("Error getting inode from stat: %d",
+                      result);
     }
 
     return result;
@@ -286,19 +366,26 @@ static void cgfs_async_stat_callback(int const status,
 
         if (COMPILER_UNLIKELY(request->type == cgfs_async_request_type_getattr &&
                               request->ino == 1 &&
-                              request->data->root_inode_number == 0 &&
                               st->st_ino >= 1))
         {
-            request->data->root_inode_number = st->st_ino;
-            first_root_lookup = true;
+            first_root_lookup = cgfs_set_root_inode_number(request->data,
+                                                           st->st_ino);
         }
 
         result = cgfs_cache_lookup(request->data->cache,
                                    st->st_ino,
                                    &(request->inode));
 
-        if (COMPILER_UNLIKELY(result != 0 &&
-                              result != ENOENT))
+        if (result == 0)
+        {
+            if (cgfs_inode_refresh_attributes(request->inode,
+                                              st) == true)
+            {
+                cgfs_invalidate_inode(request->data,
+                                      st->st_ino);
+            }
+        }
+        else if (COMPILER_UNLIKELY(result != ENOENT))
         {
             CGUTILS_WARN("Error looking up inode %"PRIu64" in cache: %d",
                          st->st_ino,
@@ -308,37 +395,19 @@ static void cgfs_async_stat_callback(int const status,
 
         if (result == ENOENT)
         {
-            result = cgfs_inode_init(st,
-                                     &(request->inode));
-
-            if (COMPILER_LIKELY(result == 0))
-            {
-                /* this is kind of ugly, but FUSE does not issue
-                   a lookup for the root inode (1). However, it does
-                   issue a forget, so we need to keep the lookup counter
-                   up-to-date.
-                */
-                if (COMPILER_UNLIKELY(first_root_lookup == true))
-                {
-                    cgfs_inode_inc_lookup_count(request->inode);
-                }
-
-                result = cgfs_cache_add(request->data->cache,
-                                        request->inode);
-
-                if (COMPILER_UNLIKELY(result != 0))
-                {
-                    CGUTILS_WARN("Error adding inode %"PRIu64" to cache: %d",
-                                 cgfs_inode_get_number(request->inode),
-                                 result);
-                }
-
-                result = 0;
-            }
-            else
+            result = cgfs_async_cache_inode(request->data,
+                                            st,
+                                            &(request->inode));
+
+            /* this is kind of ugly, but FUSE does not issue
+               a lookup for the root inode (1). However, it does
+               issue a forget, so we need to keep the lookup counter
+               up-to-date.
+            */
+            if (COMPILER_UNLIKELY(result == 0 &&
+                                  first_root_lookup == true))
             {
-                CGUTILS_ERROR("Error getting inode from stat: %d",
-                              result);
+                cgfs_inode_inc_lookup_count(request->inode);
             }
         }
 
@@ -348,11 +417,32 @@ static void cgfs_async_stat_callback(int const status,
                            request->type == cgfs_async_request_type_getattr);
             CGUTILS_ASSERT(request->stat_cb != NULL);
 
+            if (request->type == cgfs_async_request_type_stat)
+            {
+                cgfs_cache_add_lookup_child(request->data->cache,
+                                            request->ino,
+                                            request->name,
+                                            cgfs_inode_get_number(request->inode),
+                                            request->dir_generation);
+            }
+
             (*(request->stat_cb))(request->cb_data,
                                   request->inode);
         }
     }
 
+    else if (status == ENOENT &&
+             request->type == cgfs_async_request_type_stat)
+    {
+        /* a create, mkdir, link or rename completing while the
+           lookup was in flight makes this reply stale */
+        cgfs_cache_add_lookup_child(request->data->cache,
+                                    request->ino,
+                                    request->name,
+                                    0,
+                                    request->dir_generation);
+    }
+
     if (COMPILER_UNLIKELY(result != 0))
     {
         CGUTILS_ASSERT(request->error_cb != NULL);
@@ -395,6 +485,11 @@ void cgfs_async_lookup(cgfs_data * const data,
         (*cb)(cb_data,
               inode);
     }
+    else if (result == ENOENT)
+    {
+        (*error_cb)(result,
+                    cb_data);
+    }
     else
     {
         cgfs_async_request * request = NULL;
@@ -410,6 +505,8 @@ void cgfs_async_lookup(cgfs_data * const data,
         if (result == 0)
         {
             request->stat_cb = cb;
+            request->dir_generation = cgfs_cache_get_dir_generation(data->cache,
+                                                                    request->ino);
 
             result = cgsmc_async_lookup_child(data->cgsmc_data,
                                               request->ino,
@@ -527,21 +624,63 @@ size_t cgfs_async_get_remaining_dir_entries_count(cgfs_data * const data,
     CGUTILS_ASSERT(ino > 0);
     CGUTILS_ASSERT(file_handler != NULL);
     CGUTILS_ASSERT(cgfs_file_handler_get_type(file_handler) == cgfs_file_handler_type_dir);
+    size_t const first_offset = cgfs_file_handler_dir_get_first_offset(file_handler);
+    size_t const entries_count = cgfs_file_handler_dir_get_entries_count(file_handler);
+    size_t result = 0;
+
+    (void) ino;
+    (void) data;
+
+    /* only the entries of the current batch are available */
+    if (pos >= first_offset &&
+        pos < first_offset + entries_count)
+    {
+        result = first_offset + entries_count - pos;
+    }
+
+    return result;
+}
+
+size_t cgfs_async_get_remaining_dir_entries_name_len(cgfs_data * const data,
+                                                     uint64_t const ino,
+                                                     cgfs_file_handler * const file_handler,
+                                                     size_t const pos,
+                                                     size_t const max_size)
+{
+    CGUTILS_ASSERT(data != NULL);
+    CGUTILS_ASSERT(ino > 0);
+    CGUTILS_ASSERT(file_handler != NULL);
+    CGUTILS_ASSERT(cgfs_file_handler_get_type(file_handler) == cgfs_file_handler_type_dir);
+    size_t const first_offset = cgfs_file_handler_dir_get_first_offset(file_handler);
     size_t const entries_count = cgfs_file_handler_dir_get_entries_count(file_handler);
-    CGUTILS_ASSERT(pos <= entries_count);
+    size_t result = 0;
+    cgsmc_async_entry const * const entries = cgfs_file_handler_dir_get_entries(file_handler);
+    CGUTILS_ASSERT(entries != NULL ||
+                   entries_count == 0);
 
     (void) ino;
     (void) data;
 
-    return entries_count - pos;
+    /* no need to compute more entries
+       once we have reached max_size */
+
+    for (size_t idx = pos >= first_offset ? pos - first_offset : entries_count;
+         idx < entries_count &&
+             result < max_size;
+         idx++)
+    {
+        result += entries[idx].name_len;
+    }
+
+    return result;
 }
 
 int cgfs_async_get_dir_entry(cgfs_data * const data,
                              uint64_t const ino,
                              cgfs_file_handler * const file_handler,
-                             size_t const idx,
+                             size_t const pos,
                              char const ** const name_out,
-                             struct stat const ** const st_out)
+                             struct stat * const st_out)
 {
     int result = 0;
     CGUTILS_ASSERT(data != NULL);
@@ -550,20 +689,23 @@ int cgfs_async_get_dir_entry(cgfs_data * const data,
     CGUTILS_ASSERT(cgfs_file_handler_get_type(file_handler) == cgfs_file_handler_type_dir);
     CGUTILS_ASSERT(name_out != NULL);
     CGUTILS_ASSERT(st_out != NULL);
+    size_t const first_offset = cgfs_file_handler_dir_get_first_offset(file_handler);
     size_t const entries_count = cgfs_file_handler_dir_get_entries_count(file_handler);
     cgsmc_async_entry const * const entries = cgfs_file_handler_dir_get_entries(file_handler);
 
     (void) ino;
     (void) data;
 
-    if (COMPILER_LIKELY(idx < entries_count))
+    if (COMPILER_LIKELY(pos >= first_offset &&
+                        pos < first_offset + entries_count))
     {
-        cgsmc_async_entry const * const entry = &(entries[idx]);
+        cgsmc_async_entry const * const entry = &(entries[pos - first_offset]);
         CGUTILS_ASSERT(entry->data != NULL);
         cgfs_inode * inode = entry->data;
 
         *name_out = entry->name;
-        *st_out = &(inode->attr);
+        cgfs_inode_get_attributes(inode,
+                                  st_out);
     }
     else
     {
@@ -588,145 +730,173 @@ void cgfs_async_releasedir(cgfs_data * const data,
     cgfs_file_handler_free(file_handler), file_handler = NULL;
 }
 
-size_t cgfs_async_get_remaining_dir_entries_name_len(cgfs_data * const data,
-                                                     uint64_t const ino,
-                                                     cgfs_file_handler * const file_handler,
-                                                     size_t const pos,
-                                                     size_t const max_size)
-{
-    CGUTILS_ASSERT(data != NULL);
-    CGUTILS_ASSERT(ino > 0);
-    CGUTILS_ASSERT(file_handler != NULL);
-    CGUTILS_ASSERT(cgfs_file_handler_get_type(file_handler) == cgfs_file_handler_type_dir);
-    size_t const entries_count = cgfs_file_handler_dir_get_entries_count(file_handler);
-    CGUTILS_ASSERT(pos <= entries_count);
-    size_t result = 0;
-    cgsmc_async_entry const * const entries = cgfs_file_handler_dir_get_entries(file_handler);
-    CGUTILS_ASSERT(entries != NULL ||
-                   entries_count == 0);
-
-
-    (void) ino;
-    (void) data;
-
-    /* no need to compute more entries
-       once we have reached max_size */
-
-    for (size_t idx = pos;
-         idx < entries_count &&
-             result < max_size;
-         idx++)
-    {
-        result += entries[idx].name_len;
-    }
-
-    return result;
-}
+static int cgfs_async_readdir_fetch(cgfs_async_request * request,
+                                    uint64_t cursor);
 
-static void cgfs_async_readdir_callback(int const status,
-                                        cgsmc_async_entry * entries,
-                                        size_t entries_count,
-                                        bool const use_dir_index,
-                                        void * const cb_data)
+static void cgfs_async_readdir_page_callback(int const status,
+                                             cgsmc_async_entry * entries,
+                                             size_t const entries_count,
+                                             uint64_t const next_cursor,
+                                             void * const cb_data)
 {
     int result = status;
     cgfs_async_request * request = cb_data;
 
     CGUTILS_ASSERT(request != NULL);
+    CGUTILS_ASSERT(request->fh != NULL);
 
     if (COMPILER_LIKELY(status == 0))
     {
         CGUTILS_ASSERT(entries_count == 0 ||
                        entries != NULL);
 
-        cgfs_file_handler * fh = NULL;
+        cgfs_cache * const cache = request->data->cache;
+        bool const stale = cgfs_cache_get_dir_generation(cache,
+                                                         request->ino) != request->dir_generation;
 
-        result = cgfs_file_handler_create_dir(entries,
-                                              entries_count,
-                                              use_dir_index,
-                                              request->inode,
-                                              &fh);
-
-        if (COMPILER_LIKELY(result == 0))
+        for (size_t idx = 0;
+             idx < entries_count &&
+                 result == 0;
+             idx++)
         {
-            for (size_t idx = 0;
-                 idx < entries_count &&
-                     result == 0;
-                 idx++)
-            {
-                cgsmc_async_entry * entry = &(entries[idx]);
-                /* add each entry to the cache */
-                cgfs_inode * inode = NULL;
+            cgsmc_async_entry * entry = &(entries[idx]);
+            /* add each entry to the cache */
+            cgfs_inode * inode = NULL;
 
-                result = cgfs_cache_lookup(request->data->cache,
-                                           entry->st.st_ino,
-                                           &inode);
+            result = cgfs_cache_lookup(cache,
+                                       entry->st.st_ino,
+                                       &inode);
+
+            if (result == 0)
+            {
+                if (cgfs_inode_refresh_attributes(inode,
+                                                  &(entry->st)) == true)
+                {
+                    cgfs_invalidate_inode(request->data,
+                                          entry->st.st_ino);
+                }
+            }
+            else
+            {
+                result = cgfs_async_cache_inode(request->data,
+                                                &(entry->st),
+                                                &inode);
+            }
 
-                if (result != 0)
+            if (COMPILER_LIKELY(result == 0))
+            {
+                if (stale == false &&
+                    strcmp(entry->name, ".") != 0 &&
+                    strcmp(entry->name, "..") != 0)
                 {
-                    result = cgfs_inode_init(&(entry->st),
-                                             &inode);
+                    cgfs_inode * previous = NULL;
 
-                    if (COMPILER_LIKELY(result == 0))
+                    /* the name now points to another inode */
+                    if (cgfs_cache_lookup_child(cache,
+                                                request->ino,
+                                                entry->name,
+                                                &previous) == 0)
                     {
-                        result = cgfs_cache_add(request->data->cache,
-                                                inode);
-
-                        if (COMPILER_UNLIKELY(result != 0))
+                        if (cgfs_inode_get_number(previous) != cgfs_inode_get_number(inode))
                         {
-                            CGUTILS_ERROR("Error adding inode to cache: %d",
-                                         result);
+                            cgfs_invalidate_entry(request->data,
+                                                  request->ino,
+                                                  entry->name);
                         }
+
+                        cgfs_inode_release(previous), previous = NULL;
                     }
-                    else
-                    {
-                        CGUTILS_ERROR("Error getting inode from stat: %d",
-                                      result);
-                    }
-                }
 
-                if (COMPILER_LIKELY(result == 0))
-                {
-                    entry->data = inode, inode = NULL;
-                }
-                else
-                {
-                    cgfs_inode_release(inode), inode = NULL;
+                    /* the directory may still change after the check above */
+                    cgfs_cache_add_lookup_child(cache,
+                                                request->ino,
+                                                entry->name,
+                                                cgfs_inode_get_number(inode),
+                                                request->dir_generation);
                 }
+
+                entry->data = inode, inode = NULL;
+            }
+            else
+            {
+                cgfs_inode_release(inode), inode = NULL;
             }
+        }
 
-            if (COMPILER_LIKELY(result == 0))
+        if (COMPILER_LIKELY(result == 0))
+        {
+            size_t const first_offset = request->dir_offset;
+
+            cgfs_file_handler_dir_set_entries(request->fh,
+                                              entries,
+                                              entries_count,
+                                              first_offset,
+                                              next_cursor);
+            entries = NULL;
+
+            if (request->pos >= first_offset + entries_count &&
+                next_cursor != 0)
             {
-                CGUTILS_ASSERT(request->type == cgfs_async_request_type_open);
-                CGUTILS_ASSERT(request->open_cb != NULL);
+                /* the wanted position is further, keep going */
+                request->dir_offset = first_offset + entries_count;
 
-                if (request->inode != NULL &&
-                    request->inode->dir_fh == NULL)
+                result = cgfs_async_readdir_fetch(request,
+                                                  next_cursor);
+
+                if (COMPILER_LIKELY(result == 0))
                 {
-                    request->inode->dir_fh = fh;
+                    request = NULL;
                 }
+            }
+            else if (request->type == cgfs_async_request_type_open)
+            {
+                CGUTILS_ASSERT(request->open_cb != NULL);
 
                 (*(request->open_cb))(request->cb_data,
-                                      fh);
-                fh = NULL;
+                                      request->fh);
+                request->fh = NULL;
             }
             else
             {
-                cgfs_file_handler_free(fh), fh = NULL;
+                CGUTILS_ASSERT(request->type == cgfs_async_request_type_readdir);
+                CGUTILS_ASSERT(request->readdir_cb != NULL);
+
+                (*(request->readdir_cb))(request->cb_data,
+                                         request->fh,
+                                         request->ino,
+                                         request->pos,
+                                         request->buffer_size);
             }
         }
         else
         {
-            CGUTILS_ERROR("Error creating file handler: %d",
-                          result);
-            CGUTILS_FREE(entries), entries = NULL;
+            for (size_t idx = 0;
+                 idx < entries_count;
+                 idx++)
+            {
+                if (entries[idx].data != NULL)
+                {
+                    cgfs_inode_release(entries[idx].data), entries[idx].data = NULL;
+                }
+
+                cgsmc_async_entry_clean(&(entries[idx]));
+            }
+
+            CGUTILS_FREE(entries);
         }
     }
 
     if (COMPILER_UNLIKELY(result != 0))
     {
+        CGUTILS_ASSERT(request != NULL);
         CGUTILS_ASSERT(request->error_cb != NULL);
 
+        if (request->type == cgfs_async_request_type_open)
+        {
+            /* the handler has not been handed out yet */
+            cgfs_file_handler_free(request->fh), request->fh = NULL;
+        }
+
         (*(request->error_cb))(result,
                                request->cb_data);
     }
@@ -734,6 +904,32 @@ static void cgfs_async_readdir_callback(int const status,
     cgfs_async_request_free(request), request = NULL;
 }
 
+static int cgfs_async_readdir_fetch(cgfs_async_request * const request,
+                                    uint64_t const cursor)
+{
+    CGUTILS_ASSERT(request != NULL);
+
+    /* a page predating an unlink or a rename must not seed the dentry cache */
+    request->dir_generation = cgfs_cache_get_dir_generation(request->data->cache,
+                                                            request->ino);
+
+    int result = cgsmc_async_readdir_page(request->data->cgsmc_data,
+                                          request->ino,
+                                          cursor,
+                                          &cgfs_async_readdir_page_callback,
+                                          request);
+
+    if (COMPILER_UNLIKELY(result != 0))
+    {
+        CGUTILS_ERROR("Error reading entries of directory/inode %"PRIu64" from %"PRIu64": %d",
+                      request->ino,
+                      cursor,
+                      result);
+    }
+
+    return result;
+}
+
 void cgfs_async_opendir(cgfs_data * const data,
                         uint64_t ino,
                         cgfs_async_open_cb * const cb,
@@ -788,27 +984,37 @@ void cgfs_async_opendir(cgfs_data * const data,
         if (result == 0)
         {
             request->open_cb = cb;
-            request->inode = dir_inode;
-            dir_inode = NULL;
 
-            result = cgsmc_async_readdir(data->cgsmc_data,
-                                         request->ino,
-                                         &cgfs_async_readdir_callback,
-                                         request);
+            result = cgfs_file_handler_create_dir(dir_inode,
+                                                  &(request->fh));
 
-            if (COMPILER_UNLIKELY(result != 0))
+            if (COMPILER_LIKELY(result == 0))
             {
-                CGUTILS_ERROR("Error reading entries of directory/inode %"PRIu64": %d",
-                              request->ino,
-                              result);
+                /* Only the first batch is fetched for now,
+                   the next ones are fetched by readdir when needed. */
+                result = cgfs_async_readdir_fetch(request,
+                                                  0);
 
-                cgfs_async_request_free(request), request = NULL;
-            }
-        }
+                if (COMPILER_UNLIKELY(result != 0))
+                {
+                    cgfs_file_handler_free(request->fh), request->fh = NULL;
+                }
+            }
+            else
+            {
+                CGUTILS_ERROR("Error creating file handler: %d",
+                              result);
+            }
+
+            if (COMPILER_UNLIKELY(result != 0))
+            {
+                cgfs_async_request_free(request), request = NULL;
+            }
+        }
         else
         {
-        CGUTILS_ERROR("Error allocating request: %d",
-                      result);
+            CGUTILS_ERROR("Error allocating request: %d",
+                          result);
         }
     }
 
@@ -821,6 +1027,94 @@ void cgfs_async_opendir(cgfs_data * const data,
     }
 }
 
+void cgfs_async_readdir(cgfs_data * const data,
+                        uint64_t ino,
+                        cgfs_file_handler * const file_handler,
+                        size_t const off,
+                        size_t const size,
+                        cgfs_async_readdir_cb * const cb,
+                        cgfs_async_error_cb * const error_cb,
+                        void * const cb_data)
+{
+    int result = 0;
+    CGUTILS_ASSERT(data != NULL);
+    CGUTILS_ASSERT(ino > 0);
+    CGUTILS_ASSERT(file_handler != NULL);
+    CGUTILS_ASSERT(cgfs_file_handler_get_type(file_handler) == cgfs_file_handler_type_dir);
+    CGUTILS_ASSERT(cb != NULL);
+    CGUTILS_ASSERT(error_cb != NULL);
+    size_t const first_offset = cgfs_file_handler_dir_get_first_offset(file_handler);
+    size_t const end_offset = first_offset + cgfs_file_handler_dir_get_entries_count(file_handler);
+    uint64_t const next_cursor = cgfs_file_handler_dir_get_next_cursor(file_handler);
+
+    ino = cgfs_translate_inode_number(data,
+                                      ino);
+
+    if (off >= first_offset &&
+        (off < end_offset || next_cursor == 0))
+    {
+        /* in the current batch, or past the end of the directory */
+        (*cb)(cb_data,
+              file_handler,
+              ino,
+              off,
+              size);
+    }
+    else
+    {
+        cgfs_async_request * request = NULL;
+
+        result = cgfs_async_request_init(data,
+                                         ino,
+                                         NULL,
+                                         cgfs_async_request_type_readdir,
+                                         cb_data,
+                                         error_cb,
+                                         &request);
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            request->readdir_cb = cb;
+            request->fh = file_handler;
+            request->pos = off;
+            request->buffer_size = size;
+
+            if (off >= end_offset)
+            {
+                request->dir_offset = end_offset;
+
+                result = cgfs_async_readdir_fetch(request,
+                                                  next_cursor);
+            }
+            else
+            {
+                /* going backward (rewinddir, seekdir),
+                   start over from the beginning */
+                request->dir_offset = 0;
+
+                result = cgfs_async_readdir_fetch(request,
+                                                  0);
+            }
+
+            if (COMPILER_UNLIKELY(result != 0))
+            {
+                cgfs_async_request_free(request), request = NULL;
+            }
+        }
+        else
+        {
+            CGUTILS_ERROR("Error allocating request: %d",
+                          result);
+        }
+    }
+
+    if (COMPILER_UNLIKELY(result != 0))
+    {
+        (*error_cb)(result,
+                    cb_data);
+    }
+}
+
 static void cgfs_async_release_callback(int const status,
                                         void * cb_data)
 {
@@ -884,6 +1178,7 @@ static void cgfs_async_notify_of_failed_open_if_needed(cgfs_async_request const
 static void cgfs_async_create_and_open_callback(int const status,
                                                 struct stat * st,
                                                 char * file_path,
+                                                int const fd,
                                                 void * const cb_data)
 {
     int result = status;
@@ -891,6 +1186,8 @@ static void cgfs_async_create_and_open_callback(int const status,
 
     CGUTILS_ASSERT(request != NULL);
 
+    cgfs_async_invalidate_entries(request);
+
     if (COMPILER_LIKELY(status == 0))
     {
         if (request->parent_inode != NULL)
@@ -899,26 +1196,19 @@ static void cgfs_async_create_and_open_callback(int const status,
         }
 
         CGUTILS_ASSERT(st != NULL);
-        CGUTILS_ASSERT(file_path != NULL);
+        CGUTILS_ASSERT(file_path != NULL || fd != -1);
 
-        result = cgfs_inode_init(st,
-                                 &(request->inode));
+        result = cgfs_async_cache_inode(request->data,
+                                        st,
+                                        &(request->inode));
 
         if (COMPILER_LIKELY(result == 0))
         {
             cgfs_file_handler * file_handler = NULL;
 
-            result = cgfs_cache_add(request->data->cache,
-                                    request->inode);
-
-            if (COMPILER_UNLIKELY(result != 0))
-            {
-                CGUTILS_WARN("Error adding inode to cache: %d",
-                             result);
-            }
-
             result = cgfs_utils_open_file(request->inode,
                                           file_path,
+                                          fd,
                                           &(request->flags),
                                           &file_handler);
 
@@ -937,6 +1227,11 @@ static void cgfs_async_create_and_open_callback(int const status,
             CGUTILS_ERROR("Error getting inode from stat: %d",
                           result);
             CGUTILS_FREE(st);
+
+            if (fd != -1)
+            {
+                cgutils_file_close(fd);
+            }
         }
 
         if (COMPILER_UNLIKELY(result != 0))
@@ -1091,6 +1386,10 @@ void cgfs_async_file_handler_release(cgfs_data * const data,
     {
         cgfs_async_request * request = NULL;
 
+        /* the release marks the inode dirty by itself, a queued
+           write notification sent after it would do it again */
+        cgfs_inode_unqueue_dirty_notification(cgfs_file_handler_get_inode(file_handler));
+
         int result = cgfs_async_request_init(data,
                                              ino,
                                              NULL,
@@ -1153,8 +1452,8 @@ static void cgfs_async_notify_write_callback(int const status,
     cgfs_async_request_free(request), request = NULL;
 }
 
-static void cgfs_async_notify_write(cgfs_data * const data,
-                                    cgfs_inode * const inode)
+static void cgfs_async_notify_write_send(cgfs_data * const data,
+                                         cgfs_inode * const inode)
 {
     CGUTILS_ASSERT(data != NULL);
     CGUTILS_ASSERT(inode != NULL);
@@ -1193,98 +1492,475 @@ static void cgfs_async_notify_write(cgfs_data * const data,
         CGUTILS_ERROR("Error allocating request: %d",
                       result);
     }
-}
+}
+
+static void cgfs_async_notify_write_multi_callback(int const status,
+                                                   void * cb_data)
+{
+    cgfs_async_request * request = cb_data;
+
+    CGUTILS_ASSERT(request != NULL);
+    CGUTILS_ASSERT(request->inodes != NULL);
+
+    if (COMPILER_LIKELY(status == 0))
+    {
+        for (size_t idx = 0;
+             idx < request->inodes_count;
+             idx++)
+        {
+            cgfs_inode_update_dirty_notification(request->inodes[idx]);
+        }
+    }
+    else
+    {
+        CGUTILS_ERROR("Error while notifying write to %zu inodes: %d",
+                      request->inodes_count,
+                      status);
+    }
+
+    cgfs_async_request_free(request), request = NULL;
+}
+
+/* Sends the write notifications queued by this thread, skipping
+   the ones cancelled in the meantime by a release or a fsync. */
+static void cgfs_async_notify_write_flush(cgfs_data * const data)
+{
+    CGUTILS_ASSERT(data != NULL);
+    size_t const pending_count = data->pending_write_notifications_count;
+    cgfs_inode ** const pending = data->pending_write_notifications;
+    CGUTILS_ASSERT(pending_count <= CGSMC_ASYNC_NOTIFY_WRITE_BATCH_SIZE_MAX);
+
+    data->pending_write_notifications_count = 0;
+
+    if (cgutils_event_is_enabled(data->notify_write_event) == true)
+    {
+        cgutils_event_disable(data->notify_write_event);
+    }
+
+    if (pending_count > 0)
+    {
+        cgfs_async_request * request = NULL;
+        uint64_t inodes[CGSMC_ASYNC_NOTIFY_WRITE_BATCH_SIZE_MAX];
+
+        int result = cgfs_async_request_init(data,
+                                             0,
+                                             NULL,
+                                             cgfs_async_request_type_notify_write,
+                                             NULL,
+                                             NULL,
+                                             &request);
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            CGUTILS_MALLOC(request->inodes, pending_count, sizeof *(request->inodes));
+
+            if (COMPILER_UNLIKELY(request->inodes == NULL))
+            {
+                result = ENOMEM;
+            }
+        }
+
+        for (size_t idx = 0;
+             idx < pending_count;
+             idx++)
+        {
+            cgfs_inode * inode = pending[idx];
+            pending[idx] = NULL;
+
+            if (cgfs_inode_unqueue_dirty_notification(inode) == true &&
+                result == 0)
+            {
+                /* the request holds our reference now */
+                inodes[request->inodes_count] = cgfs_inode_get_number(inode);
+                request->inodes[request->inodes_count] = inode;
+                request->inodes_count++;
+            }
+            else
+            {
+                /* cancelled, or we can't send it, it will be
+                   queued again on the next write */
+                cgfs_inode_release(inode), inode = NULL;
+            }
+        }
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            if (request->inodes_count > 0)
+            {
+                request->ino = inodes[0];
+
+                result = cgsmc_async_notify_write_multi(data->cgsmc_data,
+                                                        inodes,
+                                                        request->inodes_count,
+                                                        &cgfs_async_notify_write_multi_callback,
+                                                        request);
+
+                if (COMPILER_UNLIKELY(result != 0))
+                {
+                    CGUTILS_ERROR("Error notifying write to %zu inodes: %d",
+                                  request->inodes_count,
+                                  result);
+                }
+            }
+            else
+            {
+                /* all of them have been cancelled */
+                result = ENOENT;
+            }
+        }
+        else
+        {
+            CGUTILS_ERROR("Error allocating request: %d",
+                          result);
+        }
+
+        if (result != 0)
+        {
+            cgfs_async_request_free(request), request = NULL;
+        }
+    }
+}
+
+static void cgfs_async_notify_write_timer_cb(void * const cb_data)
+{
+    CGUTILS_ASSERT(cb_data != NULL);
+    cgfs_data * data = cb_data;
+
+    cgfs_async_notify_write_flush(data);
+}
+
+int cgfs_async_notify_write_batch_init(cgfs_data * const data)
+{
+    int result = 0;
+    CGUTILS_ASSERT(data != NULL);
+    CGUTILS_ASSERT(data->event_data != NULL);
+
+    if (data->notify_write_batch_size > 1)
+    {
+        CGUTILS_MALLOC(data->pending_write_notifications, data->notify_write_batch_size, sizeof *(data->pending_write_notifications));
+
+        if (COMPILER_LIKELY(data->pending_write_notifications != NULL))
+        {
+            result = cgutils_event_create_timer_event(data->event_data,
+                                                      0,
+                                                      &cgfs_async_notify_write_timer_cb,
+                                                      data,
+                                                      &(data->notify_write_event));
+
+            if (COMPILER_UNLIKELY(result != 0))
+            {
+                CGUTILS_ERROR("Error creating write notification timer event: %d",
+                              result);
+            }
+        }
+        else
+        {
+            result = ENOMEM;
+            CGUTILS_ERROR("Error allocating pending write notifications: %d",
+                          result);
+        }
+    }
+
+    return result;
+}
+
+void cgfs_async_notify_write_batch_clean(cgfs_data * const data)
+{
+    CGUTILS_ASSERT(data != NULL);
+
+    if (data->notify_write_event != NULL)
+    {
+        cgutils_event_free(data->notify_write_event), data->notify_write_event = NULL;
+    }
+
+    for (size_t idx = 0;
+         idx < data->pending_write_notifications_count;
+         idx++)
+    {
+        cgfs_inode * inode = data->pending_write_notifications[idx];
+        cgfs_inode_unqueue_dirty_notification(inode);
+        cgfs_inode_release(inode), data->pending_write_notifications[idx] = NULL;
+    }
+
+    data->pending_write_notifications_count = 0;
+    CGUTILS_FREE(data->pending_write_notifications);
+}
+
+/* Coalesces the write notifications of this thread: each one is sent
+   along with the next ones after notify_write_batch_delay ms, or as soon
+   as notify_write_batch_size of them are waiting. */
+static void cgfs_async_notify_write(cgfs_data * const data,
+                                    cgfs_inode * const inode)
+{
+    CGUTILS_ASSERT(data != NULL);
+    CGUTILS_ASSERT(inode != NULL);
+
+    if (data->notify_write_batch_size > 1)
+    {
+        /* already waiting, maybe on another thread */
+        if (cgfs_inode_queue_dirty_notification(inode) == true)
+        {
+            CGUTILS_ASSERT(data->pending_write_notifications_count < data->notify_write_batch_size);
+
+            cgfs_inode_inc_ref_count(inode);
+            data->pending_write_notifications[data->pending_write_notifications_count] = inode;
+            data->pending_write_notifications_count++;
+
+            if (data->pending_write_notifications_count >= data->notify_write_batch_size)
+            {
+                cgfs_async_notify_write_flush(data);
+            }
+            else if (cgutils_event_is_enabled(data->notify_write_event) == false)
+            {
+                struct timeval const delay =
+                    {
+                        .tv_sec = (time_t) (data->notify_write_batch_delay / 1000),
+                        .tv_usec = (suseconds_t) ((data->notify_write_batch_delay % 1000) * 1000)
+                    };
+
+                int result = cgutils_event_enable(data->notify_write_event,
+                                                  &delay);
+
+                if (COMPILER_UNLIKELY(result != 0))
+                {
+                    CGUTILS_ERROR("Error enabling write notification timer event: %d",
+                                  result);
+                    /* we would never be woken up, do not wait */
+                    cgfs_async_notify_write_flush(data);
+                }
+            }
+        }
+    }
+    else
+    {
+        cgfs_async_notify_write_send(data,
+                                     inode);
+    }
+}
+
+
+int cgfs_async_get_fd_for_writing(cgfs_data * const data,
+                                  cgfs_file_handler * const file_handler,
+                                  uint64_t const ino,
+                                  int * const fd_out)
+{
+    CGUTILS_ASSERT(data != NULL);
+    CGUTILS_ASSERT(file_handler != NULL);
+    CGUTILS_ASSERT(ino > 0);
+    CGUTILS_ASSERT(fd_out != NULL);
+
+    int result = cgfs_file_handler_file_get_fd_for_writing(file_handler,
+                                                           fd_out);
+
+    if (COMPILER_LIKELY(result == 0))
+    {
+        cgfs_file_handler_file_set_dirty(file_handler);
+
+        if (COMPILER_UNLIKELY(cgfs_file_handler_file_need_to_notify_write(data,
+                                                                          file_handler) == true))
+        {
+            cgfs_async_notify_write(data,
+                                    cgfs_file_handler_get_inode(file_handler));
+        }
+
+        cgfs_file_handler_update_mtime(file_handler);
+    }
+    else
+    {
+        CGUTILS_ERROR("Error getting FD for writing to inode %"PRIu64": %d",
+                      ino,
+                      result);
+    }
+
+    return result;
+}
+
+void cgfs_async_forget_inode(cgfs_data * const data,
+                             uint64_t ino,
+                             size_t const lookup_count)
+{
+    cgfs_inode * inode = NULL;
+    CGUTILS_ASSERT(data != NULL);
+    CGUTILS_ASSERT(ino > 0);
+    CGUTILS_ASSERT(lookup_count > 0);
+
+    ino = cgfs_translate_inode_number(data,
+                                      ino);
+
+    int result = cgfs_cache_lookup(data->cache,
+                                   ino,
+                                   &inode);
+
+    if (COMPILER_LIKELY(result == 0))
+    {
+        cgfs_inode_dec_lookup_count(inode, lookup_count);
+
+        if (cgfs_inode_get_lookup_count(inode) == 0)
+        {
+            /* The inode may be expunged from the cache now. */
+            cgfs_cache_forget(data->cache,
+                              inode);
+        }
+
+        cgfs_inode_release(inode);
+        inode = NULL;
+    }
+    else if (result == ENOENT)
+    {
+        /* Wow, this is not expected! */
+        CGUTILS_WARN("Received a forget request for an inode (%"PRIu64") not present in cache!",
+                     ino);
+    }
+    else
+    {
+        CGUTILS_WARN("Error retrieving inode %"PRIu64" from cache: %d",
+                     ino,
+                     result);
+    }
+}
+
+static void cgfs_async_open_lease_timer_cb(void * const cb_data)
+{
+    CGUTILS_ASSERT(cb_data != NULL);
+    cgfs_data * data = cb_data;
+
+    uint64_t const next = cgfs_lease_table_purge(data->open_leases);
+
+    if (next > 0)
+    {
+        struct timeval const delay =
+            {
+                .tv_sec = (time_t) (next / 1000),
+                .tv_usec = (suseconds_t) ((next % 1000) * 1000)
+            };
+
+        int result = cgutils_event_enable(data->open_lease_event,
+                                          &delay);
+
+        if (COMPILER_UNLIKELY(result != 0))
+        {
+            CGUTILS_ERROR("Error enabling open lease timer event: %d",
+                          result);
+        }
+    }
+}
+
+int cgfs_async_open_lease_init(cgfs_data * const data)
+{
+    int result = 0;
+    CGUTILS_ASSERT(data != NULL);
+    CGUTILS_ASSERT(data->event_data != NULL);
+
+    if (data->open_lease_cache_size > 0)
+    {
+        CGUTILS_ASSERT(data->cgsmc_data != NULL);
+
+        cgsmc_async_set_open_leases(data->cgsmc_data,
+                                    true);
+
+        result = cgfs_lease_table_init(data->open_lease_cache_size,
+                                       &(data->open_leases));
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            result = cgutils_event_create_timer_event(data->event_data,
+                                                      0,
+                                                      &cgfs_async_open_lease_timer_cb,
+                                                      data,
+                                                      &(data->open_lease_event));
+
+            if (COMPILER_UNLIKELY(result != 0))
+            {
+                CGUTILS_ERROR("Error creating open lease timer event: %d",
+                              result);
+            }
+        }
+        else
+        {
+            CGUTILS_ERROR("Error creating open lease table: %d",
+                          result);
+        }
+    }
 
+    return result;
+}
 
-int cgfs_async_get_fd_for_writing(cgfs_data * const data,
-                                  cgfs_file_handler * const file_handler,
-                                  uint64_t const ino,
-                                  int * const fd_out)
+void cgfs_async_open_lease_clean(cgfs_data * const data)
 {
     CGUTILS_ASSERT(data != NULL);
-    CGUTILS_ASSERT(file_handler != NULL);
-    CGUTILS_ASSERT(ino > 0);
-    CGUTILS_ASSERT(fd_out != NULL);
-
-    int result = cgfs_file_handler_file_get_fd_for_writing(file_handler,
-                                                           fd_out);
 
-    if (COMPILER_LIKELY(result == 0))
+    if (data->open_lease_event != NULL)
     {
-        cgfs_file_handler_file_set_dirty(file_handler);
-
-        if (COMPILER_UNLIKELY(cgfs_file_handler_file_need_to_notify_write(data,
-                                                                          file_handler) == true))
-        {
-            cgfs_async_notify_write(data,
-                                    cgfs_file_handler_get_inode(file_handler));
-        }
-
-        cgfs_file_handler_update_mtime(file_handler);
+        cgutils_event_free(data->open_lease_event), data->open_lease_event = NULL;
     }
-    else
+
+    if (data->open_leases != NULL)
     {
-        CGUTILS_ERROR("Error getting FD for writing to inode %"PRIu64": %d",
-                      ino,
-                      result);
+        cgfs_lease_table_free(data->open_leases), data->open_leases = NULL;
     }
-
-    return result;
 }
 
-void cgfs_async_forget_inode(cgfs_data * const data,
-                             uint64_t ino,
-                             size_t const lookup_count)
+/* Only read-only opens are leased, any other one
+   has to be known by the storage manager. */
+static bool cgfs_async_open_is_leasable(cgfs_data const * const data,
+                                        int const flags)
 {
-    cgfs_inode * inode = NULL;
     CGUTILS_ASSERT(data != NULL);
-    CGUTILS_ASSERT(ino > 0);
-    CGUTILS_ASSERT(lookup_count > 0);
 
-    ino = cgfs_translate_inode_number(data,
-                                      ino);
+    return data->open_leases != NULL &&
+        cgfs_utils_writable_flags(flags) == false &&
+        (flags & O_TRUNC) == 0;
+}
 
-    int result = cgfs_cache_lookup(data->cache,
-                                   ino,
-                                   &inode);
+static void cgfs_async_open_lease_add(cgfs_data * const data,
+                                      cgfs_file_handler * const file_handler,
+                                      int const flags,
+                                      uint32_t const lease)
+{
+    CGUTILS_ASSERT(data != NULL);
+    CGUTILS_ASSERT(data->open_leases != NULL);
+    CGUTILS_ASSERT(file_handler != NULL);
+    CGUTILS_ASSERT(lease > 0);
+    int fd = -1;
+
+    int result = cgfs_file_handler_file_get_fd_for_reading(file_handler,
+                                                           &fd);
 
     if (COMPILER_LIKELY(result == 0))
     {
-        cgfs_inode_dec_lookup_count(inode, lookup_count);
+        result = cgfs_lease_table_add(data->open_leases,
+                                      cgfs_file_handler_get_inode(file_handler),
+                                      flags,
+                                      fd,
+                                      lease);
 
-        if (cgfs_inode_get_lookup_count(inode) == 0)
+        if (COMPILER_LIKELY(result == 0))
         {
-            /* The inode may be expunged from the cache now. */
-            result = cgfs_cache_remove(data->cache,
-                                       ino);
-
-            if (COMPILER_UNLIKELY(result != 0))
+            if (cgutils_event_is_enabled(data->open_lease_event) == false)
             {
-                CGUTILS_WARN("Error removing inode %"PRIu64" from cache: %d",
-                             ino,
-                             result);
+                struct timeval const delay =
+                    {
+                        .tv_sec = (time_t) (lease / 1000),
+                        .tv_usec = (suseconds_t) ((lease % 1000) * 1000)
+                    };
+
+                result = cgutils_event_enable(data->open_lease_event,
+                                              &delay);
+
+                if (COMPILER_UNLIKELY(result != 0))
+                {
+                    CGUTILS_ERROR("Error enabling open lease timer event: %d",
+                                  result);
+                }
             }
         }
-
-        cgfs_inode_release(inode);
-        inode = NULL;
-    }
-    else if (result == ENOENT)
-    {
-        /* Wow, this is not expected! */
-        CGUTILS_WARN("Received a forget request for an inode (%"PRIu64") not present in cache!",
-                     ino);
-    }
-    else
-    {
-        CGUTILS_WARN("Error retrieving inode %"PRIu64" from cache: %d",
-                     ino,
-                     result);
     }
 }
 
 static void cgfs_async_open_callback(int const status,
                                      char * file_path,
+                                     int const fd,
+                                     uint32_t const lease,
                                      void * const cb_data)
 {
     int result = status;
@@ -1295,12 +1971,13 @@ static void cgfs_async_open_callback(int const status,
     if (COMPILER_LIKELY(status == 0))
     {
         CGUTILS_ASSERT(request->inode != NULL);
-        CGUTILS_ASSERT(file_path != NULL);
+        CGUTILS_ASSERT(file_path != NULL || fd != -1);
 
         cgfs_file_handler * file_handler = NULL;
 
         result = cgfs_utils_open_file(request->inode,
                                       file_path,
+                                      fd,
                                       &(request->flags),
                                       &file_handler);
 
@@ -1311,6 +1988,15 @@ static void cgfs_async_open_callback(int const status,
             cgfs_inode_update_atime(request->inode,
                                     now);
 
+            if (lease > 0 &&
+                cgfs_async_open_is_leasable(request->data, request->flags) == true)
+            {
+                cgfs_async_open_lease_add(request->data,
+                                          file_handler,
+                                          request->flags,
+                                          lease);
+            }
+
             CGUTILS_ASSERT(request->type == cgfs_async_request_type_open);
             CGUTILS_ASSERT(request->open_cb != NULL);
 
@@ -1380,7 +2066,42 @@ void cgfs_async_open(cgfs_data * const data,
                           result);
         }
 
-        if (COMPILER_LIKELY(result == 0))
+        if (COMPILER_LIKELY(result == 0) &&
+            cgfs_async_open_is_leasable(data, flags) == true)
+        {
+            int fd = -1;
+            int open_flags = flags;
+
+            /* reopened from our own descriptor, as long as
+               the storage manager lease holds */
+            if (cgfs_lease_table_get(data->open_leases,
+                                     inode,
+                                     open_flags & ~(O_CREAT|O_EXCL),
+                                     &fd) == 0)
+            {
+                cgfs_file_handler * file_handler = NULL;
+
+                int res = cgfs_utils_open_file(inode,
+                                               NULL,
+                                               fd,
+                                               &open_flags,
+                                               &file_handler);
+
+                if (COMPILER_LIKELY(res == 0))
+                {
+                    cgfs_inode_update_atime(inode,
+                                            time(NULL));
+
+                    (*cb)(cb_data,
+                          file_handler);
+
+                    cgfs_inode_release(inode), inode = NULL;
+                }
+            }
+        }
+
+        if (COMPILER_LIKELY(result == 0) &&
+            inode != NULL)
         {
             result = cgfs_async_request_init(data,
                                              ino,
@@ -1459,7 +2180,6 @@ static int cgfs_async_read_event_cb(int const status,
                                       request->buffer,
                                       request->got);
 
-                CGUTILS_FREE(request->buffer);
                 cgfs_async_request_free(request), request = NULL;
             }
             else
@@ -1498,7 +2218,6 @@ static int cgfs_async_read_event_cb(int const status,
         (*(request->error_cb))(result,
                                request->cb_data);
 
-        CGUTILS_FREE(request->buffer);
         cgfs_async_request_free(request), request = NULL;
     }
 
@@ -1533,7 +2252,8 @@ void cgfs_async_read(cgfs_data * const data,
         char * buffer = NULL;
         CGUTILS_ASSERT(fd != -1);
 
-        CGUTILS_MALLOC(buffer, size, sizeof *buffer);
+        buffer = cgfs_pool_get(data->pool,
+                               size);
 
         if (COMPILER_LIKELY(buffer != NULL))
         {
@@ -1562,8 +2282,6 @@ void cgfs_async_read(cgfs_data * const data,
                     (*cb)(cb_data,
                           buffer,
                           got);
-
-                    CGUTILS_FREE(buffer);
                 }
                 else
                 {
@@ -1625,7 +2343,10 @@ void cgfs_async_read(cgfs_data * const data,
                               result);
             }
 
-            CGUTILS_FREE(buffer);
+            cgfs_pool_release(data->pool,
+                              buffer,
+                              size);
+            buffer = NULL;
         }
         else
         {
@@ -1718,6 +2439,93 @@ static int cgfs_async_write_event_cb(int const status,
     return result;
 }
 
+void cgfs_async_read_fd(cgfs_data * const data,
+                        cgfs_file_handler * const file_handler,
+                        uint64_t const ino,
+                        size_t const size,
+                        off_t const off,
+                        cgfs_async_read_fd_cb * const cb,
+                        cgfs_async_read_cb * const fallback_cb,
+                        cgfs_async_error_cb * const error_cb,
+                        void * const cb_data)
+{
+    int fd = -1;
+
+    CGUTILS_ASSERT(data != NULL);
+    CGUTILS_ASSERT(file_handler != NULL);
+    CGUTILS_ASSERT(ino > 0);
+    CGUTILS_ASSERT(cgfs_file_handler_get_inode_number(file_handler) == ino);
+    CGUTILS_ASSERT(size > 0);
+    CGUTILS_ASSERT(off >= 0);
+    CGUTILS_ASSERT(cb != NULL);
+    CGUTILS_ASSERT(fallback_cb != NULL);
+    CGUTILS_ASSERT(error_cb != NULL);
+
+    int result = cgfs_file_handler_file_get_fd_for_reading(file_handler,
+                                                           &fd);
+
+    if (COMPILER_LIKELY(result == 0))
+    {
+        struct stat st = (struct stat) { 0 };
+        CGUTILS_ASSERT(fd != -1);
+
+        /* The cache file is opened with O_NONBLOCK, which has no effect
+           on a regular file: reading (or splicing) from it will never
+           return EAGAIN. Anything else may, and FUSE would then reply
+           with an error instead of retrying, so we fall back to the
+           event-based read path. */
+        result = fstat(fd, &st);
+
+        if (COMPILER_LIKELY(result == 0 &&
+                            S_ISREG(st.st_mode)))
+        {
+            size_t available = 0;
+
+            /* The reply should contain exactly the number of bytes
+               requested, except on EOF. */
+            if (off < st.st_size)
+            {
+                available = (size_t) (st.st_size - off);
+
+                if (available > size)
+                {
+                    available = size;
+                }
+            }
+
+            (*cb)(cb_data,
+                  fd,
+                  off,
+                  available);
+        }
+        else
+        {
+            result = 0;
+
+            cgfs_async_read(data,
+                            file_handler,
+                            ino,
+                            size,
+                            off,
+                            fallback_cb,
+                            error_cb,
+                            cb_data);
+        }
+    }
+    else
+    {
+        CGUTILS_ERROR("Error getting FD for reading from inode %"PRIu64": %d",
+                      ino,
+                      result);
+    }
+
+    if (COMPILER_UNLIKELY(result != 0))
+    {
+        (*error_cb)(result,
+                    cb_data);
+    }
+}
+
 void cgfs_async_write(cgfs_data * const data,
                       cgfs_file_handler * const file_handler,
                       uint64_t const ino,
@@ -1751,90 +2559,80 @@ void cgfs_async_write(cgfs_data * const data,
         */
         size_t written = 0;
 
-        result = cgutils_file_lseek(fd,
-                                    SEEK_SET,
-                                    off);
-
-        if (COMPILER_LIKELY(result == 0))
+        /* pwrite() instead of lseek() + write(), since the
+           same file handler may be used by several threads. */
+        result = cgutils_file_pwrite(fd,
+                                     buffer,
+                                     buffer_size,
+                                     off,
+                                     &written);
+
+        if (COMPILER_LIKELY(result == 0 ||
+                            result == EAGAIN ||
+                            result == EWOULDBLOCK ||
+                            result == EINTR))
         {
-            result = cgutils_file_write(fd,
-                                        buffer,
-                                        buffer_size,
-                                        &written);
+            result = 0;
 
-            if (COMPILER_LIKELY(result == 0 ||
-                                result == EAGAIN ||
-                                result == EWOULDBLOCK ||
-                                result == EINTR))
+            if (written == 0 ||
+                written == buffer_size)
             {
-                result = 0;
-
-                if (written == 0 ||
-                    written == buffer_size)
-                {
-                    cgfs_file_handler_file_refresh_inode_attributes_from_fd(file_handler);
+                cgfs_file_handler_file_refresh_inode_attributes_from_fd(file_handler);
 
-                    (*cb)(cb_data,
-                          written);
-                }
-                else
-                {
-                    cgfs_async_request * request = NULL;
+                (*cb)(cb_data,
+                      written);
+            }
+            else
+            {
+                cgfs_async_request * request = NULL;
 
-                    result = cgfs_async_request_init(data,
-                                                     ino,
-                                                     NULL,
-                                                     cgfs_async_request_type_write,
-                                                     cb_data,
-                                                     error_cb,
-                                                     &request);
+                result = cgfs_async_request_init(data,
+                                                 ino,
+                                                 NULL,
+                                                 cgfs_async_request_type_write,
+                                                 cb_data,
+                                                 error_cb,
+                                                 &request);
 
-                    if (COMPILER_LIKELY(result == 0))
-                    {
-                        request->fd = fd;
-                        request->write_cb = cb;
-                        request->const_buffer = buffer;
-                        request->buffer_size = buffer_size;
-                        request->got = written;
-                        request->pos = (size_t) off + written;
-                        request->fh = file_handler;
-                        request->inode = cgfs_file_handler_get_inode(file_handler);
-                        cgfs_inode_inc_ref_count(request->inode);
-
-                        result = cgutils_aio_write(request->data->aio,
-                                                   request->fd,
-                                                   request->const_buffer + request->got,
-                                                   request->buffer_size - request->got,
-                                                   (off_t) (request->pos + request->got),
-                                                   &cgfs_async_write_event_cb,
-                                                   request);
+                if (COMPILER_LIKELY(result == 0))
+                {
+                    request->fd = fd;
+                    request->write_cb = cb;
+                    request->const_buffer = buffer;
+                    request->buffer_size = buffer_size;
+                    request->got = written;
+                    request->pos = (size_t) off + written;
+                    request->fh = file_handler;
+                    request->inode = cgfs_file_handler_get_inode(file_handler);
+                    cgfs_inode_inc_ref_count(request->inode);
+
+                    result = cgutils_aio_write(request->data->aio,
+                                               request->fd,
+                                               request->const_buffer + request->got,
+                                               request->buffer_size - request->got,
+                                               (off_t) (request->pos + request->got),
+                                               &cgfs_async_write_event_cb,
+                                               request);
 
-                        if (COMPILER_UNLIKELY(result != 0))
-                        {
-                            CGUTILS_ERROR("Error enabling AIO write to inode %"PRIu64": %d",
-                                          ino,
-                                          result);
-                            cgfs_async_request_free(request), request = NULL;
-                        }
-                    }
-                    else
+                    if (COMPILER_UNLIKELY(result != 0))
                     {
-                        CGUTILS_ERROR("Error allocating write request to inode %"PRIu64": %d",
+                        CGUTILS_ERROR("Error enabling AIO write to inode %"PRIu64": %d",
                                       ino,
                                       result);
+                        cgfs_async_request_free(request), request = NULL;
                     }
                 }
-            }
-            else
-            {
-                CGUTILS_ERROR("Error writing to inode %"PRIu64": %d",
-                              ino,
-                              result);
+                else
+                {
+                    CGUTILS_ERROR("Error allocating write request to inode %"PRIu64": %d",
+                                  ino,
+                                  result);
+                }
             }
         }
         else
         {
-            CGUTILS_ERROR("Error seeking before writing to inode %"PRIu64": %d",
+            CGUTILS_ERROR("Error writing to inode %"PRIu64": %d",
                           ino,
                           result);
         }
@@ -2058,9 +2856,12 @@ void cgfs_async_setattr(cgfs_data * const data,
                 request->inode = inode;
                 inode = NULL;
 
+                cgfs_inode_get_attributes(request->inode,
+                                          &(request->attr));
+
                 result = cgsmc_async_setattr(data->cgsmc_data,
                                              request->ino,
-                                             &(request->inode->attr),
+                                             &(request->attr),
                                              cgfs_to_set & CGFS_SET_ATTR_SIZE,
                                              &cgfs_async_setattr_callback,
                                              request);
@@ -2109,6 +2910,8 @@ static void cgfs_async_mkdir_callback(int const status,
     CGUTILS_ASSERT(request != NULL);
     CGUTILS_ASSERT(request->type == cgfs_async_request_type_mkdir);
 
+    cgfs_async_invalidate_entries(request);
+
     if (COMPILER_LIKELY(status == 0))
     {
         CGUTILS_ASSERT(st != NULL);
@@ -2134,28 +2937,9 @@ static void cgfs_async_mkdir_callback(int const status,
 
         if (result == ENOENT)
         {
-            result = cgfs_inode_init(st,
-                                     &(request->inode));
-
-            if (COMPILER_LIKELY(result == 0))
-            {
-                result = cgfs_cache_add(request->data->cache,
-                                        request->inode);
-
-                if (COMPILER_UNLIKELY(result != 0))
-                {
-                    CGUTILS_WARN("Error adding inode %"PRIu64" to cache: %d",
-                                 cgfs_inode_get_number(request->inode),
-                                 result);
-                }
-
-                result = 0;
-            }
-            else
-            {
-                CGUTILS_ERROR("Error getting inode from stat: %d",
-                              result);
-            }
+            result = cgfs_async_cache_inode(request->data,
+                                            st,
+                                            &(request->inode));
         }
 
         if (COMPILER_LIKELY(result == 0))
@@ -2300,6 +3084,8 @@ static void cgfs_async_rmdir_callback(int const status,
 
     CGUTILS_ASSERT(request != NULL);
 
+    cgfs_async_invalidate_entries(request);
+
     if (COMPILER_LIKELY(status == 0))
     {
         cgfs_inode * deleted_inode = NULL;
@@ -2347,6 +3133,11 @@ static void cgfs_async_rmdir_callback(int const status,
                                     time(NULL));
         }
 
+        cgfs_cache_add_child(request->data->cache,
+                             request->ino,
+                             request->name,
+                             0);
+
         CGUTILS_ASSERT(request->status_cb != NULL);
 
         (*(request->status_cb))(status,
@@ -2545,6 +3336,9 @@ static int cgfs_async_fsync_event_cb(int const status,
 
         cgfs_file_handler_file_refresh_inode_attributes_from_fd(request->fh);
 
+        /* superseded by this one */
+        cgfs_inode_unqueue_dirty_notification(request->inode);
+
         result = cgsmc_async_notify_write(request->data->cgsmc_data,
                                           cgfs_inode_get_number(request->inode),
                                           &cgfs_async_fsync_notification_callback,
@@ -2661,6 +3455,8 @@ static void cgfs_async_unlink_callback(int const status,
     CGUTILS_ASSERT(request != NULL);
     int result = status;
 
+    cgfs_async_invalidate_entries(request);
+
     if (COMPILER_LIKELY(result == 0))
     {
         cgfs_inode * parent_inode = NULL;
@@ -2706,6 +3502,11 @@ static void cgfs_async_unlink_callback(int const status,
             cgfs_inode_release(parent_inode), parent_inode = NULL;
         }
 
+        cgfs_cache_add_child(request->data->cache,
+                             request->ino,
+                             request->name,
+                             0);
+
         (*(request->status_cb))(0,
                                 request->cb_data);
     }
@@ -2797,6 +3598,8 @@ static void cgfs_async_rename_callback(int const status,
     CGUTILS_ASSERT(request != NULL);
     int result = status;
 
+    cgfs_async_invalidate_entries(request);
+
     if (COMPILER_LIKELY(result == 0))
     {
         CGUTILS_ASSERT(request->inode == NULL);
@@ -3006,6 +3809,8 @@ static void cgfs_async_hardlink_callback(int const status,
     CGUTILS_ASSERT(request != NULL);
     int result = status;
 
+    cgfs_async_invalidate_entries(request);
+
     if (COMPILER_LIKELY(result == 0))
     {
         CGUTILS_ASSERT(st != NULL);
@@ -3049,28 +3854,9 @@ static void cgfs_async_hardlink_callback(int const status,
                              result);
             }
 
-            result = cgfs_inode_init(st,
-                                     &(request->inode));
-
-            if (COMPILER_LIKELY(result == 0))
-            {
-                result = cgfs_cache_add(request->data->cache,
-                                        request->inode);
-
-                if (COMPILER_UNLIKELY(result != 0))
-                {
-                    CGUTILS_WARN("Error adding inode %"PRIu64" to cache: %d",
-                                 request->ino,
-                                 result);
-                }
-
-                result = 0;
-            }
-            else
-            {
-                CGUTILS_ERROR("Error getting inode from stat: %d",
-                              result);
-            }
+            result = cgfs_async_cache_inode(request->data,
+                                            st,
+                                            &(request->inode));
         }
 
         if (COMPILER_LIKELY(result == 0))
@@ -3186,6 +3972,8 @@ static void cgfs_async_symlink_callback(int const status,
     int result = status;
     CGUTILS_ASSERT(request->type == cgfs_async_request_type_symlink);
 
+    cgfs_async_invalidate_entries(request);
+
     if (COMPILER_LIKELY(result == 0))
     {
         CGUTILS_ASSERT(st != NULL);
@@ -3210,28 +3998,9 @@ static void cgfs_async_symlink_callback(int const status,
         }
 
         /* create new inode */
-        result = cgfs_inode_init(st,
-                                 &(request->inode));
-
-        if (COMPILER_LIKELY(result == 0))
-        {
-            result = cgfs_cache_add(request->data->cache,
-                                    request->inode);
-
-            if (COMPILER_UNLIKELY(result != 0))
-            {
-                CGUTILS_WARN("Error adding inode %"PRIu64" to cache: %d",
-                             cgfs_inode_get_number(request->inode),
-                             result);
-            }
-
-            result = 0;
-        }
-        else
-        {
-            CGUTILS_ERROR("Error getting inode from stat: %d",
-                          result);
-        }
+        result = cgfs_async_cache_inode(request->data,
+                                        st,
+                                        &(request->inode));
 
         if (COMPILER_LIKELY(result == 0))
         {
@@ -39,6 +39,14 @@ typedef void (cgfs_async_status_cb)(int status,
 typedef void (cgfs_async_open_cb)(void * cb_data,
                                   cgfs_file_handler * file_handler);
 
+/* The entries starting at position off are available
+   in the current batch of the file handler. */
+typedef void (cgfs_async_readdir_cb)(void * cb_data,
+                                     cgfs_file_handler * file_handler,
+                                     uint64_t ino,
+                                     size_t off,
+                                     size_t size);
+
 typedef void (cgfs_async_create_and_open_cb)(void * cb_data,
                                              cgfs_inode * inode,
                                              cgfs_file_handler * file_handler);
@@ -47,6 +55,13 @@ typedef void (cgfs_async_read_cb)(void * cb_data,
                                   void * buffer,
                                   size_t buffer_size);
 
+/* The data is to be read from fd, at offset off.
+   size is 0 on EOF. */
+typedef void (cgfs_async_read_fd_cb)(void * cb_data,
+                                     int fd,
+                                     off_t off,
+                                     size_t size);
+
 typedef void (cgfs_async_write_cb)(void * cb_data,
                                    size_t written);
 
@@ -75,12 +90,21 @@ void cgfs_async_opendir(cgfs_data * data,
                         cgfs_async_error_cb * error_cb,
                         void * req);
 
+void cgfs_async_readdir(cgfs_data * data,
+                        uint64_t ino,
+                        cgfs_file_handler * file_handler,
+                        size_t off,
+                        size_t size,
+                        cgfs_async_readdir_cb * cb,
+                        cgfs_async_error_cb * error_cb,
+                        void * req);
+
 int cgfs_async_get_dir_entry(cgfs_data * data,
                              uint64_t ino,
                              cgfs_file_handler * file_handler,
-                             size_t idx,
+                             size_t pos,
                              char const ** name_out,
-                             struct stat const ** st_out);
+                             struct stat * st_out);
 
 size_t cgfs_async_get_remaining_dir_entries_count(cgfs_data * data,
                                                   uint64_t ino,
@@ -137,6 +161,20 @@ void cgfs_async_read(cgfs_data * data,
                      cgfs_async_error_cb * error_cb,
                      void * req);
 
+/* Zero-copy variant of cgfs_async_read(), handing out the
+   cache file descriptor instead of a buffer whenever the data
+   can be read from it without blocking. Otherwise, falls back
+   to cgfs_async_read() and fallback_cb. */
+void cgfs_async_read_fd(cgfs_data * data,
+                        cgfs_file_handler * file_handler,
+                        uint64_t ino,
+                        size_t size,
+                        off_t off,
+                        cgfs_async_read_fd_cb * cb,
+                        cgfs_async_read_cb * fallback_cb,
+                        cgfs_async_error_cb * error_cb,
+                        void * req);
+
 void cgfs_async_write(cgfs_data * data,
                       cgfs_file_handler * file_handler,
                       uint64_t ino,
@@ -227,4 +265,14 @@ void cgfs_async_readlink(cgfs_data * data,
                          cgfs_async_error_cb * error_cb,
                          void * cb_data);
 
+/* Write notifications are coalesced per thread and sent in batches,
+   see NotifyWriteBatchSize. Pending ones are dropped by clean. */
+int cgfs_async_notify_write_batch_init(cgfs_data * data);
+void cgfs_async_notify_write_batch_clean(cgfs_data * data);
+
+/* Read-only opens leased by the storage manager are served
+   from a descriptor kept by this thread, see OpenLeaseCacheSize. */
+int cgfs_async_open_lease_init(cgfs_data * data);
+void cgfs_async_open_lease_clean(cgfs_data * data);
+
 #endif /* CGFS_ASYNC_H_ */
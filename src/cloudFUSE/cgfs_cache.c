@@ -22,157 +22,872 @@
  */
 
 #include <errno.h>
-
-#include <cloudutils/cloudutils_rbtree.h>
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
 
 #include "cgfs_cache.h"
 
+/* Inodes are indexed by number in a hash table chained through
+   inode->hash_next, and we use a segmented LRU:
+
+   Inodes are first added to the inactive lru (tail) BUT ONLY WHILE their lookup count is 0,
+   either because they have just been created from a readdir / lookup response,
+   or because a forget() brought it back down to 0.
+   Inactive hits are moved to the active lru (tail).
+   If the active list becomes full, inodes from the head are moved back to the inactive list (tail).
+   If the inactive list becomes full, inodes from the head are dropped,
+   unless they are still referenced (kernel lookup count, open handles, pending requests).
+*/
+
+#define CGFS_CACHE_TABLE_INITIAL_BITS (10)
+#define CGFS_CACHE_TABLE_MAX_BITS (30)
+
+#define CGFS_CACHE_DENTRY_TABLE_MIN_BITS (10)
+#define CGFS_CACHE_DENTRY_TABLE_MAX_BITS (24)
+
+#define CGFS_CACHE_DIR_GENERATIONS_BITS (10)
+
+/* (parent inode, name) -> inode number entries.
+   A negative entry (ino == 0) records that the name does not exist.
+   Entries are kept in insertion order for eviction,
+   and expire after the positive or negative TTL. */
+typedef struct cgfs_cache_dentry cgfs_cache_dentry;
+
+struct cgfs_cache_dentry
+{
+    cgfs_cache_dentry * hash_next;
+    cgfs_cache_dentry * age_prev;
+    cgfs_cache_dentry * age_next;
+    uint64_t parent_ino;
+    uint64_t ino;
+    time_t expiration;
+    size_t hash;
+    char name[];
+};
+
+typedef struct
+{
+    cgfs_inode * head;
+    cgfs_inode * tail;
+    size_t count;
+    size_t max;
+} cgfs_cache_lru;
+
+/* All the operations are serialized by the cache lock,
+   since the cache is shared by the FUSE worker threads. */
 struct cgfs_cache
 {
-    cgutils_rbtree * tree;
+    pthread_mutex_t lock;
+
+    cgfs_inode ** table;
+    size_t table_size;
+    size_t table_bits;
     size_t count;
+
+    cgfs_cache_lru active;
+    cgfs_cache_lru inactive;
+
+    cgfs_cache_dentry ** dentries;
+    cgfs_cache_dentry * dentries_oldest;
+    cgfs_cache_dentry * dentries_newest;
+    size_t dentries_table_bits;
+    size_t dentries_count;
+    size_t dentries_max;
+    time_t dentry_positive_ttl;
+    time_t dentry_negative_ttl;
+
+    /* Bumped each time an entry of a directory is invalidated,
+       indexed by a hash of the parent inode number. A collision
+       only makes us refuse an entry that was valid. */
+    uint64_t dir_generations[((size_t) 1) << CGFS_CACHE_DIR_GENERATIONS_BITS];
+
+    cgfs_cache_stats stats;
 };
 
-static int cgfs_cache_btree_compare_key(void const * const a,
-                                        void const * const b)
+static inline size_t cgfs_cache_hash(uint64_t const ino,
+                                     size_t const bits)
 {
-    int result = 0;
-    uint64_t const * const tmp_a = a;
-    uint64_t const * const tmp_b = b;
-    CGUTILS_ASSERT(tmp_a != NULL);
-    CGUTILS_ASSERT(tmp_b != NULL);
+    /* Fibonacci hashing */
+    return (size_t) ((ino * UINT64_C(11400714819323198485)) >> (64 - bits));
+}
 
-    if (*tmp_a > *tmp_b)
+static void cgfs_cache_lru_append(cgfs_cache_lru * const lru,
+                                  cgfs_inode_lru const lru_type,
+                                  cgfs_inode * const inode)
+{
+    CGUTILS_ASSERT(lru != NULL);
+    CGUTILS_ASSERT(inode != NULL);
+    CGUTILS_ASSERT(inode->lru == cgfs_inode_lru_none);
+    CGUTILS_ASSERT(inode->lru_prev == NULL);
+    CGUTILS_ASSERT(inode->lru_next == NULL);
+
+    inode->lru_prev = lru->tail;
+
+    if (lru->tail != NULL)
     {
-        result = 1;
+        lru->tail->lru_next = inode;
     }
-    else if (*tmp_a < *tmp_b)
+    else
     {
-        result = -1;
+        lru->head = inode;
     }
 
-    return result;
+    lru->tail = inode;
+    lru->count++;
+    inode->lru = lru_type;
 }
 
-static void cgfs_cache_btree_release_key(void * key)
+static void cgfs_cache_lru_unlink(cgfs_cache_lru * const lru,
+                                  cgfs_inode * const inode)
 {
-    CGUTILS_ASSERT(key != NULL);
-    /* key will be released when the "value" eg the inode is
-       released. */
+    CGUTILS_ASSERT(lru != NULL);
+    CGUTILS_ASSERT(inode != NULL);
+    CGUTILS_ASSERT(inode->lru != cgfs_inode_lru_none);
+    CGUTILS_ASSERT(lru->count > 0);
+
+    if (inode->lru_prev != NULL)
+    {
+        inode->lru_prev->lru_next = inode->lru_next;
+    }
+    else
+    {
+        lru->head = inode->lru_next;
+    }
+
+    if (inode->lru_next != NULL)
+    {
+        inode->lru_next->lru_prev = inode->lru_prev;
+    }
+    else
+    {
+        lru->tail = inode->lru_prev;
+    }
 
-    (void) key;
+    inode->lru_prev = NULL;
+    inode->lru_next = NULL;
+    inode->lru = cgfs_inode_lru_none;
+    lru->count--;
 }
 
-static void cgfs_cache_btree_release_value(void * value)
+static cgfs_cache_lru * cgfs_cache_get_inode_lru(cgfs_cache * const this,
+                                                 cgfs_inode const * const inode)
 {
-    cgfs_inode * inode = value;
+    cgfs_cache_lru * result = NULL;
+    CGUTILS_ASSERT(this != NULL);
     CGUTILS_ASSERT(inode != NULL);
 
+    if (inode->lru == cgfs_inode_lru_active)
+    {
+        result = &(this->active);
+    }
+    else if (inode->lru == cgfs_inode_lru_inactive)
+    {
+        result = &(this->inactive);
+    }
+
+    return result;
+}
+
+static cgfs_inode ** cgfs_cache_find_slot(cgfs_cache const * const this,
+                                          uint64_t const ino)
+{
+    CGUTILS_ASSERT(this != NULL);
+    CGUTILS_ASSERT(this->table != NULL);
+
+    cgfs_inode ** slot = &(this->table[cgfs_cache_hash(ino, this->table_bits)]);
+
+    while (*slot != NULL &&
+           cgfs_inode_get_number(*slot) != ino)
+    {
+        slot = &((*slot)->hash_next);
+    }
+
+    return slot;
+}
+
+static void cgfs_cache_grow_table(cgfs_cache * const this)
+{
+    CGUTILS_ASSERT(this != NULL);
+
+    if (this->table_bits < CGFS_CACHE_TABLE_MAX_BITS)
+    {
+        size_t const new_bits = this->table_bits + 1;
+        size_t const new_size = ((size_t) 1) << new_bits;
+        cgfs_inode ** new_table = NULL;
+
+        new_table = calloc(new_size, sizeof *new_table);
+
+        if (COMPILER_LIKELY(new_table != NULL))
+        {
+            for (size_t idx = 0;
+                 idx < this->table_size;
+                 idx++)
+            {
+                cgfs_inode * inode = this->table[idx];
+
+                while (inode != NULL)
+                {
+                    cgfs_inode * const next = inode->hash_next;
+                    size_t const bucket = cgfs_cache_hash(cgfs_inode_get_number(inode),
+                                                          new_bits);
+
+                    inode->hash_next = new_table[bucket];
+                    new_table[bucket] = inode;
+
+                    inode = next;
+                }
+            }
+
+            CGUTILS_FREE(this->table);
+            this->table = new_table;
+            this->table_size = new_size;
+            this->table_bits = new_bits;
+        }
+        else
+        {
+            /* Not fatal, we will just have longer chains. */
+            CGUTILS_WARN("Unable to grow the inode cache table to %zu entries",
+                         new_size);
+        }
+    }
+}
+
+static void cgfs_cache_drop(cgfs_cache * const this,
+                            cgfs_inode ** const slot)
+{
+    CGUTILS_ASSERT(this != NULL);
+    CGUTILS_ASSERT(slot != NULL);
+    CGUTILS_ASSERT(*slot != NULL);
+    CGUTILS_ASSERT(this->count > 0);
+
+    cgfs_inode * const inode = *slot;
+    cgfs_cache_lru * const lru = cgfs_cache_get_inode_lru(this,
+                                                          inode);
+
+    if (lru != NULL)
+    {
+        cgfs_cache_lru_unlink(lru,
+                              inode);
+    }
+
+    *slot = inode->hash_next;
+    inode->hash_next = NULL;
+    this->count--;
+
     cgfs_inode_release(inode);
 }
 
-int cgfs_cache_lookup_child(cgfs_cache * const this,
-                            uint64_t const parent_ino,
-                            char const * const name,
-                            cgfs_inode ** const out)
+static void cgfs_cache_enforce_limits(cgfs_cache * const this)
 {
     CGUTILS_ASSERT(this != NULL);
-    CGUTILS_ASSERT(parent_ino > 0);
-    CGUTILS_ASSERT(name != NULL);
+
+    while (this->active.count > this->active.max)
+    {
+        cgfs_inode * const inode = this->active.head;
+
+        cgfs_cache_lru_unlink(&(this->active),
+                              inode);
+
+        cgfs_cache_lru_append(&(this->inactive),
+                              cgfs_inode_lru_inactive,
+                              inode);
+
+        this->stats.demotions++;
+    }
+
+    /* Do not scan the same inode twice */
+    for (size_t to_scan = this->inactive.count;
+         to_scan > 0 &&
+             this->inactive.count > this->inactive.max;
+         to_scan--)
+    {
+        cgfs_inode * const inode = this->inactive.head;
+
+        cgfs_cache_lru_unlink(&(this->inactive),
+                              inode);
+
+        if (cgfs_inode_get_lookup_count(inode) > 0)
+        {
+            /* Still known by the kernel, it will be
+               added back by cgfs_cache_forget(). */
+        }
+        else if (cgfs_inode_get_ref_count(inode) > 1)
+        {
+            /* Still in use (open file, dir entry, pending request),
+               give it another chance. */
+            cgfs_cache_lru_append(&(this->inactive),
+                                  cgfs_inode_lru_inactive,
+                                  inode);
+        }
+        else
+        {
+            cgfs_inode ** const slot = cgfs_cache_find_slot(this,
+                                                            cgfs_inode_get_number(inode));
+            CGUTILS_ASSERT(*slot == inode);
+
+            cgfs_cache_drop(this,
+                            slot);
+
+            this->stats.evictions++;
+        }
+    }
+}
+
+static void cgfs_cache_touch(cgfs_cache * const this,
+                             cgfs_inode * const inode)
+{
+    CGUTILS_ASSERT(this != NULL);
+    CGUTILS_ASSERT(inode != NULL);
+
+    if (inode->lru == cgfs_inode_lru_inactive)
+    {
+        cgfs_cache_lru_unlink(&(this->inactive),
+                              inode);
+
+        cgfs_cache_lru_append(&(this->active),
+                              cgfs_inode_lru_active,
+                              inode);
+
+        this->stats.promotions++;
+
+        cgfs_cache_enforce_limits(this);
+    }
+    else if (inode->lru == cgfs_inode_lru_active &&
+             this->active.tail != inode)
+    {
+        cgfs_cache_lru_unlink(&(this->active),
+                              inode);
+
+        cgfs_cache_lru_append(&(this->active),
+                              cgfs_inode_lru_active,
+                              inode);
+    }
+}
+
+static int cgfs_cache_lookup_unlocked(cgfs_cache * const this,
+                                      uint64_t const ino,
+                                      cgfs_inode ** const out)
+{
+    int result = 0;
+    CGUTILS_ASSERT(this != NULL);
+    CGUTILS_ASSERT(this->table != NULL);
     CGUTILS_ASSERT(out != NULL);
 
-    /* Not implemented for now */
-    (void) this;
-    (void) parent_ino;
-    (void) name;
-    (void) out;
+    cgfs_inode * const inode = *(cgfs_cache_find_slot(this,
+                                                      ino));
+
+    if (COMPILER_LIKELY(inode != NULL))
+    {
+        cgfs_inode_inc_ref_count(inode);
+        cgfs_cache_touch(this,
+                         inode);
+        this->stats.hits++;
+        *out = inode;
+    }
+    else
+    {
+        this->stats.misses++;
+        result = ENOENT;
+    }
 
-    return ENOENT;
+    return result;
 }
 
 int cgfs_cache_lookup(cgfs_cache * const this,
                       uint64_t const ino,
                       cgfs_inode ** const out)
 {
-    cgutils_rbtree_node * node = NULL;
     CGUTILS_ASSERT(this != NULL);
-    CGUTILS_ASSERT(this->tree != NULL);
+
+    pthread_mutex_lock(&(this->lock));
+
+    int const result = cgfs_cache_lookup_unlocked(this,
+                                                  ino,
+                                                  out);
+
+    pthread_mutex_unlock(&(this->lock));
+
+    return result;
+}
+
+static size_t cgfs_cache_dentry_hash(uint64_t const parent_ino,
+                                     char const * const name,
+                                     size_t * const name_len)
+{
+    /* FNV-1a, seeded with the parent inode number */
+    uint64_t hash = UINT64_C(14695981039346656037) ^ parent_ino;
+    size_t len = 0;
+
+    CGUTILS_ASSERT(name != NULL);
+    CGUTILS_ASSERT(name_len != NULL);
+
+    for (; name[len] != '\0'; len++)
+    {
+        hash ^= (unsigned char) name[len];
+        hash *= UINT64_C(1099511628211);
+    }
+
+    *name_len = len;
+
+    return (size_t) hash;
+}
+
+static cgfs_cache_dentry ** cgfs_cache_dentry_find_slot(cgfs_cache const * const this,
+                                                        uint64_t const parent_ino,
+                                                        char const * const name,
+                                                        size_t const hash)
+{
+    CGUTILS_ASSERT(this != NULL);
+    CGUTILS_ASSERT(this->dentries != NULL);
+    CGUTILS_ASSERT(name != NULL);
+
+    cgfs_cache_dentry ** slot = &(this->dentries[cgfs_cache_hash(hash,
+                                                                  this->dentries_table_bits)]);
+
+    while (*slot != NULL &&
+           ((*slot)->hash != hash ||
+            (*slot)->parent_ino != parent_ino ||
+            strcmp((*slot)->name, name) != 0))
+    {
+        slot = &((*slot)->hash_next);
+    }
+
+    return slot;
+}
+
+static void cgfs_cache_dentry_drop(cgfs_cache * const this,
+                                   cgfs_cache_dentry ** const slot)
+{
+    CGUTILS_ASSERT(this != NULL);
+    CGUTILS_ASSERT(slot != NULL);
+    CGUTILS_ASSERT(*slot != NULL);
+    CGUTILS_ASSERT(this->dentries_count > 0);
+
+    cgfs_cache_dentry * dentry = *slot;
+
+    *slot = dentry->hash_next;
+
+    if (dentry->age_prev != NULL)
+    {
+        dentry->age_prev->age_next = dentry->age_next;
+    }
+    else
+    {
+        this->dentries_oldest = dentry->age_next;
+    }
+
+    if (dentry->age_next != NULL)
+    {
+        dentry->age_next->age_prev = dentry->age_prev;
+    }
+    else
+    {
+        this->dentries_newest = dentry->age_prev;
+    }
+
+    this->dentries_count--;
+
+    CGUTILS_FREE(dentry);
+}
+
+static void cgfs_cache_dentry_drop_oldest(cgfs_cache * const this)
+{
+    CGUTILS_ASSERT(this != NULL);
+    CGUTILS_ASSERT(this->dentries_oldest != NULL);
+
+    cgfs_cache_dentry const * const oldest = this->dentries_oldest;
+    cgfs_cache_dentry ** const slot = cgfs_cache_dentry_find_slot(this,
+                                                                  oldest->parent_ino,
+                                                                  oldest->name,
+                                                                  oldest->hash);
+    CGUTILS_ASSERT(*slot == oldest);
+
+    cgfs_cache_dentry_drop(this,
+                           slot);
+}
+
+int cgfs_cache_lookup_child(cgfs_cache * const this,
+                            uint64_t const parent_ino,
+                            char const * const name,
+                            cgfs_inode ** const out)
+{
+    int result = ENODATA;
+    CGUTILS_ASSERT(this != NULL);
+    CGUTILS_ASSERT(parent_ino > 0);
+    CGUTILS_ASSERT(name != NULL);
     CGUTILS_ASSERT(out != NULL);
 
-    int result = cgutils_rbtree_get(this->tree,
-                                    &ino,
-                                    &node);
+    pthread_mutex_lock(&(this->lock));
 
-    if (COMPILER_LIKELY(result == 0))
+    if (this->dentries != NULL)
     {
-        cgfs_inode * const inode = cgutils_rbtree_node_get_value(node);
-        cgfs_inode_inc_ref_count(inode);
-        *out = inode;
+        size_t name_len = 0;
+        size_t const hash = cgfs_cache_dentry_hash(parent_ino,
+                                                   name,
+                                                   &name_len);
+        cgfs_cache_dentry ** const slot = cgfs_cache_dentry_find_slot(this,
+                                                                      parent_ino,
+                                                                      name,
+                                                                      hash);
+
+        if (*slot != NULL)
+        {
+            cgfs_cache_dentry * const dentry = *slot;
+
+            if (dentry->expiration < time(NULL))
+            {
+                cgfs_cache_dentry_drop(this,
+                                       slot);
+            }
+            else if (dentry->ino == 0)
+            {
+                this->stats.dentry_negative_hits++;
+                result = ENOENT;
+            }
+            else
+            {
+                result = cgfs_cache_lookup_unlocked(this,
+                                                    dentry->ino,
+                                                    out);
+
+                if (COMPILER_LIKELY(result == 0))
+                {
+                    this->stats.dentry_hits++;
+                }
+                else
+                {
+                    /* The inode has been evicted, we have no
+                       way to return its attributes. */
+                    cgfs_cache_dentry_drop(this,
+                                           slot);
+                    result = ENODATA;
+                }
+            }
+        }
+
+        if (result == ENODATA)
+        {
+            this->stats.dentry_misses++;
+        }
     }
-    else if (result != ENOENT)
+
+    pthread_mutex_unlock(&(this->lock));
+
+    return result;
+}
+
+static void cgfs_cache_add_child_unlocked(cgfs_cache * const this,
+                                          uint64_t const parent_ino,
+                                          char const * const name,
+                                          uint64_t const ino)
+{
+    CGUTILS_ASSERT(this != NULL);
+    CGUTILS_ASSERT(parent_ino > 0);
+    CGUTILS_ASSERT(name != NULL);
+
+    time_t const ttl = ino > 0 ? this->dentry_positive_ttl : this->dentry_negative_ttl;
+
+    if (this->dentries != NULL &&
+        ttl > 0)
     {
-        CGUTILS_ERROR("Error looking up inode %"PRIu64" from the cache tree: %d",
-                      ino,
-                      result);
+        size_t name_len = 0;
+        size_t const hash = cgfs_cache_dentry_hash(parent_ino,
+                                                   name,
+                                                   &name_len);
+        cgfs_cache_dentry ** const slot = cgfs_cache_dentry_find_slot(this,
+                                                                      parent_ino,
+                                                                      name,
+                                                                      hash);
+
+        if (*slot != NULL)
+        {
+            cgfs_cache_dentry_drop(this,
+                                   slot);
+        }
+
+        cgfs_cache_dentry * dentry = malloc(sizeof *dentry + name_len + 1);
+
+        if (COMPILER_LIKELY(dentry != NULL))
+        {
+            size_t const bucket = cgfs_cache_hash(hash,
+                                                  this->dentries_table_bits);
+
+            dentry->parent_ino = parent_ino;
+            dentry->ino = ino;
+            dentry->expiration = time(NULL) + ttl;
+            dentry->hash = hash;
+            memcpy(dentry->name, name, name_len + 1);
+
+            dentry->hash_next = this->dentries[bucket];
+            this->dentries[bucket] = dentry;
+
+            dentry->age_next = NULL;
+            dentry->age_prev = this->dentries_newest;
+
+            if (this->dentries_newest != NULL)
+            {
+                this->dentries_newest->age_next = dentry;
+            }
+            else
+            {
+                this->dentries_oldest = dentry;
+            }
+
+            this->dentries_newest = dentry;
+            this->dentries_count++;
+
+            while (this->dentries_count > this->dentries_max)
+            {
+                cgfs_cache_dentry_drop_oldest(this);
+            }
+        }
+        else
+        {
+            CGUTILS_WARN("Unable to allocate a dentry for %s in %"PRIu64,
+                         name,
+                         parent_ino);
+        }
     }
+}
+
+void cgfs_cache_add_child(cgfs_cache * const this,
+                          uint64_t const parent_ino,
+                          char const * const name,
+                          uint64_t const ino)
+{
+    CGUTILS_ASSERT(this != NULL);
+
+    pthread_mutex_lock(&(this->lock));
+
+    cgfs_cache_add_child_unlocked(this,
+                                  parent_ino,
+                                  name,
+                                  ino);
+
+    pthread_mutex_unlock(&(this->lock));
+}
+
+uint64_t cgfs_cache_get_dir_generation(cgfs_cache * const this,
+                                       uint64_t const parent_ino)
+{
+    CGUTILS_ASSERT(this != NULL);
+
+    pthread_mutex_lock(&(this->lock));
+
+    uint64_t const result = this->dir_generations[cgfs_cache_hash(parent_ino,
+                                                                  CGFS_CACHE_DIR_GENERATIONS_BITS)];
+
+    pthread_mutex_unlock(&(this->lock));
 
     return result;
 }
 
-int cgfs_cache_remove(cgfs_cache * const this,
-                      uint64_t const ino)
+void cgfs_cache_add_lookup_child(cgfs_cache * const this,
+                                 uint64_t const parent_ino,
+                                 char const * const name,
+                                 uint64_t const ino,
+                                 uint64_t const dir_generation)
 {
-    cgutils_rbtree_node * node = NULL;
     CGUTILS_ASSERT(this != NULL);
-    CGUTILS_ASSERT(this->tree != NULL);
 
-    int result = cgutils_rbtree_get(this->tree,
-                                    &ino,
-                                    &node);
+    pthread_mutex_lock(&(this->lock));
 
-    if (COMPILER_LIKELY(result == 0))
+    if (this->dir_generations[cgfs_cache_hash(parent_ino,
+                                              CGFS_CACHE_DIR_GENERATIONS_BITS)] == dir_generation)
+    {
+        cgfs_cache_add_child_unlocked(this,
+                                      parent_ino,
+                                      name,
+                                      ino);
+    }
+    else
     {
-        result = cgutils_rbtree_remove(this->tree,
-                                       node);
+        this->stats.dentry_stale_lookups++;
+    }
+
+    pthread_mutex_unlock(&(this->lock));
+}
+
+void cgfs_cache_remove_child(cgfs_cache * const this,
+                             uint64_t const parent_ino,
+                             char const * const name)
+{
+    CGUTILS_ASSERT(this != NULL);
+    CGUTILS_ASSERT(name != NULL);
+
+    pthread_mutex_lock(&(this->lock));
 
-        if (COMPILER_UNLIKELY(result != 0))
+    this->dir_generations[cgfs_cache_hash(parent_ino,
+                                          CGFS_CACHE_DIR_GENERATIONS_BITS)]++;
+
+    if (this->dentries != NULL)
+    {
+        size_t name_len = 0;
+        size_t const hash = cgfs_cache_dentry_hash(parent_ino,
+                                                   name,
+                                                   &name_len);
+        cgfs_cache_dentry ** const slot = cgfs_cache_dentry_find_slot(this,
+                                                                      parent_ino,
+                                                                      name,
+                                                                      hash);
+
+        if (*slot != NULL)
         {
-            CGUTILS_ERROR("Error removing inode %"PRIu64" from the cache tree: %d",
-                          ino,
-                          result);
+            cgfs_cache_dentry_drop(this,
+                                   slot);
         }
     }
+
+    pthread_mutex_unlock(&(this->lock));
+}
+
+int cgfs_cache_remove(cgfs_cache * const this,
+                      uint64_t const ino)
+{
+    int result = 0;
+    CGUTILS_ASSERT(this != NULL);
+    CGUTILS_ASSERT(this->table != NULL);
+
+    pthread_mutex_lock(&(this->lock));
+
+    cgfs_inode ** const slot = cgfs_cache_find_slot(this,
+                                                    ino);
+
+    if (COMPILER_LIKELY(*slot != NULL))
+    {
+        cgfs_cache_drop(this,
+                        slot);
+    }
     else
     {
-        CGUTILS_ERROR("Error looking up inode %"PRIu64" for removal from the cache tree: %d",
+        result = ENOENT;
+        CGUTILS_ERROR("Error looking up inode %"PRIu64" for removal from the cache: %d",
                       ino,
                       result);
     }
 
+    pthread_mutex_unlock(&(this->lock));
+
     return result;
 }
 
 int cgfs_cache_add(cgfs_cache * const this,
-                   cgfs_inode * const inode)
+                   cgfs_inode ** const inode)
 {
+    int result = 0;
     CGUTILS_ASSERT(this != NULL);
-    CGUTILS_ASSERT(this->tree != NULL);
+    CGUTILS_ASSERT(this->table != NULL);
     CGUTILS_ASSERT(inode != NULL);
+    CGUTILS_ASSERT(*inode != NULL);
+    CGUTILS_ASSERT((*inode)->hash_next == NULL);
+    CGUTILS_ASSERT((*inode)->lru == cgfs_inode_lru_none);
+
+    pthread_mutex_lock(&(this->lock));
 
-    int result = cgutils_rbtree_insert(this->tree,
-                                       &(inode->attr.st_ino),
-                                       inode);
+    cgfs_inode ** const slot = cgfs_cache_find_slot(this,
+                                                    cgfs_inode_get_number(*inode));
 
-    if (COMPILER_LIKELY(result == 0))
+    if (COMPILER_LIKELY(*slot == NULL))
     {
+        *slot = *inode;
+        this->count++;
+
         /* do not forget to increment the inode refcount */
-        cgfs_inode_inc_ref_count(inode);
+        cgfs_inode_inc_ref_count(*inode);
+
+        if (cgfs_inode_get_lookup_count(*inode) == 0)
+        {
+            cgfs_cache_lru_append(&(this->inactive),
+                                  cgfs_inode_lru_inactive,
+                                  *inode);
+
+            cgfs_cache_enforce_limits(this);
+        }
+
+        if (this->count > this->table_size)
+        {
+            cgfs_cache_grow_table(this);
+        }
+    }
+    else
+    {
+        /* added by another request since our lookup missed,
+           the cached inode is the one to use */
+        cgfs_inode_release(*inode);
+        *inode = *slot;
+
+        cgfs_inode_inc_ref_count(*inode);
+        cgfs_cache_touch(this,
+                         *inode);
+
+        result = EEXIST;
     }
 
+    pthread_mutex_unlock(&(this->lock));
+
     return result;
 }
 
-int cgfs_cache_init(cgfs_cache ** const out)
+void cgfs_cache_forget(cgfs_cache * const this,
+                       cgfs_inode * const inode)
+{
+    CGUTILS_ASSERT(this != NULL);
+    CGUTILS_ASSERT(inode != NULL);
+
+    pthread_mutex_lock(&(this->lock));
+
+    if (cgfs_inode_get_lookup_count(inode) > 0)
+    {
+        /* Looked up again by another thread in the meantime */
+    }
+    else if (cgfs_inode_has_been_deleted(inode) == true)
+    {
+        /* No way to reach it anymore. */
+        cgfs_inode ** const slot = cgfs_cache_find_slot(this,
+                                                        cgfs_inode_get_number(inode));
+
+        if (*slot == inode)
+        {
+            cgfs_cache_drop(this,
+                            slot);
+        }
+    }
+    else if (inode->lru == cgfs_inode_lru_none)
+    {
+        cgfs_cache_lru_append(&(this->inactive),
+                              cgfs_inode_lru_inactive,
+                              inode);
+
+        cgfs_cache_enforce_limits(this);
+    }
+
+    pthread_mutex_unlock(&(this->lock));
+}
+
+void cgfs_cache_get_stats(cgfs_cache * const this,
+                          cgfs_cache_stats * const stats)
+{
+    CGUTILS_ASSERT(this != NULL);
+    CGUTILS_ASSERT(stats != NULL);
+
+    pthread_mutex_lock(&(this->lock));
+
+    *stats = this->stats;
+    stats->count = this->count;
+    stats->active_count = this->active.count;
+    stats->inactive_count = this->inactive.count;
+    stats->dentries_count = this->dentries_count;
+
+    pthread_mutex_unlock(&(this->lock));
+}
+
+int cgfs_cache_init(size_t const active_max,
+                    size_t const inactive_max,
+                    size_t const dentries_max,
+                    time_t const dentry_positive_ttl,
+                    time_t const dentry_negative_ttl,
+                    cgfs_cache ** const out)
 {
     int result = 0;
     cgfs_cache * this = NULL;
@@ -182,20 +897,49 @@ int cgfs_cache_init(cgfs_cache ** const out)
 
     if (this != NULL)
     {
-        result = cgutils_rbtree_init(&cgfs_cache_btree_compare_key,
-                                     &cgfs_cache_btree_release_key,
-                                     &cgfs_cache_btree_release_value,
-                                     &(this->tree));
+        pthread_mutex_init(&(this->lock), NULL);
+
+        this->table_bits = CGFS_CACHE_TABLE_INITIAL_BITS;
+        this->table_size = ((size_t) 1) << this->table_bits;
+        this->table = calloc(this->table_size, sizeof *(this->table));
 
-        if (result == 0)
+        if (this->table != NULL)
         {
-            this->count = 0;
+            /* An empty list would evict an inode as soon
+               as it has been added. */
+            this->active.max = active_max > 0 ? active_max : 1;
+            this->inactive.max = inactive_max > 0 ? inactive_max : 1;
+
+            this->dentries_max = dentries_max;
+            this->dentry_positive_ttl = dentry_positive_ttl;
+            this->dentry_negative_ttl = dentry_negative_ttl;
+
+            if (dentries_max > 0)
+            {
+                this->dentries_table_bits = CGFS_CACHE_DENTRY_TABLE_MIN_BITS;
+
+                while (this->dentries_table_bits < CGFS_CACHE_DENTRY_TABLE_MAX_BITS &&
+                       (((size_t) 1) << this->dentries_table_bits) < dentries_max)
+                {
+                    this->dentries_table_bits++;
+                }
+
+                this->dentries = calloc(((size_t) 1) << this->dentries_table_bits,
+                                        sizeof *(this->dentries));
+
+                if (this->dentries == NULL)
+                {
+                    /* Not fatal, we will just not cache dentries. */
+                    CGUTILS_WARN("Unable to allocate the dentry cache table, disabling it");
+                }
+            }
 
             *out = this;
         }
         else
         {
-            CGUTILS_ERROR("Error creating the cache tree: %d",
+            result = ENOMEM;
+            CGUTILS_ERROR("Error creating the cache table: %d",
                           result);
             cgfs_cache_free(this), this = NULL;
         }
@@ -212,13 +956,52 @@ void cgfs_cache_free(cgfs_cache * this)
 {
     if (this != NULL)
     {
-        if (this->tree != NULL)
+        CGUTILS_INFO("Inode cache: %"PRIu64" hits, %"PRIu64" misses, %"PRIu64" promotions, %"PRIu64" demotions, %"PRIu64" evictions",
+                     this->stats.hits,
+                     this->stats.misses,
+                     this->stats.promotions,
+                     this->stats.demotions,
+                     this->stats.evictions);
+        CGUTILS_INFO("Dentry cache: %"PRIu64" hits, %"PRIu64" negative hits, %"PRIu64" misses, %"PRIu64" stale lookups",
+                     this->stats.dentry_hits,
+                     this->stats.dentry_negative_hits,
+                     this->stats.dentry_misses,
+                     this->stats.dentry_stale_lookups);
+
+        if (this->dentries != NULL)
         {
-            cgutils_rbtree_destroy(this->tree), this->tree = NULL;
+            while (this->dentries_oldest != NULL)
+            {
+                cgfs_cache_dentry_drop_oldest(this);
+            }
+
+            CGUTILS_FREE(this->dentries);
         }
 
+        if (this->table != NULL)
+        {
+            for (size_t idx = 0;
+                 idx < this->table_size;
+                 idx++)
+            {
+                while (this->table[idx] != NULL)
+                {
+                    cgfs_cache_drop(this,
+                                    &(this->table[idx]));
+                }
+            }
+
+            CGUTILS_FREE(this->table);
+        }
+
+        CGUTILS_ASSERT(this->active.count == 0);
+        CGUTILS_ASSERT(this->inactive.count == 0);
+
+        this->table_size = 0;
         this->count = 0;
 
+        pthread_mutex_destroy(&(this->lock));
+
         CGUTILS_FREE(this);
     }
 }
@@ -23,20 +23,79 @@
 #ifndef CGFS_CACHE_H_
 #define CGFS_CACHE_H_
 
+#include <stddef.h>
 #include <stdint.h>
+#include <time.h>
 
 typedef struct cgfs_cache cgfs_cache;
 
+typedef struct
+{
+    uint64_t hits;
+    uint64_t misses;
+    /* inactive -> active */
+    uint64_t promotions;
+    /* active -> inactive */
+    uint64_t demotions;
+    /* dropped from the inactive list */
+    uint64_t evictions;
+    size_t count;
+    size_t active_count;
+    size_t inactive_count;
+    uint64_t dentry_hits;
+    uint64_t dentry_negative_hits;
+    uint64_t dentry_misses;
+    /* lookup replies not cached because the
+       directory changed while they were in flight */
+    uint64_t dentry_stale_lookups;
+    size_t dentries_count;
+} cgfs_cache_stats;
+
 #include <cgfs_inode.h>
 
-int cgfs_cache_init(cgfs_cache ** out);
+/* A dentries_max of 0 disables the dentry cache,
+   as does a TTL of 0 for the corresponding entries. */
+int cgfs_cache_init(size_t active_max,
+                    size_t inactive_max,
+                    size_t dentries_max,
+                    time_t dentry_positive_ttl,
+                    time_t dentry_negative_ttl,
+                    cgfs_cache ** out);
 void cgfs_cache_free(cgfs_cache * this);
 
+/* Returns 0 and a reference to the inode on a positive hit,
+   ENOENT if the entry is known not to exist,
+   and ENODATA if nothing valid is cached. */
 int cgfs_cache_lookup_child(cgfs_cache * this,
                             uint64_t parent_ino,
                             char const * name,
                             cgfs_inode ** out);
 
+/* An ino of 0 records a negative entry. */
+void cgfs_cache_add_child(cgfs_cache * this,
+                          uint64_t parent_ino,
+                          char const * name,
+                          uint64_t ino);
+
+/* Also bumps the generation of the parent directory */
+void cgfs_cache_remove_child(cgfs_cache * this,
+                             uint64_t parent_ino,
+                             char const * name);
+
+/* To be read before sending a lookup or a readdir page, and passed to
+   cgfs_cache_add_lookup_child() when the reply arrives. */
+uint64_t cgfs_cache_get_dir_generation(cgfs_cache * this,
+                                       uint64_t parent_ino);
+
+/* Same as cgfs_cache_add_child(), but does nothing if an entry
+   of the parent has been removed since dir_generation was read,
+   since the reply may predate that change. */
+void cgfs_cache_add_lookup_child(cgfs_cache * this,
+                                 uint64_t parent_ino,
+                                 char const * name,
+                                 uint64_t ino,
+                                 uint64_t dir_generation);
+
 int cgfs_cache_remove(cgfs_cache * this,
                       uint64_t ino);
 
@@ -44,7 +103,19 @@ int cgfs_cache_lookup(cgfs_cache * this,
                       uint64_t ino,
                       cgfs_inode ** out);
 
+/* If an inode with the same number is already cached, *inode is
+   released and replaced by the cached one, with a reference taken,
+   and EEXIST is returned. */
 int cgfs_cache_add(cgfs_cache * this,
-                   cgfs_inode * inode);
+                   cgfs_inode ** inode);
+
+/* To be called when the kernel lookup count
+   of a cached inode drops down to 0. Does nothing if
+   it has been looked up again in the meantime. */
+void cgfs_cache_forget(cgfs_cache * this,
+                       cgfs_inode * inode);
+
+void cgfs_cache_get_stats(cgfs_cache * this,
+                          cgfs_cache_stats * stats);
 
 #endif /* CGFS_CACHE_H_ */
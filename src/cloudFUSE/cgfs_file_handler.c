@@ -28,7 +28,6 @@
 #include <cgfs_utils.h>
 
 #include <cloudutils/cloudutils_file.h>
-#include <cloudutils/cloudutils_htable.h>
 
 struct cgfs_file_handler
 {
@@ -37,14 +36,21 @@ struct cgfs_file_handler
     {
         struct
         {
-            cgutils_htable * index;
+            /* current batch of entries */
             cgsmc_async_entry * entries;
             size_t entries_count;
+            /* position of the first entry of the batch
+               in the directory stream */
+            size_t first_offset;
+            /* where the next batch starts,
+               0 if this one is the last */
+            uint64_t next_cursor;
         } dir;
         struct
         {
             int fd;
             int flags;
+            /* set and read from any FUSE thread */
             bool dirty;
         } file;
     };
@@ -94,20 +100,53 @@ int  cgfs_file_handler_create_fd(int const fd,
         (*out)->file.flags = flags;
         (*out)->inode = inode;
         cgfs_inode_inc_ref_count(inode);
+
+        if (cgfs_utils_writable_flags(flags) == true)
+        {
+            COMPILER_SYNC_ADD_AND_FETCH(&(inode->writers), 1);
+        }
     }
 
     return result;
 }
 
+static void cgfs_file_handler_dir_clean_entries(cgfs_file_handler * const this)
+{
+    CGUTILS_ASSERT(this != NULL);
+    CGUTILS_ASSERT(this->type == cgfs_file_handler_type_dir);
+
+    if (this->dir.entries != NULL)
+    {
+        for (size_t idx = 0;
+             idx < this->dir.entries_count;
+             idx++)
+        {
+            cgfs_inode * inode = this->dir.entries[idx].data;
+
+            if (inode != NULL)
+            {
+                cgfs_inode_release(inode), inode = NULL;
+            }
+
+            cgsmc_async_entry_clean(&(this->dir.entries[idx]));
+        }
+    }
+
+    CGUTILS_FREE(this->dir.entries);
+    this->dir.entries_count = 0;
+}
+
 void cgfs_file_handler_free(cgfs_file_handler * this)
 {
     if (this != NULL)
     {
         if (this->inode != NULL)
         {
-            if (this->inode->dir_fh == this)
+            if (this->type == cgfs_file_handler_type_file &&
+                cgfs_utils_writable_flags(this->file.flags) == true)
             {
-                this->inode->dir_fh = NULL;
+                CGUTILS_ASSERT(this->inode->writers > 0);
+                COMPILER_SYNC_SUB_AND_FETCH(&(this->inode->writers), 1);
             }
 
             cgfs_inode_release(this->inode), this->inode = NULL;
@@ -124,30 +163,7 @@ void cgfs_file_handler_free(cgfs_file_handler * this)
         }
         else if (this->type == cgfs_file_handler_type_dir)
         {
-            if (this->dir.index != NULL)
-            {
-                cgutils_htable_free(&(this->dir.index), NULL);
-            }
-
-            if (this->dir.entries != NULL)
-            {
-                for (size_t idx = 0;
-                     idx < this->dir.entries_count;
-                     idx++)
-                {
-                    cgfs_inode * inode = this->dir.entries[idx].data;
-
-                    if (inode != NULL)
-                    {
-                        cgfs_inode_release(inode), inode = NULL;
-                    }
-
-                    cgsmc_async_entry_clean(&(this->dir.entries[idx]));
-                }
-            }
-
-            CGUTILS_FREE(this->dir.entries);
-            this->dir.entries_count = 0;
+            cgfs_file_handler_dir_clean_entries(this);
         }
 
         this->type = cgfs_file_handler_type_none;
@@ -331,10 +347,11 @@ bool cgfs_file_handler_file_need_to_notify_write(cgfs_data * const data,
     CGUTILS_ASSERT(this->type == cgfs_file_handler_type_file);
     CGUTILS_ASSERT(cgfs_utils_writable_flags(this->file.flags) == true);
 
-    if (cgfs_inode_has_been_deleted(this->inode) == false)
+    if (cgfs_inode_has_been_deleted(this->inode) == false &&
+        cgfs_inode_is_dirty_notification_queued(this->inode) == false)
     {
         time_t const now = time(NULL);
-        double const elapsed = difftime(now, this->inode->last_dirtyness_notification);
+        double const elapsed = difftime(now, cgfs_inode_get_last_dirty_notification(this->inode));
 
         if (COMPILER_LIKELY(elapsed >= 0))
         {
@@ -370,11 +387,8 @@ int cgfs_file_handler_file_refresh_inode_attributes_from_fd(cgfs_file_handler *
 
         if (COMPILER_LIKELY(result == 0))
         {
-            struct stat * inode_st = &(this->inode->attr);
-            inode_st->st_atime = st.st_atime;
-            inode_st->st_mtime = st.st_mtime;
-            inode_st->st_ctime = st.st_ctime;
-            inode_st->st_size = st.st_size;
+            cgfs_inode_set_content_attributes(this->inode,
+                                              &st);
         }
         else
         {
@@ -424,7 +438,7 @@ void cgfs_file_handler_file_set_dirty(cgfs_file_handler * const this)
     CGUTILS_ASSERT(this != NULL);
     CGUTILS_ASSERT(this->type == cgfs_file_handler_type_file);
 
-    this->file.dirty = true;
+    COMPILER_SYNC_BOOL_COMPARE_AND_SWAP(&(this->file.dirty), false, true);
 }
 
 bool cgfs_file_handler_file_is_dirty(cgfs_file_handler const * const this)
@@ -432,20 +446,16 @@ bool cgfs_file_handler_file_is_dirty(cgfs_file_handler const * const this)
     CGUTILS_ASSERT(this != NULL);
     CGUTILS_ASSERT(this->type == cgfs_file_handler_type_file);
 
-    return this->file.dirty;
+    /* atomic read */
+    return COMPILER_SYNC_BOOL_COMPARE_AND_SWAP((bool *) &(this->file.dirty), true, true);
 }
 
 
 /* DIR */
 
-int  cgfs_file_handler_create_dir(cgsmc_async_entry * const entries,
-                                  size_t const entries_count,
-                                  bool const use_dir_index,
-                                  cgfs_inode * const inode,
+int  cgfs_file_handler_create_dir(cgfs_inode * const inode,
                                   cgfs_file_handler ** const out)
 {
-    CGUTILS_ASSERT(entries != NULL ||
-                   entries_count == 0);
     CGUTILS_ASSERT(out != NULL);
 
     int result = cgfs_file_handler_create(cgfs_file_handler_type_dir,
@@ -453,51 +463,36 @@ int  cgfs_file_handler_create_dir(cgsmc_async_entry * const entries,
 
     if (COMPILER_LIKELY(result == 0))
     {
-        (*out)->dir.entries = entries;
-        (*out)->dir.entries_count = entries_count;
         (*out)->inode = inode;
-        cgfs_inode_inc_ref_count(inode);
 
-        if (use_dir_index == true)
+        if (inode != NULL)
         {
-            CGUTILS_DEBUG("Using index (%zu)",
-                          entries_count);
-
-            result = cgutils_htable_create(&((*out)->dir.index),
-                                           entries_count);
-
-            if (COMPILER_LIKELY(result == 0))
-            {
-                cgutils_htable * table = (*out)->dir.index;
-
-                for (size_t idx = 0;
-                     result == 0 &&
-                         idx < entries_count;
-                     idx++)
-                {
-                    result = cgutils_htable_insert(table,
-                                                   entries[idx].name,
-                                                   &(entries[idx]));
-
-                    if (COMPILER_UNLIKELY(result != 0))
-                    {
-                        CGUTILS_ERROR("Error inserting entry %s: %d",
-                                      entries[idx].name,
-                                      result);
-                    }
-                }
-            }
-        }
-
-        if (COMPILER_UNLIKELY(result != 0))
-        {
-            cgfs_file_handler_free(*out), *out = NULL;
+            cgfs_inode_inc_ref_count(inode);
         }
     }
 
     return result;
 }
 
+void cgfs_file_handler_dir_set_entries(cgfs_file_handler * const this,
+                                       cgsmc_async_entry * const entries,
+                                       size_t const entries_count,
+                                       size_t const first_offset,
+                                       uint64_t const next_cursor)
+{
+    CGUTILS_ASSERT(this != NULL);
+    CGUTILS_ASSERT(this->type == cgfs_file_handler_type_dir);
+    CGUTILS_ASSERT(entries != NULL ||
+                   entries_count == 0);
+
+    cgfs_file_handler_dir_clean_entries(this);
+
+    this->dir.entries = entries;
+    this->dir.entries_count = entries_count;
+    this->dir.first_offset = first_offset;
+    this->dir.next_cursor = next_cursor;
+}
+
 size_t cgfs_file_handler_dir_get_entries_count(cgfs_file_handler const * const this)
 {
     CGUTILS_ASSERT(this != NULL);
@@ -512,53 +507,16 @@ cgsmc_async_entry * cgfs_file_handler_dir_get_entries(cgfs_file_handler const *
     return this->dir.entries;
 }
 
-int cgfs_file_handler_dir_get_child_ino(cgfs_file_handler const * const this,
-                                        char const * const name,
-                                        uint64_t * const out)
+size_t cgfs_file_handler_dir_get_first_offset(cgfs_file_handler const * const this)
 {
-    int result = ENOENT;
-    cgsmc_async_entry const * entry = NULL;
     CGUTILS_ASSERT(this != NULL);
     CGUTILS_ASSERT(this->type == cgfs_file_handler_type_dir);
-    CGUTILS_ASSERT(name != NULL);
-    CGUTILS_ASSERT(out != NULL);
-
-    if (this->dir.index != NULL)
-    {
-        void * ptr = NULL;
-
-        result = cgutils_htable_get(this->dir.index,
-                                    name,
-                                    &ptr);
-
-        if (COMPILER_LIKELY(result == 0))
-        {
-            entry = ptr;
-        }
-    }
-    else
-    {
-        size_t const name_len = strlen(name);
-
-        for (size_t idx = 0;
-             result == ENOENT &&
-                 idx < this->dir.entries_count;
-             idx++)
-        {
-            entry = &(this->dir.entries[idx]);
-
-            if (COMPILER_UNLIKELY(entry->name_len == name_len &&
-                                  strcmp(entry->name, name) == 0))
-            {
-                result = 0;
-            }
-        }
-    }
-
-    if (COMPILER_LIKELY(result == 0))
-    {
-        *out = entry->st.st_ino;
-    }
+    return this->dir.first_offset;
+}
 
-    return result;
+uint64_t cgfs_file_handler_dir_get_next_cursor(cgfs_file_handler const * const this)
+{
+    CGUTILS_ASSERT(this != NULL);
+    CGUTILS_ASSERT(this->type == cgfs_file_handler_type_dir);
+    return this->dir.next_cursor;
 }
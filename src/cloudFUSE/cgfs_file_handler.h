@@ -45,10 +45,7 @@ int  cgfs_file_handler_create_fd(int fd,
                                  cgfs_inode * inode,
                                  cgfs_file_handler ** out);
 
-int  cgfs_file_handler_create_dir(cgsmc_async_entry * entries,
-                                  size_t entries_count,
-                                  bool use_dir_index,
-                                  cgfs_inode * inode,
+int  cgfs_file_handler_create_dir(cgfs_inode * inode,
                                   cgfs_file_handler ** out);
 
 void cgfs_file_handler_free(cgfs_file_handler * this);
@@ -94,12 +91,19 @@ bool cgfs_file_handler_file_is_dirty(cgfs_file_handler const * fh);
 
 /* DIR */
 
+/* Replaces the current batch of entries, the handler takes ownership of entries */
+void cgfs_file_handler_dir_set_entries(cgfs_file_handler * fh,
+                                       cgsmc_async_entry * entries,
+                                       size_t entries_count,
+                                       size_t first_offset,
+                                       uint64_t next_cursor);
+
 size_t cgfs_file_handler_dir_get_entries_count(cgfs_file_handler const * fh);
 
 cgsmc_async_entry * cgfs_file_handler_dir_get_entries(cgfs_file_handler const * fh);
 
-int cgfs_file_handler_dir_get_child_ino(cgfs_file_handler const * fh,
-                                        char const * name,
-                                        uint64_t * ino);
+size_t cgfs_file_handler_dir_get_first_offset(cgfs_file_handler const * fh);
+
+uint64_t cgfs_file_handler_dir_get_next_cursor(cgfs_file_handler const * fh);
 
 #endif /* CGFS_FILE_HANDLER_H_ */
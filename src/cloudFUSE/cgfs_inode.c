@@ -39,6 +39,7 @@ int cgfs_inode_init(struct stat const * const st,
 
     if (this != NULL)
     {
+        pthread_mutex_init(&(this->lock), NULL);
         this->ref_count = 1;
         this->attr = *st;
         *out = this;
@@ -56,11 +57,15 @@ static void cgfs_inode_free(cgfs_inode * this)
     if (this != NULL)
     {
         CGUTILS_ASSERT(this->ref_count == 0);
-/*        CGUTILS_ASSERT(this->lru_next == NULL);
+        CGUTILS_ASSERT(this->lru == cgfs_inode_lru_none);
+        CGUTILS_ASSERT(this->lru_next == NULL);
         CGUTILS_ASSERT(this->lru_prev == NULL);
+        CGUTILS_ASSERT(this->hash_next == NULL);
         this->lru_next = NULL;
-        this->lru_prev = NULL;*/
+        this->lru_prev = NULL;
+        this->hash_next = NULL;
         this->lookup_count = 0;
+        pthread_mutex_destroy(&(this->lock));
         CGUTILS_FREE(this);
     }
 }
@@ -70,20 +75,127 @@ void cgfs_inode_release(cgfs_inode * const this)
     if (this != NULL)
     {
         CGUTILS_ASSERT(this->ref_count > 0);
-        this->ref_count--;
 
-        if (this->ref_count == 0)
+        /* Inodes may be shared between threads, see cgfs_cache. */
+        if (COMPILER_SYNC_SUB_AND_FETCH(&(this->ref_count), 1) == 0)
         {
             cgfs_inode_free(this);
         }
     }
 }
 
-bool cgfs_inode_is_dir(cgfs_inode const * const this)
+bool cgfs_inode_refresh_attributes(cgfs_inode * const this,
+                                   struct stat const * const st)
 {
+    bool result = false;
     CGUTILS_ASSERT(this != NULL);
+    CGUTILS_ASSERT(st != NULL);
+
+    pthread_mutex_lock(&(this->lock));
+
+    /* While the file is being written to locally, our attributes
+       are more recent than the ones of the storage manager. */
+    if (S_ISREG(this->attr.st_mode) &&
+        cgfs_inode_get_writers(this) == 0)
+    {
+        if (this->attr.st_mtime != st->st_mtime ||
+            this->attr.st_size != st->st_size)
+        {
+            this->attr = *st;
+            this->generation++;
+            result = true;
+        }
+    }
+
+    pthread_mutex_unlock(&(this->lock));
+
+    return result;
+}
+
+bool cgfs_inode_is_dir(cgfs_inode * const this)
+{
+    CGUTILS_ASSERT(this != NULL);
+
+    pthread_mutex_lock(&(this->lock));
+    bool const result = S_ISDIR(this->attr.st_mode);
+    pthread_mutex_unlock(&(this->lock));
+
+    return result;
+}
+
+void cgfs_inode_get_attributes(cgfs_inode * const this,
+                               struct stat * const out)
+{
+    CGUTILS_ASSERT(this != NULL);
+    CGUTILS_ASSERT(out != NULL);
+
+    pthread_mutex_lock(&(this->lock));
+    *out = this->attr;
+    pthread_mutex_unlock(&(this->lock));
+}
 
-    return S_ISDIR(this->attr.st_mode);
+time_t cgfs_inode_get_last_change(cgfs_inode * const this)
+{
+    CGUTILS_ASSERT(this != NULL);
+
+    pthread_mutex_lock(&(this->lock));
+    time_t const result = this->attr.st_mtime > this->attr.st_ctime ? this->attr.st_mtime : this->attr.st_ctime;
+    pthread_mutex_unlock(&(this->lock));
+
+    return result;
+}
+
+uint64_t cgfs_inode_get_generation(cgfs_inode * const this)
+{
+    CGUTILS_ASSERT(this != NULL);
+
+    pthread_mutex_lock(&(this->lock));
+    uint64_t const result = this->generation;
+    pthread_mutex_unlock(&(this->lock));
+
+    return result;
+}
+
+time_t cgfs_inode_get_last_dirty_notification(cgfs_inode * const this)
+{
+    CGUTILS_ASSERT(this != NULL);
+
+    pthread_mutex_lock(&(this->lock));
+    time_t const result = this->last_dirtyness_notification;
+    pthread_mutex_unlock(&(this->lock));
+
+    return result;
+}
+
+void cgfs_inode_set_content_attributes(cgfs_inode * const this,
+                                       struct stat const * const st)
+{
+    CGUTILS_ASSERT(this != NULL);
+    CGUTILS_ASSERT(st != NULL);
+
+    pthread_mutex_lock(&(this->lock));
+    this->attr.st_atime = st->st_atime;
+    this->attr.st_mtime = st->st_mtime;
+    this->attr.st_ctime = st->st_ctime;
+    this->attr.st_size = st->st_size;
+    pthread_mutex_unlock(&(this->lock));
+}
+
+void cgfs_inode_touch(cgfs_inode * const this)
+{
+    CGUTILS_ASSERT(this != NULL);
+    time_t const now = time(NULL);
+
+    pthread_mutex_lock(&(this->lock));
+
+    if (difftime(now, this->attr.st_mtime) > 0)
+    {
+        this->attr.st_mtime = now;
+    }
+
+    this->attr.st_ctime = now;
+
+    pthread_mutex_unlock(&(this->lock));
 }
 
 void cgfs_inode_update_attributes(cgfs_inode * const this,
@@ -92,6 +204,9 @@ void cgfs_inode_update_attributes(cgfs_inode * const this,
 {
     CGUTILS_ASSERT(this != NULL);
     CGUTILS_ASSERT(attr != NULL);
+    time_t const now = time(NULL);
+
+    pthread_mutex_lock(&(this->lock));
 
     if (cgfs_to_set & CGFS_SET_ATTR_MODE)
     {
@@ -111,33 +226,33 @@ void cgfs_inode_update_attributes(cgfs_inode * const this,
     if (cgfs_to_set & CGFS_SET_ATTR_SIZE)
     {
         this->attr.st_size = attr->st_size;
-        cgfs_inode_update_mtime(this,
-                                time(NULL));
+        this->attr.st_mtime = now;
+        this->attr.st_ctime = now;
     }
 
     if (cgfs_to_set & CGFS_SET_ATTR_ATIME)
     {
         this->attr.st_atime = attr->st_atime;
-        cgfs_inode_update_ctime(this);
+        this->attr.st_ctime = now;
     }
 
     if (cgfs_to_set & CGFS_SET_ATTR_MTIME)
     {
         this->attr.st_mtime = attr->st_mtime;
-        cgfs_inode_update_ctime(this);
+        this->attr.st_ctime = now;
     }
 
     if (cgfs_to_set & CGFS_SET_ATTR_ATIME_NOW)
     {
-        time_t const now = time(NULL);
         this->attr.st_atime = now;
-        cgfs_inode_update_ctime(this);
+        this->attr.st_ctime = now;
     }
 
     if (cgfs_to_set & CGFS_SET_ATTR_MTIME_NOW)
     {
-        time_t const now = time(NULL);
         this->attr.st_mtime = now;
-        cgfs_inode_update_ctime(this);
+        this->attr.st_ctime = now;
     }
+
+    pthread_mutex_unlock(&(this->lock));
 }
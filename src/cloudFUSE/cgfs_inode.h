@@ -24,6 +24,7 @@
 #ifndef CGFS_INODE_H_
 #define CGFS_INODE_H_
 
+#include <pthread.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <sys/stat.h>
@@ -31,16 +32,28 @@
 
 typedef struct cgfs_inode cgfs_inode;
 
+typedef enum
+{
+    cgfs_inode_lru_none = 0,
+    cgfs_inode_lru_active,
+    cgfs_inode_lru_inactive
+} cgfs_inode_lru;
+
 #include <cgfs_file_handler.h>
 
 struct cgfs_inode
 {
+    /* With several FUSE threads, requests on the same inode may be
+       handled concurrently: lock protects attr, generation,
+       kernel_generation and last_dirtyness_notification.
+       st_ino never changes and may be read without it. */
+    pthread_mutex_t lock;
     struct stat attr;
-//    cgfs_inode * lru_prev;
-//    cgfs_inode * lru_next;
-    /* contains a pointer to a dir FH
-       for this inode, used to speed up lookup during readdir */
-    cgfs_file_handler * dir_fh;
+    /* Intrusive links owned by the inode cache:
+       hash bucket chaining and segmented LRU. */
+    cgfs_inode * hash_next;
+    cgfs_inode * lru_prev;
+    cgfs_inode * lru_next;
 
     /* number of kernel references
        to this inode number. */
@@ -48,7 +61,21 @@ struct cgfs_inode
     /* number of references to this struct
        in memory */
     uint64_t ref_count;
+    /* Bumped each time the storage manager reports a content
+       (mtime, size) we did not write ourselves. */
+    uint64_t generation;
+    /* generation of the content the kernel may have
+       in its page cache, as of the last open */
+    uint64_t kernel_generation;
+    /* number of file handlers opened for writing,
+       updated atomically rather than under lock */
+    uint64_t writers;
     time_t last_dirtyness_notification;
+    /* set while a write notification is waiting to be sent
+       in a batch, by any thread */
+    bool dirty_notification_queued;
+    /* which LRU list, if any, this inode is in */
+    cgfs_inode_lru lru;
 };
 
 #include <cloudutils/cloudutils.h>
@@ -56,12 +83,36 @@ struct cgfs_inode
 int cgfs_inode_init(struct stat const * st,
                     cgfs_inode ** out);
 
-bool cgfs_inode_is_dir(cgfs_inode const * this);
+bool cgfs_inode_is_dir(cgfs_inode * this);
+
+void cgfs_inode_get_attributes(cgfs_inode * this,
+                               struct stat * out);
+
+/* Most recent of mtime and ctime */
+time_t cgfs_inode_get_last_change(cgfs_inode * this);
+
+uint64_t cgfs_inode_get_generation(cgfs_inode * this);
+
+time_t cgfs_inode_get_last_dirty_notification(cgfs_inode * this);
+
+/* Sets the times and size from the ones of the file in cache */
+void cgfs_inode_set_content_attributes(cgfs_inode * this,
+                                       struct stat const * st);
+
+/* Sets ctime to now, and mtime too unless it is in the future */
+void cgfs_inode_touch(cgfs_inode * this);
 
 void cgfs_inode_update_attributes(cgfs_inode * this,
                                   struct stat const * attr,
                                   int cgfs_to_set);
 
+/* Updates the attributes of a regular file from the ones returned
+   by the storage manager. Returns true if the content has been
+   changed from outside of this mount since we last asked, which
+   is the only way we have to detect it. */
+bool cgfs_inode_refresh_attributes(cgfs_inode * this,
+                                   struct stat const * st);
+
 void cgfs_inode_release(cgfs_inode * inode);
 
 static inline uint64_t cgfs_inode_get_number(cgfs_inode const * const this)
@@ -79,33 +130,41 @@ static inline uint64_t cgfs_inode_get_number(cgfs_inode const * const this)
 static inline void cgfs_inode_inc_ref_count(cgfs_inode * const this)
 {
     CGUTILS_ASSERT(this != NULL);
-    this->ref_count++;
+    COMPILER_SYNC_ADD_AND_FETCH(&(this->ref_count), 1);
 }
 #endif /* NDEBUG */
 
 static inline void cgfs_inode_inc_lookup_count(cgfs_inode * const this)
 {
     CGUTILS_ASSERT(this != NULL);
-    this->lookup_count++;
+    COMPILER_SYNC_ADD_AND_FETCH(&(this->lookup_count), 1);
 }
 
 static inline void cgfs_inode_dec_lookup_count(cgfs_inode * const this,
                                                size_t const lookup_count)
 {
     CGUTILS_ASSERT(this != NULL);
+    uint64_t current = 0;
+    uint64_t wanted = 0;
 
-    if (COMPILER_LIKELY(this->lookup_count >= lookup_count))
+    do
     {
-        this->lookup_count -= lookup_count;
-    }
-    else
-    {
-        CGUTILS_WARN("Warning, decrementing lookup count of inode %"PRIu64" of more than the existing count (%zu / %zu)",
-                     cgfs_inode_get_number(this),
-                     lookup_count,
-                     this->lookup_count);
-        this->lookup_count = 0;
+        current = this->lookup_count;
+
+        if (COMPILER_LIKELY(current >= lookup_count))
+        {
+            wanted = current - lookup_count;
+        }
+        else
+        {
+            CGUTILS_WARN("Warning, decrementing lookup count of inode %"PRIu64" of more than the existing count (%zu / %zu)",
+                         cgfs_inode_get_number(this),
+                         lookup_count,
+                         current);
+            wanted = 0;
+        }
     }
+    while (COMPILER_SYNC_BOOL_COMPARE_AND_SWAP(&(this->lookup_count), current, wanted) == false);
 }
 
 static inline size_t cgfs_inode_get_lookup_count(cgfs_inode const * const this)
@@ -120,59 +179,111 @@ static inline size_t cgfs_inode_get_ref_count(cgfs_inode const * const this)
     return this->ref_count;
 }
 
+static inline uint64_t cgfs_inode_get_writers(cgfs_inode * const this)
+{
+    CGUTILS_ASSERT(this != NULL);
+    return COMPILER_ATOMIC_LOAD(&(this->writers));
+}
+
 static inline void cgfs_inode_update_ctime(cgfs_inode * const this)
 {
     CGUTILS_ASSERT(this != NULL);
+    pthread_mutex_lock(&(this->lock));
     this->attr.st_ctime = time(NULL);
+    pthread_mutex_unlock(&(this->lock));
 }
 
 static inline void cgfs_inode_update_atime(cgfs_inode * const this,
                                            time_t const atime)
 {
     CGUTILS_ASSERT(this != NULL);
+    pthread_mutex_lock(&(this->lock));
     this->attr.st_atime = atime;
-    cgfs_inode_update_ctime(this);
+    this->attr.st_ctime = time(NULL);
+    pthread_mutex_unlock(&(this->lock));
 }
 
 static inline void cgfs_inode_update_mtime(cgfs_inode * const this,
                                            time_t const mtime)
 {
     CGUTILS_ASSERT(this != NULL);
+    pthread_mutex_lock(&(this->lock));
     this->attr.st_mtime = mtime;
-    cgfs_inode_update_ctime(this);
+    this->attr.st_ctime = time(NULL);
+    pthread_mutex_unlock(&(this->lock));
 }
 
 static inline void cgfs_inode_decrement_link_count(cgfs_inode * const this)
 {
     CGUTILS_ASSERT(this != NULL);
+    pthread_mutex_lock(&(this->lock));
     CGUTILS_ASSERT(this->attr.st_nlink > 0);
     this->attr.st_nlink--;
-    cgfs_inode_update_ctime(this);
+    this->attr.st_ctime = time(NULL);
+    pthread_mutex_unlock(&(this->lock));
 }
 
 static inline void cgfs_inode_increment_link_count(cgfs_inode * const this)
 {
     CGUTILS_ASSERT(this != NULL);
+    pthread_mutex_lock(&(this->lock));
     this->attr.st_nlink++;
-    cgfs_inode_update_ctime(this);
+    this->attr.st_ctime = time(NULL);
+    pthread_mutex_unlock(&(this->lock));
 }
 
-static inline bool cgfs_inode_has_been_deleted(cgfs_inode const * const this)
+static inline bool cgfs_inode_has_been_deleted(cgfs_inode * const this)
 {
     CGUTILS_ASSERT(this != NULL);
-    return this->attr.st_nlink == 0;
+    pthread_mutex_lock(&(this->lock));
+    bool const result = this->attr.st_nlink == 0;
+    pthread_mutex_unlock(&(this->lock));
+
+    return result;
+}
+
+/* Returns true if the content the kernel may have cached
+   for this inode is still valid, then records the current
+   generation as the one cached by the kernel. */
+static inline bool cgfs_inode_check_kernel_cache(cgfs_inode * const this)
+{
+    CGUTILS_ASSERT(this != NULL);
+    pthread_mutex_lock(&(this->lock));
+    bool const result = this->kernel_generation == this->generation;
+
+    this->kernel_generation = this->generation;
+    pthread_mutex_unlock(&(this->lock));
+
+    return result;
 }
 
 static inline void cgfs_inode_update_dirty_notification(cgfs_inode * const this)
 {
     CGUTILS_ASSERT(this != NULL);
+    pthread_mutex_lock(&(this->lock));
     this->last_dirtyness_notification = time(NULL);
+    pthread_mutex_unlock(&(this->lock));
+}
+
+static inline bool cgfs_inode_is_dirty_notification_queued(cgfs_inode const * const this)
+{
+    CGUTILS_ASSERT(this != NULL);
+    return this->dirty_notification_queued;
+}
+
+/* Returns true if the notification was not already queued */
+static inline bool cgfs_inode_queue_dirty_notification(cgfs_inode * const this)
+{
+    CGUTILS_ASSERT(this != NULL);
+    return COMPILER_SYNC_BOOL_COMPARE_AND_SWAP(&(this->dirty_notification_queued), false, true);
 }
 
-static inline cgfs_file_handler * cgfs_inode_get_dir_file_handler(cgfs_inode const * const this)
+/* Returns true if the notification was still queued,
+   in which case the caller is now in charge of it */
+static inline bool cgfs_inode_unqueue_dirty_notification(cgfs_inode * const this)
 {
     CGUTILS_ASSERT(this != NULL);
-    return this->dir_fh;
+    return COMPILER_SYNC_BOOL_COMPARE_AND_SWAP(&(this->dirty_notification_queued), true, false);
 }
 
 #endif /* CGFS_INODE_H_ */
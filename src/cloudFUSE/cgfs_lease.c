@@ -0,0 +1,356 @@
+/*
+ * This file is part of Nuage Labs SAS's Cloud Gateway.
+ *
+ * Copyright (C) 2011-2017  Nuage Labs SAS
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * In addition, for the avoidance of any doubt, permission is granted to
+ * link this program with OpenSSL and to (re)distribute the binaries
+ * produced as the result of such linking.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <time.h>
+
+#include <cloudutils/cloudutils.h>
+#include <cloudutils/cloudutils_file.h>
+#include <cloudutils/cloudutils_htable.h>
+
+#include "cgfs_lease.h"
+
+#define CGFS_LEASE_KEY_SIZE (sizeof "18446744073709551615")
+
+typedef struct cgfs_lease cgfs_lease;
+
+struct cgfs_lease
+{
+    /* ordered by expiration, soonest first */
+    cgfs_lease * previous;
+    cgfs_lease * next;
+    char key[CGFS_LEASE_KEY_SIZE];
+    uint64_t generation;
+    /* monotonic, in ms */
+    uint64_t expires;
+    int flags;
+    int fd;
+};
+
+struct cgfs_lease_table
+{
+    /* inode number => cgfs_lease * */
+    cgutils_htable * leases;
+    cgfs_lease * first;
+    cgfs_lease * last;
+    size_t leases_count;
+    size_t max_leases;
+};
+
+static uint64_t cgfs_lease_now(void)
+{
+    struct timespec ts = { 0 };
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint64_t) ts.tv_sec * 1000) + ((uint64_t) ts.tv_nsec / (1000 * 1000));
+}
+
+static int cgfs_lease_dup(int const fd,
+                          int * const out)
+{
+    int result = 0;
+    CGUTILS_ASSERT(fd != -1);
+    CGUTILS_ASSERT(out != NULL);
+
+    /* shares the shared lock taken on the file in cache,
+       which keeps the cache cleaner away from it */
+    *out = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+
+    if (COMPILER_UNLIKELY(*out == -1))
+    {
+        result = errno;
+    }
+
+    return result;
+}
+
+static void cgfs_lease_remove(cgfs_lease_table * const this,
+                              cgfs_lease * lease)
+{
+    CGUTILS_ASSERT(this != NULL);
+    CGUTILS_ASSERT(lease != NULL);
+    CGUTILS_ASSERT(this->leases_count > 0);
+
+    int const result = cgutils_htable_remove(this->leases,
+                                             lease->key);
+    CGUTILS_ASSERT(result == 0);
+    (void) result;
+
+    if (lease->previous != NULL)
+    {
+        lease->previous->next = lease->next;
+    }
+    else
+    {
+        this->first = lease->next;
+    }
+
+    if (lease->next != NULL)
+    {
+        lease->next->previous = lease->previous;
+    }
+    else
+    {
+        this->last = lease->previous;
+    }
+
+    this->leases_count--;
+
+    cgutils_file_close(lease->fd), lease->fd = -1;
+    CGUTILS_FREE(lease);
+}
+
+static void cgfs_lease_insert_ordered(cgfs_lease_table * const this,
+                                      cgfs_lease * const lease)
+{
+    CGUTILS_ASSERT(this != NULL);
+    CGUTILS_ASSERT(lease != NULL);
+
+    /* almost always appended, leases having the same duration */
+    cgfs_lease * previous = this->last;
+
+    while (previous != NULL &&
+           previous->expires > lease->expires)
+    {
+        previous = previous->previous;
+    }
+
+    lease->previous = previous;
+    lease->next = previous != NULL ? previous->next : this->first;
+
+    if (lease->next != NULL)
+    {
+        lease->next->previous = lease;
+    }
+    else
+    {
+        this->last = lease;
+    }
+
+    if (previous != NULL)
+    {
+        previous->next = lease;
+    }
+    else
+    {
+        this->first = lease;
+    }
+}
+
+int cgfs_lease_table_init(size_t const max_leases,
+                          cgfs_lease_table ** const out)
+{
+    int result = 0;
+    cgfs_lease_table * this = NULL;
+    CGUTILS_ASSERT(max_leases > 0);
+    CGUTILS_ASSERT(out != NULL);
+
+    CGUTILS_ALLOCATE_STRUCT(this);
+
+    if (COMPILER_LIKELY(this != NULL))
+    {
+        this->max_leases = max_leases;
+
+        result = cgutils_htable_create(&(this->leases),
+                                       max_leases);
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            *out = this;
+        }
+        else
+        {
+            CGUTILS_ERROR("Error creating lease table: %d", result);
+            CGUTILS_FREE(this);
+        }
+    }
+    else
+    {
+        result = ENOMEM;
+    }
+
+    return result;
+}
+
+void cgfs_lease_table_free(cgfs_lease_table * this)
+{
+    if (this != NULL)
+    {
+        while (this->first != NULL)
+        {
+            cgfs_lease_remove(this, this->first);
+        }
+
+        cgutils_htable_free(&(this->leases), NULL);
+        CGUTILS_FREE(this);
+    }
+}
+
+int cgfs_lease_table_add(cgfs_lease_table * const this,
+                         cgfs_inode * const inode,
+                         int const flags,
+                         int const fd,
+                         uint32_t const duration)
+{
+    int result = 0;
+    cgfs_lease * lease = NULL;
+    CGUTILS_ASSERT(this != NULL);
+    CGUTILS_ASSERT(inode != NULL);
+    CGUTILS_ASSERT(fd != -1);
+    CGUTILS_ASSERT(duration > 0);
+
+    CGUTILS_ALLOCATE_STRUCT(lease);
+
+    if (COMPILER_LIKELY(lease != NULL))
+    {
+        void * existing = NULL;
+
+        snprintf(lease->key, sizeof lease->key, "%"PRIu64, cgfs_inode_get_number(inode));
+        lease->generation = cgfs_inode_get_generation(inode);
+        lease->expires = cgfs_lease_now() + duration;
+        lease->flags = flags;
+
+        result = cgfs_lease_dup(fd,
+                                &(lease->fd));
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            if (cgutils_htable_get(this->leases, lease->key, &existing) == 0)
+            {
+                cgfs_lease_remove(this, existing);
+            }
+            else if (this->leases_count >= this->max_leases)
+            {
+                cgfs_lease_remove(this, this->first);
+            }
+
+            result = cgutils_htable_insert(this->leases,
+                                           lease->key,
+                                           lease);
+
+            if (COMPILER_LIKELY(result == 0))
+            {
+                cgfs_lease_insert_ordered(this, lease);
+                this->leases_count++;
+                lease = NULL;
+            }
+            else
+            {
+                CGUTILS_ERROR("Error inserting lease for inode %s: %d",
+                              lease->key,
+                              result);
+            }
+
+            if (lease != NULL)
+            {
+                cgutils_file_close(lease->fd), lease->fd = -1;
+            }
+        }
+        else
+        {
+            CGUTILS_WARN("Error duplicating descriptor for inode %s: %d",
+                         lease->key,
+                         result);
+        }
+
+        CGUTILS_FREE(lease);
+    }
+    else
+    {
+        result = ENOMEM;
+    }
+
+    return result;
+}
+
+int cgfs_lease_table_get(cgfs_lease_table * const this,
+                         cgfs_inode * const inode,
+                         int const flags,
+                         int * const fd)
+{
+    int result = ENOENT;
+    char key[CGFS_LEASE_KEY_SIZE];
+    void * value = NULL;
+    CGUTILS_ASSERT(this != NULL);
+    CGUTILS_ASSERT(inode != NULL);
+    CGUTILS_ASSERT(fd != NULL);
+
+    snprintf(key, sizeof key, "%"PRIu64, cgfs_inode_get_number(inode));
+
+    if (cgutils_htable_get(this->leases, key, &value) == 0)
+    {
+        cgfs_lease * const lease = value;
+        CGUTILS_ASSERT(lease != NULL);
+
+        if (lease->generation == cgfs_inode_get_generation(inode) &&
+            lease->expires > cgfs_lease_now() &&
+            cgfs_inode_has_been_deleted(inode) == false)
+        {
+            if (lease->flags == flags)
+            {
+                result = cgfs_lease_dup(lease->fd,
+                                        fd);
+
+                if (COMPILER_UNLIKELY(result != 0))
+                {
+                    CGUTILS_WARN("Error duplicating descriptor for inode %s: %d",
+                                 key,
+                                 result);
+                }
+            }
+        }
+        else
+        {
+            /* the content may have changed under the lease,
+               or the storage manager wants to hear from us again */
+            cgfs_lease_remove(this, lease);
+        }
+    }
+
+    return result;
+}
+
+uint64_t cgfs_lease_table_purge(cgfs_lease_table * const this)
+{
+    uint64_t result = 0;
+    CGUTILS_ASSERT(this != NULL);
+
+    uint64_t const now = cgfs_lease_now();
+
+    while (this->first != NULL &&
+           this->first->expires <= now)
+    {
+        cgfs_lease_remove(this, this->first);
+    }
+
+    if (this->first != NULL)
+    {
+        result = this->first->expires - now;
+    }
+
+    return result;
+}
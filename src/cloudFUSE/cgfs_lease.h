@@ -0,0 +1,63 @@
+/*
+ * This file is part of Nuage Labs SAS's Cloud Gateway.
+ *
+ * Copyright (C) 2011-2017  Nuage Labs SAS
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * In addition, for the avoidance of any doubt, permission is granted to
+ * link this program with OpenSSL and to (re)distribute the binaries
+ * produced as the result of such linking.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+#ifndef CGFS_LEASE_H_
+#define CGFS_LEASE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Open leases granted by the storage manager on read-only opens.
+   While a lease holds, the file is reopened from a descriptor kept
+   here instead of asking the storage manager again.
+   A table belongs to a single event loop and is not thread-safe. */
+typedef struct cgfs_lease_table cgfs_lease_table;
+
+#include <cgfs_inode.h>
+
+/* At most max_leases descriptors are kept open, the ones
+   closest to expiring being dropped first. */
+int cgfs_lease_table_init(size_t max_leases,
+                          cgfs_lease_table ** out);
+
+void cgfs_lease_table_free(cgfs_lease_table * this);
+
+/* Keeps a duplicate of fd, opened with flags, for duration ms.
+   The lease is dropped as soon as the inode generation changes. */
+int cgfs_lease_table_add(cgfs_lease_table * this,
+                         cgfs_inode * inode,
+                         int flags,
+                         int fd,
+                         uint32_t duration);
+
+/* Returns ENOENT if there is no valid lease for this inode and flags,
+   otherwise fd is set to a new descriptor belonging to the caller. */
+int cgfs_lease_table_get(cgfs_lease_table * this,
+                         cgfs_inode * inode,
+                         int flags,
+                         int * fd);
+
+/* Closes the expired leases, then returns the delay in ms until
+   the next one expires, 0 if none is left. */
+uint64_t cgfs_lease_table_purge(cgfs_lease_table * this);
+
+#endif /* CGFS_LEASE_H_ */
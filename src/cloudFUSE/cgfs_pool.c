@@ -0,0 +1,228 @@
+/*
+ * This file is part of Nuage Labs SAS's Cloud Gateway.
+ *
+ * Copyright (C) 2011-2017  Nuage Labs SAS
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * In addition, for the avoidance of any doubt, permission is granted to
+ * link this program with OpenSSL and to (re)distribute the binaries
+ * produced as the result of such linking.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+
+#include <cloudutils/cloudutils.h>
+
+#include "cgfs_pool.h"
+
+/* Released buffers are chained through their first bytes,
+   which is why the smallest class has to hold a pointer. */
+typedef struct cgfs_pool_chunk cgfs_pool_chunk;
+
+struct cgfs_pool_chunk
+{
+    cgfs_pool_chunk * next;
+};
+
+COMPILER_STATIC_ASSERT((1 << CGFS_POOL_CLASS_MIN_SHIFT) >= sizeof (cgfs_pool_chunk), "The smallest class has to hold a pointer");
+
+struct cgfs_pool
+{
+    cgfs_pool_chunk * free_lists[CGFS_POOL_CLASSES_COUNT];
+    size_t cached_size_max;
+    cgfs_pool_stats stats;
+};
+
+static inline size_t cgfs_pool_get_class(size_t const size)
+{
+    size_t result = 0;
+
+    while (result < CGFS_POOL_CLASSES_COUNT &&
+           ((size_t) 1 << (result + CGFS_POOL_CLASS_MIN_SHIFT)) < size)
+    {
+        result++;
+    }
+
+    return result;
+}
+
+static inline size_t cgfs_pool_get_class_size(size_t const class_idx)
+{
+    CGUTILS_ASSERT(class_idx < CGFS_POOL_CLASSES_COUNT);
+
+    return (size_t) 1 << (class_idx + CGFS_POOL_CLASS_MIN_SHIFT);
+}
+
+int cgfs_pool_init(size_t const cached_size_max,
+                   cgfs_pool ** const out)
+{
+    int result = 0;
+    cgfs_pool * this = NULL;
+    CGUTILS_ASSERT(out != NULL);
+
+    CGUTILS_ALLOCATE_STRUCT(this);
+
+    if (COMPILER_LIKELY(this != NULL))
+    {
+        this->cached_size_max = cached_size_max;
+        *out = this;
+    }
+    else
+    {
+        result = ENOMEM;
+    }
+
+    return result;
+}
+
+void cgfs_pool_free(cgfs_pool * this)
+{
+    if (this != NULL)
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+
+        for (size_t idx = 0;
+             idx < CGFS_POOL_CLASSES_COUNT;
+             idx++)
+        {
+            cgfs_pool_chunk * chunk = this->free_lists[idx];
+
+            while (chunk != NULL)
+            {
+                cgfs_pool_chunk * next = chunk->next;
+                CGUTILS_FREE(chunk);
+                chunk = next;
+            }
+
+            this->free_lists[idx] = NULL;
+            hits += this->stats.classes[idx].hits;
+            misses += this->stats.classes[idx].misses;
+        }
+
+        CGUTILS_INFO("Buffer pool: %"PRIu64" hits, %"PRIu64" misses, %"PRIu64" oversized, %zu bytes cached at most",
+                     hits,
+                     misses,
+                     this->stats.oversized,
+                     this->stats.cached_size_high_water);
+
+        CGUTILS_FREE(this);
+    }
+}
+
+void * cgfs_pool_get(cgfs_pool * const this,
+                     size_t const size)
+{
+    void * result = NULL;
+    CGUTILS_ASSERT(this != NULL);
+    CGUTILS_ASSERT(size > 0);
+
+    size_t const class_idx = cgfs_pool_get_class(size);
+
+    if (COMPILER_LIKELY(class_idx < CGFS_POOL_CLASSES_COUNT))
+    {
+        cgfs_pool_class_stats * const stats = &(this->stats.classes[class_idx]);
+        cgfs_pool_chunk * const chunk = this->free_lists[class_idx];
+
+        if (chunk != NULL)
+        {
+            this->free_lists[class_idx] = chunk->next;
+            CGUTILS_ASSERT(stats->cached > 0);
+            stats->cached--;
+            this->stats.cached_size -= cgfs_pool_get_class_size(class_idx);
+            stats->hits++;
+            result = chunk;
+        }
+        else
+        {
+            CGUTILS_MALLOC(result, cgfs_pool_get_class_size(class_idx), 1);
+
+            if (COMPILER_LIKELY(result != NULL))
+            {
+                stats->misses++;
+            }
+        }
+
+        if (COMPILER_LIKELY(result != NULL))
+        {
+            stats->in_use++;
+
+            if (stats->in_use > stats->in_use_high_water)
+            {
+                stats->in_use_high_water = stats->in_use;
+            }
+        }
+    }
+    else
+    {
+        CGUTILS_MALLOC(result, size, 1);
+        this->stats.oversized++;
+    }
+
+    return result;
+}
+
+void cgfs_pool_release(cgfs_pool * const this,
+                       void * buffer,
+                       size_t const size)
+{
+    CGUTILS_ASSERT(this != NULL);
+
+    if (buffer != NULL)
+    {
+        size_t const class_idx = cgfs_pool_get_class(size);
+
+        if (COMPILER_LIKELY(class_idx < CGFS_POOL_CLASSES_COUNT))
+        {
+            cgfs_pool_class_stats * const stats = &(this->stats.classes[class_idx]);
+            size_t const class_size = cgfs_pool_get_class_size(class_idx);
+
+            CGUTILS_ASSERT(stats->in_use > 0);
+            stats->in_use--;
+
+            if (this->stats.cached_size + class_size <= this->cached_size_max)
+            {
+                cgfs_pool_chunk * const chunk = buffer;
+                chunk->next = this->free_lists[class_idx];
+                this->free_lists[class_idx] = chunk;
+                stats->cached++;
+                this->stats.cached_size += class_size;
+
+                if (this->stats.cached_size > this->stats.cached_size_high_water)
+                {
+                    this->stats.cached_size_high_water = this->stats.cached_size;
+                }
+            }
+            else
+            {
+                CGUTILS_FREE(buffer);
+            }
+        }
+        else
+        {
+            CGUTILS_FREE(buffer);
+        }
+    }
+}
+
+void cgfs_pool_get_stats(cgfs_pool const * const this,
+                         cgfs_pool_stats * const stats)
+{
+    CGUTILS_ASSERT(this != NULL);
+    CGUTILS_ASSERT(stats != NULL);
+
+    *stats = this->stats;
+}
@@ -0,0 +1,75 @@
+/*
+ * This file is part of Nuage Labs SAS's Cloud Gateway.
+ *
+ * Copyright (C) 2011-2017  Nuage Labs SAS
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * In addition, for the avoidance of any doubt, permission is granted to
+ * link this program with OpenSSL and to (re)distribute the binaries
+ * produced as the result of such linking.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+#ifndef CGFS_POOL_H_
+#define CGFS_POOL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Size-classed free lists of buffers, from 64 bytes to 1 MB.
+   A pool belongs to a single event loop and is not thread-safe. */
+typedef struct cgfs_pool cgfs_pool;
+
+#define CGFS_POOL_CLASS_MIN_SHIFT (6)
+#define CGFS_POOL_CLASS_MAX_SHIFT (20)
+#define CGFS_POOL_CLASSES_COUNT (CGFS_POOL_CLASS_MAX_SHIFT - CGFS_POOL_CLASS_MIN_SHIFT + 1)
+
+typedef struct
+{
+    /* served from the free list */
+    uint64_t hits;
+    /* had to be allocated */
+    uint64_t misses;
+    size_t in_use;
+    size_t in_use_high_water;
+    size_t cached;
+} cgfs_pool_class_stats;
+
+typedef struct
+{
+    cgfs_pool_class_stats classes[CGFS_POOL_CLASSES_COUNT];
+    /* larger than the biggest class, never cached */
+    uint64_t oversized;
+    size_t cached_size;
+    size_t cached_size_high_water;
+} cgfs_pool_stats;
+
+/* At most cached_size_max bytes are kept in the free lists,
+   0 disables caching. */
+int cgfs_pool_init(size_t cached_size_max,
+                   cgfs_pool ** out);
+
+void cgfs_pool_free(cgfs_pool * this);
+
+void * cgfs_pool_get(cgfs_pool * this,
+                     size_t size);
+
+/* size has to be the one passed to cgfs_pool_get() */
+void cgfs_pool_release(cgfs_pool * this,
+                       void * buffer,
+                       size_t size);
+
+void cgfs_pool_get_stats(cgfs_pool const * this,
+                         cgfs_pool_stats * stats);
+
+#endif /* CGFS_POOL_H_ */
@@ -31,6 +31,7 @@
 
 int cgfs_utils_open_file(cgfs_inode * const inode,
                          char const * const path,
+                         int fd,
                          int * const flags,
                          cgfs_file_handler ** const out)
 {
@@ -38,7 +39,7 @@ int cgfs_utils_open_file(cgfs_inode * const inode,
 
     CGUTILS_ASSERT(inode != NULL);
     CGUTILS_ASSERT(flags != NULL);
-    CGUTILS_ASSERT(path != NULL);
+    CGUTILS_ASSERT(path != NULL || fd != -1);
     CGUTILS_ASSERT(out != NULL);
 
     /* Creation has been taken care of,
@@ -47,8 +48,11 @@ int cgfs_utils_open_file(cgfs_inode * const inode,
 
     *flags &= ~(O_CREAT|O_EXCL);
 
-    int fd = open(path,
+    if (fd == -1)
+    {
+        fd = open(path,
                   *flags | O_NONBLOCK);
+    }
 
     if (COMPILER_LIKELY(fd != -1))
     {
@@ -104,14 +108,7 @@ void cgfs_utils_update_inode_mtime(cgfs_inode * const inode)
 {
     CGUTILS_ASSERT(inode != NULL);
 
-    time_t const now = time(NULL);
-
-    if (difftime(now, inode->attr.st_mtime) > 0)
-    {
-        inode->attr.st_mtime = now;
-    }
-
-    inode->attr.st_ctime = now;
+    cgfs_inode_touch(inode);
 }
 
 bool cgfs_utils_check_flags_validity(int const flags)
@@ -30,8 +30,11 @@
 #include <cgfs_file_handler.h>
 #include <cgfs_inode.h>
 
+/* fd, if not -1, is an already opened descriptor of the file
+   to use instead of path, and is owned by this function. */
 int cgfs_utils_open_file(cgfs_inode * inode,
                          char const * path,
+                         int fd,
                          int * mode,
                          cgfs_file_handler ** out);
 
@@ -22,13 +22,18 @@
  */
 
 #include <errno.h>
+#include <fcntl.h>
 #include <inttypes.h>
 #include <limits.h>
+#include <pthread.h>
 #include <signal.h>
 #include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/uio.h>
 
 #define FUSE_USE_VERSION 29
 #include <fuse/fuse_lowlevel.h>
@@ -40,24 +45,59 @@
 #include <cloudutils/cloudutils_file.h>
 #include <cloudutils/cloudutils_process.h>
 
-/* Used by the kernel to know for how long attributes can be cached.
-   The cache is invalidated by fuse_invalidate_attr()
-   on open / truncate / fallocate / read / write anyway.
-   In seconds.
-*/
-#define CGFUSE_ATTR_TIMEOUT (60.0)
-/* Same for the directory entries (dentry),
-   invalidated by fuse_invalidate_entry_cache()
-   on unlink / rmdir / rename / ..
-   In seconds.
-*/
-#define CGFUSE_ENTRY_TIMEOUT (60.0)
+/* Maximum number of pending kernel cache invalidations,
+   further ones are dropped. */
+#define CGFUSE_INVALIDATIONS_MAX (4096)
+
+#ifndef FUSE_DEV_IOC_CLONE
+/* from linux/fuse.h, Linux >= 4.2 */
+#define FUSE_DEV_IOC_CLONE _IOR(229, 0, uint32_t)
+#endif /* FUSE_DEV_IOC_CLONE */
+
+/* sizeof (struct fuse_in_header), from linux/fuse.h */
+#define CGFUSE_IN_HEADER_SIZE (40)
 
 static void cgfuse_init(void * const userdata,
                         struct fuse_conn_info * const conn)
 {
+    cgfs_data const * const data = cgfs_get_data();
+    CGUTILS_ASSERT(data != NULL);
+    CGUTILS_ASSERT(conn != NULL);
+
     (void) userdata;
-    (void) conn;
+
+    if (data->zero_copy_read != 0)
+    {
+        /* Without it, libfuse copies the data from the FD
+           into a temporary buffer before writing the reply. */
+        if ((conn->capable & FUSE_CAP_SPLICE_WRITE) != 0)
+        {
+            conn->want |= FUSE_CAP_SPLICE_WRITE;
+
+            if ((conn->capable & FUSE_CAP_SPLICE_MOVE) != 0)
+            {
+                conn->want |= FUSE_CAP_SPLICE_MOVE;
+            }
+        }
+        else
+        {
+            CGUTILS_WARN("Zero-copy read requested but splice is not supported, data will be copied");
+        }
+    }
+
+    if (data->zero_copy_write != 0)
+    {
+        /* Have libfuse splice() write requests from /dev/fuse
+           into a pipe, handed to cgfuse_write_buf(). */
+        if ((conn->capable & FUSE_CAP_SPLICE_READ) != 0)
+        {
+            conn->want |= FUSE_CAP_SPLICE_READ;
+        }
+        else
+        {
+            CGUTILS_WARN("Zero-copy write requested but splice is not supported, data will be copied");
+        }
+    }
 }
 
 static void cgfuse_destroy(void * const userdata)
@@ -102,11 +142,19 @@ static void cgfuse_fill_reply_entry(struct fuse_entry_param * const params,
                                     cgfs_inode * const inode)
 {
     CGUTILS_ASSERT(params != NULL);
+    double attr_timeout = 0;
+    double entry_timeout = 0;
+
+    cgfs_get_inode_timeouts(cgfs_get_data(),
+                            inode,
+                            &attr_timeout,
+                            &entry_timeout);
 
     if (inode != NULL)
     {
         params->ino = cgfs_inode_get_number(inode);
-        params->attr = inode->attr;
+        cgfs_inode_get_attributes(inode,
+                                  &(params->attr));
     }
     else
     {
@@ -116,9 +164,9 @@ static void cgfuse_fill_reply_entry(struct fuse_entry_param * const params,
     /* Generation number for this entry */
     params->generation = 1;
     /* Validity timeout (in seconds) for the attributes */
-    params->attr_timeout = CGFUSE_ATTR_TIMEOUT;
+    params->attr_timeout = attr_timeout;
     /* Validity timeout (in seconds) for the name */
-    params->entry_timeout = CGFUSE_ENTRY_TIMEOUT;
+    params->entry_timeout = entry_timeout;
 }
 
 static void cgfuse_reply_entry(fuse_req_t const req,
@@ -237,10 +285,20 @@ static void cgfuse_reply_attr(fuse_req_t const req,
 {
     CGUTILS_ASSERT(req != NULL);
     CGUTILS_ASSERT(inode != NULL);
+    double attr_timeout = 0;
+    struct stat attr = (struct stat) { 0 };
+
+    cgfs_get_inode_timeouts(cgfs_get_data(),
+                            inode,
+                            &attr_timeout,
+                            NULL);
+
+    cgfs_inode_get_attributes(inode,
+                              &attr);
 
     int result = fuse_reply_attr(req,
-                                 &(inode->attr),
-                                 CGFUSE_ATTR_TIMEOUT);
+                                 &attr,
+                                 attr_timeout);
 
     if (COMPILER_LIKELY(result != 0))
     {
@@ -294,10 +352,19 @@ static void cgfuse_reply_open_cb(void * const req,
     struct fuse_file_info fi = (struct fuse_file_info) { 0 };
 
     cgfuse_set_file_handler(&fi, file_handler);
-    /* There is no content modification from outside of
-       the mounted filesystem, so the content may be cached
-       by the kernel. */
-    fi.keep_cache = 1;
+
+    cgfs_inode * const inode = cgfs_file_handler_get_inode(file_handler);
+
+    /* Let the kernel keep the pages it has cached for this file,
+       unless we have seen its content change from outside of this
+       mount since the last open. This is best-effort: a change is only
+       seen when a lookup, getattr or readdir reaches the storage manager,
+       so pages may stay stale until the attribute timeout expires. */
+    if (inode != NULL &&
+        cgfs_inode_check_kernel_cache(inode) == true)
+    {
+        fi.keep_cache = 1;
+    }
 
     cgfuse_reply_open(req, &fi);
 }
@@ -419,7 +486,6 @@ static void cgfuse_reply_empty_buf(fuse_req_t const req)
     fuse_reply_buf(req, NULL, 0);
 }
 
-#if 0
 /* Reply with data from memory or FD, can be spliced. */
 /* != fuse_reply_buf uses a memory buffer, cannot be spliced. */
 static void cgfuse_reply_data_fd(fuse_req_t const req,
@@ -435,9 +501,12 @@ static void cgfuse_reply_data_fd(fuse_req_t const req,
     buf.buf[0].fd = fd;
     buf.buf[0].pos = position;
 
+    /* No FUSE_BUF_SPLICE_NONBLOCK here: the data is already
+       known to be readable, and an EAGAIN would be sent back
+       to the caller as is. */
     int result = fuse_reply_data(req,
                                  &buf,
-                                 FUSE_BUF_SPLICE_NONBLOCK);
+                                 0);
 
     if (COMPILER_UNLIKELY(result != 0))
     {
@@ -448,7 +517,26 @@ static void cgfuse_reply_data_fd(fuse_req_t const req,
                 -result);
     }
 }
-#endif /* 0 */
+
+static void cgfuse_reply_data_fd_cb(void * const req,
+                                    int const fd,
+                                    off_t const position,
+                                    size_t const size)
+{
+    CGUTILS_ASSERT(req != NULL);
+
+    if (size > 0)
+    {
+        cgfuse_reply_data_fd(req,
+                             fd,
+                             position,
+                             size);
+    }
+    else
+    {
+        cgfuse_reply_empty_buf(req);
+    }
+}
 
 static void cgfuse_reply_data_mem(fuse_req_t const req,
                                   void const * const data,
@@ -804,17 +892,32 @@ static void cgfuse_read(fuse_req_t const req,
 
     CGUTILS_ASSERT(file_handler != NULL);
 
-    /* FIXME / TODO: we may be able to use cgfuse_reply_data_fd
-       in order to allow zero-copy via splice(), but I am not
-       sure that it works correctly with a non-blocking FD. */
-    cgfs_async_read(cgfs_get_data(),
-                    file_handler,
-                    ino,
-                    size,
-                    off,
-                    &cgfuse_reply_data_mem_cb,
-                    &cgfuse_err_cb,
-                    req);
+    cgfs_data * const data = cgfs_get_data();
+
+    if (data->zero_copy_read != 0)
+    {
+        /* Let FUSE splice() the data from the cache file */
+        cgfs_async_read_fd(data,
+                           file_handler,
+                           ino,
+                           size,
+                           off,
+                           &cgfuse_reply_data_fd_cb,
+                           &cgfuse_reply_data_mem_cb,
+                           &cgfuse_err_cb,
+                           req);
+    }
+    else
+    {
+        cgfs_async_read(data,
+                        file_handler,
+                        ino,
+                        size,
+                        off,
+                        &cgfuse_reply_data_mem_cb,
+                        &cgfuse_err_cb,
+                        req);
+    }
 }
 
 static void cgfuse_write(fuse_req_t const req,
@@ -846,10 +949,6 @@ static void cgfuse_write(fuse_req_t const req,
                      req);
 }
 
-#if 0
-    /* FIXME / TODO: we may be able to use fuse_buf_copy
-       in order to allow zero-copy via splice(), but I am not
-       sure that it works correctly with a non-blocking FD. */
 #if FUSE_VERSION >= 29
 static void cgfuse_write_buf(fuse_req_t const req,
                              fuse_ino_t const ino,
@@ -857,58 +956,114 @@ static void cgfuse_write_buf(fuse_req_t const req,
                              off_t const off,
                              struct fuse_file_info * const fi)
 {
-    int result = 0;
-    int fd = -1;
     CGUTILS_ASSERT(req != NULL);
     CGUTILS_ASSERT(ino > 0);
     CGUTILS_ASSERT(bufv != NULL);
     CGUTILS_ASSERT(off >= 0);
     CGUTILS_ASSERT(fi != NULL);
-    cgfs_file_handler * file_handler = cgfuse_get_file_handler(fi);
+    /* Write should return exactly the number of bytes requested except on error */
 
+    cgfs_file_handler * file_handler = cgfuse_get_file_handler(fi);
     CGUTILS_ASSERT(file_handler != NULL);
-    result = cgfs_async_get_fd_for_writing(cgfs_get_data(),
-                                           file_handler,
-                                           ino,
-                                           &fd);
 
-    if (COMPILER_LIKELY(result == 0))
+    if (bufv->count == 1 &&
+        (bufv->buf[0].flags & FUSE_BUF_IS_FD) == 0)
     {
-        CGUTILS_ASSERT(fd != -1);
-        struct fuse_bufvec dst = FUSE_BUFVEC_INIT(fuse_buf_size(bufv));
+        /* The request has been read into memory (no splice from /dev/fuse),
+           nothing to gain here, use the regular path. */
+        CGUTILS_ASSERT(bufv->buf[0].mem != NULL);
 
-        dst.buf[0].flags = FUSE_BUF_IS_FD | FUSE_BUF_FD_SEEK;
-        dst.buf[0].fd = fd;
-        fd = -1;
-        dst.buf[0].pos = off;
-
-        ssize_t const res = fuse_buf_copy(&dst,
-                                          bufv,
-                                          FUSE_BUF_SPLICE_NONBLOCK);
+        cgfuse_write(req,
+                     ino,
+                     (char const *) bufv->buf[0].mem + bufv->off,
+                     bufv->buf[0].size - bufv->off,
+                     off,
+                     fi);
+    }
+    else
+    {
+        int fd = -1;
+        int result = cgfs_async_get_fd_for_writing(cgfs_get_data(),
+                                                   file_handler,
+                                                   ino,
+                                                   &fd);
 
-        if (COMPILER_LIKELY(res > 0))
+        if (COMPILER_LIKELY(result == 0))
         {
-            cgfuse_reply_write(req,
-                               (size_t) res);
+            size_t const total = fuse_buf_size(bufv);
+            size_t written = 0;
+            struct fuse_bufvec dst = FUSE_BUFVEC_INIT(total);
+            CGUTILS_ASSERT(fd != -1);
+
+            dst.buf[0].flags = FUSE_BUF_IS_FD | FUSE_BUF_FD_SEEK;
+            dst.buf[0].fd = fd;
+            dst.buf[0].pos = off;
+
+            /* fuse_buf_copy() advances both bufvecs, so we can just call it again
+               after a partial transfer. We do not pass FUSE_BUF_SPLICE_NONBLOCK:
+               the data is already in the pipe, and the cache file is a regular file,
+               for which O_NONBLOCK has no effect, so there is nothing to wait for
+               and only an interrupted copy is worth retrying. */
+            while (written < total &&
+                   result == 0)
+            {
+                ssize_t const res = fuse_buf_copy(&dst,
+                                                  bufv,
+                                                  0);
+
+                if (COMPILER_LIKELY(res > 0))
+                {
+                    written += (size_t) res;
+                }
+                else if (res == 0)
+                {
+                    /* Source exhausted */
+                    break;
+                }
+                else if (res == -EINTR)
+                {
+                    /* retry */
+                }
+                else
+                {
+                    CGUTILS_ASSERT(res >= INT_MIN);
+                    result = (int) -res;
+                }
+            }
+
+            if (COMPILER_LIKELY(written > 0))
+            {
+                /* On a partial write, the kernel will
+                   report the short count to the caller. */
+                cgfs_file_handler_file_refresh_inode_attributes_from_fd(file_handler);
+
+                cgfuse_reply_write(req,
+                                   written);
+            }
+            else
+            {
+                if (result == 0)
+                {
+                    result = EIO;
+                }
+
+                CGUTILS_ERROR("Error writing %zu bytes to inode %"PRIu64": %d",
+                              total,
+                              (uint64_t) ino,
+                              result);
+
+                cgfuse_reply_err(req,
+                                 result);
+            }
         }
         else
         {
-            CGUTILS_ASSERT(res >= INT_MIN);
-            CGUTILS_ASSERT(res <= INT_MAX);
-
-
             cgfuse_reply_err(req,
-                             (int) res);
+                             result);
         }
     }
-    else
-    {
-        cgfuse_reply_err(req,
-                         result);
-    }
 }
 #endif /* FUSE_VERSION >= 29 */
-#endif /* 0 */
 
 static void cgfuse_fsync(fuse_req_t const req,
                          fuse_ino_t const ino,
@@ -1071,9 +1226,6 @@ static void cgfuse_opendir(fuse_req_t const req,
     CGUTILS_ASSERT(ino > 0);
     (void) fi;
 
-    /* TODO: use DB cursor (benchs show that we are fine even with a directory
-       containing 500k+ entries, so this is not critical. */
-
     cgfs_async_opendir(cgfs_get_data(),
                        ino,
                        &cgfuse_reply_open_cb,
@@ -1081,29 +1233,22 @@ static void cgfuse_opendir(fuse_req_t const req,
                        req);
 }
 
-static void cgfuse_readdir(fuse_req_t const req,
-                           fuse_ino_t const ino,
-                           size_t const size,
-                           off_t const off,
-                           struct fuse_file_info * const fi)
+static void cgfuse_reply_readdir_cb(void * const cb_data,
+                                    cgfs_file_handler * const fh,
+                                    uint64_t const ino,
+                                    size_t const off,
+                                    size_t const size)
 {
-    /*
-      Send a buffer filled using fuse_add_direntry(), with size not exceeding the requested size. Send an empty buffer on end of stream.
-
-      fi->fh will contain the value set by the opendir method, or will be undefined if the opendir method didn't set any value.
-    */
+    fuse_req_t req = cb_data;
+    size_t idx = off;
 
-    /*
-      Returning a directory entry from readdir() does not affect its lookup count.
-    */
-
-    CGUTILS_ASSERT(off >= 0);
-
-    size_t idx = (size_t) off;
+    CGUTILS_ASSERT(req != NULL);
+    CGUTILS_ASSERT(fh != NULL);
 
     cgfs_data * const data = cgfs_get_data();
-    cgfs_file_handler * const fh = cgfuse_get_file_handler(fi);
 
+    /* Only the entries of the current batch are sent, the kernel
+       will ask for the next offset if it needs more. */
     size_t remaining_entries = cgfs_async_get_remaining_dir_entries_count(data,
                                                                           ino,
                                                                           fh,
@@ -1121,9 +1266,8 @@ static void cgfuse_readdir(fuse_req_t const req,
         /* size of of an entry is roughly 32 + entry_name_len */
         size_t needed_size = (32 * remaining_entries) + remaining_entries_name_len;
         size_t const buffer_size = needed_size > size ? size : needed_size;
-        void * buffer = NULL;
-
-        CGUTILS_MALLOC(buffer, buffer_size, 1);
+        void * buffer = cgfs_pool_get(data->pool,
+                                      buffer_size);
 
         if (COMPILER_LIKELY(buffer != NULL))
         {
@@ -1136,7 +1280,7 @@ static void cgfuse_readdir(fuse_req_t const req,
                    remaining > 0)
             {
                 char const * entry_name = NULL;
-                struct stat const * entry_st = NULL;
+                struct stat entry_st = (struct stat) { 0 };
 
                 result = cgfs_async_get_dir_entry(data,
                                                   ino,
@@ -1151,7 +1295,7 @@ static void cgfuse_readdir(fuse_req_t const req,
                                                    ((char *) buffer) + position,
                                                    remaining,
                                                    entry_name,
-                                                   entry_st,
+                                                   &entry_st,
                                                    (off_t) idx + 1);
 
                     if (COMPILER_LIKELY(got <= remaining))
@@ -1188,7 +1332,10 @@ static void cgfuse_readdir(fuse_req_t const req,
                                       buffer_size - remaining);
             }
 
-            CGUTILS_FREE(buffer);
+            cgfs_pool_release(data->pool,
+                              buffer,
+                              buffer_size);
+            buffer = NULL;
         }
 
         if (COMPILER_UNLIKELY(result != 0))
@@ -1204,6 +1351,36 @@ static void cgfuse_readdir(fuse_req_t const req,
     }
 }
 
+static void cgfuse_readdir(fuse_req_t const req,
+                           fuse_ino_t const ino,
+                           size_t const size,
+                           off_t const off,
+                           struct fuse_file_info * const fi)
+{
+    /*
+      Send a buffer filled using fuse_add_direntry(), with size not exceeding the requested size. Send an empty buffer on end of stream.
+
+      fi->fh will contain the value set by the opendir method, or will be undefined if the opendir method didn't set any value.
+    */
+
+    /*
+      Returning a directory entry from readdir() does not affect its lookup count.
+    */
+
+    CGUTILS_ASSERT(req != NULL);
+    CGUTILS_ASSERT(ino > 0);
+    CGUTILS_ASSERT(off >= 0);
+
+    cgfs_async_readdir(cgfs_get_data(),
+                       ino,
+                       cgfuse_get_file_handler(fi),
+                       (size_t) off,
+                       size,
+                       &cgfuse_reply_readdir_cb,
+                       &cgfuse_err_cb,
+                       req);
+}
+
 static void cgfuse_releasedir(fuse_req_t const req,
                               fuse_ino_t const ino,
                               struct fuse_file_info * const fi)
@@ -1292,9 +1469,6 @@ static struct fuse_lowlevel_ops const cgfuse_operations =
 
     .opendir      = cgfuse_opendir,
     .readdir	  = cgfuse_readdir,
-#if FUSE_VERSION >= 30
-    .readdirplus  = cgfuse_readdirplus,
-#endif /* FUSE_VERSION >= 30 */
     .releasedir   = cgfuse_releasedir,
 
     .getattr	  = cgfuse_getattr,
@@ -1321,11 +1495,9 @@ static struct fuse_lowlevel_ops const cgfuse_operations =
     .readlink     = cgfuse_readlink,
     .symlink      = cgfuse_symlink,
 
-#if 0
 #if FUSE_VERSION >= 29
     .write_buf    = cgfuse_write_buf,
 #endif /* FUSE_VERSION >= 29 */
-#endif /* 0 */
 #if 0
 
     .getxattr	  = cgfuse_getxattr,
@@ -1388,6 +1560,11 @@ static void cgfuse_fuse_event_cb(int const fd,
                                      &buf,
                                      chan);
         }
+        else if (result == -EAGAIN)
+        {
+            /* With several threads, the request may
+               have been picked up by another one. */
+        }
         else if (result < 0)
         {
             CGUTILS_ERROR("Error while receiving request: %d",
@@ -1418,6 +1595,8 @@ static int cgfuse_parse_arguments(int const argc,
         CGFUSE_SET_OPT("-s %s", data, cgsm_configuration_file),
         CGFUSE_SET_OPT("-i %s", data, fs_name),
         CGFUSE_SET_OPT("-p %s", data, pid_file),
+        CGFUSE_SET_OPT("zero_copy_read", data, zero_copy_read),
+        CGFUSE_SET_OPT("zero_copy_write", data, zero_copy_write),
         FUSE_OPT_END
     };
 
@@ -1445,6 +1624,17 @@ static void cgfuse_sighup_handler(int const sig,
 //    cgsm_reload_handler();
 }
 
+static void cgfuse_sigusr1_handler(int const sig,
+                                   void * cb_data)
+{
+    cgfs_data const * const data = cb_data;
+    CGUTILS_ASSERT(data != NULL);
+
+    (void) sig;
+
+    cgfs_log_stats(data);
+}
+
 static void cgfuse_exit_signal_handler(int const sig,
                                        void * cb_data)
 {
@@ -1534,9 +1724,669 @@ static int cgfuse_set_signal_handlers(cgfs_data * const data)
                                              data);
     }
 
+    if (result == 0)
+    {
+        result = cgfuse_set_one_signal_event(data->event_data,
+                                             SIGUSR1,
+                                             &(data->sigusr1_event),
+                                             &cgfuse_sigusr1_handler,
+                                             data);
+    }
+
+    return result;
+}
+
+static int cgfuse_set_fd_nonblocking(int const fd)
+{
+    int result = 0;
+    int const flags = fcntl(fd, F_GETFL);
+
+    if (flags == -1 ||
+        fcntl(fd, F_SETFL, flags | O_NONBLOCK) == -1)
+    {
+        result = errno;
+    }
+
+    return result;
+}
+
+/* libfuse 2.9 does not export its kernel channel, these ops do the
+   same over a cloned FD. A session only knows about its own channel,
+   so the session is passed as the channel data. */
+static int cgfuse_cloned_chan_receive(struct fuse_chan ** const chp,
+                                      char * const buf,
+                                      size_t const size)
+{
+    CGUTILS_ASSERT(chp != NULL);
+    CGUTILS_ASSERT(*chp != NULL);
+    CGUTILS_ASSERT(buf != NULL);
+    struct fuse_chan * const chan = *chp;
+    struct fuse_session * const session = fuse_chan_data(chan);
+    CGUTILS_ASSERT(session != NULL);
+    int result = 0;
+    ssize_t res = 0;
+
+    do
+    {
+        res = read(fuse_chan_fd(chan), buf, size);
+    }
+    /* ENOENT means the request has been interrupted */
+    while (res == -1 && errno == ENOENT);
+
+    if (fuse_session_exited(session) == 0)
+    {
+        if (res == -1)
+        {
+            result = -errno;
+
+            if (errno == ENODEV)
+            {
+                /* unmounted */
+                fuse_session_exit(session);
+                result = 0;
+            }
+        }
+        else if ((size_t) res < CGFUSE_IN_HEADER_SIZE)
+        {
+            result = -EIO;
+            CGUTILS_ERROR("Short read on cloned FUSE channel: %zd", res);
+        }
+        else
+        {
+            result = (int) res;
+        }
+    }
+
+    return result;
+}
+
+static int cgfuse_cloned_chan_send(struct fuse_chan * const chan,
+                                   struct iovec const iov[],
+                                   size_t const count)
+{
+    CGUTILS_ASSERT(chan != NULL);
+    int result = 0;
+
+    if (iov != NULL)
+    {
+        ssize_t const res = writev(fuse_chan_fd(chan), iov, (int) count);
+
+        if (res == -1)
+        {
+            struct fuse_session * const session = fuse_chan_data(chan);
+            CGUTILS_ASSERT(session != NULL);
+            result = -errno;
+
+            /* ENOENT means the request has been interrupted */
+            if (errno != ENOENT &&
+                fuse_session_exited(session) == 0)
+            {
+                CGUTILS_ERROR("Error writing to cloned FUSE channel: %d", errno);
+            }
+        }
+    }
+
     return result;
 }
 
+static void cgfuse_cloned_chan_destroy(struct fuse_chan * const chan)
+{
+    CGUTILS_ASSERT(chan != NULL);
+    int const fd = fuse_chan_fd(chan);
+
+    if (fd != -1)
+    {
+        close(fd);
+    }
+}
+
+static struct fuse_chan_ops cgfuse_cloned_chan_ops =
+{
+    .receive = &cgfuse_cloned_chan_receive,
+    .send = &cgfuse_cloned_chan_send,
+    .destroy = &cgfuse_cloned_chan_destroy,
+};
+
+/* Opens a new /dev/fuse FD attached to the same FUSE connection.
+   Requests are still taken from a shared queue, but each thread gets its
+   own FD and therefore its own event loop. */
+static int cgfuse_clone_chan(struct fuse_session * const session,
+                             struct fuse_chan * const master,
+                             struct fuse_chan ** const out)
+{
+    CGUTILS_ASSERT(session != NULL);
+    CGUTILS_ASSERT(master != NULL);
+    CGUTILS_ASSERT(out != NULL);
+    int result = 0;
+    int const clone_fd = open("/dev/fuse", O_RDWR | O_CLOEXEC);
+
+    if (clone_fd != -1)
+    {
+        uint32_t master_fd = (uint32_t) fuse_chan_fd(master);
+
+        if (ioctl(clone_fd, FUSE_DEV_IOC_CLONE, &master_fd) == 0)
+        {
+            result = cgfuse_set_fd_nonblocking(clone_fd);
+
+            if (result == 0)
+            {
+                /* the FD now belongs to the channel */
+                *out = fuse_chan_new(&cgfuse_cloned_chan_ops,
+                                     clone_fd,
+                                     fuse_chan_bufsize(master),
+                                     session);
+
+                if (*out == NULL)
+                {
+                    result = ENOMEM;
+                }
+            }
+        }
+        else
+        {
+            result = errno;
+        }
+
+        if (result != 0)
+        {
+            close(clone_fd);
+        }
+    }
+    else
+    {
+        result = errno;
+    }
+
+    return result;
+}
+
+static void cgfuse_worker_exit_cb(int const fd,
+                                  short const flags,
+                                  void * const cb_data)
+{
+    cgfs_data * const worker = cb_data;
+    CGUTILS_ASSERT(worker != NULL);
+
+    (void) fd;
+    (void) flags;
+
+    cgutils_event_exit_loop(worker->event_data);
+}
+
+static void * cgfuse_worker_run(void * const cb_data)
+{
+    cgfs_data * const worker = cb_data;
+    CGUTILS_ASSERT(worker != NULL);
+
+    cgfs_set_thread_data(worker);
+
+    cgutils_event_dispatch(worker->event_data);
+
+    return NULL;
+}
+
+static void cgfuse_worker_clean(cgfs_data * worker,
+                                struct fuse_chan * const master)
+{
+    CGUTILS_ASSERT(worker != NULL);
+
+    if (worker->fuse_event != NULL)
+    {
+        cgutils_event_free(worker->fuse_event), worker->fuse_event = NULL;
+    }
+
+    if (worker->exit_event != NULL)
+    {
+        cgutils_event_free(worker->exit_event), worker->exit_event = NULL;
+    }
+
+    for (size_t idx = 0;
+         idx < 2;
+         idx++)
+    {
+        if (worker->exit_pipe[idx] != -1)
+        {
+            close(worker->exit_pipe[idx]), worker->exit_pipe[idx] = -1;
+        }
+    }
+
+    if (worker->chan != NULL)
+    {
+        if (worker->chan != master)
+        {
+            fuse_chan_destroy(worker->chan);
+        }
+
+        worker->chan = NULL;
+    }
+
+    cgfs_data_clean(&worker);
+}
+
+static int cgfuse_worker_start(cgfs_data * const data,
+                               struct fuse_chan * const master,
+                               cgfs_data * const worker)
+{
+    CGUTILS_ASSERT(data != NULL);
+    CGUTILS_ASSERT(master != NULL);
+    CGUTILS_ASSERT(worker != NULL);
+
+    int result = cgfs_data_init_worker(data,
+                                       worker);
+
+    if (result == 0)
+    {
+        result = cgfuse_clone_chan(data->session,
+                                   master,
+                                   &(worker->chan));
+
+        if (result != 0)
+        {
+            /* Old kernel, all threads will poll the same non-blocking FD. */
+            CGUTILS_WARN("Unable to clone the FUSE channel (%d), sharing it",
+                         result);
+            worker->chan = master;
+            result = 0;
+        }
+
+        worker->buffer_size = fuse_chan_bufsize(worker->chan);
+        CGUTILS_MALLOC(worker->buffer, 1, worker->buffer_size);
+
+        if (worker->buffer != NULL)
+        {
+            result = cgutils_event_create_fd_event(worker->event_data,
+                                                   fuse_chan_fd(worker->chan),
+                                                   &cgfuse_fuse_event_cb,
+                                                   worker->chan,
+                                                   CGUTILS_EVENT_READ|CGUTILS_EVENT_PERSIST,
+                                                   &(worker->fuse_event));
+
+            if (result == 0)
+            {
+                result = cgutils_event_enable(worker->fuse_event,
+                                              NULL);
+            }
+        }
+        else
+        {
+            result = ENOMEM;
+        }
+
+        if (result == 0)
+        {
+            if (pipe2(worker->exit_pipe, O_NONBLOCK | O_CLOEXEC) == 0)
+            {
+                result = cgutils_event_create_fd_event(worker->event_data,
+                                                       worker->exit_pipe[0],
+                                                       &cgfuse_worker_exit_cb,
+                                                       worker,
+                                                       CGUTILS_EVENT_READ,
+                                                       &(worker->exit_event));
+
+                if (result == 0)
+                {
+                    result = cgutils_event_enable(worker->exit_event,
+                                                  NULL);
+                }
+            }
+            else
+            {
+                result = errno;
+            }
+        }
+
+        if (result == 0)
+        {
+            sigset_t all;
+            sigset_t previous;
+
+            /* Signals are handled by the main thread's event loop. */
+            sigfillset(&all);
+            pthread_sigmask(SIG_BLOCK, &all, &previous);
+
+            result = pthread_create(&(worker->thread),
+                                    NULL,
+                                    &cgfuse_worker_run,
+                                    worker);
+
+            pthread_sigmask(SIG_SETMASK, &previous, NULL);
+
+            if (result == 0)
+            {
+                worker->thread_started = true;
+            }
+        }
+    }
+
+    return result;
+}
+
+static void cgfuse_workers_stop(cgfs_data * const data,
+                                struct fuse_chan * const master)
+{
+    CGUTILS_ASSERT(data != NULL);
+
+    if (data->workers != NULL)
+    {
+        for (size_t idx = 0;
+             idx < data->workers_count;
+             idx++)
+        {
+            cgfs_data * const worker = &(data->workers[idx]);
+
+            if (worker->thread_started == true)
+            {
+                ssize_t const res = write(worker->exit_pipe[1], "", 1);
+                CGUTILS_ASSERT(res == 1);
+                (void) res;
+
+                pthread_join(worker->thread, NULL);
+                worker->thread_started = false;
+            }
+
+            cgfuse_worker_clean(worker,
+                                master);
+        }
+
+        CGUTILS_FREE(data->workers);
+        data->workers_count = 0;
+    }
+}
+
+static int cgfuse_workers_start(cgfs_data * const data,
+                                struct fuse_chan * const master)
+{
+    int result = 0;
+    CGUTILS_ASSERT(data != NULL);
+    CGUTILS_ASSERT(master != NULL);
+    CGUTILS_ASSERT(data->workers == NULL);
+
+    if (data->fuse_threads > 1)
+    {
+        size_t const count = data->fuse_threads - 1;
+
+        /* Several threads will be waiting on the same requests queue */
+        result = cgfuse_set_fd_nonblocking(fuse_chan_fd(master));
+
+        if (result == 0)
+        {
+            CGUTILS_MALLOC(data->workers, count, sizeof *(data->workers));
+
+            if (data->workers != NULL)
+            {
+                for (size_t idx = 0;
+                     idx < count &&
+                         result == 0;
+                     idx++)
+                {
+                    data->workers_count++;
+
+                    result = cgfuse_worker_start(data,
+                                                 master,
+                                                 &(data->workers[idx]));
+
+                    if (result != 0)
+                    {
+                        CGUTILS_ERROR("Error starting FUSE worker %zu: %d",
+                                      idx,
+                                      result);
+                    }
+                }
+
+                if (result != 0)
+                {
+                    cgfuse_workers_stop(data,
+                                        master);
+                }
+            }
+            else
+            {
+                result = ENOMEM;
+            }
+        }
+    }
+
+    return result;
+}
+
+/* Invalidations are sent to the kernel from a dedicated thread,
+   since the kernel may need a reply from one of the FUSE threads
+   before it can process them. */
+typedef struct cgfuse_invalidation cgfuse_invalidation;
+
+struct cgfuse_invalidation
+{
+    cgfuse_invalidation * next;
+    /* for entries, the parent inode */
+    uint64_t ino;
+    size_t name_len;
+    char name[];
+};
+
+typedef struct
+{
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    cgfuse_invalidation * head;
+    cgfuse_invalidation * tail;
+    size_t count;
+    struct fuse_chan * chan;
+    pthread_t thread;
+    bool thread_started;
+    bool exiting;
+} cgfuse_invalidator;
+
+static cgfuse_invalidator cgfuse_invalidations =
+{
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .cond = PTHREAD_COND_INITIALIZER,
+};
+
+static void cgfuse_invalidation_push(void * const cb_data,
+                                     uint64_t const ino,
+                                     char const * const name)
+{
+    cgfuse_invalidator * const this = cb_data;
+    cgfuse_invalidation * invalidation = NULL;
+    size_t const name_len = name != NULL ? strlen(name) : 0;
+
+    CGUTILS_ASSERT(this != NULL);
+    CGUTILS_ASSERT(ino > 0);
+
+    CGUTILS_MALLOC(invalidation, 1, sizeof *invalidation + name_len + 1);
+
+    if (COMPILER_LIKELY(invalidation != NULL))
+    {
+        invalidation->next = NULL;
+        invalidation->ino = ino;
+        invalidation->name_len = name_len;
+        memcpy(invalidation->name, name != NULL ? name : "", name_len + 1);
+
+        pthread_mutex_lock(&(this->lock));
+
+        if (COMPILER_LIKELY(this->count < CGFUSE_INVALIDATIONS_MAX &&
+                            this->exiting == false))
+        {
+            if (this->tail != NULL)
+            {
+                this->tail->next = invalidation;
+            }
+            else
+            {
+                this->head = invalidation;
+            }
+
+            this->tail = invalidation;
+            this->count++;
+            invalidation = NULL;
+
+            pthread_cond_signal(&(this->cond));
+        }
+
+        pthread_mutex_unlock(&(this->lock));
+
+        if (COMPILER_UNLIKELY(invalidation != NULL))
+        {
+            CGUTILS_WARN("Too many pending invalidations, dropping the one for inode %"PRIu64,
+                         ino);
+            CGUTILS_FREE(invalidation);
+        }
+    }
+}
+
+static void cgfuse_invalidate_inode_cb(void * const cb_data,
+                                       uint64_t const ino)
+{
+    cgfuse_invalidation_push(cb_data,
+                             ino,
+                             NULL);
+}
+
+static void cgfuse_invalidate_entry_cb(void * const cb_data,
+                                       uint64_t const parent_ino,
+                                       char const * const name)
+{
+    CGUTILS_ASSERT(name != NULL);
+
+    cgfuse_invalidation_push(cb_data,
+                             parent_ino,
+                             name);
+}
+
+static void * cgfuse_invalidator_run(void * const cb_data)
+{
+    cgfuse_invalidator * const this = cb_data;
+    CGUTILS_ASSERT(this != NULL);
+    CGUTILS_ASSERT(this->chan != NULL);
+
+    pthread_mutex_lock(&(this->lock));
+
+    while (this->exiting == false)
+    {
+        cgfuse_invalidation * invalidation = this->head;
+
+        if (invalidation != NULL)
+        {
+            int result = 0;
+
+            this->head = invalidation->next;
+
+            if (this->head == NULL)
+            {
+                this->tail = NULL;
+            }
+
+            this->count--;
+
+            pthread_mutex_unlock(&(this->lock));
+
+            if (invalidation->name_len > 0)
+            {
+                result = fuse_lowlevel_notify_inval_entry(this->chan,
+                                                          invalidation->ino,
+                                                          invalidation->name,
+                                                          invalidation->name_len);
+            }
+            else
+            {
+                /* attributes and the whole content */
+                result = fuse_lowlevel_notify_inval_inode(this->chan,
+                                                          invalidation->ino,
+                                                          0,
+                                                          0);
+            }
+
+            /* ENOENT means the kernel does not know about it */
+            if (COMPILER_UNLIKELY(result != 0 &&
+                                  result != -ENOENT))
+            {
+                CGUTILS_WARN("Error invalidating kernel cache for inode %"PRIu64": %d",
+                             invalidation->ino,
+                             -result);
+            }
+
+            CGUTILS_FREE(invalidation);
+
+            pthread_mutex_lock(&(this->lock));
+        }
+        else
+        {
+            pthread_cond_wait(&(this->cond),
+                              &(this->lock));
+        }
+    }
+
+    pthread_mutex_unlock(&(this->lock));
+
+    return NULL;
+}
+
+static int cgfuse_invalidator_start(cgfs_data * const data,
+                                    struct fuse_chan * const chan)
+{
+    cgfuse_invalidator * const this = &cgfuse_invalidations;
+    CGUTILS_ASSERT(data != NULL);
+    CGUTILS_ASSERT(chan != NULL);
+
+    this->chan = chan;
+    this->exiting = false;
+
+    int result = pthread_create(&(this->thread),
+                                NULL,
+                                &cgfuse_invalidator_run,
+                                this);
+
+    if (COMPILER_LIKELY(result == 0))
+    {
+        this->thread_started = true;
+
+        cgfs_set_invalidation_callbacks(data,
+                                        &cgfuse_invalidate_inode_cb,
+                                        &cgfuse_invalidate_entry_cb,
+                                        this);
+    }
+    else
+    {
+        CGUTILS_ERROR("Error creating invalidation thread: %d",
+                      result);
+    }
+
+    return result;
+}
+
+static void cgfuse_invalidator_stop(cgfs_data * const data)
+{
+    cgfuse_invalidator * const this = &cgfuse_invalidations;
+    CGUTILS_ASSERT(data != NULL);
+
+    cgfs_set_invalidation_callbacks(data,
+                                    NULL,
+                                    NULL,
+                                    NULL);
+
+    if (this->thread_started == true)
+    {
+        pthread_mutex_lock(&(this->lock));
+        this->exiting = true;
+        pthread_cond_signal(&(this->cond));
+        pthread_mutex_unlock(&(this->lock));
+
+        pthread_join(this->thread, NULL);
+        this->thread_started = false;
+    }
+
+    while (this->head != NULL)
+    {
+        cgfuse_invalidation * invalidation = this->head;
+        this->head = invalidation->next;
+        CGUTILS_FREE(invalidation);
+    }
+
+    this->tail = NULL;
+    this->count = 0;
+    this->chan = NULL;
+}
+
 static int cgfuse_event_run(char const * const process_name,
                             cgfs_data * const data,
                             struct fuse_args * args)
@@ -1594,7 +2444,38 @@ static int cgfuse_event_run(char const * const process_name,
 
                             if (result == 0)
                             {
-                                cgutils_event_dispatch(data->event_data);
+                                result = cgfuse_invalidator_start(data,
+                                                                  chan);
+
+                                if (result == 0)
+                                {
+                                    result = cgfuse_workers_start(data,
+                                                                  chan);
+
+                                    if (result == 0)
+                                    {
+                                        cgutils_event_dispatch(data->event_data);
+
+                                        cgfuse_workers_stop(data,
+                                                            chan);
+                                    }
+                                    else
+                                    {
+                                        fprintf(stderr,
+                                                "%s: error while starting worker threads: %d\n",
+                                                process_name,
+                                                result);
+                                    }
+
+                                    cgfuse_invalidator_stop(data);
+                                }
+                                else
+                                {
+                                    fprintf(stderr,
+                                            "%s: error while starting invalidation thread: %d\n",
+                                            process_name,
+                                            result);
+                                }
                             }
                             else
                             {
@@ -1645,6 +2526,7 @@ static int cgfuse_event_run(char const * const process_name,
             }
 
             cgutils_event_free(data->sighup_event), data->sighup_event = NULL;
+            cgutils_event_free(data->sigusr1_event), data->sigusr1_event = NULL;
             cgutils_event_free(data->sigint_event), data->sigint_event = NULL;
             cgutils_event_free(data->sigterm_event), data->sigterm_event = NULL;
         }
@@ -63,8 +63,8 @@ typedef enum
 
 typedef struct
 {
-    char const * const name;
-    char const * const proc_title;
+    char const * name;
+    char const * proc_title;
     time_t next_respawn;
     pid_t pid;
     pid_t old_pid;
@@ -96,11 +96,17 @@ static cgutils_event * master_timer_event = NULL;
 /* Pipe Of Death, used by the master to instruct children to exit. */
 static int master_children_pipe[2];
 
+/* Listening socket bound by the master and shared by the server workers. */
+static cg_storage_listener * server_listener = NULL;
+
 /* Child's data */
 static cgutils_event * child_pipe_event = NULL;
 static bool child_exiting = false;
 
-static cg_storage_manager_process cg_storage_manager_processes[] =
+#define CG_STORAGE_MANAGER_MASTER_MAX_SERVER_WORKERS (64)
+
+/* Server workers occupy the last slots, starting at cg_storage_manager_process_server. */
+static cg_storage_manager_process cg_storage_manager_processes[cg_storage_manager_processes_count - 1 + CG_STORAGE_MANAGER_MASTER_MAX_SERVER_WORKERS] =
 {
     { "cleaner", "cgStorageManager: Cleaner", (time_t) -1, (pid_t) -1, (pid_t) -1, true, cg_storage_manager_process_cleaner },
     { "monitor", "cgStorageManager: Monitor", (time_t) -1, (pid_t) -1, (pid_t) -1, true, cg_storage_manager_process_monitor },
@@ -108,7 +114,9 @@ static cg_storage_manager_process cg_storage_manager_processes[] =
     { "server", "cgStorageManager: Server",   (time_t) -1, (pid_t) -1, (pid_t) -1, true, cg_storage_manager_process_server },
 };
 
-COMPILER_STATIC_ASSERT(cg_storage_manager_processes_count == sizeof cg_storage_manager_processes / sizeof *cg_storage_manager_processes, "Enumerated processes does not match processes array size");
+static size_t cg_storage_manager_processes_used = cg_storage_manager_processes_count;
+
+COMPILER_STATIC_ASSERT(cg_storage_manager_process_server == cg_storage_manager_processes_count - 1, "Server workers should be the last processes");
 
 #define CG_STORAGE_MANAGER_MASTER_RESPAWN_INTERVAL (60)
 #define MAXIMUM_NUMBER_OF_SIGNALS ((size_t) _NSIG)
@@ -134,13 +142,6 @@ static int cg_storage_manager_parse_opt(char const * const conf_file,
     return result;
 }
 
-static pid_t cg_storage_manager_get_old_child_pid(cg_storage_manager_process_type const type)
-{
-    assert(type < cg_storage_manager_processes_count);
-
-    return cg_storage_manager_processes[type].old_pid;
-}
-
 static void cg_storage_manager_child_pipe_cb(int const fd,
                                              short const flags,
                                              void * const cb_data)
@@ -496,9 +497,12 @@ static void cg_storage_manager_cleanup(cg_storage_manager_data * data)
 }
 
 static int cg_storage_manager_server(cg_storage_manager_data * const data,
-                                     bool const graceful)
+                                     bool const graceful,
+                                     pid_t const old_server_pid)
 {
     assert(data != NULL);
+    cg_storage_listener * listener = server_listener;
+    server_listener = NULL;
 
     int result = cg_storage_manager_setup(data, true);
 
@@ -513,16 +517,11 @@ static int cg_storage_manager_server(cg_storage_manager_data * const data,
 
             if (result == 0)
             {
-                pid_t old_server_pid = -1;
-
-                if (graceful == true)
-                {
-                    old_server_pid = cg_storage_manager_get_old_child_pid(cg_storage_manager_process_server);
-                }
-
                 result = cg_storage_manager_server_run(data,
+                                                       listener,
                                                        graceful,
                                                        old_server_pid);
+                listener = NULL;
 
                 if (result != 0)
                 {
@@ -546,6 +545,11 @@ static int cg_storage_manager_server(cg_storage_manager_data * const data,
         CGUTILS_ERROR("Error in manager setup: %d", result);
     }
 
+    if (listener != NULL)
+    {
+        cg_storage_listener_free(listener), listener = NULL;
+    }
+
     cg_storage_manager_cleanup(data);
 
     return result;
@@ -734,7 +738,13 @@ static int cg_storage_manager_start_child(size_t const process_id,
     cgutils_system_setproctitle(argv0,
                                 cg_storage_manager_processes[process_id].proc_title);
 
-    switch (process_id)
+    if (cg_storage_manager_processes[process_id].type != cg_storage_manager_process_server &&
+        server_listener != NULL)
+    {
+        cg_storage_listener_free(server_listener), server_listener = NULL;
+    }
+
+    switch (cg_storage_manager_processes[process_id].type)
     {
     case cg_storage_manager_process_cleaner:
         result = cg_storage_manager_cleaner(data, graceful);
@@ -746,13 +756,53 @@ static int cg_storage_manager_start_child(size_t const process_id,
         result = cg_storage_manager_syncer(data, graceful);
         break;
     case cg_storage_manager_process_server:
-        result = cg_storage_manager_server(data, graceful);
+        result = cg_storage_manager_server(data,
+                                           graceful,
+                                           graceful == true ? cg_storage_manager_processes[process_id].old_pid : -1);
+        break;
+    case cg_storage_manager_processes_count:
+        CGUTILS_ASSERT(false);
         break;
     }
 
     return result;
 }
 
+static size_t cg_storage_manager_get_server_workers(cg_storage_manager_data const * const data)
+{
+    size_t result = cg_storage_manager_data_get_server_workers(data);
+    CGUTILS_ASSERT(data != NULL);
+
+    if (result == 0)
+    {
+        result = 1;
+    }
+    else if (result > CG_STORAGE_MANAGER_MASTER_MAX_SERVER_WORKERS)
+    {
+        CGUTILS_WARN("Too many server workers requested (%zu), using %zu.",
+                     result,
+                     (size_t) CG_STORAGE_MANAGER_MASTER_MAX_SERVER_WORKERS);
+        result = CG_STORAGE_MANAGER_MASTER_MAX_SERVER_WORKERS;
+    }
+
+    return result;
+}
+
+static void cg_storage_manager_setup_server_workers(size_t const workers)
+{
+    CGUTILS_ASSERT(workers > 0);
+    CGUTILS_ASSERT(workers <= CG_STORAGE_MANAGER_MASTER_MAX_SERVER_WORKERS);
+
+    for (size_t idx = 1;
+         idx < workers;
+         idx++)
+    {
+        cg_storage_manager_processes[cg_storage_manager_process_server + idx] = cg_storage_manager_processes[cg_storage_manager_process_server];
+    }
+
+    cg_storage_manager_processes_used = cg_storage_manager_process_server + workers;
+}
+
 static void cg_storage_manager_clean_inherited_env(cg_storage_manager_data * const data)
 {
     /* clear timer, signals, and event_base */
@@ -790,7 +840,7 @@ static void cg_storage_manager_master_do_respawn(char * const argv0,
 
     for (size_t idx = 0;
          result == 0 &&
-             idx < cg_storage_manager_processes_count &&
+             idx < cg_storage_manager_processes_used &&
              *is_master == true;
          idx++)
     {
@@ -1012,7 +1062,7 @@ static int cg_storage_manager_send_graceful_exit_signal_to_children(int const si
     time_t const now = time(NULL);
 
     for (size_t idx = 0;
-         idx < cg_storage_manager_processes_count;
+         idx < cg_storage_manager_processes_used;
          idx++)
     {
         pid_t const pid = cg_storage_manager_processes[idx].pid;
@@ -1091,7 +1141,7 @@ static void cg_storage_manager_reap_children(bool * const need_respawn)
 
             for (size_t idx = 0;
                  found == false &&
-                     idx < cg_storage_manager_processes_count;
+                     idx < cg_storage_manager_processes_used;
                  idx++)
             {
                 pid_t const pid = cg_storage_manager_processes[idx].pid;
@@ -1142,7 +1192,7 @@ static void cg_storage_manager_master_handle_old_global_data(void)
 
     for (size_t idx = 0;
          all_old_processes_exited == true &&
-             idx < cg_storage_manager_processes_count;
+             idx < cg_storage_manager_processes_used;
          idx++)
     {
         if (cg_storage_manager_processes[idx].old_pid != (pid_t) -1)
@@ -1189,7 +1239,7 @@ static void cg_storage_manager_master_signal_cb(int sig,
     {
         /* Mark processes as exiting */
         for (size_t idx = 0;
-             idx < cg_storage_manager_processes_count;
+             idx < cg_storage_manager_processes_used;
              idx++)
         {
             cg_storage_manager_processes[idx].enabled = false;
@@ -1243,33 +1293,59 @@ static void cg_storage_manager_master_signal_cb(int sig,
 
                 if (result == 0)
                 {
-                    /* reload local events */
-                    result = cg_storage_manager_reset_local_events(new_configuration);
+                    cg_storage_listener * new_listener = NULL;
 
-                    if (result != 0)
+                    result = cg_storage_manager_server_create_listener(new_configuration,
+                                                                       &new_listener);
+
+                    if (result == 0)
                     {
-                        CGUTILS_ERROR("Error resetting local events: %d", result);
-                    }
+                        /* The old server workers keep their own copy of the old socket
+                           until they exit. */
+                        if (server_listener != NULL)
+                        {
+                            cg_storage_listener_free(server_listener), server_listener = NULL;
+                        }
 
-                    /* signal old workers */
-                    result = cg_storage_manager_send_graceful_exit_signal_to_children(CG_STORAGE_MANAGER_COMMON_GRACEFUL_EXIT_SIG,
-                                                                                      false,
-                                                                                      true);
+                        server_listener = new_listener, new_listener = NULL;
 
-                    if (result != 0)
-                    {
-                        CGUTILS_ERROR("Error gracefully stopping old workers: %d", result);
-                    }
+                        if (cg_storage_manager_get_server_workers(new_configuration) != cg_storage_manager_processes_used - cg_storage_manager_process_server)
+                        {
+                            CGUTILS_WARN("The number of server workers can not be changed without a restart.");
+                        }
+
+                        /* reload local events */
+                        result = cg_storage_manager_reset_local_events(new_configuration);
 
-                    old_global_data = global_data;
-                    global_data = new_configuration;
-                    new_configuration = NULL;
-                    event_data = cg_storage_manager_data_get_event(global_data);
-                    assert(event_data != NULL);
+                        if (result != 0)
+                        {
+                            CGUTILS_ERROR("Error resetting local events: %d", result);
+                        }
 
-                    /* start new workers */
-                    master_state = cg_storage_manager_master_respawning;
-                    cgutils_event_exit_loop(event_data);
+                        /* signal old workers */
+                        result = cg_storage_manager_send_graceful_exit_signal_to_children(CG_STORAGE_MANAGER_COMMON_GRACEFUL_EXIT_SIG,
+                                                                                          false,
+                                                                                          true);
+
+                        if (result != 0)
+                        {
+                            CGUTILS_ERROR("Error gracefully stopping old workers: %d", result);
+                        }
+
+                        old_global_data = global_data;
+                        global_data = new_configuration;
+                        new_configuration = NULL;
+                        event_data = cg_storage_manager_data_get_event(global_data);
+                        assert(event_data != NULL);
+
+                        /* start new workers */
+                        master_state = cg_storage_manager_master_respawning;
+                        cgutils_event_exit_loop(event_data);
+                    }
+                    else
+                    {
+                        CGUTILS_ERROR("Error creating server listener: %d", result);
+                    }
                 }
                 else
                 {
@@ -1298,7 +1374,7 @@ static void cg_storage_manager_master_signal_cb(int sig,
 
     for (size_t idx = 0;
          all_exited == true &&
-             idx < cg_storage_manager_processes_count;
+             idx < cg_storage_manager_processes_used;
          idx++)
     {
         if (cg_storage_manager_processes[idx].pid != (pid_t) -1 ||
@@ -1551,18 +1627,27 @@ static int cg_storage_manager_roles(char * const argv0,
 
     bool const nofork = getenv("CGSM_NOFORK") != NULL || cg_storage_manager_data_get_nofork(data) == true;
 
-    if (nofork == true)
+    result = cg_storage_manager_server_create_listener(data,
+                                                       &server_listener);
+
+    if (result != 0)
+    {
+        CGUTILS_ERROR("Error creating server listener: %d", result);
+    }
+    else if (nofork == true)
     {
-        result = cg_storage_manager_server(data, false);
+        result = cg_storage_manager_server(data, false, -1);
     }
     else
     {
+        cg_storage_manager_setup_server_workers(cg_storage_manager_get_server_workers(data));
+
         bool is_master = true;
         time_t const now = time(NULL);
 
         for (size_t idx = 0;
              result == 0 &&
-                 idx < cg_storage_manager_processes_count &&
+                 idx < cg_storage_manager_processes_used &&
                  is_master == true;
              idx++)
         {
@@ -1596,6 +1681,12 @@ static int cg_storage_manager_roles(char * const argv0,
         {
             result = cg_storage_manager_master(argv0, data);
         }
+
+        if (is_master == true &&
+            server_listener != NULL)
+        {
+            cg_storage_listener_free(server_listener), server_listener = NULL;
+        }
     }
 
     return result;
@@ -63,7 +63,9 @@ typedef struct
 
     size_t current_entry_idx;
 
-    size_t offset;
+    /* entry_id of the last entry returned by the DB,
+       the next query resumes after it */
+    uint64_t after_entry_id;
     size_t got;
     size_t remaining;
     size_t pending;
@@ -139,7 +141,7 @@ static void cg_storage_manager_cleaner_reset(cg_storage_manager_cleaner_data * c
 
     cg_storage_manager_cleaner_clean_entries_list(cleaner);
 
-    cleaner->offset = 0;
+    cleaner->after_entry_id = 0;
     cleaner->got = 0;
     cleaner->remaining = 0;
     cleaner->pending = 0;
@@ -316,6 +318,16 @@ static int cg_storage_manager_cleaner_entries_cb(int const status,
 
         if (entries_count > 0)
         {
+            cgdb_entry * last = NULL;
+
+            if (cgutils_vector_get(entries,
+                                   entries_count - 1,
+                                   (void **) &last) == 0)
+            {
+                assert(last != NULL);
+                cleaner->after_entry_id = last->entry_id;
+            }
+
             cleaner->consuming = true;
             cleaner->current_entry_idx = 0;
             cg_storage_manager_cleaner_consume_entries(cleaner);
@@ -364,8 +376,7 @@ static void cg_storage_manager_cleaner_get_entries(cg_storage_manager_cleaner_da
         assert(fs_id > 0);
 
         if (to_get > 0 &&
-            to_get < UINT32_MAX &&
-            cleaner->offset < UINT32_MAX)
+            to_get < UINT32_MAX)
         {
             int result = cgdb_get_not_dirty_entries_by_type_size_last_usage_cached(db,
                                                                                    fs_id,
@@ -373,8 +384,8 @@ static void cg_storage_manager_cleaner_get_entries(cg_storage_manager_cleaner_da
                                                                                    cleaner->min_file_size,
                                                                                    cleaner->max_access,
                                                                                    cg_storage_instance_status_dirty,
+                                                                                   cleaner->after_entry_id,
                                                                                    (uint32_t) to_get,
-                                                                                   (uint32_t) cleaner->offset,
                                                                                    &cg_storage_manager_cleaner_entries_cb,
                                                                                    cleaner);
 
@@ -385,7 +396,6 @@ static void cg_storage_manager_cleaner_get_entries(cg_storage_manager_cleaner_da
 
                 cleaner->remaining_db_slots--;
                 cleaner->pending++;
-                cleaner->offset += to_get;
             }
             else
             {
@@ -468,7 +478,7 @@ static void cg_storage_manager_cleaner_handle_fs(cg_storage_manager_cleaner_data
 
                 cleaner->max_access = ((uint64_t) now) - max_access_offset;
 
-                cleaner->offset = 0;
+                cleaner->after_entry_id = 0;
                 cleaner->got = 0;
 
                 cg_storage_manager_cleaner_get_entries(cleaner);
@@ -24,7 +24,6 @@
 #include <assert.h>
 #include <errno.h>
 #include <string.h>
-#include <time.h>
 
 #include <cgsm/cg_storage_manager_data.h>
 
@@ -38,9 +37,6 @@
 #include "cgStorageManagerServer.h"
 #include "cgStorageManagerCommon.h"
 
-#define CG_STORAGE_MANAGER_SERVER_LISTENING_RETRY_COUNT (5)
-#define CG_STORAGE_MANAGER_SERVER_LISTENING_RETRY_DELAY_MS (10) /* 10 ms */
-
 /* A value larger than /proc/sys/net/core/somaxconn will be silently
    truncated to it anyway on Linux > 2.4.25 */
 #define CG_STORAGE_MANAGER_SERVER_BACKLOG (10000)
@@ -152,145 +148,107 @@ static void cg_storage_manager_server_listener_cb(cg_storage_manager_data * cons
     }
 }
 
-static int cg_storage_manager_server_handle_old_server(cg_storage_listener * const listener,
-                                                       pid_t const old_server_pid)
+static void cg_storage_manager_server_handle_old_server(pid_t const old_server_pid)
 {
-    CGUTILS_ASSERT(listener != NULL);
     CGUTILS_ASSERT(old_server_pid != -1);
 
-    int result = cgutils_process_signal(old_server_pid,
-                                        CG_STORAGE_MANAGER_COMMON_GRACEFUL_EXIT_SIG);
+    /* The listening socket has already been bound by the master, so
+       the old server can stop accepting connections right away. */
+    int const result = cgutils_process_signal(old_server_pid,
+                                              CG_STORAGE_MANAGER_COMMON_GRACEFUL_EXIT_SIG);
 
-    if (result == 0)
-    {
-        /* nanosleep(CG_STORAGE_MANAGER_SERVER_LISTENING_RETRY_DELAY_MS); */
-    }
-    else
+    if (result != 0)
     {
-        CGUTILS_ERROR("Error sending graceful exit signal (%d) to the old server process (%lld): %d",
-                      CG_STORAGE_MANAGER_COMMON_GRACEFUL_EXIT_SIG,
-                      (long long) old_server_pid,
-                      result);
+        /* It may be because the process does not exist anymore. */
+        CGUTILS_WARN("Error sending graceful exit signal (%d) to the old server process (%lld): %d",
+                     CG_STORAGE_MANAGER_COMMON_GRACEFUL_EXIT_SIG,
+                     (long long) old_server_pid,
+                     result);
     }
+}
 
-    /* Try to bind, even if signaling the previous server failed, as it may be because the process
-       does not exist anymore. */
-
-    result = EADDRINUSE;
-
-    for (size_t count = CG_STORAGE_MANAGER_SERVER_LISTENING_RETRY_COUNT;
-         count > 0 &&
-             result == EADDRINUSE;
-         count--)
-    {
-        result = cg_storage_listener_bind(listener);
-
-        if (result != 0)
-        {
-            struct timespec const tsp =
-                {
-                    .tv_sec = 0,
-                    .tv_nsec = CG_STORAGE_MANAGER_SERVER_LISTENING_RETRY_DELAY_MS * 1000 * 1000
-                };
-
-            CGUTILS_DEBUG("Bind failed with %d, will retry soon.",
-                          result);
-
-            count--;
-
-            nanosleep(&tsp, NULL);
-        }
+int cg_storage_manager_server_create_listener(cg_storage_manager_data * const data,
+                                              cg_storage_listener ** const listener)
+{
+    CGUTILS_ASSERT(data != NULL);
+    CGUTILS_ASSERT(listener != NULL);
 
-    }
+    int result = cg_storage_listener_init(data,
+                                          listener,
+                                          true,
+                                          CG_STORAGE_MANAGER_SERVER_BACKLOG);
 
     if (result != 0)
     {
-        CGUTILS_ERROR("Error while trying to bind: %d", result);
+        CGUTILS_ERROR("Error creating listener: %s", strerror(result));
     }
 
     return result;
 }
 
 int cg_storage_manager_server_run(cg_storage_manager_data * const data,
-                                  bool graceful,
+                                  cg_storage_listener * const listener,
+                                  bool const graceful,
                                   pid_t const old_server_pid)
 {
     int result = 0;
     cg_storage_manager_server_data * server_data = cg_storage_manager_server_get_data();
     CGUTILS_ASSERT(server_data != NULL);
     CGUTILS_ASSERT(data != NULL);
+    CGUTILS_ASSERT(listener != NULL);
 
     server_data->data = data;
+    server_data->listener = listener;
 
-    if (graceful == true &&
-        old_server_pid == -1)
-    {
-        graceful = false;
-    }
-
-    result = cg_storage_listener_init(data,
-                                      &(server_data->listener),
-                                      graceful == true ? false : true,
-                                      CG_STORAGE_MANAGER_SERVER_BACKLOG);
+    result = cg_storage_manager_release_configuration(data);
 
     if (result == 0)
     {
-        CGUTILS_ASSERT(server_data->listener != NULL);
+        if (graceful == true &&
+            old_server_pid != -1)
+        {
+            cg_storage_manager_server_handle_old_server(old_server_pid);
+        }
 
-        result = cg_storage_manager_release_configuration(data);
+        result = cg_storage_listener_enable(server_data->listener,
+                                            data,
+                                            &cg_storage_manager_server_listener_cb,
+                                            server_data);
 
         if (result == 0)
         {
-            if (graceful == true)
-            {
-                result = cg_storage_manager_server_handle_old_server(server_data->listener,
-                                                                     old_server_pid);
-            }
+            result = cg_storage_manager_common_register_signal(data,
+                                                               CG_STORAGE_MANAGER_COMMON_GRACEFUL_EXIT_SIG,
+                                                               &cg_storage_manager_server_graceful_exit,
+                                                               server_data);
 
             if (result == 0)
             {
-                result = cg_storage_listener_enable(server_data->listener,
-                                                    data,
-                                                    &cg_storage_manager_server_listener_cb,
-                                                    server_data);
+                result = cg_storage_manager_loop(data);
 
-                if (result == 0)
-                {
-                    result = cg_storage_manager_common_register_signal(data,
-                                                                       CG_STORAGE_MANAGER_COMMON_GRACEFUL_EXIT_SIG,
-                                                                       &cg_storage_manager_server_graceful_exit,
-                                                                       server_data);
-
-                    if (result == 0)
-                    {
-                        result = cg_storage_manager_loop(data);
-
-                        if (result != 0)
-                        {
-                            CGUTILS_ERROR("Exiting server loop with %d", result);
-                        }
-                    }
-                    else
-                    {
-                        CGUTILS_ERROR("Error registering signal event: %d", result);
-                    }
-                }
-                else
+                if (result != 0)
                 {
-                    CGUTILS_ERROR("Error enabling listener: %s", strerror(result));
+                    CGUTILS_ERROR("Exiting server loop with %d", result);
                 }
             }
+            else
+            {
+                CGUTILS_ERROR("Error registering signal event: %d", result);
+            }
         }
         else
         {
-            CGUTILS_ERROR("Error while releasing configuration: %d", result);
+            CGUTILS_ERROR("Error enabling listener: %s", strerror(result));
         }
-
-        cg_storage_listener_free(server_data->listener), server_data->listener = NULL;
     }
     else
     {
-        CGUTILS_ERROR("Error creating listener: %s", strerror(result));
+        CGUTILS_ERROR("Error while releasing configuration: %d", result);
+    }
+
+    if (server_data->listener != NULL)
+    {
+        cg_storage_listener_free(server_data->listener), server_data->listener = NULL;
     }
 
     return result;
@@ -24,7 +24,15 @@
 #ifndef CLOUD_GATEWAY_STORAGE_MANAGER_SERVER_H_
 #define CLOUD_GATEWAY_STORAGE_MANAGER_SERVER_H_
 
+#include <cgsm/cg_storage_listener.h>
+
+/* Bound in the master so that every server worker accepts
+   connections on the same socket. */
+int cg_storage_manager_server_create_listener(cg_storage_manager_data * data,
+                                              cg_storage_listener ** listener);
+
 int cg_storage_manager_server_run(cg_storage_manager_data * data,
+                                  cg_storage_listener * listener,
                                   bool graceful,
                                   pid_t old_server_pid);
 
@@ -39,6 +39,7 @@
 #include "cgStorageManagerCommon.h"
 
 #define CG_STORAGE_MANAGER_SYNCER_DELAY_DEFAULT (5)
+#define CG_STORAGE_MANAGER_SYNCER_SAFETY_NET_DELAY_DEFAULT (60)
 #define CG_STORAGE_MANAGER_SYNCER_DIRTYNESS_DELAY_DEFAULT (10)
 #define CG_STORAGE_MANAGER_SYNCER_DB_SLOTS_DEFAULT (20)
 
@@ -59,8 +60,6 @@ typedef struct
     cgutils_llist * file_instances;
     /* elt of type cgdb_inode_instance * */
     cgutils_llist_elt * current;
-    /* DB offset for the next query (think nb of objects to skip) */
-    size_t offset;
     /* The nb of objects returned by the last DB query */
     size_t got;
     /* Number of remaining objects not handled in the file_instances list,
@@ -74,6 +73,12 @@ typedef struct
     bool error;
     bool running;
     bool consuming;
+    /* New work has been notified while running,
+       query the DB again before going to sleep */
+    bool notified;
+    /* Work has been skipped or has failed during the last run,
+       and will not be notified again */
+    bool left_work;
 } cg_storage_manager_syncer_ctx;
 
 typedef struct
@@ -98,12 +103,23 @@ struct cg_storage_manager_syncer_data
     cg_storage_manager_data * data;
     cg_monitor_data_instance_status_tab * status_tab;
     cgutils_event * timer_event;
+    /* DB notifications of new work, NULL if not available */
+    cgdb_listener * listener;
     /* llist of cg_storage_manager_syncer_task * */
     cgutils_llist * running_tasks;
     size_t remaining_db_slots;
     size_t max_db_objects_per_call;
+    size_t syncer_delay;
+    size_t safety_net_delay;
+    /* current period of the timer */
+    size_t timer_delay;
     bool exiting;
     bool dump_http_states;
+    /* The listener is ready, the timer is only a safety net */
+    bool listening;
+    /* The listener has failed, it will be replaced on the next timer event */
+    bool listener_failed;
+    bool notifications_unsupported;
 };
 
 static void cg_storage_manager_syncer_task_free(cg_storage_manager_syncer_task * task)
@@ -306,6 +322,12 @@ static void cg_storage_manager_syncer_graceful_exit(int const sig,
         }
 
         syncer_data->exiting = true;
+        syncer_data->listening = false;
+
+        if (syncer_data->listener != NULL)
+        {
+            cgdb_listener_free(syncer_data->listener), syncer_data->listener = NULL;
+        }
 
         if (syncer_data->dirty_ctx.running == false &&
             syncer_data->deleted_ctx.running == false)
@@ -345,17 +367,19 @@ static bool cg_storage_manager_syncer_instance_is_up(cg_storage_manager_syncer_d
 }
 
 static int cg_storage_manager_syncer_ctx_handle(cg_storage_manager_syncer_ctx * const ctx);
+static void cg_storage_manager_syncer_update_timer(cg_storage_manager_syncer_data * const syncer_data);
 
 static void cg_storage_manager_syncer_ctx_reset(cg_storage_manager_syncer_ctx * const ctx)
 {
     if (ctx != NULL)
     {
         assert(ctx->pending == 0);
+        bool const was_running = ctx->running;
         ctx->got = 0;
-        ctx->offset = 0;
         ctx->remaining = 0;
         ctx->running = false;
         ctx->error = false;
+        ctx->notified = false;
 
         while(ctx->current != NULL)
         {
@@ -374,6 +398,12 @@ static void cg_storage_manager_syncer_ctx_reset(cg_storage_manager_syncer_ctx *
             cgutils_llist_free(&(ctx->file_instances), NULL);
         }
 
+        if (ctx->syncer_data->exiting == false &&
+            was_running == true)
+        {
+            cg_storage_manager_syncer_update_timer(ctx->syncer_data);
+        }
+
         if (ctx->syncer_data->exiting == true &&
             ctx->syncer_data->dirty_ctx.running == false &&
             ctx->syncer_data->deleted_ctx.running == false)
@@ -397,6 +427,8 @@ static void cg_storage_manager_syncer_ctx_set_db_error(cg_storage_manager_syncer
 {
     assert(ctx != NULL);
 
+    ctx->left_work = true;
+
     if (ctx->pending == 0)
     {
         cg_storage_manager_syncer_ctx_reset(ctx);
@@ -517,11 +549,6 @@ static int cg_storage_manager_syncer_action_done(int status,
 
     if (status == 0)
     {
-        if (ctx->offset > 0)
-        {
-            ctx->offset--;
-        }
-
         if (task->inode_dirty_writers == 0 &&
             cg_storage_manager_syncer_has_auto_expunge(task) == true)
         {
@@ -535,6 +562,8 @@ static int cg_storage_manager_syncer_action_done(int status,
     }
     else
     {
+        ctx->left_work = true;
+
         CGUTILS_ERROR("Error while handling action of type %s (%d) for inode number %"PRIu64" of FS %s on instance %"PRIu64" (ID in instance %s): %d",
                       (ctx->type == cg_storage_manager_syncer_type_deleted ? "deletion" : "uploading"),
                       ctx->type,
@@ -668,6 +697,7 @@ static int cg_storage_manager_syncer_ctx_handle_element(cg_storage_manager_synce
 
         if (result != 0)
         {
+            ctx->left_work = true;
             ctx->syncer_data->remaining_db_slots++;
             ctx->pending--;
             cg_storage_manager_syncer_remove_task(task);
@@ -777,6 +807,8 @@ static void cg_storage_manager_syncer_ctx_consume(cg_storage_manager_syncer_ctx
 
         if (file_instance != NULL)
         {
+            /* skipped, it stays in the queue */
+            ctx->left_work = true;
             cgdb_inode_instance_free(file_instance), file_instance = NULL;
         }
     }
@@ -806,7 +838,6 @@ static int cg_storage_manager_syncer_ctx_db_list_cb(int status,
         size_t const count = cgutils_llist_get_count(files_instances);
         ctx->got = count;
         ctx->remaining = count;
-        ctx->offset += count;
         ctx->file_instances = files_instances;
         ctx->current = cgutils_llist_get_iterator(files_instances);
 
@@ -853,8 +884,7 @@ static int cg_storage_manager_syncer_ctx_get_object_from_db(cg_storage_manager_s
         size_t const to_get = cg_storage_manager_syncer_compute_objects_per_call(ctx);
 
         if (to_get > 0 &&
-            to_get < UINT32_MAX &&
-            ctx->offset < UINT32_MAX)
+            to_get < UINT32_MAX)
         {
             cg_storage_instance_status status;
 
@@ -868,16 +898,18 @@ static int cg_storage_manager_syncer_ctx_get_object_from_db(cg_storage_manager_s
                 status = cg_storage_instance_status_dirty;
             }
 
-            result = cgdb_get_inode_instances_by_status(db,
-                                                        status,
-                                                        (uint32_t) to_get,
-                                                        (uint32_t) ctx->offset,
-                                                        &cg_storage_manager_syncer_ctx_db_list_cb,
-                                                        ctx);
-
-/*            CGUTILS_TRACE("Asking %zu, offset %zu, type %s",
+            /* Claimed objects are leased until the next run, so the next
+               call of this run returns the following ones. Objects skipped
+               during this run are retried once their lease expires. */
+            result = cgdb_claim_inode_instances_by_status(db,
+                                                          status,
+                                                          syncer_data->syncer_delay,
+                                                          (uint32_t) to_get,
+                                                          &cg_storage_manager_syncer_ctx_db_list_cb,
+                                                          ctx);
+
+/*            CGUTILS_TRACE("Asking %zu, type %s",
                            to_get,
-                           ctx->offset,
                            ctx->type == cg_storage_manager_syncer_type_deleted ? "deleted" : "dirty");*/
 
             if (result == 0)
@@ -894,9 +926,8 @@ static int cg_storage_manager_syncer_ctx_get_object_from_db(cg_storage_manager_s
         }
         else
         {
-            CGUTILS_ERROR("Invalid number of objects (%zu) to retrieve, or invalid offset (%zu)",
-                          to_get,
-                          ctx->offset);
+            CGUTILS_ERROR("Invalid number of objects (%zu) to retrieve",
+                          to_get);
             cg_storage_manager_syncer_ctx_set_db_error(ctx);
         }
     }
@@ -964,7 +995,16 @@ static int cg_storage_manager_syncer_ctx_handle(cg_storage_manager_syncer_ctx *
             {
                 if (ctx->got == 0)
                 {
-                    if (ctx->pending == 0)
+                    if (ctx->notified == true &&
+                        syncer_data->remaining_db_slots > 0 &&
+                        ctx->fetching_from_db == false)
+                    {
+                        /* new work has been notified after the last DB call */
+                        ctx->notified = false;
+                        cgutils_llist_free(&(ctx->file_instances), NULL);
+                        result = cg_storage_manager_syncer_ctx_get_object_from_db(ctx);
+                    }
+                    else if (ctx->pending == 0)
                     {
 //                    CGUTILS_TRACE("No objects remaining, last DB call returned nothing, nothing pending, sleeping");
                         /* last request returned no data, clean up and wait for the next timer event. */
@@ -979,9 +1019,8 @@ static int cg_storage_manager_syncer_ctx_handle(cg_storage_manager_syncer_ctx *
                 else if (syncer_data->remaining_db_slots > 0 &&
                          ctx->fetching_from_db == false)
                 {
-/*                CGUTILS_TRACE("No objects remaining, last DB call returned some data (%zu) or had an offset (%zu), we have DB slots (%zu), getting from DB",
+/*                CGUTILS_TRACE("No objects remaining, last DB call returned some data (%zu), we have DB slots (%zu), getting from DB",
                   ctx->got,
-                  ctx->offset,
                   syncer_data->remaining_db_slots);*/
 
                     /* fetch more object from db */
@@ -992,9 +1031,8 @@ static int cg_storage_manager_syncer_ctx_handle(cg_storage_manager_syncer_ctx *
                 }
                 else if (ctx->pending == 0)
                 {
-/*                CGUTILS_TRACE("No objects remaining, last DB call returned some data (%zu) or had an offset (%zu), but no DB slots, nothing pending, resetting",
-                  ctx->got,
-                  ctx->offset);*/
+/*                CGUTILS_TRACE("No objects remaining, last DB call returned some data (%zu), but no DB slots, nothing pending, resetting",
+                  ctx->got);*/
                     cg_storage_manager_syncer_ctx_reset(ctx);
                 }
                 else
@@ -1009,6 +1047,7 @@ static int cg_storage_manager_syncer_ctx_handle(cg_storage_manager_syncer_ctx *
     else
     {
         ctx->running = true;
+        ctx->left_work = false;
 
         result = cg_storage_manager_syncer_ctx_get_object_from_db(ctx);
     }
@@ -1016,12 +1055,195 @@ static int cg_storage_manager_syncer_ctx_handle(cg_storage_manager_syncer_ctx *
     return result;
 }
 
+static size_t cg_storage_manager_syncer_get_timer_delay(cg_storage_manager_syncer_data const * const syncer_data)
+{
+    assert(syncer_data != NULL);
+    size_t result = syncer_data->syncer_delay;
+
+    /* Skipped and failed objects are put back without any notification,
+       keep polling at the syncer delay until a run leaves nothing behind. */
+    if (syncer_data->listening == true &&
+        syncer_data->dirty_ctx.left_work == false &&
+        syncer_data->deleted_ctx.left_work == false)
+    {
+        result = syncer_data->safety_net_delay;
+    }
+
+    return result;
+}
+
+static int cg_storage_manager_syncer_enable_timer(cg_storage_manager_syncer_data * const syncer_data)
+{
+    int result = 0;
+    assert(syncer_data != NULL);
+    assert(syncer_data->timer_event != NULL);
+
+    syncer_data->timer_delay = cg_storage_manager_syncer_get_timer_delay(syncer_data);
+
+    struct timeval tv =
+        {
+            .tv_sec = (time_t) syncer_data->timer_delay,
+            .tv_usec = 0
+        };
+
+    cgutils_event_disable(syncer_data->timer_event);
+
+    result = cgutils_event_enable(syncer_data->timer_event, &tv);
+
+    if (result != 0)
+    {
+        CGUTILS_ERROR("Error enabling timer event: %d", result);
+    }
+
+    return result;
+}
+
+static void cg_storage_manager_syncer_update_timer(cg_storage_manager_syncer_data * const syncer_data)
+{
+    assert(syncer_data != NULL);
+
+    /* re-arming postpones the next event, only do it when the period changes */
+    if (syncer_data->timer_event != NULL &&
+        syncer_data->timer_delay != cg_storage_manager_syncer_get_timer_delay(syncer_data))
+    {
+        cg_storage_manager_syncer_enable_timer(syncer_data);
+    }
+}
+
+static void cg_storage_manager_syncer_ctx_wakeup(cg_storage_manager_syncer_ctx * const ctx)
+{
+    assert(ctx != NULL);
+    assert(ctx->syncer_data != NULL);
+
+    if (ctx->syncer_data->exiting == false)
+    {
+        if (ctx->running == false)
+        {
+            int const result = cg_storage_manager_syncer_ctx_handle(ctx);
+
+            if (result != 0)
+            {
+                CGUTILS_ERROR("Error handling %s files: %d",
+                              ctx->type == cg_storage_manager_syncer_type_deleted ? "deleted" : "dirty",
+                              result);
+            }
+        }
+        else
+        {
+            ctx->notified = true;
+        }
+    }
+}
+
+static int cg_storage_manager_syncer_notification_cb(int const status,
+                                                     char const * const payload,
+                                                     void * const cb_data)
+{
+    cg_storage_manager_syncer_data * const syncer_data = cb_data;
+    int result = status;
+    assert(cb_data != NULL);
+
+    if (status == 0)
+    {
+        if (payload == NULL)
+        {
+            /* Listening from now on. Catch up with anything queued
+               before that, then rely on notifications. */
+            syncer_data->listening = true;
+
+            result = cg_storage_manager_syncer_enable_timer(syncer_data);
+
+            cg_storage_manager_syncer_ctx_wakeup(&(syncer_data->dirty_ctx));
+            cg_storage_manager_syncer_ctx_wakeup(&(syncer_data->deleted_ctx));
+        }
+        else
+        {
+            uint64_t instance_status = 0;
+
+            result = cgutils_str_to_unsigned_int64(payload, &instance_status);
+
+            if (result == 0 &&
+                instance_status == cg_storage_instance_status_deleting)
+            {
+                cg_storage_manager_syncer_ctx_wakeup(&(syncer_data->deleted_ctx));
+            }
+            else if (result == 0 &&
+                     instance_status == cg_storage_instance_status_dirty)
+            {
+                cg_storage_manager_syncer_ctx_wakeup(&(syncer_data->dirty_ctx));
+            }
+            else
+            {
+                CGUTILS_WARN("Ignoring unexpected notification payload %s: %d",
+                             payload,
+                             result);
+            }
+        }
+    }
+    else
+    {
+        CGUTILS_WARN("Lost DB notifications, falling back to polling every %zu seconds: %d",
+                     syncer_data->syncer_delay,
+                     status);
+
+        syncer_data->listening = false;
+        syncer_data->listener_failed = true;
+
+        if (syncer_data->exiting == false)
+        {
+            result = cg_storage_manager_syncer_enable_timer(syncer_data);
+        }
+    }
+
+    return result;
+}
+
+static void cg_storage_manager_syncer_listen(cg_storage_manager_syncer_data * const syncer_data)
+{
+    assert(syncer_data != NULL);
+    assert(syncer_data->listener == NULL);
+    cgdb_data * db = cg_storage_manager_data_get_db(syncer_data->data);
+    assert(db != NULL);
+
+    int const result = cgdb_listen(db,
+                                   CGDB_SYNCER_WORK_CHANNEL,
+                                   &cg_storage_manager_syncer_notification_cb,
+                                   syncer_data,
+                                   &(syncer_data->listener));
+
+    if (result == ENOSYS)
+    {
+        CGUTILS_INFO("DB notifications are not supported by the DB backend, polling every %zu seconds",
+                     syncer_data->syncer_delay);
+        syncer_data->notifications_unsupported = true;
+    }
+    else if (result != 0)
+    {
+        CGUTILS_WARN("Error listening for DB notifications, polling every %zu seconds: %d",
+                     syncer_data->syncer_delay,
+                     result);
+    }
+}
+
 static void cg_storage_manager_syncer_timer_cb(void * cb_data)
 {
     cg_storage_manager_syncer_data * const syncer_data = cb_data;
     assert(cb_data != NULL);
     assert(syncer_data->data != NULL);
 
+    if (syncer_data->listener_failed == true)
+    {
+        cgdb_listener_free(syncer_data->listener), syncer_data->listener = NULL;
+        syncer_data->listener_failed = false;
+    }
+
+    if (syncer_data->exiting == false &&
+        syncer_data->listener == NULL &&
+        syncer_data->notifications_unsupported == false)
+    {
+        cg_storage_manager_syncer_listen(syncer_data);
+    }
+
     if (syncer_data->dump_http_states == true)
     {
         cgutils_http_data * http = cg_storage_manager_data_get_http(syncer_data->data);
@@ -1073,13 +1295,6 @@ static int cg_storage_manager_syncer_dirty_writers_cleared(int const status,
 
     if (status == 0)
     {
-        size_t syncer_delay = cg_storage_manager_data_get_syncer_delay(data);
-
-        if (syncer_delay == 0)
-        {
-            syncer_delay = CG_STORAGE_MANAGER_SYNCER_DELAY_DEFAULT;
-        }
-
         result = cg_storage_manager_common_register_signal(data,
                                                            CG_STORAGE_MANAGER_COMMON_GRACEFUL_EXIT_SIG,
                                                            &cg_storage_manager_syncer_graceful_exit,
@@ -1087,19 +1302,12 @@ static int cg_storage_manager_syncer_dirty_writers_cleared(int const status,
 
         if (result == 0)
         {
-            struct timeval tv =
-                {
-                    .tv_sec = (time_t) syncer_delay,
-                    .tv_usec = 0
-                };
-
-            assert(syncer_data->timer_event != NULL);
+            result = cg_storage_manager_syncer_enable_timer(syncer_data);
 
-            result = cgutils_event_enable(syncer_data->timer_event, &tv);
-
-            if (result != 0)
+            if (result == 0)
             {
-                CGUTILS_ERROR("Error enabling timer event: %d", result);
+                /* not fatal, we keep polling if it fails */
+                cg_storage_manager_syncer_listen(syncer_data);
             }
         }
         else
@@ -1197,6 +1405,20 @@ int cg_storage_manager_syncer_run(cg_storage_manager_data * const data,
 
             syncer_data->dump_http_states = cg_storage_manager_data_get_syncer_dump_http_states(data);
 
+            syncer_data->syncer_delay = cg_storage_manager_data_get_syncer_delay(data);
+
+            if (syncer_data->syncer_delay == 0)
+            {
+                syncer_data->syncer_delay = CG_STORAGE_MANAGER_SYNCER_DELAY_DEFAULT;
+            }
+
+            syncer_data->safety_net_delay = cg_storage_manager_data_get_syncer_safety_net_delay(data);
+
+            if (syncer_data->safety_net_delay == 0)
+            {
+                syncer_data->safety_net_delay = CG_STORAGE_MANAGER_SYNCER_SAFETY_NET_DELAY_DEFAULT;
+            }
+
             result = cgutils_event_create_timer_event(event_data,
                                                       CGUTILS_EVENT_PERSIST,
                                                       &cg_storage_manager_syncer_timer_cb,
@@ -1236,6 +1458,11 @@ int cg_storage_manager_syncer_run(cg_storage_manager_data * const data,
 
                     cgutils_event_free(syncer_data->timer_event), syncer_data->timer_event = NULL;
 
+                    if (syncer_data->listener != NULL)
+                    {
+                        cgdb_listener_free(syncer_data->listener), syncer_data->listener = NULL;
+                    }
+
                     cgutils_llist_free(&(syncer_data->running_tasks), &cg_storage_manager_syncer_task_delete);
                 }
                 else
@@ -0,0 +1,287 @@
+/*
+ * This file is part of Nuage Labs SAS's Cloud Gateway.
+ *
+ * Copyright (C) 2011-2017  Nuage Labs SAS
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * In addition, for the avoidance of any doubt, permission is granted to
+ * link this program with OpenSSL and to (re)distribute the binaries
+ * produced as the result of such linking.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <cloudutils/cloudutils.h>
+#include <cloudutils/cloudutils_arena.h>
+
+/* Enough for any scalar type on the platforms we support */
+#define CGUTILS_ARENA_ALIGNMENT (2 * sizeof (void *))
+#define CGUTILS_ARENA_ALIGN(size) (((size) + CGUTILS_ARENA_ALIGNMENT - 1) & ~(CGUTILS_ARENA_ALIGNMENT - 1))
+
+typedef struct cgutils_arena_block cgutils_arena_block;
+
+struct cgutils_arena_block
+{
+    cgutils_arena_block * next;
+    size_t size;
+    size_t used;
+};
+
+struct cgutils_arena
+{
+    /* block we are currently bumping into */
+    cgutils_arena_block * current;
+    /* allocated along with the arena, never freed on reset */
+    cgutils_arena_block * first;
+    size_t block_size;
+    /* sum of the used sizes of the blocks other than current */
+    size_t used_in_previous;
+};
+
+#define CGUTILS_ARENA_HEADER_SIZE CGUTILS_ARENA_ALIGN(sizeof (cgutils_arena))
+#define CGUTILS_ARENA_BLOCK_HEADER_SIZE CGUTILS_ARENA_ALIGN(sizeof (cgutils_arena_block))
+
+static inline char * cgutils_arena_block_data(cgutils_arena_block * const block)
+{
+    return ((char *) block) + CGUTILS_ARENA_BLOCK_HEADER_SIZE;
+}
+
+int cgutils_arena_init(size_t const block_size,
+                       cgutils_arena ** const out)
+{
+    int result = EINVAL;
+
+    if (block_size > 0 &&
+        block_size <= (SIZE_MAX / 2) &&
+        out != NULL)
+    {
+        size_t const aligned_block_size = CGUTILS_ARENA_ALIGN(block_size);
+        char * memory = NULL;
+
+        CGUTILS_MALLOC(memory,
+                       CGUTILS_ARENA_HEADER_SIZE + CGUTILS_ARENA_BLOCK_HEADER_SIZE + aligned_block_size,
+                       1);
+
+        if (memory != NULL)
+        {
+            cgutils_arena * this = (cgutils_arena *) (void *) memory;
+            cgutils_arena_block * first = (cgutils_arena_block *) (void *) (memory + CGUTILS_ARENA_HEADER_SIZE);
+
+            *first = (cgutils_arena_block) { 0 };
+            first->size = aligned_block_size;
+
+            *this = (cgutils_arena) { 0 };
+            this->first = first;
+            this->current = first;
+            this->block_size = aligned_block_size;
+
+            *out = this;
+            result = 0;
+        }
+        else
+        {
+            result = ENOMEM;
+        }
+    }
+
+    return result;
+}
+
+static void cgutils_arena_free_blocks(cgutils_arena * const this)
+{
+    cgutils_arena_block * block = this->current;
+
+    while (block != NULL)
+    {
+        cgutils_arena_block * next = block->next;
+
+        if (block != this->first)
+        {
+            CGUTILS_FREE(block);
+        }
+
+        block = next;
+    }
+}
+
+void cgutils_arena_reset(cgutils_arena * const this)
+{
+    if (this != NULL)
+    {
+        cgutils_arena_free_blocks(this);
+
+        this->first->next = NULL;
+        this->first->used = 0;
+        this->current = this->first;
+        this->used_in_previous = 0;
+    }
+}
+
+void cgutils_arena_free(cgutils_arena * this)
+{
+    if (this != NULL)
+    {
+        cgutils_arena_free_blocks(this);
+        this->current = NULL;
+        this->first = NULL;
+
+        CGUTILS_FREE(this);
+    }
+}
+
+void * cgutils_arena_alloc(cgutils_arena * const this,
+                           size_t const size)
+{
+    void * result = NULL;
+
+    if (COMPILER_LIKELY(this != NULL &&
+                        size <= (SIZE_MAX / 2)))
+    {
+        /* distinct non-NULL pointers for 0-sized allocations, like most malloc() */
+        size_t const aligned_size = CGUTILS_ARENA_ALIGN(size > 0 ? size : 1);
+        cgutils_arena_block * current = this->current;
+
+        if (COMPILER_LIKELY(current->size - current->used >= aligned_size))
+        {
+            result = cgutils_arena_block_data(current) + current->used;
+            current->used += aligned_size;
+        }
+        else
+        {
+            /* large allocations get a block of their own, placed behind
+               the current one so that we keep bumping into it */
+            bool const dedicated = aligned_size > (this->block_size / 2);
+            size_t const new_block_size = dedicated ? aligned_size : this->block_size;
+            cgutils_arena_block * block = NULL;
+
+            CGUTILS_MALLOC(block,
+                           CGUTILS_ARENA_BLOCK_HEADER_SIZE + new_block_size,
+                           1);
+
+            if (COMPILER_LIKELY(block != NULL))
+            {
+                *block = (cgutils_arena_block) { 0 };
+                block->size = new_block_size;
+                block->used = aligned_size;
+                result = cgutils_arena_block_data(block);
+
+                if (dedicated == true)
+                {
+                    block->next = current->next;
+                    current->next = block;
+                    this->used_in_previous += aligned_size;
+                }
+                else
+                {
+                    block->next = current;
+                    this->current = block;
+                    this->used_in_previous += current->used;
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+void * cgutils_arena_calloc(cgutils_arena * const this,
+                            size_t const count,
+                            size_t const size)
+{
+    void * result = NULL;
+
+    if (COMPILER_LIKELY(size == 0 ||
+                        count <= (SIZE_MAX / size)))
+    {
+        result = cgutils_arena_alloc(this, count * size);
+
+        if (COMPILER_LIKELY(result != NULL))
+        {
+            memset(result, 0, count * size);
+        }
+    }
+
+    return result;
+}
+
+void * cgutils_arena_memdup(cgutils_arena * const this,
+                            void const * const data,
+                            size_t const size)
+{
+    void * result = NULL;
+
+    if (COMPILER_LIKELY(data != NULL || size == 0))
+    {
+        result = cgutils_arena_alloc(this, size);
+
+        if (COMPILER_LIKELY(result != NULL &&
+                            size > 0))
+        {
+            memcpy(result, data, size);
+        }
+    }
+
+    return result;
+}
+
+char * cgutils_arena_strndup(cgutils_arena * const this,
+                             char const * const str,
+                             size_t const len)
+{
+    char * result = NULL;
+
+    if (COMPILER_LIKELY(str != NULL &&
+                        len < SIZE_MAX))
+    {
+        size_t const str_len = strnlen(str, len);
+
+        result = cgutils_arena_alloc(this, str_len + 1);
+
+        if (COMPILER_LIKELY(result != NULL))
+        {
+            memcpy(result, str, str_len);
+            result[str_len] = '\0';
+        }
+    }
+
+    return result;
+}
+
+char * cgutils_arena_strdup(cgutils_arena * const this,
+                            char const * const str)
+{
+    char * result = NULL;
+
+    if (COMPILER_LIKELY(str != NULL))
+    {
+        result = cgutils_arena_memdup(this, str, strlen(str) + 1);
+    }
+
+    return result;
+}
+
+size_t cgutils_arena_get_used_size(cgutils_arena const * const this)
+{
+    size_t result = 0;
+
+    if (this != NULL)
+    {
+        result = this->used_in_previous + this->current->used;
+    }
+
+    return result;
+}
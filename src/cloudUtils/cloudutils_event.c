@@ -24,10 +24,15 @@
 #include <assert.h>
 #include <errno.h>
 #include <inttypes.h>
+#include <limits.h>
 #include <signal.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 
+#include <sys/socket.h>
+#include <sys/uio.h>
+
 #include "cloudutils/cloudutils.h"
 #include "cloudutils/cloudutils_event.h"
 #include "cloudutils_event_internal.h"
@@ -600,6 +605,20 @@ struct cgutils_event_buffered_io
     cgutils_llist * elements;
     cgutils_llist_elt * current_elt;
     cgutils_event * event;
+    /* memory-backed IO only */
+    cgutils_event_buffered_io_flush_cb * flush_cb;
+    void * flush_cb_data;
+    /* ring-backed IO only, fd being the one we wait on */
+    cgutils_ring * ring;
+    int notify_fd;
+    char * input;
+    char * output;
+    size_t input_size;
+    size_t input_pos;
+    size_t output_size;
+    /* includes the headroom */
+    size_t output_len;
+    size_t output_headroom;
     size_t position_in_element;
     int fd;
     int error;
@@ -607,8 +626,19 @@ struct cgutils_event_buffered_io
     bool active;
     bool released;
     bool in_callback;
+    bool memory;
+    bool input_set;
 };
 
+/* memory-backed IOs are processed from the next loop iteration */
+static struct timeval const cgutils_event_buffered_io_immediately = { 0, 0 };
+
+#ifdef IOV_MAX
+#define CGUTILS_EVENT_BUFFERED_IO_IOV_MAX (IOV_MAX)
+#else
+#define CGUTILS_EVENT_BUFFERED_IO_IOV_MAX (16)
+#endif /* IOV_MAX */
+
 static void cgutils_event_buffered_io_obj_delete(void * obj)
 {
     if (obj != NULL)
@@ -617,6 +647,11 @@ static void cgutils_event_buffered_io_obj_delete(void * obj)
 
         if (COMPILER_LIKELY(io_obj->do_not_free == false))
         {
+            if (io_obj->free_object == true)
+            {
+                CGUTILS_FREE(io_obj->object);
+            }
+
             CGUTILS_FREE(obj);
         }
     }
@@ -634,22 +669,276 @@ static int cgutils_event_buffered_io_change_action(cgutils_event_buffered_io * c
     {
         this->action = new_action;
 
-        result = cgutils_event_change_action(this->event,
-                                             (new_action == cgutils_event_buffered_io_reading ?
-                                              CGUTILS_EVENT_READ :
-                                              CGUTILS_EVENT_WRITE
-                                                 )|CGUTILS_EVENT_PERSIST);
+        /* ring-backed IOs are always woken up through their fd */
+        if (this->memory == false &&
+            this->ring == NULL)
+        {
+            result = cgutils_event_change_action(this->event,
+                                                 (new_action == cgutils_event_buffered_io_reading ?
+                                                  CGUTILS_EVENT_READ :
+                                                  CGUTILS_EVENT_WRITE
+                                                     )|CGUTILS_EVENT_PERSIST);
 
-        if (COMPILER_UNLIKELY(result != 0))
+            if (COMPILER_UNLIKELY(result != 0))
+            {
+                this->active = false;
+                CGUTILS_ERROR("Error creating new event: %d", result);
+            }
+        }
+    }
+
+    return result;
+}
+
+static ssize_t cgutils_event_buffered_io_memory_transfer(cgutils_event_buffered_io * const io,
+                                                         cgutils_event_buffered_io_obj const * const obj)
+{
+    ssize_t result = -1;
+    CGUTILS_ASSERT(io != NULL);
+    CGUTILS_ASSERT(obj != NULL);
+    CGUTILS_ASSERT(obj->object_size > io->position_in_element);
+    size_t const wanted = obj->object_size - io->position_in_element;
+
+    if (io->action == cgutils_event_buffered_io_reading)
+    {
+        if (io->input_set == true)
+        {
+            size_t const available = io->input_size - io->input_pos;
+            size_t const len = available < wanted ? available : wanted;
+
+            if (len > 0)
+            {
+                memcpy(((char *)obj->object) + io->position_in_element,
+                       io->input + io->input_pos,
+                       len);
+                io->input_pos += len;
+            }
+
+            /* 0 means that we reached the end of the input */
+            result = (ssize_t) len;
+        }
+        else
+        {
+            errno = EAGAIN;
+        }
+    }
+    else
+    {
+        if (io->output == NULL)
+        {
+            io->output_len = io->output_headroom;
+        }
+
+        if (io->output_len + wanted > io->output_size)
+        {
+            char * new_output = NULL;
+            size_t new_size = io->output_size * 2;
+
+            if (new_size < io->output_len + wanted)
+            {
+                new_size = io->output_len + wanted;
+            }
+
+            CGUTILS_REALLOC(new_output, io->output, new_size, 1);
+
+            if (COMPILER_LIKELY(new_output != NULL))
+            {
+                io->output = new_output;
+                io->output_size = new_size;
+            }
+        }
+
+        if (COMPILER_LIKELY(io->output_len + wanted <= io->output_size))
+        {
+            memcpy(io->output + io->output_len,
+                   ((char const *)obj->object) + io->position_in_element,
+                   wanted);
+            io->output_len += wanted;
+
+            result = (ssize_t) wanted;
+        }
+        else
+        {
+            errno = ENOMEM;
+        }
+    }
+
+    return result;
+}
+
+static ssize_t cgutils_event_buffered_io_fd_transfer(cgutils_event_buffered_io * const io,
+                                                     cgutils_event_buffered_io_obj const * const obj)
+{
+    ssize_t result = -1;
+    CGUTILS_ASSERT(io != NULL);
+    CGUTILS_ASSERT(obj != NULL);
+    CGUTILS_ASSERT(obj->object_size == sizeof (int));
+    CGUTILS_ASSERT(io->position_in_element == 0);
+    int * const fd = obj->object;
+    /* a file descriptor has to be carried by at least one byte of data */
+    char marker = 0;
+    struct iovec iov = { .iov_base = &marker, .iov_len = sizeof marker };
+    union
+    {
+        char buffer[CMSG_SPACE(sizeof (int))];
+        struct cmsghdr align;
+    } control;
+    struct msghdr msg =
+        {
+            .msg_iov = &iov,
+            .msg_iovlen = 1,
+            .msg_control = control.buffer,
+            .msg_controllen = sizeof control.buffer
+        };
+
+    memset(&control, 0, sizeof control);
+
+    if (io->action == cgutils_event_buffered_io_writing)
+    {
+        struct cmsghdr * const cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof (int));
+        memcpy(CMSG_DATA(cmsg), fd, sizeof (int));
+
+        result = sendmsg(io->fd, &msg, MSG_NOSIGNAL);
+    }
+    else
+    {
+        result = recvmsg(io->fd, &msg, MSG_CMSG_CLOEXEC);
+
+        if (result > 0)
+        {
+            struct cmsghdr * const cmsg = CMSG_FIRSTHDR(&msg);
+
+            if (COMPILER_LIKELY(cmsg != NULL &&
+                                (msg.msg_flags & MSG_CTRUNC) == 0 &&
+                                cmsg->cmsg_level == SOL_SOCKET &&
+                                cmsg->cmsg_type == SCM_RIGHTS &&
+                                cmsg->cmsg_len == CMSG_LEN(sizeof (int))))
+            {
+                memcpy(fd, CMSG_DATA(cmsg), sizeof (int));
+            }
+            else
+            {
+                result = -1;
+                errno = EBADMSG;
+            }
+        }
+    }
+
+    if (result > 0)
+    {
+        result = (ssize_t) obj->object_size;
+    }
+
+    return result;
+}
+
+static void cgutils_event_buffered_io_ring_notify(int const fd)
+{
+    uint64_t const value = 1;
+
+    ssize_t const res = write(fd, &value, sizeof value);
+
+    if (COMPILER_UNLIKELY(res != (ssize_t) sizeof value &&
+                          errno != EAGAIN))
+    {
+        CGUTILS_ERROR("Error notifying ring peer on FD %d: %d",
+                      fd,
+                      errno);
+    }
+}
+
+static void cgutils_event_buffered_io_ring_clear(int const fd)
+{
+    uint64_t value = 0;
+
+    ssize_t const res = read(fd, &value, sizeof value);
+
+    if (COMPILER_UNLIKELY(res != (ssize_t) sizeof value &&
+                          errno != EAGAIN))
+    {
+        CGUTILS_ERROR("Error clearing ring notification on FD %d: %d",
+                      fd,
+                      errno);
+    }
+}
+
+/* Gather the consecutive objects sharing the current action,
+   so that they can be transferred with a single readv() / writev().
+   A read stops at the first object having a callback, since the callback
+   may release or deactivate the IO, and bytes read past it would be lost. */
+static int cgutils_event_buffered_io_fill_iovec(cgutils_event_buffered_io const * const io,
+                                                struct iovec * const iov,
+                                                int const iov_max)
+{
+    int result = 0;
+    CGUTILS_ASSERT(io != NULL);
+    CGUTILS_ASSERT(iov != NULL);
+    CGUTILS_ASSERT(iov_max > 0);
+    size_t offset = io->position_in_element;
+
+    for (cgutils_llist_elt * elt = io->current_elt;
+         elt != NULL && result < iov_max;
+         elt = cgutils_llist_elt_get_next(elt))
+    {
+        cgutils_event_buffered_io_obj const * const obj = cgutils_llist_elt_get_object(elt);
+        CGUTILS_ASSERT(obj != NULL);
+
+        if (obj->action != io->action ||
+            obj->pass_fd == true)
+        {
+            break;
+        }
+
+        CGUTILS_ASSERT(obj->object_size > offset);
+
+        iov[result].iov_base = ((char *) obj->object) + offset;
+        iov[result].iov_len = obj->object_size - offset;
+        result++;
+        offset = 0;
+
+        if (obj->cb != NULL &&
+            io->action == cgutils_event_buffered_io_reading)
         {
-            this->active = false;
-            CGUTILS_ERROR("Error creating new event: %d", result);
+            break;
         }
     }
 
     return result;
 }
 
+static ssize_t cgutils_event_buffered_io_ring_transfer(cgutils_event_buffered_io * const io,
+                                                       struct iovec * const iov,
+                                                       int const iov_max)
+{
+    ssize_t result = -1;
+    bool notify_peer = false;
+    CGUTILS_ASSERT(io != NULL);
+    CGUTILS_ASSERT(io->ring != NULL);
+
+    int const iov_count = cgutils_event_buffered_io_fill_iovec(io,
+                                                               iov,
+                                                               iov_max);
+
+    if (io->action == cgutils_event_buffered_io_reading)
+    {
+        result = cgutils_ring_readv(io->ring, iov, iov_count, &notify_peer);
+    }
+    else
+    {
+        result = cgutils_ring_writev(io->ring, iov, iov_count, &notify_peer);
+    }
+
+    if (notify_peer == true)
+    {
+        cgutils_event_buffered_io_ring_notify(io->notify_fd);
+    }
+
+    return result;
+}
+
 static void cgutils_event_buffered_io_event_cb(int fd, short flags, void * cb_data)
 {
     int result = 0;
@@ -663,6 +952,13 @@ static void cgutils_event_buffered_io_event_cb(int fd, short flags, void * cb_da
 
     (void) flags;
 
+    struct iovec iov[CGUTILS_EVENT_BUFFERED_IO_IOV_MAX];
+
+    if (io->ring != NULL)
+    {
+        cgutils_event_buffered_io_ring_clear(fd);
+    }
+
     do
     {
         cgutils_event_buffered_io_obj * obj = cgutils_llist_elt_get_object(io->current_elt);
@@ -670,91 +966,149 @@ static void cgutils_event_buffered_io_event_cb(int fd, short flags, void * cb_da
 
         ssize_t res = 0;
 
-        if (io->action == cgutils_event_buffered_io_reading)
+        if (io->memory == true)
+        {
+            res = cgutils_event_buffered_io_memory_transfer(io, obj);
+        }
+        else if (io->ring != NULL)
+        {
+            res = cgutils_event_buffered_io_ring_transfer(io,
+                                                          iov,
+                                                          CGUTILS_EVENT_BUFFERED_IO_IOV_MAX);
+        }
+        else if (obj->pass_fd == true)
         {
-            res = read(fd,
-                       ((char *)obj->object) + io->position_in_element,
-                       obj->object_size - io->position_in_element);
+            res = cgutils_event_buffered_io_fd_transfer(io, obj);
         }
         else
         {
-            res = write(fd,
-                        ((char const *)obj->object) + io->position_in_element,
-                        obj->object_size - io->position_in_element);
+            int const iov_count = cgutils_event_buffered_io_fill_iovec(io,
+                                                                       iov,
+                                                                       CGUTILS_EVENT_BUFFERED_IO_IOV_MAX);
+
+            if (io->action == cgutils_event_buffered_io_reading)
+            {
+                res = readv(fd, iov, iov_count);
+            }
+            else
+            {
+                res = writev(fd, iov, iov_count);
+            }
         }
 
         if (COMPILER_LIKELY(res > 0))
         {
-            io->position_in_element += (size_t) res;
+            size_t remaining = (size_t) res;
+            bool const reading = io->action == cgutils_event_buffered_io_reading;
 
-            if (io->position_in_element == obj->object_size)
+            /* the transferred bytes may span several objects */
+            while (remaining > 0 &&
+                   obj != NULL)
             {
-                bool const delete = obj->do_not_free == false;
-                io->position_in_element = 0;
-
-                cgutils_llist_elt * next = cgutils_llist_elt_get_next(io->current_elt);
+                size_t const missing = obj->object_size - io->position_in_element;
+                size_t const done = remaining < missing ? remaining : missing;
 
-                int const remove_result = cgutils_llist_remove(io->elements,
-                                                               io->current_elt);
+                io->position_in_element += done;
+                remaining -= done;
 
-                if (COMPILER_UNLIKELY(remove_result != 0))
+                if (io->position_in_element == obj->object_size)
                 {
-                    CGUTILS_ERROR("Error while removing list elt: %d",
-                                  remove_result);
+                    bool const delete = obj->do_not_free == false;
+                    int status = 0;
+                    io->position_in_element = 0;
 
-                    if (result == 0)
+                    cgutils_llist_elt * next = cgutils_llist_elt_get_next(io->current_elt);
+
+                    int const remove_result = cgutils_llist_remove(io->elements,
+                                                                   io->current_elt);
+
+                    if (COMPILER_UNLIKELY(remove_result != 0))
                     {
-                        result = remove_result;
+                        CGUTILS_ERROR("Error while removing list elt: %d",
+                                      remove_result);
+
+                        status = remove_result;
                     }
-                }
 
-                io->current_elt = next;
+                    io->current_elt = next;
 
-                if (io->current_elt != NULL)
-                {
-                    cgutils_event_buffered_io_obj * const next_obj = cgutils_llist_elt_get_object(io->current_elt);
-                    CGUTILS_ASSERT(next_obj != NULL);
+                    if (io->current_elt != NULL)
+                    {
+                        cgutils_event_buffered_io_obj * const next_obj = cgutils_llist_elt_get_object(io->current_elt);
+                        CGUTILS_ASSERT(next_obj != NULL);
 
-                    result = cgutils_event_buffered_io_change_action(io,
-                                                                     next_obj->action);
+                        status = cgutils_event_buffered_io_change_action(io,
+                                                                         next_obj->action);
 
-                    if (COMPILER_UNLIKELY(result != 0))
+                        if (COMPILER_UNLIKELY(status != 0))
+                        {
+                            CGUTILS_ERROR("Error changing action: %d", status);
+                        }
+                    }
+                    else
                     {
-                        CGUTILS_ERROR("Error changing action: %d", result);
+                        io->active = false;
+                        cgutils_event_disable(io->event);
                     }
-                }
-                else
-                {
-                    io->active = false;
-                    cgutils_event_disable(io->event);
-                }
 
-                if (COMPILER_UNLIKELY(result != 0))
-                {
-                    cgutils_event_disable(io->event);
+                    if (COMPILER_UNLIKELY(status != 0))
+                    {
+                        cgutils_event_disable(io->event);
 
-                    if (obj->cb != NULL)
+                        if (obj->cb != NULL)
+                        {
+                            io->in_callback = true;
+                            (obj->cb)(io->data, status, fd, obj);
+                            io->in_callback = false;
+                        }
+
+                        io->active = false;
+                    }
+                    else
                     {
-                        io->in_callback = true;
-                        (obj->cb)(io->data, result, fd, obj);
-                        io->in_callback = false;
+                        if (obj->cb != NULL)
+                        {
+                            io->in_callback = true;
+                            status = (obj->cb)(io->data, 0, fd, obj);
+                            io->in_callback = false;
+                        }
                     }
 
-                    io->active = false;
-                }
-                else
-                {
-                    if (obj->cb != NULL)
+                    if (result == 0)
                     {
-                        io->in_callback = true;
-                        result = (obj->cb)(io->data, 0, fd, obj);
-                        io->in_callback = false;
+                        result = status;
                     }
-                }
 
-                if (delete == true)
-                {
-                    cgutils_event_buffered_io_obj_delete(obj), obj = NULL;
+                    if (delete == true)
+                    {
+                        cgutils_event_buffered_io_obj_delete(obj);
+                    }
+
+                    obj = NULL;
+
+                    /* bytes already transferred for the next objects
+                       have to be accounted for, whatever the callback said */
+                    if (remaining > 0 &&
+                        io->active == true &&
+                        io->released == false &&
+                        io->current_elt != NULL)
+                    {
+                        obj = cgutils_llist_elt_get_object(io->current_elt);
+                        CGUTILS_ASSERT(obj != NULL);
+                    }
+                    else if (COMPILER_UNLIKELY(remaining > 0 &&
+                                               reading == true))
+                    {
+                        /* should not happen, reads stop at the first callback */
+                        CGUTILS_ERROR("Dropping %zu bytes read from FD %d after the IO was stopped",
+                                      remaining,
+                                      fd);
+
+                        if (result == 0)
+                        {
+                            result = EIO;
+                        }
+                    }
                 }
             }
         }
@@ -805,15 +1159,39 @@ static void cgutils_event_buffered_io_event_cb(int fd, short flags, void * cb_da
         }
     }
     while(io->current_elt != NULL &&
+          io->released == false &&
           (result == 0 || result == EINTR)
         );
 
+    if (io->memory == true &&
+        result == EAGAIN &&
+        io->released == false &&
+        io->output != NULL &&
+        io->flush_cb != NULL)
+    {
+        /* waiting for input, hand the pending output over */
+        io->in_callback = true;
+        (*(io->flush_cb))(io, io->flush_cb_data);
+        io->in_callback = false;
+    }
+
     if (io->released == true)
     {
         cgutils_event_buffered_io_free(io), io = NULL;
     }
 }
 
+static void cgutils_event_buffered_io_memory_event_cb(void * const cb_data)
+{
+    CGUTILS_ASSERT(cb_data != NULL);
+    cgutils_event_buffered_io * const io = cb_data;
+
+    if (COMPILER_LIKELY(io->current_elt != NULL))
+    {
+        cgutils_event_buffered_io_event_cb(io->fd, CGUTILS_EVENT_TIMEOUT, io);
+    }
+}
+
 void cgutils_event_buffered_io_free(cgutils_event_buffered_io * this)
 {
     if (COMPILER_LIKELY(this != NULL))
@@ -828,6 +1206,9 @@ void cgutils_event_buffered_io_free(cgutils_event_buffered_io * this)
             cgutils_event_free(this->event), this->event = NULL;
         }
 
+        CGUTILS_FREE(this->input);
+        CGUTILS_FREE(this->output);
+
         CGUTILS_FREE(this);
     }
 }
@@ -909,6 +1290,176 @@ int cgutils_event_buffered_io_init(cgutils_event_data * const data,
     return result;
 }
 
+int cgutils_event_buffered_io_init_memory(cgutils_event_data * const data,
+                                          int const fd,
+                                          size_t const output_headroom,
+                                          cgutils_event_buffered_io_flush_cb * const flush_cb,
+                                          void * const flush_cb_data,
+                                          cgutils_event_buffered_io ** const out)
+{
+    int result = EINVAL;
+
+    if (COMPILER_LIKELY(data != NULL && fd >= 0 && out != NULL))
+    {
+        cgutils_event_buffered_io * io = NULL;
+
+        CGUTILS_ALLOCATE_STRUCT(io);
+
+        if (COMPILER_LIKELY(io != NULL))
+        {
+            io->data = data;
+            io->action = cgutils_event_buffered_io_reading;
+            io->fd = fd;
+            io->memory = true;
+            io->output_headroom = output_headroom;
+            io->flush_cb = flush_cb;
+            io->flush_cb_data = flush_cb_data;
+
+            result = cgutils_llist_create(&(io->elements));
+
+            if (COMPILER_LIKELY(result == 0))
+            {
+                result = cgutils_event_create_timer_event(data,
+                                                          0,
+                                                          &cgutils_event_buffered_io_memory_event_cb,
+                                                          io,
+                                                          &(io->event));
+
+                if (COMPILER_LIKELY(result == 0))
+                {
+                    *out = io;
+                }
+                else
+                {
+                    CGUTILS_ERROR("Error while creating timer event: %d", result);
+                }
+            }
+            else
+            {
+                CGUTILS_ERROR("Error while creating elements list: %d", result);
+            }
+
+            if (COMPILER_UNLIKELY(result != 0))
+            {
+                cgutils_event_buffered_io_free(io), io = NULL;
+            }
+        }
+        else
+        {
+            result = ENOMEM;
+        }
+    }
+
+    return result;
+}
+
+int cgutils_event_buffered_io_init_ring(cgutils_event_data * const data,
+                                        cgutils_ring * const ring,
+                                        int const wait_fd,
+                                        int const notify_fd,
+                                        cgutils_event_buffered_io_action const action,
+                                        cgutils_event_buffered_io ** const out)
+{
+    int result = EINVAL;
+
+    if (COMPILER_LIKELY(data != NULL &&
+                        ring != NULL &&
+                        wait_fd >= 0 &&
+                        notify_fd >= 0 &&
+                        out != NULL))
+    {
+        result = cgutils_event_buffered_io_init(data,
+                                                wait_fd,
+                                                cgutils_event_buffered_io_reading,
+                                                out);
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            (*out)->ring = ring;
+            (*out)->notify_fd = notify_fd;
+            (*out)->action = action;
+        }
+    }
+
+    return result;
+}
+
+int cgutils_event_buffered_io_set_input(cgutils_event_buffered_io * const this,
+                                        char * const input,
+                                        size_t const input_size)
+{
+    int result = EINVAL;
+
+    if (COMPILER_LIKELY(this != NULL &&
+                        this->memory == true &&
+                        this->input_set == false &&
+                        (input != NULL || input_size == 0)))
+    {
+        result = 0;
+
+        this->input = input;
+        this->input_size = input_size;
+        this->input_pos = 0;
+        this->input_set = true;
+
+        if (this->active == true &&
+            this->current_elt != NULL)
+        {
+            result = cgutils_event_enable(this->event,
+                                          &cgutils_event_buffered_io_immediately);
+
+            if (COMPILER_UNLIKELY(result != 0))
+            {
+                CGUTILS_ERROR("Error while enabling event: %d", result);
+            }
+        }
+    }
+
+    return result;
+}
+
+int cgutils_event_buffered_io_take_output(cgutils_event_buffered_io * const this,
+                                          char ** const out,
+                                          size_t * const out_size)
+{
+    int result = EINVAL;
+
+    if (COMPILER_LIKELY(this != NULL &&
+                        this->memory == true &&
+                        out != NULL &&
+                        out_size != NULL))
+    {
+        result = 0;
+
+        if (this->output == NULL &&
+            this->output_headroom > 0)
+        {
+            CGUTILS_MALLOC(this->output, this->output_headroom, 1);
+
+            if (COMPILER_LIKELY(this->output != NULL))
+            {
+                this->output_size = this->output_headroom;
+                this->output_len = this->output_headroom;
+            }
+            else
+            {
+                result = ENOMEM;
+            }
+        }
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            *out = this->output;
+            *out_size = this->output_len;
+
+            this->output = NULL;
+            this->output_size = 0;
+            this->output_len = 0;
+        }
+    }
+
+    return result;
+}
 
 int cgutils_event_buffered_io_add_obj(cgutils_event_buffered_io * const this,
                                       cgutils_event_buffered_io_obj * const obj)
@@ -953,6 +1504,8 @@ int cgutils_event_buffered_io_add_obj(cgutils_event_buffered_io * const this,
                 this->active = true;
 
                 result = cgutils_event_enable(this->event,
+                                              this->memory == true ?
+                                              &cgutils_event_buffered_io_immediately :
                                               NULL);
 
                 if (COMPILER_UNLIKELY(result != 0))
@@ -960,6 +1513,12 @@ int cgutils_event_buffered_io_add_obj(cgutils_event_buffered_io * const this,
                     CGUTILS_ERROR("Error while enabling event: %d", result);
                     result = EIO;
                 }
+                else if (this->ring != NULL)
+                {
+                    /* the ring may already have data or space for us,
+                       make sure that we look at it */
+                    cgutils_event_buffered_io_ring_notify(this->fd);
+                }
             }
             else
             {
@@ -976,6 +1535,57 @@ int cgutils_event_buffered_io_add_obj(cgutils_event_buffered_io * const this,
     return result;
 }
 
+int cgutils_event_buffered_io_add_fd(cgutils_event_buffered_io * const this,
+                                     int * const fd,
+                                     cgutils_event_buffered_io_action const action,
+                                     cgutils_event_buffered_io_cb * const cb,
+                                     void * const cb_data)
+{
+    int result = 0;
+
+    if (COMPILER_LIKELY(this != NULL &&
+                        this->error == 0 &&
+                        fd != NULL))
+    {
+        if (COMPILER_LIKELY(this->memory == false &&
+                            this->ring == NULL))
+        {
+            cgutils_event_buffered_io_obj * io = NULL;
+
+            result = cgutils_event_buffered_io_object_create(this,
+                                                             fd,
+                                                             sizeof *fd,
+                                                             action,
+                                                             cb,
+                                                             cb_data,
+                                                             &io);
+
+            if (COMPILER_LIKELY(result == 0))
+            {
+                CGUTILS_ASSERT(io != NULL);
+                io->pass_fd = true;
+
+                result = cgutils_event_buffered_io_add_obj(this, io);
+
+                if (COMPILER_UNLIKELY(result != 0))
+                {
+                    CGUTILS_FREE(io), io = NULL;
+                }
+            }
+        }
+        else
+        {
+            result = ENOTSUP;
+        }
+    }
+    else
+    {
+        result = EINVAL;
+    }
+
+    return result;
+}
+
 int cgutils_event_buffered_io_add_multi(cgutils_event_buffered_io * const this,
                                         cgutils_llist * const objs)
 {
@@ -1570,6 +1570,35 @@ int cgutils_file_pread(int const fd,
     return result;
 }
 
+int cgutils_file_pwrite(int const fd,
+                        void const * const buf,
+                        size_t const count,
+                        off_t const off,
+                        size_t * const written)
+{
+    int result = 0;
+    CGUTILS_ASSERT(fd != -1);
+    CGUTILS_ASSERT(buf != NULL);
+    CGUTILS_ASSERT(count > 0);
+    CGUTILS_ASSERT(written != NULL);
+
+    ssize_t res = pwrite(fd,
+                         buf,
+                         count,
+                         off);
+
+    if (COMPILER_LIKELY(res >= 0))
+    {
+        *written = (size_t) res;
+    }
+    else
+    {
+        result = errno;
+    }
+
+    return result;
+}
+
 int cgutils_file_compute_hashed_path(char const * const base_dir,
                                      size_t const base_dir_len,
                                      char const * const base_name,
@@ -0,0 +1,289 @@
+/*
+ * This file is part of Nuage Labs SAS's Cloud Gateway.
+ *
+ * Copyright (C) 2011-2017  Nuage Labs SAS
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * In addition, for the avoidance of any doubt, permission is granted to
+ * link this program with OpenSSL and to (re)distribute the binaries
+ * produced as the result of such linking.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <cloudutils/cloudutils.h>
+#include <cloudutils/cloudutils_ring.h>
+
+#define CGUTILS_RING_CACHE_LINE_SIZE (64)
+
+/* head and tail are free-running counters, each of them
+   on its own cache line as they are written by different processes */
+typedef struct
+{
+    uint64_t head;
+    char head_padding[CGUTILS_RING_CACHE_LINE_SIZE - sizeof (uint64_t)];
+    uint64_t tail;
+    char tail_padding[CGUTILS_RING_CACHE_LINE_SIZE - sizeof (uint64_t)];
+    uint64_t capacity;
+    char capacity_padding[CGUTILS_RING_CACHE_LINE_SIZE - sizeof (uint64_t)];
+    char data[];
+} cgutils_ring_shared;
+
+struct cgutils_ring
+{
+    cgutils_ring_shared * shared;
+    size_t capacity;
+};
+
+size_t cgutils_ring_get_memory_size(size_t const capacity)
+{
+    size_t result = 0;
+
+    if (COMPILER_LIKELY(capacity > 0 &&
+                        (capacity & (capacity - 1)) == 0 &&
+                        capacity <= SIZE_MAX - sizeof (cgutils_ring_shared)))
+    {
+        result = sizeof (cgutils_ring_shared) + capacity;
+    }
+
+    return result;
+}
+
+int cgutils_ring_init(void * const memory,
+                      size_t const capacity,
+                      bool const create,
+                      cgutils_ring ** const out)
+{
+    int result = EINVAL;
+
+    if (COMPILER_LIKELY(memory != NULL &&
+                        cgutils_ring_get_memory_size(capacity) > 0 &&
+                        out != NULL))
+    {
+        cgutils_ring_shared * const shared = memory;
+
+        if (create == true)
+        {
+            COMPILER_ATOMIC_STORE(&(shared->head), 0);
+            COMPILER_ATOMIC_STORE(&(shared->tail), 0);
+            COMPILER_ATOMIC_STORE(&(shared->capacity), capacity);
+            result = 0;
+        }
+        else if (COMPILER_ATOMIC_LOAD(&(shared->capacity)) == capacity)
+        {
+            result = 0;
+        }
+        else
+        {
+            CGUTILS_ERROR("Ring capacity mismatch, expected %zu", capacity);
+        }
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            CGUTILS_ALLOCATE_STRUCT(*out);
+
+            if (COMPILER_LIKELY(*out != NULL))
+            {
+                (*out)->shared = shared;
+                (*out)->capacity = capacity;
+            }
+            else
+            {
+                result = ENOMEM;
+            }
+        }
+    }
+
+    return result;
+}
+
+void cgutils_ring_free(cgutils_ring * this)
+{
+    if (this != NULL)
+    {
+        this->shared = NULL;
+        CGUTILS_FREE(this);
+    }
+}
+
+static size_t cgutils_ring_get_iov_size(struct iovec const * const iov,
+                                        int const iov_count)
+{
+    size_t result = 0;
+    CGUTILS_ASSERT(iov != NULL || iov_count == 0);
+
+    for (int idx = 0; idx < iov_count; idx++)
+    {
+        result += iov[idx].iov_len;
+    }
+
+    return result;
+}
+
+/* Copies len bytes between the iovec and the ring, starting at
+   position in the ring, wrapping around at the end of the data area. */
+static void cgutils_ring_copy(cgutils_ring * const this,
+                              struct iovec const * const iov,
+                              uint64_t position,
+                              size_t len,
+                              bool const to_ring)
+{
+    CGUTILS_ASSERT(this != NULL);
+    CGUTILS_ASSERT(iov != NULL);
+    char * const data = this->shared->data;
+
+    for (size_t idx = 0; len > 0; idx++)
+    {
+        char * buffer = iov[idx].iov_base;
+        size_t remaining = iov[idx].iov_len < len ? iov[idx].iov_len : len;
+
+        len -= remaining;
+
+        while (remaining > 0)
+        {
+            size_t const offset = (size_t) (position & (this->capacity - 1));
+            size_t const chunk = this->capacity - offset < remaining ? this->capacity - offset : remaining;
+
+            if (to_ring == true)
+            {
+                memcpy(data + offset, buffer, chunk);
+            }
+            else
+            {
+                memcpy(buffer, data + offset, chunk);
+            }
+
+            buffer += chunk;
+            position += chunk;
+            remaining -= chunk;
+        }
+    }
+}
+
+ssize_t cgutils_ring_writev(cgutils_ring * const this,
+                            struct iovec const * const iov,
+                            int const iov_count,
+                            bool * const wake_up_reader)
+{
+    ssize_t result = -1;
+
+    if (COMPILER_LIKELY(this != NULL &&
+                        iov != NULL &&
+                        iov_count > 0 &&
+                        wake_up_reader != NULL))
+    {
+        /* only this process writes the tail */
+        uint64_t const tail = COMPILER_ATOMIC_LOAD(&(this->shared->tail));
+        uint64_t const head = COMPILER_ATOMIC_LOAD(&(this->shared->head));
+        uint64_t const used = tail - head;
+
+        *wake_up_reader = false;
+
+        if (COMPILER_LIKELY(used <= this->capacity))
+        {
+            size_t const wanted = cgutils_ring_get_iov_size(iov, iov_count);
+            size_t const available = this->capacity - (size_t) used;
+            size_t const len = wanted < available ? wanted : available;
+
+            if (len > 0 &&
+                len <= SSIZE_MAX)
+            {
+                cgutils_ring_copy(this, iov, tail, len, true);
+
+                COMPILER_ATOMIC_STORE(&(this->shared->tail), tail + len);
+
+                /* the reader sleeps after having seen an empty ring,
+                   either it sees the new tail or we see that it caught up */
+                *wake_up_reader = COMPILER_ATOMIC_LOAD(&(this->shared->head)) == tail;
+
+                result = (ssize_t) len;
+            }
+            else
+            {
+                errno = EAGAIN;
+            }
+        }
+        else
+        {
+            CGUTILS_ERROR("Ring corrupted, %"PRIu64" bytes used", used);
+            errno = EBADMSG;
+        }
+    }
+    else
+    {
+        errno = EINVAL;
+    }
+
+    return result;
+}
+
+ssize_t cgutils_ring_readv(cgutils_ring * const this,
+                           struct iovec const * const iov,
+                           int const iov_count,
+                           bool * const wake_up_writer)
+{
+    ssize_t result = -1;
+
+    if (COMPILER_LIKELY(this != NULL &&
+                        iov != NULL &&
+                        iov_count > 0 &&
+                        wake_up_writer != NULL))
+    {
+        /* only this process writes the head */
+        uint64_t const head = COMPILER_ATOMIC_LOAD(&(this->shared->head));
+        uint64_t const tail = COMPILER_ATOMIC_LOAD(&(this->shared->tail));
+        uint64_t const used = tail - head;
+
+        *wake_up_writer = false;
+
+        if (COMPILER_LIKELY(used <= this->capacity))
+        {
+            size_t const wanted = cgutils_ring_get_iov_size(iov, iov_count);
+            size_t const len = wanted < used ? wanted : (size_t) used;
+
+            if (len > 0 &&
+                len <= SSIZE_MAX)
+            {
+                cgutils_ring_copy(this, iov, head, len, false);
+
+                COMPILER_ATOMIC_STORE(&(this->shared->head), head + len);
+
+                /* the writer sleeps after having seen a full ring,
+                   either it sees the new head or we see that it filled it */
+                *wake_up_writer = COMPILER_ATOMIC_LOAD(&(this->shared->tail)) - head == this->capacity;
+
+                result = (ssize_t) len;
+            }
+            else
+            {
+                errno = EAGAIN;
+            }
+        }
+        else
+        {
+            CGUTILS_ERROR("Ring corrupted, %"PRIu64" bytes used", used);
+            errno = EBADMSG;
+        }
+    }
+    else
+    {
+        errno = EINVAL;
+    }
+
+    return result;
+}
@@ -148,7 +148,7 @@ static int cloudutils_shared_memory_segment_map(char const * const path,
     {
         *segment_size = cloudutils_shared_memory_segment_handler_compute_size(data_size);
 
-        result = cgutils_file_ftruncate(md, (off_t) segment_size);
+        result = cgutils_file_ftruncate(md, (off_t) *segment_size);
 
         if (CGUTILS_COMPILER_LIKELY(result == 0))
         {
@@ -481,6 +481,42 @@ int cloudutils_shared_memory_segment_handler_update(cloudutils_shared_memory_seg
     return result;
 }
 
+void * cloudutils_shared_memory_segment_handler_get_data(cloudutils_shared_memory_segment_handler * const this)
+{
+    void * result = NULL;
+
+    if (CGUTILS_COMPILER_LIKELY(this != NULL &&
+                                this->segment != NULL))
+    {
+        result = this->segment->data;
+    }
+
+    return result;
+}
+
+int cloudutils_shared_memory_segment_handler_unlink(cloudutils_shared_memory_segment_handler * const this)
+{
+    int result = EINVAL;
+
+    if (CGUTILS_COMPILER_LIKELY(this != NULL))
+    {
+        CGUTILS_ASSERT(this->path != NULL);
+
+        result = shm_unlink(this->path);
+
+        if (result != 0)
+        {
+            result = errno;
+
+            CGUTILS_ERROR("Error unlinking segment %s: %d",
+                          this->path,
+                          result);
+        }
+    }
+
+    return result;
+}
+
 void cloudutils_shared_memory_segment_handler_detach(cloudutils_shared_memory_segment_handler * this)
 {
     if (CGUTILS_COMPILER_LIKELY(this != NULL))
@@ -0,0 +1,85 @@
+/*
+ * This file is part of Nuage Labs SAS's Cloud Gateway.
+ *
+ * Copyright (C) 2011-2017  Nuage Labs SAS
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * In addition, for the avoidance of any doubt, permission is granted to
+ * link this program with OpenSSL and to (re)distribute the binaries
+ * produced as the result of such linking.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef CLOUD_UTILS_ARENA_H_
+#define CLOUD_UTILS_ARENA_H_
+
+#include <stddef.h>
+
+/* Bump allocator for objects sharing the lifetime of a request.
+   Allocations are never freed one by one, the whole arena is reset
+   or freed at once. Only the first block survives a reset, so a
+   reused arena does not call malloc() as long as its first block
+   is large enough. */
+typedef struct cgutils_arena cgutils_arena;
+
+#include <cloudutils/cloudutils_compiler_specifics.h>
+
+/* Same as CGUTILS_ALLOCATE_STRUCT, from an arena */
+#define CGUTILS_ARENA_ALLOCATE_STRUCT(arena, pointer)                    \
+    do                                                                  \
+    {                                                                   \
+        (pointer) = cgutils_arena_alloc((arena), sizeof *(pointer));    \
+        if ((pointer) != NULL)                                          \
+        {                                                               \
+            CGUTILS_INIT_STRUCT(pointer);                               \
+        }                                                               \
+    }                                                                   \
+    while (0)
+
+COMPILER_BLOCK_VISIBILITY_DEFAULT
+
+int cgutils_arena_init(size_t block_size,
+                       cgutils_arena ** out);
+
+/* Releases every allocation but keeps the first block */
+void cgutils_arena_reset(cgutils_arena * this);
+
+void cgutils_arena_free(cgutils_arena * this);
+
+/* The returned memory is suitably aligned for any type,
+   NULL is returned on allocation failure. */
+void * cgutils_arena_alloc(cgutils_arena * this,
+                           size_t size);
+
+void * cgutils_arena_calloc(cgutils_arena * this,
+                            size_t count,
+                            size_t size);
+
+void * cgutils_arena_memdup(cgutils_arena * this,
+                            void const * data,
+                            size_t size);
+
+char * cgutils_arena_strdup(cgutils_arena * this,
+                            char const * str);
+
+char * cgutils_arena_strndup(cgutils_arena * this,
+                             char const * str,
+                             size_t len);
+
+/* Number of bytes currently handed out, alignment padding included */
+size_t cgutils_arena_get_used_size(cgutils_arena const * this);
+
+COMPILER_BLOCK_VISIBILITY_END
+
+#endif /* CLOUD_UTILS_ARENA_H_ */
@@ -83,6 +83,18 @@
 #define COMPILER_SYNC_BOOL_COMPARE_AND_SWAP(ptr, oldval, newval) \
     __sync_bool_compare_and_swap(ptr, oldval, newval)
 
+#define COMPILER_SYNC_ADD_AND_FETCH(ptr, value) \
+    __sync_add_and_fetch(ptr, value)
+
+#define COMPILER_SYNC_SUB_AND_FETCH(ptr, value) \
+    __sync_sub_and_fetch(ptr, value)
+
+#define COMPILER_ATOMIC_LOAD(ptr) \
+    __atomic_load_n(ptr, __ATOMIC_SEQ_CST)
+
+#define COMPILER_ATOMIC_STORE(ptr, value) \
+    __atomic_store_n(ptr, value, __ATOMIC_SEQ_CST)
+
 # ifndef COMPILER_LIKELY
 #  define COMPILER_LIKELY(x)
 # endif /* COMPILER_LIKELY */
@@ -52,6 +52,7 @@ typedef void (cgutils_event_timer_cb)(void * cb_data);
 typedef void (cgutils_event_signal_cb)(int signal, void * cb_data);
 
 #include <cloudutils/cloudutils_llist.h>
+#include <cloudutils/cloudutils_ring.h>
 
 COMPILER_BLOCK_VISIBILITY_DEFAULT
 
@@ -137,8 +138,20 @@ struct cgutils_event_buffered_io_obj
        after it has been dealt with.
     */
     bool do_not_free;
+    /* if this flag is set to true,
+       object is freed along with the io_obj. */
+    bool free_object;
+    /* if this flag is set to true, object is an int holding
+       a file descriptor, transferred over a Unix socket
+       as SCM_RIGHTS ancillary data. */
+    bool pass_fd;
 };
 
+/* Called when a memory-backed IO is waiting for input
+   that has not been provided yet, while some output is pending. */
+typedef void (cgutils_event_buffered_io_flush_cb)(cgutils_event_buffered_io * io,
+                                                  void * cb_data);
+
 COMPILER_BLOCK_VISIBILITY_DEFAULT
 
 void cgutils_event_buffered_io_free(cgutils_event_buffered_io * this);
@@ -149,6 +162,39 @@ int cgutils_event_buffered_io_init(cgutils_event_data * data,
                                    cgutils_event_buffered_io_action action,
                                    cgutils_event_buffered_io ** io);
 
+/* The objects of a memory-backed IO are read from the buffer set by
+   cgutils_event_buffered_io_set_input() and written to an internal buffer,
+   retrieved with cgutils_event_buffered_io_take_output().
+   fd is only passed to the callbacks. */
+int cgutils_event_buffered_io_init_memory(cgutils_event_data * data,
+                                          int fd,
+                                          size_t output_headroom,
+                                          cgutils_event_buffered_io_flush_cb * flush_cb,
+                                          void * flush_cb_data,
+                                          cgutils_event_buffered_io ** io);
+
+/* The objects of a ring-backed IO are transferred through a ring shared with
+   another process. wait_fd and notify_fd are eventfds, the first one being
+   signaled by the peer when it has filled or drained the ring, the second one
+   being signaled to it. The ring and the descriptors are not owned by the IO. */
+int cgutils_event_buffered_io_init_ring(cgutils_event_data * data,
+                                        cgutils_ring * ring,
+                                        int wait_fd,
+                                        int notify_fd,
+                                        cgutils_event_buffered_io_action action,
+                                        cgutils_event_buffered_io ** io);
+
+/* Takes ownership of input. Reading past its end fails with EBADF. */
+int cgutils_event_buffered_io_set_input(cgutils_event_buffered_io * this,
+                                        char * input,
+                                        size_t input_size);
+
+/* The returned buffer starts with output_headroom bytes left for the caller,
+   and out_size includes them. */
+int cgutils_event_buffered_io_take_output(cgutils_event_buffered_io * this,
+                                          char ** out,
+                                          size_t * out_size);
+
 int cgutils_event_buffered_io_add_obj(cgutils_event_buffered_io * this,
                                       cgutils_event_buffered_io_obj * obj);
 
@@ -159,6 +205,15 @@ int cgutils_event_buffered_io_add_one(cgutils_event_buffered_io * this,
                                       cgutils_event_buffered_io_cb * cb,
                                       void * cb_data);
 
+/* Sends the file descriptor pointed to by fd, or receives one into it.
+   The sender keeps its own descriptor open. Not available on memory-backed
+   and ring-backed IOs. */
+int cgutils_event_buffered_io_add_fd(cgutils_event_buffered_io * this,
+                                     int * fd,
+                                     cgutils_event_buffered_io_action action,
+                                     cgutils_event_buffered_io_cb * cb,
+                                     void * cb_data);
+
 int cgutils_event_buffered_io_add_multi(cgutils_event_buffered_io * this,
                                         /* llist of cgutils_event_buffered_io_obj * */
                                         cgutils_llist * objs);
@@ -206,6 +206,12 @@ int cgutils_file_pread(int fd,
                        off_t off,
                        size_t * got);
 
+int cgutils_file_pwrite(int fd,
+                        void const * buf,
+                        size_t count,
+                        off_t off,
+                        size_t * written);
+
 int cgutils_file_compute_hashed_path(char const * base_dir,
                                      size_t base_dir_len,
                                      char const * base_name,
@@ -0,0 +1,72 @@
+/*
+ * This file is part of Nuage Labs SAS's Cloud Gateway.
+ *
+ * Copyright (C) 2011-2017  Nuage Labs SAS
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * In addition, for the avoidance of any doubt, permission is granted to
+ * link this program with OpenSSL and to (re)distribute the binaries
+ * produced as the result of such linking.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef CLOUD_UTILS_RING_H_
+#define CLOUD_UTILS_RING_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+/* Single producer, single consumer byte ring living in memory shared
+   between two processes. The indexes are only trusted up to the capacity
+   known locally, a corrupted ring making the transfers fail with EBADMSG. */
+typedef struct cgutils_ring cgutils_ring;
+
+#include <cloudutils/cloudutils_compiler_specifics.h>
+
+COMPILER_BLOCK_VISIBILITY_DEFAULT
+
+/* Size of the memory needed by a ring of the given capacity,
+   which has to be a power of two. 0 if the capacity is invalid. */
+size_t cgutils_ring_get_memory_size(size_t capacity);
+
+/* If create is true, the ring header is initialized,
+   otherwise the existing one is checked against capacity. */
+int cgutils_ring_init(void * memory,
+                      size_t capacity,
+                      bool create,
+                      cgutils_ring ** out);
+
+void cgutils_ring_free(cgutils_ring * this);
+
+/* Returns the number of bytes written, or -1 with errno set to
+   EAGAIN if the ring is full. wake_up_reader is set to true if the
+   reader may be waiting for this data. */
+ssize_t cgutils_ring_writev(cgutils_ring * this,
+                            struct iovec const * iov,
+                            int iov_count,
+                            bool * wake_up_reader);
+
+/* Returns the number of bytes read, or -1 with errno set to
+   EAGAIN if the ring is empty. wake_up_writer is set to true if the
+   writer may be waiting for this space. */
+ssize_t cgutils_ring_readv(cgutils_ring * this,
+                           struct iovec const * iov,
+                           int iov_count,
+                           bool * wake_up_writer);
+
+COMPILER_BLOCK_VISIBILITY_END
+
+#endif /* CLOUD_UTILS_RING_H_ */
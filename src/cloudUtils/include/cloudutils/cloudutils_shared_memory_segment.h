@@ -48,6 +48,12 @@ int cloudutils_shared_memory_segment_handler_update(cloudutils_shared_memory_seg
                                                     void const * new_data,
                                                     size_t new_data_size);
 
+/* Direct access to the data, for callers doing their own synchronization */
+void * cloudutils_shared_memory_segment_handler_get_data(cloudutils_shared_memory_segment_handler * this);
+
+/* Removes the name of the segment, the mappings staying valid */
+int cloudutils_shared_memory_segment_handler_unlink(cloudutils_shared_memory_segment_handler * this);
+
 int cloudutils_shared_memory_segment_handler_lock(cloudutils_shared_memory_segment_handler * this);
 int cloudutils_shared_memory_segment_handler_unlock(cloudutils_shared_memory_segment_handler * this);
 
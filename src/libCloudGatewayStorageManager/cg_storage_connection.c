@@ -24,6 +24,7 @@
 #include <assert.h>
 #include <errno.h>
 #include <inttypes.h>
+#include <string.h>
 #include <unistd.h>
 
 #include <cloudutils/cloudutils_file.h>
@@ -34,6 +35,10 @@
 #include "cgsm/cg_storage_request.h"
 
 #define CG_ST_MAX_REQUESTS_PER_CONN_DEFAULT (1000)
+/* requests are small, the largest ones carrying two names */
+#define CG_ST_MULTIPLEXED_FRAME_SIZE_MAX (1024 * 1024)
+#define CG_ST_RING_SIZE_MAX (64 * 1024 * 1024)
+#define CG_ST_RING_NAME_MAX (255) /* NAME_MAX */
 
 static char const * cg_storage_connection_opcode_to_str(cgsm_proto_opcode_type const opcode)
 {
@@ -278,6 +283,7 @@ int cg_storage_connection_init(cg_storage_manager_data * const data,
             (*out)->sock = -1;
             (*out)->request = request_zero;
             (*out)->request.conn = *out;
+            (*out)->request.fd_in_cache = -1;
             (*out)->end_cb = end_cb;
             (*out)->end_cb_data = end_cb_data;
 
@@ -301,21 +307,26 @@ static void cg_storage_request_clean(cg_storage_request * const this)
 {
     if (this != NULL)
     {
-        if (this->path != NULL)
-        {
-            CGUTILS_FREE(this->path);
-        }
-        if (this->path_to != NULL)
-        {
-            CGUTILS_FREE(this->path_to);
-        }
-
         if (this->entries != NULL)
         {
             cgutils_vector_deep_free(&(this->entries), &cgdb_entry_delete);
         }
 
-        CGUTILS_FREE(this->st);
+        /* allocated from the arena */
+        this->path = NULL;
+        this->path_to = NULL;
+        this->st = NULL;
+        this->batch_inodes = NULL;
+        this->batch_names = NULL;
+        this->batch_codes = NULL;
+        this->batch_st = NULL;
+
+        cgutils_arena_reset(this->arena);
+
+        if (this->fd_in_cache != -1)
+        {
+            cgutils_file_close(this->fd_in_cache), this->fd_in_cache = -1;
+        }
 
         this->request_size = 0;
         this->response_size = 0;
@@ -333,6 +344,10 @@ static void cg_storage_request_clean(cg_storage_request * const this)
         this->new_inode_number = 0;
         this->size_changed = 0;
         this->dirty = 0;
+        this->lease = 0;
+        this->dir_cursor = 0;
+        this->dir_page_size = 0;
+        this->batch_size = 0;
 
     }
 }
@@ -351,13 +366,57 @@ static void cg_storage_connection_clean(cg_storage_connection * const this)
             cgutils_event_buffered_io_release(this->io), this->io = NULL;
         }
 
+        if (this->write_io != NULL)
+        {
+            cgutils_event_buffered_io_release(this->write_io), this->write_io = NULL;
+        }
+
+        if (this->sock_io != NULL)
+        {
+            cgutils_event_buffered_io_release(this->sock_io), this->sock_io = NULL;
+        }
+
+        if (this->request_ring != NULL)
+        {
+            cgutils_ring_free(this->request_ring), this->request_ring = NULL;
+        }
+
+        if (this->response_ring != NULL)
+        {
+            cgutils_ring_free(this->response_ring), this->response_ring = NULL;
+        }
+
+        if (this->ring_segment != NULL)
+        {
+            cloudutils_shared_memory_segment_handler_detach(this->ring_segment), this->ring_segment = NULL;
+        }
+
+        for (size_t idx = 0;
+             idx < this->ring_fds_count;
+             idx++)
+        {
+            cgutils_file_close(this->ring_fds[idx]), this->ring_fds[idx] = -1;
+        }
+
+        CGUTILS_FREE(this->frame);
+        CGUTILS_FREE(this->ring_name);
+
         cg_storage_request_clean(&(this->request));
+        cgutils_arena_free(this->request.arena), this->request.arena = NULL;
 
         this->data = NULL;
         this->fs_id_len = 0;
         this->fs = NULL;
         this->requests_per_conn = 0;
         this->error = false;
+        this->multiplexed = false;
+        this->parent = NULL;
+        this->pending_frames = 0;
+        this->frame_id = 0;
+        this->frame_size = 0;
+        this->ring_name_len = 0;
+        this->ring_fds_count = 0;
+        this->ring_size = 0;
         this->end_cb = NULL;
         this->end_cb_data = NULL;
 
@@ -370,9 +429,173 @@ static void cg_storage_connection_clean(cg_storage_connection * const this)
     }
 }
 
+static void cg_storage_connection_release_multiplexed(cg_storage_connection * this)
+{
+    CGUTILS_ASSERT(this != NULL);
+    CGUTILS_ASSERT(this->multiplexed == true);
+
+    /* we only get there on error, stop reading frames and
+       discard the responses of the requests still in progress */
+    this->error = true;
+
+    if (this->io != NULL)
+    {
+        cgutils_event_buffered_io_release(this->io), this->io = NULL;
+    }
+
+    if (this->write_io != NULL)
+    {
+        cgutils_event_buffered_io_release(this->write_io), this->write_io = NULL;
+    }
+
+    if (this->sock_io != NULL)
+    {
+        cgutils_event_buffered_io_release(this->sock_io), this->sock_io = NULL;
+    }
+
+    if (this->sock >= 0)
+    {
+        shutdown(this->sock, SHUT_RDWR);
+    }
+
+    if (this->pending_frames == 0)
+    {
+        if (this->end_cb != NULL)
+        {
+            (*(this->end_cb))(this, this->end_cb_data);
+        }
+
+        cg_storage_connection_clean(this);
+        CGUTILS_FREE(this);
+    }
+}
+
+static int cg_storage_connection_frame_sent(cgutils_event_data * data,
+                                            int status,
+                                            int fd,
+                                            cgutils_event_buffered_io_obj * obj)
+{
+    assert(data != NULL);
+    assert(obj != NULL);
+    assert(fd >= 0);
+    (void) data;
+    (void) fd;
+
+    cg_storage_connection * this = obj->cb_data;
+
+    if (COMPILER_UNLIKELY(status != 0))
+    {
+        CGUTILS_ERROR("Error sending frame: %d", status);
+        cg_storage_connection_finish(this), this = NULL;
+    }
+
+    return status;
+}
+
+static void cg_storage_connection_release_virtual(cg_storage_connection * this)
+{
+    CGUTILS_ASSERT(this != NULL);
+    cg_storage_connection * parent = this->parent;
+    CGUTILS_ASSERT(parent != NULL);
+    CGUTILS_ASSERT(parent->pending_frames > 0);
+
+    if (parent->write_io != NULL)
+    {
+        char * frame = NULL;
+        size_t frame_len = 0;
+
+        int result = cgutils_event_buffered_io_take_output(this->io,
+                                                           &frame,
+                                                           &frame_len);
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            cgutils_event_buffered_io_obj * obj = NULL;
+            cgsm_proto_frame_size_type payload_size = 0;
+            CGUTILS_ASSERT(frame != NULL);
+            CGUTILS_ASSERT(frame_len >= CGSM_PROTO_FRAME_HEADER_SIZE);
+
+            /* an empty payload tells the client that the request failed */
+            if (COMPILER_LIKELY(this->error == false &&
+                                frame_len - CGSM_PROTO_FRAME_HEADER_SIZE <= UINT32_MAX))
+            {
+                payload_size = (cgsm_proto_frame_size_type) (frame_len - CGSM_PROTO_FRAME_HEADER_SIZE);
+            }
+
+            memcpy(frame,
+                   &(this->frame_id),
+                   sizeof this->frame_id);
+            memcpy(frame + sizeof this->frame_id,
+                   &payload_size,
+                   sizeof payload_size);
+
+            result = cgutils_event_buffered_io_object_create(parent->write_io,
+                                                             frame,
+                                                             CGSM_PROTO_FRAME_HEADER_SIZE + payload_size,
+                                                             cgutils_event_buffered_io_writing,
+                                                             &cg_storage_connection_frame_sent,
+                                                             parent,
+                                                             &obj);
+
+            if (COMPILER_LIKELY(result == 0))
+            {
+                obj->free_object = true;
+                frame = NULL;
+
+                result = cgutils_event_buffered_io_add_obj(parent->write_io,
+                                                           obj);
+
+                if (COMPILER_UNLIKELY(result != 0))
+                {
+                    CGUTILS_ERROR("Error queuing frame: %d", result);
+                    CGUTILS_FREE(obj->object);
+                    CGUTILS_FREE(obj);
+                }
+            }
+            else
+            {
+                CGUTILS_ERROR("Error creating frame object: %d", result);
+                CGUTILS_FREE(frame);
+            }
+        }
+        else
+        {
+            CGUTILS_ERROR("Error getting response: %d", result);
+        }
+
+        if (COMPILER_UNLIKELY(result != 0))
+        {
+            /* the client would wait forever for this response */
+            cg_storage_connection_release_multiplexed(parent);
+        }
+    }
+
+    parent->pending_frames--;
+    this->parent = NULL;
+
+    cg_storage_connection_clean(this);
+    CGUTILS_FREE(this);
+
+    if (parent->write_io == NULL &&
+        parent->pending_frames == 0)
+    {
+        cg_storage_connection_release_multiplexed(parent), parent = NULL;
+    }
+}
+
 void cg_storage_connection_release(cg_storage_connection * this)
 {
-    if (this != NULL)
+    if (this != NULL &&
+        this->parent != NULL)
+    {
+        cg_storage_connection_release_virtual(this), this = NULL;
+    }
+    else if (this != NULL &&
+             this->multiplexed == true)
+    {
+        cg_storage_connection_release_multiplexed(this), this = NULL;
+    }
+    else if (this != NULL)
     {
         bool reused = false;
         int result = 0;
@@ -456,6 +679,712 @@ void cg_storage_connection_finish(cg_storage_connection * const this)
     }
 }
 
+static int cg_storage_connection_init_virtual(cg_storage_connection * const parent,
+                                              cg_storage_connection ** const out)
+{
+    int result = 0;
+    cg_storage_connection * conn = NULL;
+    CGUTILS_ASSERT(parent != NULL);
+    CGUTILS_ASSERT(out != NULL);
+
+    CGUTILS_ALLOCATE_STRUCT(conn);
+
+    if (COMPILER_LIKELY(conn != NULL))
+    {
+        static cg_storage_request const request_zero;
+        conn->sock = -1;
+        conn->request = request_zero;
+        conn->request.conn = conn;
+        conn->request.fd_in_cache = -1;
+        conn->data = parent->data;
+        conn->fs = parent->fs;
+        conn->parent = parent;
+        conn->frame_id = parent->frame_id;
+
+        cgutils_event_data * event_data = cg_storage_manager_data_get_event(parent->data);
+        assert(event_data != NULL);
+
+        /* the header of the response frame is written in the headroom */
+        result = cgutils_event_buffered_io_init_memory(event_data,
+                                                       parent->sock,
+                                                       CGSM_PROTO_FRAME_HEADER_SIZE,
+                                                       NULL,
+                                                       NULL,
+                                                       &(conn->io));
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            result = cgutils_event_buffered_io_set_input(conn->io,
+                                                         parent->frame,
+                                                         parent->frame_size);
+
+            if (COMPILER_LIKELY(result == 0))
+            {
+                parent->frame = NULL;
+                parent->pending_frames++;
+                *out = conn;
+            }
+            else
+            {
+                CGUTILS_ERROR("Error setting frame as input: %d", result);
+            }
+        }
+        else
+        {
+            CGUTILS_ERROR("Error creating memory buffered io: %d", result);
+        }
+
+        if (COMPILER_UNLIKELY(result != 0))
+        {
+            conn->parent = NULL;
+            cg_storage_connection_clean(conn);
+            CGUTILS_FREE(conn);
+        }
+    }
+    else
+    {
+        result = ENOMEM;
+    }
+
+    return result;
+}
+
+static int cg_storage_connection_read_frame(cg_storage_connection * this);
+
+static int cg_storage_connection_got_frame(cgutils_event_data * data,
+                                           int status,
+                                           int fd,
+                                           cgutils_event_buffered_io_obj * obj)
+{
+    assert(data != NULL);
+    assert(obj != NULL);
+    assert(fd >= 0);
+    (void) data;
+    (void) fd;
+
+    cg_storage_connection * this = obj->cb_data;
+
+    int result = status;
+
+    if (COMPILER_LIKELY(result == 0))
+    {
+        cg_storage_connection * conn = NULL;
+
+        result = cg_storage_connection_init_virtual(this,
+                                                    &conn);
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            result = cgutils_event_buffered_io_add_one(conn->io,
+                                                       &(conn->request.opcode),
+                                                       sizeof conn->request.opcode,
+                                                       cgutils_event_buffered_io_reading,
+                                                       &cg_storage_connection_got_opcode,
+                                                       conn);
+
+            if (COMPILER_UNLIKELY(result != 0))
+            {
+                CGUTILS_ERROR("Error reading opcode: %d", result);
+                /* sends an error frame */
+                cg_storage_connection_finish(conn), conn = NULL;
+            }
+
+            result = cg_storage_connection_read_frame(this);
+        }
+        else
+        {
+            CGUTILS_ERROR("Error creating connection for frame: %d", result);
+        }
+    }
+    else
+    {
+        CGUTILS_ERROR("Error reading frame: %d", result);
+    }
+
+    if (COMPILER_UNLIKELY(result != 0))
+    {
+        cg_storage_connection_finish(this), this = NULL;
+    }
+
+    return result;
+}
+
+static int cg_storage_connection_got_frame_size(cgutils_event_data * data,
+                                                int status,
+                                                int fd,
+                                                cgutils_event_buffered_io_obj * obj)
+{
+    assert(data != NULL);
+    assert(obj != NULL);
+    assert(fd >= 0);
+    (void) data;
+    (void) fd;
+
+    cg_storage_connection * this = obj->cb_data;
+
+    int result = status;
+
+    if (COMPILER_LIKELY(result == 0))
+    {
+        if (COMPILER_LIKELY(this->frame_size > 0 &&
+                            this->frame_size <= CG_ST_MULTIPLEXED_FRAME_SIZE_MAX))
+        {
+            CGUTILS_ASSERT(this->frame == NULL);
+            CGUTILS_MALLOC(this->frame, this->frame_size, 1);
+
+            if (COMPILER_LIKELY(this->frame != NULL))
+            {
+                result = cgutils_event_buffered_io_add_one(this->io,
+                                                           this->frame,
+                                                           this->frame_size,
+                                                           cgutils_event_buffered_io_reading,
+                                                           &cg_storage_connection_got_frame,
+                                                           this);
+
+                if (COMPILER_UNLIKELY(result != 0))
+                {
+                    CGUTILS_ERROR("Error reading frame: %d", result);
+                }
+            }
+            else
+            {
+                result = ENOMEM;
+                CGUTILS_ERROR("Error allocating memory for frame of size %"PRIu32": %d",
+                              this->frame_size,
+                              result);
+            }
+        }
+        else
+        {
+            result = EINVAL;
+            CGUTILS_ERROR("Invalid frame size %"PRIu32": %d",
+                          this->frame_size,
+                          result);
+        }
+    }
+    else if (result != EBADF)
+    {
+        CGUTILS_ERROR("Error reading frame header: %d", result);
+    }
+
+    if (COMPILER_UNLIKELY(result != 0))
+    {
+        cg_storage_connection_finish(this), this = NULL;
+    }
+
+    return result;
+}
+
+static int cg_storage_connection_got_frame_id(cgutils_event_data * data,
+                                              int status,
+                                              int fd,
+                                              cgutils_event_buffered_io_obj * obj)
+{
+    assert(data != NULL);
+    assert(obj != NULL);
+    assert(fd >= 0);
+    (void) data;
+    (void) fd;
+
+    cg_storage_connection * this = obj->cb_data;
+
+    if (COMPILER_UNLIKELY(status != 0))
+    {
+        if (status != EBADF)
+        {
+            CGUTILS_ERROR("Error reading frame header: %d", status);
+        }
+
+        cg_storage_connection_finish(this), this = NULL;
+    }
+
+    return status;
+}
+
+static int cg_storage_connection_read_frame(cg_storage_connection * const this)
+{
+    CGUTILS_ASSERT(this != NULL);
+
+    int result = cgutils_event_buffered_io_add_one(this->io,
+                                                   &(this->frame_id),
+                                                   sizeof this->frame_id,
+                                                   cgutils_event_buffered_io_reading,
+                                                   &cg_storage_connection_got_frame_id,
+                                                   this);
+
+    if (COMPILER_LIKELY(result == 0))
+    {
+        result = cgutils_event_buffered_io_add_one(this->io,
+                                                   &(this->frame_size),
+                                                   sizeof this->frame_size,
+                                                   cgutils_event_buffered_io_reading,
+                                                   &cg_storage_connection_got_frame_size,
+                                                   this);
+    }
+
+    if (COMPILER_UNLIKELY(result != 0))
+    {
+        CGUTILS_ERROR("Error reading frame header: %d", result);
+    }
+
+    return result;
+}
+
+int cg_storage_connection_multiplex(cg_storage_connection * const this)
+{
+    int result = EINVAL;
+
+    if (COMPILER_LIKELY(this != NULL &&
+                        this->parent == NULL &&
+                        this->multiplexed == false))
+    {
+        cgutils_event_data * event_data = cg_storage_manager_data_get_event(this->data);
+        assert(event_data != NULL);
+
+        /* responses are sent on a separate queue, so that they
+           do not wait behind the read of the next frame */
+        result = cgutils_event_buffered_io_init(event_data,
+                                                this->sock,
+                                                cgutils_event_buffered_io_writing,
+                                                &(this->write_io));
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            this->multiplexed = true;
+            this->request.response_code = 0;
+
+            result = cgutils_event_buffered_io_add_one(this->write_io,
+                                                       &(this->request.response_code),
+                                                       sizeof this->request.response_code,
+                                                       cgutils_event_buffered_io_writing,
+                                                       &cg_storage_connection_frame_sent,
+                                                       this);
+
+            if (COMPILER_LIKELY(result == 0))
+            {
+                result = cg_storage_connection_read_frame(this);
+            }
+            else
+            {
+                CGUTILS_ERROR("Error sending code: %d", result);
+            }
+        }
+        else
+        {
+            CGUTILS_ERROR("Unable to create socket buffered io: %d", result);
+        }
+    }
+    else
+    {
+        CGUTILS_ERROR("Multiplexing is not allowed on this connection: %d", result);
+    }
+
+    return result;
+}
+
+static int cg_storage_connection_ring_hangup(cgutils_event_data * data,
+                                             int status,
+                                             int fd,
+                                             cgutils_event_buffered_io_obj * obj)
+{
+    assert(data != NULL);
+    assert(obj != NULL);
+    assert(fd >= 0);
+    (void) data;
+    (void) fd;
+
+    cg_storage_connection * this = obj->cb_data;
+
+    /* the client does not write to the socket once the rings are set up */
+    if (status == 0)
+    {
+        CGUTILS_WARN("Unexpected data on the socket of a ring connection");
+        status = EPROTO;
+    }
+
+    cg_storage_connection_finish(this), this = NULL;
+
+    return status;
+}
+
+static int cg_storage_connection_ring_refused(cgutils_event_data * data,
+                                              int status,
+                                              int fd,
+                                              cgutils_event_buffered_io_obj * obj)
+{
+    assert(data != NULL);
+    assert(obj != NULL);
+    assert(fd >= 0);
+    (void) data;
+    (void) fd;
+
+    cg_storage_connection * this = obj->cb_data;
+
+    /* the client may have written frames to the rings already,
+       it will send them again on another connection */
+    cg_storage_connection_finish(this), this = NULL;
+
+    return status != 0 ? status : ECANCELED;
+}
+
+static int cg_storage_connection_ring_setup(cg_storage_connection * const this)
+{
+    int result = 0;
+    cgutils_event_buffered_io * read_io = NULL;
+    cgutils_event_buffered_io * write_io = NULL;
+    CGUTILS_ASSERT(this != NULL);
+    CGUTILS_ASSERT(this->ring_name != NULL);
+    CGUTILS_ASSERT(this->ring_fds_count == cgsm_proto_ring_fd_count);
+    size_t const ring_memory_size = cgutils_ring_get_memory_size((size_t) this->ring_size);
+    CGUTILS_ASSERT(ring_memory_size > 0);
+    cgutils_event_data * event_data = cg_storage_manager_data_get_event(this->data);
+    assert(event_data != NULL);
+
+    result = cloudutils_shared_memory_segment_handler_attach(this->ring_name,
+                                                             true,
+                                                             2 * ring_memory_size,
+                                                             &(this->ring_segment));
+
+    if (COMPILER_LIKELY(result == 0))
+    {
+        char * const memory = cloudutils_shared_memory_segment_handler_get_data(this->ring_segment);
+        CGUTILS_ASSERT(memory != NULL);
+
+        result = cgutils_ring_init(memory,
+                                   (size_t) this->ring_size,
+                                   false,
+                                   &(this->request_ring));
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            result = cgutils_ring_init(memory + ring_memory_size,
+                                       (size_t) this->ring_size,
+                                       false,
+                                       &(this->response_ring));
+        }
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            result = cgutils_event_buffered_io_init_ring(event_data,
+                                                         this->request_ring,
+                                                         this->ring_fds[cgsm_proto_ring_fd_request_data],
+                                                         this->ring_fds[cgsm_proto_ring_fd_request_space],
+                                                         cgutils_event_buffered_io_reading,
+                                                         &read_io);
+        }
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            result = cgutils_event_buffered_io_init_ring(event_data,
+                                                         this->response_ring,
+                                                         this->ring_fds[cgsm_proto_ring_fd_response_space],
+                                                         this->ring_fds[cgsm_proto_ring_fd_response_data],
+                                                         cgutils_event_buffered_io_writing,
+                                                         &write_io);
+        }
+
+        if (COMPILER_UNLIKELY(result != 0))
+        {
+            CGUTILS_ERROR("Error setting up rings of segment %s: %d",
+                          this->ring_name,
+                          result);
+        }
+    }
+    else
+    {
+        CGUTILS_ERROR("Error attaching to ring segment %s: %d",
+                      this->ring_name,
+                      result);
+    }
+
+    /* the client falls back to the socket if we refuse */
+    this->request.response_code = (cgsm_proto_response_code) result;
+
+    int res = cgutils_event_buffered_io_add_one(this->io,
+                                                &(this->request.response_code),
+                                                sizeof this->request.response_code,
+                                                cgutils_event_buffered_io_writing,
+                                                result == 0 ?
+                                                &cg_storage_connection_frame_sent :
+                                                &cg_storage_connection_ring_refused,
+                                                this);
+
+    if (COMPILER_LIKELY(res == 0 &&
+                        result == 0))
+    {
+        res = cgutils_event_buffered_io_add_one(this->io,
+                                                &(this->hangup),
+                                                sizeof this->hangup,
+                                                cgutils_event_buffered_io_reading,
+                                                &cg_storage_connection_ring_hangup,
+                                                this);
+
+        if (COMPILER_LIKELY(res == 0))
+        {
+            this->sock_io = this->io;
+            this->io = read_io;
+            read_io = NULL;
+            this->write_io = write_io;
+            write_io = NULL;
+            this->multiplexed = true;
+
+            res = cg_storage_connection_read_frame(this);
+        }
+        else
+        {
+            CGUTILS_ERROR("Error watching ring connection socket: %d", res);
+        }
+    }
+    else if (COMPILER_UNLIKELY(res != 0))
+    {
+        CGUTILS_ERROR("Error sending code: %d", res);
+    }
+
+    if (read_io != NULL)
+    {
+        cgutils_event_buffered_io_release(read_io), read_io = NULL;
+    }
+
+    if (write_io != NULL)
+    {
+        cgutils_event_buffered_io_release(write_io), write_io = NULL;
+    }
+
+    return res;
+}
+
+static int cg_storage_connection_got_ring_fd(cgutils_event_data * data,
+                                             int status,
+                                             int fd,
+                                             cgutils_event_buffered_io_obj * obj)
+{
+    assert(data != NULL);
+    assert(obj != NULL);
+    assert(fd >= 0);
+    (void) data;
+    (void) fd;
+
+    cg_storage_connection * this = obj->cb_data;
+
+    int result = status;
+
+    if (COMPILER_LIKELY(result == 0))
+    {
+        CGUTILS_ASSERT(this->ring_fds_count < cgsm_proto_ring_fd_count);
+        this->ring_fds_count++;
+
+        if (this->ring_fds_count == cgsm_proto_ring_fd_count)
+        {
+            result = cg_storage_connection_ring_setup(this);
+        }
+    }
+    else
+    {
+        CGUTILS_ERROR("Error reading ring eventfd: %d", result);
+    }
+
+    if (COMPILER_UNLIKELY(result != 0))
+    {
+        cg_storage_connection_finish(this), this = NULL;
+    }
+
+    return result;
+}
+
+static int cg_storage_connection_got_ring_name(cgutils_event_data * data,
+                                               int status,
+                                               int fd,
+                                               cgutils_event_buffered_io_obj * obj)
+{
+    assert(data != NULL);
+    assert(obj != NULL);
+    assert(fd >= 0);
+    (void) data;
+    (void) fd;
+
+    cg_storage_connection * this = obj->cb_data;
+
+    int result = status;
+
+    if (COMPILER_LIKELY(result == 0))
+    {
+        this->ring_name[this->ring_name_len] = '\0';
+
+        for (size_t idx = 0;
+             result == 0 && idx < cgsm_proto_ring_fd_count;
+             idx++)
+        {
+            result = cgutils_event_buffered_io_add_fd(this->io,
+                                                      &(this->ring_fds[idx]),
+                                                      cgutils_event_buffered_io_reading,
+                                                      &cg_storage_connection_got_ring_fd,
+                                                      this);
+        }
+
+        if (COMPILER_UNLIKELY(result != 0))
+        {
+            CGUTILS_ERROR("Error reading ring eventfds: %d", result);
+        }
+    }
+    else
+    {
+        CGUTILS_ERROR("Error reading ring name: %d", result);
+    }
+
+    if (COMPILER_UNLIKELY(result != 0))
+    {
+        cg_storage_connection_finish(this), this = NULL;
+    }
+
+    return result;
+}
+
+static int cg_storage_connection_got_ring_name_len(cgutils_event_data * data,
+                                                   int status,
+                                                   int fd,
+                                                   cgutils_event_buffered_io_obj * obj)
+{
+    assert(data != NULL);
+    assert(obj != NULL);
+    assert(fd >= 0);
+    (void) data;
+    (void) fd;
+
+    cg_storage_connection * this = obj->cb_data;
+
+    int result = status;
+
+    if (COMPILER_LIKELY(result == 0))
+    {
+        if (COMPILER_LIKELY(this->ring_name_len > 0 &&
+                            this->ring_name_len <= CG_ST_RING_NAME_MAX))
+        {
+            CGUTILS_ASSERT(this->ring_name == NULL);
+            CGUTILS_MALLOC(this->ring_name, this->ring_name_len + 1, 1);
+
+            if (COMPILER_LIKELY(this->ring_name != NULL))
+            {
+                result = cgutils_event_buffered_io_add_one(this->io,
+                                                           this->ring_name,
+                                                           this->ring_name_len,
+                                                           cgutils_event_buffered_io_reading,
+                                                           &cg_storage_connection_got_ring_name,
+                                                           this);
+
+                if (COMPILER_UNLIKELY(result != 0))
+                {
+                    CGUTILS_ERROR("Error reading ring name: %d", result);
+                }
+            }
+            else
+            {
+                result = ENOMEM;
+                CGUTILS_ERROR("Error allocating memory for ring name: %d", result);
+            }
+        }
+        else
+        {
+            result = EINVAL;
+            CGUTILS_ERROR("Invalid ring name length %zu: %d",
+                          this->ring_name_len,
+                          result);
+        }
+    }
+    else
+    {
+        CGUTILS_ERROR("Error reading ring name length: %d", result);
+    }
+
+    if (COMPILER_UNLIKELY(result != 0))
+    {
+        cg_storage_connection_finish(this), this = NULL;
+    }
+
+    return result;
+}
+
+static int cg_storage_connection_got_ring_size(cgutils_event_data * data,
+                                               int status,
+                                               int fd,
+                                               cgutils_event_buffered_io_obj * obj)
+{
+    assert(data != NULL);
+    assert(obj != NULL);
+    assert(fd >= 0);
+    (void) data;
+    (void) fd;
+
+    cg_storage_connection * this = obj->cb_data;
+
+    int result = status;
+
+    if (COMPILER_LIKELY(result == 0))
+    {
+        if (COMPILER_LIKELY(this->ring_size <= CG_ST_RING_SIZE_MAX &&
+                            cgutils_ring_get_memory_size((size_t) this->ring_size) > 0))
+        {
+            result = cgutils_event_buffered_io_add_one(this->io,
+                                                       &(this->ring_name_len),
+                                                       sizeof this->ring_name_len,
+                                                       cgutils_event_buffered_io_reading,
+                                                       &cg_storage_connection_got_ring_name_len,
+                                                       this);
+
+            if (COMPILER_UNLIKELY(result != 0))
+            {
+                CGUTILS_ERROR("Error reading ring name length: %d", result);
+            }
+        }
+        else
+        {
+            result = EINVAL;
+            CGUTILS_ERROR("Invalid ring size %"PRIu64": %d",
+                          this->ring_size,
+                          result);
+        }
+    }
+    else
+    {
+        CGUTILS_ERROR("Error reading ring size: %d", result);
+    }
+
+    if (COMPILER_UNLIKELY(result != 0))
+    {
+        cg_storage_connection_finish(this), this = NULL;
+    }
+
+    return result;
+}
+
+int cg_storage_connection_multiplex_ring(cg_storage_connection * const this)
+{
+    int result = EINVAL;
+
+    if (COMPILER_LIKELY(this != NULL &&
+                        this->parent == NULL &&
+                        this->multiplexed == false &&
+                        this->ring_name == NULL))
+    {
+        result = cgutils_event_buffered_io_add_one(this->io,
+                                                   &(this->ring_size),
+                                                   sizeof this->ring_size,
+                                                   cgutils_event_buffered_io_reading,
+                                                   &cg_storage_connection_got_ring_size,
+                                                   this);
+
+        if (COMPILER_UNLIKELY(result != 0))
+        {
+            CGUTILS_ERROR("Error reading ring size: %d", result);
+        }
+    }
+    else
+    {
+        CGUTILS_ERROR("Shared memory rings are not allowed on this connection: %d", result);
+    }
+
+    return result;
+}
+
 int cg_storage_connection_go(cg_storage_connection * const this)
 {
     int result = EINVAL;
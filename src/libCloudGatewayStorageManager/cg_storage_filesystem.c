@@ -42,6 +42,9 @@
 
 #define CG_STORAGE_FILESYSTEM_DEFAULT_IO_BLOCK_SIZE (4096)
 #define CG_STORAGE_FILESYSTEM_DEFAULT_INODE_DIGEST (cgutils_crypto_digest_algorithm_sha256)
+#define CG_STORAGE_FILESYSTEM_DEFAULT_INODE_CACHE_SIZE (16384)
+#define CG_STORAGE_FILESYSTEM_DEFAULT_INODE_CACHE_TTL (1000)
+#define CG_STORAGE_FILESYSTEM_DEFAULT_OPEN_LEASE_DURATION (5000)
 
 char const * cg_storage_filesystem_state_to_str(cg_storage_filesystem_handler_state const state)
 {
@@ -398,6 +401,9 @@ int cg_storage_filesystem_init(cg_storage_manager_data * const data,
                                     uint64_t clean_max_access_offset = 0;
                                     uint64_t delayed_expunge = 0;
                                     uint64_t io_block_size = 0;
+                                    uint64_t inode_cache_size = CG_STORAGE_FILESYSTEM_DEFAULT_INODE_CACHE_SIZE;
+                                    uint64_t inode_cache_ttl = CG_STORAGE_FILESYSTEM_DEFAULT_INODE_CACHE_TTL;
+                                    uint64_t open_lease_duration = CG_STORAGE_FILESYSTEM_DEFAULT_OPEN_LEASE_DURATION;
                                     char * digest_algo_str = NULL;
                                     bool auto_expunge;
 
@@ -521,6 +527,71 @@ int cg_storage_filesystem_init(cg_storage_manager_data * const data,
                                     {
                                         (*filesystem)->digest_algorithm = CG_STORAGE_FILESYSTEM_DEFAULT_INODE_DIGEST;
                                     }
+
+                                    res = cgutils_configuration_get_unsigned_integer(filesystem_conf,
+                                                                                     "InodeCacheSize",
+                                                                                     &inode_cache_size);
+
+                                    if (res == E2BIG)
+                                    {
+                                        CGUTILS_WARN("More than one 'InodeCacheSize' value specified for FS %s, using the default.", (*filesystem)->name);
+                                        inode_cache_size = CG_STORAGE_FILESYSTEM_DEFAULT_INODE_CACHE_SIZE;
+                                    }
+                                    else if (res != 0 && res != ENOENT)
+                                    {
+                                        CGUTILS_WARN("Error retrieving the 'InodeCacheSize' value for FS %s, using the default.", (*filesystem)->name);
+                                        inode_cache_size = CG_STORAGE_FILESYSTEM_DEFAULT_INODE_CACHE_SIZE;
+                                    }
+
+                                    res = cgutils_configuration_get_unsigned_integer(filesystem_conf,
+                                                                                     "InodeCacheTTL",
+                                                                                     &inode_cache_ttl);
+
+                                    if (res == E2BIG)
+                                    {
+                                        CGUTILS_WARN("More than one 'InodeCacheTTL' value specified for FS %s, using the default.", (*filesystem)->name);
+                                        inode_cache_ttl = CG_STORAGE_FILESYSTEM_DEFAULT_INODE_CACHE_TTL;
+                                    }
+                                    else if (res != 0 && res != ENOENT)
+                                    {
+                                        CGUTILS_WARN("Error retrieving the 'InodeCacheTTL' value for FS %s, using the default.", (*filesystem)->name);
+                                        inode_cache_ttl = CG_STORAGE_FILESYSTEM_DEFAULT_INODE_CACHE_TTL;
+                                    }
+
+                                    res = cgutils_configuration_get_unsigned_integer(filesystem_conf,
+                                                                                     "OpenLeaseDuration",
+                                                                                     &open_lease_duration);
+
+                                    if (res == E2BIG)
+                                    {
+                                        CGUTILS_WARN("More than one 'OpenLeaseDuration' value specified for FS %s, using the default.", (*filesystem)->name);
+                                        open_lease_duration = CG_STORAGE_FILESYSTEM_DEFAULT_OPEN_LEASE_DURATION;
+                                    }
+                                    else if (res != 0 && res != ENOENT)
+                                    {
+                                        CGUTILS_WARN("Error retrieving the 'OpenLeaseDuration' value for FS %s, using the default.", (*filesystem)->name);
+                                        open_lease_duration = CG_STORAGE_FILESYSTEM_DEFAULT_OPEN_LEASE_DURATION;
+                                    }
+                                    else if (open_lease_duration > UINT32_MAX)
+                                    {
+                                        CGUTILS_WARN("Invalid 'OpenLeaseDuration' value for FS %s, using the default.", (*filesystem)->name);
+                                        open_lease_duration = CG_STORAGE_FILESYSTEM_DEFAULT_OPEN_LEASE_DURATION;
+                                    }
+
+                                    (*filesystem)->open_lease_duration = (uint32_t) open_lease_duration;
+
+                                    if (inode_cache_size > 0 &&
+                                        inode_cache_ttl > 0)
+                                    {
+                                        res = cg_storage_inode_cache_init((size_t) inode_cache_size,
+                                                                          inode_cache_ttl,
+                                                                          &((*filesystem)->inode_cache));
+
+                                        if (res != 0)
+                                        {
+                                            CGUTILS_WARN("Error creating the inode cache for FS %s, disabling it: %d", (*filesystem)->name, res);
+                                        }
+                                    }
                                 }
                                 else
                                 {
@@ -575,6 +646,22 @@ void cg_storage_filesystem_free(cg_storage_filesystem * fs)
 {
     if (fs != NULL)
     {
+        if (fs->inode_cache != NULL)
+        {
+            cg_storage_inode_cache_stats stats = { 0 };
+            cg_storage_inode_cache_get_stats(fs->inode_cache, &stats);
+
+            CGUTILS_INFO("Inode cache for FS %s: %"PRIu64" hits, %"PRIu64" misses, %"PRIu64" insertions, %"PRIu64" evictions, %"PRIu64" invalidations",
+                         fs->name,
+                         stats.hits,
+                         stats.misses,
+                         stats.insertions,
+                         stats.evictions,
+                         stats.invalidations);
+
+            cg_storage_inode_cache_free(fs->inode_cache), fs->inode_cache = NULL;
+        }
+
         if (fs->name != NULL)
         {
             CGUTILS_FREE(fs->name);
@@ -704,6 +791,18 @@ uint32_t cg_storage_filesystem_get_io_block_size(cg_storage_filesystem const * c
     return result;
 }
 
+uint32_t cg_storage_filesystem_get_open_lease_duration(cg_storage_filesystem const * const fs)
+{
+    uint32_t result = 0;
+
+    if (fs != NULL)
+    {
+        result = fs->open_lease_duration;
+    }
+
+    return result;
+}
+
 cg_storage_filesystem_type cg_storage_filesystem_get_type(cg_storage_filesystem const * const this)
 {
     cg_storage_filesystem_type result = 0;
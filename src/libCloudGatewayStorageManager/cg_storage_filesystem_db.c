@@ -329,6 +329,62 @@ int cg_storage_filesystem_db_get_or_create_root_inode(cg_storage_filesystem * co
     return result;
 }
 
+/* Callbacks used by requests altering inodes or entries,
+   closing the inode cache mutation window opened before the request. */
+static void cg_storage_filesystem_db_mutation_end(cg_storage_fs_cb_data * const data,
+                                                  uint64_t const first_ino,
+                                                  uint64_t const second_ino)
+{
+    cg_storage_filesystem * const fs = cg_storage_fs_cb_data_get_fs(data);
+    CGUTILS_ASSERT(fs != NULL);
+
+    if (first_ino > 0)
+    {
+        cg_storage_inode_cache_invalidate(fs->inode_cache, first_ino);
+    }
+
+    if (second_ino > 0)
+    {
+        cg_storage_inode_cache_invalidate(fs->inode_cache, second_ino);
+    }
+
+    cg_storage_inode_cache_mutation_end(fs->inode_cache);
+}
+
+static int cg_storage_filesystem_db_mutation_status_cb(int const status,
+                                                       void * const void_data)
+{
+    CGUTILS_ASSERT(void_data != NULL);
+
+    cg_storage_filesystem_db_mutation_end(void_data, 0, 0);
+
+    return cg_storage_filesystem_db_status_cb(status, void_data);
+}
+
+static int cg_storage_filesystem_db_mutation_returning_cb(int const status,
+                                                          uint64_t const returning_id,
+                                                          void * const void_data)
+{
+    CGUTILS_ASSERT(void_data != NULL);
+
+    cg_storage_filesystem_db_mutation_end(void_data,
+                                          status == 0 ? returning_id : 0,
+                                          0);
+
+    return cg_storage_filesystem_db_returning_cb(status, returning_id, void_data);
+}
+
+static int cg_storage_filesystem_db_mutation_inode_info_cb(int const status,
+                                                           cgdb_inode * const inode,
+                                                           void * const void_data)
+{
+    CGUTILS_ASSERT(void_data != NULL);
+
+    cg_storage_filesystem_db_mutation_end(void_data, 0, 0);
+
+    return cg_storage_filesystem_db_get_inode_info_cb(status, inode, void_data);
+}
+
 int cg_storage_filesystem_db_create_file_entry(cg_storage_filesystem * const fs,
                                                uid_t const uid,
                                                gid_t const gid,
@@ -376,14 +432,24 @@ int cg_storage_filesystem_db_create_file_entry(cg_storage_filesystem * const fs,
 
         if (COMPILER_LIKELY(result == 0))
         {
+            uint64_t const parent_inode_number = cg_storage_fs_cb_data_get_parent_inode_number(data);
+
+            cg_storage_inode_cache_mutation_begin(fs->inode_cache);
+            cg_storage_inode_cache_invalidate(fs->inode_cache, parent_inode_number);
+            cg_storage_inode_cache_invalidate_child(fs->inode_cache,
+                                                    parent_inode_number,
+                                                    cg_storage_fs_cb_data_get_path(data));
+
             result = cgdb_add_new_entry_and_inode(fs->db,
-                                                  cg_storage_fs_cb_data_get_parent_inode_number(data),
+                                                  parent_inode_number,
                                                   entry,
-                                                  &cg_storage_filesystem_db_returning_cb,
+                                                  &cg_storage_filesystem_db_mutation_returning_cb,
                                                   data);
 
             if (COMPILER_UNLIKELY(result != 0))
             {
+                cg_storage_inode_cache_mutation_end(fs->inode_cache);
+
                 CGUTILS_ERROR("Error adding entry %"PRIu64"->%s, on fs %s: %d",
                               cg_storage_fs_cb_data_get_parent_inode_number(data),
                               cg_storage_fs_cb_data_get_path(data),
@@ -444,14 +510,24 @@ int cg_storage_filesystem_db_create_symlink_entry(cg_storage_filesystem * const
 
         if (COMPILER_LIKELY(result == 0))
         {
+            uint64_t const parent_inode_number = cg_storage_fs_cb_data_get_parent_inode_number(data);
+
+            cg_storage_inode_cache_mutation_begin(fs->inode_cache);
+            cg_storage_inode_cache_invalidate(fs->inode_cache, parent_inode_number);
+            cg_storage_inode_cache_invalidate_child(fs->inode_cache,
+                                                    parent_inode_number,
+                                                    cg_storage_fs_cb_data_get_path(data));
+
             result = cgdb_add_new_entry_and_inode(fs->db,
-                                                  cg_storage_fs_cb_data_get_parent_inode_number(data),
+                                                  parent_inode_number,
                                                   entry,
-                                                  &cg_storage_filesystem_db_returning_cb,
+                                                  &cg_storage_filesystem_db_mutation_returning_cb,
                                                   data);
 
             if (COMPILER_UNLIKELY(result != 0))
             {
+                cg_storage_inode_cache_mutation_end(fs->inode_cache);
+
                 CGUTILS_ERROR("Error adding symlink %"PRIu64"->%s to %s, on fs %s: %d",
                               cg_storage_fs_cb_data_get_parent_inode_number(data),
                               cg_storage_fs_cb_data_get_path(data),
@@ -512,14 +588,24 @@ int cg_storage_filesystem_db_create_dir_entry(cg_storage_filesystem * const fs,
 
         if (COMPILER_LIKELY(result == 0))
         {
+            uint64_t const parent_inode_number = cg_storage_fs_cb_data_get_parent_inode_number(data);
+
+            cg_storage_inode_cache_mutation_begin(fs->inode_cache);
+            cg_storage_inode_cache_invalidate(fs->inode_cache, parent_inode_number);
+            cg_storage_inode_cache_invalidate_child(fs->inode_cache,
+                                                    parent_inode_number,
+                                                    cg_storage_fs_cb_data_get_path(data));
+
             result = cgdb_add_new_entry_and_inode(fs->db,
-                                                  cg_storage_fs_cb_data_get_parent_inode_number(data),
+                                                  parent_inode_number,
                                                   entry,
-                                                  &cg_storage_filesystem_db_returning_cb,
+                                                  &cg_storage_filesystem_db_mutation_returning_cb,
                                                   data);
 
             if (COMPILER_UNLIKELY(result != 0))
             {
+                cg_storage_inode_cache_mutation_end(fs->inode_cache);
+
                 CGUTILS_ERROR("Error adding dir entry %"PRIu64"->%s, on fs %s: %d",
                               cg_storage_fs_cb_data_get_parent_inode_number(data),
                               cg_storage_fs_cb_data_get_path(data),
@@ -743,6 +829,41 @@ int cg_storage_filesystem_db_add_inode_instance(cg_storage_filesystem * const fs
     return result;
 }
 
+int cg_storage_filesystem_db_add_inode_instances(cg_storage_filesystem * const fs,
+                                                 uint64_t const inode_number,
+                                                 uint64_t const * const instances_ids,
+                                                 char const * const * const ids_in_instance,
+                                                 size_t const instances_count,
+                                                 cg_storage_instance_status const status,
+                                                 cg_storage_fs_cb_data * const data)
+{
+    int result = 0;
+    CGUTILS_ASSERT(fs != NULL);
+    CGUTILS_ASSERT(data != NULL);
+
+    result = cgdb_add_inode_instances(fs->db,
+                                      fs->id,
+                                      inode_number,
+                                      instances_ids,
+                                      ids_in_instance,
+                                      instances_count,
+                                      status,
+                                      &cg_storage_filesystem_db_status_cb,
+                                      data);
+
+    if (result != 0 &&
+        result != ENOSYS)
+    {
+        CGUTILS_ERROR("Error adding %zu inode instances for inode %"PRIu64", fs %s: %d",
+                      instances_count,
+                      inode_number,
+                      fs->name,
+                      result);
+    }
+
+    return result;
+}
+
 int cg_storage_filesystem_db_set_inode_instance_delete_in_progress(cg_storage_filesystem * const fs,
                                                                    cg_storage_fs_cb_data * const data)
 {
@@ -859,6 +980,100 @@ int cg_storage_filesystem_db_get_dir_entries_by_inode(cg_storage_filesystem * co
     return result;
 }
 
+int cg_storage_filesystem_db_get_dir_entries_page_by_inode(cg_storage_filesystem * const fs,
+                                                           uint64_t const inode,
+                                                           uint64_t const after_entry_id,
+                                                           size_t const max_entries,
+                                                           cg_storage_fs_cb_data * const data)
+{
+    int result = 0;
+    CGUTILS_ASSERT(fs != NULL);
+    CGUTILS_ASSERT(inode >= 1);
+    CGUTILS_ASSERT(max_entries > 0);
+    CGUTILS_ASSERT(data != NULL);
+
+    result = cgdb_get_inode_entries_page(fs->db,
+                                         fs->id,
+                                         inode,
+                                         after_entry_id,
+                                         (cgdb_limit_type) max_entries,
+                                         &cg_storage_filesystem_db_entries_cb,
+                                         data);
+
+    if (result != 0)
+    {
+        CGUTILS_ERROR("Error listing entries from directory %"PRIu64" after %"PRIu64", fs %s: %d",
+                      inode,
+                      after_entry_id,
+                      fs->name,
+                      result);
+    }
+
+    return result;
+}
+
+int cg_storage_filesystem_db_get_inodes_info_multi(cg_storage_filesystem * const fs,
+                                                   uint64_t const * const inodes,
+                                                   size_t const inodes_count,
+                                                   cg_storage_fs_cb_data * const data)
+{
+    int result = 0;
+    CGUTILS_ASSERT(fs != NULL);
+    CGUTILS_ASSERT(inodes != NULL);
+    CGUTILS_ASSERT(inodes_count > 0);
+    CGUTILS_ASSERT(data != NULL);
+
+    result = cgdb_get_inodes_info_multi(fs->db,
+                                        fs->id,
+                                        inodes,
+                                        inodes_count,
+                                        &cg_storage_filesystem_db_entries_cb,
+                                        data);
+
+    if (result != 0)
+    {
+        CGUTILS_ERROR("Error getting %zu inodes, fs %s: %d",
+                      inodes_count,
+                      fs->name,
+                      result);
+    }
+
+    return result;
+}
+
+int cg_storage_filesystem_db_get_children_inodes_info_multi(cg_storage_filesystem * const fs,
+                                                            uint64_t const parent,
+                                                            char const * const * const names,
+                                                            size_t const names_count,
+                                                            cg_storage_fs_cb_data * const data)
+{
+    int result = 0;
+    CGUTILS_ASSERT(fs != NULL);
+    CGUTILS_ASSERT(parent >= 1);
+    CGUTILS_ASSERT(names != NULL);
+    CGUTILS_ASSERT(names_count > 0);
+    CGUTILS_ASSERT(data != NULL);
+
+    result = cgdb_get_children_inodes_info_multi(fs->db,
+                                                 fs->id,
+                                                 parent,
+                                                 names,
+                                                 names_count,
+                                                 &cg_storage_filesystem_db_entries_cb,
+                                                 data);
+
+    if (result != 0)
+    {
+        CGUTILS_ERROR("Error looking up %zu children of %"PRIu64", fs %s: %d",
+                      names_count,
+                      parent,
+                      fs->name,
+                      result);
+    }
+
+    return result;
+}
+
 int cg_storage_filesystem_db_update_cache_status(cg_storage_filesystem * const fs,
                                                  uint64_t const inode_number,
                                                  bool const in_cache,
@@ -868,15 +1083,20 @@ int cg_storage_filesystem_db_update_cache_status(cg_storage_filesystem * const f
     CGUTILS_ASSERT(fs != NULL);
     CGUTILS_ASSERT(data != NULL);
 
+    cg_storage_inode_cache_mutation_begin(fs->inode_cache);
+    cg_storage_inode_cache_invalidate(fs->inode_cache, inode_number);
+
     result = cgdb_update_inode_cache_status(fs->db,
                                             fs->id,
                                             inode_number,
                                             in_cache,
-                                            &cg_storage_filesystem_db_status_cb,
+                                            &cg_storage_filesystem_db_mutation_status_cb,
                                             data);
 
     if (result != 0)
     {
+        cg_storage_inode_cache_mutation_end(fs->inode_cache);
+
         CGUTILS_ERROR("Error updating cache status for inode %"PRIu64" on fs %s: %d",
                       inode_number,
                       fs->name,
@@ -898,6 +1118,9 @@ int cg_storage_filesystem_db_set_inode_digest(cg_storage_filesystem * const fs,
     CGUTILS_ASSERT(fs != NULL);
     CGUTILS_ASSERT(data != NULL);
 
+    cg_storage_inode_cache_mutation_begin(fs->inode_cache);
+    cg_storage_inode_cache_invalidate(fs->inode_cache, inode_number);
+
     result = cgdb_update_inode_digest(fs->db,
                                       fs->id,
                                       inode_number,
@@ -905,11 +1128,13 @@ int cg_storage_filesystem_db_set_inode_digest(cg_storage_filesystem * const fs,
                                       digest,
                                       digest_size,
                                       max_mtime,
-                                      &cg_storage_filesystem_db_status_cb,
+                                      &cg_storage_filesystem_db_mutation_status_cb,
                                       data);
 
     if (result != 0)
     {
+        cg_storage_inode_cache_mutation_end(fs->inode_cache);
+
         CGUTILS_ERROR("Error updating digest for inode %"PRIu64" on fs %s: %d",
                       inode_number,
                       fs->name,
@@ -958,15 +1183,20 @@ int cg_storage_filesystem_db_update_inode_counter(cg_storage_filesystem * const
     CGUTILS_ASSERT(fs != NULL);
     CGUTILS_ASSERT(data != NULL);
 
+    cg_storage_inode_cache_mutation_begin(fs->inode_cache);
+    cg_storage_inode_cache_invalidate(fs->inode_cache, inode_number);
+
     result = cgdb_update_inode_counter(fs->db,
                                        fs->id,
                                        inode_number,
                                        1,
                                        increment,
-                                       &cg_storage_filesystem_db_status_cb,
+                                       &cg_storage_filesystem_db_mutation_status_cb,
                                        data);
     if (result != 0)
     {
+        cg_storage_inode_cache_mutation_end(fs->inode_cache);
+
         CGUTILS_ERROR("Error updating dirty writers counter for inode %"PRIu64" on fs %s: %d",
                       inode_number,
                       fs->name,
@@ -987,6 +1217,10 @@ int cg_storage_filesystem_db_release_inode(cg_storage_filesystem * const fs,
     CGUTILS_ASSERT(fs != NULL);
     CGUTILS_ASSERT(data != NULL);
 
+    cg_storage_inode_cache_mutation_begin(fs->inode_cache);
+    cg_storage_inode_cache_invalidate(fs->inode_cache,
+                                      cg_storage_fs_cb_data_get_inode_number(data));
+
     if (altered == true)
     {
         time_t const now = time(NULL);
@@ -1002,7 +1236,7 @@ int cg_storage_filesystem_db_release_inode(cg_storage_filesystem * const fs,
                                        everything else is fine */
                                     cg_storage_instance_status_ok,
                                     cg_storage_instance_status_dirty,
-                                    &cg_storage_filesystem_db_status_cb,
+                                    &cg_storage_filesystem_db_mutation_status_cb,
                                     data);
     }
     else
@@ -1012,12 +1246,14 @@ int cg_storage_filesystem_db_release_inode(cg_storage_filesystem * const fs,
                                            cg_storage_fs_cb_data_get_inode_number(data),
                                            1,
                                            false,
-                                           &cg_storage_filesystem_db_status_cb,
+                                           &cg_storage_filesystem_db_mutation_status_cb,
                                            data);
     }
 
     if (COMPILER_UNLIKELY(result != 0))
     {
+        cg_storage_inode_cache_mutation_end(fs->inode_cache);
+
         CGUTILS_ERROR("Error releasing inode %"PRIu64" on fs %s: %d",
                       cg_storage_fs_cb_data_get_inode_number(data),
                       fs->name,
@@ -1041,6 +1277,9 @@ int cg_storage_filesystem_db_set_inode_dirty(cg_storage_filesystem * const fs,
     CGUTILS_ASSERT(inode_number > 0);
     CGUTILS_ASSERT(data != NULL);
 
+    cg_storage_inode_cache_mutation_begin(fs->inode_cache);
+    cg_storage_inode_cache_invalidate(fs->inode_cache, inode_number);
+
     result = cgdb_set_inode_and_all_inodes_instances_dirty(fs->db,
                                                            fs->id,
                                                            inode_number,
@@ -1051,10 +1290,12 @@ int cg_storage_filesystem_db_set_inode_dirty(cg_storage_filesystem * const fs,
                                                               everything else is fine */
                                                            cg_storage_instance_status_ok,
                                                            cg_storage_instance_status_dirty,
-                                                           &cg_storage_filesystem_db_status_cb,
+                                                           &cg_storage_filesystem_db_mutation_status_cb,
                                                            data);
     if (result != 0)
     {
+        cg_storage_inode_cache_mutation_end(fs->inode_cache);
+
         CGUTILS_ERROR("Error settting status dirty for inode %"PRIu64" of fs %s: %d",
                       inode_number,
                       fs->name,
@@ -1064,6 +1305,53 @@ int cg_storage_filesystem_db_set_inode_dirty(cg_storage_filesystem * const fs,
     return result;
 }
 
+int cg_storage_filesystem_db_set_inodes_dirty_multi(cg_storage_filesystem * const fs,
+                                                    uint64_t const * const inodes,
+                                                    size_t const inodes_count,
+                                                    time_t const mtime,
+                                                    time_t const ctime_local,
+                                                    time_t const last_modification,
+                                                    cg_storage_fs_cb_data * const data)
+{
+    int result = 0;
+    CGUTILS_ASSERT(fs != NULL);
+    CGUTILS_ASSERT(inodes != NULL);
+    CGUTILS_ASSERT(inodes_count > 0);
+    CGUTILS_ASSERT(data != NULL);
+
+    cg_storage_inode_cache_mutation_begin(fs->inode_cache);
+
+    for (size_t idx = 0;
+         idx < inodes_count;
+         idx++)
+    {
+        cg_storage_inode_cache_invalidate(fs->inode_cache, inodes[idx]);
+    }
+
+    result = cgdb_set_inodes_and_all_inodes_instances_dirty_multi(fs->db,
+                                                                  fs->id,
+                                                                  inodes,
+                                                                  inodes_count,
+                                                                  mtime,
+                                                                  ctime_local,
+                                                                  last_modification,
+                                                                  cg_storage_instance_status_ok,
+                                                                  cg_storage_instance_status_dirty,
+                                                                  &cg_storage_filesystem_db_mutation_status_cb,
+                                                                  data);
+    if (result != 0)
+    {
+        cg_storage_inode_cache_mutation_end(fs->inode_cache);
+
+        CGUTILS_ERROR("Error settting status dirty for %zu inodes of fs %s: %d",
+                      inodes_count,
+                      fs->name,
+                      result);
+    }
+
+    return result;
+}
+
 int cg_storage_filesystem_db_update_cache_and_dirty_writers_status(cg_storage_filesystem * const fs,
                                                                    uint64_t const inode_number,
                                                                    bool const in_cache,
@@ -1076,13 +1364,16 @@ int cg_storage_filesystem_db_update_cache_and_dirty_writers_status(cg_storage_fi
     CGUTILS_ASSERT(inode_number > 0);
     CGUTILS_ASSERT(data != NULL);
 
+    cg_storage_inode_cache_mutation_begin(fs->inode_cache);
+    cg_storage_inode_cache_invalidate(fs->inode_cache, inode_number);
+
     if (increase_dirty_writers == true)
     {
         result = cgdb_update_inode_cache_status_and_increase_dirty_writers(fs->db,
                                                                            fs->id,
                                                                            inode_number,
                                                                            in_cache,
-                                                                           &cg_storage_filesystem_db_status_cb,
+                                                                           &cg_storage_filesystem_db_mutation_status_cb,
                                                                            data);
     }
     else
@@ -1091,12 +1382,14 @@ int cg_storage_filesystem_db_update_cache_and_dirty_writers_status(cg_storage_fi
                                                 fs->id,
                                                 inode_number,
                                                 in_cache,
-                                                &cg_storage_filesystem_db_status_cb,
+                                                &cg_storage_filesystem_db_mutation_status_cb,
                                                 data);
     }
 
     if (result != 0)
     {
+        cg_storage_inode_cache_mutation_end(fs->inode_cache);
+
         CGUTILS_ERROR("Error updating inode cache status (to %d, dirty writers %d) for inode %"PRIu64" of fs %s: %d",
                       in_cache,
                       increase_dirty_writers,
@@ -1121,6 +1414,9 @@ int cg_storage_filesystem_db_get_inode_cache_status_updating_writers(cg_storage_
 
     time_t const now = time(NULL);
 
+    cg_storage_inode_cache_mutation_begin(fs->inode_cache);
+    cg_storage_inode_cache_invalidate(fs->inode_cache, inode_number);
+
     result = cgdb_get_inode_info_updating_times_and_writers(fs->db,
                                                             fs->id,
                                                             inode_number,
@@ -1128,10 +1424,12 @@ int cg_storage_filesystem_db_get_inode_cache_status_updating_writers(cg_storage_
                                                             (uint64_t) now,
                                                             (uint64_t) now,
                                                             increase_dirty_writers,
-                                                            &cg_storage_filesystem_db_get_inode_info_cb,
+                                                            &cg_storage_filesystem_db_mutation_inode_info_cb,
                                                             data);
     if (result != 0)
     {
+        cg_storage_inode_cache_mutation_end(fs->inode_cache);
+
         CGUTILS_ERROR("Error getting inode info, updating attributes for inode %"PRIu64" of fs %s: %d",
                       inode_number,
                       fs->name,
@@ -1151,15 +1449,20 @@ int cg_storage_filesystem_db_decrease_dirty_writers_count(cg_storage_filesystem
     CGUTILS_ASSERT(inode_number > 0);
     CGUTILS_ASSERT(data != NULL);
 
+    cg_storage_inode_cache_mutation_begin(fs->inode_cache);
+    cg_storage_inode_cache_invalidate(fs->inode_cache, inode_number);
+
     result = cgdb_update_inode_counter(fs->db,
                                        fs->id,
                                        inode_number,
                                        1,
                                        true,
-                                       &cg_storage_filesystem_db_status_cb,
+                                       &cg_storage_filesystem_db_mutation_status_cb,
                                        data);
     if (result != 0)
     {
+        cg_storage_inode_cache_mutation_end(fs->inode_cache);
+
         CGUTILS_ERROR("Error decreasing inode %"PRIu64" dirty writers count, on fs %s: %d",
                       inode_number,
                       fs->name,
@@ -1183,6 +1486,9 @@ int cg_storage_filesystem_db_update_inode_attributes(cg_storage_filesystem * con
     CGUTILS_ASSERT(fs != NULL);
     CGUTILS_ASSERT(data != NULL);
 
+    cg_storage_inode_cache_mutation_begin(fs->inode_cache);
+    cg_storage_inode_cache_invalidate(fs->inode_cache, inode_number);
+
     result = cgdb_update_inode_attributes(fs->db,
                                           fs->id,
                                           inode_number,
@@ -1192,10 +1498,12 @@ int cg_storage_filesystem_db_update_inode_attributes(cg_storage_filesystem * con
                                           (uint64_t) atime,
                                           (uint64_t) mtime,
                                           size,
-                                          &cg_storage_filesystem_db_status_cb,
+                                          &cg_storage_filesystem_db_mutation_status_cb,
                                           data);
     if (COMPILER_UNLIKELY(result != 0))
     {
+        cg_storage_inode_cache_mutation_end(fs->inode_cache);
+
         CGUTILS_ERROR("Error updating attributes of inode %"PRIu64", on fs %s: %d",
                       inode_number,
                       fs->name,
@@ -1215,14 +1523,22 @@ int cg_storage_filesystem_db_remove_dir_entry(cg_storage_filesystem * const fs,
     CGUTILS_ASSERT(data != NULL);
     CGUTILS_ASSERT(entry_name != NULL);
 
+    cg_storage_inode_cache_mutation_begin(fs->inode_cache);
+    cg_storage_inode_cache_invalidate(fs->inode_cache, parent_inode_number);
+    cg_storage_inode_cache_invalidate_child(fs->inode_cache,
+                                            parent_inode_number,
+                                            entry_name);
+
     result = cgdb_remove_dir_entry(fs->db,
                                    fs->id,
                                    parent_inode_number,
                                    entry_name,
-                                   &cg_storage_filesystem_db_returning_cb,
+                                   &cg_storage_filesystem_db_mutation_returning_cb,
                                    data);
     if (COMPILER_UNLIKELY(result != 0))
     {
+        cg_storage_inode_cache_mutation_end(fs->inode_cache);
+
         CGUTILS_ERROR("Error removing dir entry named %s from inode %"PRIu64", on fs %s: %d",
                       entry_name,
                       parent_inode_number,
@@ -1254,6 +1570,23 @@ static int cg_storage_filesystem_db_returning_inode_number_and_deleted_status_cb
     return status;
 }
 
+static int cg_storage_filesystem_db_mutation_returning_inode_number_and_deleted_status_cb(int const status,
+                                                                                          uint64_t const returning_id,
+                                                                                          bool const deleted,
+                                                                                          void * const void_data)
+{
+    CGUTILS_ASSERT(void_data != NULL);
+
+    cg_storage_filesystem_db_mutation_end(void_data,
+                                          status == 0 ? returning_id : 0,
+                                          0);
+
+    return cg_storage_filesystem_db_returning_inode_number_and_deleted_status_cb(status,
+                                                                                 returning_id,
+                                                                                 deleted,
+                                                                                 void_data);
+}
+
 int cg_storage_filesystem_db_remove_inode_entry(cg_storage_filesystem * const fs,
                                                 uint64_t const parent_inode_number,
                                                 char const * const entry_name,
@@ -1264,15 +1597,23 @@ int cg_storage_filesystem_db_remove_inode_entry(cg_storage_filesystem * const fs
     CGUTILS_ASSERT(data != NULL);
     CGUTILS_ASSERT(entry_name != NULL);
 
+    cg_storage_inode_cache_mutation_begin(fs->inode_cache);
+    cg_storage_inode_cache_invalidate(fs->inode_cache, parent_inode_number);
+    cg_storage_inode_cache_invalidate_child(fs->inode_cache,
+                                            parent_inode_number,
+                                            entry_name);
+
     result = cgdb_remove_inode_entry(fs->db,
                                      fs->id,
                                      parent_inode_number,
                                      entry_name,
-                                     &cg_storage_filesystem_db_returning_inode_number_and_deleted_status_cb,
+                                     &cg_storage_filesystem_db_mutation_returning_inode_number_and_deleted_status_cb,
                                      data);
 
     if (COMPILER_UNLIKELY(result != 0))
     {
+        cg_storage_inode_cache_mutation_end(fs->inode_cache);
+
         CGUTILS_ERROR("Error removing entry named %s from inode %"PRIu64", on fs %s: %d",
                       entry_name,
                       parent_inode_number,
@@ -1306,6 +1647,25 @@ static int cg_storage_filesystem_db_rename_inode_cb(int const status,
     return 0;
 }
 
+static int cg_storage_filesystem_db_mutation_rename_inode_cb(int const status,
+                                                             uint64_t const renamed_ino,
+                                                             uint64_t const deleted_ino,
+                                                             bool const deleted,
+                                                             void * const void_data)
+{
+    CGUTILS_ASSERT(void_data != NULL);
+
+    cg_storage_filesystem_db_mutation_end(void_data,
+                                          status == 0 ? renamed_ino : 0,
+                                          status == 0 ? deleted_ino : 0);
+
+    return cg_storage_filesystem_db_rename_inode_cb(status,
+                                                    renamed_ino,
+                                                    deleted_ino,
+                                                    deleted,
+                                                    void_data);
+}
+
 int cg_storage_filesystem_db_rename_inode_entry(cg_storage_filesystem * const fs,
                                                 uint64_t const old_parent_ino,
                                                 char const * const old_entry_name,
@@ -1321,17 +1681,29 @@ int cg_storage_filesystem_db_rename_inode_entry(cg_storage_filesystem * const fs
     CGUTILS_ASSERT(new_parent_ino > 0);
     CGUTILS_ASSERT(new_entry_name != NULL);
 
+    cg_storage_inode_cache_mutation_begin(fs->inode_cache);
+    cg_storage_inode_cache_invalidate(fs->inode_cache, old_parent_ino);
+    cg_storage_inode_cache_invalidate(fs->inode_cache, new_parent_ino);
+    cg_storage_inode_cache_invalidate_child(fs->inode_cache,
+                                            old_parent_ino,
+                                            old_entry_name);
+    cg_storage_inode_cache_invalidate_child(fs->inode_cache,
+                                            new_parent_ino,
+                                            new_entry_name);
+
     result = cgdb_rename_inode(fs->db,
                                fs->id,
                                old_parent_ino,
                                old_entry_name,
                                new_parent_ino,
                                new_entry_name,
-                               &cg_storage_filesystem_db_rename_inode_cb,
+                               &cg_storage_filesystem_db_mutation_rename_inode_cb,
                                data);
 
     if (COMPILER_UNLIKELY(result != 0))
     {
+        cg_storage_inode_cache_mutation_end(fs->inode_cache);
+
         CGUTILS_ERROR("Error renaming entry from %"PRIu64"->%s to %"PRIu64"->%s, on fs %s: %d",
                       old_parent_ino,
                       old_entry_name,
@@ -1357,17 +1729,26 @@ int cg_storage_filesystem_db_add_inode_hardlink(cg_storage_filesystem * const fs
     CGUTILS_ASSERT(new_parent_ino > 0);
     CGUTILS_ASSERT(new_entry_name != NULL);
 
+    cg_storage_inode_cache_mutation_begin(fs->inode_cache);
+    cg_storage_inode_cache_invalidate(fs->inode_cache, existing_ino);
+    cg_storage_inode_cache_invalidate(fs->inode_cache, new_parent_ino);
+    cg_storage_inode_cache_invalidate_child(fs->inode_cache,
+                                            new_parent_ino,
+                                            new_entry_name);
+
     result = cgdb_add_hardlink(fs->db,
                                fs->id,
                                existing_ino,
                                new_parent_ino,
                                new_entry_name,
                                CGDB_OBJECT_TYPE_FILE,
-                               &cg_storage_filesystem_db_get_inode_info_cb,
+                               &cg_storage_filesystem_db_mutation_inode_info_cb,
                                data);
 
     if (COMPILER_UNLIKELY(result != 0))
     {
+        cg_storage_inode_cache_mutation_end(fs->inode_cache);
+
         CGUTILS_ERROR("Error hardlinking existing inode %"PRIu64" to %"PRIu64"->%s, on fs %s: %d",
                       existing_ino,
                       new_parent_ino,
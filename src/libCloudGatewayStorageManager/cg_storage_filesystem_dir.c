@@ -186,6 +186,177 @@ int cg_storage_filesystem_dir_get_entries_by_inode(cg_storage_filesystem * const
     return result;
 }
 
+int cg_storage_filesystem_dir_get_entries_page_by_inode(cg_storage_filesystem * const fs,
+                                                        uint64_t const inode,
+                                                        uint64_t const after_entry_id,
+                                                        size_t const max_entries,
+                                                        cg_storage_filesystem_dir_cb * const cb,
+                                                        void * const cb_data)
+{
+    int result = 0;
+    cg_storage_fs_cb_data * data = NULL;
+    CGUTILS_ASSERT(fs != NULL);
+    CGUTILS_ASSERT(inode >= 1);
+    CGUTILS_ASSERT(max_entries > 0);
+    CGUTILS_ASSERT(cb != NULL);
+
+    result = cg_storage_fs_cb_data_init(fs,
+                                        &data);
+
+    if (result == 0)
+    {
+        cg_storage_fs_cb_data_set_inode_number(data, inode);
+
+        /* same handler as the whole directory listing */
+        cg_storage_fs_cb_data_set_handler(data,
+                                          &cg_storage_filesystem_dir_get_entries_by_inode_handler);
+
+        cg_storage_fs_cb_data_set_callback(data,
+                                           cb,
+                                           cb_data);
+
+        cg_storage_fs_cb_data_set_state(data,
+                                        cg_storage_filesystem_state_fetching_dir_entries);
+
+        result = cg_storage_filesystem_db_get_dir_entries_page_by_inode(fs,
+                                                                        inode,
+                                                                        after_entry_id,
+                                                                        max_entries,
+                                                                        data);
+
+        if (result != 0)
+        {
+            CGUTILS_ERROR("Error getting children entries of inode %"PRIu64" after %"PRIu64" on fs %s: %d",
+                          inode,
+                          after_entry_id,
+                          fs->name,
+                          result);
+
+            cg_storage_fs_cb_data_free(data), data = NULL;
+        }
+    }
+    else
+    {
+        CGUTILS_ERROR("Error allocating cb data: %d", result);
+    }
+
+    return result;
+}
+
+/* Batched getattr: the entries of the given inodes, in no particular order,
+   missing inodes being simply absent. */
+int cg_storage_filesystem_dir_get_inodes_entries(cg_storage_filesystem * const fs,
+                                                 uint64_t const * const inodes,
+                                                 size_t const inodes_count,
+                                                 cg_storage_filesystem_dir_cb * const cb,
+                                                 void * const cb_data)
+{
+    int result = 0;
+    cg_storage_fs_cb_data * data = NULL;
+    CGUTILS_ASSERT(fs != NULL);
+    CGUTILS_ASSERT(inodes != NULL);
+    CGUTILS_ASSERT(inodes_count > 0);
+    CGUTILS_ASSERT(cb != NULL);
+
+    result = cg_storage_fs_cb_data_init(fs,
+                                        &data);
+
+    if (result == 0)
+    {
+        /* only used for logging by the handler */
+        cg_storage_fs_cb_data_set_inode_number(data, inodes[0]);
+
+        cg_storage_fs_cb_data_set_handler(data,
+                                          &cg_storage_filesystem_dir_get_entries_by_inode_handler);
+
+        cg_storage_fs_cb_data_set_callback(data,
+                                           cb,
+                                           cb_data);
+
+        cg_storage_fs_cb_data_set_state(data,
+                                        cg_storage_filesystem_state_fetching_dir_entries);
+
+        result = cg_storage_filesystem_db_get_inodes_info_multi(fs,
+                                                                inodes,
+                                                                inodes_count,
+                                                                data);
+
+        if (result != 0)
+        {
+            CGUTILS_ERROR("Error getting %zu inodes on fs %s: %d",
+                          inodes_count,
+                          fs->name,
+                          result);
+
+            cg_storage_fs_cb_data_free(data), data = NULL;
+        }
+    }
+    else
+    {
+        CGUTILS_ERROR("Error allocating cb data: %d", result);
+    }
+
+    return result;
+}
+
+/* Batched lookup of several children of the same directory */
+int cg_storage_filesystem_dir_get_children_entries(cg_storage_filesystem * const fs,
+                                                   uint64_t const parent,
+                                                   char const * const * const names,
+                                                   size_t const names_count,
+                                                   cg_storage_filesystem_dir_cb * const cb,
+                                                   void * const cb_data)
+{
+    int result = 0;
+    cg_storage_fs_cb_data * data = NULL;
+    CGUTILS_ASSERT(fs != NULL);
+    CGUTILS_ASSERT(parent >= 1);
+    CGUTILS_ASSERT(names != NULL);
+    CGUTILS_ASSERT(names_count > 0);
+    CGUTILS_ASSERT(cb != NULL);
+
+    result = cg_storage_fs_cb_data_init(fs,
+                                        &data);
+
+    if (result == 0)
+    {
+        cg_storage_fs_cb_data_set_inode_number(data, parent);
+
+        cg_storage_fs_cb_data_set_handler(data,
+                                          &cg_storage_filesystem_dir_get_entries_by_inode_handler);
+
+        cg_storage_fs_cb_data_set_callback(data,
+                                           cb,
+                                           cb_data);
+
+        cg_storage_fs_cb_data_set_state(data,
+                                        cg_storage_filesystem_state_fetching_dir_entries);
+
+        result = cg_storage_filesystem_db_get_children_inodes_info_multi(fs,
+                                                                         parent,
+                                                                         names,
+                                                                         names_count,
+                                                                         data);
+
+        if (result != 0)
+        {
+            CGUTILS_ERROR("Error looking up %zu children of inode %"PRIu64" on fs %s: %d",
+                          names_count,
+                          parent,
+                          fs->name,
+                          result);
+
+            cg_storage_fs_cb_data_free(data), data = NULL;
+        }
+    }
+    else
+    {
+        CGUTILS_ERROR("Error allocating cb data: %d", result);
+    }
+
+    return result;
+}
+
 static void cg_storage_filesystem_dir_mkdir_inode_handler(int const status,
                                                           cg_storage_fs_cb_data * data)
 {
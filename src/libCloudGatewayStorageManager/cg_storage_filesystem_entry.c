@@ -503,6 +503,82 @@ int cg_storage_filesystem_entry_get_object_info_by_path(cg_storage_filesystem *
     return result;
 }
 
+/* Store the inode of an object freshly fetched from the DB into the inode cache,
+   unless a mutation happened in the meantime. Dirty inodes are not cached since
+   their stats may be refreshed from the cache file. */
+static void cg_storage_filesystem_entry_cache_object(cg_storage_filesystem * const this,
+                                                     cg_storage_fs_cb_data const * const data,
+                                                     cg_storage_object * const object,
+                                                     char const * const child_name,
+                                                     uint64_t const parent_inode_number)
+{
+    uint64_t const generation = cg_storage_fs_cb_data_get_inode_cache_generation(data);
+    CGUTILS_ASSERT(this != NULL);
+
+    if (this->inode_cache != NULL &&
+        generation > 0)
+    {
+        cgdb_inode const * inode = NULL;
+
+        int result = cg_storage_object_get_inode(object,
+                                                 &inode);
+
+        if (COMPILER_LIKELY(result == 0 &&
+                            inode->dirty_writers == 0))
+        {
+            if (child_name != NULL)
+            {
+                cg_storage_inode_cache_add_child(this->inode_cache,
+                                                 generation,
+                                                 parent_inode_number,
+                                                 child_name,
+                                                 inode);
+            }
+            else
+            {
+                cg_storage_inode_cache_add(this->inode_cache,
+                                           generation,
+                                           inode);
+            }
+        }
+    }
+}
+
+static int cg_storage_filesystem_entry_return_cached_inode(cg_storage_filesystem * const this,
+                                                           cgdb_inode const * const inode,
+                                                           cg_storage_fs_cb_data * const data)
+{
+    cg_storage_object * object = NULL;
+    CGUTILS_ASSERT(this != NULL);
+    CGUTILS_ASSERT(inode != NULL);
+    CGUTILS_ASSERT(data != NULL);
+
+    int result = cg_storage_object_init_from_inode(this,
+                                                   inode,
+                                                   NULL,
+                                                   cg_storage_object_mode_to_type(inode->st.st_mode),
+                                                   &object);
+
+    if (COMPILER_LIKELY(result == 0))
+    {
+        cg_storage_fs_cb_data_set_object(data, object);
+        object = NULL;
+        /* do not put it back into the cache */
+        cg_storage_fs_cb_data_set_inode_cache_generation(data, 0);
+
+        cg_storage_filesystem_return_to_handler(0, data);
+    }
+    else
+    {
+        CGUTILS_ERROR("Error getting object from cached inode %"PRIu64" on fs %s: %d",
+                      inode->inode_number,
+                      this->name,
+                      result);
+    }
+
+    return result;
+}
+
 static void cg_storage_filesystem_entry_get_object_by_inode_handler(int const status,
                                                                     cg_storage_fs_cb_data * data)
 {
@@ -522,6 +598,12 @@ static void cg_storage_filesystem_entry_get_object_by_inode_handler(int const st
         {
             cgdb_entry * entry = NULL;
 
+            cg_storage_filesystem_entry_cache_object(this,
+                                                     data,
+                                                     object,
+                                                     NULL,
+                                                     0);
+
             result = cg_storage_object_get_entry(object,
                                                  &entry);
 
@@ -603,6 +685,12 @@ static void cg_storage_filesystem_entry_get_root_object_handler(int const status
     {
         if (COMPILER_LIKELY(result == 0))
         {
+            cg_storage_filesystem_entry_cache_object(this,
+                                                     data,
+                                                     object,
+                                                     NULL,
+                                                     0);
+
             /* Phew, that was easy. */
             cg_storage_filesystem_entry_object_cb * cb = cg_storage_fs_cb_data_get_callback(data);
             CGUTILS_ASSERT(cb != NULL);
@@ -667,8 +755,21 @@ int cg_storage_filesystem_entry_get_object_by_inode(cg_storage_filesystem * cons
                                         cg_storage_filesystem_state_fetching_entry);
 
 
-        /* First, we fetch the corresponding entry. */
-        if (COMPILER_UNLIKELY(inode == 1))
+        cgdb_inode const * cached_inode = NULL;
+
+        /* First, we fetch the corresponding entry, from the inode cache if possible. */
+        if (cg_storage_inode_cache_get(this->inode_cache,
+                                       inode,
+                                       &cached_inode) == 0)
+        {
+            cg_storage_fs_cb_data_set_handler(data,
+                                              &cg_storage_filesystem_entry_get_object_by_inode_handler);
+
+            result = cg_storage_filesystem_entry_return_cached_inode(this,
+                                                                     cached_inode,
+                                                                     data);
+        }
+        else if (COMPILER_UNLIKELY(inode == 1))
         {
             cg_storage_object * object = NULL;
             /* See mkfs for the defaults perms */
@@ -755,6 +856,12 @@ static void cg_storage_filesystem_entry_get_child_handler(int const status,
         {
             cgdb_entry * entry = NULL;
 
+            cg_storage_filesystem_entry_cache_object(this,
+                                                     data,
+                                                     object,
+                                                     child_name,
+                                                     parent_inode_number);
+
             result = cg_storage_object_get_entry(object,
                                                  &entry);
 
@@ -855,10 +962,27 @@ int cg_storage_filesystem_entry_get_child(cg_storage_filesystem * const this,
             cg_storage_fs_cb_data_set_handler(data,
                                               &cg_storage_filesystem_entry_get_child_handler);
 
-            result = cg_storage_filesystem_db_get_child_inode_info(this,
-                                                                   parent_inode,
-                                                                   name,
-                                                                   data);
+            cgdb_inode const * cached_inode = NULL;
+
+            if (cg_storage_inode_cache_get_child(this->inode_cache,
+                                                 parent_inode,
+                                                 name,
+                                                 &cached_inode) == 0)
+            {
+                result = cg_storage_filesystem_entry_return_cached_inode(this,
+                                                                         cached_inode,
+                                                                         data);
+            }
+            else
+            {
+                cg_storage_fs_cb_data_set_inode_cache_generation(data,
+                                                                 cg_storage_inode_cache_get_generation(this->inode_cache));
+
+                result = cg_storage_filesystem_db_get_child_inode_info(this,
+                                                                       parent_inode,
+                                                                       name,
+                                                                       data);
+            }
 
             if (COMPILER_UNLIKELY(result != 0))
             {
@@ -37,6 +37,75 @@
 #include <cgsm/cg_storage_filesystem_transfer_queue.h>
 #include <cgsm/cg_storage_filesystem_utils.h>
 
+static int cg_storage_filesystem_file_add_related_inode_instances(cg_storage_filesystem * const fs,
+                                                                  char const * const path,
+                                                                  uint64_t const parent,
+                                                                  cg_storage_object * const object,
+                                                                  uint64_t const * const instances_ids,
+                                                                  char const * const * const ids_in_instance,
+                                                                  size_t const instances_count,
+                                                                  cg_storage_fs_cb_data * const data)
+{
+    int result = 0;
+    CGUTILS_ASSERT(fs != NULL);
+    CGUTILS_ASSERT(object != NULL);
+    CGUTILS_ASSERT(instances_ids != NULL);
+    CGUTILS_ASSERT(ids_in_instance != NULL);
+    CGUTILS_ASSERT(data != NULL);
+
+    /* All the inode instances in a single DB request */
+    cg_storage_fs_cb_data_inc_references(data);
+
+    result = cg_storage_filesystem_db_add_inode_instances(fs,
+                                                          cg_storage_object_get_inode_number(object),
+                                                          instances_ids,
+                                                          ids_in_instance,
+                                                          instances_count,
+                                                          cg_storage_instance_status_dirty,
+                                                          data);
+
+    if (result != 0)
+    {
+        cg_storage_fs_cb_data_dec_references(data);
+    }
+
+    if (result == ENOSYS)
+    {
+        /* The DB backend does not support batches, one request per instance */
+        result = 0;
+
+        for (size_t idx = 0;
+             result == 0 &&
+                 idx < instances_count;
+             idx++)
+        {
+            cg_storage_fs_cb_data_inc_references(data);
+
+            result = cg_storage_filesystem_db_add_inode_instance(fs,
+                                                                 instances_ids[idx],
+                                                                 cg_storage_object_get_inode_number(object),
+                                                                 ids_in_instance[idx],
+                                                                 cg_storage_instance_status_dirty,
+                                                                 data);
+            if (result != 0)
+            {
+                cg_storage_fs_cb_data_dec_references(data);
+            }
+        }
+    }
+
+    if (result != 0)
+    {
+        CGUTILS_ERROR("Error adding inode instances of entry %s of parent inode %"PRIu64", fs %s: %d",
+                      path,
+                      parent,
+                      fs->name,
+                      result);
+    }
+
+    return result;
+}
+
 static int cg_storage_filesystem_file_create_related_inode_instances(cg_storage_filesystem * const fs,
                                                                      char const * const path,
                                                                      uint64_t const parent,
@@ -56,75 +125,100 @@ static int cg_storage_filesystem_file_create_related_inode_instances(cg_storage_
     if (result == 0)
     {
         CGUTILS_ASSERT(instances_to_up != NULL);
+        size_t const instances_count = cgutils_llist_get_count(instances_to_up);
 
-        for (cgutils_llist_elt * elt = cgutils_llist_get_iterator(instances_to_up);
-             result == 0 &&
-                 elt != NULL;
-             elt = cgutils_llist_elt_get_next(elt))
+        if (instances_count > 0)
         {
-            cg_storage_instance * const instance = cgutils_llist_elt_get_object(elt);
-            char * object_id = NULL;
-
-            CGUTILS_ASSERT(instance != NULL);
+            uint64_t * instances_ids = NULL;
+            char ** ids_in_instance = NULL;
+            size_t ids_count = 0;
 
-            result = cgutils_asprintf(&object_id,
-                                      "%"PRIu64"-%"PRIu64,
-                                      fs->id,
-                                      cg_storage_fs_cb_data_get_returning_id(data));
+            CGUTILS_MALLOC(instances_ids, instances_count, sizeof *instances_ids);
+            CGUTILS_MALLOC(ids_in_instance, instances_count, sizeof *ids_in_instance);
 
-
-            if (result == 0)
+            if (instances_ids != NULL &&
+                ids_in_instance != NULL)
             {
-                char * id_in_instance = NULL;
+                char * object_id = NULL;
 
-                result = cg_storage_instance_get_object_id(instance,
-                                                           object_id,
-                                                           &id_in_instance);
+                result = cgutils_asprintf(&object_id,
+                                          "%"PRIu64"-%"PRIu64,
+                                          fs->id,
+                                          cg_storage_fs_cb_data_get_returning_id(data));
 
                 if (result == 0)
                 {
-                    cg_storage_fs_cb_data_inc_references(data);
-
-                    result = cg_storage_filesystem_db_add_inode_instance(fs,
-                                                                         cg_storage_instance_get_id(instance),
-                                                                         cg_storage_object_get_inode_number(object),
-                                                                         id_in_instance,
-                                                                         cg_storage_instance_status_dirty,
-                                                                         data);
-                    if (result != 0)
+                    for (cgutils_llist_elt * elt = cgutils_llist_get_iterator(instances_to_up);
+                         result == 0 &&
+                             elt != NULL;
+                         elt = cgutils_llist_elt_get_next(elt))
                     {
-                        cg_storage_fs_cb_data_dec_references(data);
+                        cg_storage_instance * const instance = cgutils_llist_elt_get_object(elt);
+                        CGUTILS_ASSERT(instance != NULL);
+                        CGUTILS_ASSERT(ids_count < instances_count);
 
-                        CGUTILS_ERROR("Error adding inode instance entry %s of parent inode %"PRIu64", fs %s, instance %s: %d",
-                                      path,
-                                      parent,
-                                      fs->name,
-                                      cg_storage_instance_get_name(instance),
-                                      result);
+                        result = cg_storage_instance_get_object_id(instance,
+                                                                   object_id,
+                                                                   &(ids_in_instance[ids_count]));
+
+                        if (result == 0)
+                        {
+                            instances_ids[ids_count] = cg_storage_instance_get_id(instance);
+                            ids_count++;
+                        }
+                        else
+                        {
+                            CGUTILS_ERROR("Error getting an id for entry %s of parent %"PRIu64", fs %s, instance %s: %d",
+                                          path,
+                                          parent,
+                                          fs->name,
+                                          cg_storage_instance_get_name(instance),
+                                          result);
+                        }
                     }
 
-                    CGUTILS_FREE(id_in_instance);
+                    if (result == 0)
+                    {
+                        result = cg_storage_filesystem_file_add_related_inode_instances(fs,
+                                                                                       path,
+                                                                                       parent,
+                                                                                       object,
+                                                                                       instances_ids,
+                                                                                       (char const * const *) ids_in_instance,
+                                                                                       ids_count,
+                                                                                       data);
+                    }
+
+                    CGUTILS_FREE(object_id);
                 }
                 else
                 {
-                    CGUTILS_ERROR("Error getting an id for entry %s of parent %"PRIu64", fs %s, instance %s: %d",
+                    CGUTILS_ERROR("Error getting an object id for entry %s of parent %"PRIu64", fs %s: %d",
                                   path,
                                   parent,
                                   fs->name,
-                                  cg_storage_instance_get_name(instance),
                                   result);
                 }
 
-                CGUTILS_FREE(object_id);
+                for (size_t idx = 0;
+                     idx < ids_count;
+                     idx++)
+                {
+                    CGUTILS_FREE(ids_in_instance[idx]);
+                }
             }
             else
             {
-                CGUTILS_ERROR("Error getting an object id for entry %s of parent %"PRIu64", fs %s: %d",
+                result = ENOMEM;
+                CGUTILS_ERROR("Error allocating inode instances for entry %s of parent %"PRIu64", fs %s: %d",
                               path,
                               parent,
                               fs->name,
                               result);
             }
+
+            CGUTILS_FREE(ids_in_instance);
+            CGUTILS_FREE(instances_ids);
         }
 
         cgutils_llist_free(&instances_to_up, NULL);
@@ -635,6 +729,65 @@ int cg_storage_filesystem_file_inode_notify_write(cg_storage_filesystem * const
     return result;
 }
 
+int cg_storage_filesystem_file_inodes_notify_write_multi(cg_storage_filesystem * const fs,
+                                                        uint64_t const * const inodes,
+                                                        size_t const inodes_count,
+                                                        cg_storage_filesystem_status_cb * const cb,
+                                                        void * const cb_data)
+{
+    int result = 0;
+    cg_storage_fs_cb_data * data = NULL;
+    CGUTILS_ASSERT(fs != NULL);
+    CGUTILS_ASSERT(inodes != NULL);
+    CGUTILS_ASSERT(inodes_count > 0);
+
+    result = cg_storage_fs_cb_data_init(fs,
+                                        &data);
+
+    if (COMPILER_LIKELY(result == 0))
+    {
+        time_t const now = time(NULL);
+
+        /* only used for logging */
+        cg_storage_fs_cb_data_set_inode_number(data,
+                                               inodes[0]);
+
+        cg_storage_fs_cb_data_set_handler(data,
+                                          &cg_storage_filesystem_file_inode_notify_write_handler);
+
+        cg_storage_fs_cb_data_set_state(data,
+                                        cg_storage_filesystem_state_setting_dirty);
+
+        cg_storage_fs_cb_data_set_callback(data,
+                                           cb,
+                                           cb_data);
+
+        result = cg_storage_filesystem_db_set_inodes_dirty_multi(fs,
+                                                                 inodes,
+                                                                 inodes_count,
+                                                                 now,
+                                                                 now,
+                                                                 now,
+                                                                 data);
+
+        if (COMPILER_UNLIKELY(result != 0))
+        {
+            CGUTILS_ERROR("Error setting %zu inodes of fs %s dirty: %d",
+                          inodes_count,
+                          fs->name,
+                          result);
+
+            cg_storage_fs_cb_data_free(data), data = NULL;
+        }
+    }
+    else
+    {
+        CGUTILS_ERROR("Error allocating cb data: %d", result);
+    }
+
+    return result;
+}
+
 static int cg_storage_filesystem_file_get_path_in_cache_transfer_cb(int const status,
                                                                     cg_storage_instance_infos * const infos,
                                                                     void * cb_data);
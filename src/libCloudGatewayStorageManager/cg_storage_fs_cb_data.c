@@ -78,6 +78,9 @@ struct cg_storage_fs_cb_data
     uint64_t inode_number;
     uint64_t parent_inode_number;
 
+    /* Inode cache generation observed before a DB lookup, 0 if the result should not be cached */
+    uint64_t inode_cache_generation;
+
     /* State */
     cg_storage_filesystem_handler_state state;
 
@@ -333,6 +336,13 @@ void cg_storage_fs_cb_data_set_parent_inode_number(cg_storage_fs_cb_data * const
     this->parent_inode_number = inode_number;
 }
 
+void cg_storage_fs_cb_data_set_inode_cache_generation(cg_storage_fs_cb_data * const this,
+                                                      uint64_t const generation)
+{
+    CGUTILS_ASSERT(this != NULL);
+    this->inode_cache_generation = generation;
+}
+
 void cg_storage_fs_cb_data_set_flags(cg_storage_fs_cb_data * const this,
                                      int const flags)
 {
@@ -490,6 +500,13 @@ uint64_t cg_storage_fs_cb_data_get_parent_inode_number(cg_storage_fs_cb_data con
     return this->parent_inode_number;
 }
 
+uint64_t cg_storage_fs_cb_data_get_inode_cache_generation(cg_storage_fs_cb_data const * const this)
+{
+    CGUTILS_ASSERT(this != NULL);
+
+    return this->inode_cache_generation;
+}
+
 int cg_storage_fs_cb_data_get_fd(cg_storage_fs_cb_data const * const this)
 {
     CGUTILS_ASSERT(this != NULL);
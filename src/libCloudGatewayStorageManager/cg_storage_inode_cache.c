@@ -0,0 +1,585 @@
+/*
+ * This file is part of Nuage Labs SAS's Cloud Gateway.
+ *
+ * Copyright (C) 2011-2017  Nuage Labs SAS
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * In addition, for the avoidance of any doubt, permission is granted to
+ * link this program with OpenSSL and to (re)distribute the binaries
+ * produced as the result of such linking.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <cgsm/cg_storage_inode_cache.h>
+
+#include <cloudutils/cloudutils.h>
+#include <cloudutils/cloudutils_htable.h>
+
+/* "<parent inode number>/<name>" */
+#define CG_STORAGE_INODE_CACHE_KEY_SIZE (sizeof "18446744073709551615/" + NAME_MAX)
+
+typedef struct cg_storage_inode_cache_entry cg_storage_inode_cache_entry;
+
+struct cg_storage_inode_cache_entry
+{
+    /* LRU list, most recently used first */
+    cg_storage_inode_cache_entry * previous;
+    cg_storage_inode_cache_entry * next;
+    char * key;
+    /* inode entries only */
+    cgdb_inode inode;
+    /* child entries only, the inode this entry points to */
+    uint64_t child_inode_number;
+    /* monotonic, in ms */
+    uint64_t expires;
+    bool child;
+};
+
+struct cg_storage_inode_cache
+{
+    /* inode number => cg_storage_inode_cache_entry * */
+    cgutils_htable * inodes;
+    /* parent inode number/name => cg_storage_inode_cache_entry * */
+    cgutils_htable * children;
+    cg_storage_inode_cache_entry * most_recent;
+    cg_storage_inode_cache_entry * least_recent;
+    cg_storage_inode_cache_stats stats;
+    size_t entries_count;
+    size_t max_entries;
+    size_t mutations_in_flight;
+    uint64_t ttl;
+    uint64_t generation;
+};
+
+static uint64_t cg_storage_inode_cache_now(void)
+{
+    struct timespec ts = { 0 };
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint64_t) ts.tv_sec * 1000) + ((uint64_t) ts.tv_nsec / (1000 * 1000));
+}
+
+static void cg_storage_inode_cache_entry_free(cg_storage_inode_cache_entry * entry)
+{
+    if (entry != NULL)
+    {
+        CGUTILS_FREE(entry->inode.digest);
+        CGUTILS_FREE(entry->key);
+        CGUTILS_FREE(entry);
+    }
+}
+
+static void cg_storage_inode_cache_unlink(cg_storage_inode_cache * const this,
+                                          cg_storage_inode_cache_entry * const entry)
+{
+    CGUTILS_ASSERT(this != NULL);
+    CGUTILS_ASSERT(entry != NULL);
+
+    if (entry->previous != NULL)
+    {
+        entry->previous->next = entry->next;
+    }
+    else
+    {
+        this->most_recent = entry->next;
+    }
+
+    if (entry->next != NULL)
+    {
+        entry->next->previous = entry->previous;
+    }
+    else
+    {
+        this->least_recent = entry->previous;
+    }
+
+    entry->previous = NULL;
+    entry->next = NULL;
+}
+
+static void cg_storage_inode_cache_push_front(cg_storage_inode_cache * const this,
+                                              cg_storage_inode_cache_entry * const entry)
+{
+    CGUTILS_ASSERT(this != NULL);
+    CGUTILS_ASSERT(entry != NULL);
+
+    entry->previous = NULL;
+    entry->next = this->most_recent;
+
+    if (this->most_recent != NULL)
+    {
+        this->most_recent->previous = entry;
+    }
+    else
+    {
+        this->least_recent = entry;
+    }
+
+    this->most_recent = entry;
+}
+
+static void cg_storage_inode_cache_remove(cg_storage_inode_cache * const this,
+                                          cg_storage_inode_cache_entry * entry)
+{
+    CGUTILS_ASSERT(this != NULL);
+    CGUTILS_ASSERT(entry != NULL);
+    CGUTILS_ASSERT(this->entries_count > 0);
+
+    int const result = cgutils_htable_remove(entry->child == true ? this->children : this->inodes,
+                                             entry->key);
+    CGUTILS_ASSERT(result == 0);
+    (void) result;
+
+    cg_storage_inode_cache_unlink(this, entry);
+    this->entries_count--;
+
+    cg_storage_inode_cache_entry_free(entry), entry = NULL;
+}
+
+/* Returns NULL if the key is not present or has expired. */
+static cg_storage_inode_cache_entry * cg_storage_inode_cache_lookup(cg_storage_inode_cache * const this,
+                                                                    cgutils_htable * const table,
+                                                                    char const * const key,
+                                                                    uint64_t const now)
+{
+    void * value = NULL;
+    cg_storage_inode_cache_entry * result = NULL;
+    CGUTILS_ASSERT(this != NULL);
+    CGUTILS_ASSERT(table != NULL);
+    CGUTILS_ASSERT(key != NULL);
+
+    if (cgutils_htable_get(table, key, &value) == 0)
+    {
+        result = value;
+        CGUTILS_ASSERT(result != NULL);
+
+        if (result->expires <= now)
+        {
+            cg_storage_inode_cache_remove(this, result), result = NULL;
+        }
+    }
+
+    return result;
+}
+
+static int cg_storage_inode_cache_insert(cg_storage_inode_cache * const this,
+                                         bool const child,
+                                         char const * const key,
+                                         cg_storage_inode_cache_entry ** const out)
+{
+    int result = 0;
+    void * value = NULL;
+    cgutils_htable * const table = child == true ? this->children : this->inodes;
+    CGUTILS_ASSERT(this != NULL);
+    CGUTILS_ASSERT(key != NULL);
+    CGUTILS_ASSERT(out != NULL);
+
+    if (cgutils_htable_get(table, key, &value) == 0)
+    {
+        *out = value;
+        CGUTILS_ASSERT(*out != NULL);
+
+        cg_storage_inode_cache_unlink(this, *out);
+        CGUTILS_FREE((*out)->inode.digest);
+    }
+    else
+    {
+        if (this->entries_count >= this->max_entries)
+        {
+            CGUTILS_ASSERT(this->least_recent != NULL);
+            cg_storage_inode_cache_remove(this, this->least_recent);
+            this->stats.evictions++;
+        }
+
+        CGUTILS_ALLOCATE_STRUCT(*out);
+
+        if (COMPILER_LIKELY(*out != NULL))
+        {
+            (*out)->child = child;
+            (*out)->key = cgutils_strdup(key);
+
+            if (COMPILER_LIKELY((*out)->key != NULL))
+            {
+                result = cgutils_htable_insert(table,
+                                               (*out)->key,
+                                               *out);
+            }
+            else
+            {
+                result = ENOMEM;
+            }
+
+            if (COMPILER_LIKELY(result == 0))
+            {
+                this->entries_count++;
+            }
+            else
+            {
+                cg_storage_inode_cache_entry_free(*out), *out = NULL;
+            }
+        }
+        else
+        {
+            result = ENOMEM;
+        }
+    }
+
+    if (COMPILER_LIKELY(result == 0))
+    {
+        (*out)->expires = cg_storage_inode_cache_now() + this->ttl;
+        cg_storage_inode_cache_push_front(this, *out);
+        this->stats.insertions++;
+    }
+
+    return result;
+}
+
+int cg_storage_inode_cache_init(size_t const max_entries,
+                                uint64_t const ttl_ms,
+                                cg_storage_inode_cache ** const out)
+{
+    int result = EINVAL;
+
+    if (max_entries > 0 &&
+        out != NULL)
+    {
+        CGUTILS_ALLOCATE_STRUCT(*out);
+
+        if (*out != NULL)
+        {
+            (*out)->max_entries = max_entries;
+            (*out)->ttl = ttl_ms;
+            (*out)->generation = 1;
+
+            result = cgutils_htable_create(&((*out)->inodes),
+                                           max_entries);
+
+            if (result == 0)
+            {
+                result = cgutils_htable_create(&((*out)->children),
+                                               max_entries);
+            }
+
+            if (result != 0)
+            {
+                CGUTILS_ERROR("Error creating inode cache tables: %d", result);
+                cg_storage_inode_cache_free(*out), *out = NULL;
+            }
+        }
+        else
+        {
+            result = ENOMEM;
+        }
+    }
+
+    return result;
+}
+
+void cg_storage_inode_cache_free(cg_storage_inode_cache * this)
+{
+    if (this != NULL)
+    {
+        cg_storage_inode_cache_entry * entry = this->most_recent;
+
+        while (entry != NULL)
+        {
+            cg_storage_inode_cache_entry * next = entry->next;
+            cg_storage_inode_cache_entry_free(entry);
+            entry = next;
+        }
+
+        this->most_recent = NULL;
+        this->least_recent = NULL;
+
+        cgutils_htable_free(&(this->inodes), NULL);
+        cgutils_htable_free(&(this->children), NULL);
+
+        CGUTILS_FREE(this);
+    }
+}
+
+int cg_storage_inode_cache_get(cg_storage_inode_cache * const this,
+                               uint64_t const inode_number,
+                               cgdb_inode const ** const inode)
+{
+    int result = ENOENT;
+    CGUTILS_ASSERT(inode != NULL);
+
+    if (this != NULL)
+    {
+        char key[CG_STORAGE_INODE_CACHE_KEY_SIZE];
+        snprintf(key, sizeof key, "%"PRIu64, inode_number);
+
+        cg_storage_inode_cache_entry * const entry = cg_storage_inode_cache_lookup(this,
+                                                                                   this->inodes,
+                                                                                   key,
+                                                                                   cg_storage_inode_cache_now());
+
+        if (entry != NULL)
+        {
+            cg_storage_inode_cache_unlink(this, entry);
+            cg_storage_inode_cache_push_front(this, entry);
+
+            *inode = &(entry->inode);
+            result = 0;
+            this->stats.hits++;
+        }
+        else
+        {
+            this->stats.misses++;
+        }
+    }
+
+    return result;
+}
+
+int cg_storage_inode_cache_get_child(cg_storage_inode_cache * const this,
+                                     uint64_t const parent_inode_number,
+                                     char const * const name,
+                                     cgdb_inode const ** const inode)
+{
+    int result = ENOENT;
+    CGUTILS_ASSERT(name != NULL);
+    CGUTILS_ASSERT(inode != NULL);
+
+    if (this != NULL)
+    {
+        char key[CG_STORAGE_INODE_CACHE_KEY_SIZE];
+        int const written = snprintf(key, sizeof key, "%"PRIu64"/%s", parent_inode_number, name);
+        uint64_t const now = cg_storage_inode_cache_now();
+
+        if (COMPILER_LIKELY(written > 0 &&
+                            (size_t) written < sizeof key))
+        {
+            cg_storage_inode_cache_entry * const entry = cg_storage_inode_cache_lookup(this,
+                                                                                       this->children,
+                                                                                       key,
+                                                                                       now);
+
+            if (entry != NULL)
+            {
+                snprintf(key, sizeof key, "%"PRIu64, entry->child_inode_number);
+
+                cg_storage_inode_cache_entry * const inode_entry = cg_storage_inode_cache_lookup(this,
+                                                                                                 this->inodes,
+                                                                                                 key,
+                                                                                                 now);
+
+                if (inode_entry != NULL)
+                {
+                    cg_storage_inode_cache_unlink(this, entry);
+                    cg_storage_inode_cache_push_front(this, entry);
+                    cg_storage_inode_cache_unlink(this, inode_entry);
+                    cg_storage_inode_cache_push_front(this, inode_entry);
+
+                    *inode = &(inode_entry->inode);
+                    result = 0;
+                }
+            }
+        }
+
+        if (result == 0)
+        {
+            this->stats.hits++;
+        }
+        else
+        {
+            this->stats.misses++;
+        }
+    }
+
+    return result;
+}
+
+uint64_t cg_storage_inode_cache_get_generation(cg_storage_inode_cache const * const this)
+{
+    uint64_t result = 0;
+
+    if (this != NULL)
+    {
+        result = this->generation;
+    }
+
+    return result;
+}
+
+static bool cg_storage_inode_cache_can_add(cg_storage_inode_cache const * const this,
+                                           uint64_t const generation)
+{
+    return this != NULL &&
+        this->mutations_in_flight == 0 &&
+        this->generation == generation;
+}
+
+void cg_storage_inode_cache_add(cg_storage_inode_cache * const this,
+                                uint64_t const generation,
+                                cgdb_inode const * const inode)
+{
+    CGUTILS_ASSERT(inode != NULL);
+
+    if (cg_storage_inode_cache_can_add(this, generation) == true)
+    {
+        char key[CG_STORAGE_INODE_CACHE_KEY_SIZE];
+        cg_storage_inode_cache_entry * entry = NULL;
+
+        snprintf(key, sizeof key, "%"PRIu64, inode->inode_number);
+
+        int result = cg_storage_inode_cache_insert(this,
+                                                   false,
+                                                   key,
+                                                   &entry);
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            entry->inode = *inode;
+
+            if (inode->digest != NULL)
+            {
+                entry->inode.digest = cgutils_strdup(inode->digest);
+
+                if (COMPILER_UNLIKELY(entry->inode.digest == NULL))
+                {
+                    cg_storage_inode_cache_remove(this, entry), entry = NULL;
+                }
+            }
+        }
+    }
+}
+
+void cg_storage_inode_cache_add_child(cg_storage_inode_cache * const this,
+                                      uint64_t const generation,
+                                      uint64_t const parent_inode_number,
+                                      char const * const name,
+                                      cgdb_inode const * const inode)
+{
+    CGUTILS_ASSERT(name != NULL);
+    CGUTILS_ASSERT(inode != NULL);
+
+    if (cg_storage_inode_cache_can_add(this, generation) == true)
+    {
+        char key[CG_STORAGE_INODE_CACHE_KEY_SIZE];
+        int const written = snprintf(key, sizeof key, "%"PRIu64"/%s", parent_inode_number, name);
+
+        if (COMPILER_LIKELY(written > 0 &&
+                            (size_t) written < sizeof key))
+        {
+            cg_storage_inode_cache_entry * entry = NULL;
+
+            int result = cg_storage_inode_cache_insert(this,
+                                                       true,
+                                                       key,
+                                                       &entry);
+
+            if (COMPILER_LIKELY(result == 0))
+            {
+                entry->child_inode_number = inode->inode_number;
+
+                cg_storage_inode_cache_add(this,
+                                           generation,
+                                           inode);
+            }
+        }
+    }
+}
+
+void cg_storage_inode_cache_invalidate(cg_storage_inode_cache * const this,
+                                       uint64_t const inode_number)
+{
+    if (this != NULL)
+    {
+        char key[CG_STORAGE_INODE_CACHE_KEY_SIZE];
+        void * value = NULL;
+
+        this->generation++;
+
+        snprintf(key, sizeof key, "%"PRIu64, inode_number);
+
+        if (cgutils_htable_get(this->inodes, key, &value) == 0)
+        {
+            cg_storage_inode_cache_remove(this, value);
+            this->stats.invalidations++;
+        }
+    }
+}
+
+void cg_storage_inode_cache_invalidate_child(cg_storage_inode_cache * const this,
+                                             uint64_t const parent_inode_number,
+                                             char const * const name)
+{
+    CGUTILS_ASSERT(name != NULL);
+
+    if (this != NULL)
+    {
+        char key[CG_STORAGE_INODE_CACHE_KEY_SIZE];
+        void * value = NULL;
+        int const written = snprintf(key, sizeof key, "%"PRIu64"/%s", parent_inode_number, name);
+
+        this->generation++;
+
+        if (COMPILER_LIKELY(written > 0 &&
+                            (size_t) written < sizeof key) &&
+            cgutils_htable_get(this->children, key, &value) == 0)
+        {
+            cg_storage_inode_cache_entry * entry = value;
+            uint64_t const child_inode_number = entry->child_inode_number;
+
+            cg_storage_inode_cache_remove(this, entry), entry = NULL;
+            this->stats.invalidations++;
+
+            cg_storage_inode_cache_invalidate(this, child_inode_number);
+        }
+    }
+}
+
+void cg_storage_inode_cache_mutation_begin(cg_storage_inode_cache * const this)
+{
+    if (this != NULL)
+    {
+        this->mutations_in_flight++;
+        this->generation++;
+    }
+}
+
+void cg_storage_inode_cache_mutation_end(cg_storage_inode_cache * const this)
+{
+    if (this != NULL)
+    {
+        CGUTILS_ASSERT(this->mutations_in_flight > 0);
+        this->mutations_in_flight--;
+        this->generation++;
+    }
+}
+
+void cg_storage_inode_cache_get_stats(cg_storage_inode_cache const * const this,
+                                      cg_storage_inode_cache_stats * const stats)
+{
+    CGUTILS_ASSERT(stats != NULL);
+
+    if (this != NULL)
+    {
+        *stats = this->stats;
+    }
+    else
+    {
+        *stats = (cg_storage_inode_cache_stats) { 0 };
+    }
+}
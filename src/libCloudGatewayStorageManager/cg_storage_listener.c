@@ -67,6 +67,12 @@ static void cg_storage_listener_connection_cb(int sock,
         {
             (*(this->cb))(this->data, this, connection_fd, this->cb_data);
         }
+        else if (result == EAGAIN ||
+                 result == EWOULDBLOCK)
+        {
+            /* The listening socket may be shared by several processes,
+               another one got this connection first. */
+        }
         else
         {
             CGUTILS_ERROR("Error accepting connection: %d", result);
@@ -164,8 +170,8 @@ int cg_storage_listener_init(cg_storage_manager_data * const data,
                             result = cgutils_network_listen_on_socket(binding,
                                                                       /* no deferred accept on UNIX socket */
                                                                       0,
-                                                                      true,
                                                                       (*out)->backlog,
+                                                                      true,
                                                                       &((*out)->sock));
 
                             if (result == 0)
@@ -66,10 +66,12 @@ struct cg_storage_manager_data
     size_t cleaner_delay;
     size_t cleaner_db_slots;
     size_t syncer_delay;
+    size_t syncer_safety_net_delay;
     size_t syncer_dirtyness_delay;
     size_t syncer_db_slots;
     size_t syncer_max_db_objects_per_call;
     size_t cgsm_max_requests_per_connection;
+    size_t server_workers;
     size_t checker_delay;
     bool syncer_dump_http_states;
     bool daemonize;
@@ -1316,6 +1318,18 @@ size_t cg_storage_manager_data_get_syncer_delay(cg_storage_manager_data const *
     return result;
 }
 
+size_t cg_storage_manager_data_get_syncer_safety_net_delay(cg_storage_manager_data const * const this)
+{
+    size_t result = 0;
+
+    if (this != NULL)
+    {
+        result = this->syncer_safety_net_delay;
+    }
+
+    return result;
+}
+
 size_t cg_storage_manager_data_get_syncer_dirtyness_delay(cg_storage_manager_data const * const this)
 {
     size_t result = 0;
@@ -1400,6 +1414,18 @@ size_t cg_storage_manager_data_get_max_requests_per_connection(cg_storage_manage
     return result;
 }
 
+size_t cg_storage_manager_data_get_server_workers(cg_storage_manager_data const * const this)
+{
+    size_t result = 0;
+
+    if (this != NULL)
+    {
+        result = this->server_workers;
+    }
+
+    return result;
+}
+
 cgutils_http_global_params const * cg_storage_manager_data_get_http_global_params(cg_storage_manager_data const * const data)
 {
     cgutils_http_global_params const * result = NULL;
@@ -22,11 +22,13 @@
  */
 #include <assert.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <inttypes.h>
 #include <string.h>
 
 #include <cloudutils/cloudutils_compiler_specifics.h>
 #include <cloudutils/cloudutils_configuration.h>
+#include <cloudutils/cloudutils_file.h>
 
 #include <cgsm/cg_storage_request.h>
 #include <cgsm/cg_storage_connection_internals.h>
@@ -35,6 +37,13 @@
 
 typedef int (cg_storage_request_obj_cb)(int status, cg_storage_request * request);
 
+/* Maximum number of entries returned by a single readdir_page request */
+#define CG_STORAGE_REQUEST_READDIR_PAGE_SIZE_MAX (4096)
+/* Maximum number of keys of a single _multi request */
+#define CG_STORAGE_REQUEST_BATCH_SIZE_MAX (256)
+/* Large enough for the names, stat and small objects of most requests */
+#define CG_STORAGE_REQUEST_ARENA_BLOCK_SIZE (4096)
+
 typedef struct
 {
     void * obj;
@@ -44,6 +53,35 @@ typedef struct
     bool is_string;
 } cg_storage_request_obj;
 
+/* Memory released when the request is cleaned, do not free it. */
+static void * cg_storage_request_alloc(cg_storage_request * const request,
+                                       size_t const count,
+                                       size_t const size)
+{
+    void * result = NULL;
+    CGUTILS_ASSERT(request != NULL);
+
+    if (COMPILER_UNLIKELY(request->arena == NULL))
+    {
+        int res = cgutils_arena_init(CG_STORAGE_REQUEST_ARENA_BLOCK_SIZE,
+                                     &(request->arena));
+
+        if (COMPILER_UNLIKELY(res != 0))
+        {
+            CGUTILS_ERROR("Error creating request arena: %d", res);
+        }
+    }
+
+    if (COMPILER_LIKELY(request->arena != NULL))
+    {
+        result = cgutils_arena_calloc(request->arena,
+                                      count,
+                                      size);
+    }
+
+    return result;
+}
+
 static int cg_storage_request_code_sent(cgutils_event_data * const data,
                                          int const status,
                                          int const fd,
@@ -161,8 +199,6 @@ static int cg_storage_request_read_object_done(cgutils_event_data * data,
         cg_storage_connection_finish(this->request->conn), this = NULL;
     }
 
-    CGUTILS_FREE(this);
-
     return result;
 }
 
@@ -184,11 +220,9 @@ static int cg_storage_request_got_object_size_cb(cgutils_event_data * data,
 
     if (COMPILER_LIKELY(result == 0))
     {
-        void * object = NULL;
-
-        CGUTILS_MALLOC(object,
-                       *(this->obj_size) + (size_t)(this->is_string ? 1 : 0),
-                       1);
+        void * object = cg_storage_request_alloc(this->request,
+                                                 *(this->obj_size) + (size_t)(this->is_string ? 1 : 0),
+                                                 1);
 
         if (COMPILER_LIKELY(object != NULL))
         {
@@ -209,7 +243,7 @@ static int cg_storage_request_got_object_size_cb(cgutils_event_data * data,
                               *(this->obj_size),
                               result);
                 this->request->conn->error = true;
-                CGUTILS_FREE(object);
+                object = NULL;
                 *((char **) this->obj) = NULL;
             }
         }
@@ -229,7 +263,6 @@ static int cg_storage_request_got_object_size_cb(cgutils_event_data * data,
     if (COMPILER_UNLIKELY(result != 0))
     {
         cg_storage_connection_finish(this->request->conn), this = NULL;
-        CGUTILS_FREE(this);
     }
 
     return result;
@@ -396,9 +429,9 @@ static int cg_storage_request_read_object(cg_storage_request * request,
     assert(cb != NULL);
 
     int result = ENOMEM;
-    cg_storage_request_obj * obj = NULL;
-
-    CGUTILS_ALLOCATE_STRUCT(obj);
+    cg_storage_request_obj * obj = cg_storage_request_alloc(request,
+                                                            1,
+                                                            sizeof *obj);
 
     if (COMPILER_LIKELY(obj != NULL))
     {
@@ -418,7 +451,7 @@ static int cg_storage_request_read_object(cg_storage_request * request,
         if (COMPILER_UNLIKELY(result != 0))
         {
             CGUTILS_ERROR("Error reading object size: %d", result);
-            CGUTILS_FREE(obj);
+            obj = NULL;
         }
     }
 
@@ -440,7 +473,7 @@ static int cg_storage_request_low_attr_db_cb(int status,
 
     if (result == 0)
     {
-        CGUTILS_ALLOCATE_STRUCT(request->st);
+        request->st = cg_storage_request_alloc(request, 1, sizeof *(request->st));
 
         if (COMPILER_LIKELY(request->st != NULL))
         {
@@ -633,26 +666,93 @@ int cg_storage_request_cb_low_getattr(cg_storage_request * const request)
     return result;
 }
 
-static int cg_storage_request_low_readdir_db_cb(int status,
-                                                size_t const entries_count,
-                                                cgutils_vector * entries,
-                                                void * cb_data)
+static int cg_storage_request_batch_init(cg_storage_request * const request)
+{
+    int result = 0;
+    CGUTILS_ASSERT(request != NULL);
+    CGUTILS_ASSERT(request->batch_size > 0);
+
+    request->batch_codes = cg_storage_request_alloc(request, request->batch_size, sizeof *(request->batch_codes));
+    request->batch_st = cg_storage_request_alloc(request, request->batch_size, sizeof *(request->batch_st));
+
+    if (COMPILER_LIKELY(request->batch_codes != NULL &&
+                        request->batch_st != NULL))
+    {
+        for (size_t idx = 0;
+             idx < request->batch_size;
+             idx++)
+        {
+            request->batch_codes[idx] = ENOENT;
+            request->batch_st[idx] = (struct stat) { 0 };
+        }
+    }
+    else
+    {
+        result = ENOMEM;
+        CGUTILS_ERROR("Error allocating responses for %"PRIu32" keys: %d",
+                      request->batch_size,
+                      result);
+    }
+
+    return result;
+}
+
+/* Replies to a _multi request with the global response code,
+   then the response code and the stat of each key, in request order. */
+static int cg_storage_request_low_multi_db_cb(int status,
+                                              size_t const entries_count,
+                                              cgutils_vector * entries,
+                                              void * cb_data)
 {
     int result = status;
     cg_storage_request * request = cb_data;
+    CGUTILS_ASSERT(request != NULL);
 
-    if (result == 0)
+    if (COMPILER_LIKELY(result == 0))
     {
-        size_t * count = NULL;
+        for (size_t idx = 0;
+             result == 0 &&
+                 idx < entries_count;
+             idx++)
+        {
+            cgdb_entry * entry = NULL;
 
-        CGUTILS_MALLOC(count, 1, sizeof *count);
+            result = cgutils_vector_get(entries,
+                                        idx,
+                                        (void **) &entry);
 
-        if (count != NULL)
-        {
-            request->entries = entries;
-            *count = entries_count;
+            if (COMPILER_LIKELY(result == 0))
+            {
+                CGUTILS_ASSERT(entry != NULL);
+
+                /* the same key may have been asked more than once */
+                for (size_t key = 0;
+                     key < request->batch_size;
+                     key++)
+                {
+                    bool const match = request->batch_names != NULL ?
+                        (entry->name != NULL && strcmp(request->batch_names[key], entry->name) == 0) :
+                        request->batch_inodes[key] == entry->inode.inode_number;
 
+                    if (match == true)
+                    {
+                        request->batch_codes[key] = 0;
+                        request->batch_st[key] = entry->inode.st;
+                    }
+                }
+            }
+            else
+            {
+                CGUTILS_ERROR("Error getting entry %zu: %d",
+                              idx,
+                              result);
+            }
+        }
+
+        if (COMPILER_LIKELY(result == 0))
+        {
             request->response_code = 0;
+
             result = cgutils_event_buffered_io_add_one(request->conn->io,
                                                        &request->response_code,
                                                        sizeof request->response_code,
@@ -660,129 +760,115 @@ static int cg_storage_request_low_readdir_db_cb(int status,
                                                        &cg_storage_request_io_error_handler,
                                                        request);
 
-            if (result == 0)
+            if (COMPILER_LIKELY(result == 0))
             {
                 result = cgutils_event_buffered_io_add_one(request->conn->io,
-                                                           count,
-                                                           sizeof *count,
+                                                           request->batch_codes,
+                                                           request->batch_size * sizeof *(request->batch_codes),
                                                            cgutils_event_buffered_io_writing,
-                                                           &cg_storage_request_writer_cb_free,
+                                                           &cg_storage_request_io_error_handler,
                                                            request);
 
-                if (result == 0)
+                if (COMPILER_LIKELY(result == 0))
                 {
-                    count = NULL;
+                    result = cgutils_event_buffered_io_add_one(request->conn->io,
+                                                               request->batch_st,
+                                                               request->batch_size * sizeof *(request->batch_st),
+                                                               cgutils_event_buffered_io_writing,
+                                                               &cg_storage_request_writer_cb_nofree,
+                                                               request);
 
-                    for(size_t idx = 0;
-                        idx < entries_count &&
-                            result == 0;
-                        idx++)
+                    if (COMPILER_UNLIKELY(result != 0))
                     {
-                        cgdb_entry * entry = NULL;
-
-                        result = cgutils_vector_get(entries,
-                                                    idx,
-                                                    (void **) &entry);
-
-                        if (result == 0)
-                        {
-                            CGUTILS_ASSERT(entry != NULL);
-                            CGUTILS_ASSERT(entry->name != NULL);
-
-                            if (entry->name != NULL)
-                            {
-                                size_t const entry_name_len = strlen(entry->name);
-                                CGUTILS_ASSERT(entry_name_len > 0);
-
-                                result = cg_storage_request_send_object(request,
-                                                                        entry_name_len + 1,
-                                                                        entry->name,
-                                                                        &cg_storage_request_io_error_handler);
-
-                                if (result == 0)
-                                {
-                                    result = cgutils_event_buffered_io_add_one(request->conn->io,
-                                                                               &(entry->inode.st),
-                                                                               sizeof (entry->inode.st),
-                                                                               cgutils_event_buffered_io_writing,
-                                                                               &cg_storage_request_writer_cb_nofree,
-                                                                               request);
-
-                                    if (result != 0)
-                                    {
-                                        CGUTILS_ERROR("Error adding stat to buffered writer: %d", result);
-                                    }
-                                }
-                                else
-                                {
-                                    CGUTILS_ERROR("Error adding data to buffered writer: %d", result);
-                                }
-                            }
-                            else
-                            {
-                                CGUTILS_ERROR("Error, invalid NULL name for entry %zu, skipping",
-                                              idx);
-                            }
-                        }
-                        else
-                        {
-                            CGUTILS_ERROR("Error getting entry %zu: %d",
-                                          idx,
-                                          result);
-                        }
+                        CGUTILS_ERROR("Error sending stat data: %d", result);
                     }
                 }
                 else
                 {
-                    CGUTILS_ERROR("Error sending entries count: %d", result);
+                    CGUTILS_ERROR("Error sending response codes: %d", result);
                 }
             }
             else
             {
-                CGUTILS_ERROR("Error sending response code: %d", result);
-            }
-
-            if (result != 0 && count != NULL)
-            {
-                CGUTILS_FREE(count);
+                CGUTILS_ERROR("Error sending response code object: %d", result);
             }
         }
-        else
-        {
-            CGUTILS_ERROR("Error allocating counter: %d", result);
-            result = ENOMEM;
-        }
+    }
+    else
+    {
+        CGUTILS_ERROR("Got status of: %d", result);
+    }
 
-        if (result == 0)
-        {
-            /* entries are freed when the request is freed,
-               after the writer callback */
-        }
-        else
+    if (entries != NULL)
+    {
+        cgutils_vector_deep_free(&entries, &cgdb_entry_delete);
+    }
+
+    if (COMPILER_UNLIKELY(result != 0))
+    {
+        cg_storage_request_send_code(request, result);
+    }
+
+    return result;
+}
+
+static int cg_storage_request_low_getattr_multi_ready(cgutils_event_data * const data,
+                                                      int const status,
+                                                      int const fd,
+                                                      cgutils_event_buffered_io_obj * const obj)
+{
+    int result = status;
+
+    CGUTILS_ASSERT(data != NULL);
+    CGUTILS_ASSERT(fd != -1);
+    CGUTILS_ASSERT(obj != NULL);
+    cg_storage_request * request = obj->cb_data;
+    CGUTILS_ASSERT(request != NULL);
+
+    (void) data;
+    (void) fd;
+
+    if (COMPILER_LIKELY(status == 0))
+    {
+        result = cg_storage_request_batch_init(request);
+
+        if (COMPILER_LIKELY(result == 0))
         {
-            cgutils_vector_deep_free(&entries, &cgdb_entry_delete);
-            request->entries = NULL;
+            result = cg_storage_filesystem_dir_get_inodes_entries(request->conn->fs,
+                                                                  request->batch_inodes,
+                                                                  request->batch_size,
+                                                                  &cg_storage_request_low_multi_db_cb,
+                                                                  request);
+
+            if (COMPILER_UNLIKELY(result != 0))
+            {
+                CGUTILS_ERROR("Error in cg_storage_filesystem_dir_get_inodes_entries: %d",
+                              result);
+            }
         }
     }
     else
     {
-        CGUTILS_ERROR("Got status of: %d", result);
+        CGUTILS_ERROR("Error reading from socket: %d",
+                      result);
     }
 
-    if (result != 0)
+    if (COMPILER_UNLIKELY(result != 0))
     {
-        cg_storage_request_send_code(request, result);
+        cg_storage_request_send_code(request,
+                                     result);
     }
 
     return result;
 }
 
-static int cg_storage_request_low_readdir_ready(cgutils_event_data * const data,
-                                                int const status,
-                                                int const fd,
-                                                cgutils_event_buffered_io_obj * const obj)
+static int cg_storage_request_low_getattr_multi_size_ready(cgutils_event_data * const data,
+                                                           int const status,
+                                                           int const fd,
+                                                           cgutils_event_buffered_io_obj * const obj)
 {
     int result = status;
+
     CGUTILS_ASSERT(data != NULL);
     CGUTILS_ASSERT(fd != -1);
     CGUTILS_ASSERT(obj != NULL);
@@ -794,20 +880,651 @@ static int cg_storage_request_low_readdir_ready(cgutils_event_data * const data,
 
     if (COMPILER_LIKELY(status == 0))
     {
-        result = cg_storage_filesystem_dir_get_entries_by_inode(request->conn->fs,
-                                                                request->inode_number,
-                                                                &cg_storage_request_low_readdir_db_cb,
-                                                                request);
+        if (COMPILER_LIKELY(request->batch_size > 0 &&
+                            request->batch_size <= CG_STORAGE_REQUEST_BATCH_SIZE_MAX))
+        {
+            request->batch_inodes = cg_storage_request_alloc(request, request->batch_size, sizeof *(request->batch_inodes));
+
+            if (COMPILER_LIKELY(request->batch_inodes != NULL))
+            {
+                result = cgutils_event_buffered_io_add_one(request->conn->io,
+                                                           request->batch_inodes,
+                                                           request->batch_size * sizeof *(request->batch_inodes),
+                                                           cgutils_event_buffered_io_reading,
+                                                           &cg_storage_request_low_getattr_multi_ready,
+                                                           request);
+
+                if (COMPILER_UNLIKELY(result != 0))
+                {
+                    CGUTILS_ERROR("Error adding read operation for inode numbers: %d",
+                                  result);
+                }
+            }
+            else
+            {
+                result = ENOMEM;
+                CGUTILS_ERROR("Error allocating %"PRIu32" inode numbers: %d",
+                              request->batch_size,
+                              result);
+            }
+        }
+        else
+        {
+            /* we can't skip the keys, the stream is lost */
+            result = EINVAL;
+            CGUTILS_ERROR("Invalid batch size %"PRIu32": %d",
+                          request->batch_size,
+                          result);
+        }
+    }
+    else
+    {
+        CGUTILS_ERROR("Error reading from socket: %d",
+                      result);
+    }
+
+    if (COMPILER_UNLIKELY(result != 0))
+    {
+        cg_storage_connection_finish(request->conn), request = NULL;
+    }
+
+    return result;
+}
+
+int cg_storage_request_cb_low_getattr_multi(cg_storage_request * const request)
+{
+    CGUTILS_ASSERT(request != NULL);
+
+    int result = cgutils_event_buffered_io_add_one(request->conn->io,
+                                                   &(request->batch_size),
+                                                   sizeof request->batch_size,
+                                                   cgutils_event_buffered_io_reading,
+                                                   &cg_storage_request_low_getattr_multi_size_ready,
+                                                   request);
+
+    if (COMPILER_UNLIKELY(result != 0))
+    {
+        CGUTILS_ERROR("Error adding read operation for batch size: %d",
+                      result);
+        cg_storage_request_send_code(request,
+                                     result);
+    }
+
+    return result;
+}
+
+/* The names are sent as a single object, each one being NUL-terminated */
+static int cg_storage_request_low_lookup_child_multi_ready(int const status,
+                                                           cg_storage_request * const request)
+{
+    int result = status;
+    CGUTILS_ASSERT(request != NULL);
+
+    if (COMPILER_LIKELY(status == 0))
+    {
+        CGUTILS_ASSERT(request->path != NULL);
+        request->path[request->path_len] = '\0';
+
+        if (COMPILER_LIKELY(request->batch_size > 0 &&
+                            request->batch_size <= CG_STORAGE_REQUEST_BATCH_SIZE_MAX))
+        {
+            request->batch_names = cg_storage_request_alloc(request, request->batch_size, sizeof *(request->batch_names));
+
+            if (COMPILER_LIKELY(request->batch_names != NULL))
+            {
+                size_t names_count = 0;
+                size_t pos = 0;
+
+                while (result == 0 &&
+                       pos < request->path_len)
+                {
+                    char const * const name = request->path + pos;
+                    size_t const name_len = strlen(name);
+
+                    if (COMPILER_LIKELY(name_len > 0 &&
+                                        names_count < request->batch_size))
+                    {
+                        request->batch_names[names_count] = name;
+                        names_count++;
+                        pos += name_len + 1;
+                    }
+                    else
+                    {
+                        result = EINVAL;
+                    }
+                }
+
+                if (COMPILER_LIKELY(result == 0 &&
+                                    names_count == request->batch_size))
+                {
+                    result = cg_storage_request_batch_init(request);
+
+                    if (COMPILER_LIKELY(result == 0))
+                    {
+                        result = cg_storage_filesystem_dir_get_children_entries(request->conn->fs,
+                                                                                request->inode_number,
+                                                                                request->batch_names,
+                                                                                request->batch_size,
+                                                                                &cg_storage_request_low_multi_db_cb,
+                                                                                request);
+
+                        if (COMPILER_UNLIKELY(result != 0))
+                        {
+                            CGUTILS_ERROR("Error in cg_storage_filesystem_dir_get_children_entries: %d",
+                                          result);
+                        }
+                    }
+                }
+                else
+                {
+                    result = EINVAL;
+                    CGUTILS_ERROR("Invalid names for a batch of %"PRIu32": %d",
+                                  request->batch_size,
+                                  result);
+                }
+            }
+            else
+            {
+                result = ENOMEM;
+                CGUTILS_ERROR("Error allocating %"PRIu32" names: %d",
+                              request->batch_size,
+                              result);
+            }
+        }
+        else
+        {
+            result = EINVAL;
+            CGUTILS_ERROR("Invalid batch size %"PRIu32": %d",
+                          request->batch_size,
+                          result);
+        }
+    }
+    else
+    {
+        CGUTILS_ERROR("Error reading from socket: %d",
+                      result);
+    }
+
+    if (COMPILER_UNLIKELY(result != 0))
+    {
+        cg_storage_request_send_code(request,
+                                     result);
+    }
+
+    return result;
+}
+
+int cg_storage_request_cb_low_lookup_child_multi(cg_storage_request * const request)
+{
+    CGUTILS_ASSERT(request != NULL);
+
+    int result = cgutils_event_buffered_io_add_one(request->conn->io,
+                                                   &(request->inode_number),
+                                                   sizeof request->inode_number,
+                                                   cgutils_event_buffered_io_reading,
+                                                   &cg_storage_request_io_error_handler,
+                                                   request);
+
+    if (COMPILER_LIKELY(result == 0))
+    {
+        result = cgutils_event_buffered_io_add_one(request->conn->io,
+                                                   &(request->batch_size),
+                                                   sizeof request->batch_size,
+                                                   cgutils_event_buffered_io_reading,
+                                                   &cg_storage_request_io_error_handler,
+                                                   request);
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            result = cg_storage_request_read_object(request,
+                                                    &(request->path_len),
+                                                    &(request->path),
+                                                    true,
+                                                    &cg_storage_request_low_lookup_child_multi_ready);
+
+            if (COMPILER_UNLIKELY(result != 0))
+            {
+                CGUTILS_ERROR("Error adding read operation for names: %d",
+                              result);
+            }
+        }
+        else
+        {
+            CGUTILS_ERROR("Error adding read operation for batch size: %d",
+                          result);
+        }
+    }
+    else
+    {
+        CGUTILS_ERROR("Error adding read operation for inode number: %d",
+                      result);
+    }
+
+    if (COMPILER_UNLIKELY(result != 0))
+    {
+        cg_storage_request_send_code(request,
+                                     result);
+    }
+
+    return result;
+}
+
+/* Sends the entries count, then the name and stat of each entry */
+static int cg_storage_request_send_entries(cg_storage_request * const request,
+                                           size_t const entries_count,
+                                           cgutils_vector * const entries)
+{
+    int result = 0;
+    size_t * count = NULL;
+    CGUTILS_ASSERT(request != NULL);
+    CGUTILS_ASSERT(entries != NULL || entries_count == 0);
+
+    count = cg_storage_request_alloc(request, 1, sizeof *count);
+
+    if (count != NULL)
+    {
+        *count = entries_count;
+
+        result = cgutils_event_buffered_io_add_one(request->conn->io,
+                                                   count,
+                                                   sizeof *count,
+                                                   cgutils_event_buffered_io_writing,
+                                                   &cg_storage_request_writer_cb_nofree,
+                                                   request);
+
+        if (result == 0)
+        {
+            for(size_t idx = 0;
+                idx < entries_count &&
+                    result == 0;
+                idx++)
+            {
+                cgdb_entry * entry = NULL;
+
+                result = cgutils_vector_get(entries,
+                                            idx,
+                                            (void **) &entry);
+
+                if (result == 0)
+                {
+                    CGUTILS_ASSERT(entry != NULL);
+                    CGUTILS_ASSERT(entry->name != NULL);
+
+                    if (entry->name != NULL)
+                    {
+                        size_t const entry_name_len = strlen(entry->name);
+                        CGUTILS_ASSERT(entry_name_len > 0);
+
+                        result = cg_storage_request_send_object(request,
+                                                                entry_name_len + 1,
+                                                                entry->name,
+                                                                &cg_storage_request_io_error_handler);
+
+                        if (result == 0)
+                        {
+                            result = cgutils_event_buffered_io_add_one(request->conn->io,
+                                                                       &(entry->inode.st),
+                                                                       sizeof (entry->inode.st),
+                                                                       cgutils_event_buffered_io_writing,
+                                                                       &cg_storage_request_writer_cb_nofree,
+                                                                       request);
+
+                            if (result != 0)
+                            {
+                                CGUTILS_ERROR("Error adding stat to buffered writer: %d", result);
+                            }
+                        }
+                        else
+                        {
+                            CGUTILS_ERROR("Error adding data to buffered writer: %d", result);
+                        }
+                    }
+                    else
+                    {
+                        CGUTILS_ERROR("Error, invalid NULL name for entry %zu, skipping",
+                                      idx);
+                    }
+                }
+                else
+                {
+                    CGUTILS_ERROR("Error getting entry %zu: %d",
+                                  idx,
+                                  result);
+                }
+            }
+        }
+        else
+        {
+            CGUTILS_ERROR("Error sending entries count: %d", result);
+        }
+
+    }
+    else
+    {
+        result = ENOMEM;
+        CGUTILS_ERROR("Error allocating counter: %d", result);
+    }
+
+    return result;
+}
+
+static int cg_storage_request_low_readdir_db_cb(int status,
+                                                size_t const entries_count,
+                                                cgutils_vector * entries,
+                                                void * cb_data)
+{
+    int result = status;
+    cg_storage_request * request = cb_data;
+
+    if (result == 0)
+    {
+        request->entries = entries;
+
+        request->response_code = 0;
+        result = cgutils_event_buffered_io_add_one(request->conn->io,
+                                                   &request->response_code,
+                                                   sizeof request->response_code,
+                                                   cgutils_event_buffered_io_writing,
+                                                   &cg_storage_request_io_error_handler,
+                                                   request);
+
+        if (result == 0)
+        {
+            result = cg_storage_request_send_entries(request,
+                                                     entries_count,
+                                                     entries);
+        }
+        else
+        {
+            CGUTILS_ERROR("Error sending response code: %d", result);
+        }
+
+        if (result == 0)
+        {
+            /* entries are freed when the request is freed,
+               after the writer callback */
+        }
+        else
+        {
+            cgutils_vector_deep_free(&entries, &cgdb_entry_delete);
+            request->entries = NULL;
+        }
+    }
+    else
+    {
+        CGUTILS_ERROR("Got status of: %d", result);
+    }
+
+    if (result != 0)
+    {
+        cg_storage_request_send_code(request, result);
+    }
+
+    return result;
+}
+
+static int cg_storage_request_low_readdir_ready(cgutils_event_data * const data,
+                                                int const status,
+                                                int const fd,
+                                                cgutils_event_buffered_io_obj * const obj)
+{
+    int result = status;
+    CGUTILS_ASSERT(data != NULL);
+    CGUTILS_ASSERT(fd != -1);
+    CGUTILS_ASSERT(obj != NULL);
+    cg_storage_request * request = obj->cb_data;
+    CGUTILS_ASSERT(request != NULL);
+
+    (void) data;
+    (void) fd;
+
+    if (COMPILER_LIKELY(status == 0))
+    {
+        result = cg_storage_filesystem_dir_get_entries_by_inode(request->conn->fs,
+                                                                request->inode_number,
+                                                                &cg_storage_request_low_readdir_db_cb,
+                                                                request);
+
+        if (COMPILER_UNLIKELY(result != 0))
+        {
+            CGUTILS_ERROR("Error in cg_storage_filesystem_entry_get_entries_by_inode: %d",
+                          result);
+        }
+    }
+    else
+    {
+        CGUTILS_ERROR("Error reading from socket: %d",
+                      result);
+    }
+
+    if (COMPILER_UNLIKELY(result != 0))
+    {
+        cg_storage_request_send_code(request,
+                                     result);
+    }
+
+    return result;
+}
+
+/* Non-paginated listing, no longer sent by cgsmclient but kept for older clients */
+int cg_storage_request_cb_low_readdir(cg_storage_request * const request)
+{
+    CGUTILS_ASSERT(request != NULL);
+
+    int result = cgutils_event_buffered_io_add_one(request->conn->io,
+                                                   &(request->inode_number),
+                                                   sizeof request->inode_number,
+                                                   cgutils_event_buffered_io_reading,
+                                                   &cg_storage_request_low_readdir_ready,
+                                                   request);
+
+    if (COMPILER_UNLIKELY(result != 0))
+    {
+        CGUTILS_ERROR("Error adding read operation for inode_number: %d",
+                      result);
+        cg_storage_request_send_code(request,
+                                     result);
+    }
+
+    return result;
+}
+
+static int cg_storage_request_low_readdir_page_db_cb(int status,
+                                                     size_t const entries_count,
+                                                     cgutils_vector * entries,
+                                                     void * cb_data)
+{
+    int result = status;
+    cg_storage_request * request = cb_data;
+
+    if (result == 0)
+    {
+        size_t children_count = 0;
+        uint64_t last_entry_id = 0;
+
+        request->entries = entries;
+
+        /* The first page also contains '.' and '..',
+           they do not count against the page size. */
+        for (size_t idx = 0;
+             idx < entries_count &&
+                 result == 0;
+             idx++)
+        {
+            cgdb_entry * entry = NULL;
+
+            result = cgutils_vector_get(entries,
+                                        idx,
+                                        (void **) &entry);
+
+            if (result == 0)
+            {
+                CGUTILS_ASSERT(entry != NULL);
+
+                if (entry->name != NULL &&
+                    strcmp(entry->name, ".") != 0 &&
+                    strcmp(entry->name, "..") != 0)
+                {
+                    children_count++;
+                    last_entry_id = entry->entry_id;
+                }
+            }
+        }
+
+        /* a short page means we reached the end of the directory */
+        request->dir_cursor = children_count >= request->dir_page_size ? last_entry_id : 0;
+
+        request->response_code = 0;
+
+        if (result == 0)
+        {
+            result = cgutils_event_buffered_io_add_one(request->conn->io,
+                                                       &request->response_code,
+                                                       sizeof request->response_code,
+                                                       cgutils_event_buffered_io_writing,
+                                                       &cg_storage_request_io_error_handler,
+                                                       request);
+        }
+
+        if (result == 0)
+        {
+            result = cgutils_event_buffered_io_add_one(request->conn->io,
+                                                       &request->dir_cursor,
+                                                       sizeof request->dir_cursor,
+                                                       cgutils_event_buffered_io_writing,
+                                                       &cg_storage_request_io_error_handler,
+                                                       request);
+
+            if (result == 0)
+            {
+                result = cg_storage_request_send_entries(request,
+                                                         entries_count,
+                                                         entries);
+            }
+            else
+            {
+                CGUTILS_ERROR("Error sending next cursor: %d", result);
+            }
+        }
+        else
+        {
+            CGUTILS_ERROR("Error sending response code: %d", result);
+        }
+
+        if (result != 0)
+        {
+            cgutils_vector_deep_free(&entries, &cgdb_entry_delete);
+            request->entries = NULL;
+        }
+    }
+    else
+    {
+        CGUTILS_ERROR("Got status of: %d", result);
+    }
+
+    if (result != 0)
+    {
+        cg_storage_request_send_code(request, result);
+    }
+
+    return result;
+}
+
+static int cg_storage_request_low_readdir_page_ready(cgutils_event_data * const data,
+                                                     int const status,
+                                                     int const fd,
+                                                     cgutils_event_buffered_io_obj * const obj)
+{
+    int result = status;
+    CGUTILS_ASSERT(data != NULL);
+    CGUTILS_ASSERT(fd != -1);
+    CGUTILS_ASSERT(obj != NULL);
+    cg_storage_request * request = obj->cb_data;
+    CGUTILS_ASSERT(request != NULL);
+
+    (void) data;
+    (void) fd;
+
+    if (COMPILER_LIKELY(status == 0))
+    {
+        if (request->dir_page_size == 0 ||
+            request->dir_page_size > CG_STORAGE_REQUEST_READDIR_PAGE_SIZE_MAX)
+        {
+            request->dir_page_size = CG_STORAGE_REQUEST_READDIR_PAGE_SIZE_MAX;
+        }
+
+        result = cg_storage_filesystem_dir_get_entries_page_by_inode(request->conn->fs,
+                                                                     request->inode_number,
+                                                                     request->dir_cursor,
+                                                                     request->dir_page_size,
+                                                                     &cg_storage_request_low_readdir_page_db_cb,
+                                                                     request);
+
+        if (COMPILER_UNLIKELY(result != 0))
+        {
+            CGUTILS_ERROR("Error in cg_storage_filesystem_dir_get_entries_page_by_inode: %d",
+                          result);
+        }
+    }
+    else
+    {
+        CGUTILS_ERROR("Error reading from socket: %d",
+                      result);
+    }
+
+    if (COMPILER_UNLIKELY(result != 0))
+    {
+        cg_storage_request_send_code(request,
+                                     result);
+    }
+
+    return result;
+}
+
+int cg_storage_request_cb_low_readdir_page(cg_storage_request * const request)
+{
+    CGUTILS_ASSERT(request != NULL);
+
+    int result = cgutils_event_buffered_io_add_one(request->conn->io,
+                                                   &(request->inode_number),
+                                                   sizeof request->inode_number,
+                                                   cgutils_event_buffered_io_reading,
+                                                   &cg_storage_request_io_error_handler,
+                                                   request);
+
+    if (COMPILER_LIKELY(result == 0))
+    {
+        result = cgutils_event_buffered_io_add_one(request->conn->io,
+                                                   &(request->dir_cursor),
+                                                   sizeof request->dir_cursor,
+                                                   cgutils_event_buffered_io_reading,
+                                                   &cg_storage_request_io_error_handler,
+                                                   request);
 
-        if (COMPILER_UNLIKELY(result != 0))
+        if (COMPILER_LIKELY(result == 0))
         {
-            CGUTILS_ERROR("Error in cg_storage_filesystem_entry_get_entries_by_inode: %d",
+            result = cgutils_event_buffered_io_add_one(request->conn->io,
+                                                       &(request->dir_page_size),
+                                                       sizeof request->dir_page_size,
+                                                       cgutils_event_buffered_io_reading,
+                                                       &cg_storage_request_low_readdir_page_ready,
+                                                       request);
+
+            if (COMPILER_UNLIKELY(result != 0))
+            {
+                CGUTILS_ERROR("Error adding read operation for page size: %d",
+                              result);
+            }
+        }
+        else
+        {
+            CGUTILS_ERROR("Error adding read operation for cursor: %d",
                           result);
         }
     }
     else
     {
-        CGUTILS_ERROR("Error reading from socket: %d",
+        CGUTILS_ERROR("Error adding read operation for inode number: %d",
                       result);
     }
 
@@ -820,23 +1537,67 @@ static int cg_storage_request_low_readdir_ready(cgutils_event_data * const data,
     return result;
 }
 
-int cg_storage_request_cb_low_readdir(cg_storage_request * const request)
+static bool cg_storage_request_wants_fd(cg_storage_request const * const request)
 {
     CGUTILS_ASSERT(request != NULL);
 
-    int result = cgutils_event_buffered_io_add_one(request->conn->io,
-                                                   &(request->inode_number),
-                                                   sizeof request->inode_number,
-                                                   cgutils_event_buffered_io_reading,
-                                                   &cg_storage_request_low_readdir_ready,
-                                                   request);
+    return request->opcode == cgsm_proto_opcode_low_open_fd ||
+        request->opcode == cgsm_proto_opcode_low_open_fd_leased ||
+        request->opcode == cgsm_proto_opcode_low_create_and_open_fd;
+}
+
+/* Older clients do not expect a lease in the response */
+static bool cg_storage_request_wants_lease(cg_storage_request const * const request)
+{
+    CGUTILS_ASSERT(request != NULL);
+
+    return request->opcode == cgsm_proto_opcode_low_open_leased ||
+        request->opcode == cgsm_proto_opcode_low_open_fd_leased;
+}
+
+/* The file is opened here, on behalf of the client, so that
+   it does not have to resolve the path in cache again
+   and cannot lose the file to the cleaner in the meantime. */
+static int cg_storage_request_open_file_in_cache(cg_storage_request * const request,
+                                                 char const * const path_in_cache)
+{
+    CGUTILS_ASSERT(request != NULL);
+    CGUTILS_ASSERT(path_in_cache != NULL);
+    CGUTILS_ASSERT(request->fd_in_cache == -1);
+
+    int const flags = (request->flags & ~(O_CREAT|O_EXCL)) | O_NONBLOCK | O_CLOEXEC;
+
+    int result = cgutils_file_open(path_in_cache,
+                                   flags,
+                                   0,
+                                   &(request->fd_in_cache));
 
     if (COMPILER_UNLIKELY(result != 0))
     {
-        CGUTILS_ERROR("Error adding read operation for inode_number: %d",
+        CGUTILS_ERROR("Error opening file in cache %s: %d",
+                      path_in_cache,
+                      result);
+    }
+
+    return result;
+}
+
+static int cg_storage_request_send_fd_in_cache(cg_storage_request * const request)
+{
+    CGUTILS_ASSERT(request != NULL);
+    CGUTILS_ASSERT(request->fd_in_cache != -1);
+
+    /* the descriptor is closed once the request has been dealt with */
+    int result = cgutils_event_buffered_io_add_fd(request->conn->io,
+                                                  &(request->fd_in_cache),
+                                                  cgutils_event_buffered_io_writing,
+                                                  &cg_storage_request_writer_cb_nofree,
+                                                  request);
+
+    if (COMPILER_UNLIKELY(result != 0))
+    {
+        CGUTILS_ERROR("Error sending file in cache descriptor: %d",
                       result);
-        cg_storage_request_send_code(request,
-                                     result);
     }
 
     return result;
@@ -858,12 +1619,21 @@ static int cg_storage_request_low_create_and_open_db_cb(int status,
 
         if (COMPILER_LIKELY(file_in_cache != NULL))
         {
-            CGUTILS_ALLOCATE_STRUCT(request->st);
+            bool const wants_fd = cg_storage_request_wants_fd(request);
+
+            request->st = cg_storage_request_alloc(request, 1, sizeof *(request->st));
 
             if (COMPILER_LIKELY(request->st != NULL))
             {
                 result = cg_storage_object_get_stat(obj, request->st);
 
+                if (COMPILER_LIKELY(result == 0 &&
+                                    wants_fd == true))
+                {
+                    result = cg_storage_request_open_file_in_cache(request,
+                                                                   file_in_cache);
+                }
+
                 if (COMPILER_LIKELY(result == 0))
                 {
                     request->response_code = 0;
@@ -885,18 +1655,25 @@ static int cg_storage_request_low_create_and_open_db_cb(int status,
 
                         if (COMPILER_LIKELY(result == 0))
                         {
-                            size_t const file_in_cache_len = strlen(file_in_cache);
-                            CGUTILS_ASSERT(file_in_cache_len > 0);
+                            if (wants_fd == true)
+                            {
+                                result = cg_storage_request_send_fd_in_cache(request);
+                            }
+                            else
+                            {
+                                size_t const file_in_cache_len = strlen(file_in_cache);
+                                CGUTILS_ASSERT(file_in_cache_len > 0);
 
-                            result = cg_storage_request_send_object(request,
-                                                                    file_in_cache_len + 1,
-                                                                    file_in_cache,
-                                                                    &cg_storage_request_writer_cb_free);
+                                result = cg_storage_request_send_object(request,
+                                                                        file_in_cache_len + 1,
+                                                                        file_in_cache,
+                                                                        &cg_storage_request_writer_cb_free);
 
-                            if (COMPILER_UNLIKELY(result != 0))
-                            {
-                                CGUTILS_ERROR("Error sending file in cache path data: %d",
-                                              result);
+                                if (COMPILER_UNLIKELY(result != 0))
+                                {
+                                    CGUTILS_ERROR("Error sending file in cache path data: %d",
+                                                  result);
+                                }
                             }
                         }
                         else
@@ -923,6 +1700,12 @@ static int cg_storage_request_low_create_and_open_db_cb(int status,
                 CGUTILS_ERROR("Error allocating object: %d",
                               result);
             }
+
+            if (wants_fd == true)
+            {
+                /* only the descriptor is sent */
+                CGUTILS_FREE(file_in_cache);
+            }
         }
         else
         {
@@ -1083,6 +1866,22 @@ int cg_storage_request_cb_low_create_and_open(cg_storage_request * const request
     return result;
 }
 
+/* Read-only opens are leased to the client, which reopens the file
+   from its own descriptor until the lease expires or it sees the inode change. */
+static cgsm_proto_lease_type cg_storage_request_open_lease(cg_storage_request const * const request)
+{
+    CGUTILS_ASSERT(request != NULL);
+    cgsm_proto_lease_type result = 0;
+
+    if ((request->flags & O_ACCMODE) == O_RDONLY &&
+        (request->flags & O_TRUNC) == 0)
+    {
+        result = cg_storage_filesystem_get_open_lease_duration(request->conn->fs);
+    }
+
+    return result;
+}
+
 static int cg_storage_request_low_open_file_in_cache_cb(int status,
                                                         char * path_in_cache,
                                                         void * cb_data)
@@ -1097,28 +1896,61 @@ static int cg_storage_request_low_open_file_in_cache_cb(int status,
 
         if (COMPILER_LIKELY(path_in_cache != NULL))
         {
-            request->response_code = 0;
-            result = cgutils_event_buffered_io_add_one(request->conn->io,
-                                                       &request->response_code,
-                                                       sizeof request->response_code,
-                                                       cgutils_event_buffered_io_writing,
-                                                       &cg_storage_request_io_error_handler,
-                                                       request);
+            bool const wants_fd = cg_storage_request_wants_fd(request);
+
+            if (wants_fd == true)
+            {
+                result = cg_storage_request_open_file_in_cache(request,
+                                                               path_in_cache);
+            }
 
             if (COMPILER_LIKELY(result == 0))
             {
-                result = cg_storage_request_send_object(request,
-                                                        strlen(path_in_cache) + 1,
-                                                        (void * ) path_in_cache,
-                                                        &cg_storage_request_writer_cb_free);
-                if (COMPILER_UNLIKELY(result != 0))
+                request->response_code = 0;
+                result = cgutils_event_buffered_io_add_one(request->conn->io,
+                                                           &request->response_code,
+                                                           sizeof request->response_code,
+                                                           cgutils_event_buffered_io_writing,
+                                                           &cg_storage_request_io_error_handler,
+                                                           request);
+
+                if (COMPILER_LIKELY(result == 0) &&
+                    cg_storage_request_wants_lease(request) == true)
                 {
-                    CGUTILS_ERROR("Error sending path in cache: %d", result);
+                    request->lease = cg_storage_request_open_lease(request);
+
+                    result = cgutils_event_buffered_io_add_one(request->conn->io,
+                                                               &request->lease,
+                                                               sizeof request->lease,
+                                                               cgutils_event_buffered_io_writing,
+                                                               &cg_storage_request_io_error_handler,
+                                                               request);
+                }
+
+                if (COMPILER_LIKELY(result == 0))
+                {
+                    if (wants_fd == true)
+                    {
+                        result = cg_storage_request_send_fd_in_cache(request);
+
+                        CGUTILS_FREE(path_in_cache);
+                    }
+                    else
+                    {
+                        result = cg_storage_request_send_object(request,
+                                                                strlen(path_in_cache) + 1,
+                                                                (void * ) path_in_cache,
+                                                                &cg_storage_request_writer_cb_free);
+                        if (COMPILER_UNLIKELY(result != 0))
+                        {
+                            CGUTILS_ERROR("Error sending path in cache: %d", result);
+                        }
+                    }
+                }
+                else
+                {
+                    CGUTILS_ERROR("Error sending response code or lease: %d", result);
                 }
-            }
-            else
-            {
-                CGUTILS_ERROR("Error sending response code: %d", result);
             }
 
             if (COMPILER_UNLIKELY(result != 0))
@@ -1381,6 +2213,141 @@ int cg_storage_request_cb_low_notify_write(cg_storage_request * const request)
     return result;
 }
 
+static int cg_storage_request_low_notify_write_multi_ready(cgutils_event_data * const data,
+                                                           int const status,
+                                                           int const fd,
+                                                           cgutils_event_buffered_io_obj * const obj)
+{
+    int result = status;
+    CGUTILS_ASSERT(data != NULL);
+    CGUTILS_ASSERT(fd != -1);
+    CGUTILS_ASSERT(obj != NULL);
+    cg_storage_request * request = obj->cb_data;
+    CGUTILS_ASSERT(request != NULL);
+
+    (void) data;
+    (void) fd;
+
+    if (COMPILER_LIKELY(status == 0))
+    {
+        result = cg_storage_filesystem_file_inodes_notify_write_multi(request->conn->fs,
+                                                                      request->batch_inodes,
+                                                                      request->batch_size,
+                                                                      &cg_storage_request_status_cb,
+                                                                      request);
+
+        if (COMPILER_UNLIKELY(result != 0))
+        {
+            CGUTILS_ERROR("Error in cg_storage_filesystem_file_inodes_notify_write_multi: %d",
+                          result);
+        }
+    }
+    else
+    {
+        CGUTILS_ERROR("Error reading from socket: %d",
+                      result);
+    }
+
+    if (COMPILER_UNLIKELY(result != 0))
+    {
+        cg_storage_request_send_code(request,
+                                     result);
+    }
+
+    return result;
+}
+
+static int cg_storage_request_low_notify_write_multi_size_ready(cgutils_event_data * const data,
+                                                                int const status,
+                                                                int const fd,
+                                                                cgutils_event_buffered_io_obj * const obj)
+{
+    int result = status;
+
+    CGUTILS_ASSERT(data != NULL);
+    CGUTILS_ASSERT(fd != -1);
+    CGUTILS_ASSERT(obj != NULL);
+    cg_storage_request * request = obj->cb_data;
+    CGUTILS_ASSERT(request != NULL);
+
+    (void) data;
+    (void) fd;
+
+    if (COMPILER_LIKELY(status == 0))
+    {
+        if (COMPILER_LIKELY(request->batch_size > 0 &&
+                            request->batch_size <= CG_STORAGE_REQUEST_BATCH_SIZE_MAX))
+        {
+            request->batch_inodes = cg_storage_request_alloc(request, request->batch_size, sizeof *(request->batch_inodes));
+
+            if (COMPILER_LIKELY(request->batch_inodes != NULL))
+            {
+                result = cgutils_event_buffered_io_add_one(request->conn->io,
+                                                           request->batch_inodes,
+                                                           request->batch_size * sizeof *(request->batch_inodes),
+                                                           cgutils_event_buffered_io_reading,
+                                                           &cg_storage_request_low_notify_write_multi_ready,
+                                                           request);
+
+                if (COMPILER_UNLIKELY(result != 0))
+                {
+                    CGUTILS_ERROR("Error adding read operation for inode numbers: %d",
+                                  result);
+                }
+            }
+            else
+            {
+                result = ENOMEM;
+                CGUTILS_ERROR("Error allocating %"PRIu32" inode numbers: %d",
+                              request->batch_size,
+                              result);
+            }
+        }
+        else
+        {
+            /* we can't skip the keys, the stream is lost */
+            result = EINVAL;
+            CGUTILS_ERROR("Invalid batch size %"PRIu32": %d",
+                          request->batch_size,
+                          result);
+        }
+    }
+    else
+    {
+        CGUTILS_ERROR("Error reading from socket: %d",
+                      result);
+    }
+
+    if (COMPILER_UNLIKELY(result != 0))
+    {
+        cg_storage_connection_finish(request->conn), request = NULL;
+    }
+
+    return result;
+}
+
+int cg_storage_request_cb_low_notify_write_multi(cg_storage_request * const request)
+{
+    CGUTILS_ASSERT(request != NULL);
+
+    int result = cgutils_event_buffered_io_add_one(request->conn->io,
+                                                   &(request->batch_size),
+                                                   sizeof request->batch_size,
+                                                   cgutils_event_buffered_io_reading,
+                                                   &cg_storage_request_low_notify_write_multi_size_ready,
+                                                   request);
+
+    if (COMPILER_UNLIKELY(result != 0))
+    {
+        CGUTILS_ERROR("Error adding read operation for batch size: %d",
+                      result);
+        cg_storage_request_send_code(request,
+                                     result);
+    }
+
+    return result;
+}
+
 #include <cloudutils/cloudutils_system.h>
 
 static int cg_storage_request_low_setattr_ready(cgutils_event_data * const data,
@@ -1442,7 +2409,7 @@ int cg_storage_request_cb_low_setattr(cg_storage_request * const request)
 
     if (COMPILER_LIKELY(result == 0))
     {
-        CGUTILS_ALLOCATE_STRUCT(request->st);
+        request->st = cg_storage_request_alloc(request, 1, sizeof *(request->st));
 
         if (COMPILER_LIKELY(request->st != NULL))
         {
@@ -1963,15 +2930,15 @@ static int cg_storage_request_low_rename_paths_size_ready(cgutils_event_data * c
         if (COMPILER_LIKELY(request->path_len > 0 &&
                             request->path_to_len > 0))
         {
-            CGUTILS_MALLOC(request->path,
-                           request->path_len + 1,
-                           1);
+            request->path = cg_storage_request_alloc(request,
+                                                     request->path_len + 1,
+                                                     1);
 
             if (COMPILER_LIKELY(request->path != NULL))
             {
-                CGUTILS_MALLOC(request->path_to,
-                               request->path_to_len + 1,
-                               1);
+                request->path_to = cg_storage_request_alloc(request,
+                                                            request->path_to_len + 1,
+                                                            1);
 
                 if (COMPILER_LIKELY(request->path_to != NULL))
                 {
@@ -2182,9 +3149,9 @@ static int cg_storage_request_low_hardlink_path_size_ready(cgutils_event_data *
     {
         if (COMPILER_LIKELY(request->path_len > 0))
         {
-            CGUTILS_MALLOC(request->path,
-                           request->path_len + 1,
-                           1);
+            request->path = cg_storage_request_alloc(request,
+                                                     request->path_len + 1,
+                                                     1);
 
             if (COMPILER_LIKELY(request->path != NULL))
             {
@@ -2361,15 +3328,15 @@ static int cg_storage_request_low_symlink_paths_size_ready(cgutils_event_data *
         if (COMPILER_LIKELY(request->path_len > 0 &&
                             request->path_to_len > 0))
         {
-            CGUTILS_MALLOC(request->path,
-                           request->path_len + 1,
-                           1);
+            request->path = cg_storage_request_alloc(request,
+                                                     request->path_len + 1,
+                                                     1);
 
             if (COMPILER_LIKELY(request->path != NULL))
             {
-                CGUTILS_MALLOC(request->path_to,
-                               request->path_to_len + 1,
-                               1);
+                request->path_to = cg_storage_request_alloc(request,
+                                                            request->path_to_len + 1,
+                                                            1);
 
                 if (COMPILER_LIKELY(request->path_to != NULL))
                 {
@@ -2648,3 +3615,47 @@ int cg_storage_request_cb_low_readlink(cg_storage_request * const request)
 
     return result;
 }
+
+int cg_storage_request_cb_multiplex(cg_storage_request * const request)
+{
+    CGUTILS_ASSERT(request != NULL);
+
+    /* on error, the connection is closed */
+    return cg_storage_connection_multiplex(request->conn);
+}
+
+int cg_storage_request_cb_multiplex_ring(cg_storage_request * const request)
+{
+    CGUTILS_ASSERT(request != NULL);
+
+    /* on error, the connection is closed */
+    return cg_storage_connection_multiplex_ring(request->conn);
+}
+
+int cg_storage_request_cb_low_open_fd(cg_storage_request * const request)
+{
+    CGUTILS_ASSERT(request != NULL);
+
+    return cg_storage_request_cb_low_open(request);
+}
+
+int cg_storage_request_cb_low_create_and_open_fd(cg_storage_request * const request)
+{
+    CGUTILS_ASSERT(request != NULL);
+
+    return cg_storage_request_cb_low_create_and_open(request);
+}
+
+int cg_storage_request_cb_low_open_leased(cg_storage_request * const request)
+{
+    CGUTILS_ASSERT(request != NULL);
+
+    return cg_storage_request_cb_low_open(request);
+}
+
+int cg_storage_request_cb_low_open_fd_leased(cg_storage_request * const request)
+{
+    CGUTILS_ASSERT(request != NULL);
+
+    return cg_storage_request_cb_low_open(request);
+}
@@ -44,6 +44,12 @@ void cg_storage_connection_release(cg_storage_connection * this);
 
 int cg_storage_connection_go(cg_storage_connection * this);
 
+int cg_storage_connection_multiplex(cg_storage_connection * this);
+
+/* Reads the shared memory rings parameters, then switches
+   the connection to multiplexed mode over these rings */
+int cg_storage_connection_multiplex_ring(cg_storage_connection * this);
+
 COMPILER_BLOCK_VISIBILITY_END
 
 #endif /* CLOUD_GATEWAY_STORAGE_MANAGER_CONNECTION_H_ */
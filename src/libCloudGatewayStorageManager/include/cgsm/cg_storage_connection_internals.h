@@ -24,7 +24,10 @@
 #ifndef CLOUD_GATEWAY_STORAGE_CONNECTION_INTERNALS_H_
 #define CLOUD_GATEWAY_STORAGE_CONNECTION_INTERNALS_H_
 
+#include <cloudutils/cloudutils_arena.h>
 #include <cloudutils/cloudutils_event.h>
+#include <cloudutils/cloudutils_ring.h>
+#include <cloudutils/cloudutils_shared_memory_segment.h>
 #include <cgsm/cg_storage_manager_proto.h>
 
 #include "cg_storage_filesystem.h"
@@ -34,6 +37,9 @@ typedef struct cg_storage_request cg_storage_request;
 struct cg_storage_request
 {
     cg_storage_connection * conn;
+    /* allocations living until the request is cleaned,
+       created on first use and reset between requests */
+    cgutils_arena * arena;
     char * path;
     char * path_to;
     struct stat * st;
@@ -59,9 +65,26 @@ struct cg_storage_request
     cgsm_proto_response_code response_code;
     cgsm_proto_size_changed_type size_changed;
     cgsm_proto_dirty_type dirty;
+    /* used for low_open and low_open_fd */
+    cgsm_proto_lease_type lease;
+
+    /* used for readdir_page */
+    cgsm_proto_dir_cursor_type dir_cursor;
+    cgsm_proto_dir_page_size_type dir_page_size;
+
+    /* used for the _multi opcodes, names point into path */
+    cgsm_proto_batch_size_type batch_size;
+    uint64_t * batch_inodes;
+    char const ** batch_names;
+    cgsm_proto_response_code * batch_codes;
+    struct stat * batch_st;
 
     /* vector of cgdb_entry * used for readdir */
     cgutils_vector * entries;
+
+    /* file in cache passed to the client by the _fd opcodes,
+       -1 if none */
+    int fd_in_cache;
 };
 
 struct cg_storage_connection
@@ -80,8 +103,33 @@ struct cg_storage_connection
 
     size_t requests_per_conn;
 
+    /* Multiplexed mode: the real connection reads frames from io and
+       writes the responses to write_io, each frame being handled by
+       a virtual connection whose io is memory-backed. */
+    cg_storage_connection * parent;
+    cgutils_event_buffered_io * write_io;
+    char * frame;
+    size_t pending_frames;
+    cgsm_proto_request_id_type frame_id;
+    cgsm_proto_frame_size_type frame_size;
+
+    /* Shared memory rings: io and write_io go through them instead of
+       the socket, which is only watched by sock_io for the client going away.
+       ring_fds_count eventfds have been received. */
+    cloudutils_shared_memory_segment_handler * ring_segment;
+    cgutils_ring * request_ring;
+    cgutils_ring * response_ring;
+    cgutils_event_buffered_io * sock_io;
+    char * ring_name;
+    size_t ring_name_len;
+    size_t ring_fds_count;
+    cgsm_proto_ring_size_type ring_size;
+    int ring_fds[cgsm_proto_ring_fd_count];
+    char hangup;
+
     int sock;
     bool error;
+    bool multiplexed;
 };
 
 #endif /* CLOUD_GATEWAY_STORAGE_CONNECTION_INTERNALS_H_ */
@@ -129,6 +129,13 @@ int cg_storage_filesystem_file_inode_notify_write(cg_storage_filesystem * this,
                                                   cg_storage_filesystem_status_cb * cb,
                                                   void * cb_data);
 
+/* Sets all the given inodes dirty at once, with a single status */
+int cg_storage_filesystem_file_inodes_notify_write_multi(cg_storage_filesystem * this,
+                                                        uint64_t const * inodes,
+                                                        size_t inodes_count,
+                                                        cg_storage_filesystem_status_cb * cb,
+                                                        void * cb_data);
+
 /* this function only gets info on a given object, it does not download the object,
    nor create the root entry if there is none. */
 int cg_storage_filesystem_entry_get_object_info_by_path(cg_storage_filesystem * fs,
@@ -217,6 +224,26 @@ int cg_storage_filesystem_dir_get_entries_by_inode(cg_storage_filesystem * fs,
                                                    cg_storage_filesystem_dir_cb * cb,
                                                    void * cb_data);
 
+int cg_storage_filesystem_dir_get_entries_page_by_inode(cg_storage_filesystem * fs,
+                                                        uint64_t inode,
+                                                        uint64_t after_entry_id,
+                                                        size_t max_entries,
+                                                        cg_storage_filesystem_dir_cb * cb,
+                                                        void * cb_data);
+
+int cg_storage_filesystem_dir_get_inodes_entries(cg_storage_filesystem * fs,
+                                                 uint64_t const * inodes,
+                                                 size_t inodes_count,
+                                                 cg_storage_filesystem_dir_cb * cb,
+                                                 void * cb_data);
+
+int cg_storage_filesystem_dir_get_children_entries(cg_storage_filesystem * fs,
+                                                   uint64_t parent,
+                                                   char const * const * names,
+                                                   size_t names_count,
+                                                   cg_storage_filesystem_dir_cb * cb,
+                                                   void * cb_data);
+
 int cg_storage_filesystem_check_cache(cg_storage_filesystem const * filesystem,
                                       bool * full);
 
@@ -245,6 +272,8 @@ int cg_storage_filesystem_entry_expunge_inode_from_cache_if_all_instances_valid(
 uint64_t cg_storage_filesystem_get_clean_max_access_offset(cg_storage_filesystem const * fs) COMPILER_PURE_FUNCTION;
 uint64_t cg_storage_filesystem_get_clean_min_file_size(cg_storage_filesystem const * fs) COMPILER_PURE_FUNCTION;
 uint32_t cg_storage_filesystem_get_io_block_size(cg_storage_filesystem const * fs) COMPILER_PURE_FUNCTION;
+/* in milliseconds, 0 if read-only opens are not leased */
+uint32_t cg_storage_filesystem_get_open_lease_duration(cg_storage_filesystem const * fs) COMPILER_PURE_FUNCTION;
 
 bool cg_storage_filesystem_has_auto_expunge(cg_storage_filesystem const * fs) COMPILER_PURE_FUNCTION;
 
@@ -30,6 +30,7 @@
 #include <cgsm/cg_storage_filter.h>
 #include <cgsm/cg_storage_object.h>
 #include <cgsm/cg_storage_cache.h>
+#include <cgsm/cg_storage_inode_cache.h>
 
 #include <cloudutils/cloudutils_llist.h>
 #include <cloudutils/cloudutils_rbtree.h>
@@ -54,6 +55,8 @@ struct cg_storage_filesystem
     cg_storage_filesystem_instance * instances;
     /* rbtree of cgutils_llist * of generic_cb_data * */
     cgutils_rbtree * pending_transfers;
+    /* Inodes and directory entries cache, NULL if disabled */
+    cg_storage_inode_cache * inode_cache;
     /* Filesystem Name */
     char * name;
     /* Filesystem ID */
@@ -67,6 +70,9 @@ struct cg_storage_filesystem
     uint8_t full_threshold;
     /* IO block size */
     uint32_t io_block_size;
+    /* Time, in milliseconds, during which a client may reopen
+       a file read-only without asking us again */
+    uint32_t open_lease_duration;
     /* Delayed expunge settings */
     uint64_t delayed_expunge;
     unsigned int seed;
@@ -110,6 +110,15 @@ int cg_storage_filesystem_db_add_inode_instance(cg_storage_filesystem * fs,
                                                 cg_storage_instance_status status,
                                                 cg_storage_fs_cb_data * data);
 
+/* Returns ENOSYS if the DB backend does not support batches */
+int cg_storage_filesystem_db_add_inode_instances(cg_storage_filesystem * fs,
+                                                 uint64_t inode_number,
+                                                 uint64_t const * instances_ids,
+                                                 char const * const * ids_in_instance,
+                                                 size_t instances_count,
+                                                 cg_storage_instance_status status,
+                                                 cg_storage_fs_cb_data * data);
+
 int cg_storage_filesystem_db_set_inode_instance_delete_in_progress(cg_storage_filesystem * fs,
                                                                    cg_storage_fs_cb_data * data);
 
@@ -123,6 +132,23 @@ int cg_storage_filesystem_db_get_dir_entries_by_inode(cg_storage_filesystem * fs
                                                       uint64_t inode,
                                                       cg_storage_fs_cb_data * data);
 
+int cg_storage_filesystem_db_get_dir_entries_page_by_inode(cg_storage_filesystem * fs,
+                                                           uint64_t inode,
+                                                           uint64_t after_entry_id,
+                                                           size_t max_entries,
+                                                           cg_storage_fs_cb_data * data);
+
+int cg_storage_filesystem_db_get_inodes_info_multi(cg_storage_filesystem * fs,
+                                                   uint64_t const * inodes,
+                                                   size_t inodes_count,
+                                                   cg_storage_fs_cb_data * data);
+
+int cg_storage_filesystem_db_get_children_inodes_info_multi(cg_storage_filesystem * fs,
+                                                            uint64_t parent,
+                                                            char const * const * names,
+                                                            size_t names_count,
+                                                            cg_storage_fs_cb_data * data);
+
 int cg_storage_filesystem_db_update_cache_status(cg_storage_filesystem * fs,
                                                  uint64_t inode_number,
                                                  bool in_cache,
@@ -166,6 +192,14 @@ int cg_storage_filesystem_db_set_inode_dirty(cg_storage_filesystem * fs,
                                              time_t last_modification,
                                              cg_storage_fs_cb_data * data);
 
+int cg_storage_filesystem_db_set_inodes_dirty_multi(cg_storage_filesystem * fs,
+                                                    uint64_t const * inodes,
+                                                    size_t inodes_count,
+                                                    time_t mtime,
+                                                    time_t ctime,
+                                                    time_t last_modification,
+                                                    cg_storage_fs_cb_data * data);
+
 int cg_storage_filesystem_db_update_cache_and_dirty_writers_status(cg_storage_filesystem * fs,
                                                                    uint64_t inode_number,
                                                                    bool in_cache,
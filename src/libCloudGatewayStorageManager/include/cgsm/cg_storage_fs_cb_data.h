@@ -116,6 +116,9 @@ void cg_storage_fs_cb_data_set_inode_number(cg_storage_fs_cb_data * this,
 void cg_storage_fs_cb_data_set_parent_inode_number(cg_storage_fs_cb_data * this,
                                                    uint64_t inode_number);
 
+void cg_storage_fs_cb_data_set_inode_cache_generation(cg_storage_fs_cb_data * this,
+                                                      uint64_t generation);
+
 void cg_storage_fs_cb_data_set_state(cg_storage_fs_cb_data * this,
                                      cg_storage_filesystem_handler_state state);
 
@@ -168,6 +171,7 @@ size_t cg_storage_fs_cb_data_get_entries_count(cg_storage_fs_cb_data const * thi
 
 uint64_t cg_storage_fs_cb_data_get_inode_number(cg_storage_fs_cb_data const * this);
 uint64_t cg_storage_fs_cb_data_get_parent_inode_number(cg_storage_fs_cb_data const * this);
+uint64_t cg_storage_fs_cb_data_get_inode_cache_generation(cg_storage_fs_cb_data const * this);
 
 int cg_storage_fs_cb_data_get_fd(cg_storage_fs_cb_data const * this);
 
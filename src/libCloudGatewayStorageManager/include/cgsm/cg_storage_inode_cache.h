@@ -0,0 +1,95 @@
+/*
+ * This file is part of Nuage Labs SAS's Cloud Gateway.
+ *
+ * Copyright (C) 2011-2017  Nuage Labs SAS
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * In addition, for the avoidance of any doubt, permission is granted to
+ * link this program with OpenSSL and to (re)distribute the binaries
+ * produced as the result of such linking.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef CLOUD_GATEWAY_STORAGE_INODE_CACHE_H_
+#define CLOUD_GATEWAY_STORAGE_INODE_CACHE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <cgdb/cgdb.h>
+
+/* Bounded, in-process cache of inodes and directory entries fetched
+   from the database. Entries expire after a configurable delay, because
+   other processes may update the database behind our back.
+
+   Every database update touching an inode or an entry has to be wrapped
+   between mutation_begin() and mutation_end(). No value is inserted while
+   a mutation is in flight, nor if a mutation has started since the
+   lookup that produced it, so a stale result can never be cached. */
+typedef struct cg_storage_inode_cache cg_storage_inode_cache;
+
+typedef struct
+{
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t insertions;
+    uint64_t evictions;
+    uint64_t invalidations;
+} cg_storage_inode_cache_stats;
+
+int cg_storage_inode_cache_init(size_t max_entries,
+                                uint64_t ttl_ms,
+                                cg_storage_inode_cache ** out);
+
+void cg_storage_inode_cache_free(cg_storage_inode_cache * this);
+
+/* The returned inode is owned by the cache and only valid until
+   the next call modifying it. Returns ENOENT on a miss. */
+int cg_storage_inode_cache_get(cg_storage_inode_cache * this,
+                               uint64_t inode_number,
+                               cgdb_inode const ** inode);
+
+int cg_storage_inode_cache_get_child(cg_storage_inode_cache * this,
+                                     uint64_t parent_inode_number,
+                                     char const * name,
+                                     cgdb_inode const ** inode);
+
+/* To be retrieved before issuing the lookup, and passed to add(). */
+uint64_t cg_storage_inode_cache_get_generation(cg_storage_inode_cache const * this);
+
+void cg_storage_inode_cache_add(cg_storage_inode_cache * this,
+                                uint64_t generation,
+                                cgdb_inode const * inode);
+
+void cg_storage_inode_cache_add_child(cg_storage_inode_cache * this,
+                                      uint64_t generation,
+                                      uint64_t parent_inode_number,
+                                      char const * name,
+                                      cgdb_inode const * inode);
+
+void cg_storage_inode_cache_invalidate(cg_storage_inode_cache * this,
+                                       uint64_t inode_number);
+
+/* Also invalidates the inode the entry points to, if known. */
+void cg_storage_inode_cache_invalidate_child(cg_storage_inode_cache * this,
+                                             uint64_t parent_inode_number,
+                                             char const * name);
+
+void cg_storage_inode_cache_mutation_begin(cg_storage_inode_cache * this);
+void cg_storage_inode_cache_mutation_end(cg_storage_inode_cache * this);
+
+void cg_storage_inode_cache_get_stats(cg_storage_inode_cache const * this,
+                                      cg_storage_inode_cache_stats * stats);
+
+#endif /* CLOUD_GATEWAY_STORAGE_INODE_CACHE_H_ */
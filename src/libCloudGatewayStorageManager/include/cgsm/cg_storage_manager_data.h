@@ -71,6 +71,7 @@ size_t cg_storage_manager_data_get_cleaner_delay(cg_storage_manager_data const *
 size_t cg_storage_manager_data_get_cleaner_db_slots(cg_storage_manager_data const * data) COMPILER_PURE_FUNCTION;
 
 size_t cg_storage_manager_data_get_syncer_delay(cg_storage_manager_data const * data) COMPILER_PURE_FUNCTION;
+size_t cg_storage_manager_data_get_syncer_safety_net_delay(cg_storage_manager_data const * data) COMPILER_PURE_FUNCTION;
 size_t cg_storage_manager_data_get_syncer_dirtyness_delay(cg_storage_manager_data const * data) COMPILER_PURE_FUNCTION;
 size_t cg_storage_manager_data_get_syncer_max_db_objects_per_call(cg_storage_manager_data const * data) COMPILER_PURE_FUNCTION;
 size_t cg_storage_manager_data_get_syncer_db_slots(cg_storage_manager_data const * data) COMPILER_PURE_FUNCTION;
@@ -80,6 +81,7 @@ size_t cg_storage_manager_data_get_checker_delay(cg_storage_manager_data const *
 bool cg_storage_manager_data_get_checker_checks_disabled(cg_storage_manager_data const * data) COMPILER_PURE_FUNCTION;
 
 size_t cg_storage_manager_data_get_max_requests_per_connection(cg_storage_manager_data const * data) COMPILER_PURE_FUNCTION;
+size_t cg_storage_manager_data_get_server_workers(cg_storage_manager_data const * data) COMPILER_PURE_FUNCTION;
 
 cgutils_configuration * cg_storage_manager_data_get_configuration(cg_storage_manager_data const *) COMPILER_PURE_FUNCTION;
 cgutils_event_data * cg_storage_manager_data_get_event(cg_storage_manager_data const * data) COMPILER_PURE_FUNCTION;
@@ -42,6 +42,39 @@ typedef int64_t cgsm_proto_offset_type;
 typedef struct timespec cgsm_proto_timespec_type;
 typedef uint8_t cgsm_proto_size_changed_type;
 typedef uint8_t cgsm_proto_dirty_type;
+/* entry ID after which a paginated readdir resumes, 0 for the first page */
+typedef uint64_t cgsm_proto_dir_cursor_type;
+/* maximum number of entries returned by a paginated readdir */
+typedef uint32_t cgsm_proto_dir_page_size_type;
+/* number of keys of a _multi request, each key getting its own
+   response code and stat in the response */
+typedef uint32_t cgsm_proto_batch_size_type;
+/* sent by low_open_leased and low_open_fd_leased right after the response code:
+   time, in milliseconds, during which the client may reopen the file
+   read-only without asking again, as long as it does not see the inode
+   change. 0 means no lease. */
+typedef uint32_t cgsm_proto_lease_type;
+/* multiplexed connections: each frame is made of the request ID,
+   the payload size and the payload (opcode and parameters, or response) */
+typedef uint64_t cgsm_proto_request_id_type;
+typedef uint32_t cgsm_proto_frame_size_type;
+
+#define CGSM_PROTO_FRAME_HEADER_SIZE (sizeof (cgsm_proto_request_id_type) + sizeof (cgsm_proto_frame_size_type))
+
+/* multiplex_ring: the frames go through a shared memory segment holding
+   the request ring then the response ring, each of that capacity.
+   The capacity is followed by the segment name length (size_t), the name,
+   then the eventfds, in the order below. */
+typedef uint64_t cgsm_proto_ring_size_type;
+
+typedef enum
+{
+    cgsm_proto_ring_fd_request_data = 0,
+    cgsm_proto_ring_fd_request_space,
+    cgsm_proto_ring_fd_response_data,
+    cgsm_proto_ring_fd_response_space,
+    cgsm_proto_ring_fd_count
+} cgsm_proto_ring_fd;
 
 COMPILER_STATIC_ASSERT(sizeof(cgsm_proto_mode_type) >= sizeof(mode_t),
                        "cgsm_proto_mode_type is not large enough for mode_t");
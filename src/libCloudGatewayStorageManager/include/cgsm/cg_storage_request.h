@@ -31,6 +31,7 @@ int cg_storage_request_cb_low_lookup_child(cg_storage_request * request);
 int cg_storage_request_cb_low_getattr(cg_storage_request * request);
 int cg_storage_request_cb_low_setattr(cg_storage_request * request);
 int cg_storage_request_cb_low_readdir(cg_storage_request * request);
+int cg_storage_request_cb_low_readdir_page(cg_storage_request * request);
 int cg_storage_request_cb_low_create_and_open(cg_storage_request * request);
 int cg_storage_request_cb_low_open(cg_storage_request * request);
 int cg_storage_request_cb_low_notify_write(cg_storage_request * request);
@@ -42,5 +43,14 @@ int cg_storage_request_cb_low_rename(cg_storage_request * request);
 int cg_storage_request_cb_low_hardlink(cg_storage_request * request);
 int cg_storage_request_cb_low_symlink(cg_storage_request * request);
 int cg_storage_request_cb_low_readlink(cg_storage_request * request);
+int cg_storage_request_cb_multiplex(cg_storage_request * request);
+int cg_storage_request_cb_low_open_fd(cg_storage_request * request);
+int cg_storage_request_cb_low_create_and_open_fd(cg_storage_request * request);
+int cg_storage_request_cb_low_getattr_multi(cg_storage_request * request);
+int cg_storage_request_cb_low_lookup_child_multi(cg_storage_request * request);
+int cg_storage_request_cb_multiplex_ring(cg_storage_request * request);
+int cg_storage_request_cb_low_notify_write_multi(cg_storage_request * request);
+int cg_storage_request_cb_low_open_leased(cg_storage_request * request);
+int cg_storage_request_cb_low_open_fd_leased(cg_storage_request * request);
 
 #endif /* CLOUD_GATEWAY_STORAGE_REQUEST_H_ */
@@ -22,21 +22,29 @@
  */
 
 #include <errno.h>
+#include <inttypes.h>
 #include <string.h>
+#include <unistd.h>
+
+#include <sys/eventfd.h>
 
 #include <cgsmclient/cgsmc_async.h>
 #include <cgsmclient/cgsmc_async_connection.h>
 
 #include <cloudutils/cloudutils.h>
+#include <cloudutils/cloudutils_arena.h>
 #include <cloudutils/cloudutils_configuration.h>
 #include <cloudutils/cloudutils_event.h>
+#include <cloudutils/cloudutils_file.h>
 #include <cloudutils/cloudutils_network.h>
 #include <cloudutils/cloudutils_pool.h>
-#include <cloudutils/cloudutils_vector.h>
+#include <cloudutils/cloudutils_ring.h>
+#include <cloudutils/cloudutils_shared_memory_segment.h>
 
 #include <cgsm/cg_storage_manager_proto.h>
 
 typedef struct cgsmc_async_request cgsmc_async_request;
+typedef struct cgsmc_async_mux cgsmc_async_mux;
 
 typedef void (cgsmc_async_response_cb)(cgsmc_async_request *);
 
@@ -52,7 +60,7 @@ typedef enum
     cgsmc_async_request_type_lookup_child,
     cgsmc_async_request_type_getattr,
     cgsmc_async_request_type_setattr,
-    cgsmc_async_request_type_readdir,
+    cgsmc_async_request_type_readdir_page,
     cgsmc_async_request_type_create_and_open,
     cgsmc_async_request_type_open,
     cgsmc_async_request_type_release,
@@ -64,6 +72,9 @@ typedef enum
     cgsmc_async_request_type_hardlink,
     cgsmc_async_request_type_symlink,
     cgsmc_async_request_type_readlink,
+    cgsmc_async_request_type_getattr_multi,
+    cgsmc_async_request_type_lookup_child_multi,
+    cgsmc_async_request_type_notify_write_multi,
     cgsmc_async_request_type_count
 } cgsmc_async_request_type;
 
@@ -78,12 +89,18 @@ typedef enum
 
 struct cgsmc_async_request
 {
+    /* the request itself and everything it does not hand over
+       to the caller are allocated from there */
+    cgutils_arena * arena;
     cgsmc_async_data * data;
     cgsmc_async_connection * conn;
+    /* multiplexed mode, instead of conn */
+    cgsmc_async_mux * mux;
+    cgsm_proto_request_id_type mux_id;
     union
     {
         cgsmc_async_stat_cb * stat_cb;
-        cgsmc_async_readdir_cb * readdir_cb;
+        cgsmc_async_readdir_page_cb * readdir_page_cb;
         cgsmc_async_create_and_open_cb * create_and_open_cb;
         cgsmc_async_open_cb * open_cb;
         cgsmc_async_status_cb * status_cb;
@@ -98,9 +115,11 @@ struct cgsmc_async_request
     /* Buffered IOs */
     cgutils_event_buffered_io * io;
 
-    /* vector of half set up cgutils_event_buffered_io_obj * */
-    cgutils_vector * write_ios;
-    cgutils_vector * read_ios;
+    /* half set up cgutils_event_buffered_io_obj */
+    cgutils_event_buffered_io_obj * write_ios;
+    cgutils_event_buffered_io_obj * read_ios;
+    size_t write_ios_count;
+    size_t read_ios_count;
 
     /* optional request fields */
     char const * name;
@@ -119,11 +138,20 @@ struct cgsmc_async_request
     struct stat * st;
     char * path_in_cache;
     size_t path_in_cache_len;
+    /* file in cache passed by the storage manager, -1 if none */
+    int fd_in_cache;
+    /* open lease granted by the storage manager, in milliseconds */
+    cgsm_proto_lease_type lease;
 
     cgsmc_async_entry * entries;
     size_t expected_entries_count;
     size_t entries_count;
 
+    /* paginated readdir */
+    cgsm_proto_dir_cursor_type dir_cursor;
+    cgsm_proto_dir_cursor_type next_dir_cursor;
+    cgsm_proto_dir_page_size_type dir_page_size;
+
     size_t retry_count;
     cgsm_proto_opcode_type opcode;
     cgsmc_async_request_type type;
@@ -134,7 +162,56 @@ struct cgsmc_async_request
 
     cgsmc_async_request_state state;
 
+    /* _multi requests: the coalesced requests, in the order
+       of their keys, and the response to each key */
+    cgsmc_async_request ** batch;
+    uint64_t * batch_inodes;
+    char * batch_names;
+    size_t batch_names_len;
+    cgsm_proto_response_code * batch_codes;
+    struct stat * batch_st;
+    cgsm_proto_batch_size_type batch_size;
+
     bool io_error;
+    /* open using the _fd opcodes */
+    bool pass_fd;
+    /* open using the _leased opcodes */
+    bool want_lease;
+};
+
+/* A connection carrying the requests of several cgsmc_async_request,
+   each of them writing to and reading from a memory-backed IO.
+   Frames are made of the request ID, the payload size and the payload,
+   responses being matched to requests by their ID. */
+struct cgsmc_async_mux
+{
+    cgsmc_async_data * data;
+    cgsmc_async_connection * conn;
+    /* responses are read from read_io while requests are written to write_io,
+       so that they do not wait behind the read of the next response */
+    cgutils_event_buffered_io * read_io;
+    cgutils_event_buffered_io * write_io;
+    /* cgsmc_async_request * waiting for their response */
+    cgutils_llist * pending;
+    char * frame;
+    size_t slot;
+    cgsm_proto_request_id_type next_id;
+    cgsm_proto_request_id_type frame_id;
+    cgsm_proto_frame_size_type frame_size;
+    cgsm_proto_opcode_type opcode;
+    cgsm_proto_response_code response_code;
+    /* Shared memory rings: read_io and write_io go through them, sock_io
+       carrying the setup then watching for the storage manager going away.
+       ring_name is freed once the storage manager has attached the segment. */
+    cloudutils_shared_memory_segment_handler * ring_segment;
+    cgutils_ring * request_ring;
+    cgutils_ring * response_ring;
+    cgutils_event_buffered_io * sock_io;
+    char * ring_name;
+    size_t ring_name_len;
+    cgsm_proto_ring_size_type ring_size;
+    int ring_fds[cgsm_proto_ring_fd_count];
+    char hangup;
 };
 
 struct cgsmc_async_data
@@ -160,17 +237,51 @@ struct cgsmc_async_data
     /* Maximum pooled connections */
     size_t max_pooled_connections;
 
+    /* Number of multiplexed connections, each of them
+       carrying many concurrent requests. 0 means that
+       each request uses a connection of its own. */
+    size_t mux_connections;
+    size_t next_mux;
+    /* mux_connections entries, NULL when not connected */
+    cgsmc_async_mux ** muxes;
+
+    /* Capacity of the shared memory rings carrying the frames
+       of the multiplexed connections instead of their socket.
+       0 means that the socket is used. */
+    size_t ring_size;
+    /* used to name the shared memory segments */
+    uint64_t rings_count;
+
     size_t dirtyness_delay;
 
-    /* Minimum number of entries in a readdir response
-       triggering the use of a dir index
-    */
-    size_t dir_index_limit;
+    /* Maximum number of entries requested
+       by a paginated readdir */
+    size_t readdir_page_size;
 
     /* Maximum number of times we are allowed
        to retry a failed connection to the Storage Manager */
     size_t max_retry_count;
 
+    /* getattr and lookup requests issued during the same loop
+       iteration are sent together using the _multi opcodes,
+       up to that many at once. 0 or 1 disables batching. */
+    size_t metadata_batch_size;
+    cgsmc_async_request ** pending_getattrs;
+    size_t pending_getattrs_count;
+    /* lookups of a batch share the same parent */
+    cgsmc_async_request ** pending_lookups;
+    size_t pending_lookups_count;
+    /* fires at the next loop iteration to send the pending requests */
+    cgutils_event * batch_event;
+
+    /* Get the files in cache as descriptors passed
+       over the socket, instead of their paths.
+       Not available on multiplexed connections. */
+    bool pass_fds;
+    /* Ask for read-only open leases, the storage
+       manager needs to support the _leased opcodes. */
+    bool open_leases;
+
     /* Connection validity time:
        connection established after that time
        are no longer valid.
@@ -182,14 +293,25 @@ struct cgsmc_async_data
 #define CGSMC_ASYNC_MAX_CONNECTION_IDLE_TIME_DEFAULT (120)
 #define CGSMC_ASYNC_MAX_REQUESTS_PER_CONNECTION_DEFAULT (1000)
 #define CGSMC_ASYNC_MAX_RETRY_COUNT_DEFAULT (3)
+#define CGSMC_ASYNC_MUX_CONNECTIONS_DEFAULT (0)
+#define CGSMC_ASYNC_RING_SIZE_DEFAULT (0)
+/* the storage manager rejects larger rings */
+#define CGSMC_ASYNC_RING_SIZE_MAX (64 * 1024 * 1024)
+#define CGSMC_ASYNC_PASS_FDS_DEFAULT (true)
 
 #define CGSMC_ASYNC_DIRTYNESS_DELAY_DEFAULT (10)
 
+/* enough for the request, its IO objects and a small batch */
+#define CGSMC_ASYNC_REQUEST_ARENA_BLOCK_SIZE (2048)
+
 #define CGSMC_ASYNC_NAME_MAX_DEFAULT (255)  /* NAME_MAX */
 #define CGSMC_ASYNC_PATH_MAX_DEFAULT (1024) /* PATH_MAX */
 #define CGSMC_ASYNC_SYMLINK_MAX_DEFAULT (0) /* SYMLINK_MAX */
 
-#define CGSMC_ASYNC_DIR_INDEX_LIMIT_DEFAULT (10000)
+#define CGSMC_ASYNC_READDIR_PAGE_SIZE_DEFAULT (1024)
+#define CGSMC_ASYNC_METADATA_BATCH_SIZE_DEFAULT (64)
+/* the storage manager rejects larger batches */
+#define CGSMC_ASYNC_METADATA_BATCH_SIZE_MAX (256)
 
 void cgsmc_async_entry_clean(cgsmc_async_entry * const this)
 {
@@ -239,11 +361,53 @@ static int cgsmc_async_load_parameters_from_configuration(cgsmc_async_data * con
     GET_SIZE_CONF("MaxConnectionIdleTime", this->max_connection_idle_time, CGSMC_ASYNC_MAX_CONNECTION_IDLE_TIME_DEFAULT);
     GET_SIZE_CONF("MaxRequestsPerConnection", this->max_requests_per_connection, CGSMC_ASYNC_MAX_REQUESTS_PER_CONNECTION_DEFAULT);
     GET_SIZE_CONF("RetryCount", this->max_retry_count, CGSMC_ASYNC_MAX_RETRY_COUNT_DEFAULT);
+    GET_SIZE_CONF("MultiplexedConnections", this->mux_connections, CGSMC_ASYNC_MUX_CONNECTIONS_DEFAULT);
+    GET_SIZE_CONF("SharedMemoryRingSize", this->ring_size, CGSMC_ASYNC_RING_SIZE_DEFAULT);
     GET_SIZE_CONF("DirtynessDelay", this->dirtyness_delay, CGSMC_ASYNC_DIRTYNESS_DELAY_DEFAULT);
     GET_SIZE_CONF("PathMax", this->path_max, CGSMC_ASYNC_PATH_MAX_DEFAULT);
     GET_SIZE_CONF("NameMax", this->name_max, CGSMC_ASYNC_NAME_MAX_DEFAULT);
     GET_SIZE_CONF("SymlinkMax", this->symlink_max, CGSMC_ASYNC_SYMLINK_MAX_DEFAULT);
-    GET_SIZE_CONF("DirIndexLimit", this->dir_index_limit, CGSMC_ASYNC_DIR_INDEX_LIMIT_DEFAULT);
+    GET_SIZE_CONF("ReaddirPageSize", this->readdir_page_size, CGSMC_ASYNC_READDIR_PAGE_SIZE_DEFAULT);
+    GET_SIZE_CONF("MetadataBatchSize", this->metadata_batch_size, CGSMC_ASYNC_METADATA_BATCH_SIZE_DEFAULT);
+
+    result = cgutils_configuration_get_boolean(configuration,
+                                               "PassFileDescriptors",
+                                               &(this->pass_fds));
+
+    if (result != 0)
+    {
+        this->pass_fds = CGSMC_ASYNC_PASS_FDS_DEFAULT;
+
+        if (result != ENOENT)
+        {
+            CGUTILS_WARN("Invalid value found for %s, using the default.", "PassFileDescriptors");
+        }
+    }
+
+    if (this->readdir_page_size == 0)
+    {
+        this->readdir_page_size = CGSMC_ASYNC_READDIR_PAGE_SIZE_DEFAULT;
+    }
+    else if (this->readdir_page_size > UINT32_MAX)
+    {
+        /* sent as a cgsm_proto_dir_page_size_type */
+        this->readdir_page_size = UINT32_MAX;
+    }
+
+    if (this->metadata_batch_size > CGSMC_ASYNC_METADATA_BATCH_SIZE_MAX)
+    {
+        this->metadata_batch_size = CGSMC_ASYNC_METADATA_BATCH_SIZE_MAX;
+    }
+
+    if (this->ring_size > 0 &&
+        (this->mux_connections == 0 ||
+         this->ring_size > CGSMC_ASYNC_RING_SIZE_MAX ||
+         cgutils_ring_get_memory_size(this->ring_size) == 0))
+    {
+        CGUTILS_WARN("SharedMemoryRingSize has to be a power of two no larger than %d and requires MultiplexedConnections, using the socket.",
+                     CGSMC_ASYNC_RING_SIZE_MAX);
+        this->ring_size = 0;
+    }
 
     return 0;
 }
@@ -378,6 +542,44 @@ static int cgsm_async_load_configuration(cgsmc_async_data * const this,
     return result;
 }
 
+static void cgsmc_async_request_free(cgsmc_async_request * req);
+
+static void cgsmc_async_batch_flush_cb(void * cb_data);
+
+static int cgsmc_async_batch_init(cgsmc_async_data * const this)
+{
+    int result = 0;
+    CGUTILS_ASSERT(this != NULL);
+    CGUTILS_ASSERT(this->metadata_batch_size > 1);
+
+    CGUTILS_MALLOC(this->pending_getattrs, this->metadata_batch_size, sizeof *(this->pending_getattrs));
+    CGUTILS_MALLOC(this->pending_lookups, this->metadata_batch_size, sizeof *(this->pending_lookups));
+
+    if (COMPILER_LIKELY(this->pending_getattrs != NULL &&
+                        this->pending_lookups != NULL))
+    {
+        result = cgutils_event_create_timer_event(this->event_data,
+                                                  0,
+                                                  &cgsmc_async_batch_flush_cb,
+                                                  this,
+                                                  &(this->batch_event));
+
+        if (COMPILER_UNLIKELY(result != 0))
+        {
+            CGUTILS_ERROR("Error creating batch timer event: %d",
+                          result);
+        }
+    }
+    else
+    {
+        result = ENOMEM;
+        CGUTILS_ERROR("Error allocating pending batches: %d",
+                      result);
+    }
+
+    return result;
+}
+
 int cgsmc_async_data_init(char const * const fs_name,
                           char const * const configuration_file_path,
                           cgutils_event_data * const event_data,
@@ -420,7 +622,37 @@ int cgsmc_async_data_init(char const * const fs_name,
 
                     this->event_data = event_data;
 
-                    *out = this;
+                    if (this->mux_connections > 0)
+                    {
+                        CGUTILS_MALLOC(this->muxes, this->mux_connections, sizeof *(this->muxes));
+
+                        if (this->muxes != NULL)
+                        {
+                            for (size_t idx = 0;
+                                 idx < this->mux_connections;
+                                 idx++)
+                            {
+                                this->muxes[idx] = NULL;
+                            }
+                        }
+                        else
+                        {
+                            result = ENOMEM;
+                            CGUTILS_ERROR("Error allocating multiplexed connections: %d",
+                                          result);
+                        }
+                    }
+
+                    if (result == 0 &&
+                        this->metadata_batch_size > 1)
+                    {
+                        result = cgsmc_async_batch_init(this);
+                    }
+
+                    if (result == 0)
+                    {
+                        *out = this;
+                    }
                 }
                 else
                 {
@@ -461,10 +693,137 @@ int cgsmc_async_data_init(char const * const fs_name,
     return result;
 }
 
+static void cgsmc_async_mux_free(cgsmc_async_mux * mux)
+{
+    if (mux != NULL)
+    {
+        if (mux->read_io != NULL)
+        {
+            cgutils_event_buffered_io_release(mux->read_io), mux->read_io = NULL;
+        }
+
+        if (mux->write_io != NULL)
+        {
+            cgutils_event_buffered_io_release(mux->write_io), mux->write_io = NULL;
+        }
+
+        if (mux->sock_io != NULL)
+        {
+            cgutils_event_buffered_io_release(mux->sock_io), mux->sock_io = NULL;
+        }
+
+        if (mux->request_ring != NULL)
+        {
+            cgutils_ring_free(mux->request_ring), mux->request_ring = NULL;
+        }
+
+        if (mux->response_ring != NULL)
+        {
+            cgutils_ring_free(mux->response_ring), mux->response_ring = NULL;
+        }
+
+        if (mux->ring_segment != NULL)
+        {
+            if (mux->ring_name != NULL)
+            {
+                cloudutils_shared_memory_segment_handler_unlink(mux->ring_segment);
+            }
+
+            cloudutils_shared_memory_segment_handler_detach(mux->ring_segment), mux->ring_segment = NULL;
+        }
+
+        for (size_t idx = 0;
+             idx < cgsm_proto_ring_fd_count;
+             idx++)
+        {
+            if (mux->ring_fds[idx] != -1)
+            {
+                cgutils_file_close(mux->ring_fds[idx]), mux->ring_fds[idx] = -1;
+            }
+        }
+
+        CGUTILS_FREE(mux->ring_name);
+
+        if (mux->pending != NULL)
+        {
+            for (cgutils_llist_elt * elt = cgutils_llist_get_iterator(mux->pending);
+                 elt != NULL;
+                 elt = cgutils_llist_elt_get_next(elt))
+            {
+                cgsmc_async_request * req = cgutils_llist_elt_get_object(elt);
+                CGUTILS_ASSERT(req != NULL);
+                req->mux = NULL;
+            }
+
+            cgutils_llist_free(&(mux->pending), NULL);
+        }
+
+        if (mux->conn != NULL)
+        {
+            cgsmc_async_connection_free(mux->conn), mux->conn = NULL;
+        }
+
+        CGUTILS_FREE(mux->frame);
+        mux->data = NULL;
+
+        CGUTILS_FREE(mux);
+    }
+}
+
+static void cgsmc_async_mux_detach(cgsmc_async_request * const req)
+{
+    CGUTILS_ASSERT(req != NULL);
+
+    if (req->mux != NULL)
+    {
+        /* not there anymore if the response has been received */
+        cgutils_llist_remove_by_object(req->mux->pending,
+                                       req);
+        req->mux = NULL;
+    }
+}
+
 void cgsmc_async_data_free(cgsmc_async_data * this)
 {
     if (this != NULL)
     {
+        if (this->batch_event != NULL)
+        {
+            cgutils_event_free(this->batch_event), this->batch_event = NULL;
+        }
+
+        /* never sent, their callbacks will not be called */
+        for (size_t idx = 0;
+             idx < this->pending_getattrs_count;
+             idx++)
+        {
+            cgsmc_async_request_free(this->pending_getattrs[idx]), this->pending_getattrs[idx] = NULL;
+        }
+
+        for (size_t idx = 0;
+             idx < this->pending_lookups_count;
+             idx++)
+        {
+            cgsmc_async_request_free(this->pending_lookups[idx]), this->pending_lookups[idx] = NULL;
+        }
+
+        this->pending_getattrs_count = 0;
+        this->pending_lookups_count = 0;
+        CGUTILS_FREE(this->pending_getattrs);
+        CGUTILS_FREE(this->pending_lookups);
+
+        if (this->muxes != NULL)
+        {
+            for (size_t idx = 0;
+                 idx < this->mux_connections;
+                 idx++)
+            {
+                cgsmc_async_mux_free(this->muxes[idx]), this->muxes[idx] = NULL;
+            }
+
+            CGUTILS_FREE(this->muxes);
+        }
+
         if (this->connections != NULL)
         {
             cgutils_pool_free(this->connections), this->connections = NULL;
@@ -504,14 +863,27 @@ static void cgsmc_async_request_compute_opcode(cgsmc_async_request * const req)
     case cgsmc_async_request_type_setattr:
         req->opcode = cgsm_proto_opcode_low_setattr;
         break;
-    case cgsmc_async_request_type_readdir:
-        req->opcode = cgsm_proto_opcode_low_readdir;
+    case cgsmc_async_request_type_readdir_page:
+        req->opcode = cgsm_proto_opcode_low_readdir_page;
         break;
     case cgsmc_async_request_type_create_and_open:
-        req->opcode = cgsm_proto_opcode_low_create_and_open;
+        req->opcode = req->pass_fd == true ?
+            cgsm_proto_opcode_low_create_and_open_fd :
+            cgsm_proto_opcode_low_create_and_open;
         break;
     case cgsmc_async_request_type_open:
-        req->opcode = cgsm_proto_opcode_low_open;
+        if (req->want_lease == true)
+        {
+            req->opcode = req->pass_fd == true ?
+                cgsm_proto_opcode_low_open_fd_leased :
+                cgsm_proto_opcode_low_open_leased;
+        }
+        else
+        {
+            req->opcode = req->pass_fd == true ?
+                cgsm_proto_opcode_low_open_fd :
+                cgsm_proto_opcode_low_open;
+        }
         break;
     case cgsmc_async_request_type_release:
         req->opcode = cgsm_proto_opcode_low_release;
@@ -540,6 +912,15 @@ static void cgsmc_async_request_compute_opcode(cgsmc_async_request * const req)
     case cgsmc_async_request_type_readlink:
         req->opcode = cgsm_proto_opcode_low_readlink;
         break;
+    case cgsmc_async_request_type_getattr_multi:
+        req->opcode = cgsm_proto_opcode_low_getattr_multi;
+        break;
+    case cgsmc_async_request_type_lookup_child_multi:
+        req->opcode = cgsm_proto_opcode_low_lookup_child_multi;
+        break;
+    case cgsmc_async_request_type_notify_write_multi:
+        req->opcode = cgsm_proto_opcode_low_notify_write_multi;
+        break;
     case cgsmc_async_request_type_none:
     case cgsmc_async_request_type_count:
         CGUTILS_ERROR("Invalid type %d",
@@ -599,19 +980,19 @@ static void cgsmc_async_request_free(cgsmc_async_request * req)
         CGUTILS_FREE(req->path_in_cache);
         req->path_in_cache_len = 0;
 
-        if (req->io != NULL)
-        {
-            cgutils_event_buffered_io_release(req->io), req->io = NULL;
-        }
+        /* the coalesced requests are freed when dispatching the response,
+           the batch arrays live in the arena */
+        req->batch_names_len = 0;
+        req->batch_size = 0;
 
-        if (req->write_ios != NULL)
+        if (req->fd_in_cache != -1)
         {
-            cgutils_vector_deep_free(&(req->write_ios), &free), req->write_ios = NULL;
+            cgutils_file_close(req->fd_in_cache), req->fd_in_cache = -1;
         }
 
-        if (req->read_ios != NULL)
+        if (req->io != NULL)
         {
-            cgutils_vector_deep_free(&(req->read_ios), &free), req->read_ios = NULL;
+            cgutils_event_buffered_io_release(req->io), req->io = NULL;
         }
 
         if (req->conn != NULL)
@@ -619,7 +1000,9 @@ static void cgsmc_async_request_free(cgsmc_async_request * req)
             cgsmc_async_request_release_connection(req), req->conn = NULL;
         }
 
-        CGUTILS_FREE(req);
+        cgsmc_async_mux_detach(req);
+
+        cgutils_arena_free(req->arena), req = NULL;
     }
 }
 
@@ -627,25 +1010,29 @@ static int cgsmc_async_request_init(cgsmc_async_data * data,
                                     cgsmc_async_request_type const type,
                                     cgsmc_async_request ** out)
 {
-    int result = 0;
-    cgsmc_async_request * req = NULL;
+    cgutils_arena * arena = NULL;
 
     CGUTILS_ASSERT(data != NULL);
     CGUTILS_ASSERT(out != NULL);
 
-    CGUTILS_ALLOCATE_STRUCT(req);
+    int result = cgutils_arena_init(CGSMC_ASYNC_REQUEST_ARENA_BLOCK_SIZE,
+                                    &arena);
 
-    if (COMPILER_LIKELY(req != NULL))
+    if (COMPILER_LIKELY(result == 0))
     {
+        cgsmc_async_request * req = NULL;
+
+        CGUTILS_ARENA_ALLOCATE_STRUCT(arena, req);
+        /* the first block is large enough */
+        CGUTILS_ASSERT(req != NULL);
+
+        req->arena = arena;
         req->data = data;
         req->type = type;
         req->state = cgsmc_async_request_state_none;
+        req->fd_in_cache = -1;
         *out = req;
     }
-    else
-    {
-        result = ENOMEM;
-    }
 
     return result;
 }
@@ -656,72 +1043,33 @@ static int cgsmc_async_request_add_ios_to_req(cgsmc_async_request * const req,
                                               size_t const io_objects_count)
 {
     int result = 0;
-    cgutils_vector * ios_vector = NULL;
     CGUTILS_ASSERT(req != NULL);
     CGUTILS_ASSERT(io_objects != NULL || io_objects_count == 0);
 
     if (COMPILER_LIKELY(io_objects_count > 0))
     {
-        result = cgutils_vector_init(io_objects_count,
-                                     &ios_vector);
+        cgutils_event_buffered_io_obj * const ios = cgutils_arena_memdup(req->arena,
+                                                                        io_objects,
+                                                                        io_objects_count * sizeof *io_objects);
 
-        if (COMPILER_LIKELY(result == 0))
+        if (COMPILER_LIKELY(ios != NULL))
         {
-            for (size_t idx = 0;
-                 result == 0 &&
-                     idx < io_objects_count;
-                 idx++)
-            {
-                cgutils_event_buffered_io_obj * obj = NULL;
-                CGUTILS_ALLOCATE_STRUCT(obj);
-
-                if (COMPILER_LIKELY(obj != NULL))
-                {
-                    *obj = io_objects[idx];
-
-                    result = cgutils_vector_add(ios_vector,
-                                                obj);
-
-                    if (COMPILER_LIKELY(result == 0))
-                    {
-                        obj = NULL;
-                    }
-                    else
-                    {
-                        CGUTILS_ERROR("Error adding IO object %zu to vector: %d",
-                                      idx,
-                                      result);
-                        CGUTILS_FREE(obj);
-                    }
-                }
-                else
-                {
-                    result = ENOMEM;
-                    CGUTILS_ERROR("Error allocating memory for IO object %zu: %d",
-                                  idx,
-                                  result);
-                }
-            }
-
-            if (COMPILER_LIKELY(result == 0))
+            if (io_type == cgsmc_async_request_io_type_read)
             {
-                if (io_type == cgsmc_async_request_io_type_read)
-                {
-                    req->read_ios = ios_vector;
-                }
-                else
-                {
-                    req->write_ios = ios_vector;
-                }
+                req->read_ios = ios;
+                req->read_ios_count = io_objects_count;
             }
             else
             {
-                cgutils_vector_deep_free(&ios_vector, &free);
+                req->write_ios = ios;
+                req->write_ios_count = io_objects_count;
             }
         }
         else
         {
-            CGUTILS_ERROR("Error allocating vector for IO objects: %d",
+            result = ENOMEM;
+            CGUTILS_ERROR("Error allocating memory for %zu IO objects: %d",
+                          io_objects_count,
                           result);
         }
     }
@@ -730,6 +1078,7 @@ static int cgsmc_async_request_add_ios_to_req(cgsmc_async_request * const req,
 }
 
 static int cgsmc_async_get_new_connection(cgsmc_async_request * const req);
+static int cgsmc_async_mux_send(cgsmc_async_request * const req);
 
 static void cgsmc_async_request_clean_for_reconnection(cgsmc_async_request * const req)
 {
@@ -738,12 +1087,18 @@ static void cgsmc_async_request_clean_for_reconnection(cgsmc_async_request * con
     /* do not even think about reusing that one */
     cgutils_event_buffered_io_release(req->io), req->io = NULL;
     cgsmc_async_connection_free(req->conn), req->conn = NULL;
+    cgsmc_async_mux_detach(req);
 
     req->state = cgsmc_async_request_state_none;
 
     CGUTILS_FREE(req->path_in_cache);
     req->path_in_cache_len = 0;
 
+    if (req->fd_in_cache != -1)
+    {
+        cgutils_file_close(req->fd_in_cache), req->fd_in_cache = -1;
+    }
+
     for (size_t idx = 0;
          idx < req->entries_count;
          idx++)
@@ -769,7 +1124,14 @@ static int cgsmc_async_request_retry(cgsmc_async_request * const req)
 
     cgsmc_async_request_clean_for_reconnection(req);
 
-    result = cgsmc_async_get_new_connection(req);
+    if (req->data->mux_connections > 0)
+    {
+        result = cgsmc_async_mux_send(req);
+    }
+    else
+    {
+        result = cgsmc_async_get_new_connection(req);
+    }
 
     if (result != 0)
     {
@@ -789,11 +1151,14 @@ static bool cgsmc_async_request_is_idempotent(cgsmc_async_request_type const typ
     switch (type)
     {
     case cgsmc_async_request_type_notify_write:
+    case cgsmc_async_request_type_notify_write_multi:
     case cgsmc_async_request_type_setattr:
     case cgsmc_async_request_type_lookup_child:
     case cgsmc_async_request_type_getattr:
     case cgsmc_async_request_type_readlink:
-    case cgsmc_async_request_type_readdir:
+    case cgsmc_async_request_type_readdir_page:
+    case cgsmc_async_request_type_getattr_multi:
+    case cgsmc_async_request_type_lookup_child_multi:
         result = true;
         break;
     default:
@@ -840,6 +1205,67 @@ static bool cgsmc_async_request_may_retry(cgsmc_async_request const * const req)
     return result;
 }
 
+/* Fails requests that were waiting to be sent in a batch */
+static void cgsmc_async_batch_fail(cgsmc_async_request * const * const members,
+                                   size_t const members_count,
+                                   int const status)
+{
+    CGUTILS_ASSERT(members != NULL);
+    CGUTILS_ASSERT(status != 0);
+
+    for (size_t idx = 0;
+         idx < members_count;
+         idx++)
+    {
+        cgsmc_async_request * member = members[idx];
+        CGUTILS_ASSERT(member != NULL);
+
+        (*(member->stat_cb))(status,
+                             NULL,
+                             member->cb_data);
+
+        cgsmc_async_request_free(member), member = NULL;
+    }
+}
+
+/* Hands its response to each of the requests coalesced into
+   a _multi one, or status if the whole batch failed. */
+static void cgsmc_async_batch_dispatch(cgsmc_async_request * const req,
+                                       int const status)
+{
+    CGUTILS_ASSERT(req != NULL);
+    CGUTILS_ASSERT(req->batch != NULL);
+
+    for (size_t idx = 0;
+         idx < req->batch_size;
+         idx++)
+    {
+        cgsmc_async_request * member = req->batch[idx];
+        CGUTILS_ASSERT(member != NULL);
+        CGUTILS_ASSERT(member->st != NULL);
+        int const code = status != 0 ? status : req->batch_codes[idx];
+
+        if (code == 0)
+        {
+            *(member->st) = req->batch_st[idx];
+
+            (*(member->stat_cb))(0,
+                                 member->st,
+                                 member->cb_data);
+
+            member->st = NULL;
+        }
+        else
+        {
+            (*(member->stat_cb))(code,
+                                 NULL,
+                                 member->cb_data);
+        }
+
+        cgsmc_async_request_free(member), req->batch[idx] = NULL;
+    }
+}
+
 static void cgsmc_async_request_error(cgsmc_async_request * req)
 {
     bool retry = false;
@@ -865,6 +1291,7 @@ static void cgsmc_async_request_error(cgsmc_async_request * req)
         {
         case cgsmc_async_request_type_release:
         case cgsmc_async_request_type_notify_write:
+        case cgsmc_async_request_type_notify_write_multi:
         case cgsmc_async_request_type_setattr:
             (*(req->status_cb))(req->result,
                                 req->cb_data);
@@ -879,22 +1306,25 @@ static void cgsmc_async_request_error(cgsmc_async_request * req)
                               NULL,
                               req->cb_data);
             break;
-        case cgsmc_async_request_type_readdir:
-            (*(req->readdir_cb))(req->result,
-                                 NULL,
-                                 0,
-                                 false,
-                                 req->cb_data);
+        case cgsmc_async_request_type_readdir_page:
+            (*(req->readdir_page_cb))(req->result,
+                                      NULL,
+                                      0,
+                                      0,
+                                      req->cb_data);
             break;
         case cgsmc_async_request_type_create_and_open:
             (*(req->create_and_open_cb))(req->result,
                                          NULL,
                                          NULL,
+                                         -1,
                                          req->cb_data);
             break;
         case cgsmc_async_request_type_open:
             (*(req->open_cb))(req->result,
                               NULL,
+                              -1,
+                              0,
                               req->cb_data);
             break;
         case cgsmc_async_request_type_rmdir:
@@ -909,6 +1339,10 @@ static void cgsmc_async_request_error(cgsmc_async_request * req)
                                                                     0,
                                                                     req->cb_data);
             break;
+        case cgsmc_async_request_type_getattr_multi:
+        case cgsmc_async_request_type_lookup_child_multi:
+            cgsmc_async_batch_dispatch(req, req->result);
+            break;
         case cgsmc_async_request_type_none:
         case cgsmc_async_request_type_count:
             CGUTILS_ERROR("Invalid type %d for request %p, with error %d",
@@ -936,6 +1370,7 @@ static void cgsmc_async_request_done(cgsmc_async_request * req)
         {
         case cgsmc_async_request_type_release:
         case cgsmc_async_request_type_notify_write:
+        case cgsmc_async_request_type_notify_write_multi:
         case cgsmc_async_request_type_setattr:
             (*(req->status_cb))(0,
                                 req->cb_data);
@@ -951,28 +1386,37 @@ static void cgsmc_async_request_done(cgsmc_async_request * req)
             req->st = NULL;
 
             break;
-        case cgsmc_async_request_type_readdir:
-            (*(req->readdir_cb))(0,
-                                 req->entries,
-                                 req->entries_count,
-                                 req->data->dir_index_limit > 0 &&
-                                 req->entries_count >= req->data->dir_index_limit,
-                                 req->cb_data);
+        case cgsmc_async_request_type_readdir_page:
+            (*(req->readdir_page_cb))(0,
+                                      req->entries,
+                                      req->entries_count,
+                                      req->next_dir_cursor,
+                                      req->cb_data);
             break;
         case cgsmc_async_request_type_create_and_open:
             (*(req->create_and_open_cb))(0,
                                          req->st,
                                          req->path_in_cache,
+                                         req->fd_in_cache,
                                          req->cb_data);
             req->st = NULL;
             req->path_in_cache = NULL;
+            req->fd_in_cache = -1;
             break;
         case cgsmc_async_request_type_open:
-        case cgsmc_async_request_type_readlink:
             (*(req->open_cb))(0,
                               req->path_in_cache,
+                              req->fd_in_cache,
+                              req->lease,
                               req->cb_data);
             req->path_in_cache = NULL;
+            req->fd_in_cache = -1;
+            break;
+        case cgsmc_async_request_type_readlink:
+            (*(req->readlink_cb))(0,
+                                  req->path_in_cache,
+                                  req->cb_data);
+            req->path_in_cache = NULL;
             break;
         case cgsmc_async_request_type_rmdir:
         case cgsmc_async_request_type_unlink:
@@ -986,6 +1430,10 @@ static void cgsmc_async_request_done(cgsmc_async_request * req)
                                                                     req->ino,
                                                                     req->cb_data);
             break;
+        case cgsmc_async_request_type_getattr_multi:
+        case cgsmc_async_request_type_lookup_child_multi:
+            cgsmc_async_batch_dispatch(req, 0);
+            break;
         case cgsmc_async_request_type_none:
         case cgsmc_async_request_type_count:
             CGUTILS_ERROR("Invalid type %d for request %p",
@@ -1042,15 +1490,17 @@ static int cgsmc_async_connection_add_iovec(cgsmc_async_request * const req,
 {
     int result = 0;
     CGUTILS_ASSERT(req != NULL);
-    cgutils_vector const * const vect = io_type == cgsmc_async_request_io_type_read ?
+    cgutils_event_buffered_io_obj * const ios = io_type == cgsmc_async_request_io_type_read ?
         req->read_ios :
         req->write_ios;
-    CGUTILS_ASSERT(vect != NULL);
+    CGUTILS_ASSERT(ios != NULL);
     cgutils_event_buffered_io_action const action = io_type == cgsmc_async_request_io_type_read ?
         cgutils_event_buffered_io_reading :
         cgutils_event_buffered_io_writing;
     size_t idx = 0;
-    size_t const ios_count = cgutils_vector_count(vect);
+    size_t const ios_count = io_type == cgsmc_async_request_io_type_read ?
+        req->read_ios_count :
+        req->write_ios_count;
 
 
     for (;
@@ -1058,32 +1508,23 @@ static int cgsmc_async_connection_add_iovec(cgsmc_async_request * const req,
              idx < ios_count;
          idx++)
     {
-        void * obj = NULL;
+        cgutils_event_buffered_io_obj * io_obj = &(ios[idx]);
+        io_obj->io = req->io;
+        io_obj->cb = &cgsmc_async_request_error_dispatching_cb;
+        io_obj->cb_data = req;
+        io_obj->action = action;
+        /* so we can reuse them after reconnection
+           if needed */
+        io_obj->do_not_free = true;
+
+        result = cgutils_event_buffered_io_add_obj(req->io,
+                                                   io_obj);
 
-        result = cgutils_vector_get(vect,
-                                    idx,
-                                    &obj);
-
-        if (COMPILER_LIKELY(result == 0))
+        if (COMPILER_UNLIKELY(result != 0))
         {
-            cgutils_event_buffered_io_obj * io_obj = obj;
-            io_obj->io = req->io;
-            io_obj->cb = &cgsmc_async_request_error_dispatching_cb;
-            io_obj->cb_data = req;
-            io_obj->action = action;
-            /* so we can reuse them after reconnection
-               if needed */
-            io_obj->do_not_free = true;
-
-            result = cgutils_event_buffered_io_add_obj(req->io,
-                                                       io_obj);
-
-            if (COMPILER_UNLIKELY(result != 0))
-            {
-                CGUTILS_ERROR("Error adding object %zu to IO queue: %d",
-                              idx,
-                              result);
-            }
+            CGUTILS_ERROR("Error adding object %zu to IO queue: %d",
+                          idx,
+                          result);
         }
     }
 
@@ -1163,7 +1604,7 @@ static void cgsmc_async_request_connection_ready(cgsmc_async_request * const req
     int result = 0;
 
     CGUTILS_ASSERT(req != NULL);
-    CGUTILS_ASSERT(req->conn != NULL);
+    CGUTILS_ASSERT(req->conn != NULL || req->mux != NULL);
 
     /* we've got ourselves a connection, bound to our FS ID */
     // send the request identifier
@@ -1239,16 +1680,830 @@ static void cgsmc_async_request_connection_ready(cgsmc_async_request * const req
     }
 }
 
-static int cgsmc_async_connection_setup_cb(cgutils_event_data * const event,
-                                           int const status,
-                                           int const fd,
-                                           cgutils_event_buffered_io_obj * const obj)
+static void cgsmc_async_mux_fail(cgsmc_async_mux * mux,
+                                 int const status)
 {
-    CGUTILS_ASSERT(event != NULL);
-    CGUTILS_ASSERT(fd != -1);
-    CGUTILS_ASSERT(obj != NULL);
-    cgsmc_async_request * const req = obj->cb_data;
-    CGUTILS_ASSERT(req != NULL);
+    CGUTILS_ASSERT(mux != NULL);
+    CGUTILS_ASSERT(status != 0);
+    cgsmc_async_data * const data = mux->data;
+    CGUTILS_ASSERT(data != NULL);
+    CGUTILS_ASSERT(mux->slot < data->mux_connections);
+
+    /* so that requests retried from here get a new connection */
+    if (data->muxes[mux->slot] == mux)
+    {
+        data->muxes[mux->slot] = NULL;
+    }
+
+    while (cgutils_llist_get_count(mux->pending) > 0)
+    {
+        cgutils_llist_elt * elt = cgutils_llist_get_iterator(mux->pending);
+        cgsmc_async_request * req = cgutils_llist_elt_get_object(elt);
+        CGUTILS_ASSERT(req != NULL);
+
+        cgutils_llist_remove(mux->pending, elt);
+        req->mux = NULL;
+
+        req->io_error = true;
+        req->result = status;
+        cgsmc_async_request_error(req), req = NULL;
+    }
+
+    cgsmc_async_mux_free(mux), mux = NULL;
+}
+
+static int cgsmc_async_mux_io_cb(cgutils_event_data * const event,
+                                 int const status,
+                                 int const fd,
+                                 cgutils_event_buffered_io_obj * const obj)
+{
+    CGUTILS_ASSERT(event != NULL);
+    CGUTILS_ASSERT(fd != -1);
+    CGUTILS_ASSERT(obj != NULL);
+    cgsmc_async_mux * const mux = obj->cb_data;
+    CGUTILS_ASSERT(mux != NULL);
+
+    (void) event;
+    (void) fd;
+
+    if (COMPILER_UNLIKELY(status != 0))
+    {
+        CGUTILS_ERROR("Error on multiplexed connection: %d",
+                      status);
+        cgsmc_async_mux_fail(mux, status);
+    }
+
+    return status;
+}
+
+static int cgsmc_async_mux_read_frame(cgsmc_async_mux * const mux);
+
+static int cgsmc_async_mux_got_frame_cb(cgutils_event_data * const event,
+                                        int const status,
+                                        int const fd,
+                                        cgutils_event_buffered_io_obj * const obj)
+{
+    int result = status;
+    CGUTILS_ASSERT(event != NULL);
+    CGUTILS_ASSERT(fd != -1);
+    CGUTILS_ASSERT(obj != NULL);
+    cgsmc_async_mux * const mux = obj->cb_data;
+    CGUTILS_ASSERT(mux != NULL);
+
+    (void) event;
+    (void) fd;
+
+    if (COMPILER_LIKELY(result == 0))
+    {
+        cgsmc_async_request * req = NULL;
+
+        /* responses usually come in order, so the request
+           is most likely near the head of the list */
+        for (cgutils_llist_elt * elt = cgutils_llist_get_iterator(mux->pending);
+             elt != NULL && req == NULL;
+             elt = cgutils_llist_elt_get_next(elt))
+        {
+            cgsmc_async_request * const pending_req = cgutils_llist_elt_get_object(elt);
+            CGUTILS_ASSERT(pending_req != NULL);
+
+            if (pending_req->mux_id == mux->frame_id)
+            {
+                req = pending_req;
+                cgutils_llist_remove(mux->pending, elt);
+            }
+        }
+
+        if (COMPILER_LIKELY(req != NULL))
+        {
+            if (COMPILER_LIKELY(mux->frame_size > 0))
+            {
+                /* the request reads its response from the frame */
+                result = cgutils_event_buffered_io_set_input(req->io,
+                                                             mux->frame,
+                                                             mux->frame_size);
+
+                if (COMPILER_LIKELY(result == 0))
+                {
+                    mux->frame = NULL;
+                }
+                else
+                {
+                    CGUTILS_ERROR("Error setting response as input: %d",
+                                  result);
+                }
+            }
+            else
+            {
+                /* the storage manager failed to handle this request */
+                result = EIO;
+            }
+
+            if (COMPILER_UNLIKELY(result != 0))
+            {
+                req->mux = NULL;
+                req->io_error = true;
+                req->result = result;
+                cgsmc_async_request_error(req), req = NULL;
+            }
+        }
+        else
+        {
+            CGUTILS_WARN("Discarding response to unknown request %"PRIu64,
+                         mux->frame_id);
+        }
+
+        CGUTILS_FREE(mux->frame);
+
+        result = cgsmc_async_mux_read_frame(mux);
+
+        if (COMPILER_UNLIKELY(result != 0))
+        {
+            cgsmc_async_mux_fail(mux, result);
+        }
+    }
+    else
+    {
+        CGUTILS_ERROR("Error reading response frame: %d",
+                      result);
+        cgsmc_async_mux_fail(mux, result);
+    }
+
+    return result;
+}
+
+static int cgsmc_async_mux_got_frame_size_cb(cgutils_event_data * const event,
+                                             int const status,
+                                             int const fd,
+                                             cgutils_event_buffered_io_obj * const obj)
+{
+    int result = status;
+    CGUTILS_ASSERT(event != NULL);
+    CGUTILS_ASSERT(fd != -1);
+    CGUTILS_ASSERT(obj != NULL);
+    cgsmc_async_mux * const mux = obj->cb_data;
+    CGUTILS_ASSERT(mux != NULL);
+
+    if (COMPILER_LIKELY(result == 0))
+    {
+        if (COMPILER_LIKELY(mux->frame_size > 0))
+        {
+            CGUTILS_ASSERT(mux->frame == NULL);
+            CGUTILS_MALLOC(mux->frame, mux->frame_size, 1);
+
+            if (COMPILER_LIKELY(mux->frame != NULL))
+            {
+                result = cgutils_event_buffered_io_add_one(mux->read_io,
+                                                           mux->frame,
+                                                           mux->frame_size,
+                                                           cgutils_event_buffered_io_reading,
+                                                           &cgsmc_async_mux_got_frame_cb,
+                                                           mux);
+
+                if (COMPILER_UNLIKELY(result != 0))
+                {
+                    CGUTILS_ERROR("Error reading response frame: %d",
+                                  result);
+                }
+            }
+            else
+            {
+                result = ENOMEM;
+                CGUTILS_ERROR("Error allocating memory for response frame of size %"PRIu32": %d",
+                              mux->frame_size,
+                              result);
+            }
+
+            if (COMPILER_UNLIKELY(result != 0))
+            {
+                cgsmc_async_mux_fail(mux, result);
+            }
+        }
+        else
+        {
+            /* no payload */
+            result = cgsmc_async_mux_got_frame_cb(event,
+                                                  0,
+                                                  fd,
+                                                  obj);
+        }
+    }
+    else
+    {
+        cgsmc_async_mux_io_cb(event,
+                              result,
+                              fd,
+                              obj);
+    }
+
+    return result;
+}
+
+static int cgsmc_async_mux_read_frame(cgsmc_async_mux * const mux)
+{
+    CGUTILS_ASSERT(mux != NULL);
+
+    int result = cgutils_event_buffered_io_add_one(mux->read_io,
+                                                   &(mux->frame_id),
+                                                   sizeof mux->frame_id,
+                                                   cgutils_event_buffered_io_reading,
+                                                   &cgsmc_async_mux_io_cb,
+                                                   mux);
+
+    if (COMPILER_LIKELY(result == 0))
+    {
+        result = cgutils_event_buffered_io_add_one(mux->read_io,
+                                                   &(mux->frame_size),
+                                                   sizeof mux->frame_size,
+                                                   cgutils_event_buffered_io_reading,
+                                                   &cgsmc_async_mux_got_frame_size_cb,
+                                                   mux);
+    }
+
+    if (COMPILER_UNLIKELY(result != 0))
+    {
+        CGUTILS_ERROR("Error reading frame header: %d",
+                      result);
+    }
+
+    return result;
+}
+
+static int cgsmc_async_mux_hangup_cb(cgutils_event_data * const event,
+                                     int const status,
+                                     int const fd,
+                                     cgutils_event_buffered_io_obj * const obj)
+{
+    int result = status;
+    CGUTILS_ASSERT(event != NULL);
+    CGUTILS_ASSERT(fd != -1);
+    CGUTILS_ASSERT(obj != NULL);
+    cgsmc_async_mux * const mux = obj->cb_data;
+    CGUTILS_ASSERT(mux != NULL);
+
+    (void) event;
+    (void) fd;
+
+    /* nothing is sent on the socket once the rings are set up */
+    if (result == 0)
+    {
+        result = EPROTO;
+    }
+
+    CGUTILS_ERROR("Lost the socket of a ring connection: %d",
+                  result);
+    cgsmc_async_mux_fail(mux, result);
+
+    return result;
+}
+
+static int cgsmc_async_mux_ring_init(cgsmc_async_mux * const mux,
+                                     int const fd)
+{
+    int result = 0;
+    CGUTILS_ASSERT(mux != NULL);
+    cgsmc_async_data * const data = mux->data;
+    CGUTILS_ASSERT(data != NULL);
+    CGUTILS_ASSERT(data->ring_size > 0);
+    size_t const ring_memory_size = cgutils_ring_get_memory_size(data->ring_size);
+    CGUTILS_ASSERT(ring_memory_size > 0);
+
+    mux->opcode = cgsm_proto_opcode_multiplex_ring;
+    mux->ring_size = data->ring_size;
+
+    for (size_t idx = 0;
+         result == 0 && idx < cgsm_proto_ring_fd_count;
+         idx++)
+    {
+        mux->ring_fds[idx] = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+        if (COMPILER_UNLIKELY(mux->ring_fds[idx] == -1))
+        {
+            result = errno;
+            CGUTILS_ERROR("Error creating eventfd: %d",
+                          result);
+        }
+    }
+
+    if (COMPILER_LIKELY(result == 0))
+    {
+        result = cgutils_asprintf(&(mux->ring_name),
+                                  "/cgsmc-ring-%d-%"PRIu64,
+                                  (int) getpid(),
+                                  data->rings_count++);
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            mux->ring_name_len = strlen(mux->ring_name);
+
+            result = cloudutils_shared_memory_segment_handler_create(mux->ring_name,
+                                                                     2 * ring_memory_size,
+                                                                     &(mux->ring_segment));
+
+            if (COMPILER_UNLIKELY(result != 0))
+            {
+                CGUTILS_ERROR("Error creating shared memory segment %s: %d",
+                              mux->ring_name,
+                              result);
+                /* nothing to unlink */
+                CGUTILS_FREE(mux->ring_name);
+            }
+        }
+        else
+        {
+            CGUTILS_ERROR("Error allocating ring name: %d",
+                          result);
+        }
+    }
+
+    if (COMPILER_LIKELY(result == 0))
+    {
+        char * const memory = cloudutils_shared_memory_segment_handler_get_data(mux->ring_segment);
+        CGUTILS_ASSERT(memory != NULL);
+
+        result = cgutils_ring_init(memory,
+                                   data->ring_size,
+                                   true,
+                                   &(mux->request_ring));
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            result = cgutils_ring_init(memory + ring_memory_size,
+                                       data->ring_size,
+                                       true,
+                                       &(mux->response_ring));
+        }
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            result = cgutils_event_buffered_io_init_ring(data->event_data,
+                                                         mux->request_ring,
+                                                         mux->ring_fds[cgsm_proto_ring_fd_request_space],
+                                                         mux->ring_fds[cgsm_proto_ring_fd_request_data],
+                                                         cgutils_event_buffered_io_writing,
+                                                         &(mux->write_io));
+        }
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            result = cgutils_event_buffered_io_init_ring(data->event_data,
+                                                         mux->response_ring,
+                                                         mux->ring_fds[cgsm_proto_ring_fd_response_data],
+                                                         mux->ring_fds[cgsm_proto_ring_fd_response_space],
+                                                         cgutils_event_buffered_io_reading,
+                                                         &(mux->read_io));
+        }
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            result = cgutils_event_buffered_io_init(data->event_data,
+                                                    fd,
+                                                    cgutils_event_buffered_io_writing,
+                                                    &(mux->sock_io));
+        }
+
+        if (COMPILER_UNLIKELY(result != 0))
+        {
+            CGUTILS_ERROR("Error setting up rings: %d",
+                          result);
+        }
+    }
+
+    return result;
+}
+
+static int cgsmc_async_mux_ready_cb(cgutils_event_data * const event,
+                                    int const status,
+                                    int const fd,
+                                    cgutils_event_buffered_io_obj * const obj)
+{
+    int result = status;
+    CGUTILS_ASSERT(event != NULL);
+    CGUTILS_ASSERT(fd != -1);
+    CGUTILS_ASSERT(obj != NULL);
+    cgsmc_async_mux * const mux = obj->cb_data;
+    CGUTILS_ASSERT(mux != NULL);
+
+    (void) event;
+    (void) fd;
+
+    if (COMPILER_LIKELY(result == 0))
+    {
+        if (COMPILER_LIKELY(mux->response_code == 0))
+        {
+            if (mux->sock_io != NULL)
+            {
+                /* the storage manager has its own mapping of the segment */
+                cloudutils_shared_memory_segment_handler_unlink(mux->ring_segment);
+                CGUTILS_FREE(mux->ring_name);
+
+                result = cgutils_event_buffered_io_add_one(mux->sock_io,
+                                                           &(mux->hangup),
+                                                           sizeof mux->hangup,
+                                                           cgutils_event_buffered_io_reading,
+                                                           &cgsmc_async_mux_hangup_cb,
+                                                           mux);
+
+                if (COMPILER_UNLIKELY(result != 0))
+                {
+                    CGUTILS_ERROR("Error watching ring connection socket: %d",
+                                  result);
+                }
+            }
+
+            if (COMPILER_LIKELY(result == 0))
+            {
+                result = cgsmc_async_mux_read_frame(mux);
+            }
+        }
+        else if (mux->sock_io != NULL)
+        {
+            result = mux->response_code;
+            /* the pending requests are retried on the socket */
+            CGUTILS_WARN("The storage manager refused the shared memory rings, not using them anymore: %d",
+                         result);
+            mux->data->ring_size = 0;
+        }
+        else
+        {
+            result = mux->response_code;
+            CGUTILS_ERROR("The storage manager refused to multiplex this connection: %d",
+                          result);
+        }
+    }
+    else
+    {
+        CGUTILS_ERROR("Error setting up multiplexed connection: %d",
+                      result);
+    }
+
+    if (COMPILER_UNLIKELY(result != 0))
+    {
+        cgsmc_async_mux_fail(mux, result);
+    }
+
+    return result;
+}
+
+static int cgsmc_async_mux_init(cgsmc_async_data * const data,
+                                size_t const slot,
+                                cgsmc_async_mux ** const out)
+{
+    int result = 0;
+    cgsmc_async_mux * mux = NULL;
+    CGUTILS_ASSERT(data != NULL);
+    CGUTILS_ASSERT(slot < data->mux_connections);
+    CGUTILS_ASSERT(out != NULL);
+
+    CGUTILS_ALLOCATE_STRUCT(mux);
+
+    if (COMPILER_LIKELY(mux != NULL))
+    {
+        mux->data = data;
+        mux->slot = slot;
+        mux->opcode = cgsm_proto_opcode_multiplex;
+
+        for (size_t idx = 0;
+             idx < cgsm_proto_ring_fd_count;
+             idx++)
+        {
+            mux->ring_fds[idx] = -1;
+        }
+
+        result = cgutils_llist_create(&(mux->pending));
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            result = cgsmc_async_connection_init(data->manager_sock_binding,
+                                                 &(mux->conn));
+
+            if (COMPILER_LIKELY(result == 0))
+            {
+                int const fd = cgsmc_async_connection_get_fd(mux->conn);
+
+                if (data->ring_size > 0)
+                {
+                    result = cgsmc_async_mux_ring_init(mux,
+                                                       fd);
+                }
+                else
+                {
+                    result = cgutils_event_buffered_io_init(data->event_data,
+                                                            fd,
+                                                            cgutils_event_buffered_io_writing,
+                                                            &(mux->write_io));
+
+                    if (COMPILER_LIKELY(result == 0))
+                    {
+                        result = cgutils_event_buffered_io_init(data->event_data,
+                                                                fd,
+                                                                cgutils_event_buffered_io_reading,
+                                                                &(mux->read_io));
+                    }
+
+                    if (COMPILER_UNLIKELY(result != 0))
+                    {
+                        CGUTILS_ERROR("Error creating buffered IO: %d",
+                                      result);
+                    }
+                }
+
+                if (COMPILER_LIKELY(result == 0))
+                {
+                    /* with rings, the socket only carries the setup */
+                    cgutils_event_buffered_io * const setup_io = mux->sock_io != NULL ? mux->sock_io : mux->write_io;
+
+                    /* bind the connection to this FS, then switch it to multiplexed mode */
+                    result = cgutils_event_buffered_io_add_one(setup_io,
+                                                               &(data->fs_name_len),
+                                                               sizeof (data->fs_name_len),
+                                                               cgutils_event_buffered_io_writing,
+                                                               &cgsmc_async_mux_io_cb,
+                                                               mux);
+
+                    if (COMPILER_LIKELY(result == 0))
+                    {
+                        result = cgutils_event_buffered_io_add_one(setup_io,
+                                                                   (char *) data->fs_name,
+                                                                   data->fs_name_len,
+                                                                   cgutils_event_buffered_io_writing,
+                                                                   &cgsmc_async_mux_io_cb,
+                                                                   mux);
+                    }
+
+                    if (COMPILER_LIKELY(result == 0))
+                    {
+                        result = cgutils_event_buffered_io_add_one(setup_io,
+                                                                   &(mux->opcode),
+                                                                   sizeof mux->opcode,
+                                                                   cgutils_event_buffered_io_writing,
+                                                                   &cgsmc_async_mux_io_cb,
+                                                                   mux);
+                    }
+
+                    if (COMPILER_LIKELY(result == 0 &&
+                                        mux->sock_io != NULL))
+                    {
+                        result = cgutils_event_buffered_io_add_one(setup_io,
+                                                                   &(mux->ring_size),
+                                                                   sizeof mux->ring_size,
+                                                                   cgutils_event_buffered_io_writing,
+                                                                   &cgsmc_async_mux_io_cb,
+                                                                   mux);
+
+                        if (COMPILER_LIKELY(result == 0))
+                        {
+                            result = cgutils_event_buffered_io_add_one(setup_io,
+                                                                       &(mux->ring_name_len),
+                                                                       sizeof mux->ring_name_len,
+                                                                       cgutils_event_buffered_io_writing,
+                                                                       &cgsmc_async_mux_io_cb,
+                                                                       mux);
+                        }
+
+                        if (COMPILER_LIKELY(result == 0))
+                        {
+                            result = cgutils_event_buffered_io_add_one(setup_io,
+                                                                       mux->ring_name,
+                                                                       mux->ring_name_len,
+                                                                       cgutils_event_buffered_io_writing,
+                                                                       &cgsmc_async_mux_io_cb,
+                                                                       mux);
+                        }
+
+                        for (size_t idx = 0;
+                             result == 0 && idx < cgsm_proto_ring_fd_count;
+                             idx++)
+                        {
+                            result = cgutils_event_buffered_io_add_fd(setup_io,
+                                                                      &(mux->ring_fds[idx]),
+                                                                      cgutils_event_buffered_io_writing,
+                                                                      &cgsmc_async_mux_io_cb,
+                                                                      mux);
+                        }
+                    }
+
+                    if (COMPILER_LIKELY(result == 0))
+                    {
+                        result = cgutils_event_buffered_io_add_one(mux->sock_io != NULL ? mux->sock_io : mux->read_io,
+                                                                   &(mux->response_code),
+                                                                   sizeof mux->response_code,
+                                                                   cgutils_event_buffered_io_reading,
+                                                                   &cgsmc_async_mux_ready_cb,
+                                                                   mux);
+                    }
+
+                    if (COMPILER_UNLIKELY(result != 0))
+                    {
+                        CGUTILS_ERROR("Error queuing multiplexed connection setup: %d",
+                                      result);
+                    }
+                }
+            }
+            else
+            {
+                CGUTILS_ERROR("Error getting connection: %d",
+                              result);
+            }
+        }
+        else
+        {
+            CGUTILS_ERROR("Error creating pending requests list: %d",
+                          result);
+        }
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            *out = mux;
+        }
+        else
+        {
+            cgsmc_async_mux_free(mux), mux = NULL;
+        }
+    }
+    else
+    {
+        result = ENOMEM;
+    }
+
+    return result;
+}
+
+static int cgsmc_async_mux_frame_sent_cb(cgutils_event_data * const event,
+                                         int const status,
+                                         int const fd,
+                                         cgutils_event_buffered_io_obj * const obj)
+{
+    return cgsmc_async_mux_io_cb(event,
+                                 status,
+                                 fd,
+                                 obj);
+}
+
+static void cgsmc_async_mux_request_flush_cb(cgutils_event_buffered_io * const io,
+                                             void * const cb_data)
+{
+    char * frame = NULL;
+    size_t frame_len = 0;
+    CGUTILS_ASSERT(io != NULL);
+    CGUTILS_ASSERT(cb_data != NULL);
+    cgsmc_async_request * req = cb_data;
+    cgsmc_async_mux * const mux = req->mux;
+    CGUTILS_ASSERT(mux != NULL);
+
+    /* the request is waiting for its response,
+       send what it has written as a single frame */
+    int result = cgutils_event_buffered_io_take_output(io,
+                                                       &frame,
+                                                       &frame_len);
+
+    if (COMPILER_LIKELY(result == 0))
+    {
+        cgutils_event_buffered_io_obj * obj = NULL;
+        CGUTILS_ASSERT(frame != NULL);
+        CGUTILS_ASSERT(frame_len > CGSM_PROTO_FRAME_HEADER_SIZE);
+        cgsm_proto_frame_size_type const payload_size = (cgsm_proto_frame_size_type) (frame_len - CGSM_PROTO_FRAME_HEADER_SIZE);
+
+        memcpy(frame,
+               &(req->mux_id),
+               sizeof req->mux_id);
+        memcpy(frame + sizeof req->mux_id,
+               &payload_size,
+               sizeof payload_size);
+
+        result = cgutils_event_buffered_io_object_create(mux->write_io,
+                                                         frame,
+                                                         frame_len,
+                                                         cgutils_event_buffered_io_writing,
+                                                         &cgsmc_async_mux_frame_sent_cb,
+                                                         mux,
+                                                         &obj);
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            obj->free_object = true;
+            frame = NULL;
+
+            result = cgutils_event_buffered_io_add_obj(mux->write_io,
+                                                       obj);
+
+            if (COMPILER_UNLIKELY(result != 0))
+            {
+                CGUTILS_ERROR("Error queuing request frame: %d",
+                              result);
+                CGUTILS_FREE(obj->object);
+                CGUTILS_FREE(obj);
+            }
+        }
+        else
+        {
+            CGUTILS_ERROR("Error creating request frame object: %d",
+                          result);
+            CGUTILS_FREE(frame);
+        }
+    }
+    else
+    {
+        CGUTILS_ERROR("Error getting request frame: %d",
+                      result);
+    }
+
+    if (COMPILER_UNLIKELY(result != 0))
+    {
+        cgsmc_async_mux_detach(req);
+        req->io_error = true;
+        req->result = result;
+        cgsmc_async_request_error(req), req = NULL;
+    }
+}
+
+static int cgsmc_async_mux_send(cgsmc_async_request * const req)
+{
+    int result = 0;
+    CGUTILS_ASSERT(req != NULL);
+    CGUTILS_ASSERT(req->conn == NULL);
+    CGUTILS_ASSERT(req->mux == NULL);
+    CGUTILS_ASSERT(req->io == NULL);
+    cgsmc_async_data * const data = req->data;
+    CGUTILS_ASSERT(data != NULL);
+    CGUTILS_ASSERT(data->mux_connections > 0);
+    CGUTILS_ASSERT(data->muxes != NULL);
+
+    size_t const slot = data->next_mux;
+    data->next_mux = (slot + 1) % data->mux_connections;
+
+    cgsmc_async_mux * mux = data->muxes[slot];
+
+    if (mux == NULL)
+    {
+        result = cgsmc_async_mux_init(data,
+                                      slot,
+                                      &mux);
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            data->muxes[slot] = mux;
+        }
+        else
+        {
+            CGUTILS_ERROR("Error creating multiplexed connection: %d",
+                          result);
+        }
+    }
+
+    if (COMPILER_LIKELY(result == 0))
+    {
+        /* the header of the request frame is written in the headroom */
+        result = cgutils_event_buffered_io_init_memory(data->event_data,
+                                                       cgsmc_async_connection_get_fd(mux->conn),
+                                                       CGSM_PROTO_FRAME_HEADER_SIZE,
+                                                       &cgsmc_async_mux_request_flush_cb,
+                                                       req,
+                                                       &(req->io));
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            result = cgutils_llist_insert(mux->pending,
+                                          req);
+
+            if (COMPILER_LIKELY(result == 0))
+            {
+                req->mux = mux;
+                req->mux_id = mux->next_id++;
+
+                cgsmc_async_request_connection_ready(req);
+            }
+            else
+            {
+                CGUTILS_ERROR("Error adding request to pending list: %d",
+                              result);
+                cgutils_event_buffered_io_release(req->io), req->io = NULL;
+            }
+        }
+        else
+        {
+            CGUTILS_ERROR("Error creating memory buffered IO: %d",
+                          result);
+        }
+    }
+
+    if (COMPILER_UNLIKELY(result != 0))
+    {
+        req->io_error = true;
+    }
+
+    return result;
+}
+
+static int cgsmc_async_connection_setup_cb(cgutils_event_data * const event,
+                                           int const status,
+                                           int const fd,
+                                           cgutils_event_buffered_io_obj * const obj)
+{
+    CGUTILS_ASSERT(event != NULL);
+    CGUTILS_ASSERT(fd != -1);
+    CGUTILS_ASSERT(obj != NULL);
+    cgsmc_async_request * const req = obj->cb_data;
+    CGUTILS_ASSERT(req != NULL);
 
     (void) event;
     (void) fd;
@@ -1355,132 +2610,496 @@ static int cgsmc_async_get_new_connection(cgsmc_async_request * const req)
                                                            &cgsmc_async_request_error_dispatching_cb,
                                                            req);
 
-                if (COMPILER_LIKELY(result == 0))
+                if (COMPILER_LIKELY(result == 0))
+                {
+                    result = cgutils_event_buffered_io_add_one(req->io,
+                                                               (char * ) req->data->fs_name,
+                                                               req->data->fs_name_len,
+                                                               cgutils_event_buffered_io_writing,
+                                                               &cgsmc_async_connection_setup_cb,
+                                                               req);
+
+                    if (COMPILER_UNLIKELY(result != 0))
+                    {
+                        CGUTILS_ERROR("Error sending FS ID: %d",
+                                      result);
+                    }
+                }
+                else
+                {
+                    CGUTILS_ERROR("Error sending FS ID length: %d",
+                                  result);
+                }
+            }
+            else
+            {
+                CGUTILS_ERROR("Error creating buffered IO: %d",
+                              result);
+            }
+        }
+        else
+        {
+            CGUTILS_ERROR("Error getting connection: %d",
+                          result);
+        }
+
+        if (COMPILER_UNLIKELY(result != 0))
+        {
+            req->retry_count++;
+        }
+    }
+    while (result != 0 &&
+           req->retry_count < req->data->max_retry_count);
+
+    if (COMPILER_UNLIKELY(result != 0))
+    {
+        req->io_error = true;
+    }
+
+    return result;
+}
+
+static int cgsmc_async_get_connection(cgsmc_async_request * const req)
+{
+    int result = 0;
+    CGUTILS_ASSERT(req != NULL);
+    CGUTILS_ASSERT(req->data != NULL);
+    cgsmc_async_data * data = req->data;
+
+    if (data->mux_connections > 0)
+    {
+        result = cgsmc_async_mux_send(req);
+
+        if (COMPILER_UNLIKELY(result == ENOENT))
+        {
+            result = EHOSTDOWN;
+        }
+    }
+    else
+    {
+        result = cgsmc_async_get_connection_from_pool(data,
+                                                      &(req->conn));
+
+        if (result == 0)
+        {
+            cgsmc_async_request_connection_ready(req);
+        }
+        else if (result == ENOENT)
+        {
+            result = cgsmc_async_get_new_connection(req);
+
+            if (COMPILER_UNLIKELY(result != 0))
+            {
+                CGUTILS_ERROR("Error getting a new connection to the storage manager: %d",
+                              result);
+
+                if (result == ENOENT)
+                {
+                    /* ENOENT could be interpreted has non-existing entry,
+                       which we don't want! */
+                    result = EHOSTDOWN;
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+static int cgsmc_async_request_send(cgsmc_async_request * const req,
+                                    cgutils_event_buffered_io_obj const * const write_io_objects,
+                                    size_t const write_io_objects_count,
+                                    cgutils_event_buffered_io_obj const * const read_io_objects,
+                                    size_t const read_io_objects_count)
+
+{
+    int result = 0;
+    CGUTILS_ASSERT(req != NULL);
+    CGUTILS_ASSERT(write_io_objects != NULL ||
+                   write_io_objects_count == 0);
+    CGUTILS_ASSERT(read_io_objects != NULL ||
+                   read_io_objects_count == 0);
+
+    result = cgsmc_async_request_add_ios_to_req(req,
+                                                cgsmc_async_request_io_type_write,
+                                                write_io_objects,
+                                                write_io_objects_count);
+
+    if (COMPILER_LIKELY(result == 0))
+    {
+        result = cgsmc_async_request_add_ios_to_req(req,
+                                                    cgsmc_async_request_io_type_read,
+                                                    read_io_objects,
+                                                    read_io_objects_count);
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            /* once the connection has been established,
+               cgsmc_async_request_connection_ready will be called.
+            */
+            result = cgsmc_async_get_connection(req);
+
+            if (result != 0)
+            {
+                req->read_ios = NULL;
+                req->read_ios_count = 0;
+            }
+        }
+
+        if (result != 0)
+        {
+            req->write_ios = NULL;
+            req->write_ios_count = 0;
+        }
+    }
+
+    return result;
+}
+
+static int cgsmc_async_lookup_child_send(cgsmc_async_request * const req)
+{
+    int result = 0;
+    CGUTILS_ASSERT(req != NULL);
+    CGUTILS_ASSERT(req->st != NULL);
+
+    cgutils_event_buffered_io_obj const write_io_objects[] =
+        {
+            { NULL, &(req->ino), sizeof (req->ino), NULL, NULL, cgutils_event_buffered_io_writing },
+            { NULL, &(req->name_len), sizeof (req->name_len), NULL, NULL, cgutils_event_buffered_io_writing },
+            { NULL, (char *) req->name, req->name_len, NULL, NULL, cgutils_event_buffered_io_writing },
+        };
+    size_t const write_io_objects_count = sizeof write_io_objects / sizeof *write_io_objects;
+    cgutils_event_buffered_io_obj const read_io_objects[] =
+        {
+            { NULL, req->st, sizeof *(req->st), NULL, NULL, cgutils_event_buffered_io_reading },
+        };
+    size_t const read_io_objects_count = sizeof read_io_objects / sizeof *read_io_objects;
+
+    result = cgsmc_async_request_send(req,
+                                      write_io_objects,
+                                      write_io_objects_count,
+                                      read_io_objects,
+                                      read_io_objects_count);
+
+    return result;
+}
+
+static void cgsmc_async_getattr_response_cb(cgsmc_async_request * req)
+{
+    CGUTILS_ASSERT(req != NULL);
+    CGUTILS_ASSERT(req->type == cgsmc_async_request_type_getattr);
+    CGUTILS_ASSERT(req->stat_cb != NULL);
+    /* errors should be handled by the error cb */
+    CGUTILS_ASSERT(req->result == 0);
+
+    (*(req->stat_cb))(req->result,
+                      req->st,
+                      req->cb_data);
+
+    req->st = NULL;
+
+    cgsmc_async_request_free(req), req = NULL;
+}
+
+static int cgsmc_async_getattr_send(cgsmc_async_request * const req)
+{
+    int result = 0;
+    CGUTILS_ASSERT(req != NULL);
+    CGUTILS_ASSERT(req->st != NULL);
+
+    cgutils_event_buffered_io_obj const write_io_objects[] =
+        {
+            { NULL, &(req->ino), sizeof (req->ino), NULL, NULL, cgutils_event_buffered_io_writing },
+        };
+    size_t const write_io_objects_count = sizeof write_io_objects / sizeof *write_io_objects;
+    cgutils_event_buffered_io_obj const read_io_objects[] =
+        {
+            { NULL, req->st, sizeof *(req->st), NULL, NULL, cgutils_event_buffered_io_reading },
+        };
+    size_t const read_io_objects_count = sizeof read_io_objects / sizeof *read_io_objects;
+
+    result = cgsmc_async_request_send(req,
+                                      write_io_objects,
+                                      write_io_objects_count,
+                                      read_io_objects,
+                                      read_io_objects_count);
+
+    return result;
+}
+
+static int cgsmc_async_batch_send_multi(cgsmc_async_data * const data,
+                                        cgsmc_async_request_type const type,
+                                        cgsmc_async_request * const * const members,
+                                        size_t const members_count)
+{
+    int result = 0;
+    cgsmc_async_request * req = NULL;
+    CGUTILS_ASSERT(data != NULL);
+    CGUTILS_ASSERT(members != NULL);
+    CGUTILS_ASSERT(members_count > 1);
+    CGUTILS_ASSERT(members_count <= CGSMC_ASYNC_METADATA_BATCH_SIZE_MAX);
+
+    result = cgsmc_async_request_init(data,
+                                      type == cgsmc_async_request_type_getattr ?
+                                      cgsmc_async_request_type_getattr_multi :
+                                      cgsmc_async_request_type_lookup_child_multi,
+                                      &req);
+
+    if (COMPILER_LIKELY(result == 0))
+    {
+        req->response_cb = NULL;
+        req->batch_size = (cgsm_proto_batch_size_type) members_count;
+        req->ino = members[0]->ino;
+
+        req->batch = cgutils_arena_calloc(req->arena, members_count, sizeof *(req->batch));
+        req->batch_codes = cgutils_arena_calloc(req->arena, members_count, sizeof *(req->batch_codes));
+        req->batch_st = cgutils_arena_calloc(req->arena, members_count, sizeof *(req->batch_st));
+
+        if (type == cgsmc_async_request_type_getattr)
+        {
+            req->batch_inodes = cgutils_arena_calloc(req->arena, members_count, sizeof *(req->batch_inodes));
+        }
+        else
+        {
+            for (size_t idx = 0;
+                 idx < members_count;
+                 idx++)
+            {
+                req->batch_names_len += members[idx]->name_len + 1;
+            }
+
+            req->batch_names = cgutils_arena_calloc(req->arena, req->batch_names_len, 1);
+        }
+
+        if (COMPILER_LIKELY(req->batch != NULL &&
+                            req->batch_codes != NULL &&
+                            req->batch_st != NULL &&
+                            (req->batch_inodes != NULL || req->batch_names != NULL)))
+        {
+            size_t names_pos = 0;
+
+            for (size_t idx = 0;
+                 idx < members_count;
+                 idx++)
+            {
+                cgsmc_async_request const * const member = members[idx];
+                req->batch[idx] = members[idx];
+
+                if (type == cgsmc_async_request_type_getattr)
                 {
-                    result = cgutils_event_buffered_io_add_one(req->io,
-                                                               (char * ) req->data->fs_name,
-                                                               req->data->fs_name_len,
-                                                               cgutils_event_buffered_io_writing,
-                                                               &cgsmc_async_connection_setup_cb,
-                                                               req);
-
-                    if (COMPILER_UNLIKELY(result != 0))
-                    {
-                        CGUTILS_ERROR("Error sending FS ID: %d",
-                                      result);
-                    }
+                    req->batch_inodes[idx] = member->ino;
                 }
                 else
                 {
-                    CGUTILS_ERROR("Error sending FS ID length: %d",
-                                  result);
+                    /* each name is NUL-terminated */
+                    memcpy(req->batch_names + names_pos, member->name, member->name_len);
+                    names_pos += member->name_len;
+                    req->batch_names[names_pos++] = '\0';
                 }
             }
+
+            cgutils_event_buffered_io_obj const read_io_objects[] =
+                {
+                    { NULL, req->batch_codes, members_count * sizeof *(req->batch_codes), NULL, NULL, cgutils_event_buffered_io_reading },
+                    { NULL, req->batch_st, members_count * sizeof *(req->batch_st), NULL, NULL, cgutils_event_buffered_io_reading },
+                };
+            size_t const read_io_objects_count = sizeof read_io_objects / sizeof *read_io_objects;
+
+            if (type == cgsmc_async_request_type_getattr)
+            {
+                cgutils_event_buffered_io_obj const write_io_objects[] =
+                    {
+                        { NULL, &(req->batch_size), sizeof (req->batch_size), NULL, NULL, cgutils_event_buffered_io_writing },
+                        { NULL, req->batch_inodes, members_count * sizeof *(req->batch_inodes), NULL, NULL, cgutils_event_buffered_io_writing },
+                    };
+                size_t const write_io_objects_count = sizeof write_io_objects / sizeof *write_io_objects;
+
+                result = cgsmc_async_request_send(req,
+                                                  write_io_objects,
+                                                  write_io_objects_count,
+                                                  read_io_objects,
+                                                  read_io_objects_count);
+            }
             else
             {
-                CGUTILS_ERROR("Error creating buffered IO: %d",
+                cgutils_event_buffered_io_obj const write_io_objects[] =
+                    {
+                        { NULL, &(req->ino), sizeof (req->ino), NULL, NULL, cgutils_event_buffered_io_writing },
+                        { NULL, &(req->batch_size), sizeof (req->batch_size), NULL, NULL, cgutils_event_buffered_io_writing },
+                        { NULL, &(req->batch_names_len), sizeof (req->batch_names_len), NULL, NULL, cgutils_event_buffered_io_writing },
+                        { NULL, req->batch_names, req->batch_names_len, NULL, NULL, cgutils_event_buffered_io_writing },
+                    };
+                size_t const write_io_objects_count = sizeof write_io_objects / sizeof *write_io_objects;
+
+                result = cgsmc_async_request_send(req,
+                                                  write_io_objects,
+                                                  write_io_objects_count,
+                                                  read_io_objects,
+                                                  read_io_objects_count);
+            }
+
+            if (COMPILER_UNLIKELY(result != 0))
+            {
+                CGUTILS_ERROR("Error sending a batch of %zu requests: %d",
+                              members_count,
                               result);
+                /* the coalesced requests are owned by the batch now */
+                cgsmc_async_batch_dispatch(req, result);
             }
         }
         else
         {
-            CGUTILS_ERROR("Error getting connection: %d",
+            result = ENOMEM;
+            CGUTILS_ERROR("Error allocating a batch of %zu requests: %d",
+                          members_count,
                           result);
+            cgsmc_async_batch_fail(members, members_count, result);
         }
 
         if (COMPILER_UNLIKELY(result != 0))
         {
-            req->retry_count++;
+            cgsmc_async_request_free(req), req = NULL;
         }
     }
-    while (result != 0 &&
-           req->retry_count < req->data->max_retry_count);
-
-    if (COMPILER_UNLIKELY(result != 0))
+    else
     {
-        req->io_error = true;
+        CGUTILS_ERROR("Error allocating a batch request: %d",
+                      result);
+        cgsmc_async_batch_fail(members, members_count, result);
     }
 
     return result;
 }
 
-static int cgsmc_async_get_connection(cgsmc_async_request * const req)
+/* Sends the given pending requests, as a _multi one if there is more than one.
+   Errors are reported through the callbacks of the requests, which are always
+   freed once done. */
+static void cgsmc_async_batch_send(cgsmc_async_data * const data,
+                                   cgsmc_async_request_type const type,
+                                   cgsmc_async_request * const * const members,
+                                   size_t const members_count)
 {
     int result = 0;
-    CGUTILS_ASSERT(req != NULL);
-    CGUTILS_ASSERT(req->data != NULL);
-    cgsmc_async_data * data = req->data;
-
-    result = cgsmc_async_get_connection_from_pool(data,
-                                                  &(req->conn));
+    CGUTILS_ASSERT(data != NULL);
+    CGUTILS_ASSERT(members != NULL);
+    CGUTILS_ASSERT(members_count > 0);
 
-    if (result == 0)
+    if (members_count > 1)
     {
-        cgsmc_async_request_connection_ready(req);
+        /* errors are dispatched to the requests */
+        (void) cgsmc_async_batch_send_multi(data,
+                                            type,
+                                            members,
+                                            members_count);
     }
-    else if (result == ENOENT)
+    else
     {
-        result = cgsmc_async_get_new_connection(req);
+        result = type == cgsmc_async_request_type_getattr ?
+            cgsmc_async_getattr_send(members[0]) :
+            cgsmc_async_lookup_child_send(members[0]);
 
         if (COMPILER_UNLIKELY(result != 0))
         {
-            CGUTILS_ERROR("Error getting a new connection to the storage manager: %d",
-                          result);
-
-            if (result == ENOENT)
-            {
-                /* ENOENT could be interpreted has non-existing entry,
-                   which we don't want! */
-                result = EHOSTDOWN;
-            }
+            cgsmc_async_batch_fail(members, 1, result);
         }
     }
+}
 
-    return result;
+static void cgsmc_async_batch_flush_getattrs(cgsmc_async_data * const data)
+{
+    CGUTILS_ASSERT(data != NULL);
+
+    if (data->pending_getattrs_count > 0)
+    {
+        size_t const count = data->pending_getattrs_count;
+        data->pending_getattrs_count = 0;
+
+        cgsmc_async_batch_send(data,
+                               cgsmc_async_request_type_getattr,
+                               data->pending_getattrs,
+                               count);
+    }
 }
 
-static int cgsmc_async_request_send(cgsmc_async_request * const req,
-                                    cgutils_event_buffered_io_obj const * const write_io_objects,
-                                    size_t const write_io_objects_count,
-                                    cgutils_event_buffered_io_obj const * const read_io_objects,
-                                    size_t const read_io_objects_count)
+static void cgsmc_async_batch_flush_lookups(cgsmc_async_data * const data)
+{
+    CGUTILS_ASSERT(data != NULL);
+
+    if (data->pending_lookups_count > 0)
+    {
+        size_t const count = data->pending_lookups_count;
+        data->pending_lookups_count = 0;
+
+        cgsmc_async_batch_send(data,
+                               cgsmc_async_request_type_lookup_child,
+                               data->pending_lookups,
+                               count);
+    }
+}
+
+static void cgsmc_async_batch_flush_cb(void * const cb_data)
+{
+    CGUTILS_ASSERT(cb_data != NULL);
+    cgsmc_async_data * data = cb_data;
+
+    cgsmc_async_batch_flush_getattrs(data);
+    cgsmc_async_batch_flush_lookups(data);
+}
 
+/* Queues a getattr or lookup request until the next loop iteration,
+   so that the ones issued in the meantime are sent along. */
+static int cgsmc_async_batch_add(cgsmc_async_request * const req)
 {
+    static struct timeval const next_iteration = { 0, 0 };
     int result = 0;
     CGUTILS_ASSERT(req != NULL);
-    CGUTILS_ASSERT(write_io_objects != NULL ||
-                   write_io_objects_count == 0);
-    CGUTILS_ASSERT(read_io_objects != NULL ||
-                   read_io_objects_count == 0);
-
-    result = cgsmc_async_request_add_ios_to_req(req,
-                                                cgsmc_async_request_io_type_write,
-                                                write_io_objects,
-                                                write_io_objects_count);
+    cgsmc_async_data * data = req->data;
+    CGUTILS_ASSERT(data != NULL);
+    CGUTILS_ASSERT(data->metadata_batch_size > 1);
+    bool const getattr = req->type == cgsmc_async_request_type_getattr;
 
-    if (COMPILER_LIKELY(result == 0))
+    if (getattr == false &&
+        data->pending_lookups_count > 0 &&
+        data->pending_lookups[0]->ino != req->ino)
     {
-        result = cgsmc_async_request_add_ios_to_req(req,
-                                                    cgsmc_async_request_io_type_read,
-                                                    read_io_objects,
-                                                    read_io_objects_count);
+        /* a batch of lookups shares the same parent */
+        cgsmc_async_batch_flush_lookups(data);
+    }
 
-        if (COMPILER_LIKELY(result == 0))
-        {
-            /* once the connection has been established,
-               cgsmc_async_request_connection_ready will be called.
-            */
-            result = cgsmc_async_get_connection(req);
+    cgsmc_async_request ** const pending = getattr == true ?
+        data->pending_getattrs :
+        data->pending_lookups;
+    size_t * const pending_count = getattr == true ?
+        &(data->pending_getattrs_count) :
+        &(data->pending_lookups_count);
 
-            if (result != 0)
-            {
-                cgutils_vector_deep_free(&(req->read_ios), &free);
-            }
+    CGUTILS_ASSERT(*pending_count < data->metadata_batch_size);
+    pending[*pending_count] = req;
+    (*pending_count)++;
+
+    if (*pending_count >= data->metadata_batch_size)
+    {
+        if (getattr == true)
+        {
+            cgsmc_async_batch_flush_getattrs(data);
+        }
+        else
+        {
+            cgsmc_async_batch_flush_lookups(data);
         }
+    }
+    else if (cgutils_event_is_enabled(data->batch_event) == false)
+    {
+        result = cgutils_event_enable(data->batch_event,
+                                      &next_iteration);
 
-        if (result != 0)
+        if (COMPILER_UNLIKELY(result != 0))
         {
-            cgutils_vector_deep_free(&(req->write_ios), &free);
+            CGUTILS_ERROR("Error enabling batch timer event: %d",
+                          result);
+            /* we would never be woken up, do not wait */
+            cgsmc_async_batch_flush_cb(data);
+            result = 0;
         }
     }
 
@@ -1531,25 +3150,15 @@ int cgsmc_async_lookup_child(cgsmc_async_data * const data,
 
             if (COMPILER_LIKELY(req->st != NULL))
             {
-                cgutils_event_buffered_io_obj const write_io_objects[] =
-                    {
-                        { NULL, &(req->ino), sizeof (req->ino), NULL, NULL, cgutils_event_buffered_io_writing },
-                        { NULL, &(req->name_len), sizeof (req->name_len), NULL, NULL, cgutils_event_buffered_io_writing },
-                        { NULL, (char *) req->name, req->name_len, NULL, NULL, cgutils_event_buffered_io_writing },
-                    };
-                size_t const write_io_objects_count = sizeof write_io_objects / sizeof *write_io_objects;
-                cgutils_event_buffered_io_obj const read_io_objects[] =
-                    {
-                        { NULL, req->st, sizeof *(req->st), NULL, NULL, cgutils_event_buffered_io_reading },
-                    };
-                size_t const read_io_objects_count = sizeof read_io_objects / sizeof *read_io_objects;
-
-                result = cgsmc_async_request_send(req,
-                                                  write_io_objects,
-                                                  write_io_objects_count,
-                                                  read_io_objects,
-                                                  read_io_objects_count);
-
+                if (data->metadata_batch_size > 1 &&
+                    name_len > 0)
+                {
+                    result = cgsmc_async_batch_add(req);
+                }
+                else
+                {
+                    result = cgsmc_async_lookup_child_send(req);
+                }
             }
             else
             {
@@ -1566,23 +3175,6 @@ int cgsmc_async_lookup_child(cgsmc_async_data * const data,
     return result;
 }
 
-static void cgsmc_async_getattr_response_cb(cgsmc_async_request * req)
-{
-    CGUTILS_ASSERT(req != NULL);
-    CGUTILS_ASSERT(req->type == cgsmc_async_request_type_getattr);
-    CGUTILS_ASSERT(req->stat_cb != NULL);
-    /* errors should be handled by the error cb */
-    CGUTILS_ASSERT(req->result == 0);
-
-    (*(req->stat_cb))(req->result,
-                      req->st,
-                      req->cb_data);
-
-    req->st = NULL;
-
-    cgsmc_async_request_free(req), req = NULL;
-}
-
 int cgsmc_async_getattr(cgsmc_async_data * const data,
                         uint64_t const ino,
                         cgsmc_async_stat_cb * const cb,
@@ -1609,23 +3201,17 @@ int cgsmc_async_getattr(cgsmc_async_data * const data,
 
         if (COMPILER_LIKELY(req->st != NULL))
         {
-            cgutils_event_buffered_io_obj const write_io_objects[] =
-                {
-                    { NULL, &(req->ino), sizeof (req->ino), NULL, NULL, cgutils_event_buffered_io_writing },
-                };
-            size_t const write_io_objects_count = sizeof write_io_objects / sizeof *write_io_objects;
-            cgutils_event_buffered_io_obj const read_io_objects[] =
-                {
-                    { NULL, req->st, sizeof *(req->st), NULL, NULL, cgutils_event_buffered_io_reading },
-                };
-            size_t const read_io_objects_count = sizeof read_io_objects / sizeof *read_io_objects;
-
-            result = cgsmc_async_request_send(req,
-                                              write_io_objects,
-                                              write_io_objects_count,
-                                              read_io_objects,
-                                              read_io_objects_count);
-
+            /* the root inode may have to be created,
+               which only the single getattr does */
+            if (data->metadata_batch_size > 1 &&
+                ino > 1)
+            {
+                result = cgsmc_async_batch_add(req);
+            }
+            else
+            {
+                result = cgsmc_async_getattr_send(req);
+            }
         }
         else
         {
@@ -1775,7 +3361,7 @@ static void cgsmc_async_readdir_ready_cb(cgsmc_async_request * req)
 {
     int result = 0;
     CGUTILS_ASSERT(req != NULL);
-    CGUTILS_ASSERT(req->type == cgsmc_async_request_type_readdir);
+    CGUTILS_ASSERT(req->type == cgsmc_async_request_type_readdir_page);
     CGUTILS_ASSERT(req->stat_cb != NULL);
     /* errors should be handled by the error cb */
     CGUTILS_ASSERT(req->result == 0);
@@ -1828,21 +3414,21 @@ static void cgsmc_async_readdir_ready_cb(cgsmc_async_request * req)
     }
     else
     {
-        (*(req->readdir_cb))(req->result,
-                             req->entries,
-                             req->entries_count,
-                             req->data->dir_index_limit > 0 &&
-                             req->entries_count >= req->data->dir_index_limit,
-                             req->cb_data);
+        (*(req->readdir_page_cb))(req->result,
+                                  req->entries,
+                                  req->entries_count,
+                                  req->next_dir_cursor,
+                                  req->cb_data);
 
         cgsmc_async_request_free(req), req = NULL;
     }
 }
 
-int cgsmc_async_readdir(cgsmc_async_data * const data,
-                        uint64_t const ino,
-                        cgsmc_async_readdir_cb * const cb,
-                        void * const cb_data)
+int cgsmc_async_readdir_page(cgsmc_async_data * const data,
+                             uint64_t const ino,
+                             uint64_t const cursor,
+                             cgsmc_async_readdir_page_cb * const cb,
+                             void * const cb_data)
 {
     int result = 0;
     cgsmc_async_request * req = NULL;
@@ -1851,23 +3437,28 @@ int cgsmc_async_readdir(cgsmc_async_data * const data,
     CGUTILS_ASSERT(cb_data != NULL);
 
     result = cgsmc_async_request_init(data,
-                                      cgsmc_async_request_type_readdir,
+                                      cgsmc_async_request_type_readdir_page,
                                       &req);
 
     if (COMPILER_LIKELY(result == 0))
     {
         req->ino = ino;
-        req->readdir_cb = cb;
+        req->dir_cursor = cursor;
+        req->dir_page_size = (cgsm_proto_dir_page_size_type) data->readdir_page_size;
+        req->readdir_page_cb = cb;
         req->cb_data = cb_data;
         req->response_cb = &cgsmc_async_readdir_ready_cb;
 
         cgutils_event_buffered_io_obj const write_io_objects[] =
             {
                 { NULL, &(req->ino), sizeof (req->ino), NULL, NULL, cgutils_event_buffered_io_writing },
+                { NULL, &(req->dir_cursor), sizeof (req->dir_cursor), NULL, NULL, cgutils_event_buffered_io_writing },
+                { NULL, &(req->dir_page_size), sizeof (req->dir_page_size), NULL, NULL, cgutils_event_buffered_io_writing },
             };
         size_t const write_io_objects_count = sizeof write_io_objects / sizeof *write_io_objects;
         cgutils_event_buffered_io_obj const read_io_objects[] =
             {
+                { NULL, &(req->next_dir_cursor), sizeof req->next_dir_cursor, NULL, NULL, cgutils_event_buffered_io_reading },
                 { NULL, &(req->expected_entries_count), sizeof req->expected_entries_count, NULL, NULL, cgutils_event_buffered_io_reading },
             };
         size_t const read_io_objects_count = sizeof read_io_objects / sizeof *read_io_objects;
@@ -1887,6 +3478,15 @@ int cgsmc_async_readdir(cgsmc_async_data * const data,
     return result;
 }
 
+static bool cgsmc_async_can_pass_fds(cgsmc_async_data const * const data)
+{
+    CGUTILS_ASSERT(data != NULL);
+
+    /* the responses of multiplexed connections go through memory buffers */
+    return data->pass_fds == true &&
+        data->mux_connections == 0;
+}
+
 static int cgsmc_async_create_and_open_ready_cb(cgutils_event_data * const event,
                                                 int const status,
                                                 int const fd,
@@ -1910,6 +3510,7 @@ static int cgsmc_async_create_and_open_ready_cb(cgutils_event_data * const event
         (*(req->create_and_open_cb))(req->result,
                                      req->st,
                                      req->path_in_cache,
+                                     -1,
                                      req->cb_data);
 
         req->path_in_cache = NULL;
@@ -1974,6 +3575,7 @@ static void cgsmc_async_create_and_open_name_len_ready_cb(cgsmc_async_request *
         (*(req->create_and_open_cb))(req->result,
                                      req->st,
                                      NULL,
+                                     -1,
                                      req->cb_data);
 
         req->st = NULL;
@@ -2020,7 +3622,12 @@ int cgsmc_async_create_and_open(cgsmc_async_data * const data,
             req->name_len = name_len;
             req->create_and_open_cb = cb;
             req->cb_data = cb_data;
-            req->response_cb = &cgsmc_async_create_and_open_name_len_ready_cb;
+            req->pass_fd = cgsmc_async_can_pass_fds(data);
+            /* with a passed descriptor, the response is complete
+               once the read objects have been received */
+            req->response_cb = req->pass_fd == true ?
+                NULL :
+                &cgsmc_async_create_and_open_name_len_ready_cb;
 
             CGUTILS_ALLOCATE_STRUCT(req->st);
 
@@ -2040,7 +3647,9 @@ int cgsmc_async_create_and_open(cgsmc_async_data * const data,
                 cgutils_event_buffered_io_obj const read_io_objects[] =
                     {
                         { NULL, req->st, sizeof *(req->st), NULL, NULL, cgutils_event_buffered_io_reading },
-                        { NULL, &(req->path_in_cache_len), sizeof req->path_in_cache_len, NULL, NULL, cgutils_event_buffered_io_reading },
+                        req->pass_fd == true ?
+                        (cgutils_event_buffered_io_obj) { NULL, &(req->fd_in_cache), sizeof req->fd_in_cache, NULL, NULL, cgutils_event_buffered_io_reading, false, false, true } :
+                        (cgutils_event_buffered_io_obj) { NULL, &(req->path_in_cache_len), sizeof req->path_in_cache_len, NULL, NULL, cgutils_event_buffered_io_reading },
                     };
                 size_t const read_io_objects_count = sizeof read_io_objects / sizeof *read_io_objects;
 
@@ -2133,6 +3742,8 @@ static int cgsmc_async_open_ready_cb(cgutils_event_data * const event,
 
         (*(req->open_cb))(req->result,
                           req->path_in_cache,
+                          -1,
+                          req->lease,
                           req->cb_data);
 
         req->path_in_cache = NULL;
@@ -2195,6 +3806,8 @@ static void cgsmc_async_open_name_len_ready_cb(cgsmc_async_request * req)
     {
         (*(req->open_cb))(req->result,
                           NULL,
+                          -1,
+                          req->lease,
                           req->cb_data);
 
         cgsmc_async_request_free(req), req = NULL;
@@ -2224,7 +3837,11 @@ int cgsmc_async_open(cgsmc_async_data * const data,
         req->flags = flags;
         req->open_cb = cb;
         req->cb_data = cb_data;
-        req->response_cb = &cgsmc_async_open_name_len_ready_cb;
+        req->pass_fd = cgsmc_async_can_pass_fds(data);
+        req->want_lease = data->open_leases;
+        req->response_cb = req->pass_fd == true ?
+            NULL :
+            &cgsmc_async_open_name_len_ready_cb;
 
         cgutils_event_buffered_io_obj const write_io_objects[] =
             {
@@ -2234,14 +3851,19 @@ int cgsmc_async_open(cgsmc_async_data * const data,
         size_t const write_io_objects_count = sizeof write_io_objects / sizeof *write_io_objects;
         cgutils_event_buffered_io_obj const read_io_objects[] =
             {
-                { NULL, &(req->path_in_cache_len), sizeof req->path_in_cache_len, NULL, NULL, cgutils_event_buffered_io_reading },
+                { NULL, &(req->lease), sizeof req->lease, NULL, NULL, cgutils_event_buffered_io_reading },
+                req->pass_fd == true ?
+                (cgutils_event_buffered_io_obj) { NULL, &(req->fd_in_cache), sizeof req->fd_in_cache, NULL, NULL, cgutils_event_buffered_io_reading, false, false, true } :
+                (cgutils_event_buffered_io_obj) { NULL, &(req->path_in_cache_len), sizeof req->path_in_cache_len, NULL, NULL, cgutils_event_buffered_io_reading },
             };
-        size_t const read_io_objects_count = sizeof read_io_objects / sizeof *read_io_objects;
+        /* the lease is only sent in response to the _leased opcodes */
+        size_t const skipped_io_objects = req->want_lease == true ? 0 : 1;
+        size_t const read_io_objects_count = (sizeof read_io_objects / sizeof *read_io_objects) - skipped_io_objects;
 
         result = cgsmc_async_request_send(req,
                                           write_io_objects,
                                           write_io_objects_count,
-                                          read_io_objects,
+                                          read_io_objects + skipped_io_objects,
                                           read_io_objects_count);
 
         if (COMPILER_UNLIKELY(result != 0))
@@ -2296,6 +3918,79 @@ int cgsmc_async_notify_write(cgsmc_async_data * const data,
     return result;
 }
 
+int cgsmc_async_notify_write_multi(cgsmc_async_data * const data,
+                                   uint64_t const * const inodes,
+                                   size_t const inodes_count,
+                                   cgsmc_async_status_cb * const cb,
+                                   void * const cb_data)
+{
+    int result = 0;
+    cgsmc_async_request * req = NULL;
+    CGUTILS_ASSERT(data != NULL);
+    CGUTILS_ASSERT(inodes != NULL);
+    CGUTILS_ASSERT(inodes_count > 0);
+    CGUTILS_ASSERT(cb != NULL);
+    CGUTILS_ASSERT(cb_data != NULL);
+
+    if (inodes_count == 1)
+    {
+        result = cgsmc_async_notify_write(data,
+                                          inodes[0],
+                                          cb,
+                                          cb_data);
+    }
+    else if (COMPILER_LIKELY(inodes_count <= CGSMC_ASYNC_NOTIFY_WRITE_BATCH_SIZE_MAX))
+    {
+        result = cgsmc_async_request_init(data,
+                                          cgsmc_async_request_type_notify_write_multi,
+                                          &req);
+
+        if (COMPILER_LIKELY(result == 0))
+        {
+            req->ino = inodes[0];
+            req->status_cb = cb;
+            req->cb_data = cb_data;
+            req->batch_size = (cgsm_proto_batch_size_type) inodes_count;
+            /* the caller's array may not outlive this call */
+            req->batch_inodes = cgutils_arena_memdup(req->arena, inodes, inodes_count * sizeof *inodes);
+
+            if (COMPILER_LIKELY(req->batch_inodes != NULL))
+            {
+                cgutils_event_buffered_io_obj const write_io_objects[] =
+                    {
+                        { NULL, &(req->batch_size), sizeof (req->batch_size), NULL, NULL, cgutils_event_buffered_io_writing },
+                        { NULL, req->batch_inodes, inodes_count * sizeof *(req->batch_inodes), NULL, NULL, cgutils_event_buffered_io_writing },
+                    };
+                size_t const write_io_objects_count = sizeof write_io_objects / sizeof *write_io_objects;
+
+                result = cgsmc_async_request_send(req,
+                                                  write_io_objects,
+                                                  write_io_objects_count,
+                                                  NULL,
+                                                  0);
+            }
+            else
+            {
+                result = ENOMEM;
+                CGUTILS_ERROR("Error allocating a batch of %zu inode numbers: %d",
+                              inodes_count,
+                              result);
+            }
+
+            if (COMPILER_UNLIKELY(result != 0))
+            {
+                cgsmc_async_request_free(req), req = NULL;
+            }
+        }
+    }
+    else
+    {
+        result = E2BIG;
+    }
+
+    return result;
+}
+
 bool cgsmc_async_need_to_notify_write(cgsmc_async_data * const data,
                                       size_t const elapsed)
 {
@@ -2985,3 +4680,11 @@ unsigned long cgsmc_async_get_name_max(cgsmc_async_data * const data)
 
     return result;
 }
+
+void cgsmc_async_set_open_leases(cgsmc_async_data * const data,
+                                 bool const enabled)
+{
+    CGUTILS_ASSERT(data != NULL);
+
+    data->open_leases = enabled;
+}
@@ -31,6 +31,9 @@
 
 typedef struct cgsmc_async_data cgsmc_async_data;
 
+/* the storage manager rejects larger batches */
+#define CGSMC_ASYNC_NOTIFY_WRITE_BATCH_SIZE_MAX (256)
+
 typedef struct
 {
     struct stat st;
@@ -51,19 +54,28 @@ typedef void (cgsmc_async_returning_inode_number_cb)(int status,
                                                      uint64_t inode_number,
                                                      void * cb_data);
 
-typedef void (cgsmc_async_readdir_cb)(int status,
-                                      cgsmc_async_entry * entries,
-                                      size_t entries_count,
-                                      bool use_dir_index,
-                                      void * cb_data);
+/* next_cursor is 0 once the end of the directory has been reached */
+typedef void (cgsmc_async_readdir_page_cb)(int status,
+                                           cgsmc_async_entry * entries,
+                                           size_t entries_count,
+                                           uint64_t next_cursor,
+                                           void * cb_data);
 
+/* On success, either filename is set or fd is a descriptor
+   of the file in cache passed by the storage manager (-1 otherwise).
+   Both belong to the callback. */
 typedef void (cgsmc_async_create_and_open_cb)(int status,
                                               struct stat * st,
                                               char * filename,
+                                              int fd,
                                               void * cb_data);
 
+/* lease is the time, in milliseconds, during which the file may be
+   reopened read-only without asking the storage manager, 0 if none. */
 typedef void (cgsmc_async_open_cb)(int status,
                                    char * filename,
+                                   int fd,
+                                   uint32_t lease,
                                    void * cb_data);
 
 typedef void (cgsmc_async_returning_renamed_and_deleted_inode_number_cb)(int status,
@@ -95,10 +107,11 @@ int cgsmc_async_getattr(cgsmc_async_data * data,
                         cgsmc_async_stat_cb * cb,
                         void * cb_data);
 
-int cgsmc_async_readdir(cgsmc_async_data * data,
-                        uint64_t ino,
-                        cgsmc_async_readdir_cb * cb,
-                        void * cb_data);
+int cgsmc_async_readdir_page(cgsmc_async_data * data,
+                             uint64_t ino,
+                             uint64_t cursor,
+                             cgsmc_async_readdir_page_cb * cb,
+                             void * cb_data);
 
 int cgsmc_async_create_and_open(cgsmc_async_data * data,
                                 uint64_t parent,
@@ -127,6 +140,14 @@ int cgsmc_async_notify_write(cgsmc_async_data * data,
                              cgsmc_async_status_cb * cb,
                              void * cb_data);
 
+/* Notifies writes to several inodes at once, using a single
+   request. The status is the same for all of them. */
+int cgsmc_async_notify_write_multi(cgsmc_async_data * data,
+                                   uint64_t const * inodes,
+                                   size_t inodes_count,
+                                   cgsmc_async_status_cb * cb,
+                                   void * cb_data);
+
 int cgsmc_async_setattr(cgsmc_async_data * data,
                         uint64_t inode,
                         struct stat const * st,
@@ -190,6 +211,11 @@ int cgsmc_async_readlink(cgsmc_async_data * data,
 unsigned long cgsmc_async_get_block_size(cgsmc_async_data * data);
 unsigned long cgsmc_async_get_name_max(cgsmc_async_data * data);
 
+/* Disabled by default, requires a storage manager
+   supporting the _leased open opcodes. */
+void cgsmc_async_set_open_leases(cgsmc_async_data * data,
+                                 bool enabled);
+
 void cgsmc_async_entry_free(cgsmc_async_entry * this);
 void cgsmc_async_entry_clean(cgsmc_async_entry * this);
 
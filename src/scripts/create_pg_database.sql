@@ -45,8 +45,10 @@ CREATE TABLE IF NOT EXISTS entries(
     );
 
 CREATE INDEX entries_inode_number_idx ON entries USING btree (inode_number);
-CREATE INDEX entries_parent_idx ON entries USING btree (parent_entry_id);
+CREATE INDEX entries_parent_idx ON entries USING btree (parent_entry_id, entry_id);
 CREATE INDEX entries_type_idx ON entries USING btree (type);
+-- cache cleaner scans, resuming after the last entry seen
+CREATE INDEX entries_fs_type_entry_id_idx ON entries USING btree (fs_id, type, entry_id);
 
 CREATE TABLE IF NOT EXISTS inodes_instances(
     inode_instance_id BIGSERIAL NOT NULL UNIQUE,
@@ -82,6 +84,82 @@ CREATE TABLE IF NOT EXISTS inodes_instances_link(
 
 CREATE INDEX inodes_instances_link_inode_instance_id_idx ON inodes_instances_link USING btree (inode_instance_id);
 
+-- dirty / deleting instances waiting for the syncer, claimed with a lease
+CREATE TABLE IF NOT EXISTS inodes_instances_work_queue(
+    inode_instance_id BIGINT NOT NULL REFERENCES inodes_instances(inode_instance_id) ON DELETE CASCADE,
+    status SMALLINT NOT NULL,
+    claimed_until BIGINT NOT NULL DEFAULT 0,
+    PRIMARY KEY(inode_instance_id)
+    );
+
+CREATE INDEX inodes_instances_work_queue_status_idx ON inodes_instances_work_queue USING btree (status, claimed_until, inode_instance_id);
+
+CREATE OR REPLACE FUNCTION inodes_instances_work_queue_update()
+RETURNS TRIGGER AS $$
+DECLARE
+    notify_var BOOLEAN := false;
+BEGIN
+    IF NEW.status IN (1, 2) AND NEW.uploading = false AND NEW.deleting = false THEN
+
+        -- wake the syncers up on new work, not when an upload or
+        -- a deletion ends and puts the instance back in the queue
+        IF TG_OP = 'INSERT' THEN
+            notify_var := true;
+        ELSIF OLD.status <> NEW.status THEN
+            notify_var := true;
+        END IF;
+
+        -- a single statement, since two transactions may add
+        -- the same instance concurrently
+        INSERT INTO inodes_instances_work_queue AS wq (inode_instance_id, status)
+        VALUES (NEW.inode_instance_id, NEW.status)
+        ON CONFLICT (inode_instance_id) DO UPDATE
+        SET status = EXCLUDED.status, claimed_until = CASE WHEN wq.status = EXCLUDED.status THEN wq.claimed_until ELSE 0 END;
+
+        IF notify_var = true THEN
+            PERFORM pg_notify('cg_syncer_work', NEW.status::TEXT);
+        END IF;
+    ELSE
+        DELETE FROM inodes_instances_work_queue AS wq
+        WHERE wq.inode_instance_id = NEW.inode_instance_id;
+    END IF;
+
+    RETURN NULL;
+END;
+$$ LANGUAGE plpgsql;
+
+DROP TRIGGER IF EXISTS inodes_instances_work_queue_trigger ON inodes_instances;
+CREATE TRIGGER inodes_instances_work_queue_trigger
+AFTER INSERT OR UPDATE OF status, uploading, deleting ON inodes_instances
+FOR EACH ROW EXECUTE PROCEDURE inodes_instances_work_queue_update();
+
+-- dirty instances skipped while their inode had writers
+-- can be claimed again as soon as the last writer is gone
+CREATE OR REPLACE FUNCTION inodes_dirty_writers_released()
+RETURNS TRIGGER AS $$
+BEGIN
+    UPDATE inodes_instances_work_queue AS wq
+    SET claimed_until = 0
+    FROM inodes_instances_link AS iil
+    WHERE iil.inode_instance_id = wq.inode_instance_id
+    AND iil.fs_id = NEW.fs_id
+    AND iil.inode_number = NEW.inode_number
+    AND wq.status = 1;
+
+    IF FOUND THEN
+        PERFORM pg_notify('cg_syncer_work', '1');
+    END IF;
+
+    RETURN NULL;
+END;
+$$ LANGUAGE plpgsql;
+
+DROP TRIGGER IF EXISTS inodes_dirty_writers_released_trigger ON inodes;
+CREATE TRIGGER inodes_dirty_writers_released_trigger
+AFTER UPDATE OF dirty_writers ON inodes
+FOR EACH ROW WHEN (OLD.dirty_writers > 0 AND NEW.dirty_writers = 0)
+EXECUTE PROCEDURE inodes_dirty_writers_released();
+
 CREATE TABLE IF NOT EXISTS delayed_expunge_entries(
     fs_id BIGINT NOT NULL REFERENCES filesystems(fs_id),
     inode_number BIGINT,
@@ -485,6 +563,29 @@ BEGIN
 END;
 $$ LANGUAGE plpgsql;
 
+CREATE OR REPLACE FUNCTION set_inodes_and_all_inodes_instances_dirty(fs_id_p BIGINT, inode_numbers_p BIGINT[], mtime_p BIGINT, ctime_p BIGINT, last_modification_p BIGINT, old_status_p SMALLINT, new_status_p SMALLINT)
+RETURNS void AS $$
+DECLARE
+BEGIN
+    BEGIN
+
+        UPDATE inodes_instances AS ii
+        SET status = new_status_p
+        FROM inodes_instances_link AS iil
+        WHERE iil.inode_instance_id = ii.inode_instance_id
+        AND iil.fs_id = fs_id_p
+        AND iil.inode_number = ANY(inode_numbers_p)
+        AND ii.status = old_status_p;
+
+        UPDATE inodes AS ino
+        SET mtime = mtime_p, ctime = ctime_p, last_modification = last_modification_p
+        WHERE ino.fs_id = fs_id_p
+        AND ino.inode_number = ANY(inode_numbers_p);
+
+    END;
+END;
+$$ LANGUAGE plpgsql;
+
 CREATE OR REPLACE FUNCTION get_inode_info_updating_times_and_writers(fs_id_p BIGINT, inode_number_p BIGINT, atime_p BIGINT, ctime_p BIGINT, last_usage_p BIGINT, write_p BOOLEAN)
 RETURNS TABLE(inode_number BIGINT, uid BIGINT, gid BIGINT, mode BIGINT, size BIGINT, atime BIGINT, ctime BIGINT, mtime BIGINT, last_usage BIGINT, last_modification BIGINT, nlink BIGINT, dirty_writers BIGINT, in_cache BOOLEAN, digest TEXT, digest_type SMALLINT) AS $$
 DECLARE
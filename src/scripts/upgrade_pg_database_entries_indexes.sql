@@ -0,0 +1,17 @@
+-- Upgrades the entries indexes of a database created before the
+-- paginated readdir and the cache cleaner keyset scans, which
+-- otherwise fall back to sorting every entry of the directory or
+-- of the filesystem. Can be run more than once:
+-- psql -q "<Database Connection String>" < upgrade_pg_database_entries_indexes.sql
+-- Writes to the entries table are blocked while the indexes are built.
+
+BEGIN;
+
+-- readdir pages, resuming after the last entry_id seen
+DROP INDEX IF EXISTS entries_parent_idx;
+CREATE INDEX entries_parent_idx ON entries USING btree (parent_entry_id, entry_id);
+
+-- cache cleaner scans, resuming after the last entry seen
+CREATE INDEX IF NOT EXISTS entries_fs_type_entry_id_idx ON entries USING btree (fs_id, type, entry_id);
+
+COMMIT;
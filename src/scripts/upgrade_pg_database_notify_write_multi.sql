@@ -0,0 +1,32 @@
+-- Upgrades a database created before the batched dirty
+-- notifications (low_notify_write_multi) were introduced.
+-- Without it, every batched notification fails and the written
+-- files are never uploaded. Can be run more than once:
+-- psql -q "<Database Connection String>" < upgrade_pg_database_notify_write_multi.sql
+
+BEGIN;
+
+CREATE OR REPLACE FUNCTION set_inodes_and_all_inodes_instances_dirty(fs_id_p BIGINT, inode_numbers_p BIGINT[], mtime_p BIGINT, ctime_p BIGINT, last_modification_p BIGINT, old_status_p SMALLINT, new_status_p SMALLINT)
+RETURNS void AS $$
+DECLARE
+BEGIN
+    BEGIN
+
+        UPDATE inodes_instances AS ii
+        SET status = new_status_p
+        FROM inodes_instances_link AS iil
+        WHERE iil.inode_instance_id = ii.inode_instance_id
+        AND iil.fs_id = fs_id_p
+        AND iil.inode_number = ANY(inode_numbers_p)
+        AND ii.status = old_status_p;
+
+        UPDATE inodes AS ino
+        SET mtime = mtime_p, ctime = ctime_p, last_modification = last_modification_p
+        WHERE ino.fs_id = fs_id_p
+        AND ino.inode_number = ANY(inode_numbers_p);
+
+    END;
+END;
+$$ LANGUAGE plpgsql;
+
+COMMIT;
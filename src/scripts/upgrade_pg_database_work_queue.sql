@@ -0,0 +1,97 @@
+-- Upgrades a database created before the syncer work queue
+-- was introduced, or with a version of its trigger that could
+-- fail with a unique violation. Can be run more than once:
+-- psql -q "<Database Connection String>" < upgrade_pg_database_work_queue.sql
+-- Requires PostgreSQL >= 9.5.
+
+BEGIN;
+
+-- dirty / deleting instances waiting for the syncer, claimed with a lease
+CREATE TABLE IF NOT EXISTS inodes_instances_work_queue(
+    inode_instance_id BIGINT NOT NULL REFERENCES inodes_instances(inode_instance_id) ON DELETE CASCADE,
+    status SMALLINT NOT NULL,
+    claimed_until BIGINT NOT NULL DEFAULT 0,
+    PRIMARY KEY(inode_instance_id)
+    );
+
+CREATE INDEX IF NOT EXISTS inodes_instances_work_queue_status_idx ON inodes_instances_work_queue USING btree (status, claimed_until, inode_instance_id);
+
+-- the syncer no longer scans inodes_instances by status
+DROP INDEX IF EXISTS inodes_instances_status_inode_instance_id_idx;
+
+CREATE OR REPLACE FUNCTION inodes_instances_work_queue_update()
+RETURNS TRIGGER AS $$
+DECLARE
+    notify_var BOOLEAN := false;
+BEGIN
+    IF NEW.status IN (1, 2) AND NEW.uploading = false AND NEW.deleting = false THEN
+
+        -- wake the syncers up on new work, not when an upload or
+        -- a deletion ends and puts the instance back in the queue
+        IF TG_OP = 'INSERT' THEN
+            notify_var := true;
+        ELSIF OLD.status <> NEW.status THEN
+            notify_var := true;
+        END IF;
+
+        -- a single statement, since two transactions may add
+        -- the same instance concurrently
+        INSERT INTO inodes_instances_work_queue AS wq (inode_instance_id, status)
+        VALUES (NEW.inode_instance_id, NEW.status)
+        ON CONFLICT (inode_instance_id) DO UPDATE
+        SET status = EXCLUDED.status, claimed_until = CASE WHEN wq.status = EXCLUDED.status THEN wq.claimed_until ELSE 0 END;
+
+        IF notify_var = true THEN
+            PERFORM pg_notify('cg_syncer_work', NEW.status::TEXT);
+        END IF;
+    ELSE
+        DELETE FROM inodes_instances_work_queue AS wq
+        WHERE wq.inode_instance_id = NEW.inode_instance_id;
+    END IF;
+
+    RETURN NULL;
+END;
+$$ LANGUAGE plpgsql;
+
+DROP TRIGGER IF EXISTS inodes_instances_work_queue_trigger ON inodes_instances;
+CREATE TRIGGER inodes_instances_work_queue_trigger
+AFTER INSERT OR UPDATE OF status, uploading, deleting ON inodes_instances
+FOR EACH ROW EXECUTE PROCEDURE inodes_instances_work_queue_update();
+
+-- dirty instances skipped while their inode had writers
+-- can be claimed again as soon as the last writer is gone
+CREATE OR REPLACE FUNCTION inodes_dirty_writers_released()
+RETURNS TRIGGER AS $$
+BEGIN
+    UPDATE inodes_instances_work_queue AS wq
+    SET claimed_until = 0
+    FROM inodes_instances_link AS iil
+    WHERE iil.inode_instance_id = wq.inode_instance_id
+    AND iil.fs_id = NEW.fs_id
+    AND iil.inode_number = NEW.inode_number
+    AND wq.status = 1;
+
+    IF FOUND THEN
+        PERFORM pg_notify('cg_syncer_work', '1');
+    END IF;
+
+    RETURN NULL;
+END;
+$$ LANGUAGE plpgsql;
+
+DROP TRIGGER IF EXISTS inodes_dirty_writers_released_trigger ON inodes;
+CREATE TRIGGER inodes_dirty_writers_released_trigger
+AFTER UPDATE OF dirty_writers ON inodes
+FOR EACH ROW WHEN (OLD.dirty_writers > 0 AND NEW.dirty_writers = 0)
+EXECUTE PROCEDURE inodes_dirty_writers_released();
+
+-- instances that were already waiting for the syncer
+INSERT INTO inodes_instances_work_queue(inode_instance_id, status)
+SELECT ii.inode_instance_id, ii.status
+FROM inodes_instances AS ii
+WHERE ii.status IN (1, 2)
+AND ii.uploading = false
+AND ii.deleting = false
+ON CONFLICT (inode_instance_id) DO NOTHING;
+
+COMMIT;
@@ -619,6 +619,84 @@ static int test_db_get_child_inode_info(cgdb_data * const db)
     return result;
 }
 
+/* Only TEST_DB_ENTRY_NAME exists among the requested keys */
+static int test_db_get_multi_cb(int const status,
+                                size_t const entries_count,
+                                /* vector of cgdb_entry * */
+                                cgutils_vector * entries,
+                                void * const cb_data)
+{
+    TEST_ASSERT(status == 0, "test_db_get_multi_cb status");
+    TEST_ASSERT(cb_data != NULL, "test_db_get_multi_cb cb_data");
+
+    if (status == 0)
+    {
+        TEST_ASSERT(entries_count == 1, "test_db_get_multi_cb entries count");
+
+        if (entries_count == 1)
+        {
+            cgdb_entry const * got_entry = NULL;
+
+            int res = cgutils_vector_get(entries,
+                                         0,
+                                         (void **) &got_entry);
+
+            TEST_ASSERT(res == 0, "cgutils_vector_get");
+
+            if (res == 0)
+            {
+                TEST_ASSERT(got_entry != NULL, "test_db_get_multi_cb entry");
+                CGUTILS_ASSERT(got_entry != NULL);
+
+                TEST_ASSERT(got_entry->inode.inode_number == inode_number, "test_db_get_multi_cb inode number");
+                TEST_ASSERT(got_entry->name != NULL && strcmp(got_entry->name, TEST_DB_ENTRY_NAME) == 0, "test_db_get_multi_cb name");
+            }
+        }
+    }
+
+    if (entries != NULL)
+    {
+        cgutils_vector_deep_free(&entries, &cgdb_entry_delete);
+    }
+
+    return status;
+}
+
+static int test_db_get_inodes_info_multi(cgdb_data * const db)
+{
+    CGUTILS_ASSERT(db != NULL);
+    uint64_t const inodes[] = { inode_number, UINT64_MAX / 2 };
+
+    int result = cgdb_get_inodes_info_multi(db,
+                                            fs_id,
+                                            inodes,
+                                            sizeof inodes / sizeof *inodes,
+                                            &test_db_get_multi_cb,
+                                            db);
+
+    TEST_ASSERT(result == 0, "test_db_get_inodes_info_multi");
+
+    return result;
+}
+
+static int test_db_get_children_inodes_info_multi(cgdb_data * const db)
+{
+    CGUTILS_ASSERT(db != NULL);
+    char const * const names[] = { TEST_DB_ENTRY_NAME, "missing \"entry\", {really}" };
+
+    int result = cgdb_get_children_inodes_info_multi(db,
+                                                     fs_id,
+                                                     root_inode_number,
+                                                     names,
+                                                     sizeof names / sizeof *names,
+                                                     &test_db_get_multi_cb,
+                                                     db);
+
+    TEST_ASSERT(result == 0, "test_db_get_children_inodes_info_multi");
+
+    return result;
+}
+
 static int test_db_get_inode_instances_cb(int const status,
                                           /* llist of cgdb_inode_instance * */
                                           cgutils_llist * inode_instances,
@@ -873,40 +951,48 @@ static int test_db_count_inode_instances_by_status(cgdb_data * const db)
     return result;
 }
 
-static int test_db_get_inode_instances_by_status_cb(int const status,
-                                                    /* llist of cgdb_inode_instance * */
-                                                    cgutils_llist * inode_instances,
-                                                    void * const cb_data)
+#define TEST_DB_BATCH_ID_IN_INSTANCE_PREFIX "TestBatch"
+
+static char const * const test_db_batch_ids_in_instance[] =
 {
-    TEST_ASSERT(status == 0, "test_db_get_inode_instances_by_status_cb status");
-    TEST_ASSERT(cb_data != NULL, "test_db_get_inode_instances_by_status_cb cb_data");
+    TEST_DB_BATCH_ID_IN_INSTANCE_PREFIX "0",
+    TEST_DB_BATCH_ID_IN_INSTANCE_PREFIX "1",
+    TEST_DB_BATCH_ID_IN_INSTANCE_PREFIX "2",
+};
+
+static size_t const test_db_batch_ids_in_instance_count = sizeof test_db_batch_ids_in_instance / sizeof *test_db_batch_ids_in_instance;
+
+static int test_db_add_inode_instances_get_cb(int const status,
+                                              /* llist of cgdb_inode_instance * */
+                                              cgutils_llist * inode_instances,
+                                              void * const cb_data)
+{
+    TEST_ASSERT(status == 0, "test_db_add_inode_instances_get_cb status");
+    TEST_ASSERT(cb_data != NULL, "test_db_add_inode_instances_get_cb cb_data");
 
     if (status == 0)
     {
-        TEST_ASSERT(inode_instances != NULL, "test_db_get_inode_instances_by_status_cb inode_instances");
-        TEST_ASSERT(cgutils_llist_get_count(inode_instances) > 0, "test_db_get_inode_instances_by_status_cb inode_instances count");
+        size_t found = 0;
 
-        if (inode_instances != NULL &&
-                    cgutils_llist_get_count(inode_instances) > 0)
+        for (cgutils_llist_elt * elt = cgutils_llist_get_first(inode_instances);
+             elt != NULL;
+             elt = cgutils_llist_elt_get_next(elt))
         {
-            for (cgutils_llist_elt * elt = cgutils_llist_get_first(inode_instances);
-                 elt != NULL;
-                 elt = cgutils_llist_elt_get_next(elt))
-            {
-                cgdb_inode_instance const * const instance = cgutils_llist_elt_get_object(elt);
-                TEST_ASSERT(instance != NULL, "test_db_get_inode_instances_by_status_cb instance");
-                CGUTILS_ASSERT(instance != NULL);
+            cgdb_inode_instance const * const instance = cgutils_llist_elt_get_object(elt);
+            CGUTILS_ASSERT(instance != NULL);
 
-                if (instance != NULL)
-                {
-                    TEST_ASSERT(instance->fs_id > 0, "test_db_get_inode_instances_by_status_cb instance fs_id");
-                    TEST_ASSERT(instance->inode_number > 0, "test_db_get_inode_instances_by_status_cb instance inode_number");
-                    TEST_ASSERT(instance->instance_id > 0, "test_db_get_inode_instances_by_status_cb instance instance_id");
-                    TEST_ASSERT(instance->id_in_instance != NULL, "test_db_get_inode_instances_by_status_cb instance id_in_instance");
-                    TEST_ASSERT(instance->status == cg_storage_instance_status_ok, "test_db_get_inode_instances_by_status_cb instance status");
-                }
+            if (instance->id_in_instance != NULL &&
+                strncmp(instance->id_in_instance,
+                        TEST_DB_BATCH_ID_IN_INSTANCE_PREFIX,
+                        sizeof TEST_DB_BATCH_ID_IN_INSTANCE_PREFIX - 1) == 0)
+            {
+                TEST_ASSERT(instance->instance_id == instance_id, "test_db_add_inode_instances_get_cb instance instance_id");
+                TEST_ASSERT(instance->status == cg_storage_instance_status_ok, "test_db_add_inode_instances_get_cb instance status");
+                found++;
             }
         }
+
+        TEST_ASSERT(found == test_db_batch_ids_in_instance_count, "test_db_add_inode_instances_get_cb all instances added");
     }
 
     if (inode_instances != NULL)
@@ -917,18 +1003,212 @@ static int test_db_get_inode_instances_by_status_cb(int const status,
     return status;
 }
 
-static int test_db_get_inode_instances_by_status(cgdb_data * const db)
+static int test_db_add_inode_instances_cb(int const status,
+                                          void * const cb_data)
+{
+    cgdb_data * db = cb_data;
+    TEST_ASSERT(status == 0, "test_db_add_inode_instances_cb status");
+    TEST_ASSERT(cb_data != NULL, "test_db_add_inode_instances_cb cb_data");
+
+    if (status == 0)
+    {
+        int result = cgdb_get_inode_instances(db,
+                                              fs_id,
+                                              inode_number,
+                                              &test_db_add_inode_instances_get_cb,
+                                              db);
+
+        TEST_ASSERT(result == 0, "test_db_add_inode_instances_cb cgdb_get_inode_instances");
+    }
+
+    return status;
+}
+
+static int test_db_add_inode_instances(cgdb_data * const db)
+{
+    CGUTILS_ASSERT(db != NULL);
+
+    uint64_t instances_ids[test_db_batch_ids_in_instance_count];
+
+    for (size_t idx = 0;
+         idx < test_db_batch_ids_in_instance_count;
+         idx++)
+    {
+        instances_ids[idx] = instance_id;
+    }
+
+    int result = cgdb_add_inode_instances(db,
+                                          fs_id,
+                                          inode_number,
+                                          instances_ids,
+                                          test_db_batch_ids_in_instance,
+                                          test_db_batch_ids_in_instance_count,
+                                          cg_storage_instance_status_ok,
+                                          &test_db_add_inode_instances_cb,
+                                          db);
+
+    TEST_ASSERT(result == 0, "cgdb_add_inode_instances");
+
+    return result;
+}
+
+static int test_db_remove_inode_instances(cgdb_data * const db)
 {
     CGUTILS_ASSERT(db != NULL);
+    int result = 0;
+
+    for (size_t idx = 0;
+         result == 0 &&
+             idx < test_db_batch_ids_in_instance_count;
+         idx++)
+    {
+        result = cgdb_remove_inode_instance(db,
+                                            fs_id,
+                                            instance_id,
+                                            inode_number,
+                                            test_db_batch_ids_in_instance[idx],
+                                            cg_storage_instance_status_ok,
+                                            &test_db_remove_inode_instance_cb,
+                                            db);
+
+        TEST_ASSERT(result == 0, "cgdb_remove_inode_instance");
+    }
+
+    return result;
+}
+
+#define TEST_DB_QUEUE_ID_IN_INSTANCE "TestQueue0"
+#define TEST_DB_QUEUE_LEASE_DURATION (3600)
+#define TEST_DB_QUEUE_LIMIT (100000)
 
-    int result = cgdb_get_inode_instances_by_status(db,
-                                                    cg_storage_instance_status_ok,
-                                                    (cgdb_limit_type) 50,
-                                                    (cgdb_skip_type) 0,
-                                                    &test_db_get_inode_instances_by_status_cb,
-                                                    db);
+static size_t test_db_count_queue_instance(cgutils_llist * const inode_instances,
+                                           char const * const id_in_instance)
+{
+    size_t result = 0;
 
-    TEST_ASSERT(result == 0, "test_db_get_inode_instances_by_status");
+    for (cgutils_llist_elt * elt = cgutils_llist_get_first(inode_instances);
+         elt != NULL;
+         elt = cgutils_llist_elt_get_next(elt))
+    {
+        cgdb_inode_instance const * const instance = cgutils_llist_elt_get_object(elt);
+        CGUTILS_ASSERT(instance != NULL);
+
+        if (instance->id_in_instance != NULL &&
+            strcmp(instance->id_in_instance, id_in_instance) == 0)
+        {
+            TEST_ASSERT(instance->status == cg_storage_instance_status_dirty, "test_db_count_queue_instance instance status");
+            TEST_ASSERT(instance->uploading == false, "test_db_count_queue_instance instance uploading");
+            TEST_ASSERT(instance->deleting == false, "test_db_count_queue_instance instance deleting");
+            result++;
+        }
+    }
+
+    return result;
+}
+
+static int test_db_claim_inode_instances_by_status_again_cb(int const status,
+                                                            /* llist of cgdb_inode_instance * */
+                                                            cgutils_llist * inode_instances,
+                                                            void * const cb_data)
+{
+    cgdb_data * db = cb_data;
+    TEST_ASSERT(status == 0, "test_db_claim_inode_instances_by_status_again_cb status");
+    TEST_ASSERT(cb_data != NULL, "test_db_claim_inode_instances_by_status_again_cb cb_data");
+
+    if (status == 0)
+    {
+        /* still leased, nobody else can claim it */
+        TEST_ASSERT(test_db_count_queue_instance(inode_instances, TEST_DB_QUEUE_ID_IN_INSTANCE) == 0, "test_db_claim_inode_instances_by_status_again_cb not claimed twice");
+
+        int result = cgdb_remove_inode_instance(db,
+                                                fs_id,
+                                                instance_id,
+                                                inode_number,
+                                                TEST_DB_QUEUE_ID_IN_INSTANCE,
+                                                cg_storage_instance_status_dirty,
+                                                &test_db_remove_inode_instance_cb,
+                                                db);
+
+        TEST_ASSERT(result == 0, "test_db_claim_inode_instances_by_status_again_cb cgdb_remove_inode_instance");
+    }
+
+    if (inode_instances != NULL)
+    {
+        cgutils_llist_free(&inode_instances, &cgdb_inode_instance_delete);
+    }
+
+    return status;
+}
+
+static int test_db_claim_inode_instances_by_status_cb(int const status,
+                                                      /* llist of cgdb_inode_instance * */
+                                                      cgutils_llist * inode_instances,
+                                                      void * const cb_data)
+{
+    cgdb_data * db = cb_data;
+    TEST_ASSERT(status == 0, "test_db_claim_inode_instances_by_status_cb status");
+    TEST_ASSERT(cb_data != NULL, "test_db_claim_inode_instances_by_status_cb cb_data");
+
+    if (status == 0)
+    {
+        TEST_ASSERT(test_db_count_queue_instance(inode_instances, TEST_DB_QUEUE_ID_IN_INSTANCE) == 1, "test_db_claim_inode_instances_by_status_cb claimed");
+
+        int result = cgdb_claim_inode_instances_by_status(db,
+                                                          cg_storage_instance_status_dirty,
+                                                          TEST_DB_QUEUE_LEASE_DURATION,
+                                                          (cgdb_limit_type) TEST_DB_QUEUE_LIMIT,
+                                                          &test_db_claim_inode_instances_by_status_again_cb,
+                                                          db);
+
+        TEST_ASSERT(result == 0, "test_db_claim_inode_instances_by_status_cb cgdb_claim_inode_instances_by_status");
+    }
+
+    if (inode_instances != NULL)
+    {
+        cgutils_llist_free(&inode_instances, &cgdb_inode_instance_delete);
+    }
+
+    return status;
+}
+
+static int test_db_claim_inode_instances_by_status_add_cb(int const status,
+                                                          void * const cb_data)
+{
+    cgdb_data * db = cb_data;
+    TEST_ASSERT(status == 0, "test_db_claim_inode_instances_by_status_add_cb status");
+    TEST_ASSERT(cb_data != NULL, "test_db_claim_inode_instances_by_status_add_cb cb_data");
+
+    if (status == 0)
+    {
+        int result = cgdb_claim_inode_instances_by_status(db,
+                                                          cg_storage_instance_status_dirty,
+                                                          TEST_DB_QUEUE_LEASE_DURATION,
+                                                          (cgdb_limit_type) TEST_DB_QUEUE_LIMIT,
+                                                          &test_db_claim_inode_instances_by_status_cb,
+                                                          db);
+
+        TEST_ASSERT(result == 0, "test_db_claim_inode_instances_by_status_add_cb cgdb_claim_inode_instances_by_status");
+    }
+
+    return status;
+}
+
+/* A new dirty instance enters the work queue, and can only be
+   claimed once while its lease is running. */
+static int test_db_claim_inode_instances_by_status(cgdb_data * const db)
+{
+    CGUTILS_ASSERT(db != NULL);
+
+    int result = cgdb_add_inode_instance(db,
+                                         fs_id,
+                                         instance_id,
+                                         inode_number,
+                                         TEST_DB_QUEUE_ID_IN_INSTANCE,
+                                         cg_storage_instance_status_dirty,
+                                         &test_db_claim_inode_instances_by_status_add_cb,
+                                         db);
+
+    TEST_ASSERT(result == 0, "cgdb_add_inode_instance");
 
     return result;
 }
@@ -1005,8 +1285,8 @@ static int test_db_get_not_dirty_entries_by_type_size_last_usage_cached(cgdb_dat
                                                                            0,
                                                                            0,
                                                                            cg_storage_instance_status_dirty,
-                                                                           50,
                                                                            0,
+                                                                           50,
                                                                            &test_db_get_not_dirty_entries_by_type_size_last_usage_cached_cb,
                                                                            db);
 
@@ -1073,6 +1353,262 @@ static int test_db_generic_status_cb(int const status,
     return status;
 }
 
+#define TEST_DB_NOTIFY_ID_IN_INSTANCE "TestNotify0"
+
+static cgdb_listener * test_listener = NULL;
+static bool test_listener_notified = false;
+
+static int test_db_listen_remove_cb(int const status,
+                                    void * const cb_data)
+{
+    TEST_ASSERT(status == 0, "test_db_listen_remove_cb status");
+    TEST_ASSERT(cb_data != NULL, "test_db_listen_remove_cb cb_data");
+    TEST_ASSERT(test_listener_notified == true, "test_db_listen_remove_cb notified");
+
+    cgdb_listener_free(test_listener), test_listener = NULL;
+
+    return status;
+}
+
+static int test_db_listen_cb(int const status,
+                             char const * const payload,
+                             void * const cb_data)
+{
+    cgdb_data * db = cb_data;
+    int result = 0;
+    TEST_ASSERT(status == 0, "test_db_listen_cb status");
+    TEST_ASSERT(cb_data != NULL, "test_db_listen_cb cb_data");
+
+    if (status == 0)
+    {
+        if (payload == NULL)
+        {
+            /* listening, a new dirty instance should be notified */
+            result = cgdb_add_inode_instance(db,
+                                             fs_id,
+                                             instance_id,
+                                             inode_number,
+                                             TEST_DB_NOTIFY_ID_IN_INSTANCE,
+                                             cg_storage_instance_status_dirty,
+                                             &test_db_generic_status_cb,
+                                             (void *) "cgdb_add_inode_instance");
+
+            TEST_ASSERT(result == 0, "test_db_listen_cb cgdb_add_inode_instance");
+        }
+        else if (test_listener_notified == false)
+        {
+            TEST_ASSERT(strcmp(payload, "1") == 0, "test_db_listen_cb payload");
+            test_listener_notified = true;
+
+            result = cgdb_remove_inode_instance(db,
+                                                fs_id,
+                                                instance_id,
+                                                inode_number,
+                                                TEST_DB_NOTIFY_ID_IN_INSTANCE,
+                                                cg_storage_instance_status_dirty,
+                                                &test_db_listen_remove_cb,
+                                                db);
+
+            TEST_ASSERT(result == 0, "test_db_listen_cb cgdb_remove_inode_instance");
+        }
+    }
+
+    return result;
+}
+
+static int test_db_listen(cgdb_data * const db)
+{
+    CGUTILS_ASSERT(db != NULL);
+
+    int result = cgdb_listen(db,
+                             CGDB_SYNCER_WORK_CHANNEL,
+                             &test_db_listen_cb,
+                             db,
+                             &test_listener);
+
+    TEST_ASSERT(result == 0, "cgdb_listen");
+
+    return result;
+}
+
+#define TEST_DB_RETRY_ID_IN_INSTANCE "TestRetry0"
+
+static cgdb_listener * test_retry_listener = NULL;
+static bool test_retry_notified = false;
+static size_t test_retry_claims = 0;
+
+static int test_db_retry_failed_upload_claim_cb(int status,
+                                                cgutils_llist * inode_instances,
+                                                void * cb_data);
+
+static int test_db_retry_failed_upload_remove_cb(int const status,
+                                                 void * const cb_data)
+{
+    TEST_ASSERT(status == 0, "test_db_retry_failed_upload_remove_cb status");
+    TEST_ASSERT(cb_data != NULL, "test_db_retry_failed_upload_remove_cb cb_data");
+
+    cgdb_listener_free(test_retry_listener), test_retry_listener = NULL;
+
+    return status;
+}
+
+static int test_db_retry_failed_upload_done_cb(int const status,
+                                               void * const cb_data)
+{
+    cgdb_data * db = cb_data;
+    TEST_ASSERT(status == 0, "test_db_retry_failed_upload_done_cb status");
+    TEST_ASSERT(cb_data != NULL, "test_db_retry_failed_upload_done_cb cb_data");
+
+    if (status == 0)
+    {
+        /* put back without any notification, the next run has to find it */
+        int result = cgdb_claim_inode_instances_by_status(db,
+                                                          cg_storage_instance_status_dirty,
+                                                          0,
+                                                          (cgdb_limit_type) TEST_DB_QUEUE_LIMIT,
+                                                          &test_db_retry_failed_upload_claim_cb,
+                                                          db);
+
+        TEST_ASSERT(result == 0, "test_db_retry_failed_upload_done_cb cgdb_claim_inode_instances_by_status");
+    }
+
+    return status;
+}
+
+static int test_db_retry_failed_upload_uploading_cb(int const status,
+                                                    void * const cb_data)
+{
+    cgdb_data * db = cb_data;
+    TEST_ASSERT(status == 0, "test_db_retry_failed_upload_uploading_cb status");
+    TEST_ASSERT(cb_data != NULL, "test_db_retry_failed_upload_uploading_cb cb_data");
+
+    if (status == 0)
+    {
+        int result = cgdb_update_inode_instance_set_uploading_done(db,
+                                                                   fs_id,
+                                                                   instance_id,
+                                                                   inode_number,
+                                                                   TEST_DB_RETRY_ID_IN_INSTANCE,
+                                                                   true,
+                                                                   &test_db_retry_failed_upload_done_cb,
+                                                                   db);
+
+        TEST_ASSERT(result == 0, "test_db_retry_failed_upload_uploading_cb cgdb_update_inode_instance_set_uploading_done");
+    }
+
+    return status;
+}
+
+static int test_db_retry_failed_upload_claim_cb(int const status,
+                                                /* llist of cgdb_inode_instance * */
+                                                cgutils_llist * inode_instances,
+                                                void * const cb_data)
+{
+    cgdb_data * db = cb_data;
+    int result = 0;
+    TEST_ASSERT(status == 0, "test_db_retry_failed_upload_claim_cb status");
+    TEST_ASSERT(cb_data != NULL, "test_db_retry_failed_upload_claim_cb cb_data");
+
+    if (status == 0)
+    {
+        TEST_ASSERT(test_db_count_queue_instance(inode_instances, TEST_DB_RETRY_ID_IN_INSTANCE) == 1, "test_db_retry_failed_upload_claim_cb claimed");
+        test_retry_claims++;
+
+        if (test_retry_claims == 1)
+        {
+            result = cgdb_update_inode_instance_set_uploading(db,
+                                                              fs_id,
+                                                              instance_id,
+                                                              inode_number,
+                                                              TEST_DB_RETRY_ID_IN_INSTANCE,
+                                                              &test_db_retry_failed_upload_uploading_cb,
+                                                              db);
+
+            TEST_ASSERT(result == 0, "test_db_retry_failed_upload_claim_cb cgdb_update_inode_instance_set_uploading");
+        }
+        else
+        {
+            result = cgdb_remove_inode_instance(db,
+                                                fs_id,
+                                                instance_id,
+                                                inode_number,
+                                                TEST_DB_RETRY_ID_IN_INSTANCE,
+                                                cg_storage_instance_status_dirty,
+                                                &test_db_retry_failed_upload_remove_cb,
+                                                db);
+
+            TEST_ASSERT(result == 0, "test_db_retry_failed_upload_claim_cb cgdb_remove_inode_instance");
+        }
+    }
+
+    if (inode_instances != NULL)
+    {
+        cgutils_llist_free(&inode_instances, &cgdb_inode_instance_delete);
+    }
+
+    return status;
+}
+
+static int test_db_retry_failed_upload_listen_cb(int const status,
+                                                 char const * const payload,
+                                                 void * const cb_data)
+{
+    cgdb_data * db = cb_data;
+    int result = 0;
+    TEST_ASSERT(status == 0, "test_db_retry_failed_upload_listen_cb status");
+    TEST_ASSERT(cb_data != NULL, "test_db_retry_failed_upload_listen_cb cb_data");
+
+    if (status == 0)
+    {
+        if (payload == NULL)
+        {
+            result = cgdb_add_inode_instance(db,
+                                             fs_id,
+                                             instance_id,
+                                             inode_number,
+                                             TEST_DB_RETRY_ID_IN_INSTANCE,
+                                             cg_storage_instance_status_dirty,
+                                             &test_db_generic_status_cb,
+                                             (void *) "cgdb_add_inode_instance");
+
+            TEST_ASSERT(result == 0, "test_db_retry_failed_upload_listen_cb cgdb_add_inode_instance");
+        }
+        else if (test_retry_notified == false)
+        {
+            test_retry_notified = true;
+
+            /* no lease, so that the failed upload is claimable right away */
+            result = cgdb_claim_inode_instances_by_status(db,
+                                                          cg_storage_instance_status_dirty,
+                                                          0,
+                                                          (cgdb_limit_type) TEST_DB_QUEUE_LIMIT,
+                                                          &test_db_retry_failed_upload_claim_cb,
+                                                          db);
+
+            TEST_ASSERT(result == 0, "test_db_retry_failed_upload_listen_cb cgdb_claim_inode_instances_by_status");
+        }
+    }
+
+    return result;
+}
+
+/* In listening mode, a failed upload is put back in the work queue
+   without any notification, and has to be claimed again by a later run. */
+static int test_db_retry_failed_upload(cgdb_data * const db)
+{
+    CGUTILS_ASSERT(db != NULL);
+
+    int result = cgdb_listen(db,
+                             CGDB_SYNCER_WORK_CHANNEL,
+                             &test_db_retry_failed_upload_listen_cb,
+                             db,
+                             &test_retry_listener);
+
+    TEST_ASSERT(result == 0, "cgdb_listen");
+
+    return result;
+}
+
 static int test_db_update_inode_digest(cgdb_data * const db)
 {
     static char const str[] = "cgdb_update_inode_digest";
@@ -1137,6 +1673,34 @@ static int test_db_update_inode_counter(cgdb_data * const db)
     return result;
 }
 
+static int test_db_set_inodes_and_all_inodes_instances_dirty_multi(cgdb_data * const db)
+{
+    static char const str[] = "cgdb_set_inodes_and_all_inodes_instances_dirty_multi";
+
+    CGUTILS_ASSERT(db != NULL);
+    CGUTILS_ASSERT(fs_id > 0);
+    CGUTILS_ASSERT(inode_number > 0);
+    uint64_t const inodes[] = { inode_number, UINT64_MAX / 2 };
+    time_t const now = time(NULL);
+
+    /* same old and new instance status, only the inode times change */
+    int result = cgdb_set_inodes_and_all_inodes_instances_dirty_multi(db,
+                                                                      fs_id,
+                                                                      inodes,
+                                                                      sizeof inodes / sizeof *inodes,
+                                                                      now,
+                                                                      now,
+                                                                      now,
+                                                                      0,
+                                                                      0,
+                                                                      &test_db_generic_status_cb,
+                                                                      (void *) str);
+
+    TEST_ASSERT(result == 0, "cgdb_set_inodes_and_all_inodes_instances_dirty_multi");
+
+    return result;
+}
+
 static int test_db_update_inode_instance_set_uploading(cgdb_data * const db)
 {
     static char const str[] = "cgdb_update_inode_instance_set_uploading";
@@ -1347,6 +1911,8 @@ int main(void)
 
                                         TEST(test_db_get_inode_info)
                                         TEST(test_db_get_child_inode_info)
+                                        TEST(test_db_get_inodes_info_multi)
+                                        TEST(test_db_get_children_inodes_info_multi)
 
                                         TEST(test_db_get_inode_instances)
                                         TEST(test_db_get_inode_valid_instances)
@@ -1354,7 +1920,11 @@ int main(void)
                                         TEST(test_db_get_inode_entries)
 
                                         TEST(test_db_count_inode_instances_by_status)
-                                        TEST(test_db_get_inode_instances_by_status)
+                                        TEST(test_db_add_inode_instances)
+                                        TEST(test_db_remove_inode_instances)
+                                        TEST(test_db_claim_inode_instances_by_status)
+                                        TEST(test_db_listen)
+                                        TEST(test_db_retry_failed_upload)
 
                                         TEST(test_db_get_not_dirty_entries_by_type_size_last_usage_cached)
 
@@ -1363,6 +1933,7 @@ int main(void)
                                         TEST(test_db_update_inode_digest)
                                         TEST(test_db_update_inode_cache_status)
                                         TEST(test_db_update_inode_counter)
+                                        TEST(test_db_set_inodes_and_all_inodes_instances_dirty_multi)
 
                                         TEST(test_db_update_inode_instance_set_uploading)
                                         TEST(test_db_update_inode_instance_set_uploading_done)
@@ -0,0 +1,331 @@
+/*
+ * This file is part of Nuage Labs SAS's Cloud Gateway.
+ *
+ * Copyright (C) 2011-2017  Nuage Labs SAS
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * In addition, for the avoidance of any doubt, permission is granted to
+ * link this program with OpenSSL and to (re)distribute the binaries
+ * produced as the result of such linking.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+/* Measures the throughput of cgutils_event_buffered_io over a socketpair,
+   with many small objects (as for a readdir response) and with a single
+   object carrying the same amount of data. Every read object gets a
+   completion callback, as protocol reads do.
+   Usage: cloudEventBench [objects count] [object size] */
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <sys/socket.h>
+
+#include <cloudutils/cloudutils.h>
+#include <cloudutils/cloudutils_event.h>
+#include <cloudutils/cloudutils_time_counter.h>
+
+#define BENCH_DEFAULT_OBJECTS_COUNT (100000)
+#define BENCH_DEFAULT_OBJECT_SIZE (64)
+
+typedef struct
+{
+    size_t objects_count;
+    size_t object_size;
+    char * source;
+    char * destination;
+    size_t expected;
+    size_t completed;
+    int status;
+} bench_state;
+
+static int bench_set_non_blocking(int const fd)
+{
+    int result = 0;
+    int const flags = fcntl(fd, F_GETFL);
+
+    if (flags == -1 ||
+        fcntl(fd, F_SETFL, flags | O_NONBLOCK) == -1)
+    {
+        result = errno;
+        fprintf(stderr, "Error setting FD %d non-blocking: %s\n", fd, strerror(result));
+    }
+
+    return result;
+}
+
+static int bench_read_done_cb(cgutils_event_data * const data,
+                              int const status,
+                              int const fd,
+                              cgutils_event_buffered_io_obj * const obj)
+{
+    assert(obj != NULL);
+    bench_state * const state = obj->cb_data;
+    assert(state != NULL);
+    (void) fd;
+
+    state->completed++;
+
+    if (status != 0 &&
+        state->status == 0)
+    {
+        state->status = status;
+    }
+
+    if (state->completed == state->expected ||
+        status != 0)
+    {
+        cgutils_event_exit_loop(data);
+    }
+
+    return status;
+}
+
+static int bench_run(cgutils_event_data * const event_data,
+                     bench_state * const state,
+                     size_t const objects_count,
+                     size_t const object_size,
+                     uint64_t * const elapsed)
+{
+    int sockets[2] = { -1, -1 };
+    assert(event_data != NULL);
+    assert(state != NULL);
+    assert(elapsed != NULL);
+
+    int result = socketpair(AF_UNIX, SOCK_STREAM, 0, sockets);
+
+    if (result == 0)
+    {
+        result = bench_set_non_blocking(sockets[0]);
+
+        if (result == 0)
+        {
+            result = bench_set_non_blocking(sockets[1]);
+        }
+
+        if (result == 0)
+        {
+            cgutils_event_buffered_io * writer = NULL;
+            cgutils_event_buffered_io * reader = NULL;
+
+            result = cgutils_event_buffered_io_init(event_data,
+                                                    sockets[0],
+                                                    cgutils_event_buffered_io_writing,
+                                                    &writer);
+
+            if (result == 0)
+            {
+                result = cgutils_event_buffered_io_init(event_data,
+                                                        sockets[1],
+                                                        cgutils_event_buffered_io_reading,
+                                                        &reader);
+            }
+
+            if (result == 0)
+            {
+                cgutils_time_counter counter;
+                cgutils_time_counter_init(&counter);
+
+                state->status = 0;
+                state->expected = objects_count;
+                state->completed = 0;
+                memset(state->destination, 0, state->objects_count * state->object_size);
+
+                cgutils_time_counter_start(&counter);
+
+                for (size_t idx = 0;
+                     result == 0 && idx < objects_count;
+                     idx++)
+                {
+                    result = cgutils_event_buffered_io_add_one(writer,
+                                                               state->source + (idx * object_size),
+                                                               object_size,
+                                                               cgutils_event_buffered_io_writing,
+                                                               NULL,
+                                                               NULL);
+
+                    if (result == 0)
+                    {
+                        result = cgutils_event_buffered_io_add_one(reader,
+                                                                   state->destination + (idx * object_size),
+                                                                   object_size,
+                                                                   cgutils_event_buffered_io_reading,
+                                                                   &bench_read_done_cb,
+                                                                   state);
+                    }
+                }
+
+                if (result == 0)
+                {
+                    result = cgutils_event_dispatch(event_data);
+
+                    cgutils_time_counter_stop(&counter);
+                    cgutils_time_counter_to_milliseconds(&counter, elapsed);
+
+                    if (result == 0)
+                    {
+                        if (state->status != 0)
+                        {
+                            result = state->status;
+                        }
+                        else if (state->completed != objects_count)
+                        {
+                            result = EIO;
+                        }
+                        else if (memcmp(state->source,
+                                        state->destination,
+                                        objects_count * object_size) != 0)
+                        {
+                            fprintf(stderr, "Received data does not match\n");
+                            result = EIO;
+                        }
+                    }
+                }
+            }
+
+            if (reader != NULL)
+            {
+                cgutils_event_buffered_io_release(reader), reader = NULL;
+            }
+
+            if (writer != NULL)
+            {
+                cgutils_event_buffered_io_release(writer), writer = NULL;
+            }
+        }
+
+        close(sockets[0]), sockets[0] = -1;
+        close(sockets[1]), sockets[1] = -1;
+    }
+    else
+    {
+        result = errno;
+        fprintf(stderr, "Error creating socket pair: %s\n", strerror(result));
+    }
+
+    return result;
+}
+
+static void bench_print(char const * const name,
+                        size_t const objects_count,
+                        size_t const total_size,
+                        uint64_t const elapsed)
+{
+    uint64_t const ms = elapsed > 0 ? elapsed : 1;
+
+    fprintf(stdout,
+            "%-16s %10zu objects %12zu bytes %8"PRIu64" ms %12"PRIu64" objects/s %10.2f MB/s\n",
+            name,
+            objects_count,
+            total_size,
+            elapsed,
+            (objects_count * 1000) / ms,
+            ((double) total_size * 1000.0) / ((double) ms * 1024.0 * 1024.0));
+}
+
+int main(int argc, char ** argv)
+{
+    bench_state state = { 0 };
+    cgutils_event_data * event_data = NULL;
+    int result = 0;
+
+    state.objects_count = BENCH_DEFAULT_OBJECTS_COUNT;
+    state.object_size = BENCH_DEFAULT_OBJECT_SIZE;
+
+    if (argc > 1)
+    {
+        state.objects_count = (size_t) strtoull(argv[1], NULL, 10);
+    }
+
+    if (argc > 2)
+    {
+        state.object_size = (size_t) strtoull(argv[2], NULL, 10);
+    }
+
+    if (state.objects_count == 0 ||
+        state.object_size == 0)
+    {
+        fprintf(stderr, "Usage: %s [objects count] [object size]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    size_t const total_size = state.objects_count * state.object_size;
+
+    CGUTILS_MALLOC(state.source, total_size, 1);
+    CGUTILS_MALLOC(state.destination, total_size, 1);
+
+    if (state.source != NULL &&
+        state.destination != NULL)
+    {
+        for (size_t idx = 0; idx < total_size; idx++)
+        {
+            state.source[idx] = (char) (idx % 251);
+        }
+
+        result = cgutils_event_init(&event_data);
+
+        if (result == 0)
+        {
+            uint64_t elapsed = 0;
+
+            result = bench_run(event_data,
+                               &state,
+                               state.objects_count,
+                               state.object_size,
+                               &elapsed);
+
+            if (result == 0)
+            {
+                bench_print("small objects", state.objects_count, total_size, elapsed);
+
+                result = bench_run(event_data,
+                                   &state,
+                                   1,
+                                   total_size,
+                                   &elapsed);
+
+                if (result == 0)
+                {
+                    bench_print("single object", 1, total_size, elapsed);
+                }
+            }
+
+            if (result != 0)
+            {
+                fprintf(stderr, "Benchmark failed: %s\n", strerror(result));
+            }
+
+            cgutils_event_destroy(event_data), event_data = NULL;
+        }
+        else
+        {
+            fprintf(stderr, "Error in cgutils_event_init: %d\n", result);
+        }
+    }
+    else
+    {
+        result = ENOMEM;
+    }
+
+    CGUTILS_FREE(state.destination);
+    CGUTILS_FREE(state.source);
+
+    return result == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
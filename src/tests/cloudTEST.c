@@ -23,10 +23,13 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <limits.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/eventfd.h>
 #include <sys/file.h>
+#include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <time.h>
@@ -40,16 +43,22 @@
 #include <cloudutils/cloudutils_event.h>
 #include <cloudutils/cloudutils_file.h>
 #include <cloudutils/cloudutils_advanced_file_ops.h>
+#include <cloudutils/cloudutils_arena.h>
 #include <cloudutils/cloudutils_http.h>
 #include <cloudutils/cloudutils_htable.h>
 #include <cloudutils/cloudutils_network.h>
 #include <cloudutils/cloudutils_process.h>
 #include <cloudutils/cloudutils_rbtree.h>
+#include <cloudutils/cloudutils_ring.h>
 #include <cloudutils/cloudutils_system.h>
 #include <cloudutils/cloudutils_time_counter.h>
 #include <cloudutils/cloudutils_xml.h>
 
 #include <cgsm/cg_storage_filter.h>
+#include <cgsm/cg_storage_inode_cache.h>
+
+#include <cgfs_cache.h>
+#include <cgfs_lease.h>
 
 #include "cloudTest.h"
 
@@ -2082,6 +2091,533 @@ static int test_cgutils_event(cgutils_event_data ** event_data)
     return result;
 }
 
+static char const test_cgutils_event_buffered_io_memory_request[] = "REQUEST";
+static char test_cgutils_event_buffered_io_memory_response[8];
+static bool test_cgutils_event_buffered_io_memory_flushed = false;
+static int test_cgutils_event_buffered_io_memory_status = -1;
+
+static void test_cgutils_event_buffered_io_memory_flush_cb(cgutils_event_buffered_io * const io,
+                                                          void * const cb_data)
+{
+    char * output = NULL;
+    size_t output_size = 0;
+    (void) cb_data;
+
+    test_cgutils_event_buffered_io_memory_flushed = true;
+
+    int result = cgutils_event_buffered_io_take_output(io,
+                                                       &output,
+                                                       &output_size);
+
+    TEST_ASSERT(result == 0, "cgutils_event_buffered_io_take_output");
+
+    if (result == 0)
+    {
+        char * input = NULL;
+        size_t const request_len = sizeof test_cgutils_event_buffered_io_memory_request - 1;
+
+        TEST_ASSERT(output_size == sizeof (uint64_t) + request_len, "cgutils_event_buffered_io_take_output size");
+        TEST_ASSERT(memcmp(output + sizeof (uint64_t),
+                           test_cgutils_event_buffered_io_memory_request,
+                           request_len) == 0,
+                    "cgutils_event_buffered_io_take_output consistency");
+
+        /* echo the request back */
+        CGUTILS_MALLOC(input, request_len, 1);
+        TEST_ASSERT(input != NULL, "allocation");
+
+        if (input != NULL)
+        {
+            memcpy(input, output + sizeof (uint64_t), request_len);
+
+            result = cgutils_event_buffered_io_set_input(io,
+                                                         input,
+                                                         request_len);
+            TEST_ASSERT(result == 0, "cgutils_event_buffered_io_set_input");
+        }
+
+        CGUTILS_FREE(output);
+    }
+}
+
+static int test_cgutils_event_buffered_io_memory_read_cb(cgutils_event_data * const data,
+                                                         int const status,
+                                                         int const fd,
+                                                         cgutils_event_buffered_io_obj * const obj)
+{
+    (void) fd;
+    (void) obj;
+
+    test_cgutils_event_buffered_io_memory_status = status;
+
+    cgutils_event_exit_loop(data);
+
+    return status;
+}
+
+static int test_cgutils_event_buffered_io_memory(cgutils_event_data * const event_data)
+{
+    cgutils_event_buffered_io * io = NULL;
+    assert(event_data != NULL);
+
+    int result = cgutils_event_buffered_io_init_memory(event_data,
+                                                       0,
+                                                       sizeof (uint64_t),
+                                                       &test_cgutils_event_buffered_io_memory_flush_cb,
+                                                       NULL,
+                                                       &io);
+
+    TEST_ASSERT(result == 0, "cgutils_event_buffered_io_init_memory");
+
+    if (result == 0)
+    {
+        result = cgutils_event_buffered_io_add_one(io,
+                                                   (char *) test_cgutils_event_buffered_io_memory_request,
+                                                   sizeof test_cgutils_event_buffered_io_memory_request - 1,
+                                                   cgutils_event_buffered_io_writing,
+                                                   NULL,
+                                                   NULL);
+        TEST_ASSERT(result == 0, "cgutils_event_buffered_io_add_one");
+
+        if (result == 0)
+        {
+            result = cgutils_event_buffered_io_add_one(io,
+                                                       test_cgutils_event_buffered_io_memory_response,
+                                                       sizeof test_cgutils_event_buffered_io_memory_response - 1,
+                                                       cgutils_event_buffered_io_reading,
+                                                       &test_cgutils_event_buffered_io_memory_read_cb,
+                                                       NULL);
+            TEST_ASSERT(result == 0, "cgutils_event_buffered_io_add_one");
+
+            if (result == 0)
+            {
+                /* objects are only processed from the event loop */
+                TEST_ASSERT(test_cgutils_event_buffered_io_memory_flushed == false, "memory buffered io is asynchronous");
+
+                cgutils_event_dispatch(event_data);
+
+                TEST_ASSERT(test_cgutils_event_buffered_io_memory_flushed == true, "memory buffered io flush");
+                TEST_ASSERT(test_cgutils_event_buffered_io_memory_status == 0, "memory buffered io read");
+                TEST_ASSERT(memcmp(test_cgutils_event_buffered_io_memory_response,
+                                   test_cgutils_event_buffered_io_memory_request,
+                                   sizeof test_cgutils_event_buffered_io_memory_response - 1) == 0,
+                            "memory buffered io read consistency");
+
+                /* the input is exhausted */
+                result = cgutils_event_buffered_io_add_one(io,
+                                                           test_cgutils_event_buffered_io_memory_response,
+                                                           1,
+                                                           cgutils_event_buffered_io_reading,
+                                                           &test_cgutils_event_buffered_io_memory_read_cb,
+                                                           NULL);
+                TEST_ASSERT(result == 0, "cgutils_event_buffered_io_add_one");
+
+                if (result == 0)
+                {
+                    cgutils_event_dispatch(event_data);
+                    TEST_ASSERT(test_cgutils_event_buffered_io_memory_status == EBADF, "memory buffered io end of input");
+                }
+            }
+        }
+
+        cgutils_event_buffered_io_free(io), io = NULL;
+    }
+
+    return result;
+}
+
+static int test_cgutils_event_buffered_io_fd_status = -1;
+
+static int test_cgutils_event_buffered_io_fd_read_cb(cgutils_event_data * const data,
+                                                     int const status,
+                                                     int const fd,
+                                                     cgutils_event_buffered_io_obj * const obj)
+{
+    (void) fd;
+    (void) obj;
+
+    test_cgutils_event_buffered_io_fd_status = status;
+
+    cgutils_event_exit_loop(data);
+
+    return status;
+}
+
+static int test_cgutils_event_buffered_io_fd(cgutils_event_data * const event_data)
+{
+    int sockets[2] = { -1, -1 };
+    int pipe_fds[2] = { -1, -1 };
+    assert(event_data != NULL);
+
+    int result = socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sockets);
+
+    TEST_ASSERT(result == 0, "socketpair");
+
+    if (result == 0)
+    {
+        result = pipe(pipe_fds);
+
+        TEST_ASSERT(result == 0, "pipe");
+
+        if (result == 0)
+        {
+            cgutils_event_buffered_io * writer = NULL;
+            cgutils_event_buffered_io * reader = NULL;
+            uint64_t const sent_value = 42;
+            uint64_t received_value = 0;
+            int received_fd = -1;
+
+            result = cgutils_event_buffered_io_init(event_data,
+                                                    sockets[0],
+                                                    cgutils_event_buffered_io_writing,
+                                                    &writer);
+            TEST_ASSERT(result == 0, "cgutils_event_buffered_io_init");
+
+            if (result == 0)
+            {
+                result = cgutils_event_buffered_io_init(event_data,
+                                                        sockets[1],
+                                                        cgutils_event_buffered_io_reading,
+                                                        &reader);
+                TEST_ASSERT(result == 0, "cgutils_event_buffered_io_init");
+            }
+
+            if (result == 0)
+            {
+                /* a regular object, then the write end of the pipe */
+                result = cgutils_event_buffered_io_add_one(writer,
+                                                           (void *) &sent_value,
+                                                           sizeof sent_value,
+                                                           cgutils_event_buffered_io_writing,
+                                                           NULL,
+                                                           NULL);
+                TEST_ASSERT(result == 0, "cgutils_event_buffered_io_add_one");
+
+                if (result == 0)
+                {
+                    result = cgutils_event_buffered_io_add_fd(writer,
+                                                              &(pipe_fds[1]),
+                                                              cgutils_event_buffered_io_writing,
+                                                              NULL,
+                                                              NULL);
+                    TEST_ASSERT(result == 0, "cgutils_event_buffered_io_add_fd");
+                }
+
+                if (result == 0)
+                {
+                    result = cgutils_event_buffered_io_add_one(reader,
+                                                               &received_value,
+                                                               sizeof received_value,
+                                                               cgutils_event_buffered_io_reading,
+                                                               NULL,
+                                                               NULL);
+                    TEST_ASSERT(result == 0, "cgutils_event_buffered_io_add_one");
+                }
+
+                if (result == 0)
+                {
+                    result = cgutils_event_buffered_io_add_fd(reader,
+                                                              &received_fd,
+                                                              cgutils_event_buffered_io_reading,
+                                                              &test_cgutils_event_buffered_io_fd_read_cb,
+                                                              NULL);
+                    TEST_ASSERT(result == 0, "cgutils_event_buffered_io_add_fd");
+                }
+
+                if (result == 0)
+                {
+                    cgutils_event_dispatch(event_data);
+
+                    TEST_ASSERT(test_cgutils_event_buffered_io_fd_status == 0, "buffered io fd passing");
+                    TEST_ASSERT(received_value == sent_value, "buffered io fd passing consistency");
+                    TEST_ASSERT(received_fd != -1 && received_fd != pipe_fds[1], "buffered io received fd");
+
+                    if (received_fd != -1)
+                    {
+                        char value = 'X';
+                        char read_value = 0;
+
+                        TEST_ASSERT(write(received_fd, &value, sizeof value) == sizeof value, "write to received fd");
+                        TEST_ASSERT(read(pipe_fds[0], &read_value, sizeof read_value) == sizeof read_value, "read from pipe");
+                        TEST_ASSERT(read_value == value, "received fd consistency");
+
+                        close(received_fd), received_fd = -1;
+                    }
+                }
+            }
+
+            if (reader != NULL)
+            {
+                cgutils_event_buffered_io_free(reader), reader = NULL;
+            }
+
+            if (writer != NULL)
+            {
+                cgutils_event_buffered_io_free(writer), writer = NULL;
+            }
+
+            close(pipe_fds[0]), pipe_fds[0] = -1;
+            close(pipe_fds[1]), pipe_fds[1] = -1;
+        }
+
+        close(sockets[0]), sockets[0] = -1;
+        close(sockets[1]), sockets[1] = -1;
+    }
+
+    return result;
+}
+
+static int test_cgutils_ring(void)
+{
+    /* room for the header and a tiny data area */
+    uint64_t memory[64];
+    cgutils_ring * ring = NULL;
+    char output[16];
+    bool wake_up = false;
+
+    TEST_ASSERT(cgutils_ring_get_memory_size(6) == 0, "cgutils_ring_get_memory_size invalid capacity");
+    TEST_ASSERT(cgutils_ring_get_memory_size(8) <= sizeof memory, "cgutils_ring_get_memory_size");
+
+    int result = cgutils_ring_init(memory, 8, true, &ring);
+
+    TEST_ASSERT(result == 0, "cgutils_ring_init");
+
+    if (result == 0)
+    {
+        cgutils_ring * other = NULL;
+        struct iovec first = { .iov_base = (char *) "abcde", .iov_len = 5 };
+        struct iovec second[2] =
+            {
+                { .iov_base = (char *) "fgh", .iov_len = 3 },
+                { .iov_base = (char *) "ijklm", .iov_len = 5 }
+            };
+        struct iovec out[2] =
+            {
+                { .iov_base = output, .iov_len = 3 },
+                { .iov_base = output + 3, .iov_len = sizeof output - 3 }
+            };
+
+        TEST_ASSERT(cgutils_ring_init(memory, 16, false, &other) == EINVAL, "cgutils_ring_init capacity mismatch");
+
+        TEST_ASSERT(cgutils_ring_writev(ring, &first, 1, &wake_up) == 5, "cgutils_ring_writev");
+        TEST_ASSERT(wake_up == true, "cgutils_ring_writev wakes up the reader of an empty ring");
+
+        TEST_ASSERT(cgutils_ring_readv(ring, out, 1, &wake_up) == 3, "cgutils_ring_readv");
+        TEST_ASSERT(wake_up == false, "cgutils_ring_readv");
+        TEST_ASSERT(memcmp(output, "abc", 3) == 0, "cgutils_ring_readv consistency");
+
+        /* only 6 bytes of room left, wrapping around */
+        TEST_ASSERT(cgutils_ring_writev(ring, second, 2, &wake_up) == 6, "cgutils_ring_writev partial");
+        TEST_ASSERT(wake_up == false, "cgutils_ring_writev on a non-empty ring");
+        TEST_ASSERT(cgutils_ring_writev(ring, second, 2, &wake_up) == -1 && errno == EAGAIN, "cgutils_ring_writev full");
+
+        TEST_ASSERT(cgutils_ring_readv(ring, out, 2, &wake_up) == 8, "cgutils_ring_readv wrapping around");
+        TEST_ASSERT(wake_up == true, "cgutils_ring_readv wakes up the writer of a full ring");
+        TEST_ASSERT(memcmp(output, "defghijk", 8) == 0, "cgutils_ring_readv wrapping around consistency");
+        TEST_ASSERT(cgutils_ring_readv(ring, out, 2, &wake_up) == -1 && errno == EAGAIN, "cgutils_ring_readv empty");
+
+        cgutils_ring_free(ring), ring = NULL;
+    }
+
+    return result;
+}
+
+static int test_cgutils_arena(void)
+{
+    cgutils_arena * arena = NULL;
+
+    TEST_ASSERT(cgutils_arena_init(0, &arena) == EINVAL, "cgutils_arena_init invalid size");
+
+    int result = cgutils_arena_init(256, &arena);
+
+    TEST_ASSERT(result == 0, "cgutils_arena_init");
+
+    if (result == 0)
+    {
+        char * first = cgutils_arena_alloc(arena, 1);
+        uint64_t * second = cgutils_arena_alloc(arena, sizeof *second);
+        char * str = cgutils_arena_strdup(arena, "abcdef");
+        char * strn = cgutils_arena_strndup(arena, "abcdef", 3);
+        size_t * zeroed = cgutils_arena_calloc(arena, 4, sizeof *zeroed);
+
+        TEST_ASSERT(first != NULL && second != NULL && str != NULL && strn != NULL && zeroed != NULL,
+                    "cgutils_arena_alloc");
+        TEST_ASSERT(((uintptr_t) second) % sizeof (void *) == 0, "cgutils_arena_alloc alignment");
+        TEST_ASSERT(first != (char *) second, "cgutils_arena_alloc distinct pointers");
+        TEST_ASSERT(strcmp(str, "abcdef") == 0, "cgutils_arena_strdup");
+        TEST_ASSERT(strcmp(strn, "abc") == 0, "cgutils_arena_strndup");
+        TEST_ASSERT(zeroed[0] == 0 && zeroed[3] == 0, "cgutils_arena_calloc");
+        TEST_ASSERT(cgutils_arena_calloc(arena, SIZE_MAX, 2) == NULL, "cgutils_arena_calloc overflow");
+
+        /* larger than a block, and more blocks than the first one */
+        char * large = cgutils_arena_alloc(arena, 1000);
+        TEST_ASSERT(large != NULL, "cgutils_arena_alloc large");
+
+        for (size_t idx = 0; idx < 64; idx++)
+        {
+            uint64_t * value = cgutils_arena_alloc(arena, sizeof *value);
+            TEST_ASSERT(value != NULL, "cgutils_arena_alloc new block");
+            *value = idx;
+        }
+
+        memset(large, 'a', 1000);
+        TEST_ASSERT(strcmp(str, "abcdef") == 0, "cgutils_arena_alloc does not move previous allocations");
+        TEST_ASSERT(cgutils_arena_get_used_size(arena) >= 1000 + (64 * sizeof (uint64_t)), "cgutils_arena_get_used_size");
+
+        cgutils_arena_reset(arena);
+
+        TEST_ASSERT(cgutils_arena_get_used_size(arena) == 0, "cgutils_arena_reset");
+        TEST_ASSERT(cgutils_arena_alloc(arena, 1) == first, "cgutils_arena_reset reuses the first block");
+
+        cgutils_arena_free(arena), arena = NULL;
+    }
+
+    return result;
+}
+
+static int test_cgutils_event_buffered_io_ring_status = -1;
+
+static int test_cgutils_event_buffered_io_ring_read_cb(cgutils_event_data * const data,
+                                                       int const status,
+                                                       int const fd,
+                                                       cgutils_event_buffered_io_obj * const obj)
+{
+    (void) fd;
+    (void) obj;
+
+    test_cgutils_event_buffered_io_ring_status = status;
+
+    cgutils_event_exit_loop(data);
+
+    return status;
+}
+
+static int test_cgutils_event_buffered_io_ring(cgutils_event_data * const event_data)
+{
+    /* larger than the ring, so that the writer has to wait for the reader */
+    static char sent[10000];
+    static char received[sizeof sent];
+    size_t const capacity = 1024;
+    size_t const memory_size = cgutils_ring_get_memory_size(capacity);
+    void * memory = NULL;
+    assert(event_data != NULL);
+
+    int data_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    int space_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    TEST_ASSERT(data_fd != -1 && space_fd != -1, "eventfd");
+
+    CGUTILS_MALLOC(memory, memory_size, 1);
+
+    TEST_ASSERT(memory != NULL, "ring memory allocation");
+
+    int result = data_fd != -1 && space_fd != -1 && memory != NULL ? 0 : ENOMEM;
+
+    if (result == 0)
+    {
+        cgutils_ring * ring = NULL;
+
+        result = cgutils_ring_init(memory, capacity, true, &ring);
+
+        TEST_ASSERT(result == 0, "cgutils_ring_init");
+
+        if (result == 0)
+        {
+            cgutils_event_buffered_io * writer = NULL;
+            cgutils_event_buffered_io * reader = NULL;
+
+            for (size_t idx = 0; idx < sizeof sent; idx++)
+            {
+                sent[idx] = (char) (idx % 251);
+            }
+
+            result = cgutils_event_buffered_io_init_ring(event_data,
+                                                         ring,
+                                                         space_fd,
+                                                         data_fd,
+                                                         cgutils_event_buffered_io_writing,
+                                                         &writer);
+            TEST_ASSERT(result == 0, "cgutils_event_buffered_io_init_ring");
+
+            if (result == 0)
+            {
+                result = cgutils_event_buffered_io_init_ring(event_data,
+                                                             ring,
+                                                             data_fd,
+                                                             space_fd,
+                                                             cgutils_event_buffered_io_reading,
+                                                             &reader);
+                TEST_ASSERT(result == 0, "cgutils_event_buffered_io_init_ring");
+            }
+
+            if (result == 0)
+            {
+                int fd = data_fd;
+
+                TEST_ASSERT(cgutils_event_buffered_io_add_fd(writer,
+                                                             &fd,
+                                                             cgutils_event_buffered_io_writing,
+                                                             NULL,
+                                                             NULL) == ENOTSUP,
+                            "no fd passing on ring buffered io");
+
+                result = cgutils_event_buffered_io_add_one(writer,
+                                                           sent,
+                                                           sizeof sent,
+                                                           cgutils_event_buffered_io_writing,
+                                                           NULL,
+                                                           NULL);
+                TEST_ASSERT(result == 0, "cgutils_event_buffered_io_add_one");
+
+                if (result == 0)
+                {
+                    result = cgutils_event_buffered_io_add_one(reader,
+                                                               received,
+                                                               sizeof received,
+                                                               cgutils_event_buffered_io_reading,
+                                                               &test_cgutils_event_buffered_io_ring_read_cb,
+                                                               NULL);
+                    TEST_ASSERT(result == 0, "cgutils_event_buffered_io_add_one");
+                }
+
+                if (result == 0)
+                {
+                    cgutils_event_dispatch(event_data);
+
+                    TEST_ASSERT(test_cgutils_event_buffered_io_ring_status == 0, "ring buffered io read");
+                    TEST_ASSERT(memcmp(received, sent, sizeof sent) == 0, "ring buffered io consistency");
+                }
+            }
+
+            if (reader != NULL)
+            {
+                cgutils_event_buffered_io_free(reader), reader = NULL;
+            }
+
+            if (writer != NULL)
+            {
+                cgutils_event_buffered_io_free(writer), writer = NULL;
+            }
+
+            cgutils_ring_free(ring), ring = NULL;
+        }
+    }
+
+    CGUTILS_FREE(memory);
+
+    if (data_fd != -1)
+    {
+        close(data_fd), data_fd = -1;
+    }
+
+    if (space_fd != -1)
+    {
+        close(space_fd), space_fd = -1;
+    }
+
+    return result;
+}
+
 static int test_cgutils_network(void)
 {
     struct addrinfo * addr = NULL;
@@ -2429,6 +2965,334 @@ static int test_cgutils_process(cgutils_event_data * const event_data)
     return result;
 }
 
+static void test_cg_storage_inode_cache_add(cg_storage_inode_cache * const cache,
+                                            uint64_t const inode_number)
+{
+    cgdb_inode inode = (cgdb_inode) { 0 };
+    inode.inode_number = inode_number;
+
+    cg_storage_inode_cache_add(cache,
+                               cg_storage_inode_cache_get_generation(cache),
+                               &inode);
+}
+
+static bool test_cg_storage_inode_cache_has(cg_storage_inode_cache * const cache,
+                                            uint64_t const inode_number)
+{
+    cgdb_inode const * inode = NULL;
+    int const result = cg_storage_inode_cache_get(cache,
+                                                  inode_number,
+                                                  &inode);
+
+    return result == 0 &&
+        inode != NULL &&
+        inode->inode_number == inode_number;
+}
+
+static int test_cg_storage_inode_cache(void)
+{
+    cg_storage_inode_cache * cache = NULL;
+    cg_storage_inode_cache_stats stats = (cg_storage_inode_cache_stats) { 0 };
+
+    TEST_ASSERT(cg_storage_inode_cache_init(0, 1000, &cache) == EINVAL, "cg_storage_inode_cache_init invalid size");
+
+    int result = cg_storage_inode_cache_init(3, 60 * 1000, &cache);
+
+    TEST_ASSERT(result == 0, "cg_storage_inode_cache_init");
+
+    if (result == 0)
+    {
+        cgdb_inode inode = (cgdb_inode) { 0 };
+
+        TEST_ASSERT(test_cg_storage_inode_cache_has(cache, 1) == false, "cg_storage_inode_cache_get miss");
+
+        test_cg_storage_inode_cache_add(cache, 1);
+        TEST_ASSERT(test_cg_storage_inode_cache_has(cache, 1) == true, "cg_storage_inode_cache_get hit");
+
+        cg_storage_inode_cache_get_stats(cache, &stats);
+        TEST_ASSERT(stats.hits == 1 && stats.misses == 1 && stats.insertions == 1, "cg_storage_inode_cache_get_stats");
+
+        /* 1 has just been used, 2 is the least recently used one */
+        test_cg_storage_inode_cache_add(cache, 2);
+        test_cg_storage_inode_cache_add(cache, 3);
+        TEST_ASSERT(test_cg_storage_inode_cache_has(cache, 1) == true, "cg_storage_inode_cache_get refresh");
+        test_cg_storage_inode_cache_add(cache, 4);
+
+        TEST_ASSERT(test_cg_storage_inode_cache_has(cache, 2) == false, "cg_storage_inode_cache eviction of the least recently used");
+        TEST_ASSERT(test_cg_storage_inode_cache_has(cache, 1) == true, "cg_storage_inode_cache eviction order");
+        TEST_ASSERT(test_cg_storage_inode_cache_has(cache, 3) == true, "cg_storage_inode_cache eviction order");
+        TEST_ASSERT(test_cg_storage_inode_cache_has(cache, 4) == true, "cg_storage_inode_cache eviction order");
+
+        cg_storage_inode_cache_get_stats(cache, &stats);
+        TEST_ASSERT(stats.evictions == 1, "cg_storage_inode_cache_get_stats evictions");
+
+        cg_storage_inode_cache_invalidate(cache, 3);
+        TEST_ASSERT(test_cg_storage_inode_cache_has(cache, 3) == false, "cg_storage_inode_cache_invalidate");
+
+        /* a lookup racing a mutation: the result may predate it */
+        uint64_t generation = cg_storage_inode_cache_get_generation(cache);
+        inode.inode_number = 5;
+
+        cg_storage_inode_cache_mutation_begin(cache);
+        cg_storage_inode_cache_add(cache, cg_storage_inode_cache_get_generation(cache), &inode);
+        TEST_ASSERT(test_cg_storage_inode_cache_has(cache, 5) == false, "cg_storage_inode_cache_add refused during a mutation");
+        cg_storage_inode_cache_mutation_end(cache);
+
+        cg_storage_inode_cache_add(cache, generation, &inode);
+        TEST_ASSERT(test_cg_storage_inode_cache_has(cache, 5) == false, "cg_storage_inode_cache_add refused after a mutation");
+
+        generation = cg_storage_inode_cache_get_generation(cache);
+        cg_storage_inode_cache_invalidate(cache, 42);
+        cg_storage_inode_cache_add(cache, generation, &inode);
+        TEST_ASSERT(test_cg_storage_inode_cache_has(cache, 5) == false, "cg_storage_inode_cache_add refused after an invalidation");
+
+        test_cg_storage_inode_cache_add(cache, 5);
+        TEST_ASSERT(test_cg_storage_inode_cache_has(cache, 5) == true, "cg_storage_inode_cache_add with a current generation");
+
+        cg_storage_inode_cache_free(cache), cache = NULL;
+    }
+
+    result = cg_storage_inode_cache_init(4, 60 * 1000, &cache);
+
+    TEST_ASSERT(result == 0, "cg_storage_inode_cache_init");
+
+    if (result == 0)
+    {
+        cgdb_inode inode = (cgdb_inode) { 0 };
+        cgdb_inode const * found = NULL;
+        inode.inode_number = 7;
+
+        TEST_ASSERT(cg_storage_inode_cache_get_child(cache, 1, "child", &found) == ENOENT, "cg_storage_inode_cache_get_child miss");
+
+        cg_storage_inode_cache_add_child(cache,
+                                         cg_storage_inode_cache_get_generation(cache),
+                                         1,
+                                         "child",
+                                         &inode);
+
+        TEST_ASSERT(cg_storage_inode_cache_get_child(cache, 1, "child", &found) == 0, "cg_storage_inode_cache_get_child hit");
+        TEST_ASSERT(found != NULL && found->inode_number == 7, "cg_storage_inode_cache_get_child consistency");
+        TEST_ASSERT(test_cg_storage_inode_cache_has(cache, 7) == true, "cg_storage_inode_cache_add_child adds the inode");
+        TEST_ASSERT(cg_storage_inode_cache_get_child(cache, 1, "other", &found) == ENOENT, "cg_storage_inode_cache_get_child other name");
+        TEST_ASSERT(cg_storage_inode_cache_get_child(cache, 2, "child", &found) == ENOENT, "cg_storage_inode_cache_get_child other parent");
+
+        /* the entry is useless without its inode */
+        cg_storage_inode_cache_invalidate(cache, 7);
+        TEST_ASSERT(cg_storage_inode_cache_get_child(cache, 1, "child", &found) == ENOENT, "cg_storage_inode_cache_get_child invalidated inode");
+
+        cg_storage_inode_cache_add_child(cache,
+                                         cg_storage_inode_cache_get_generation(cache),
+                                         1,
+                                         "child",
+                                         &inode);
+        cg_storage_inode_cache_invalidate_child(cache, 1, "child");
+        TEST_ASSERT(cg_storage_inode_cache_get_child(cache, 1, "child", &found) == ENOENT, "cg_storage_inode_cache_invalidate_child");
+        TEST_ASSERT(test_cg_storage_inode_cache_has(cache, 7) == false, "cg_storage_inode_cache_invalidate_child invalidates the inode");
+
+        cg_storage_inode_cache_free(cache), cache = NULL;
+    }
+
+    result = cg_storage_inode_cache_init(4, 1, &cache);
+
+    TEST_ASSERT(result == 0, "cg_storage_inode_cache_init");
+
+    if (result == 0)
+    {
+        struct timespec const delay = { .tv_sec = 0, .tv_nsec = 5 * 1000 * 1000 };
+
+        test_cg_storage_inode_cache_add(cache, 1);
+        nanosleep(&delay, NULL);
+        TEST_ASSERT(test_cg_storage_inode_cache_has(cache, 1) == false, "cg_storage_inode_cache_get expired");
+
+        cg_storage_inode_cache_free(cache), cache = NULL;
+    }
+
+    return result;
+}
+
+static int test_cgfs_cache(void)
+{
+    cgfs_cache * cache = NULL;
+    int result = cgfs_cache_init(4, 4, 16, 1, 1, &cache);
+
+    TEST_ASSERT(result == 0, "cgfs_cache_init");
+
+    if (result == 0)
+    {
+        cgfs_inode * first = NULL;
+        cgfs_inode * second = NULL;
+        struct stat st = (struct stat) { 0 };
+        st.st_ino = 42;
+        st.st_mode = S_IFREG | 0644;
+        st.st_nlink = 1;
+
+        result = cgfs_inode_init(&st, &first);
+        TEST_ASSERT(result == 0, "cgfs_inode_init");
+
+        if (result == 0)
+        {
+            result = cgfs_cache_add(cache, &first);
+            TEST_ASSERT(result == 0, "cgfs_cache_add");
+        }
+
+        if (result == 0)
+        {
+            /* same inode resolved by two concurrent requests */
+            result = cgfs_inode_init(&st, &second);
+            TEST_ASSERT(result == 0, "cgfs_inode_init");
+        }
+
+        if (result == 0)
+        {
+            cgfs_inode * cached = NULL;
+            cgfs_cache_stats stats = (cgfs_cache_stats) { 0 };
+
+            TEST_ASSERT(cgfs_cache_add(cache, &second) == EEXIST, "cgfs_cache_add existing");
+            TEST_ASSERT(second == first, "cgfs_cache_add returns the cached inode");
+            /* the cache, first and second */
+            TEST_ASSERT(cgfs_inode_get_ref_count(first) == 3, "cgfs_cache_add takes a reference");
+
+            TEST_ASSERT(cgfs_cache_lookup(cache, 42, &cached) == 0, "cgfs_cache_lookup");
+            TEST_ASSERT(cached == first, "cgfs_cache_lookup after a concurrent add");
+            cgfs_inode_release(cached), cached = NULL;
+
+            cgfs_cache_get_stats(cache, &stats);
+            TEST_ASSERT(stats.count == 1, "cgfs_cache_add keeps a single inode");
+
+            cgfs_inode_release(second), second = NULL;
+        }
+
+        if (first != NULL)
+        {
+            cgfs_inode_release(first), first = NULL;
+        }
+
+        cgfs_cache_free(cache), cache = NULL;
+    }
+
+    return result;
+}
+
+static bool test_cgfs_lease_has(cgfs_lease_table * const table,
+                                cgfs_inode * const inode,
+                                int const flags)
+{
+    int fd = -1;
+    int const result = cgfs_lease_table_get(table,
+                                            inode,
+                                            flags,
+                                            &fd);
+
+    if (result == 0)
+    {
+        TEST_ASSERT(fd != -1, "cgfs_lease_table_get descriptor");
+        cgutils_file_close(fd), fd = -1;
+    }
+
+    return result == 0;
+}
+
+static int test_cgfs_lease(void)
+{
+    cgfs_inode * inodes[3] = { NULL };
+    size_t const inodes_count = sizeof inodes / sizeof *inodes;
+    int result = 0;
+    int const fd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+
+    TEST_ASSERT(fd != -1, "open");
+
+    for (size_t idx = 0; result == 0 && idx < inodes_count; idx++)
+    {
+        struct stat st = (struct stat) { 0 };
+        st.st_ino = idx + 1;
+        st.st_mode = S_IFREG | 0644;
+        st.st_nlink = 1;
+
+        result = cgfs_inode_init(&st, &(inodes[idx]));
+
+        TEST_ASSERT(result == 0, "cgfs_inode_init");
+    }
+
+    if (result == 0 &&
+        fd != -1)
+    {
+        cgfs_lease_table * table = NULL;
+
+        result = cgfs_lease_table_init(2, &table);
+
+        TEST_ASSERT(result == 0, "cgfs_lease_table_init");
+
+        if (result == 0)
+        {
+            struct stat changed = inodes[1]->attr;
+            changed.st_mtime++;
+
+            TEST_ASSERT(test_cgfs_lease_has(table, inodes[0], O_RDONLY) == false, "cgfs_lease_table_get empty");
+
+            TEST_ASSERT(cgfs_lease_table_add(table, inodes[0], O_RDONLY, fd, 60 * 1000) == 0, "cgfs_lease_table_add");
+            TEST_ASSERT(test_cgfs_lease_has(table, inodes[0], O_RDONLY) == true, "cgfs_lease_table_get");
+            TEST_ASSERT(test_cgfs_lease_has(table, inodes[0], O_RDONLY | O_NOATIME) == false, "cgfs_lease_table_get other flags");
+            TEST_ASSERT(test_cgfs_lease_has(table, inodes[0], O_RDONLY) == true, "cgfs_lease_table_get kept on other flags");
+
+            /* full, the lease closest to expiring goes away */
+            TEST_ASSERT(cgfs_lease_table_add(table, inodes[1], O_RDONLY, fd, 60 * 1000) == 0, "cgfs_lease_table_add");
+            TEST_ASSERT(cgfs_lease_table_add(table, inodes[2], O_RDONLY, fd, 120 * 1000) == 0, "cgfs_lease_table_add");
+            TEST_ASSERT(test_cgfs_lease_has(table, inodes[0], O_RDONLY) == false, "cgfs_lease_table_add eviction");
+            TEST_ASSERT(test_cgfs_lease_has(table, inodes[1], O_RDONLY) == true, "cgfs_lease_table_add eviction order");
+            TEST_ASSERT(test_cgfs_lease_has(table, inodes[2], O_RDONLY) == true, "cgfs_lease_table_add eviction order");
+
+            /* changed from outside of the mount */
+            TEST_ASSERT(cgfs_inode_refresh_attributes(inodes[1], &changed) == true, "cgfs_inode_refresh_attributes");
+            TEST_ASSERT(test_cgfs_lease_has(table, inodes[1], O_RDONLY) == false, "cgfs_lease_table_get revoked by generation");
+            TEST_ASSERT(cgfs_lease_table_add(table, inodes[1], O_RDONLY, fd, 60 * 1000) == 0, "cgfs_lease_table_add new generation");
+            TEST_ASSERT(test_cgfs_lease_has(table, inodes[1], O_RDONLY) == true, "cgfs_lease_table_get new generation");
+
+            inodes[2]->attr.st_nlink = 0;
+            TEST_ASSERT(test_cgfs_lease_has(table, inodes[2], O_RDONLY) == false, "cgfs_lease_table_get deleted inode");
+
+            cgfs_lease_table_free(table), table = NULL;
+        }
+
+        result = cgfs_lease_table_init(4, &table);
+
+        TEST_ASSERT(result == 0, "cgfs_lease_table_init");
+
+        if (result == 0)
+        {
+            struct timespec const delay = { .tv_sec = 0, .tv_nsec = 5 * 1000 * 1000 };
+
+            TEST_ASSERT(cgfs_lease_table_purge(table) == 0, "cgfs_lease_table_purge empty");
+
+            TEST_ASSERT(cgfs_lease_table_add(table, inodes[0], O_RDONLY, fd, 60 * 1000) == 0, "cgfs_lease_table_add");
+            TEST_ASSERT(cgfs_lease_table_add(table, inodes[1], O_RDONLY, fd, 1) == 0, "cgfs_lease_table_add");
+            nanosleep(&delay, NULL);
+
+            TEST_ASSERT(test_cgfs_lease_has(table, inodes[1], O_RDONLY) == false, "cgfs_lease_table_get expired");
+
+            TEST_ASSERT(cgfs_lease_table_add(table, inodes[2], O_RDONLY, fd, 1) == 0, "cgfs_lease_table_add");
+            nanosleep(&delay, NULL);
+
+            uint64_t const next = cgfs_lease_table_purge(table);
+            TEST_ASSERT(next > 0 && next <= 60 * 1000, "cgfs_lease_table_purge delay until the next expiration");
+            TEST_ASSERT(test_cgfs_lease_has(table, inodes[0], O_RDONLY) == true, "cgfs_lease_table_purge keeps valid leases");
+
+            cgfs_lease_table_free(table), table = NULL;
+        }
+    }
+
+    for (size_t idx = 0; idx < inodes_count; idx++)
+    {
+        cgfs_inode_release(inodes[idx]), inodes[idx] = NULL;
+    }
+
+    if (fd != -1)
+    {
+        close(fd);
+    }
+
+    return result;
+}
+
 int main(void)
 {
     cgutils_event_data * event_data = NULL;
@@ -2477,6 +3341,14 @@ int main(void)
 
         TEST_ASSERT(result == 0, "test_cgutils_time_counter");
 
+        result = test_cgutils_ring();
+
+        TEST_ASSERT(result == 0, "test_cgutils_ring");
+
+        result = test_cgutils_arena();
+
+        TEST_ASSERT(result == 0, "test_cgutils_arena");
+
         result = test_cgutils_network();
 
         TEST_ASSERT(result == 0, "test_cgutils_network");
@@ -2493,6 +3365,18 @@ int main(void)
 
         TEST_ASSERT(result == 0, "test_cgutils_rbtree");
 
+        result = test_cg_storage_inode_cache();
+
+        TEST_ASSERT(result == 0, "test_cg_storage_inode_cache");
+
+        result = test_cgfs_cache();
+
+        TEST_ASSERT(result == 0, "test_cgfs_cache");
+
+        result = test_cgfs_lease();
+
+        TEST_ASSERT(result == 0, "test_cgfs_lease");
+
         result = test_cgutils_storage_filter_encryption(&encrypted,
                                                         &encrypted_size);
 
@@ -2548,6 +3432,18 @@ int main(void)
 
             TEST_ASSERT(result == 0, "test_cgutils_aio");
 
+            result = test_cgutils_event_buffered_io_memory(event_data);
+
+            TEST_ASSERT(result == 0, "test_cgutils_event_buffered_io_memory");
+
+            result = test_cgutils_event_buffered_io_fd(event_data);
+
+            TEST_ASSERT(result == 0, "test_cgutils_event_buffered_io_fd");
+
+            result = test_cgutils_event_buffered_io_ring(event_data);
+
+            TEST_ASSERT(result == 0, "test_cgutils_event_buffered_io_ring");
+
             result = test_cgutils_process(event_data);
 
             TEST_ASSERT(result == 0, "test_cgutils_process");
@@ -0,0 +1,107 @@
+#!/bin/bash
+
+# Measures the write throughput through cloudFUSE, with and without
+# the zero-copy (splice) write path.
+# Uses the same setup as fonctionnal.sh.
+
+readonly TEST_DIR=`dirname $0`
+
+readonly PROJECT_PATH="${TEST_DIR}/../.."
+readonly SOURCE_PATH=${PROJECT_PATH}/src
+readonly BUILD_PATH=${PROJECT_PATH}/build
+
+if [ -z "${BIN_PATH}" ]; then
+    BIN_PATH="${BUILD_PATH}"
+fi
+
+# Size of the file written for each run, in MB
+if [ -z "${BENCH_SIZE_MB}" ]; then
+    BENCH_SIZE_MB=2048
+fi
+
+# Size of each write() call, in kB (big_writes allows up to 128 kB)
+if [ -z "${BENCH_BLOCK_KB}" ]; then
+    BENCH_BLOCK_KB=128
+fi
+
+# Number of runs of each path, alternated
+if [ -z "${BENCH_RUNS}" ]; then
+    BENCH_RUNS=3
+fi
+
+readonly CG_STORAGE_MANAGER_BIN="${BIN_PATH}/cloudGatewayStorageManager/bin/cgStorageManager"
+readonly CLOUD_FUSE_BIN="${BIN_PATH}/cloudFUSE/bin/cloudFUSE_low"
+readonly MOUNT_POINT=/mnt/ftp
+
+readonly CONFIG_FILE="${SOURCE_PATH}/tests/configs/CloudGatewayConfigurationPG.xml"
+readonly FS_ID=$( ${BIN_PATH}/tools/bin/cg_config_get ${CONFIG_FILE} 'FileSystems/FileSystem/Id' )
+readonly CLOUD_FUSE_PARAMETERS="-o default_permissions -o fsname=CloudGateway:vg_fuse -o allow_other -o big_writes ${MOUNT_POINT} -s ${CONFIG_FILE} -i ${FS_ID}"
+
+function fail()
+{
+    echo "Failed: $1";
+    fusermount -u ${MOUNT_POINT}
+    kill -USR1 `cat /tmp/CloudGatewayStorageManager.pid`
+    exit 1;
+}
+
+function run_bench()
+{
+    local label="$1"
+    local options="$2"
+
+    ${CLOUD_FUSE_BIN} ${options} ${CLOUD_FUSE_PARAMETERS} > /tmp/cloud_fuse_log 2> /tmp/cloud_fuse_err &
+
+    if [ $? -ne 0 ]; then
+        fail "Cloud FUSE launch failure.";
+    fi
+
+    sleep 1
+
+    rm -f ${MOUNT_POINT}/write_throughput_file
+
+    local start=`date +%s.%N`
+
+    dd if=/dev/zero of=${MOUNT_POINT}/write_throughput_file bs=${BENCH_BLOCK_KB}k count=$(( BENCH_SIZE_MB * 1024 / BENCH_BLOCK_KB )) conv=fsync 2> /dev/null
+
+    if [ $? -ne 0 ]; then
+        fail "Write failure (${label}).";
+    fi
+
+    local end=`date +%s.%N`
+
+    echo "${label}: ${BENCH_SIZE_MB} MB in $( echo "${end} - ${start}" | bc ) s, $( echo "scale=2; ${BENCH_SIZE_MB} / (${end} - ${start})" | bc ) MB/s"
+
+    rm -f ${MOUNT_POINT}/write_throughput_file
+
+    fusermount -u ${MOUNT_POINT}
+
+    if [ $? -ne 0 ]; then
+        fail "Unmount failure.";
+    fi
+
+    sleep 1
+}
+
+if [ ! -d ${MOUNT_POINT} ]; then
+    fail "Mount point ${MOUNT_POINT} does not exist.";
+fi
+
+if [ -z "${NO_STORAGE_MANAGER}" -o "${NO_STORAGE_MANAGER}" != "yes" ]; then
+    ${CG_STORAGE_MANAGER_BIN} ${CONFIG_FILE} > /tmp/cg_storage_manager_log 2> /tmp/cg_storage_manager_err &
+
+    if [ $? -ne 0 ]; then
+        fail "CG Storage Manager launch failure.";
+    fi
+fi
+
+sleep 1;
+
+for run in `seq 1 ${BENCH_RUNS}`; do
+    run_bench "buffered #${run}" ""
+    run_bench "zero-copy #${run}" "-o zero_copy_write"
+done
+
+if [ -z "${NO_STORAGE_MANAGER}" -o "${NO_STORAGE_MANAGER}" != "yes" ]; then
+    kill -USR1 `cat /tmp/CloudGatewayStorageManager.pid`
+fi